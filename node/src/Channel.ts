@@ -3,6 +3,7 @@ import { Duplex } from 'stream';
 import { Logger } from './Logger';
 import { EnhancedEventEmitter } from './EnhancedEventEmitter';
 import { InvalidStateError } from './errors';
+import * as msgpack from './msgpack';
 
 const littleEndian = os.endianness() == 'LE';
 const logger = new Logger('Channel');
@@ -40,6 +41,9 @@ export class Channel extends EnhancedEventEmitter
 	// Buffer for reading messages from the worker.
 	#recvBuffer = Buffer.alloc(0);
 
+	// Whether request data is sent in MessagePack instead of JSON.
+	readonly #msgpack: boolean;
+
 	/**
 	 * @private
 	 */
@@ -47,12 +51,14 @@ export class Channel extends EnhancedEventEmitter
 		{
 			producerSocket,
 			consumerSocket,
-			pid
+			pid,
+			channelFormat = 'json'
 		}:
 		{
 			producerSocket: any;
 			consumerSocket: any;
 			pid: number;
+			channelFormat?: 'json' | 'msgpack';
 		})
 	{
 		super();
@@ -61,6 +67,7 @@ export class Channel extends EnhancedEventEmitter
 
 		this.#producerSocket = producerSocket as Duplex;
 		this.#consumerSocket = consumerSocket as Duplex;
+		this.#msgpack = channelFormat === 'msgpack';
 
 		// Read Channel responses/notifications from the worker.
 		this.#consumerSocket.on('data', (buffer: Buffer) =>
@@ -115,7 +122,8 @@ export class Channel extends EnhancedEventEmitter
 
 				try
 				{
-					// We can receive JSON messages (Channel messages) or log strings.
+					// We can receive JSON or MessagePack messages (Channel messages) or
+					// log strings.
 					switch (payload[0])
 					{
 						// 123 = '{' (a Channel JSON message).
@@ -123,6 +131,16 @@ export class Channel extends EnhancedEventEmitter
 							this.processMessage(JSON.parse(payload.toString('utf8')));
 							break;
 
+						// 0x80-0x8f = fixmap, 0xde = map 16, 0xdf = map 32 (a Channel
+						// MessagePack message).
+						case 0x80: case 0x81: case 0x82: case 0x83:
+						case 0x84: case 0x85: case 0x86: case 0x87:
+						case 0x88: case 0x89: case 0x8a: case 0x8b:
+						case 0x8c: case 0x8d: case 0x8e: case 0x8f:
+						case 0xde: case 0xdf:
+							this.processMessage(msgpack.decode(payload));
+							break;
+
 						// 68 = 'D' (a debug log).
 						case 68:
 							logger.debug(`[pid:${pid}] ${payload.toString('utf8', 1)}`);
@@ -234,7 +252,17 @@ export class Channel extends EnhancedEventEmitter
 		if (this.#closed)
 			throw new InvalidStateError('Channel closed');
 
-		const request = `${id}:${method}:${handlerId}:${JSON.stringify(data)}`;
+		let request: string | Buffer;
+
+		if (this.#msgpack && data !== undefined && data !== null)
+		{
+			request = Buffer.concat(
+				[ Buffer.from(`${id}:${method}:${handlerId}:`), msgpack.encode(data) ]);
+		}
+		else
+		{
+			request = `${id}:${method}:${handlerId}:${JSON.stringify(data)}`;
+		}
 
 		if (Buffer.byteLength(request) > MESSAGE_MAX_LEN)
 			throw new Error('Channel request too big');
@@ -17,6 +17,12 @@ export type DirectTransportOptions =
 	 */
 	maxMessageSize: number;
 
+	/**
+	 * Send periodic RTCP Sender and Receiver Reports of its consumers and
+	 * producers, and probation RTP packets. Default false.
+	 */
+	enableRtcpReports?: boolean;
+
 	/**
 	 * Custom application data.
 	 */
@@ -219,6 +225,12 @@ export class DirectTransport extends
 						break;
 					}
 
+					// Probation RTP packets, not associated to any Consumer.
+					case 'rtp':
+					{
+						break;
+					}
+
 					default:
 					{
 						logger.error('ignoring unknown event "%s"', event);
@@ -94,8 +94,13 @@ export type PipeTransportStat =
 	availableOutgoingBitrate?: number;
 	availableIncomingBitrate?: number;
 	maxIncomingBitrate?: number;
+	recvBatchSizes?: number[];
 	// PipeTransport specific.
 	tuple: TransportTuple;
+	udpSendBatchSize?: number;
+	udpSendBatches?: number;
+	udpSendBatchedPackets?: number;
+	udpSendGsoPackets?: number;
 };
 
 export type PipeConsumerOptions =
@@ -38,6 +38,14 @@ export type PlainTransportOptions =
 	 */
 	comedia?: boolean;
 
+	/**
+	 * Estimate the available outgoing bitrate with the sender side bandwidth
+	 * estimator (loss, RTT and delay based) instead of the transport-cc / REMB
+	 * one. It also works if the remote endpoint just sends RTCP Receiver Reports.
+	 * Default false.
+	 */
+	enableSenderBwe?: boolean;
+
 	/**
 	 * Create a SCTP association. Default false.
 	 */
@@ -102,11 +110,16 @@ export type PlainTransportStat =
 	availableOutgoingBitrate?: number;
 	availableIncomingBitrate?: number;
 	maxIncomingBitrate?: number;
+	recvBatchSizes?: number[];
 	// PlainTransport specific.
 	rtcpMux: boolean;
 	comedia: boolean;
 	tuple: TransportTuple;
 	rtcpTuple?: TransportTuple;
+	udpSendBatchSize?: number;
+	udpSendBatches?: number;
+	udpSendBatchedPackets?: number;
+	udpSendGsoPackets?: number;
 };
 
 export type PlainTransportEvents = TransportEvents &
@@ -10,8 +10,8 @@ import { WebRtcTransport, WebRtcTransportOptions } from './WebRtcTransport';
 import { PlainTransport, PlainTransportOptions } from './PlainTransport';
 import { PipeTransport, PipeTransportOptions } from './PipeTransport';
 import { DirectTransport, DirectTransportOptions } from './DirectTransport';
-import { Producer } from './Producer';
-import { Consumer } from './Consumer';
+import { Producer, ProducerStat } from './Producer';
+import { Consumer, ConsumerStat } from './Consumer';
 import { DataProducer } from './DataProducer';
 import { DataConsumer } from './DataConsumer';
 import { RtpObserver } from './RtpObserver';
@@ -27,6 +27,13 @@ export type RouterOptions =
 	 */
 	mediaCodecs?: RtpCodecCapability[];
 
+	/**
+	 * Store the RTP packets of each Producer once for all its Consumers instead
+	 * of once per Consumer, so retransmissions use less memory with many
+	 * Consumers. Default false.
+	 */
+	sharedRtpPacketHistory?: boolean;
+
 	/**
 	 * Custom application data.
 	 */
@@ -349,6 +356,17 @@ export class Router extends EnhancedEventEmitter<RouterEvents>
 		return this.#channel.request('router.dump', this.#internal.routerId);
 	}
 
+	/**
+	 * Get stats of all the Consumers in the Router, indexed by Consumer id, in
+	 * a single request. The worker collects them in bounded time slices.
+	 */
+	async getConsumersStats(): Promise<Record<string, Array<ConsumerStat | ProducerStat>>>
+	{
+		logger.debug('getConsumersStats()');
+
+		return this.#channel.request('router.getConsumersStats', this.#internal.routerId);
+	}
+
 	/**
 	 * Create a WebRtcTransport.
 	 */
@@ -362,6 +380,8 @@ export class Router extends EnhancedEventEmitter<RouterEvents>
 			preferUdp = false,
 			preferTcp = false,
 			initialAvailableOutgoingBitrate = 600000,
+			enablePacing = false,
+			enableSenderBwe = false,
 			enableSctp = false,
 			numSctpStreams = { OS: 1024, MIS: 1024 },
 			maxSctpMessageSize = 262144,
@@ -410,6 +430,8 @@ export class Router extends EnhancedEventEmitter<RouterEvents>
 			preferUdp,
 			preferTcp,
 			initialAvailableOutgoingBitrate,
+			enablePacing,
+			enableSenderBwe,
 			enableSctp,
 			numSctpStreams,
 			maxSctpMessageSize,
@@ -471,6 +493,7 @@ export class Router extends EnhancedEventEmitter<RouterEvents>
 			port,
 			rtcpMux = true,
 			comedia = false,
+			enableSenderBwe = false,
 			enableSctp = false,
 			numSctpStreams = { OS: 1024, MIS: 1024 },
 			maxSctpMessageSize = 262144,
@@ -512,6 +535,7 @@ export class Router extends EnhancedEventEmitter<RouterEvents>
 			port,
 			rtcpMux,
 			comedia,
+			enableSenderBwe,
 			enableSctp,
 			numSctpStreams,
 			maxSctpMessageSize,
@@ -664,6 +688,7 @@ export class Router extends EnhancedEventEmitter<RouterEvents>
 	async createDirectTransport(
 		{
 			maxMessageSize = 262144,
+			enableRtcpReports = false,
 			appData
 		}: DirectTransportOptions =
 		{
@@ -677,7 +702,8 @@ export class Router extends EnhancedEventEmitter<RouterEvents>
 		{
 			transportId : uuidv4(),
 			direct      : true,
-			maxMessageSize
+			maxMessageSize,
+			enableRtcpReports
 		};
 
 		const data =
@@ -67,6 +67,21 @@ export type WebRtcTransportOptionsBase =
 	 */
 	initialAvailableOutgoingBitrate?: number;
 
+	/**
+	 * Queue RTP packets sent to consumers and send them by priority (audio,
+	 * retransmissions, video base layer and upper layers) at the pacing rate
+	 * given by the bandwidth estimation. Default false.
+	 */
+	enablePacing?: boolean;
+
+	/**
+	 * Estimate the available outgoing bitrate with the sender side bandwidth
+	 * estimator (loss, RTT and delay based) instead of the transport-cc / REMB
+	 * one. It also works if the remote endpoint just sends RTCP Receiver Reports.
+	 * Default false.
+	 */
+	enableSenderBwe?: boolean;
+
 	/**
 	 * Create a SCTP association. Default false.
 	 */
@@ -163,11 +178,20 @@ export type WebRtcTransportStat =
 	availableOutgoingBitrate?: number;
 	availableIncomingBitrate?: number;
 	maxIncomingBitrate?: number;
+	recvBatchSizes?: number[];
+	pacingQueueSize?: number;
+	pacingQueueBytes?: number;
+	pacingDelay?: number;
+	pacingDroppedPackets?: number;
 	// WebRtcTransport specific.
 	iceRole: string;
 	iceState: IceState;
 	iceSelectedTuple?: TransportTuple;
 	dtlsState: DtlsState;
+	udpSendBatchSize?: number;
+	udpSendBatches?: number;
+	udpSendBatchedPackets?: number;
+	udpSendGsoPackets?: number;
 };
 
 export type WebRtcTransportEvents = TransportEvents &
@@ -64,13 +64,41 @@ export type WorkerSettings =
 	 */
 	dtlsPrivateKeyFile?: string;
 
+	/**
+	 * Max number of UDP datagrams the worker queues within a loop iteration
+	 * before writing them all at once (using sendmmsg() and UDP GSO on Linux).
+	 * Between 1 and 256, 1 disables batching. Default 32.
+	 */
+	udpSendBatchSize?: number;
+
+	/**
+	 * Format of the Channel messages exchanged with the worker. 'msgpack'
+	 * (MessagePack) is cheaper to generate and parse than 'json' for large
+	 * responses (dumps and stats) and frequent notifications (score, trace,
+	 * etc). Default 'json'.
+	 */
+	channelFormat?: 'json' | 'msgpack';
+
+	/**
+	 * Granularity (in milliseconds) of the worker timers. Timers expiring
+	 * within the same interval fire together. Default 1.
+	 */
+	timerGranularity?: number;
+
 	/**
 	 * Custom application data.
 	 */
 	appData?: Record<string, unknown>;
 };
 
-export type WorkerUpdateableSettings = Pick<WorkerSettings, 'logLevel' | 'logTags'>;
+export type WorkerUpdateableSettings = Pick<WorkerSettings, 'logLevel' | 'logTags'> &
+{
+	/**
+	 * Whether the worker collects latency histograms of its media path (check
+	 * worker.getLatencyStats()). Enabling it resets them. Default false.
+	 */
+	latencyStats?: boolean;
+};
 
 /**
  * An object with the fields of the uv_rusage_t struct.
@@ -165,6 +193,49 @@ export type WorkerResourceUsage =
 	/* eslint-enable camelcase */
 };
 
+/**
+ * Latencies (in nanoseconds) recorded in a stage of the worker.
+ */
+export type WorkerLatencyStat =
+{
+	count: number;
+	min: number;
+	max: number;
+	mean: number;
+	p50: number;
+	p90: number;
+	p99: number;
+	p999: number;
+};
+
+export type WorkerLatencyStats =
+{
+	/**
+	 * Whether latency stats are currently being collected.
+	 */
+	enabled: boolean;
+
+	/**
+	 * Latencies of each stage. Processing of received UDP datagrams (udpRecv)
+	 * includes the stages it triggers (srtpDecrypt, producerReceive, etc) and
+	 * so do producerReceive (routerFanout) and consumerSend (srtpEncrypt and
+	 * socketSend). loopIteration is the time the loop is busy in each iteration
+	 * and timerLag the delay of timers.
+	 */
+	stages:
+	{
+		udpRecv: WorkerLatencyStat;
+		srtpDecrypt: WorkerLatencyStat;
+		producerReceive: WorkerLatencyStat;
+		routerFanout: WorkerLatencyStat;
+		consumerSend: WorkerLatencyStat;
+		srtpEncrypt: WorkerLatencyStat;
+		socketSend: WorkerLatencyStat;
+		loopIteration: WorkerLatencyStat;
+		timerLag: WorkerLatencyStat;
+	};
+};
+
 export type WorkerEvents = 
 { 
 	died: [Error];
@@ -235,6 +306,9 @@ export class Worker extends EnhancedEventEmitter<WorkerEvents>
 			rtcMaxPort,
 			dtlsCertificateFile,
 			dtlsPrivateKeyFile,
+			udpSendBatchSize,
+			channelFormat,
+			timerGranularity,
 			appData
 		}: WorkerSettings)
 	{
@@ -278,6 +352,26 @@ export class Worker extends EnhancedEventEmitter<WorkerEvents>
 		if (typeof dtlsPrivateKeyFile === 'string' && dtlsPrivateKeyFile)
 			spawnArgs.push(`--dtlsPrivateKeyFile=${dtlsPrivateKeyFile}`);
 
+		if (typeof udpSendBatchSize === 'number' && !Number.isNaN(udpSendBatchSize))
+		{
+			if (
+				!Number.isInteger(udpSendBatchSize) ||
+				udpSendBatchSize < 1 ||
+				udpSendBatchSize > 256
+			)
+			{
+				throw new TypeError('udpSendBatchSize must be an integer between 1 and 256');
+			}
+
+			spawnArgs.push(`--udpSendBatchSize=${udpSendBatchSize}`);
+		}
+
+		if (typeof channelFormat === 'string' && channelFormat)
+			spawnArgs.push(`--channelFormat=${channelFormat}`);
+
+		if (typeof timerGranularity === 'number' && !Number.isNaN(timerGranularity))
+			spawnArgs.push(`--timerGranularity=${timerGranularity}`);
+
 		logger.debug(
 			'spawning worker process: %s %s', spawnBin, spawnArgs.join(' '));
 
@@ -316,7 +410,8 @@ export class Worker extends EnhancedEventEmitter<WorkerEvents>
 			{
 				producerSocket : this.#child.stdio[3],
 				consumerSocket : this.#child.stdio[4],
-				pid            : this.#pid
+				pid            : this.#pid,
+				channelFormat  : channelFormat
 			});
 
 		this.#payloadChannel = new PayloadChannel(
@@ -562,19 +657,34 @@ export class Worker extends EnhancedEventEmitter<WorkerEvents>
 		return this.#channel.request('worker.getResourceUsage');
 	}
 
+	/**
+	 * Get latency histograms of the worker (enabled with updateSettings()).
+	 */
+	async getLatencyStats(
+		{ reset = false }: { reset?: boolean } = {}
+	): Promise<WorkerLatencyStats>
+	{
+		logger.debug('getLatencyStats()');
+
+		const reqData = { reset };
+
+		return this.#channel.request('worker.getLatencyStats', undefined, reqData);
+	}
+
 	/**
 	 * Update settings.
 	 */
 	async updateSettings(
 		{
 			logLevel,
-			logTags
+			logTags,
+			latencyStats
 		}: WorkerUpdateableSettings = {}
 	): Promise<void>
 	{
 		logger.debug('updateSettings()');
 
-		const reqData = { logLevel, logTags };
+		const reqData = { logLevel, logTags, latencyStats };
 
 		await this.#channel.request('worker.updateSettings', undefined, reqData);
 	}
@@ -623,6 +733,7 @@ export class Worker extends EnhancedEventEmitter<WorkerEvents>
 	async createRouter(
 		{
 			mediaCodecs,
+			sharedRtpPacketHistory = false,
 			appData
 		}: RouterOptions = {}): Promise<Router>
 	{
@@ -634,7 +745,7 @@ export class Worker extends EnhancedEventEmitter<WorkerEvents>
 		// This may throw.
 		const rtpCapabilities = ortc.generateRouterRtpCapabilities(mediaCodecs);
 
-		const reqData = { routerId: uuidv4() };
+		const reqData = { routerId: uuidv4(), sharedRtpPacketHistory };
 
 		await this.#channel.request('worker.createRouter', undefined, reqData);
 
@@ -46,6 +46,8 @@ export async function createWorker(
 		rtcMaxPort = 59999,
 		dtlsCertificateFile,
 		dtlsPrivateKeyFile,
+		udpSendBatchSize,
+		timerGranularity,
 		appData
 	}: WorkerSettings = {}
 ): Promise<Worker>
@@ -63,6 +65,8 @@ export async function createWorker(
 			rtcMaxPort,
 			dtlsCertificateFile,
 			dtlsPrivateKeyFile,
+			udpSendBatchSize,
+			timerGranularity,
 			appData
 		});
 
@@ -0,0 +1,386 @@
+/**
+ * Minimal MessagePack encoder and decoder for the Channel messages exchanged
+ * with the worker (maps, arrays, strings, numbers, booleans and null). It
+ * follows JSON semantics: undefined object values are skipped, undefined
+ * array items and non finite numbers are encoded as null.
+ *
+ * https://github.com/msgpack/msgpack/blob/master/spec.md
+ */
+
+class Encoder
+{
+	#buffer = Buffer.allocUnsafe(1024);
+
+	#length = 0;
+
+	encode(value: any): Buffer
+	{
+		this.#length = 0;
+		this.write(value);
+
+		return this.#buffer.subarray(0, this.#length);
+	}
+
+	private write(value: any): void
+	{
+		switch (typeof value)
+		{
+			case 'string':
+			{
+				this.writeString(value);
+
+				break;
+			}
+
+			case 'number':
+			{
+				this.writeNumber(value);
+
+				break;
+			}
+
+			case 'boolean':
+			{
+				this.ensure(1);
+				this.#buffer[this.#length++] = value ? 0xc3 : 0xc2;
+
+				break;
+			}
+
+			case 'bigint':
+			{
+				this.writeNumber(Number(value));
+
+				break;
+			}
+
+			case 'object':
+			{
+				if (value === null)
+				{
+					this.writeNil();
+				}
+				else if (Array.isArray(value))
+				{
+					this.writeHeader(value.length, 0x90, 0xdc, 0xdd);
+
+					for (const item of value)
+					{
+						this.write(item === undefined ? null : item);
+					}
+				}
+				else if (typeof value.toJSON === 'function')
+				{
+					this.write(value.toJSON());
+				}
+				else
+				{
+					const keys = Object.keys(value)
+						.filter((key) => value[key] !== undefined && typeof value[key] !== 'function');
+
+					this.writeHeader(keys.length, 0x80, 0xde, 0xdf);
+
+					for (const key of keys)
+					{
+						this.writeString(key);
+						this.write(value[key]);
+					}
+				}
+
+				break;
+			}
+
+			default:
+			{
+				this.writeNil();
+			}
+		}
+	}
+
+	private writeNil(): void
+	{
+		this.ensure(1);
+		this.#buffer[this.#length++] = 0xc0;
+	}
+
+	private writeNumber(value: number): void
+	{
+		if (!Number.isFinite(value))
+		{
+			this.writeNil();
+
+			return;
+		}
+
+		this.ensure(9);
+
+		const buffer = this.#buffer;
+
+		if (!Number.isSafeInteger(value))
+		{
+			buffer[this.#length] = 0xcb;
+			buffer.writeDoubleBE(value, this.#length + 1);
+			this.#length += 9;
+		}
+		else if (value >= 0)
+		{
+			if (value < 0x80)
+			{
+				buffer[this.#length++] = value;
+			}
+			else if (value < 0x100)
+			{
+				buffer[this.#length] = 0xcc;
+				buffer[this.#length + 1] = value;
+				this.#length += 2;
+			}
+			else if (value < 0x10000)
+			{
+				buffer[this.#length] = 0xcd;
+				buffer.writeUInt16BE(value, this.#length + 1);
+				this.#length += 3;
+			}
+			else if (value < 0x100000000)
+			{
+				buffer[this.#length] = 0xce;
+				buffer.writeUInt32BE(value, this.#length + 1);
+				this.#length += 5;
+			}
+			else
+			{
+				buffer[this.#length] = 0xcf;
+				buffer.writeBigUInt64BE(BigInt(value), this.#length + 1);
+				this.#length += 9;
+			}
+		}
+		else if (value >= -0x20)
+		{
+			buffer[this.#length++] = value & 0xff;
+		}
+		else if (value >= -0x80)
+		{
+			buffer[this.#length] = 0xd0;
+			buffer.writeInt8(value, this.#length + 1);
+			this.#length += 2;
+		}
+		else if (value >= -0x8000)
+		{
+			buffer[this.#length] = 0xd1;
+			buffer.writeInt16BE(value, this.#length + 1);
+			this.#length += 3;
+		}
+		else if (value >= -0x80000000)
+		{
+			buffer[this.#length] = 0xd2;
+			buffer.writeInt32BE(value, this.#length + 1);
+			this.#length += 5;
+		}
+		else
+		{
+			buffer[this.#length] = 0xd3;
+			buffer.writeBigInt64BE(BigInt(value), this.#length + 1);
+			this.#length += 9;
+		}
+	}
+
+	private writeString(value: string): void
+	{
+		const maxLength = value.length * 3;
+
+		this.ensure(5 + maxLength);
+
+		// Write the string after the largest header and move it if shorter.
+		const length = this.#buffer.write(value, this.#length + 5, 'utf8');
+		let headerLength: number;
+
+		if (length < 0x20)
+			headerLength = 1;
+		else if (length < 0x100)
+			headerLength = 2;
+		else if (length < 0x10000)
+			headerLength = 3;
+		else
+			headerLength = 5;
+
+		if (headerLength !== 5)
+		{
+			this.#buffer.copyWithin(
+				this.#length + headerLength, this.#length + 5, this.#length + 5 + length);
+		}
+
+		this.writeHeader(length, 0xa0, 0xda, 0xdb, 0xd9);
+		this.#length += length;
+	}
+
+	private writeHeader(
+		length: number, fixType: number, type16: number, type32: number, type8?: number
+	): void
+	{
+		this.ensure(5);
+
+		const buffer = this.#buffer;
+
+		// fixstr holds up to 31 bytes, fixmap and fixarray up to 15 items.
+		if (length < (type8 === undefined ? 0x10 : 0x20))
+		{
+			buffer[this.#length++] = fixType | length;
+		}
+		else if (type8 !== undefined && length < 0x100)
+		{
+			buffer[this.#length] = type8;
+			buffer[this.#length + 1] = length;
+			this.#length += 2;
+		}
+		else if (length < 0x10000)
+		{
+			buffer[this.#length] = type16;
+			buffer.writeUInt16BE(length, this.#length + 1);
+			this.#length += 3;
+		}
+		else
+		{
+			buffer[this.#length] = type32;
+			buffer.writeUInt32BE(length, this.#length + 1);
+			this.#length += 5;
+		}
+	}
+
+	private ensure(length: number): void
+	{
+		if (this.#length + length <= this.#buffer.length)
+			return;
+
+		const buffer = Buffer.allocUnsafe(
+			Math.max(this.#buffer.length * 2, this.#length + length));
+
+		this.#buffer.copy(buffer, 0, 0, this.#length);
+		this.#buffer = buffer;
+	}
+}
+
+class Decoder
+{
+	#buffer: Buffer = Buffer.alloc(0);
+
+	#offset = 0;
+
+	decode(buffer: Buffer): any
+	{
+		this.#buffer = buffer;
+		this.#offset = 0;
+
+		const value = this.read();
+
+		if (this.#offset !== buffer.length)
+			throw new TypeError('invalid MessagePack data (trailing bytes)');
+
+		return value;
+	}
+
+	private read(): any
+	{
+		const buffer = this.#buffer;
+
+		if (this.#offset >= buffer.length)
+			throw new TypeError('invalid MessagePack data (truncated)');
+
+		const type = buffer[this.#offset++];
+
+		// positive fixint.
+		if (type < 0x80)
+			return type;
+		// fixmap.
+		else if (type < 0x90)
+			return this.readMap(type & 0x0f);
+		// fixarray.
+		else if (type < 0xa0)
+			return this.readArray(type & 0x0f);
+		// fixstr.
+		else if (type < 0xc0)
+			return this.readString(type & 0x1f);
+		// negative fixint.
+		else if (type >= 0xe0)
+			return type - 0x100;
+
+		let value: any;
+
+		switch (type)
+		{
+			case 0xc0: return null;
+			case 0xc2: return false;
+			case 0xc3: return true;
+			case 0xca: value = buffer.readFloatBE(this.#offset); this.#offset += 4; return value;
+			case 0xcb: value = buffer.readDoubleBE(this.#offset); this.#offset += 8; return value;
+			case 0xcc: return buffer[this.#offset++];
+			case 0xcd: value = buffer.readUInt16BE(this.#offset); this.#offset += 2; return value;
+			case 0xce: value = buffer.readUInt32BE(this.#offset); this.#offset += 4; return value;
+			case 0xcf: value = buffer.readBigUInt64BE(this.#offset); this.#offset += 8; return Number(value);
+			case 0xd0: value = buffer.readInt8(this.#offset); this.#offset += 1; return value;
+			case 0xd1: value = buffer.readInt16BE(this.#offset); this.#offset += 2; return value;
+			case 0xd2: value = buffer.readInt32BE(this.#offset); this.#offset += 4; return value;
+			case 0xd3: value = buffer.readBigInt64BE(this.#offset); this.#offset += 8; return Number(value);
+			case 0xd9: return this.readString(buffer[this.#offset++]);
+			case 0xda: value = buffer.readUInt16BE(this.#offset); this.#offset += 2; return this.readString(value);
+			case 0xdb: value = buffer.readUInt32BE(this.#offset); this.#offset += 4; return this.readString(value);
+			case 0xdc: value = buffer.readUInt16BE(this.#offset); this.#offset += 2; return this.readArray(value);
+			case 0xdd: value = buffer.readUInt32BE(this.#offset); this.#offset += 4; return this.readArray(value);
+			case 0xde: value = buffer.readUInt16BE(this.#offset); this.#offset += 2; return this.readMap(value);
+			case 0xdf: value = buffer.readUInt32BE(this.#offset); this.#offset += 4; return this.readMap(value);
+			default: throw new TypeError(`unsupported MessagePack type 0x${type.toString(16)}`);
+		}
+	}
+
+	private readString(length: number): string
+	{
+		if (this.#offset + length > this.#buffer.length)
+			throw new TypeError('invalid MessagePack data (truncated)');
+
+		const value = this.#buffer.toString('utf8', this.#offset, this.#offset + length);
+
+		this.#offset += length;
+
+		return value;
+	}
+
+	private readArray(length: number): any[]
+	{
+		const value = new Array(length);
+
+		for (let i = 0; i < length; ++i)
+		{
+			value[i] = this.read();
+		}
+
+		return value;
+	}
+
+	private readMap(length: number): any
+	{
+		const value: any = {};
+
+		for (let i = 0; i < length; ++i)
+		{
+			const key = this.read();
+
+			value[String(key)] = this.read();
+		}
+
+		return value;
+	}
+}
+
+const encoder = new Encoder();
+const decoder = new Decoder();
+
+/**
+ * Encodes the given value. The returned Buffer is reused by the next call.
+ */
+export function encode(value: any): Buffer
+{
+	return encoder.encode(value);
+}
+
+export function decode(buffer: Buffer): any
+{
+	return decoder.decode(buffer);
+}
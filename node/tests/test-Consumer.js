@@ -764,6 +764,31 @@ test('consumer.getStats() succeeds', async () =>
 			]);
 }, 2000);
 
+test('router.getConsumersStats() succeeds', async () =>
+{
+	const stats = await router.getConsumersStats();
+
+	expect(stats[audioConsumer.id]).toEqual(
+		[
+			expect.objectContaining(
+				{
+					type : 'outbound-rtp',
+					kind : 'audio',
+					ssrc : audioConsumer.rtpParameters.encodings[0].ssrc
+				})
+		]);
+
+	expect(stats[videoConsumer.id]).toEqual(
+		[
+			expect.objectContaining(
+				{
+					type : 'outbound-rtp',
+					kind : 'video',
+					ssrc : videoConsumer.rtpParameters.encodings[0].ssrc
+				})
+		]);
+}, 2000);
+
 test('consumer.pause() and resume() succeed', async () =>
 {
 	await audioConsumer.pause();
@@ -79,6 +79,15 @@ test('createWorker() with wrong settings rejects with TypeError', async () =>
 		.rejects
 		.toThrow(TypeError);
 
+	// Batch size is from 1 to 256.
+	await expect(createWorker({ udpSendBatchSize: 0 }))
+		.rejects
+		.toThrow(TypeError);
+
+	await expect(createWorker({ udpSendBatchSize: 257 }))
+		.rejects
+		.toThrow(TypeError);
+
 	await expect(createWorker({ appData: 'NOT-AN-OBJECT' }))
 		.rejects
 		.toThrow(TypeError);
@@ -163,6 +172,41 @@ test('worker.getResourceUsage() succeeds', async () =>
 	worker.close();
 }, 2000);
 
+test('worker.getLatencyStats() succeeds', async () =>
+{
+	worker = await createWorker();
+
+	await expect(worker.getLatencyStats())
+		.resolves
+		.toMatchObject({ enabled: false });
+
+	await worker.updateSettings({ latencyStats: true });
+
+	// Loop iterations are recorded once they end, so make the worker loop at
+	// least once more.
+	await worker.getLatencyStats();
+
+	const latencyStats = await worker.getLatencyStats({ reset: true });
+
+	expect(latencyStats.enabled).toBe(true);
+	expect(latencyStats.stages.loopIteration.count).toBeGreaterThan(0);
+	expect(latencyStats.stages.udpRecv).toMatchObject(
+		{
+			count : 0,
+			min   : 0,
+			max   : 0,
+			p50   : 0
+		});
+
+	await worker.updateSettings({ latencyStats: false });
+
+	await expect(worker.getLatencyStats())
+		.resolves
+		.toMatchObject({ enabled: false });
+
+	worker.close();
+}, 2000);
+
 test('worker.close() succeeds', async () =>
 {
 	worker = await createWorker({ logLevel: 'warn' });
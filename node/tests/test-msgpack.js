@@ -0,0 +1,38 @@
+const msgpack = require('../lib/msgpack');
+
+test('encode() and decode() follow JSON semantics', () =>
+{
+	const value =
+	{
+		id       : 1,
+		accepted : true,
+		data     :
+		{
+			integers   : [ 0, 127, 255, 65535, 70000, 5000000000, -1, -33, -200, -70000, -5000000000 ],
+			float      : 1.5,
+			nil        : null,
+			undef      : undefined,
+			nan        : NaN,
+			strings    : [ 'foo', 'x'.repeat(40), 'y'.repeat(300), 'z'.repeat(70000), 'ñ€😀' ],
+			array      : Array.from({ length: 20 }, (_, i) => i),
+			undefArray : [ undefined ]
+		}
+	};
+
+	expect(msgpack.decode(Buffer.from(msgpack.encode(value))))
+		.toEqual(JSON.parse(JSON.stringify(value)));
+});
+
+test('encode() produces standard MessagePack', () =>
+{
+	expect(msgpack.encode({ bitrate: 1000 }).toString('hex'))
+		.toBe('81a762697472617465cd03e8');
+});
+
+test('decode() with truncated data throws', () =>
+{
+	const buffer = Buffer.from(msgpack.encode({ foo: 'bar' }));
+
+	expect(() => msgpack.decode(buffer.subarray(0, buffer.length - 1)))
+		.toThrow(TypeError);
+});
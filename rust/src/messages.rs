@@ -25,11 +25,12 @@ use crate::srtp_parameters::{SrtpCryptoSuite, SrtpParameters};
 use crate::transport::{TransportId, TransportTraceEventType};
 use crate::webrtc_server::{WebRtcServerDump, WebRtcServerId, WebRtcServerListenInfos};
 use crate::webrtc_transport::{TransportListenIps, WebRtcTransportListen, WebRtcTransportOptions};
-use crate::worker::{WorkerDump, WorkerUpdateSettings};
+use crate::worker::{WorkerDump, WorkerLatencyStats, WorkerUpdateSettings};
 use parking_lot::Mutex;
 use serde::de::DeserializeOwned;
 use serde::{Deserialize, Serialize};
 use serde_json::Value;
+use std::collections::HashMap;
 use std::fmt::{Debug, Display};
 use std::net::IpAddr;
 use std::num::NonZeroU16;
@@ -56,6 +57,12 @@ pub(crate) trait Notification: Debug + Serialize {
 
     /// Request event to call on worker.
     fn as_event(&self) -> &'static str;
+
+    /// Event id and PPID if the notification can be pushed to the worker as a binary frame
+    /// (see `PayloadChannelNotification::EventId` in the worker).
+    fn as_binary(&self) -> Option<(u8, u32)> {
+        None
+    }
 }
 
 macro_rules! request_response {
@@ -158,6 +165,13 @@ request_response!(
     WorkerDump
 );
 
+request_response!(
+    &'static str,
+    "worker.getLatencyStats",
+    WorkerGetLatencyStatsRequest { reset: bool },
+    WorkerLatencyStats
+);
+
 request_response!(
     &'static str,
     "worker.updateSettings",
@@ -174,6 +188,7 @@ request_response!(
         #[serde(rename = "webRtcServerId")]
         webrtc_server_id: WebRtcServerId,
         listen_infos: WebRtcServerListenInfos,
+        num_shards: u16,
     },
 );
 
@@ -200,6 +215,7 @@ request_response!(
     "worker.createRouter",
     WorkerCreateRouterRequest {
         router_id: RouterId,
+        shared_rtp_packet_history: bool,
     },
 );
 
@@ -215,12 +231,20 @@ request_response!(
 
 request_response!(RouterId, "router.dump", RouterDumpRequest {}, RouterDump);
 
+request_response!(
+    RouterId,
+    "router.getConsumersStats",
+    RouterGetConsumersStatsRequest {},
+    HashMap<ConsumerId, ConsumerStats>,
+);
+
 #[derive(Debug, Serialize)]
 #[serde(rename_all = "camelCase")]
 pub(crate) struct RouterCreateDirectTransportData {
     transport_id: TransportId,
     direct: bool,
     max_message_size: usize,
+    enable_rtcp_reports: bool,
 }
 
 impl RouterCreateDirectTransportData {
@@ -232,6 +256,7 @@ impl RouterCreateDirectTransportData {
             transport_id,
             direct: true,
             max_message_size: direct_transport_options.max_message_size,
+            enable_rtcp_reports: direct_transport_options.enable_rtcp_reports,
         }
     }
 }
@@ -272,6 +297,8 @@ pub(crate) struct RouterCreateWebrtcTransportRequest {
     prefer_udp: bool,
     prefer_tcp: bool,
     initial_available_outgoing_bitrate: u32,
+    enable_pacing: bool,
+    enable_sender_bwe: bool,
     enable_sctp: bool,
     num_sctp_streams: NumSctpStreams,
     max_sctp_message_size: u32,
@@ -305,6 +332,8 @@ impl RouterCreateWebrtcTransportRequest {
             prefer_tcp: webrtc_transport_options.prefer_tcp,
             initial_available_outgoing_bitrate: webrtc_transport_options
                 .initial_available_outgoing_bitrate,
+            enable_pacing: webrtc_transport_options.enable_pacing,
+            enable_sender_bwe: webrtc_transport_options.enable_sender_bwe,
             enable_sctp: webrtc_transport_options.enable_sctp,
             num_sctp_streams: webrtc_transport_options.num_sctp_streams,
             max_sctp_message_size: webrtc_transport_options.max_sctp_message_size,
@@ -352,6 +381,7 @@ pub(crate) struct RouterCreatePlainTransportData {
     port: Option<u16>,
     rtcp_mux: bool,
     comedia: bool,
+    enable_sender_bwe: bool,
     enable_sctp: bool,
     num_sctp_streams: NumSctpStreams,
     max_sctp_message_size: u32,
@@ -372,6 +402,7 @@ impl RouterCreatePlainTransportData {
             port: plain_transport_options.port,
             rtcp_mux: plain_transport_options.rtcp_mux,
             comedia: plain_transport_options.comedia,
+            enable_sender_bwe: plain_transport_options.enable_sender_bwe,
             enable_sctp: plain_transport_options.enable_sctp,
             num_sctp_streams: plain_transport_options.num_sctp_streams,
             max_sctp_message_size: plain_transport_options.max_sctp_message_size,
@@ -699,6 +730,10 @@ impl Notification for TransportSendRtcpNotification {
     fn as_event(&self) -> &'static str {
         "transport.sendRtcp"
     }
+
+    fn as_binary(&self) -> Option<(u8, u32)> {
+        Some((1, 0))
+    }
 }
 
 request_response!(
@@ -747,6 +782,10 @@ impl Notification for ProducerSendNotification {
     fn as_event(&self) -> &'static str {
         "producer.send"
     }
+
+    fn as_binary(&self) -> Option<(u8, u32)> {
+        Some((2, 0))
+    }
 }
 
 request_response!(
@@ -851,6 +890,10 @@ impl Notification for DataProducerSendNotification {
     fn as_event(&self) -> &'static str {
         "dataProducer.send"
     }
+
+    fn as_binary(&self) -> Option<(u8, u32)> {
+        Some((3, self.ppid))
+    }
 }
 
 request_response!(
@@ -23,7 +23,7 @@ pub(super) mod webrtc_transport;
 
 use crate::active_speaker_observer::{ActiveSpeakerObserver, ActiveSpeakerObserverOptions};
 use crate::audio_level_observer::{AudioLevelObserver, AudioLevelObserverOptions};
-use crate::consumer::{Consumer, ConsumerId, ConsumerOptions};
+use crate::consumer::{Consumer, ConsumerId, ConsumerOptions, ConsumerStats};
 use crate::data_consumer::{DataConsumer, DataConsumerId, DataConsumerOptions};
 use crate::data_producer::{
     DataProducer, DataProducerId, DataProducerOptions, NonClosingDataProducer, WeakDataProducer,
@@ -37,6 +37,7 @@ use crate::messages::{
     RouterCreateDirectTransportRequest, RouterCreatePipeTransportData,
     RouterCreatePipeTransportRequest, RouterCreatePlainTransportData,
     RouterCreatePlainTransportRequest, RouterCreateWebrtcTransportRequest, RouterDumpRequest,
+    RouterGetConsumersStatsRequest,
 };
 use crate::pipe_transport::{
     PipeTransport, PipeTransportOptions, PipeTransportRemoteParameters, WeakPipeTransport,
@@ -61,6 +62,7 @@ use hash_hasher::{HashedMap, HashedSet};
 use log::{debug, error};
 use parking_lot::{Mutex, RwLock};
 use serde::{Deserialize, Serialize};
+use std::collections::HashMap;
 use std::fmt;
 use std::net::{IpAddr, Ipv4Addr};
 use std::ops::Deref;
@@ -85,6 +87,11 @@ uuid_based_wrapper_type!(
 pub struct RouterOptions {
     /// Router media codecs.
     pub media_codecs: Vec<RtpCodecCapability>,
+    /// Store the RTP packets of each producer once for all its consumers instead of once per
+    /// consumer, so retransmissions use less memory with many consumers.
+    ///
+    /// Default `false`.
+    pub shared_rtp_packet_history: bool,
     /// Custom application data.
     pub app_data: AppData,
 }
@@ -95,6 +102,7 @@ impl RouterOptions {
     pub fn new(media_codecs: Vec<RtpCodecCapability>) -> Self {
         Self {
             media_codecs,
+            shared_rtp_packet_history: false,
             app_data: AppData::default(),
         }
     }
@@ -536,6 +544,19 @@ impl Router {
             .await
     }
 
+    /// Returns the stats of all the consumers of the router in a single request. The worker collects
+    /// them in bounded time slices so a router with many consumers doesn't block it.
+    pub async fn get_consumers_stats(
+        &self,
+    ) -> Result<HashMap<ConsumerId, ConsumerStats>, RequestError> {
+        debug!("get_consumers_stats()");
+
+        self.inner
+            .channel
+            .request(self.inner.id, RouterGetConsumersStatsRequest {})
+            .await
+    }
+
     /// Create a [`DirectTransport`].
     ///
     /// Router will be kept alive as long as at least one transport instance is alive.
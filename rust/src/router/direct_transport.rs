@@ -36,6 +36,10 @@ pub struct DirectTransportOptions {
     /// Maximum allowed size for direct messages sent from DataProducers.
     /// Default 262_144.
     pub max_message_size: usize,
+    /// Send periodic RTCP Sender and Receiver Reports of its consumers and producers, and
+    /// probation RTP packets.
+    /// Default false.
+    pub enable_rtcp_reports: bool,
     /// Custom application data.
     pub app_data: AppData,
 }
@@ -44,6 +48,7 @@ impl Default for DirectTransportOptions {
     fn default() -> Self {
         Self {
             max_message_size: 262_144,
+            enable_rtcp_reports: false,
             app_data: AppData::default(),
         }
     }
@@ -132,6 +137,8 @@ enum Notification {
 #[serde(tag = "event", rename_all = "lowercase", content = "data")]
 enum PayloadNotification {
     Rtcp,
+    /// Probation RTP packets, not associated to any consumer.
+    Rtp,
 }
 
 struct Inner {
@@ -463,6 +470,7 @@ impl DirectTransport {
                                 callback(payload);
                             });
                         }
+                        PayloadNotification::Rtp => {}
                     },
                     Err(error) => {
                         error!("Failed to parse payload notification: {}", error);
@@ -141,8 +141,18 @@ pub struct PipeTransportStat {
     pub rtp_packet_loss_received: Option<f64>,
     #[serde(skip_serializing_if = "Option::is_none")]
     pub rtp_packet_loss_sent: Option<f64>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub recv_batch_sizes: Option<Vec<usize>>,
     // PipeTransport specific.
     pub tuple: Option<TransportTuple>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_batch_size: Option<u16>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_batches: Option<usize>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_batched_packets: Option<usize>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_gso_packets: Option<usize>,
 }
 
 /// Remote parameters for pipe transport.
@@ -54,6 +54,11 @@ pub struct PlainTransportOptions {
     /// SRTP is enabled. If so, it must be called with just remote SRTP parameters.
     /// Default false.
     pub comedia: bool,
+    /// Estimate the available outgoing bitrate with the sender side bandwidth estimator (loss, RTT
+    /// and delay based) instead of the transport-cc / REMB one. It also works if the remote
+    /// endpoint just sends RTCP Receiver Reports.
+    /// Default false.
+    pub enable_sender_bwe: bool,
     /// Create a SCTP association.
     /// Default false.
     pub enable_sctp: bool,
@@ -84,6 +89,7 @@ impl PlainTransportOptions {
             port: None,
             rtcp_mux: true,
             comedia: false,
+            enable_sender_bwe: false,
             enable_sctp: false,
             num_sctp_streams: NumSctpStreams::default(),
             max_sctp_message_size: 262_144,
@@ -159,11 +165,21 @@ pub struct PlainTransportStat {
     pub rtp_packet_loss_received: Option<f64>,
     #[serde(skip_serializing_if = "Option::is_none")]
     pub rtp_packet_loss_sent: Option<f64>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub recv_batch_sizes: Option<Vec<usize>>,
     // PlainTransport specific.
     pub rtcp_mux: bool,
     pub comedia: bool,
     pub tuple: Option<TransportTuple>,
     pub rtcp_tuple: Option<TransportTuple>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_batch_size: Option<u16>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_batches: Option<usize>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_batched_packets: Option<usize>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_gso_packets: Option<usize>,
 }
 
 /// Remote parameters for plain transport.
@@ -128,6 +128,15 @@ pub struct WebRtcTransportOptions {
     /// Initial available outgoing bitrate (in bps).
     /// Default 600000.
     pub initial_available_outgoing_bitrate: u32,
+    /// Queue RTP packets sent to consumers and send them by priority (audio, retransmissions,
+    /// video base layer and upper layers) at the pacing rate given by the bandwidth estimation.
+    /// Default false.
+    pub enable_pacing: bool,
+    /// Estimate the available outgoing bitrate with the sender side bandwidth estimator (loss, RTT
+    /// and delay based) instead of the transport-cc / REMB one. It also works if the remote
+    /// endpoint just sends RTCP Receiver Reports.
+    /// Default false.
+    pub enable_sender_bwe: bool,
     /// Create a SCTP association.
     /// Default false.
     pub enable_sctp: bool,
@@ -157,6 +166,8 @@ impl WebRtcTransportOptions {
             prefer_udp: false,
             prefer_tcp: false,
             initial_available_outgoing_bitrate: 600_000,
+            enable_pacing: false,
+            enable_sender_bwe: false,
             enable_sctp: false,
             num_sctp_streams: NumSctpStreams::default(),
             max_sctp_message_size: 262_144,
@@ -174,6 +185,8 @@ impl WebRtcTransportOptions {
             prefer_udp: false,
             prefer_tcp: false,
             initial_available_outgoing_bitrate: 600_000,
+            enable_pacing: false,
+            enable_sender_bwe: false,
             enable_sctp: false,
             num_sctp_streams: NumSctpStreams::default(),
             max_sctp_message_size: 262_144,
@@ -249,12 +262,30 @@ pub struct WebRtcTransportStat {
     pub rtp_packet_loss_received: Option<f64>,
     #[serde(skip_serializing_if = "Option::is_none")]
     pub rtp_packet_loss_sent: Option<f64>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub recv_batch_sizes: Option<Vec<usize>>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub pacing_queue_size: Option<usize>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub pacing_queue_bytes: Option<usize>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub pacing_delay: Option<f64>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub pacing_dropped_packets: Option<u64>,
     // WebRtcTransport specific.
     pub ice_role: IceRole,
     pub ice_state: IceState,
     #[serde(skip_serializing_if = "Option::is_none")]
     pub ice_selected_tuple: Option<TransportTuple>,
     pub dtls_state: DtlsState,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_batch_size: Option<u16>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_batches: Option<usize>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_batched_packets: Option<usize>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub udp_send_gso_packets: Option<usize>,
 }
 
 /// Remote parameters for [`WebRtcTransport`].
@@ -71,6 +71,7 @@ pub struct WebRtcServerDump {
     pub webrtc_transport_ids: HashedSet<TransportId>,
     pub local_ice_username_fragments: Vec<WebRtcServerIceUsernameFragment>,
     pub tuple_hashes: Vec<WebRtcServerTupleHash>,
+    pub dropped_forwarded_packets: Option<u64>,
 }
 
 /// Listening protocol, IP and port for [`WebRtcServer`] to listen on.
@@ -136,6 +137,12 @@ impl TryFrom<Vec<WebRtcServerListenInfo>> for WebRtcServerListenInfos {
 pub struct WebRtcServerOptions {
     /// Listening infos in order of preference (first one is the preferred one).
     pub listen_infos: WebRtcServerListenInfos,
+    /// Number of WebRTC servers (one per worker, all workers running in this process) listening on
+    /// the same UDP IPs and ports using `SO_REUSEPORT`. Each remote tuple is always delivered to
+    /// the same server, which forwards its packets to the server owning the
+    /// [`WebRtcTransport`] if needed. Servers must be created in all the workers with the same
+    /// listen infos. TCP listen infos are not supported. Default 1 (no sharding).
+    pub num_shards: u16,
     /// Custom application data.
     pub app_data: AppData,
 }
@@ -145,6 +152,7 @@ impl WebRtcServerOptions {
     pub fn new(listen_infos: WebRtcServerListenInfos) -> Self {
         Self {
             listen_infos,
+            num_shards: 1,
             app_data: AppData::default(),
         }
     }
@@ -9,7 +9,7 @@ mod utils;
 use crate::data_structures::AppData;
 use crate::messages::{
     WorkerCloseRequest, WorkerCreateRouterRequest, WorkerCreateWebRtcServerRequest,
-    WorkerDumpRequest, WorkerUpdateSettingsRequest,
+    WorkerDumpRequest, WorkerGetLatencyStatsRequest, WorkerUpdateSettingsRequest,
 };
 pub use crate::ortc::RtpCapabilitiesError;
 use crate::router::{Router, RouterId, RouterOptions};
@@ -182,6 +182,17 @@ pub struct WorkerSettings {
     ///
     /// If `None`, a certificate is dynamically created.
     pub dtls_files: Option<WorkerDtlsFiles>,
+    /// Max number of UDP datagrams the worker queues within a loop iteration before writing them
+    /// all at once (using `sendmmsg()` and UDP GSO on Linux). Between 1 and 256, 1 disables
+    /// batching.
+    ///
+    /// Default 32.
+    pub udp_send_batch_size: u16,
+    /// Granularity (in milliseconds) of the worker timers. Timers expiring within the same
+    /// interval fire together.
+    ///
+    /// Default 1.
+    pub timer_granularity: u16,
     /// Function that will be called under worker thread before worker starts, can be used for
     /// pinning worker threads to CPU cores.
     pub thread_initializer: Option<Arc<dyn Fn() + Send + Sync>>,
@@ -210,6 +221,8 @@ impl Default for WorkerSettings {
             ],
             rtc_ports_range: 10000..=59999,
             dtls_files: None,
+            udp_send_batch_size: 32,
+            timer_granularity: 1,
             thread_initializer: None,
             app_data: AppData::default(),
         }
@@ -223,6 +236,8 @@ impl fmt::Debug for WorkerSettings {
             log_tags,
             rtc_ports_range,
             dtls_files,
+            udp_send_batch_size,
+            timer_granularity,
             thread_initializer,
             app_data,
         } = self;
@@ -232,6 +247,8 @@ impl fmt::Debug for WorkerSettings {
             .field("log_tags", &log_tags)
             .field("rtc_ports_range", &rtc_ports_range)
             .field("dtls_files", &dtls_files)
+            .field("udp_send_batch_size", &udp_send_batch_size)
+            .field("timer_granularity", &timer_granularity)
             .field(
                 "thread_initializer",
                 &thread_initializer.as_ref().map(|_| "ThreadInitializer"),
@@ -255,6 +272,11 @@ pub struct WorkerUpdateSettings {
     ///
     /// If `None`, log tags will not be updated.
     pub log_tags: Option<Vec<WorkerLogTag>>,
+    /// Whether the worker collects latency histograms of its media path (see
+    /// [`Worker::get_latency_stats`]). Enabling it resets them.
+    ///
+    /// If `None`, it will not be updated.
+    pub latency_stats: Option<bool>,
 }
 
 #[derive(Debug, Clone, Deserialize, Serialize, Eq, PartialEq)]
@@ -278,6 +300,51 @@ pub struct WorkerDump {
     pub channel_message_handlers: ChannelMessageHandlers,
 }
 
+/// Latencies (in nanoseconds) recorded in a stage of the worker.
+#[derive(Debug, Copy, Clone, Default, Deserialize, Serialize, Eq, PartialEq)]
+#[non_exhaustive]
+pub struct WorkerLatencyStat {
+    pub count: u64,
+    pub min: u64,
+    pub max: u64,
+    pub mean: u64,
+    pub p50: u64,
+    pub p90: u64,
+    pub p99: u64,
+    pub p999: u64,
+}
+
+/// Latencies of each stage of the worker.
+///
+/// Processing of received UDP datagrams (`udp_recv`) includes the stages it triggers
+/// (`srtp_decrypt`, `producer_receive`, etc) and so do `producer_receive` (`router_fanout`) and
+/// `consumer_send` (`srtp_encrypt` and `socket_send`).
+#[derive(Debug, Copy, Clone, Default, Deserialize, Serialize, Eq, PartialEq)]
+#[serde(rename_all = "camelCase")]
+#[non_exhaustive]
+pub struct WorkerLatencyStages {
+    pub udp_recv: WorkerLatencyStat,
+    pub srtp_decrypt: WorkerLatencyStat,
+    pub producer_receive: WorkerLatencyStat,
+    pub router_fanout: WorkerLatencyStat,
+    pub consumer_send: WorkerLatencyStat,
+    pub srtp_encrypt: WorkerLatencyStat,
+    pub socket_send: WorkerLatencyStat,
+    /// Time the loop is busy in each iteration.
+    pub loop_iteration: WorkerLatencyStat,
+    /// Delay of timers.
+    pub timer_lag: WorkerLatencyStat,
+}
+
+/// Latency histograms of the worker.
+#[derive(Debug, Copy, Clone, Default, Deserialize, Serialize, Eq, PartialEq)]
+#[non_exhaustive]
+pub struct WorkerLatencyStats {
+    /// Whether latency stats are currently being collected.
+    pub enabled: bool,
+    pub stages: WorkerLatencyStages,
+}
+
 /// Error that caused [`Worker::create_webrtc_server`] to fail.
 #[derive(Debug, Error, Eq, PartialEq)]
 pub enum CreateWebRtcServerError {
@@ -335,6 +402,8 @@ impl Inner {
             log_tags,
             rtc_ports_range,
             dtls_files,
+            udp_send_batch_size,
+            timer_granularity,
             thread_initializer,
             app_data,
         }: WorkerSettings,
@@ -376,6 +445,22 @@ impl Inner {
             ));
         }
 
+        if !(1..=256).contains(&udp_send_batch_size) {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidInput,
+                "Invalid UDP send batch size, must be between 1 and 256",
+            ));
+        }
+        spawn_args.push(format!("--udpSendBatchSize={}", udp_send_batch_size));
+
+        if timer_granularity == 0 {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidInput,
+                "Invalid timer granularity",
+            ));
+        }
+        spawn_args.push(format!("--timerGranularity={}", timer_granularity));
+
         let id = WorkerId::new();
         debug!(
             "spawning worker with arguments [id:{}]: {}",
@@ -627,6 +712,17 @@ impl Worker {
         self.inner.channel.request("", WorkerDumpRequest {}).await
     }
 
+    /// Get latency histograms of the worker (enabled with [`Worker::update_settings`]), resetting
+    /// them afterwards if `reset` is `true`.
+    pub async fn get_latency_stats(&self, reset: bool) -> Result<WorkerLatencyStats, RequestError> {
+        debug!("get_latency_stats()");
+
+        self.inner
+            .channel
+            .request("", WorkerGetLatencyStatsRequest { reset })
+            .await
+    }
+
     /// Updates the worker settings in runtime. Just a subset of the worker settings can be updated.
     pub async fn update_settings(&self, data: WorkerUpdateSettings) -> Result<(), RequestError> {
         debug!("update_settings()");
@@ -648,6 +744,7 @@ impl Worker {
 
         let WebRtcServerOptions {
             listen_infos,
+            num_shards,
             app_data,
         } = webrtc_server_options;
 
@@ -665,6 +762,7 @@ impl Worker {
                 WorkerCreateWebRtcServerRequest {
                     webrtc_server_id,
                     listen_infos,
+                    num_shards,
                 },
             )
             .await
@@ -698,6 +796,7 @@ impl Worker {
         let RouterOptions {
             app_data,
             media_codecs,
+            shared_rtp_packet_history,
         } = router_options;
 
         let rtp_capabilities = ortc::generate_router_rtp_capabilities(media_codecs)
@@ -709,7 +808,13 @@ impl Worker {
 
         self.inner
             .channel
-            .request("", WorkerCreateRouterRequest { router_id })
+            .request(
+                "",
+                WorkerCreateRouterRequest {
+                    router_id,
+                    shared_rtp_packet_history,
+                },
+            )
             .await
             .map_err(CreateRouterError::Request)?;
 
@@ -350,6 +350,35 @@ impl PayloadChannel {
     {
         debug!("notify() [event:{}]", notification.as_event());
 
+        // Binary fast path, skipping serialization and parsing in the worker. Only taken when no
+        // message is queued so notifications are not reordered.
+        if let Some((event_id, ppid)) = notification.as_binary() {
+            let outgoing_message_buffer = self.inner.outgoing_message_buffer.lock();
+            if let Some(handle) = outgoing_message_buffer.handle {
+                if outgoing_message_buffer.messages.is_empty() {
+                    if self.inner.worker_closed.load(Ordering::Acquire) {
+                        return Err(NotificationError::ChannelClosed);
+                    }
+                    let handler_id = handler_id.to_string();
+                    // The lock above ensures a single producer at a time.
+                    let ret = unsafe {
+                        mediasoup_sys::mediasoup_worker_payload_channel_push(
+                            handle,
+                            event_id,
+                            handler_id.as_ptr().cast(),
+                            handler_id.len() as u32,
+                            ppid,
+                            payload.as_ptr(),
+                            payload.len() as u32,
+                        )
+                    };
+                    if ret == 0 {
+                        return Ok(());
+                    }
+                }
+            }
+        }
+
         // TODO: Todo pre-allocate fixed size string sufficient for most cases by default
         // TODO: Refactor to avoid extra allocation during JSON serialization if possible
         let message = format!(
@@ -103,6 +103,23 @@ fn create_worker_wrong_settings() {
 
             assert!(matches!(worker_result, Err(io::Error { .. })));
         }
+
+        for udp_send_batch_size in [0, 257] {
+            let worker_result = worker_manager
+                .create_worker({
+                    let mut settings = WorkerSettings::default();
+
+                    settings.udp_send_batch_size = udp_send_batch_size;
+
+                    settings
+                })
+                .await;
+
+            assert!(matches!(
+                worker_result,
+                Err(ref error) if error.kind() == io::ErrorKind::InvalidInput
+            ));
+        }
     });
 }
 
@@ -0,0 +1,19 @@
+#ifndef MS_BENCH_ALLOCATIONS_HPP
+#define MS_BENCH_ALLOCATIONS_HPP
+
+#include "common.hpp"
+
+namespace Bench
+{
+	// Counts the heap allocations done with the global operator new, which is
+	// replaced by the bench binary.
+	namespace Allocations
+	{
+		void StartCounting();
+		void StopCounting();
+		uint64_t GetCount();
+		void Reset();
+	} // namespace Allocations
+} // namespace Bench
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef MS_BENCH_FANOUT_SCENARIO_HPP
+#define MS_BENCH_FANOUT_SCENARIO_HPP
+
+#include "common.hpp"
+#include "RtpGenerator.hpp"
+#include "Channel/ChannelSocket.hpp"
+#include "PayloadChannel/PayloadChannelNotification.hpp"
+#include "PayloadChannel/PayloadChannelSocket.hpp"
+#include "RTC/Router.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace Bench
+{
+	// A Router with a Producer in a DirectTransport, fed by a RtpGenerator, and
+	// N Consumers of it, each one in its own PlainTransport (sending to a local
+	// UDP sink socket) or DirectTransport. Everything is driven in-process
+	// through the Channel request handlers, as the Worker does.
+	class FanoutScenario : public RTC::Router::Listener
+	{
+	public:
+		enum class TransportType : uint8_t
+		{
+			PLAIN = 0,
+			DIRECT
+		};
+
+	public:
+		struct Options
+		{
+			RtpGenerator::Codec codec{ RtpGenerator::Codec::VP8 };
+			TransportType transportType{ TransportType::PLAIN };
+			size_t consumers{ 100u };
+			bool srtp{ false };
+			bool sharedRtpPacketHistory{ false };
+			size_t keyFrameInterval{ 100u };
+		};
+
+	public:
+		explicit FanoutScenario(const Options& options);
+		~FanoutScenario() override;
+
+	public:
+		uint32_t GetFrameRate() const
+		{
+			return this->generator.GetFrameRate();
+		}
+		// Creates the Consumers, once the Producer streams are active.
+		void CreateConsumers();
+		// Injects the packets of the next frame into the Producer and flushes the
+		// UDP send batch. Returns the number of injected packets.
+		size_t SendFrame();
+		// Runs pending libuv callbacks (timers, RTCP) without blocking.
+		void RunLoop();
+		// Reads (and discards) the datagrams received by the sink socket.
+		// Returns the number of read datagrams.
+		size_t DrainSink();
+		// Sum of the RTP packets sent by all the Consumers.
+		uint64_t GetConsumersPacketCount();
+
+		/* Pure virtual methods inherited from RTC::Router::Listener. */
+	public:
+		RTC::WebRtcServer* OnRouterNeedWebRtcServer(
+		  RTC::Router* router, std::string& webRtcServerId) override;
+
+	private:
+		// Sends a Channel request and returns the response `data` (if any).
+		// Throws MediaSoupError if the request is rejected.
+		json Request(const std::string& method, const std::string& handlerId, const json& data);
+		void CreateSink();
+		void CreateConsumer(size_t idx);
+
+	private:
+		static ChannelReadFreeFn OnChannelRead(
+		  uint8_t** message,
+		  uint32_t* messageLen,
+		  size_t* messageCtx,
+		  const void* handle,
+		  ChannelReadCtx ctx);
+		static PayloadChannelReadFreeFn OnPayloadChannelRead(
+		  uint8_t** message,
+		  uint32_t* messageLen,
+		  size_t* messageCtx,
+		  uint8_t** payload,
+		  uint32_t* payloadLen,
+		  size_t* payloadCapacity,
+		  const void* handle,
+		  PayloadChannelReadCtx ctx);
+		static void OnChannelWrite(const uint8_t* message, uint32_t messageLen, ChannelWriteCtx ctx);
+		static void OnPayloadChannelWrite(
+		  const uint8_t* message,
+		  uint32_t messageLen,
+		  const uint8_t* payload,
+		  uint32_t payloadLen,
+		  ChannelWriteCtx ctx);
+
+	private:
+		// Passed by argument.
+		Options options;
+		// Allocated by this.
+		Channel::ChannelSocket* channel{ nullptr };
+		PayloadChannel::PayloadChannelSocket* payloadChannel{ nullptr };
+		RTC::Router* router{ nullptr };
+		// Others.
+		RtpGenerator generator;
+		PayloadChannel::PayloadChannelNotification notification;
+		std::vector<std::string> consumerIds;
+		uint32_t nextRequestId{ 1u };
+		json lastResponse;
+		int sinkFd{ -1 };
+		uint16_t sinkPort{ 0u };
+		uint8_t sinkBuffer[RTC::MtuSize];
+	};
+} // namespace Bench
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef MS_BENCH_FEEDBACK_SCENARIO_HPP
+#define MS_BENCH_FEEDBACK_SCENARIO_HPP
+
+#include "common.hpp"
+#include "RTC/RTCP/FeedbackRtpTransport.hpp"
+#include "RTC/TransportCongestionControlClient.hpp"
+#include <vector>
+
+namespace Bench
+{
+	// The TransportCongestionControlClient of a single transport sending video
+	// packets and receiving a transport-wide CC feedback for every few of them,
+	// as generated by a receiver with a constant network delay and some packet
+	// loss. Feedbacks are passed to the client in batches of the given size, as
+	// if they were received within the same batch of datagrams.
+	class FeedbackScenario : public RTC::TransportCongestionControlClient::Listener
+	{
+	public:
+		struct Options
+		{
+			size_t packetsPerFeedback{ 10u };
+			size_t feedbacksPerBatch{ 1u };
+		};
+
+	public:
+		explicit FeedbackScenario(const Options& options);
+		~FeedbackScenario() override;
+
+	public:
+		// Notifies the client about the packets covered by the next batch of
+		// feedbacks as inserted and sent.
+		void SendPackets();
+		// Generates and parses the next batch of feedbacks.
+		void CreateFeedbacks();
+		// Passes the generated feedbacks to the client. Returns the number of
+		// processed feedbacks.
+		size_t ReceiveFeedbacks();
+		uint32_t GetAvailableBitrate() const
+		{
+			return this->tccClient->GetAvailableBitrate();
+		}
+
+		/* Pure virtual methods inherited from RTC::TransportCongestionControlClient::Listener. */
+	public:
+		void OnTransportCongestionControlClientBitrates(
+		  RTC::TransportCongestionControlClient* tccClient,
+		  RTC::TransportCongestionControlClient::Bitrates& bitrates) override;
+		void OnTransportCongestionControlClientSendRtpPacket(
+		  RTC::TransportCongestionControlClient* tccClient,
+		  RTC::RtpPacket* packet,
+		  const webrtc::PacedPacketInfo& pacingInfo) override;
+		void OnTransportCongestionControlClientSendQueuedRtpPacket(
+		  RTC::TransportCongestionControlClient* tccClient,
+		  RTC::Consumer* consumer,
+		  RTC::RtpPacket* packet,
+		  bool retransmission) override;
+
+	private:
+		void ClearFeedbacks();
+
+	private:
+		// Passed by argument.
+		Options options;
+		// Allocated by this.
+		RTC::TransportCongestionControlClient* tccClient{ nullptr };
+		std::vector<RTC::RTCP::FeedbackRtpTransportPacket*> feedbacks;
+		// Others.
+		uint16_t sentWideSeq{ 0u };
+		uint16_t sentRtpSeq{ 0u };
+		uint16_t receivedWideSeq{ 0u };
+		// Remote clock of the receiver (in ms).
+		uint64_t receivedAtMs{ 0u };
+		uint8_t feedbackPacketCount{ 0u };
+		std::vector<uint8_t> buffer;
+	};
+} // namespace Bench
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef MS_BENCH_LISTENER_SCENARIO_HPP
+#define MS_BENCH_LISTENER_SCENARIO_HPP
+
+#include "common.hpp"
+#include "RTC/Producer.hpp"
+#include "RTC/RtpListener.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <vector>
+
+namespace Bench
+{
+	// N video Producers in the RtpListener of a single Transport, each one with
+	// a MID and 3 simulcast streams with RTX. Even Producers signal the SSRCs of
+	// their streams while odd ones just signal RIDs, so the first packets of
+	// their streams are resolved by MID and RID (or repaired RID).
+	class ListenerScenario : public RTC::Producer::Listener
+	{
+	public:
+		struct Options
+		{
+			size_t producers{ 10000u };
+		};
+
+	public:
+		explicit ListenerScenario(const Options& options);
+		~ListenerScenario() override;
+
+	public:
+		size_t GetStreamCount() const
+		{
+			return this->packets.size();
+		}
+		void AddProducers();
+		void RemoveProducers();
+		// Resolves a packet of every stream. Returns the number of packets
+		// resolved to the expected Producer.
+		size_t LookupPackets();
+		// Removes the SSRCs learnt by the RtpListener, so the next packets of
+		// the streams of odd Producers are resolved again by MID and RID.
+		void ForgetLearntSsrcs();
+
+		/* Pure virtual methods inherited from RTC::Producer::Listener. */
+	public:
+		void OnProducerReceiveData(RTC::Producer* producer, size_t len) override;
+		void OnProducerReceiveRtpPacket(RTC::Producer* producer, RTC::RtpPacket* packet) override;
+		void OnProducerPaused(RTC::Producer* producer) override;
+		void OnProducerResumed(RTC::Producer* producer) override;
+		void OnProducerNewRtpStream(
+		  RTC::Producer* producer, RTC::RtpStream* rtpStream, uint32_t mappedSsrc) override;
+		void OnProducerRtpStreamScore(
+		  RTC::Producer* producer,
+		  RTC::RtpStream* rtpStream,
+		  uint8_t score,
+		  uint8_t previousScore) override;
+		void OnProducerRtcpSenderReport(
+		  RTC::Producer* producer, RTC::RtpStream* rtpStream, bool first) override;
+		void OnProducerRtpPacketReceived(RTC::Producer* producer, RTC::RtpPacket* packet) override;
+		void OnProducerSendRtcpPacket(RTC::Producer* producer, RTC::RTCP::Packet* packet) override;
+		void OnProducerNeedWorstRemoteFractionLost(
+		  RTC::Producer* producer, uint32_t mappedSsrc, uint8_t& worstRemoteFractionLost) override;
+
+	private:
+		void CreateProducer(size_t idx);
+		void CreatePacket(size_t producerIdx, size_t streamIdx);
+
+	private:
+		struct PacketBuffer
+		{
+			uint8_t data[64];
+		};
+
+	private:
+		// Passed by argument.
+		Options options;
+		// Others.
+		RTC::RtpListener listener;
+		std::vector<RTC::Producer*> producers;
+		std::vector<PacketBuffer> buffers;
+		std::vector<RTC::RtpPacket*> packets;
+		// Producer expected for each packet.
+		std::vector<RTC::Producer*> packetProducers;
+	};
+} // namespace Bench
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef MS_BENCH_NETWORK_LINK_HPP
+#define MS_BENCH_NETWORK_LINK_HPP
+
+#include "common.hpp"
+#include "Utils.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <deque>
+#include <map>
+#include <random>
+
+namespace Bench
+{
+	// One way network path emulated in virtual time: a drop-tail bottleneck
+	// queue drained at the link capacity, followed by a propagation delay with
+	// jitter, random losses and reordering. Random decisions come from a seeded
+	// generator so a run can be replayed exactly.
+	//
+	// Cross traffic can be injected into the bottleneck queue. It competes with
+	// the given packets for the capacity but it's never delivered.
+	class NetworkLink
+	{
+	public:
+		struct Options
+		{
+			// Capacity in bps.
+			uint32_t capacity{ 1000000u };
+			// Maximum queuing delay (at the current capacity) before dropping.
+			uint32_t queueMs{ 100u };
+			// One way propagation delay.
+			uint32_t delayMs{ 25u };
+			// Maximum extra delay added to each packet. Packets are not reordered
+			// by jitter.
+			uint32_t jitterMs{ 0u };
+			// Ratio of packets lost after the bottleneck.
+			double lossRatio{ 0 };
+			// Ratio of packets delayed `reorderDelayMs` more than the following ones.
+			double reorderRatio{ 0 };
+			uint32_t reorderDelayMs{ 20u };
+			uint32_t seed{ 1u };
+		};
+
+	public:
+		struct Packet
+		{
+			uint8_t data[RTC::MtuSize + 100];
+			size_t len{ 0u };
+			bool isCrossTraffic{ false };
+			uint64_t sentAtUs{ 0u };
+		};
+
+	public:
+		struct Stats
+		{
+			uint64_t sentPackets{ 0u };
+			uint64_t queueDroppedPackets{ 0u };
+			uint64_t lostPackets{ 0u };
+			uint64_t deliveredPackets{ 0u };
+			uint64_t deliveredBytes{ 0u };
+			uint64_t crossTrafficBytes{ 0u };
+		};
+
+	public:
+		explicit NetworkLink(const Options& options);
+
+	public:
+		uint32_t GetCapacity() const
+		{
+			return this->capacity;
+		}
+		void SetCapacity(uint32_t capacity)
+		{
+			this->capacity = capacity;
+		}
+		// Enqueues a packet sent at `nowUs`. Returns false if the queue is full.
+		bool Send(const uint8_t* data, size_t len, uint64_t nowUs);
+		// Enqueues `len` bytes of cross traffic sent at `nowUs`.
+		void SendCrossTraffic(size_t len, uint64_t nowUs);
+		// Drains the bottleneck queue up to `nowUs`. Must be called at least
+		// once per millisecond.
+		void Process(uint64_t nowUs);
+		// Calls `onPacket(data, len)` for each packet arriving up to `nowUs`, in
+		// arrival order.
+		template<typename F>
+		void Receive(uint64_t nowUs, F onPacket)
+		{
+			while (!this->inFlight.empty() && this->inFlight.begin()->first <= nowUs)
+			{
+				auto it = this->inFlight.begin();
+
+				this->stats.deliveredPackets++;
+				this->stats.deliveredBytes += it->second.len;
+
+				onPacket(it->second.data, it->second.len);
+
+				this->inFlight.erase(it);
+			}
+		}
+		const Stats& GetStats() const
+		{
+			return this->stats;
+		}
+		// Queuing delays (nanoseconds) of the packets that left the bottleneck,
+		// cross traffic excluded.
+		Utils::LatencyHistogram& GetQueueDelays()
+		{
+			return this->queueDelays;
+		}
+
+	private:
+		bool Enqueue(Packet& packet, uint64_t nowUs);
+
+	private:
+		// Passed by argument.
+		Options options;
+		// Others.
+		uint32_t capacity{ 0u };
+		std::mt19937 random;
+		std::uniform_real_distribution<double> uniform{ 0, 1 };
+		std::deque<Packet> queue;
+		size_t queueBytes{ 0u };
+		// Bits that can still be transmitted in the current millisecond.
+		uint64_t credit{ 0u };
+		uint64_t lastProcessedAtUs{ 0u };
+		// Packets already transmitted, by arrival time.
+		std::multimap<uint64_t, Packet> inFlight;
+		uint64_t lastArrivalAtUs{ 0u };
+		Stats stats;
+		Utils::LatencyHistogram queueDelays;
+	};
+} // namespace Bench
+
+#endif
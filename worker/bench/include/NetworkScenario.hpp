@@ -0,0 +1,214 @@
+#ifndef MS_BENCH_NETWORK_SCENARIO_HPP
+#define MS_BENCH_NETWORK_SCENARIO_HPP
+
+#include "common.hpp"
+#include "NetworkLink.hpp"
+#include "RtpGenerator.hpp"
+#include "Channel/ChannelSocket.hpp"
+#include "PayloadChannel/PayloadChannelNotification.hpp"
+#include "PayloadChannel/PayloadChannelSocket.hpp"
+#include "RTC/Router.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace Bench
+{
+	// Congestion control of a Transport evaluated over an emulated network, in
+	// virtual time. A Consumer in a DirectTransport (the sender) consumes a
+	// Producer fed by a RtpGenerator. Its RTP and RTCP go through a forward
+	// NetworkLink into a DirectTransport with a Producer mirroring the Consumer
+	// (the receiver), whose RTCP (transport-cc, REMB, Receiver Reports, NACK)
+	// goes back through a reverse NetworkLink.
+	//
+	// The capacity of the forward link and the cross traffic on it follow a
+	// profile made of phases. For each phase the scenario reports:
+	//
+	// - Convergence time: since the phase start, until the available outgoing
+	//   bitrate of the sender stays within `convergenceTolerance` of the
+	//   available capacity (capacity minus cross traffic).
+	// - Utilization: delivered bits divided by the available capacity.
+	// - Queuing delay of the bottleneck (mean and 95th percentile).
+	//
+	// Requires the virtual clock of DepLibUV (MS_VIRTUAL_CLOCK). Probation
+	// packets are not sent by DirectTransports so the bandwidth is discovered
+	// with media only.
+	class NetworkScenario : public RTC::Router::Listener
+	{
+	public:
+		enum class Profile : uint8_t
+		{
+			// 2.5 Mbps, then 1 Mbps at 20 s and 2.5 Mbps again at 40 s.
+			STEP_DOWN = 0,
+			// 2.5 Mbps with 1.25 Mbps of cross traffic from 15 s to 35 s.
+			CROSS_TRAFFIC,
+			// Replay of a LTE like capacity trace.
+			LTE
+		};
+
+	public:
+		enum class Feedback : uint8_t
+		{
+			TRANSPORT_CC = 0,
+			REMB,
+			// Just RTCP Receiver Reports (for the sender side BWE).
+			RR
+		};
+
+	public:
+		struct Options
+		{
+			Profile profile{ Profile::STEP_DOWN };
+			// File with a "<ms> <bps>" capacity trace (one per line) replacing the
+			// canned LTE trace.
+			std::string traceFile;
+			RtpGenerator::Codec codec{ RtpGenerator::Codec::VP8 };
+			size_t packetsPerFrame{ 10u };
+			Feedback feedback{ Feedback::TRANSPORT_CC };
+			bool pacing{ false };
+			bool senderBwe{ false };
+			// Used by both links. The capacity is given by the profile in the
+			// forward link, and losses and reordering just happen on it.
+			NetworkLink::Options link;
+			double convergenceTolerance{ 0.25 };
+		};
+
+	public:
+		struct PhaseResult
+		{
+			uint64_t startMs{ 0u };
+			uint64_t endMs{ 0u };
+			// Available capacity at the phase start.
+			uint32_t availableCapacity{ 0u };
+			// -1 if it didn't converge.
+			int64_t convergenceMs{ -1 };
+			double utilization{ 0 };
+			uint32_t deliveredBitrate{ 0u };
+			uint32_t availableOutgoingBitrate{ 0u };
+			double queueDelayMeanMs{ 0 };
+			double queueDelayP95Ms{ 0 };
+			uint64_t queueDroppedPackets{ 0u };
+			uint64_t lostPackets{ 0u };
+		};
+
+	public:
+		struct Result
+		{
+			std::vector<PhaseResult> phases;
+			double utilization{ 0 };
+			uint64_t sentPackets{ 0u };
+			uint64_t queueDroppedPackets{ 0u };
+			uint64_t lostPackets{ 0u };
+		};
+
+	public:
+		static Profile GetProfile(const std::string& name);
+		static const std::string& GetProfileName(Profile profile);
+		static Feedback GetFeedback(const std::string& name);
+		static const std::string& GetFeedbackName(Feedback feedback);
+
+	private:
+		// Capacity and cross traffic from the given time. Segments starting a
+		// new phase are reported separately.
+		struct Segment
+		{
+			uint64_t startMs;
+			uint32_t capacity;
+			uint32_t crossTraffic;
+			bool newPhase;
+		};
+
+	public:
+		explicit NetworkScenario(const Options& options);
+		~NetworkScenario() override;
+
+	public:
+		uint64_t GetDurationMs() const
+		{
+			return this->durationMs;
+		}
+		// Runs the whole profile in virtual time.
+		Result Run();
+
+		/* Pure virtual methods inherited from RTC::Router::Listener. */
+	public:
+		RTC::WebRtcServer* OnRouterNeedWebRtcServer(
+		  RTC::Router* router, std::string& webRtcServerId) override;
+
+	private:
+		// Sends a Channel request and returns the response `data` (if any).
+		// Throws MediaSoupError if the request is rejected.
+		json Request(const std::string& method, const std::string& handlerId, const json& data);
+		void LoadProfile();
+		void LoadTraceFile();
+		void CreateProducer();
+		void CreateSenderAndReceiver();
+		// Advances the virtual clock 1 ms, delivering the packets and firing the
+		// timers due until then.
+		void Step();
+		void SendFrame();
+		// Sends a Sender Report for each Producer stream, as the source would.
+		void SendSenderReports();
+		void SendCrossTraffic();
+		void SendNotification(
+		  PayloadChannel::PayloadChannelNotification::EventId eventId,
+		  const std::string& handlerId,
+		  const uint8_t* data,
+		  size_t len);
+		uint32_t GetAvailableOutgoingBitrate();
+		void HandleRtcpToProducer(const uint8_t* data, size_t len);
+		void OnPayloadChannelMessage(
+		  const uint8_t* message, uint32_t messageLen, const uint8_t* payload, uint32_t payloadLen);
+
+	private:
+		static ChannelReadFreeFn OnChannelRead(
+		  uint8_t** message,
+		  uint32_t* messageLen,
+		  size_t* messageCtx,
+		  const void* handle,
+		  ChannelReadCtx ctx);
+		static PayloadChannelReadFreeFn OnPayloadChannelRead(
+		  uint8_t** message,
+		  uint32_t* messageLen,
+		  size_t* messageCtx,
+		  uint8_t** payload,
+		  uint32_t* payloadLen,
+		  size_t* payloadCapacity,
+		  const void* handle,
+		  PayloadChannelReadCtx ctx);
+		static void OnChannelWrite(const uint8_t* message, uint32_t messageLen, ChannelWriteCtx ctx);
+		static void OnPayloadChannelWrite(
+		  const uint8_t* message,
+		  uint32_t messageLen,
+		  const uint8_t* payload,
+		  uint32_t payloadLen,
+		  ChannelWriteCtx ctx);
+
+	private:
+		// Passed by argument.
+		Options options;
+		// Allocated by this.
+		Channel::ChannelSocket* channel{ nullptr };
+		PayloadChannel::PayloadChannelSocket* payloadChannel{ nullptr };
+		RTC::Router* router{ nullptr };
+		// Others.
+		RtpGenerator generator;
+		NetworkLink forwardLink;
+		NetworkLink reverseLink;
+		PayloadChannel::PayloadChannelNotification notification;
+		std::vector<Segment> segments;
+		uint64_t durationMs{ 0u };
+		// Virtual time since the scenario started.
+		uint64_t nowMs{ 0u };
+		uint64_t sentFrames{ 0u };
+		uint32_t crossTraffic{ 0u };
+		// Cross traffic bits not sent yet.
+		uint64_t crossTrafficCredit{ 0u };
+		uint32_t nextRequestId{ 1u };
+		json lastResponse;
+	};
+} // namespace Bench
+
+#endif
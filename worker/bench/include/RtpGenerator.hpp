@@ -0,0 +1,112 @@
+#ifndef MS_BENCH_RTP_GENERATOR_HPP
+#define MS_BENCH_RTP_GENERATOR_HPP
+
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace Bench
+{
+	// Generates the RTP packets of a synthetic media source, frame by frame.
+	// Packets carry valid payload descriptors so the Producer and Consumers
+	// take the same code paths (layer detection, key frames, rewriting) as with
+	// real encoders.
+	//
+	// - vp8: 3 simulcast streams with 3 temporal layers each (L1T3).
+	// - vp9: 1 stream with 3 spatial and 3 temporal layers (L3T3).
+	// - h264: 1 stream, SPS and IDR packets on key frames.
+	// - opus: 1 audio stream with the ssrc-audio-level extension.
+	//
+	// Each video frame (or layer frame) is split into `packetsPerFrame` packets
+	// so higher bitrates can be generated.
+	class RtpGenerator
+	{
+	public:
+		enum class Codec : uint8_t
+		{
+			VP8 = 0,
+			VP9,
+			H264,
+			OPUS
+		};
+
+	public:
+		struct Packet
+		{
+			uint8_t data[RTC::MtuSize];
+			size_t len{ 0u };
+		};
+
+	public:
+		static Codec GetCodec(const std::string& name);
+		static const std::string& GetCodecName(Codec codec);
+
+	public:
+		RtpGenerator(Codec codec, size_t keyFrameInterval, size_t packetsPerFrame = 1u);
+
+	public:
+		Codec GetCodec() const
+		{
+			return this->codec;
+		}
+		bool IsVideo() const
+		{
+			return this->codec != Codec::OPUS;
+		}
+		const std::vector<uint32_t>& GetSsrcs() const
+		{
+			return this->ssrcs;
+		}
+		// Frames per second of the source.
+		uint32_t GetFrameRate() const
+		{
+			return IsVideo() ? 30u : 50u;
+		}
+		// RTP timestamp of the next frame.
+		uint32_t GetTimestamp() const
+		{
+			return this->timestamp;
+		}
+		// Fills the Producer `rtpParameters` and `rtpMapping`.
+		void FillProducerParameters(json& rtpParameters, json& rtpMapping) const;
+		// Fills the Consumer `rtpParameters`, `type` and `consumableRtpEncodings`
+		// of a `transport.consume` request.
+		void FillConsumerParameters(json& data) const;
+		// Makes the next frame a key frame.
+		void RequestKeyFrame()
+		{
+			this->keyFrameRequested = true;
+		}
+		// Generates the packets of the next frame, valid until the next call.
+		const std::vector<Packet>& NextFrame();
+
+	private:
+		void AddPacket(
+		  size_t streamIdx,
+		  bool marker,
+		  const uint8_t* descriptor,
+		  size_t descriptorLen,
+		  size_t payloadLen);
+
+	private:
+		// Passed by argument.
+		Codec codec;
+		size_t keyFrameInterval{ 0u };
+		size_t packetsPerFrame{ 1u };
+		// Others.
+		std::vector<uint32_t> ssrcs;
+		std::vector<uint16_t> seqs;
+		std::vector<Packet> packets;
+		uint64_t frameCount{ 0u };
+		uint32_t timestamp{ 0u };
+		uint16_t pictureId{ 0u };
+		uint8_t tl0PictureIndex{ 0u };
+		bool keyFrameRequested{ false };
+	};
+} // namespace Bench
+
+#endif
@@ -0,0 +1,46 @@
+#include "Allocations.hpp"
+#include <cstdlib> // std::malloc(), std::free()
+#include <new>     // std::bad_alloc
+
+/* Static. */
+
+static bool counting{ false };
+static uint64_t count{ 0u };
+
+void* operator new(size_t size)
+{
+	if (counting)
+		++count;
+
+	void* ptr = std::malloc(size != 0u ? size : 1u);
+
+	if (!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void Bench::Allocations::StartCounting()
+{
+	counting = true;
+}
+
+void Bench::Allocations::StopCounting()
+{
+	counting = false;
+}
+
+uint64_t Bench::Allocations::GetCount()
+{
+	return count;
+}
+
+void Bench::Allocations::Reset()
+{
+	count = 0u;
+}
@@ -0,0 +1,414 @@
+#define MS_CLASS "Bench::FanoutScenario"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "FanoutScenario.hpp"
+#include "ChannelMessageHandlers.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include "Utils.hpp"
+#include "Channel/ChannelNotifier.hpp"
+#include "Channel/ChannelRequest.hpp"
+#include "PayloadChannel/PayloadChannelNotifier.hpp"
+#include "RTC/RTCP/FeedbackPs.hpp"
+#include "handles/UdpSocketHandler.hpp"
+#include <cerrno>
+#include <cstring> // std::strerror()
+#include <fcntl.h>  // fcntl()
+#include <unistd.h> // close()
+
+namespace Bench
+{
+	/* Static. */
+
+	static constexpr int SinkRecvBufferSize{ 8 * 1024 * 1024 };
+
+	/* Class methods. */
+
+	ChannelReadFreeFn FanoutScenario::OnChannelRead(
+	  uint8_t** /*message*/,
+	  uint32_t* /*messageLen*/,
+	  size_t* /*messageCtx*/,
+	  const void* /*handle*/,
+	  ChannelReadCtx /*ctx*/)
+	{
+		// Requests are not read from the Channel but directly dispatched.
+		return nullptr;
+	}
+
+	PayloadChannelReadFreeFn FanoutScenario::OnPayloadChannelRead(
+	  uint8_t** /*message*/,
+	  uint32_t* /*messageLen*/,
+	  size_t* /*messageCtx*/,
+	  uint8_t** /*payload*/,
+	  uint32_t* /*payloadLen*/,
+	  size_t* /*payloadCapacity*/,
+	  const void* /*handle*/,
+	  PayloadChannelReadCtx /*ctx*/)
+	{
+		// Notifications are not read from the PayloadChannel but directly
+		// dispatched.
+		return nullptr;
+	}
+
+	void FanoutScenario::OnChannelWrite(
+	  const uint8_t* message, uint32_t messageLen, ChannelWriteCtx ctx)
+	{
+		auto* scenario = static_cast<FanoutScenario*>(ctx);
+
+		// Just keep responses, not notifications nor logs.
+		if (messageLen == 0u || message[0] != '{')
+			return;
+
+		auto jsonMessage = json::parse(message, message + messageLen);
+
+		if (jsonMessage.contains("accepted") || jsonMessage.contains("error"))
+			scenario->lastResponse = std::move(jsonMessage);
+	}
+
+	void FanoutScenario::OnPayloadChannelWrite(
+	  const uint8_t* /*message*/,
+	  uint32_t /*messageLen*/,
+	  const uint8_t* payload,
+	  uint32_t payloadLen,
+	  ChannelWriteCtx ctx)
+	{
+		// RTP sent by DirectTransport Consumers is discarded. RTCP sent to the
+		// Producer is inspected so key frame requests are honored, as an encoder
+		// would do.
+		if (!payload || !RTC::RTCP::Packet::IsRtcp(payload, payloadLen))
+			return;
+
+		auto* scenario = static_cast<FanoutScenario*>(ctx);
+		auto* packet   = RTC::RTCP::Packet::Parse(payload, payloadLen);
+
+		while (packet)
+		{
+			if (packet->GetType() == RTC::RTCP::Type::PSFB)
+			{
+				auto* feedback = static_cast<RTC::RTCP::FeedbackPsPacket*>(packet);
+
+				if (
+				  feedback->GetMessageType() == RTC::RTCP::FeedbackPs::MessageType::PLI ||
+				  feedback->GetMessageType() == RTC::RTCP::FeedbackPs::MessageType::FIR)
+				{
+					scenario->generator.RequestKeyFrame();
+				}
+			}
+
+			auto* previousPacket = packet;
+
+			packet = packet->GetNext();
+
+			delete previousPacket;
+		}
+	}
+
+	/* Instance methods. */
+
+	FanoutScenario::FanoutScenario(const Options& options)
+	  : options(options), generator(options.codec, options.keyFrameInterval)
+	{
+		MS_TRACE();
+
+		this->channel = new Channel::ChannelSocket(
+		  &FanoutScenario::OnChannelRead, nullptr, &FanoutScenario::OnChannelWrite, this);
+
+		this->payloadChannel = new PayloadChannel::PayloadChannelSocket(
+		  &FanoutScenario::OnPayloadChannelRead,
+		  nullptr,
+		  &FanoutScenario::OnPayloadChannelWrite,
+		  this);
+
+		Channel::ChannelNotifier::ClassInit(this->channel);
+		PayloadChannel::PayloadChannelNotifier::ClassInit(this->payloadChannel);
+
+		json routerData = json::object();
+
+		routerData["sharedRtpPacketHistory"] = this->options.sharedRtpPacketHistory;
+
+		this->router = new RTC::Router("router", this, routerData);
+
+		// Producer side.
+		json transportData = json::object();
+
+		transportData["transportId"]    = "producer-transport";
+		transportData["direct"]         = true;
+		transportData["maxMessageSize"] = 262144;
+
+		Request("router.createDirectTransport", this->router->id, transportData);
+
+		json produceData = json::object();
+		json rtpParameters;
+		json rtpMapping;
+
+		this->generator.FillProducerParameters(rtpParameters, rtpMapping);
+
+		produceData["producerId"]    = "producer";
+		produceData["kind"]          = this->generator.IsVideo() ? "video" : "audio";
+		produceData["rtpParameters"] = rtpParameters;
+		produceData["rtpMapping"]    = rtpMapping;
+		produceData["paused"]        = false;
+
+		Request("transport.produce", "producer-transport", produceData);
+
+		// The Producer is fed through its PayloadChannel notification handler.
+		using EventId = PayloadChannel::PayloadChannelNotification::EventId;
+
+		this->notification.event     = "producer.send";
+		this->notification.eventId   = EventId::PRODUCER_SEND;
+		this->notification.handlerId = "producer";
+
+		if (this->options.transportType == TransportType::PLAIN)
+			CreateSink();
+	}
+
+	FanoutScenario::~FanoutScenario()
+	{
+		MS_TRACE();
+
+		delete this->router;
+
+		UdpSocketHandler::FlushSendBatch();
+
+		this->channel->Close();
+		this->payloadChannel->Close();
+
+		// Let libuv close the handles.
+		DepLibUV::RunLoop();
+
+		delete this->channel;
+		delete this->payloadChannel;
+
+		if (this->sinkFd != -1)
+			close(this->sinkFd);
+	}
+
+	size_t FanoutScenario::SendFrame()
+	{
+		MS_TRACE();
+
+		const auto& packets = this->generator.NextFrame();
+		auto* handler       = ChannelMessageHandlers::GetPayloadChannelNotificationHandler("producer");
+
+		for (const auto& packet : packets)
+		{
+			this->notification.SetPayload(packet.data, packet.len);
+
+			handler->HandleNotification(std::addressof(this->notification));
+		}
+
+		UdpSocketHandler::FlushSendBatch();
+
+		return packets.size();
+	}
+
+	void FanoutScenario::CreateConsumers()
+	{
+		MS_TRACE();
+
+		for (size_t idx{ 0u }; idx < this->options.consumers; ++idx)
+		{
+			CreateConsumer(idx);
+		}
+	}
+
+	void FanoutScenario::RunLoop()
+	{
+		MS_TRACE();
+
+		uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+	}
+
+	size_t FanoutScenario::DrainSink()
+	{
+		MS_TRACE();
+
+		if (this->sinkFd == -1)
+			return 0u;
+
+		size_t count{ 0u };
+
+		while (recv(this->sinkFd, this->sinkBuffer, sizeof(this->sinkBuffer), 0) >= 0)
+		{
+			++count;
+		}
+
+		return count;
+	}
+
+	uint64_t FanoutScenario::GetConsumersPacketCount()
+	{
+		MS_TRACE();
+
+		uint64_t packetCount{ 0u };
+		json emptyData = json::object();
+
+		for (const auto& consumerId : this->consumerIds)
+		{
+			auto stats = Request("consumer.getStats", consumerId, emptyData);
+
+			for (const auto& stat : stats)
+			{
+				if (stat.value("type", "") == "outbound-rtp")
+					packetCount += stat.value("packetCount", 0u);
+			}
+		}
+
+		return packetCount;
+	}
+
+	RTC::WebRtcServer* FanoutScenario::OnRouterNeedWebRtcServer(
+	  RTC::Router* /*router*/, std::string& /*webRtcServerId*/)
+	{
+		MS_TRACE();
+
+		return nullptr;
+	}
+
+	json FanoutScenario::Request(
+	  const std::string& method, const std::string& handlerId, const json& data)
+	{
+		MS_TRACE();
+
+		std::string message;
+
+		message.append(std::to_string(this->nextRequestId++));
+		message.append(":");
+		message.append(method);
+		message.append(":");
+		message.append(handlerId);
+		message.append(":");
+		message.append(data.dump());
+
+		Channel::ChannelRequest request(this->channel, message.c_str(), message.length());
+		auto* handler = ChannelMessageHandlers::GetChannelRequestHandler(request.handlerId);
+
+		if (!handler)
+			MS_THROW_ERROR("Channel request handler with ID %s not found", handlerId.c_str());
+
+		this->lastResponse = json::object();
+
+		try
+		{
+			handler->HandleRequest(std::addressof(request));
+		}
+		catch (const MediaSoupError& error)
+		{
+			MS_THROW_ERROR("%s [method:%s]", error.what(), method.c_str());
+		}
+
+		auto jsonErrorIt = this->lastResponse.find("error");
+
+		if (jsonErrorIt != this->lastResponse.end())
+		{
+			MS_THROW_ERROR(
+			  "%s [method:%s]", this->lastResponse.value("reason", "").c_str(), method.c_str());
+		}
+
+		auto jsonDataIt = this->lastResponse.find("data");
+
+		if (jsonDataIt == this->lastResponse.end())
+			return json::object();
+
+		return *jsonDataIt;
+	}
+
+	void FanoutScenario::CreateSink()
+	{
+		MS_TRACE();
+
+		struct sockaddr_in addr; // NOLINT(cppcoreguidelines-pro-type-member-init)
+		auto* sockaddr    = reinterpret_cast<struct sockaddr*>(std::addressof(addr));
+		socklen_t addrLen = sizeof(addr);
+
+		std::memset(std::addressof(addr), 0, sizeof(addr));
+		addr.sin_family      = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		this->sinkFd = socket(AF_INET, SOCK_DGRAM, 0);
+
+		if (this->sinkFd == -1)
+			MS_THROW_ERROR("socket() failed: %s", std::strerror(errno));
+
+		// The kernel drops what does not fit, which is fine.
+		setsockopt(
+		  this->sinkFd, SOL_SOCKET, SO_RCVBUF, &SinkRecvBufferSize, sizeof(SinkRecvBufferSize));
+
+		if (
+		  bind(this->sinkFd, sockaddr, addrLen) != 0 ||
+		  getsockname(this->sinkFd, sockaddr, &addrLen) != 0 ||
+		  fcntl(this->sinkFd, F_SETFL, fcntl(this->sinkFd, F_GETFL) | O_NONBLOCK) != 0)
+		{
+			MS_THROW_ERROR("cannot setup the sink socket: %s", std::strerror(errno));
+		}
+
+		this->sinkPort = ntohs(addr.sin_port);
+	}
+
+	void FanoutScenario::CreateConsumer(size_t idx)
+	{
+		MS_TRACE();
+
+		auto transportId   = "consumer-transport-" + std::to_string(idx);
+		json transportData = json::object();
+
+		transportData["transportId"] = transportId;
+
+		if (this->options.transportType == TransportType::PLAIN)
+		{
+			transportData["listenIp"]   = { { "ip", "127.0.0.1" } };
+			transportData["rtcpMux"]    = true;
+			transportData["comedia"]    = false;
+			transportData["enableSrtp"] = this->options.srtp;
+
+			if (this->options.srtp)
+				transportData["srtpCryptoSuite"] = "AES_CM_128_HMAC_SHA1_80";
+
+			Request("router.createPlainTransport", this->router->id, transportData);
+
+			json connectData = json::object();
+
+			connectData["ip"]   = "127.0.0.1";
+			connectData["port"] = this->sinkPort;
+
+			if (this->options.srtp)
+			{
+				uint8_t key[30];
+
+				for (auto& byte : key)
+				{
+					byte = static_cast<uint8_t>(Utils::Crypto::GetRandomUInt(0u, 255u));
+				}
+
+				auto keyBase64 = Utils::String::Base64Encode(key, sizeof(key));
+
+				connectData["srtpParameters"] = { { "cryptoSuite", "AES_CM_128_HMAC_SHA1_80" },
+					                                { "keyBase64", keyBase64 } };
+			}
+
+			Request("transport.connect", transportId, connectData);
+		}
+		else
+		{
+			transportData["direct"]         = true;
+			transportData["maxMessageSize"] = 262144;
+
+			Request("router.createDirectTransport", this->router->id, transportData);
+		}
+
+		auto consumerId  = "consumer-" + std::to_string(idx);
+		json consumeData = json::object();
+
+		consumeData["consumerId"] = consumerId;
+		consumeData["producerId"] = "producer";
+		consumeData["kind"]       = this->generator.IsVideo() ? "video" : "audio";
+		consumeData["paused"]     = false;
+
+		this->generator.FillConsumerParameters(consumeData);
+
+		Request("transport.consume", transportId, consumeData);
+
+		this->consumerIds.push_back(consumerId);
+	}
+} // namespace Bench
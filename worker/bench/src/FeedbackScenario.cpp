@@ -0,0 +1,178 @@
+#define MS_CLASS "Bench::FeedbackScenario"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "FeedbackScenario.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include <libwebrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h> // webrtc::RtpPacketSendInfo
+#include <algorithm>                                             // std::max()
+
+namespace Bench
+{
+	/* Static. */
+
+	static constexpr uint32_t Ssrc{ 1111u };
+	static constexpr uint32_t FeedbackSsrc{ 2222u };
+	static constexpr size_t PacketSize{ 1200u };
+	static constexpr uint32_t InitialAvailableBitrate{ 1000000u };
+	static constexpr size_t MaxRtcpPacketLen{ 1200u };
+	// Every packet with a transport-wide sequence number multiple of this is lost.
+	static constexpr uint16_t LossInterval{ 50u };
+	// One way delay (in ms) of the simulated network.
+	static constexpr uint64_t NetworkDelay{ 20u };
+
+	/* Instance methods. */
+
+	FeedbackScenario::FeedbackScenario(const Options& options) : options(options)
+	{
+		MS_TRACE();
+
+		if (this->options.packetsPerFeedback == 0u)
+			MS_THROW_TYPE_ERROR("packetsPerFeedback must be greater than 0");
+		else if (this->options.feedbacksPerBatch == 0u)
+			MS_THROW_TYPE_ERROR("feedbacksPerBatch must be greater than 0");
+
+		this->tccClient = new RTC::TransportCongestionControlClient(
+		  this, RTC::BweType::TRANSPORT_CC, InitialAvailableBitrate, 0u);
+
+		this->tccClient->TransportConnected();
+
+		// Parsed feedbacks point to their buffer, so each one needs its own.
+		this->buffer.resize(this->options.feedbacksPerBatch * MaxRtcpPacketLen);
+		this->feedbacks.reserve(this->options.feedbacksPerBatch);
+		this->receivedAtMs = DepLibUV::GetTimeMs() + NetworkDelay;
+	}
+
+	FeedbackScenario::~FeedbackScenario()
+	{
+		MS_TRACE();
+
+		ClearFeedbacks();
+
+		delete this->tccClient;
+	}
+
+	void FeedbackScenario::SendPackets()
+	{
+		MS_TRACE();
+
+		auto numPackets = this->options.packetsPerFeedback * this->options.feedbacksPerBatch;
+		auto nowMs      = DepLibUV::GetTimeMsInt64();
+
+		for (size_t idx{ 0u }; idx < numPackets; ++idx)
+		{
+			webrtc::RtpPacketSendInfo packetInfo;
+
+			packetInfo.ssrc                      = Ssrc;
+			packetInfo.transport_sequence_number = ++this->sentWideSeq;
+			packetInfo.has_rtp_sequence_number   = true;
+			packetInfo.rtp_sequence_number       = ++this->sentRtpSeq;
+			packetInfo.length                    = PacketSize;
+			packetInfo.pacing_info               = this->tccClient->GetPacingInfo();
+
+			this->tccClient->InsertPacket(packetInfo);
+			this->tccClient->PacketSent(packetInfo, nowMs);
+		}
+	}
+
+	void FeedbackScenario::CreateFeedbacks()
+	{
+		MS_TRACE();
+
+		ClearFeedbacks();
+
+		// Packets are received one way delay after being sent (and they are sent
+		// all at once).
+		auto receivedAtMs = std::max(this->receivedAtMs, DepLibUV::GetTimeMs() + NetworkDelay);
+
+		for (size_t idx{ 0u }; idx < this->options.feedbacksPerBatch; ++idx)
+		{
+			RTC::RTCP::FeedbackRtpTransportPacket feedback(FeedbackSsrc, Ssrc);
+
+			feedback.SetFeedbackPacketCount(this->feedbackPacketCount++);
+
+			// As TransportCongestionControlServer does, the latest received packet
+			// of the previous feedback is the base of the new one.
+			feedback.AddPacket(this->receivedWideSeq, this->receivedAtMs, MaxRtcpPacketLen);
+
+			for (size_t packetIdx{ 0u }; packetIdx < this->options.packetsPerFeedback; ++packetIdx)
+			{
+				uint16_t wideSeq = this->receivedWideSeq + 1;
+
+				if (wideSeq % LossInterval == 0u && packetIdx != this->options.packetsPerFeedback - 1)
+				{
+					// Lost. Will be reported as such by the next received packet.
+					++this->receivedWideSeq;
+
+					continue;
+				}
+
+				feedback.AddPacket(wideSeq, receivedAtMs, MaxRtcpPacketLen);
+
+				this->receivedWideSeq = wideSeq;
+				this->receivedAtMs    = receivedAtMs;
+			}
+
+			feedback.Finish();
+
+			auto* data           = this->buffer.data() + (idx * MaxRtcpPacketLen);
+			auto len             = feedback.Serialize(data);
+			auto* parsedFeedback = RTC::RTCP::FeedbackRtpTransportPacket::Parse(data, len);
+
+			if (!parsedFeedback)
+				MS_THROW_ERROR("generated feedback could not be parsed");
+
+			this->feedbacks.push_back(parsedFeedback);
+		}
+	}
+
+	size_t FeedbackScenario::ReceiveFeedbacks()
+	{
+		MS_TRACE();
+
+		this->tccClient->StartRtcpTransportFeedbackBatch();
+
+		for (auto* feedback : this->feedbacks)
+		{
+			this->tccClient->ReceiveRtcpTransportFeedback(feedback);
+		}
+
+		this->tccClient->EndRtcpTransportFeedbackBatch();
+
+		return this->feedbacks.size();
+	}
+
+	void FeedbackScenario::ClearFeedbacks()
+	{
+		MS_TRACE();
+
+		for (auto* feedback : this->feedbacks)
+		{
+			delete feedback;
+		}
+
+		this->feedbacks.clear();
+	}
+
+	void FeedbackScenario::OnTransportCongestionControlClientBitrates(
+	  RTC::TransportCongestionControlClient* /*tccClient*/,
+	  RTC::TransportCongestionControlClient::Bitrates& /*bitrates*/)
+	{
+	}
+
+	void FeedbackScenario::OnTransportCongestionControlClientSendRtpPacket(
+	  RTC::TransportCongestionControlClient* /*tccClient*/,
+	  RTC::RtpPacket* /*packet*/,
+	  const webrtc::PacedPacketInfo& /*pacingInfo*/)
+	{
+	}
+
+	void FeedbackScenario::OnTransportCongestionControlClientSendQueuedRtpPacket(
+	  RTC::TransportCongestionControlClient* /*tccClient*/,
+	  RTC::Consumer* /*consumer*/,
+	  RTC::RtpPacket* /*packet*/,
+	  bool /*retransmission*/)
+	{
+	}
+} // namespace Bench
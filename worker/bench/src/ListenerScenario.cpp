@@ -0,0 +1,323 @@
+#define MS_CLASS "Bench::ListenerScenario"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "ListenerScenario.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include "Utils.hpp"
+#include <nlohmann/json.hpp>
+#include <cstring> // std::memset(), std::memcpy()
+#include <string>
+
+using json = nlohmann::json;
+
+namespace Bench
+{
+	/* Static. */
+
+	static constexpr uint8_t PayloadType{ 100u };
+	static constexpr uint8_t RtxPayloadType{ 101u };
+	static constexpr size_t NumStreams{ 3u };
+	static constexpr uint32_t SsrcBase{ 100000000u };
+	static constexpr uint32_t MappedSsrcOffset{ 10000000u };
+	// Header extension ids of the generated packets.
+	static constexpr uint8_t MidExtensionId{ 1u };
+	static constexpr uint8_t RidExtensionId{ 2u };
+	static constexpr uint8_t RepairedRidExtensionId{ 3u };
+
+	// SSRC of the given stream (or its RTX stream) of the given Producer.
+	inline static uint32_t getSsrc(size_t producerIdx, size_t streamIdx, bool rtx)
+	{
+		return SsrcBase + static_cast<uint32_t>((producerIdx * NumStreams * 2) + (streamIdx * 2)) +
+		       (rtx ? 1u : 0u);
+	}
+
+	inline static std::string getMid(size_t producerIdx)
+	{
+		return std::to_string(producerIdx);
+	}
+
+	inline static std::string getRid(size_t streamIdx)
+	{
+		return "r" + std::to_string(streamIdx);
+	}
+
+	/* Instance methods. */
+
+	ListenerScenario::ListenerScenario(const Options& options) : options(options)
+	{
+		MS_TRACE();
+
+		if (this->options.producers == 0u)
+			MS_THROW_TYPE_ERROR("producers must be greater than 0");
+
+		this->producers.reserve(this->options.producers);
+
+		for (size_t idx{ 0u }; idx < this->options.producers; ++idx)
+		{
+			CreateProducer(idx);
+		}
+
+		auto numPackets = this->options.producers * NumStreams * 2;
+
+		// Packets are parsed in place so buffers cannot be reallocated.
+		this->buffers.resize(numPackets);
+		this->packets.reserve(numPackets);
+		this->packetProducers.reserve(numPackets);
+
+		for (size_t idx{ 0u }; idx < this->options.producers; ++idx)
+		{
+			for (size_t streamIdx{ 0u }; streamIdx < NumStreams; ++streamIdx)
+			{
+				CreatePacket(idx, streamIdx);
+			}
+		}
+	}
+
+	ListenerScenario::~ListenerScenario()
+	{
+		MS_TRACE();
+
+		for (auto* packet : this->packets)
+		{
+			RTC::RtpPacket::Deallocate(packet);
+		}
+
+		for (auto* producer : this->producers)
+		{
+			delete producer;
+		}
+	}
+
+	void ListenerScenario::AddProducers()
+	{
+		MS_TRACE();
+
+		for (auto* producer : this->producers)
+		{
+			this->listener.AddProducer(producer);
+		}
+	}
+
+	void ListenerScenario::RemoveProducers()
+	{
+		MS_TRACE();
+
+		for (auto* producer : this->producers)
+		{
+			this->listener.RemoveProducer(producer);
+		}
+	}
+
+	size_t ListenerScenario::LookupPackets()
+	{
+		MS_TRACE();
+
+		size_t resolved{ 0u };
+
+		for (size_t idx{ 0u }; idx < this->packets.size(); ++idx)
+		{
+			if (this->listener.GetProducer(this->packets[idx]) == this->packetProducers[idx])
+				++resolved;
+		}
+
+		return resolved;
+	}
+
+	void ListenerScenario::ForgetLearntSsrcs()
+	{
+		MS_TRACE();
+
+		for (size_t idx{ 1u }; idx < this->options.producers; idx += 2)
+		{
+			for (size_t streamIdx{ 0u }; streamIdx < NumStreams; ++streamIdx)
+			{
+				this->listener.ssrcTable.erase(getSsrc(idx, streamIdx, false));
+				this->listener.ssrcTable.erase(getSsrc(idx, streamIdx, true));
+			}
+		}
+	}
+
+	void ListenerScenario::CreateProducer(size_t idx)
+	{
+		MS_TRACE();
+
+		json data          = json::object();
+		json rtpParameters = json::object();
+		json rtpMapping    = json::object();
+		bool signalSsrcs   = idx % 2 == 0;
+
+		rtpParameters["mid"] = getMid(idx);
+
+		rtpParameters["codecs"] = json::array(
+		  { { { "mimeType", "video/VP8" },
+		      { "payloadType", PayloadType },
+		      { "clockRate", 90000 },
+		      { "parameters", json::object() },
+		      { "rtcpFeedback", json::array() } },
+		    { { "mimeType", "video/rtx" },
+		      { "payloadType", RtxPayloadType },
+		      { "clockRate", 90000 },
+		      { "parameters", { { "apt", PayloadType } } },
+		      { "rtcpFeedback", json::array() } } });
+
+		rtpParameters["headerExtensions"] = json::array(
+		  { { { "uri", "urn:ietf:params:rtp-hdrext:sdes:mid" }, { "id", MidExtensionId } },
+		    { { "uri", "urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id" }, { "id", RidExtensionId } },
+		    { { "uri", "urn:ietf:params:rtp-hdrext:sdes:repaired-rtp-stream-id" },
+		      { "id", RepairedRidExtensionId } } });
+
+		rtpParameters["encodings"] = json::array();
+		rtpParameters["rtcp"]      = { { "cname", "bench" }, { "reducedSize", true } };
+
+		rtpMapping["codecs"] = json::array(
+		  { { { "payloadType", PayloadType }, { "mappedPayloadType", PayloadType } },
+		    { { "payloadType", RtxPayloadType }, { "mappedPayloadType", RtxPayloadType } } });
+		rtpMapping["encodings"] = json::array();
+
+		for (size_t streamIdx{ 0u }; streamIdx < NumStreams; ++streamIdx)
+		{
+			json encoding        = json::object();
+			json encodingMapping = json::object();
+			auto mappedSsrc      = getSsrc(idx, streamIdx, false) + MappedSsrcOffset;
+
+			if (signalSsrcs)
+			{
+				encoding["ssrc"] = getSsrc(idx, streamIdx, false);
+				encoding["rtx"]  = { { "ssrc", getSsrc(idx, streamIdx, true) } };
+
+				encodingMapping["ssrc"] = getSsrc(idx, streamIdx, false);
+			}
+			else
+			{
+				encoding["rid"] = getRid(streamIdx);
+
+				encodingMapping["rid"] = getRid(streamIdx);
+			}
+
+			encodingMapping["mappedSsrc"] = mappedSsrc;
+
+			rtpParameters["encodings"].push_back(encoding);
+			rtpMapping["encodings"].push_back(encodingMapping);
+		}
+
+		data["kind"]          = "video";
+		data["rtpParameters"] = rtpParameters;
+		data["rtpMapping"]    = rtpMapping;
+		data["paused"]        = false;
+
+		this->producers.push_back(new RTC::Producer("producer-" + std::to_string(idx), this, data));
+	}
+
+	void ListenerScenario::CreatePacket(size_t producerIdx, size_t streamIdx)
+	{
+		MS_TRACE();
+
+		auto mid = getMid(producerIdx);
+		auto rid = getRid(streamIdx);
+
+		for (auto rtx : { false, true })
+		{
+			auto* data = this->buffers[this->packets.size()].data;
+			auto* ptr  = data;
+
+			std::memset(data, 0, sizeof(PacketBuffer::data));
+
+			// RTP header with the extension bit.
+			ptr[0] = 0b10010000;
+			ptr[1] = rtx ? RtxPayloadType : PayloadType;
+
+			Utils::Byte::Set4Bytes(ptr, 8, getSsrc(producerIdx, streamIdx, rtx));
+
+			ptr += 12;
+
+			// One-Byte header extension with MID and RID (or repaired RID).
+			auto* headerExtension = ptr;
+
+			ptr[0] = 0xBE;
+			ptr[1] = 0xDE;
+			ptr += 4;
+
+			ptr[0] = (MidExtensionId << 4) | static_cast<uint8_t>(mid.size() - 1);
+			std::memcpy(ptr + 1, mid.data(), mid.size());
+			ptr += 1 + mid.size();
+
+			ptr[0] = ((rtx ? RepairedRidExtensionId : RidExtensionId) << 4) |
+			         static_cast<uint8_t>(rid.size() - 1);
+			std::memcpy(ptr + 1, rid.data(), rid.size());
+			ptr += 1 + rid.size();
+
+			auto extensionLen =
+			  Utils::Byte::PadTo4Bytes(static_cast<uint16_t>(ptr - headerExtension - 4));
+
+			Utils::Byte::Set2Bytes(headerExtension, 2, static_cast<uint16_t>(extensionLen / 4));
+
+			ptr = headerExtension + 4 + extensionLen;
+
+			// Some payload.
+			ptr += 8;
+
+			auto* packet = RTC::RtpPacket::Parse(data, static_cast<size_t>(ptr - data));
+
+			if (!packet)
+				MS_THROW_ERROR("invalid generated RTP packet");
+
+			packet->SetMidExtensionId(MidExtensionId);
+			packet->SetRidExtensionId(RidExtensionId);
+			packet->SetRepairedRidExtensionId(RepairedRidExtensionId);
+
+			this->packets.push_back(packet);
+			this->packetProducers.push_back(this->producers[producerIdx]);
+		}
+	}
+
+	inline void ListenerScenario::OnProducerReceiveData(RTC::Producer* /*producer*/, size_t /*len*/)
+	{
+	}
+
+	inline void ListenerScenario::OnProducerReceiveRtpPacket(
+	  RTC::Producer* /*producer*/, RTC::RtpPacket* /*packet*/)
+	{
+	}
+
+	inline void ListenerScenario::OnProducerPaused(RTC::Producer* /*producer*/)
+	{
+	}
+
+	inline void ListenerScenario::OnProducerResumed(RTC::Producer* /*producer*/)
+	{
+	}
+
+	inline void ListenerScenario::OnProducerNewRtpStream(
+	  RTC::Producer* /*producer*/, RTC::RtpStream* /*rtpStream*/, uint32_t /*mappedSsrc*/)
+	{
+	}
+
+	inline void ListenerScenario::OnProducerRtpStreamScore(
+	  RTC::Producer* /*producer*/,
+	  RTC::RtpStream* /*rtpStream*/,
+	  uint8_t /*score*/,
+	  uint8_t /*previousScore*/)
+	{
+	}
+
+	inline void ListenerScenario::OnProducerRtcpSenderReport(
+	  RTC::Producer* /*producer*/, RTC::RtpStream* /*rtpStream*/, bool /*first*/)
+	{
+	}
+
+	inline void ListenerScenario::OnProducerRtpPacketReceived(
+	  RTC::Producer* /*producer*/, RTC::RtpPacket* /*packet*/)
+	{
+	}
+
+	inline void ListenerScenario::OnProducerSendRtcpPacket(
+	  RTC::Producer* /*producer*/, RTC::RTCP::Packet* /*packet*/)
+	{
+	}
+
+	inline void ListenerScenario::OnProducerNeedWorstRemoteFractionLost(
+	  RTC::Producer* /*producer*/, uint32_t /*mappedSsrc*/, uint8_t& /*worstRemoteFractionLost*/)
+	{
+	}
+} // namespace Bench
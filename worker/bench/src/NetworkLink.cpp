@@ -0,0 +1,141 @@
+#define MS_CLASS "Bench::NetworkLink"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "NetworkLink.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include <algorithm> // std::max()
+#include <cstring>   // std::memcpy()
+
+namespace Bench
+{
+	/* Instance methods. */
+
+	NetworkLink::NetworkLink(const Options& options)
+	  : options(options), capacity(options.capacity), random(options.seed)
+	{
+		MS_TRACE();
+	}
+
+	bool NetworkLink::Send(const uint8_t* data, size_t len, uint64_t nowUs)
+	{
+		MS_TRACE();
+
+		if (len > sizeof(Packet::data))
+			MS_THROW_ERROR("packet too big [len:%zu]", len);
+
+		this->stats.sentPackets++;
+
+		Packet packet;
+
+		std::memcpy(packet.data, data, len);
+		packet.len = len;
+
+		return Enqueue(packet, nowUs);
+	}
+
+	void NetworkLink::SendCrossTraffic(size_t len, uint64_t nowUs)
+	{
+		MS_TRACE();
+
+		Packet packet;
+
+		packet.len            = len;
+		packet.isCrossTraffic = true;
+
+		Enqueue(packet, nowUs);
+	}
+
+	void NetworkLink::Process(uint64_t nowUs)
+	{
+		MS_TRACE();
+
+		auto elapsedUs = this->lastProcessedAtUs != 0u ? nowUs - this->lastProcessedAtUs : 0u;
+
+		this->lastProcessedAtUs = nowUs;
+
+		// An idle link can not save capacity for later.
+		if (this->queue.empty())
+		{
+			this->credit = 0u;
+
+			return;
+		}
+
+		this->credit += static_cast<uint64_t>(this->capacity) * elapsedUs / 1000000u;
+
+		while (!this->queue.empty())
+		{
+			auto& packet = this->queue.front();
+			auto bits    = static_cast<uint64_t>(packet.len) * 8u;
+
+			if (this->credit < bits)
+				break;
+
+			this->credit -= bits;
+			this->queueBytes -= packet.len;
+
+			if (packet.isCrossTraffic)
+			{
+				this->stats.crossTrafficBytes += packet.len;
+			}
+			else
+			{
+				this->queueDelays.Record((nowUs - packet.sentAtUs) * 1000u);
+
+				if (this->uniform(this->random) < this->options.lossRatio)
+				{
+					this->stats.lostPackets++;
+				}
+				else
+				{
+					uint64_t arrivalAtUs = nowUs + (this->options.delayMs * 1000u);
+
+					if (this->options.jitterMs != 0u)
+					{
+						arrivalAtUs += static_cast<uint64_t>(
+						  this->uniform(this->random) * this->options.jitterMs * 1000u);
+					}
+
+					arrivalAtUs = std::max(arrivalAtUs, this->lastArrivalAtUs);
+
+					// A reordered packet doesn't hold back the following ones.
+					if (this->uniform(this->random) < this->options.reorderRatio)
+						arrivalAtUs += this->options.reorderDelayMs * 1000u;
+					else
+						this->lastArrivalAtUs = arrivalAtUs;
+
+					this->inFlight.emplace(arrivalAtUs, packet);
+				}
+			}
+
+			this->queue.pop_front();
+		}
+
+		if (this->queue.empty())
+			this->credit = 0u;
+	}
+
+	bool NetworkLink::Enqueue(Packet& packet, uint64_t nowUs)
+	{
+		MS_TRACE();
+
+		auto maxQueueBytes = static_cast<uint64_t>(this->capacity) * this->options.queueMs / 8000u;
+
+		// A packet is always accepted by an empty queue.
+		if (!this->queue.empty() && this->queueBytes + packet.len > maxQueueBytes)
+		{
+			if (!packet.isCrossTraffic)
+				this->stats.queueDroppedPackets++;
+
+			return false;
+		}
+
+		packet.sentAtUs = nowUs;
+
+		this->queue.push_back(packet);
+		this->queueBytes += packet.len;
+
+		return true;
+	}
+} // namespace Bench
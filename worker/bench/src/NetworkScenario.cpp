@@ -0,0 +1,823 @@
+#define MS_CLASS "Bench::NetworkScenario"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "NetworkScenario.hpp"
+#include "ChannelMessageHandlers.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include "Channel/ChannelNotifier.hpp"
+#include "Channel/ChannelRequest.hpp"
+#include "PayloadChannel/PayloadChannelNotifier.hpp"
+#include "Utils.hpp"
+#include "RTC/RTCP/FeedbackPs.hpp"
+#include "RTC/RTCP/SenderReport.hpp"
+#include "handles/TimerWheel.hpp"
+#include <algorithm> // std::max()
+#include <cmath>     // std::abs()
+#include <fstream>
+#include <sstream>
+
+#ifndef MS_VIRTUAL_CLOCK
+#error "NetworkScenario requires MS_VIRTUAL_CLOCK"
+#endif
+
+namespace Bench
+{
+	/* Static. */
+
+	// clang-format off
+	static const std::vector<std::string> ProfileNames =
+	{
+		"step-down", "cross-traffic", "lte"
+	};
+	static const std::vector<std::string> FeedbackNames =
+	{
+		"transport-cc", "remb", "rr"
+	};
+	// Synthetic capacity (kbps) every 500 ms, shaped after LTE drive tests:
+	// fast fluctuations, a handover outage and cell edge periods.
+	static const std::vector<uint32_t> LteTraceKbps =
+	{
+		2200, 2400, 2100, 2600, 2900, 2700, 2300, 2500, 2800, 3100,
+		3300, 3000, 2600, 2200, 1900, 1700, 1500, 1600, 1400, 1200,
+		 900,  600,  300,  200,  400,  800, 1300, 1800, 2300, 2700,
+		3000, 3200, 3500, 3400, 3100, 2800, 2500, 2600, 2400, 2100,
+		1800, 1600, 1300, 1100,  900,  800,  700,  900, 1000, 1200,
+		1500, 1700, 2000, 2300, 2200, 1900, 1700, 1900, 2200, 2500,
+		2800, 3000, 2900, 2600, 2400, 2100, 1800, 1500, 1300, 1500,
+		1800, 2100, 2400, 2600, 2800, 2700, 2500, 2300, 2200, 2400
+	};
+	// clang-format on
+	static constexpr uint64_t LteTraceIntervalMs{ 500u };
+	// Time the Producer streams are active before consuming them.
+	static constexpr uint64_t WarmupMs{ 1000u };
+	// Interval of the available outgoing bitrate samples.
+	static constexpr uint64_t SampleIntervalMs{ 100u };
+	static constexpr size_t CrossTrafficPacketLen{ 1200u };
+	static constexpr uint32_t ReverseLinkCapacity{ 10000000u };
+	static constexpr uint8_t TransportWideCc01ExtensionId{ 5u };
+	static constexpr uint32_t ReceiverMappedSsrc{ 22222222u };
+	static constexpr uint8_t ReceiverMappedPayloadType{ 102u };
+
+	// The reverse link just carries RTCP, without losses nor reordering.
+	static NetworkLink::Options getReverseLinkOptions(const NetworkLink::Options& options)
+	{
+		NetworkLink::Options reverseLinkOptions = options;
+
+		reverseLinkOptions.capacity     = ReverseLinkCapacity;
+		reverseLinkOptions.lossRatio    = 0;
+		reverseLinkOptions.reorderRatio = 0;
+		reverseLinkOptions.seed         = options.seed + 1u;
+
+		return reverseLinkOptions;
+	}
+
+	/* Class methods. */
+
+	NetworkScenario::Profile NetworkScenario::GetProfile(const std::string& name)
+	{
+		MS_TRACE();
+
+		for (size_t idx{ 0u }; idx < ProfileNames.size(); ++idx)
+		{
+			if (ProfileNames[idx] == name)
+				return static_cast<Profile>(idx);
+		}
+
+		MS_THROW_TYPE_ERROR("unknown profile '%s'", name.c_str());
+	}
+
+	const std::string& NetworkScenario::GetProfileName(Profile profile)
+	{
+		MS_TRACE();
+
+		return ProfileNames[static_cast<size_t>(profile)];
+	}
+
+	NetworkScenario::Feedback NetworkScenario::GetFeedback(const std::string& name)
+	{
+		MS_TRACE();
+
+		for (size_t idx{ 0u }; idx < FeedbackNames.size(); ++idx)
+		{
+			if (FeedbackNames[idx] == name)
+				return static_cast<Feedback>(idx);
+		}
+
+		MS_THROW_TYPE_ERROR("unknown feedback '%s'", name.c_str());
+	}
+
+	const std::string& NetworkScenario::GetFeedbackName(Feedback feedback)
+	{
+		MS_TRACE();
+
+		return FeedbackNames[static_cast<size_t>(feedback)];
+	}
+
+	ChannelReadFreeFn NetworkScenario::OnChannelRead(
+	  uint8_t** /*message*/,
+	  uint32_t* /*messageLen*/,
+	  size_t* /*messageCtx*/,
+	  const void* /*handle*/,
+	  ChannelReadCtx /*ctx*/)
+	{
+		// Requests are not read from the Channel but directly dispatched.
+		return nullptr;
+	}
+
+	PayloadChannelReadFreeFn NetworkScenario::OnPayloadChannelRead(
+	  uint8_t** /*message*/,
+	  uint32_t* /*messageLen*/,
+	  size_t* /*messageCtx*/,
+	  uint8_t** /*payload*/,
+	  uint32_t* /*payloadLen*/,
+	  size_t* /*payloadCapacity*/,
+	  const void* /*handle*/,
+	  PayloadChannelReadCtx /*ctx*/)
+	{
+		// Notifications are not read from the PayloadChannel but directly
+		// dispatched.
+		return nullptr;
+	}
+
+	void NetworkScenario::OnChannelWrite(
+	  const uint8_t* message, uint32_t messageLen, ChannelWriteCtx ctx)
+	{
+		auto* scenario = static_cast<NetworkScenario*>(ctx);
+
+		// Just keep responses, not notifications nor logs.
+		if (messageLen == 0u || message[0] != '{')
+			return;
+
+		auto jsonMessage = json::parse(message, message + messageLen);
+
+		if (jsonMessage.contains("accepted") || jsonMessage.contains("error"))
+			scenario->lastResponse = std::move(jsonMessage);
+	}
+
+	void NetworkScenario::OnPayloadChannelWrite(
+	  const uint8_t* message,
+	  uint32_t messageLen,
+	  const uint8_t* payload,
+	  uint32_t payloadLen,
+	  ChannelWriteCtx ctx)
+	{
+		auto* scenario = static_cast<NetworkScenario*>(ctx);
+
+		scenario->OnPayloadChannelMessage(message, messageLen, payload, payloadLen);
+	}
+
+	/* Instance methods. */
+
+	NetworkScenario::NetworkScenario(const Options& options)
+	  : options(options), generator(options.codec, 100u, options.packetsPerFrame),
+	    forwardLink(options.link), reverseLink(getReverseLinkOptions(options.link))
+	{
+		MS_TRACE();
+
+		LoadProfile();
+
+		// Timers created from now on run in virtual time and, with the random
+		// numbers of the worker (SSRCs, sequence numbers...) seeded too, runs
+		// can be replayed exactly.
+		DepLibUV::EnableVirtualClock();
+		Utils::Crypto::SetSeed(options.link.seed);
+
+		this->channel = new Channel::ChannelSocket(
+		  &NetworkScenario::OnChannelRead, nullptr, &NetworkScenario::OnChannelWrite, this);
+
+		this->payloadChannel = new PayloadChannel::PayloadChannelSocket(
+		  &NetworkScenario::OnPayloadChannelRead,
+		  nullptr,
+		  &NetworkScenario::OnPayloadChannelWrite,
+		  this);
+
+		Channel::ChannelNotifier::ClassInit(this->channel);
+		PayloadChannel::PayloadChannelNotifier::ClassInit(this->payloadChannel);
+
+		json routerData = json::object();
+
+		this->router = new RTC::Router("router", this, routerData);
+
+		CreateProducer();
+	}
+
+	NetworkScenario::~NetworkScenario()
+	{
+		MS_TRACE();
+
+		delete this->router;
+
+		this->channel->Close();
+		this->payloadChannel->Close();
+
+		DepLibUV::DisableVirtualClock();
+
+		// Let libuv close the handles.
+		DepLibUV::RunLoop();
+
+		delete this->channel;
+		delete this->payloadChannel;
+	}
+
+	NetworkScenario::Result NetworkScenario::Run()
+	{
+		MS_TRACE();
+
+		// Let the Producer streams and their layers be active before consuming
+		// them, as with a real source.
+		while (this->nowMs < WarmupMs)
+		{
+			SendFrame();
+			Step();
+		}
+
+		CreateSenderAndReceiver();
+
+		Result result;
+		PhaseResult* phase{ nullptr };
+		size_t segmentIdx{ 0u };
+		uint32_t availableCapacity{ 0u };
+		// Sum of the available capacity of every millisecond of the phase.
+		uint64_t phaseCapacity{ 0u };
+		uint64_t totalCapacity{ 0u };
+		uint64_t phaseDeliveredBytes{ 0u };
+		uint64_t totalDeliveredBytes{ 0u };
+		uint64_t phaseQueueDroppedPackets{ 0u };
+		uint64_t phaseLostPackets{ 0u };
+		uint64_t sumSampledBitrate{ 0u };
+		uint64_t numSamples{ 0u };
+		int64_t lastOutOfBandMs{ -1 };
+		bool inBand{ false };
+
+		auto closePhase = [&](uint64_t endMs)
+		{
+			const auto& linkStats = this->forwardLink.GetStats();
+			auto& queueDelays     = this->forwardLink.GetQueueDelays();
+			auto deliveredBytes   = linkStats.deliveredBytes - phaseDeliveredBytes;
+			auto durationMs       = std::max<uint64_t>(endMs - phase->startMs, 1u);
+
+			phase->endMs = endMs;
+
+			if (inBand)
+			{
+				phase->convergenceMs =
+				  lastOutOfBandMs == -1 ? 0 : lastOutOfBandMs + static_cast<int64_t>(SampleIntervalMs);
+			}
+
+			phase->utilization =
+			  phaseCapacity != 0u ? static_cast<double>(deliveredBytes * 8u * 1000u) / phaseCapacity : 0;
+			phase->deliveredBitrate = static_cast<uint32_t>(deliveredBytes * 8u * 1000u / durationMs);
+			phase->availableOutgoingBitrate =
+			  numSamples != 0u ? static_cast<uint32_t>(sumSampledBitrate / numSamples) : 0u;
+			phase->queueDelayMeanMs    = static_cast<double>(queueDelays.GetMean()) / 1e6;
+			phase->queueDelayP95Ms     = static_cast<double>(queueDelays.GetValueAtPercentile(95)) / 1e6;
+			phase->queueDroppedPackets = linkStats.queueDroppedPackets - phaseQueueDroppedPackets;
+			phase->lostPackets         = linkStats.lostPackets - phaseLostPackets;
+
+			totalCapacity += phaseCapacity;
+			totalDeliveredBytes += deliveredBytes;
+
+			queueDelays.Reset();
+		};
+
+		for (uint64_t elapsedMs{ 0u }; elapsedMs < this->durationMs; ++elapsedMs)
+		{
+			// Apply the profile.
+			while (segmentIdx < this->segments.size() &&
+			       this->segments[segmentIdx].startMs <= elapsedMs)
+			{
+				const auto& segment = this->segments[segmentIdx++];
+
+				this->forwardLink.SetCapacity(segment.capacity);
+				this->crossTraffic = segment.crossTraffic;
+				availableCapacity =
+				  segment.capacity > segment.crossTraffic ? segment.capacity - segment.crossTraffic : 0u;
+
+				if (!segment.newPhase)
+					continue;
+
+				if (phase)
+					closePhase(elapsedMs);
+
+				const auto& linkStats = this->forwardLink.GetStats();
+
+				result.phases.emplace_back();
+
+				phase                    = std::addressof(result.phases.back());
+				phase->startMs           = elapsedMs;
+				phase->availableCapacity = availableCapacity;
+				phaseCapacity            = 0u;
+				phaseDeliveredBytes      = linkStats.deliveredBytes;
+				phaseQueueDroppedPackets = linkStats.queueDroppedPackets;
+				phaseLostPackets         = linkStats.lostPackets;
+				sumSampledBitrate        = 0u;
+				numSamples               = 0u;
+				lastOutOfBandMs          = -1;
+				inBand                   = false;
+			}
+
+			if (elapsedMs % SampleIntervalMs == 0u)
+			{
+				auto bitrate = GetAvailableOutgoingBitrate();
+				auto error   = std::abs(static_cast<double>(bitrate) - availableCapacity);
+
+				inBand = error <= this->options.convergenceTolerance * availableCapacity;
+
+				if (!inBand)
+					lastOutOfBandMs = static_cast<int64_t>(elapsedMs - phase->startMs);
+
+				sumSampledBitrate += bitrate;
+				numSamples++;
+			}
+
+			phaseCapacity += availableCapacity;
+
+			SendFrame();
+			SendCrossTraffic();
+			Step();
+		}
+
+		closePhase(this->durationMs);
+
+		const auto& linkStats = this->forwardLink.GetStats();
+
+		result.utilization =
+		  totalCapacity != 0u ? static_cast<double>(totalDeliveredBytes * 8u * 1000u) / totalCapacity
+		                      : 0;
+		result.sentPackets         = linkStats.sentPackets;
+		result.queueDroppedPackets = linkStats.queueDroppedPackets;
+		result.lostPackets         = linkStats.lostPackets;
+
+		return result;
+	}
+
+	RTC::WebRtcServer* NetworkScenario::OnRouterNeedWebRtcServer(
+	  RTC::Router* /*router*/, std::string& /*webRtcServerId*/)
+	{
+		MS_TRACE();
+
+		return nullptr;
+	}
+
+	json NetworkScenario::Request(
+	  const std::string& method, const std::string& handlerId, const json& data)
+	{
+		MS_TRACE();
+
+		std::string message;
+
+		message.append(std::to_string(this->nextRequestId++));
+		message.append(":");
+		message.append(method);
+		message.append(":");
+		message.append(handlerId);
+		message.append(":");
+		message.append(data.dump());
+
+		Channel::ChannelRequest request(this->channel, message.c_str(), message.length());
+		auto* handler = ChannelMessageHandlers::GetChannelRequestHandler(request.handlerId);
+
+		if (!handler)
+			MS_THROW_ERROR("Channel request handler with ID %s not found", handlerId.c_str());
+
+		this->lastResponse = json::object();
+
+		try
+		{
+			handler->HandleRequest(std::addressof(request));
+		}
+		catch (const MediaSoupError& error)
+		{
+			MS_THROW_ERROR("%s [method:%s]", error.what(), method.c_str());
+		}
+
+		auto jsonErrorIt = this->lastResponse.find("error");
+
+		if (jsonErrorIt != this->lastResponse.end())
+		{
+			MS_THROW_ERROR(
+			  "%s [method:%s]", this->lastResponse.value("reason", "").c_str(), method.c_str());
+		}
+
+		auto jsonDataIt = this->lastResponse.find("data");
+
+		if (jsonDataIt == this->lastResponse.end())
+			return json::object();
+
+		return *jsonDataIt;
+	}
+
+	void NetworkScenario::LoadProfile()
+	{
+		MS_TRACE();
+
+		if (!this->options.traceFile.empty())
+		{
+			LoadTraceFile();
+
+			return;
+		}
+
+		switch (this->options.profile)
+		{
+			case Profile::STEP_DOWN:
+			{
+				this->segments.push_back({ 0u, 2500000u, 0u, true });
+				this->segments.push_back({ 20000u, 1000000u, 0u, true });
+				this->segments.push_back({ 40000u, 2500000u, 0u, true });
+				this->durationMs = 60000u;
+
+				break;
+			}
+
+			case Profile::CROSS_TRAFFIC:
+			{
+				this->segments.push_back({ 0u, 2500000u, 0u, true });
+				this->segments.push_back({ 15000u, 2500000u, 1250000u, true });
+				this->segments.push_back({ 35000u, 2500000u, 0u, true });
+				this->durationMs = 50000u;
+
+				break;
+			}
+
+			case Profile::LTE:
+			{
+				for (size_t idx{ 0u }; idx < LteTraceKbps.size(); ++idx)
+				{
+					this->segments.push_back(
+					  { idx * LteTraceIntervalMs, LteTraceKbps[idx] * 1000u, 0u, idx == 0u });
+				}
+
+				this->durationMs = LteTraceKbps.size() * LteTraceIntervalMs;
+
+				break;
+			}
+		}
+	}
+
+	void NetworkScenario::LoadTraceFile()
+	{
+		MS_TRACE();
+
+		std::ifstream file(this->options.traceFile);
+
+		if (!file)
+			MS_THROW_TYPE_ERROR("cannot open trace file '%s'", this->options.traceFile.c_str());
+
+		std::string line;
+
+		while (std::getline(file, line))
+		{
+			if (line.empty() || line[0] == '#')
+				continue;
+
+			std::istringstream stream(line);
+			uint64_t startMs;
+			uint32_t capacity;
+
+			if (!(stream >> startMs >> capacity))
+				MS_THROW_TYPE_ERROR("invalid trace line '%s'", line.c_str());
+
+			if (!this->segments.empty() && startMs <= this->segments.back().startMs)
+				MS_THROW_TYPE_ERROR("trace times must be increasing");
+
+			this->segments.push_back({ startMs, capacity, 0u, this->segments.empty() });
+		}
+
+		if (this->segments.empty())
+			MS_THROW_TYPE_ERROR("empty trace file");
+
+		if (this->segments[0].startMs != 0u)
+			MS_THROW_TYPE_ERROR("trace must start at 0 ms");
+
+		// The last capacity lasts as long as the previous one.
+		auto lastIntervalMs = this->segments.size() > 1u
+		                        ? this->segments.back().startMs -
+		                            this->segments[this->segments.size() - 2u].startMs
+		                        : 1000u;
+
+		this->durationMs = this->segments.back().startMs + lastIntervalMs;
+	}
+
+	void NetworkScenario::CreateProducer()
+	{
+		MS_TRACE();
+
+		json transportData = json::object();
+
+		transportData["transportId"]    = "producer-transport";
+		transportData["direct"]         = true;
+		transportData["maxMessageSize"] = 262144;
+
+		Request("router.createDirectTransport", this->router->id, transportData);
+
+		json produceData = json::object();
+		json rtpParameters;
+		json rtpMapping;
+
+		this->generator.FillProducerParameters(rtpParameters, rtpMapping);
+
+		produceData["producerId"]    = "producer";
+		produceData["kind"]          = this->generator.IsVideo() ? "video" : "audio";
+		produceData["rtpParameters"] = rtpParameters;
+		produceData["rtpMapping"]    = rtpMapping;
+		produceData["paused"]        = false;
+
+		Request("transport.produce", "producer-transport", produceData);
+	}
+
+	void NetworkScenario::CreateSenderAndReceiver()
+	{
+		MS_TRACE();
+
+		const auto* kind = this->generator.IsVideo() ? "video" : "audio";
+
+		// Sender.
+		json transportData = json::object();
+
+		transportData["transportId"]       = "sender-transport";
+		transportData["direct"]            = true;
+		transportData["maxMessageSize"]    = 262144;
+		transportData["enableRtcpReports"] = true;
+		transportData["enablePacing"]      = this->options.pacing;
+		transportData["enableSenderBwe"]   = this->options.senderBwe;
+
+		Request("router.createDirectTransport", this->router->id, transportData);
+
+		json consumeData = json::object();
+
+		consumeData["consumerId"] = "consumer";
+		consumeData["producerId"] = "producer";
+		consumeData["kind"]       = kind;
+		consumeData["paused"]     = false;
+
+		this->generator.FillConsumerParameters(consumeData);
+
+		auto& rtpParameters = consumeData["rtpParameters"];
+		auto& rtcpFeedback  = rtpParameters["codecs"][0]["rtcpFeedback"];
+
+		switch (this->options.feedback)
+		{
+			case Feedback::TRANSPORT_CC:
+			{
+				rtpParameters["headerExtensions"].push_back(
+				  { { "uri", "http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01" },
+				    { "id", TransportWideCc01ExtensionId } });
+				rtcpFeedback.push_back({ { "type", "transport-cc" } });
+
+				break;
+			}
+
+			case Feedback::REMB:
+			{
+				rtcpFeedback.push_back({ { "type", "goog-remb" } });
+
+				break;
+			}
+
+			case Feedback::RR:
+			{
+				break;
+			}
+		}
+
+		Request("transport.consume", "sender-transport", consumeData);
+
+		// Receiver, with a Producer mirroring the Consumer RTP parameters.
+		transportData = json::object();
+
+		transportData["transportId"]       = "receiver-transport";
+		transportData["direct"]            = true;
+		transportData["maxMessageSize"]    = 262144;
+		transportData["enableRtcpReports"] = true;
+
+		Request("router.createDirectTransport", this->router->id, transportData);
+
+		auto ssrc           = rtpParameters["encodings"][0]["ssrc"].get<uint32_t>();
+		auto payloadType    = rtpParameters["codecs"][0]["payloadType"].get<uint8_t>();
+		json produceData    = json::object();
+		json receiverParams = rtpParameters;
+
+		receiverParams["encodings"] = json::array({ { { "ssrc", ssrc } } });
+		receiverParams["rtcp"] = { { "cname", "bench-receiver" }, { "reducedSize", true } };
+
+		produceData["producerId"]    = "receiver-producer";
+		produceData["kind"]          = kind;
+		produceData["rtpParameters"] = receiverParams;
+		produceData["rtpMapping"]    = json::object();
+		produceData["paused"]        = false;
+
+		auto& rtpMapping = produceData["rtpMapping"];
+
+		rtpMapping["codecs"] = json::array(
+		  { { { "payloadType", payloadType }, { "mappedPayloadType", ReceiverMappedPayloadType } } });
+		rtpMapping["encodings"] =
+		  json::array({ { { "ssrc", ssrc }, { "mappedSsrc", ReceiverMappedSsrc } } });
+
+		Request("transport.produce", "receiver-transport", produceData);
+	}
+
+	void NetworkScenario::Step()
+	{
+		MS_TRACE();
+
+		DepLibUV::AdvanceVirtualClock(1000000u);
+
+		this->nowMs++;
+
+		auto nowUs = DepLibUV::GetTimeUs();
+
+		this->forwardLink.Process(nowUs);
+		this->reverseLink.Process(nowUs);
+
+		using EventId = PayloadChannel::PayloadChannelNotification::EventId;
+
+		this->forwardLink.Receive(
+		  nowUs,
+		  [this](const uint8_t* data, size_t len)
+		  {
+			  if (RTC::RTCP::Packet::IsRtcp(data, len))
+				  SendNotification(EventId::TRANSPORT_SEND_RTCP, "receiver-transport", data, len);
+			  else
+				  SendNotification(EventId::PRODUCER_SEND, "receiver-producer", data, len);
+		  });
+
+		this->reverseLink.Receive(
+		  nowUs,
+		  [this](const uint8_t* data, size_t len)
+		  {
+			  SendNotification(EventId::TRANSPORT_SEND_RTCP, "sender-transport", data, len);
+		  });
+
+		// As the uv_timer_t of the TimerWheel would do.
+		TimerWheel::OnUvTimer();
+	}
+
+	void NetworkScenario::SendFrame()
+	{
+		MS_TRACE();
+
+		// Frames are due every 1000 / frame rate ms since the start.
+		if (this->sentFrames * 1000u / this->generator.GetFrameRate() > this->nowMs)
+			return;
+
+		// Once per second, so the Consumer can switch between simulcast streams.
+		if (this->sentFrames % this->generator.GetFrameRate() == 0u)
+			SendSenderReports();
+
+		const auto& packets = this->generator.NextFrame();
+
+		for (const auto& packet : packets)
+		{
+			SendNotification(
+			  PayloadChannel::PayloadChannelNotification::EventId::PRODUCER_SEND,
+			  "producer",
+			  packet.data,
+			  packet.len);
+		}
+
+		this->sentFrames++;
+	}
+
+	void NetworkScenario::SendSenderReports()
+	{
+		MS_TRACE();
+
+		// The next frame is captured now.
+		auto ntp = Utils::Time::TimeMs2Ntp(DepLibUV::GetTimeMs());
+		uint8_t buffer[RTC::RTCP::Packet::CommonHeaderSize + RTC::RTCP::SenderReport::HeaderSize];
+
+		for (auto ssrc : this->generator.GetSsrcs())
+		{
+			RTC::RTCP::SenderReportPacket packet;
+			auto* report = new RTC::RTCP::SenderReport();
+
+			report->SetSsrc(ssrc);
+			report->SetNtpSec(ntp.seconds);
+			report->SetNtpFrac(ntp.fractions);
+			report->SetRtpTs(this->generator.GetTimestamp());
+			packet.AddReport(report);
+
+			auto len = packet.Serialize(buffer);
+
+			SendNotification(
+			  PayloadChannel::PayloadChannelNotification::EventId::TRANSPORT_SEND_RTCP,
+			  "producer-transport",
+			  buffer,
+			  len);
+		}
+	}
+
+	void NetworkScenario::SendCrossTraffic()
+	{
+		MS_TRACE();
+
+		this->crossTrafficCredit += this->crossTraffic / 1000u;
+
+		while (this->crossTrafficCredit >= CrossTrafficPacketLen * 8u)
+		{
+			this->forwardLink.SendCrossTraffic(CrossTrafficPacketLen, DepLibUV::GetTimeUs());
+			this->crossTrafficCredit -= CrossTrafficPacketLen * 8u;
+		}
+	}
+
+	void NetworkScenario::SendNotification(
+	  PayloadChannel::PayloadChannelNotification::EventId eventId,
+	  const std::string& handlerId,
+	  const uint8_t* data,
+	  size_t len)
+	{
+		MS_TRACE();
+
+		auto* handler = ChannelMessageHandlers::GetPayloadChannelNotificationHandler(handlerId);
+
+		if (!handler)
+			MS_THROW_ERROR("PayloadChannel notification handler with ID %s not found", handlerId.c_str());
+
+		this->notification.event =
+		  eventId == PayloadChannel::PayloadChannelNotification::EventId::PRODUCER_SEND
+		    ? "producer.send"
+		    : "transport.sendRtcp";
+		this->notification.eventId   = eventId;
+		this->notification.handlerId = handlerId;
+		this->notification.SetPayload(data, len);
+
+		handler->HandleNotification(std::addressof(this->notification));
+	}
+
+	uint32_t NetworkScenario::GetAvailableOutgoingBitrate()
+	{
+		MS_TRACE();
+
+		auto stats = Request("transport.getStats", "sender-transport", json::object());
+
+		for (const auto& stat : stats)
+		{
+			return stat.value("availableOutgoingBitrate", 0u);
+		}
+
+		return 0u;
+	}
+
+	void NetworkScenario::HandleRtcpToProducer(const uint8_t* data, size_t len)
+	{
+		MS_TRACE();
+
+		// Key frame requests are honored, as an encoder would do.
+		auto* packet = RTC::RTCP::Packet::Parse(data, len);
+
+		while (packet)
+		{
+			if (packet->GetType() == RTC::RTCP::Type::PSFB)
+			{
+				auto* feedback = static_cast<RTC::RTCP::FeedbackPsPacket*>(packet);
+
+				if (
+				  feedback->GetMessageType() == RTC::RTCP::FeedbackPs::MessageType::PLI ||
+				  feedback->GetMessageType() == RTC::RTCP::FeedbackPs::MessageType::FIR)
+				{
+					this->generator.RequestKeyFrame();
+				}
+			}
+
+			auto* previousPacket = packet;
+
+			packet = packet->GetNext();
+
+			delete previousPacket;
+		}
+	}
+
+	void NetworkScenario::OnPayloadChannelMessage(
+	  const uint8_t* message, uint32_t messageLen, const uint8_t* payload, uint32_t payloadLen)
+	{
+		MS_TRACE();
+
+		if (!payload || payloadLen == 0u)
+			return;
+
+		// The notification starts with the target id, which tells who sends the
+		// payload.
+		static const std::string TargetIdPrefix{ "{\"targetId\":\"" };
+
+		std::string targetId(reinterpret_cast<const char*>(message), messageLen);
+
+		if (targetId.compare(0u, TargetIdPrefix.size(), TargetIdPrefix) != 0)
+			return;
+
+		targetId.erase(0u, TargetIdPrefix.size());
+		targetId.erase(std::min(targetId.find('"'), targetId.size()));
+
+		auto nowUs = DepLibUV::GetTimeUs();
+
+		// RTP of the Consumer and RTCP of its transport.
+		if (targetId == "consumer" || targetId == "sender-transport")
+			this->forwardLink.Send(payload, payloadLen, nowUs);
+		else if (targetId == "receiver-transport")
+			this->reverseLink.Send(payload, payloadLen, nowUs);
+		else if (targetId == "producer-transport")
+			HandleRtcpToProducer(payload, payloadLen);
+	}
+} // namespace Bench
@@ -0,0 +1,422 @@
+#define MS_CLASS "Bench::RtpGenerator"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "RtpGenerator.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include "Utils.hpp"
+#include <cstring> // std::memset(), std::memcpy()
+
+namespace Bench
+{
+	/* Static. */
+
+	// clang-format off
+	static const std::vector<std::string> CodecNames =
+	{
+		"vp8", "vp9", "h264", "opus"
+	};
+	// clang-format on
+	static constexpr uint8_t PayloadType{ 100u };
+	static constexpr uint8_t MappedPayloadType{ 101u };
+	static constexpr uint32_t MappedSsrcOffset{ 10000000u };
+	// Header extension ids of the generated packets.
+	static constexpr uint8_t AbsSendTimeExtensionId{ 3u };
+	static constexpr uint8_t SsrcAudioLevelExtensionId{ 1u };
+	// Consumers use the header extension ids of the Router capabilities.
+	static constexpr uint8_t ConsumerAbsSendTimeExtensionId{ 4u };
+	static constexpr uint8_t ConsumerSsrcAudioLevelExtensionId{ 10u };
+	// Temporal layer of each frame in a L1T3 / L3T3 pattern.
+	static constexpr uint8_t TemporalLayerPattern[]{ 0u, 2u, 1u, 2u };
+	// Payload length of each spatial layer / simulcast stream.
+	static constexpr size_t VideoPayloadLens[]{ 200u, 500u, 1000u };
+	static constexpr size_t AudioPayloadLen{ 100u };
+
+	/* Class methods. */
+
+	RtpGenerator::Codec RtpGenerator::GetCodec(const std::string& name)
+	{
+		MS_TRACE();
+
+		for (size_t idx{ 0u }; idx < CodecNames.size(); ++idx)
+		{
+			if (CodecNames[idx] == name)
+				return static_cast<Codec>(idx);
+		}
+
+		MS_THROW_TYPE_ERROR("unknown codec '%s'", name.c_str());
+	}
+
+	const std::string& RtpGenerator::GetCodecName(Codec codec)
+	{
+		MS_TRACE();
+
+		return CodecNames[static_cast<size_t>(codec)];
+	}
+
+	/* Instance methods. */
+
+	RtpGenerator::RtpGenerator(Codec codec, size_t keyFrameInterval, size_t packetsPerFrame)
+	  : codec(codec), keyFrameInterval(keyFrameInterval), packetsPerFrame(packetsPerFrame)
+	{
+		MS_TRACE();
+
+		auto numStreams = codec == Codec::VP8 ? 3u : 1u;
+
+		for (size_t idx{ 0u }; idx < numStreams; ++idx)
+		{
+			this->ssrcs.push_back(11111111u + static_cast<uint32_t>(idx));
+			this->seqs.push_back(static_cast<uint16_t>(Utils::Crypto::GetRandomUInt(0u, 0xFFFF)));
+		}
+
+		if (this->packetsPerFrame == 0u)
+			MS_THROW_TYPE_ERROR("packetsPerFrame must be greater than 0");
+
+		// Up to 3 packets per frame and layer (plus SPS), so no allocation
+		// happens later.
+		this->packets.reserve((3u * this->packetsPerFrame) + 1u);
+	}
+
+	void RtpGenerator::FillProducerParameters(json& rtpParameters, json& rtpMapping) const
+	{
+		MS_TRACE();
+
+		json codec = json::object();
+
+		codec["payloadType"] = PayloadType;
+
+		switch (this->codec)
+		{
+			case Codec::VP8:
+			{
+				codec["mimeType"]   = "video/VP8";
+				codec["clockRate"]  = 90000;
+				codec["parameters"] = json::object();
+
+				break;
+			}
+
+			case Codec::VP9:
+			{
+				codec["mimeType"]   = "video/VP9";
+				codec["clockRate"]  = 90000;
+				codec["parameters"] = { { "profile-id", 0 } };
+
+				break;
+			}
+
+			case Codec::H264:
+			{
+				codec["mimeType"]   = "video/H264";
+				codec["clockRate"]  = 90000;
+				codec["parameters"] = { { "packetization-mode", 1 },
+					                      { "profile-level-id", "42e01f" },
+					                      { "level-asymmetry-allowed", 1 } };
+
+				break;
+			}
+
+			case Codec::OPUS:
+			{
+				codec["mimeType"]   = "audio/opus";
+				codec["clockRate"]  = 48000;
+				codec["channels"]   = 2;
+				codec["parameters"] = { { "useinbandfec", 1 } };
+
+				break;
+			}
+		}
+
+		if (IsVideo())
+		{
+			codec["rtcpFeedback"] = json::array({ { { "type", "nack" } },
+			                                      { { "type", "nack" }, { "parameter", "pli" } },
+			                                      { { "type", "ccm" }, { "parameter", "fir" } } });
+		}
+		else
+		{
+			codec["rtcpFeedback"] = json::array();
+		}
+
+		rtpParameters["codecs"] = json::array({ codec });
+
+		rtpParameters["headerExtensions"] = json::array();
+
+		rtpParameters["headerExtensions"].push_back(
+		  { { "uri", "http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time" },
+		    { "id", AbsSendTimeExtensionId } });
+
+		if (!IsVideo())
+		{
+			rtpParameters["headerExtensions"].push_back(
+			  { { "uri", "urn:ietf:params:rtp-hdrext:ssrc-audio-level" },
+			    { "id", SsrcAudioLevelExtensionId } });
+		}
+
+		rtpParameters["encodings"] = json::array();
+		rtpMapping["encodings"]    = json::array();
+
+		for (auto ssrc : this->ssrcs)
+		{
+			json encoding = { { "ssrc", ssrc } };
+
+			if (this->codec == Codec::VP8)
+				encoding["scalabilityMode"] = "L1T3";
+			else if (this->codec == Codec::VP9)
+				encoding["scalabilityMode"] = "L3T3";
+
+			rtpParameters["encodings"].push_back(encoding);
+			rtpMapping["encodings"].push_back(
+			  { { "ssrc", ssrc }, { "mappedSsrc", ssrc + MappedSsrcOffset } });
+		}
+
+		rtpParameters["rtcp"] = { { "cname", "bench" }, { "reducedSize", true } };
+
+		rtpMapping["codecs"] = json::array(
+		  { { { "payloadType", PayloadType }, { "mappedPayloadType", MappedPayloadType } } });
+	}
+
+	void RtpGenerator::FillConsumerParameters(json& data) const
+	{
+		MS_TRACE();
+
+		json producerRtpParameters = json::object();
+		json rtpMapping            = json::object();
+
+		FillProducerParameters(producerRtpParameters, rtpMapping);
+
+		auto& rtpParameters = data["rtpParameters"];
+
+		rtpParameters = json::object();
+
+		rtpParameters["codecs"]                   = producerRtpParameters["codecs"];
+		rtpParameters["codecs"][0]["payloadType"] = MappedPayloadType;
+
+		rtpParameters["headerExtensions"] = json::array();
+
+		rtpParameters["headerExtensions"].push_back(
+		  { { "uri", "http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time" },
+		    { "id", ConsumerAbsSendTimeExtensionId } });
+
+		if (!IsVideo())
+		{
+			rtpParameters["headerExtensions"].push_back(
+			  { { "uri", "urn:ietf:params:rtp-hdrext:ssrc-audio-level" },
+			    { "id", ConsumerSsrcAudioLevelExtensionId } });
+		}
+
+		json encoding = { { "ssrc", Utils::Crypto::GetRandomUInt(100000000u, 999999999u) } };
+
+		if (this->codec == Codec::VP8)
+		{
+			data["type"]                = "simulcast";
+			encoding["scalabilityMode"] = "S3T3";
+		}
+		else if (this->codec == Codec::VP9)
+		{
+			data["type"]                = "svc";
+			encoding["scalabilityMode"] = "L3T3";
+		}
+		else
+		{
+			data["type"] = "simple";
+		}
+
+		rtpParameters["encodings"] = json::array({ encoding });
+		rtpParameters["rtcp"]      = { { "cname", "bench" }, { "reducedSize", true }, { "mux", true } };
+
+		data["consumableRtpEncodings"] = json::array();
+
+		for (size_t idx{ 0u }; idx < this->ssrcs.size(); ++idx)
+		{
+			json consumableEncoding = { { "ssrc", this->ssrcs[idx] + MappedSsrcOffset } };
+
+			if (producerRtpParameters["encodings"][idx].contains("scalabilityMode"))
+			{
+				consumableEncoding["scalabilityMode"] =
+				  producerRtpParameters["encodings"][idx]["scalabilityMode"];
+			}
+
+			data["consumableRtpEncodings"].push_back(consumableEncoding);
+		}
+	}
+
+	const std::vector<RtpGenerator::Packet>& RtpGenerator::NextFrame()
+	{
+		MS_TRACE();
+
+		this->packets.clear();
+
+		bool isKeyFrame =
+		  this->keyFrameRequested ||
+		  (this->keyFrameInterval != 0u && this->frameCount % this->keyFrameInterval == 0u);
+		uint8_t tid = isKeyFrame ? 0u : TemporalLayerPattern[this->frameCount % 4u];
+		uint8_t descriptor[6];
+
+		switch (this->codec)
+		{
+			case Codec::VP8:
+			{
+				// X, S, I, L, T, 15 bits picture id, TL0PICIDX, TID and Y.
+				descriptor[1] = 0xE0;
+				descriptor[2] = 0x80 | static_cast<uint8_t>(this->pictureId >> 8);
+				descriptor[3] = static_cast<uint8_t>(this->pictureId);
+				descriptor[4] = this->tl0PictureIndex;
+				descriptor[5] = static_cast<uint8_t>(tid << 6) | (tid != 0u ? 0x20 : 0x00);
+
+				for (size_t idx{ 0u }; idx < this->ssrcs.size(); ++idx)
+				{
+					for (size_t packetIdx{ 0u }; packetIdx < this->packetsPerFrame; ++packetIdx)
+					{
+						bool first = packetIdx == 0u;
+						bool last  = packetIdx == this->packetsPerFrame - 1u;
+
+						// S bit just in the first packet of the frame.
+						descriptor[0] = first ? 0x90 : 0x80;
+
+						AddPacket(idx, last, descriptor, 6u, VideoPayloadLens[idx]);
+
+						// VP8 payload header: P bit unset on key frames.
+						if (first)
+						{
+							this->packets.back().data[this->packets.back().len - VideoPayloadLens[idx]] =
+							  isKeyFrame ? 0x00 : 0x01;
+						}
+					}
+				}
+
+				break;
+			}
+
+			case Codec::VP9:
+			{
+				for (uint8_t sid{ 0u }; sid < 3u; ++sid)
+				{
+					for (size_t packetIdx{ 0u }; packetIdx < this->packetsPerFrame; ++packetIdx)
+					{
+						bool first = packetIdx == 0u;
+						bool last  = packetIdx == this->packetsPerFrame - 1u;
+
+						// I, P (inter picture), L, B (first packet of the layer frame) and E
+						// (last packet of the layer frame), 15 bits picture id, TID, U, SID,
+						// D and TL0PICIDX.
+						descriptor[0] = 0x80 | (isKeyFrame ? 0x00 : 0x40) | 0x20 | (first ? 0x08 : 0x00) |
+						                (last ? 0x04 : 0x00);
+						descriptor[1] = 0x80 | static_cast<uint8_t>(this->pictureId >> 8);
+						descriptor[2] = static_cast<uint8_t>(this->pictureId);
+						descriptor[3] = static_cast<uint8_t>(tid << 5) | (tid != 0u ? 0x10 : 0x00) |
+						                static_cast<uint8_t>(sid << 1) | (sid != 0u ? 0x01 : 0x00);
+						descriptor[4] = this->tl0PictureIndex;
+
+						AddPacket(0u, sid == 2u && last, descriptor, 5u, VideoPayloadLens[sid]);
+					}
+				}
+
+				break;
+			}
+
+			case Codec::H264:
+			{
+				if (isKeyFrame)
+				{
+					// SPS.
+					descriptor[0] = 0x67;
+
+					AddPacket(0u, false, descriptor, 1u, 20u);
+
+					// IDR slices.
+					descriptor[0] = 0x65;
+				}
+				else
+				{
+					// Non IDR slices.
+					descriptor[0] = 0x41;
+				}
+
+				for (size_t packetIdx{ 0u }; packetIdx < this->packetsPerFrame; ++packetIdx)
+				{
+					AddPacket(
+					  0u, packetIdx == this->packetsPerFrame - 1u, descriptor, 1u, VideoPayloadLens[2]);
+				}
+
+				break;
+			}
+
+			case Codec::OPUS:
+			{
+				AddPacket(0u, false, nullptr, 0u, AudioPayloadLen);
+
+				break;
+			}
+		}
+
+		++this->frameCount;
+		this->keyFrameRequested = false;
+		this->pictureId = (this->pictureId + 1u) & 0x7FFF;
+
+		if (tid == 0u)
+			++this->tl0PictureIndex;
+
+		this->timestamp += IsVideo() ? 90000u / GetFrameRate() : 48000u / GetFrameRate();
+
+		return this->packets;
+	}
+
+	void RtpGenerator::AddPacket(
+	  size_t streamIdx,
+	  bool marker,
+	  const uint8_t* descriptor,
+	  size_t descriptorLen,
+	  size_t payloadLen)
+	{
+		MS_TRACE();
+
+		this->packets.emplace_back();
+
+		auto& packet = this->packets.back();
+		auto* data   = packet.data;
+		size_t len{ 0u };
+
+		// RTP header with the one-byte header extension profile.
+		data[0] = 0x90;
+		data[1] = (marker ? 0x80 : 0x00) | PayloadType;
+		Utils::Byte::Set2Bytes(data, 2, this->seqs[streamIdx]++);
+		Utils::Byte::Set4Bytes(data, 4, this->timestamp);
+		Utils::Byte::Set4Bytes(data, 8, this->ssrcs[streamIdx]);
+		len += 12u;
+
+		// Header extensions: abs-send-time and, in audio, ssrc-audio-level.
+		auto extensionsLen = IsVideo() ? 4u : 8u;
+		auto nowMs         = this->frameCount * 1000u / GetFrameRate();
+		auto absSendTime   = static_cast<uint32_t>(((nowMs << 18) / 1000u) & 0x00FFFFFF);
+
+		Utils::Byte::Set2Bytes(data, len, 0xBEDE);
+		Utils::Byte::Set2Bytes(data, len + 2, extensionsLen / 4u);
+		len += 4u;
+
+		std::memset(data + len, 0, extensionsLen);
+
+		data[len] = static_cast<uint8_t>(AbsSendTimeExtensionId << 4) | 2u;
+		Utils::Byte::Set3Bytes(data, len + 1, absSendTime);
+
+		if (!IsVideo())
+		{
+			// Voice activity and -30 dBov.
+			data[len + 4] = static_cast<uint8_t>(SsrcAudioLevelExtensionId << 4);
+			data[len + 5] = 0x80 | 30u;
+		}
+
+		len += extensionsLen;
+
+		if (descriptorLen != 0u)
+		{
+			std::memcpy(data + len, descriptor, descriptorLen);
+			len += descriptorLen;
+		}
+
+		std::memset(data + len, 0xAB, payloadLen);
+		len += payloadLen;
+
+		packet.len = len;
+	}
+} // namespace Bench
@@ -0,0 +1,903 @@
+#define MS_CLASS "bench"
+
+#include "Allocations.hpp"
+#include "DepLibSRTP.hpp"
+#include "DepLibUV.hpp"
+#include "DepLibWebRTC.hpp"
+#include "DepOpenSSL.hpp"
+#include "DepUsrSCTP.hpp"
+#include "FanoutScenario.hpp"
+#include "FeedbackScenario.hpp"
+#include "ListenerScenario.hpp"
+#include "LogLevel.hpp"
+#include "MediaSoupErrors.hpp"
+#include "NetworkScenario.hpp"
+#include "Settings.hpp"
+#include "Utils.hpp"
+#include "handles/UdpSocketHandler.hpp"
+#include "RTC/DtlsTransport.hpp"
+#include "RTC/SrtpSession.hpp"
+#include <uv.h>
+#include <algorithm> // std::max()
+#include <cstdlib>   // std::getenv()
+#include <getopt.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Synthetic load generator measuring the RTP fanout throughput of a Router:
+ * a single Producer whose packets are forwarded to N Consumers. It reports
+ * packets per second, nanoseconds per packet and heap allocations per packet,
+ * so fanout regressions can be detected by comparing runs.
+ *
+ * The listener scenario instead measures how the RtpListener of a Transport
+ * with N Producers resolves the Producer of received RTP packets, both for
+ * known SSRCs and for the first packets of streams just signaled by MID and
+ * RID.
+ *
+ * The feedback scenario measures how the congestion controller of a transport
+ * processes transport-wide CC feedbacks (and the sent packets they report),
+ * with feedbacks passed one by one or in batches as when several of them are
+ * received together.
+ *
+ * The network scenario runs a Consumer over an emulated network in virtual
+ * time (see Bench::NetworkScenario) and reports, for each phase of a canned
+ * profile or of a capacity trace, the convergence time of the available
+ * outgoing bitrate, the link utilization and the queuing delay. If thresholds
+ * are given and not met it exits with status 1, so congestion control and
+ * pacing changes can be checked in CI.
+ *
+ * Usage:
+ *   mediasoup-worker-bench --codec=vp8 --transport=plain --consumers=100
+ *   mediasoup-worker-bench --scenario=listener --producers=10000
+ *   mediasoup-worker-bench --scenario=feedback --feedbacks=100000 --feedbacksPerBatch=4
+ *   mediasoup-worker-bench --scenario=network --profile=step-down --feedback=transport-cc
+ *     --pacing=true --queueMs=200 --lossRatio=0.01 --maxConvergenceMs=15000
+ *     --minUtilization=0.4 --maxQueueDelayMs=250
+ */
+
+enum class Scenario : uint8_t
+{
+	FANOUT = 0,
+	LISTENER,
+	FEEDBACK,
+	NETWORK
+};
+
+struct BenchOptions
+{
+	Scenario scenario{ Scenario::FANOUT };
+	Bench::FanoutScenario::Options fanout;
+	Bench::ListenerScenario::Options listener;
+	Bench::FeedbackScenario::Options feedback;
+	Bench::NetworkScenario::Options network;
+	size_t frames{ 3000u };
+	size_t warmupFrames{ 100u };
+	size_t rounds{ 100u };
+	size_t feedbacks{ 100000u };
+	// Network scenario thresholds (0 means not checked).
+	uint64_t maxConvergenceMs{ 0u };
+	double minUtilization{ 0 };
+	double maxQueueDelayMs{ 0 };
+	bool json{ false };
+};
+
+static BenchOptions ParseOptions(int argc, char* argv[]);
+static bool ParseBool(const std::string& value);
+static void RunFanoutScenario(const BenchOptions& options);
+static void RunListenerScenario(const BenchOptions& options);
+static void RunFeedbackScenario(const BenchOptions& options);
+static bool RunNetworkScenario(const BenchOptions& options);
+
+int main(int argc, char* argv[])
+{
+	LogLevel logLevel{ LogLevel::LOG_NONE };
+
+	// Get logLevel from ENV variable.
+	if (std::getenv("MS_BENCH_LOG_LEVEL"))
+	{
+		if (std::string(std::getenv("MS_BENCH_LOG_LEVEL")) == "debug")
+			logLevel = LogLevel::LOG_DEBUG;
+		else if (std::string(std::getenv("MS_BENCH_LOG_LEVEL")) == "warn")
+			logLevel = LogLevel::LOG_WARN;
+		else if (std::string(std::getenv("MS_BENCH_LOG_LEVEL")) == "error")
+			logLevel = LogLevel::LOG_ERROR;
+	}
+
+	Settings::configuration.logLevel = logLevel;
+
+	BenchOptions options;
+
+	try
+	{
+		options = ParseOptions(argc, argv);
+	}
+	catch (const MediaSoupError& error)
+	{
+		std::cerr << "[bench] " << error.what() << std::endl;
+
+		return 1;
+	}
+
+	// Initialize static stuff.
+	DepLibUV::ClassInit();
+	DepOpenSSL::ClassInit();
+	DepLibSRTP::ClassInit();
+	DepUsrSCTP::ClassInit();
+	DepLibWebRTC::ClassInit();
+	Utils::Crypto::ClassInit();
+	RTC::DtlsTransport::ClassInit();
+	RTC::SrtpSession::ClassInit();
+	UdpSocketHandler::CreateSendBatch(Settings::configuration.udpSendBatchSize);
+
+	int status{ 0 };
+
+	try
+	{
+		if (options.scenario == Scenario::FANOUT)
+			RunFanoutScenario(options);
+		else if (options.scenario == Scenario::LISTENER)
+			RunListenerScenario(options);
+		else if (options.scenario == Scenario::FEEDBACK)
+			RunFeedbackScenario(options);
+		else if (!RunNetworkScenario(options))
+			status = 1;
+	}
+	catch (const MediaSoupError& error)
+	{
+		std::cerr << "[bench] failure: " << error.what() << std::endl;
+
+		status = 1;
+	}
+
+	// Free static stuff.
+	UdpSocketHandler::CloseSendBatch();
+	DepLibUV::RunLoop();
+	DepLibSRTP::ClassDestroy();
+	Utils::Crypto::ClassDestroy();
+	DepLibWebRTC::ClassDestroy();
+	RTC::DtlsTransport::ClassDestroy();
+	DepUsrSCTP::ClassDestroy();
+	DepLibUV::ClassDestroy();
+
+	return status;
+}
+
+static void RunFanoutScenario(const BenchOptions& options)
+{
+	Bench::FanoutScenario scenario(options.fanout);
+
+	// Send one second of media in real time before Consumers join, so the
+	// Producer streams and their layers are active as with a real source.
+	for (size_t idx{ 0u }; idx < scenario.GetFrameRate(); ++idx)
+	{
+		scenario.SendFrame();
+		scenario.RunLoop();
+
+		uv_sleep(1000u / scenario.GetFrameRate());
+	}
+
+	scenario.CreateConsumers();
+
+	for (size_t idx{ 0u }; idx < options.warmupFrames; ++idx)
+	{
+		scenario.SendFrame();
+		scenario.RunLoop();
+		scenario.DrainSink();
+	}
+
+	uint64_t packetsSentBefore = scenario.GetConsumersPacketCount();
+	uint64_t packetsInjected{ 0u };
+	uint64_t packetsDelivered{ 0u };
+	uint64_t busyNs{ 0u };
+
+	Bench::Allocations::Reset();
+
+	// Only the time spent in the worker code is measured, not the time
+	// needed to drain the sink socket.
+	for (size_t idx{ 0u }; idx < options.frames; ++idx)
+	{
+		auto startNs = uv_hrtime();
+
+		Bench::Allocations::StartCounting();
+
+		packetsInjected += scenario.SendFrame();
+		scenario.RunLoop();
+
+		Bench::Allocations::StopCounting();
+
+		busyNs += uv_hrtime() - startNs;
+
+		packetsDelivered += scenario.DrainSink();
+	}
+
+	uint64_t packetsSent = scenario.GetConsumersPacketCount() - packetsSentBefore;
+	double packetsPerSecond =
+	  busyNs != 0u ? static_cast<double>(packetsSent) * 1e9 / static_cast<double>(busyNs) : 0;
+	double nsPerPacket =
+	  packetsSent != 0u ? static_cast<double>(busyNs) / static_cast<double>(packetsSent) : 0;
+	auto allocations = static_cast<double>(Bench::Allocations::GetCount());
+	double allocationsPerPacket =
+	  packetsSent != 0u ? allocations / static_cast<double>(packetsSent) : 0;
+	const auto& codec = Bench::RtpGenerator::GetCodecName(options.fanout.codec);
+	const char* transport =
+	  options.fanout.transportType == Bench::FanoutScenario::TransportType::PLAIN ? "plain"
+	                                                                              : "direct";
+
+	if (options.json)
+	{
+		json result = json::object();
+
+		result["codec"]                  = codec;
+		result["transport"]              = transport;
+		result["consumers"]              = options.fanout.consumers;
+		result["srtp"]                   = options.fanout.srtp;
+		result["sharedRtpPacketHistory"] = options.fanout.sharedRtpPacketHistory;
+		result["frames"]                 = options.frames;
+		result["packetsInjected"]        = packetsInjected;
+		result["packetsSent"]            = packetsSent;
+		result["packetsDelivered"]       = packetsDelivered;
+		result["busyMs"]                 = busyNs / 1000000u;
+		result["packetsPerSecond"]       = packetsPerSecond;
+		result["nsPerPacket"]            = nsPerPacket;
+		result["allocationsPerPacket"]   = allocationsPerPacket;
+
+		std::cout << result.dump() << std::endl;
+	}
+	else
+	{
+		std::cout << "[bench] codec:" << codec << " transport:" << transport
+		          << " consumers:" << options.fanout.consumers
+		          << " srtp:" << options.fanout.srtp
+		          << " sharedRtpPacketHistory:" << options.fanout.sharedRtpPacketHistory
+		          << " frames:" << options.frames << std::endl;
+		std::cout << "[bench] packets injected:" << packetsInjected << " sent:" << packetsSent
+		          << " delivered:" << packetsDelivered << " busy:" << busyNs / 1000000u << "ms"
+		          << std::endl;
+		std::cout << "[bench] packets/s:" << static_cast<uint64_t>(packetsPerSecond)
+		          << " ns/packet:" << nsPerPacket << " allocations/packet:" << allocationsPerPacket
+		          << std::endl;
+	}
+}
+
+static void RunListenerScenario(const BenchOptions& options)
+{
+	Bench::ListenerScenario scenario(options.listener);
+
+	auto numStreams = scenario.GetStreamCount();
+
+	Bench::Allocations::Reset();
+	Bench::Allocations::StartCounting();
+
+	auto startNs = uv_hrtime();
+
+	scenario.AddProducers();
+
+	uint64_t addNs = uv_hrtime() - startNs;
+
+	Bench::Allocations::StopCounting();
+
+	auto addAllocations = Bench::Allocations::GetCount();
+
+	// Learn the SSRCs once so the SSRC table has its final size.
+	if (scenario.LookupPackets() != numStreams)
+		MS_THROW_ERROR("RTP packets not resolved to their Producer");
+
+	uint64_t newStreamsNs{ 0u };
+	uint64_t newStreamsAllocations{ 0u };
+	uint64_t knownStreamsNs{ 0u };
+	uint64_t knownStreamsAllocations{ 0u };
+
+	for (size_t round{ 0u }; round < options.rounds; ++round)
+	{
+		scenario.ForgetLearntSsrcs();
+
+		Bench::Allocations::Reset();
+		Bench::Allocations::StartCounting();
+
+		startNs = uv_hrtime();
+
+		scenario.LookupPackets();
+
+		newStreamsNs += uv_hrtime() - startNs;
+
+		Bench::Allocations::StopCounting();
+
+		newStreamsAllocations += Bench::Allocations::GetCount();
+
+		Bench::Allocations::Reset();
+		Bench::Allocations::StartCounting();
+
+		startNs = uv_hrtime();
+
+		scenario.LookupPackets();
+
+		knownStreamsNs += uv_hrtime() - startNs;
+
+		Bench::Allocations::StopCounting();
+
+		knownStreamsAllocations += Bench::Allocations::GetCount();
+	}
+
+	startNs = uv_hrtime();
+
+	scenario.RemoveProducers();
+
+	uint64_t removeNs = uv_hrtime() - startNs;
+
+	auto numProducers                = static_cast<double>(options.listener.producers);
+	auto numLookups                  = static_cast<double>(numStreams * options.rounds);
+	double addNsPerProducer          = static_cast<double>(addNs) / numProducers;
+	double addAllocationsPerProducer = static_cast<double>(addAllocations) / numProducers;
+	double removeNsPerProducer       = static_cast<double>(removeNs) / numProducers;
+	double newStreamsNsPerPacket =
+	  numLookups != 0 ? static_cast<double>(newStreamsNs) / numLookups : 0;
+	double newStreamsAllocationsPerPacket =
+	  numLookups != 0 ? static_cast<double>(newStreamsAllocations) / numLookups : 0;
+	double knownStreamsNsPerPacket =
+	  numLookups != 0 ? static_cast<double>(knownStreamsNs) / numLookups : 0;
+	double knownStreamsAllocationsPerPacket =
+	  numLookups != 0 ? static_cast<double>(knownStreamsAllocations) / numLookups : 0;
+
+	if (options.json)
+	{
+		json result = json::object();
+
+		result["scenario"]                         = "listener";
+		result["producers"]                        = options.listener.producers;
+		result["streams"]                          = numStreams;
+		result["rounds"]                           = options.rounds;
+		result["addNsPerProducer"]                 = addNsPerProducer;
+		result["addAllocationsPerProducer"]        = addAllocationsPerProducer;
+		result["removeNsPerProducer"]              = removeNsPerProducer;
+		result["newStreamsNsPerPacket"]            = newStreamsNsPerPacket;
+		result["newStreamsAllocationsPerPacket"]   = newStreamsAllocationsPerPacket;
+		result["knownStreamsNsPerPacket"]          = knownStreamsNsPerPacket;
+		result["knownStreamsAllocationsPerPacket"] = knownStreamsAllocationsPerPacket;
+
+		std::cout << result.dump() << std::endl;
+	}
+	else
+	{
+		std::cout << "[bench] scenario:listener producers:" << options.listener.producers
+		          << " streams:" << numStreams << " rounds:" << options.rounds << std::endl;
+		std::cout << "[bench] add ns/producer:" << addNsPerProducer
+		          << " allocations/producer:" << addAllocationsPerProducer
+		          << " remove ns/producer:" << removeNsPerProducer << std::endl;
+		std::cout << "[bench] new streams ns/packet:" << newStreamsNsPerPacket
+		          << " allocations/packet:" << newStreamsAllocationsPerPacket << std::endl;
+		std::cout << "[bench] known streams ns/packet:" << knownStreamsNsPerPacket
+		          << " allocations/packet:" << knownStreamsAllocationsPerPacket << std::endl;
+	}
+}
+
+static void RunFeedbackScenario(const BenchOptions& options)
+{
+	Bench::FeedbackScenario scenario(options.feedback);
+
+	auto numBatches = std::max<size_t>(options.feedbacks / options.feedback.feedbacksPerBatch, 1u);
+
+	// Let reused buffers grow to their final size.
+	for (size_t idx{ 0u }; idx < options.warmupFrames; ++idx)
+	{
+		scenario.SendPackets();
+		scenario.CreateFeedbacks();
+		scenario.ReceiveFeedbacks();
+	}
+
+	uint64_t sendNs{ 0u };
+	uint64_t sendAllocations{ 0u };
+	uint64_t feedbackNs{ 0u };
+	uint64_t feedbackAllocations{ 0u };
+	uint64_t numFeedbacks{ 0u };
+
+	// Generating and parsing the feedbacks is not measured.
+	for (size_t idx{ 0u }; idx < numBatches; ++idx)
+	{
+		Bench::Allocations::Reset();
+		Bench::Allocations::StartCounting();
+
+		auto startNs = uv_hrtime();
+
+		scenario.SendPackets();
+
+		sendNs += uv_hrtime() - startNs;
+
+		Bench::Allocations::StopCounting();
+
+		sendAllocations += Bench::Allocations::GetCount();
+
+		scenario.CreateFeedbacks();
+
+		Bench::Allocations::Reset();
+		Bench::Allocations::StartCounting();
+
+		startNs = uv_hrtime();
+
+		numFeedbacks += scenario.ReceiveFeedbacks();
+
+		feedbackNs += uv_hrtime() - startNs;
+
+		Bench::Allocations::StopCounting();
+
+		feedbackAllocations += Bench::Allocations::GetCount();
+	}
+
+	auto numPackets = static_cast<double>(numFeedbacks * options.feedback.packetsPerFeedback);
+	double sendNsPerPacket          = static_cast<double>(sendNs) / numPackets;
+	double sendAllocationsPerPacket = static_cast<double>(sendAllocations) / numPackets;
+	double nsPerFeedback = static_cast<double>(feedbackNs) / static_cast<double>(numFeedbacks);
+	double allocationsPerFeedback =
+	  static_cast<double>(feedbackAllocations) / static_cast<double>(numFeedbacks);
+	double feedbacksPerSecond = nsPerFeedback > 0 ? 1e9 / nsPerFeedback : 0;
+
+	if (options.json)
+	{
+		json result = json::object();
+
+		result["scenario"]                 = "feedback";
+		result["packetsPerFeedback"]       = options.feedback.packetsPerFeedback;
+		result["feedbacksPerBatch"]        = options.feedback.feedbacksPerBatch;
+		result["feedbacks"]                = numFeedbacks;
+		result["sendNsPerPacket"]          = sendNsPerPacket;
+		result["sendAllocationsPerPacket"] = sendAllocationsPerPacket;
+		result["feedbacksPerSecond"]       = feedbacksPerSecond;
+		result["nsPerFeedback"]            = nsPerFeedback;
+		result["allocationsPerFeedback"]   = allocationsPerFeedback;
+		result["availableBitrate"]         = scenario.GetAvailableBitrate();
+
+		std::cout << result.dump() << std::endl;
+	}
+	else
+	{
+		std::cout << "[bench] scenario:feedback packetsPerFeedback:"
+		          << options.feedback.packetsPerFeedback
+		          << " feedbacksPerBatch:" << options.feedback.feedbacksPerBatch
+		          << " feedbacks:" << numFeedbacks << std::endl;
+		std::cout << "[bench] sent packets ns/packet:" << sendNsPerPacket
+		          << " allocations/packet:" << sendAllocationsPerPacket << std::endl;
+		std::cout << "[bench] feedbacks/s:" << static_cast<uint64_t>(feedbacksPerSecond)
+		          << " ns/feedback:" << nsPerFeedback
+		          << " allocations/feedback:" << allocationsPerFeedback
+		          << " available bitrate:" << scenario.GetAvailableBitrate() << std::endl;
+	}
+}
+
+static bool RunNetworkScenario(const BenchOptions& options)
+{
+	Bench::NetworkScenario scenario(options.network);
+
+	auto result = scenario.Run();
+	std::vector<std::string> failures;
+
+	for (size_t idx{ 0u }; idx < result.phases.size(); ++idx)
+	{
+		const auto& phase = result.phases[idx];
+
+		// clang-format off
+		if (
+			options.maxConvergenceMs != 0u &&
+			(
+				phase.convergenceMs == -1 ||
+				static_cast<uint64_t>(phase.convergenceMs) > options.maxConvergenceMs
+			)
+		)
+		// clang-format on
+		{
+			failures.push_back("phase " + std::to_string(idx) + " convergence");
+		}
+
+		if (options.maxQueueDelayMs != 0 && phase.queueDelayP95Ms > options.maxQueueDelayMs)
+			failures.push_back("phase " + std::to_string(idx) + " queuing delay");
+	}
+
+	if (options.minUtilization != 0 && result.utilization < options.minUtilization)
+		failures.push_back("utilization");
+
+	const auto& network = options.network;
+	const auto& profile = network.traceFile.empty()
+	                        ? Bench::NetworkScenario::GetProfileName(network.profile)
+	                        : network.traceFile;
+	const auto& feedback = Bench::NetworkScenario::GetFeedbackName(network.feedback);
+	const auto& codec    = Bench::RtpGenerator::GetCodecName(network.codec);
+
+	if (options.json)
+	{
+		json output = json::object();
+
+		output["scenario"]            = "network";
+		output["profile"]             = profile;
+		output["feedback"]            = feedback;
+		output["codec"]               = codec;
+		output["pacing"]              = network.pacing;
+		output["senderBwe"]           = network.senderBwe;
+		output["queueMs"]             = network.link.queueMs;
+		output["delayMs"]             = network.link.delayMs;
+		output["jitterMs"]            = network.link.jitterMs;
+		output["lossRatio"]           = network.link.lossRatio;
+		output["reorderRatio"]        = network.link.reorderRatio;
+		output["seed"]                = network.link.seed;
+		output["phases"]              = json::array();
+		output["utilization"]         = result.utilization;
+		output["sentPackets"]         = result.sentPackets;
+		output["queueDroppedPackets"] = result.queueDroppedPackets;
+		output["lostPackets"]         = result.lostPackets;
+		output["passed"]              = failures.empty();
+		output["failures"]            = failures;
+
+		for (const auto& phase : result.phases)
+		{
+			json jsonPhase = json::object();
+
+			jsonPhase["startMs"]                  = phase.startMs;
+			jsonPhase["endMs"]                    = phase.endMs;
+			jsonPhase["availableCapacity"]        = phase.availableCapacity;
+			jsonPhase["convergenceMs"]            = phase.convergenceMs;
+			jsonPhase["utilization"]              = phase.utilization;
+			jsonPhase["deliveredBitrate"]         = phase.deliveredBitrate;
+			jsonPhase["availableOutgoingBitrate"] = phase.availableOutgoingBitrate;
+			jsonPhase["queueDelayMeanMs"]         = phase.queueDelayMeanMs;
+			jsonPhase["queueDelayP95Ms"]          = phase.queueDelayP95Ms;
+			jsonPhase["queueDroppedPackets"]      = phase.queueDroppedPackets;
+			jsonPhase["lostPackets"]              = phase.lostPackets;
+
+			output["phases"].push_back(jsonPhase);
+		}
+
+		std::cout << output.dump() << std::endl;
+	}
+	else
+	{
+		std::cout << "[bench] scenario:network profile:" << profile << " feedback:" << feedback
+		          << " codec:" << codec << " pacing:" << network.pacing
+		          << " senderBwe:" << network.senderBwe << std::endl;
+		std::cout << "[bench] queue:" << network.link.queueMs << "ms delay:" << network.link.delayMs
+		          << "ms jitter:" << network.link.jitterMs << "ms loss:" << network.link.lossRatio
+		          << " reorder:" << network.link.reorderRatio << " seed:" << network.link.seed
+		          << std::endl;
+
+		for (size_t idx{ 0u }; idx < result.phases.size(); ++idx)
+		{
+			const auto& phase = result.phases[idx];
+
+			std::cout << "[bench] phase:" << idx << " start:" << phase.startMs
+			          << "ms capacity:" << phase.availableCapacity << " convergence:";
+
+			if (phase.convergenceMs == -1)
+				std::cout << "none";
+			else
+				std::cout << phase.convergenceMs << "ms";
+
+			std::cout << " utilization:" << phase.utilization
+			          << " delivered:" << phase.deliveredBitrate
+			          << " available outgoing:" << phase.availableOutgoingBitrate << std::endl;
+			std::cout << "[bench] phase:" << idx << " queuing delay mean:" << phase.queueDelayMeanMs
+			          << "ms p95:" << phase.queueDelayP95Ms
+			          << "ms dropped:" << phase.queueDroppedPackets << " lost:" << phase.lostPackets
+			          << std::endl;
+		}
+
+		std::cout << "[bench] utilization:" << result.utilization << " sent:" << result.sentPackets
+		          << " dropped:" << result.queueDroppedPackets << " lost:" << result.lostPackets
+		          << std::endl;
+
+		for (const auto& failure : failures)
+		{
+			std::cout << "[bench] threshold not met: " << failure << std::endl;
+		}
+	}
+
+	return failures.empty();
+}
+
+static BenchOptions ParseOptions(int argc, char* argv[])
+{
+	/* Variables for getopt. */
+
+	int c;
+	int optionIdx{ 0 };
+	// clang-format off
+	struct option options[] =
+	{
+		{ "scenario",               required_argument, nullptr, 'S' },
+		{ "codec",                  required_argument, nullptr, 'c' },
+		{ "transport",              required_argument, nullptr, 't' },
+		{ "consumers",              required_argument, nullptr, 'n' },
+		{ "frames",                 required_argument, nullptr, 'f' },
+		{ "warmupFrames",           required_argument, nullptr, 'w' },
+		{ "keyFrameInterval",       required_argument, nullptr, 'k' },
+		{ "srtp",                   required_argument, nullptr, 's' },
+		{ "sharedRtpPacketHistory", required_argument, nullptr, 'h' },
+		{ "udpSendBatchSize",       required_argument, nullptr, 'b' },
+		{ "producers",              required_argument, nullptr, 'p' },
+		{ "rounds",                 required_argument, nullptr, 'r' },
+		{ "feedbacks",              required_argument, nullptr, 'F' },
+		{ "packetsPerFeedback",     required_argument, nullptr, 'P' },
+		{ "feedbacksPerBatch",      required_argument, nullptr, 'B' },
+		{ "profile",                required_argument, nullptr, 'o' },
+		{ "networkTrace",           required_argument, nullptr, 'T' },
+		{ "feedback",               required_argument, nullptr, 'e' },
+		{ "packetsPerFrame",        required_argument, nullptr, 'K' },
+		{ "pacing",                 required_argument, nullptr, 'a' },
+		{ "senderBwe",              required_argument, nullptr, 'E' },
+		{ "queueMs",                required_argument, nullptr, 'q' },
+		{ "delayMs",                required_argument, nullptr, 'd' },
+		{ "jitterMs",               required_argument, nullptr, 'J' },
+		{ "lossRatio",              required_argument, nullptr, 'l' },
+		{ "reorderRatio",           required_argument, nullptr, 'R' },
+		{ "seed",                   required_argument, nullptr, 'x' },
+		{ "maxConvergenceMs",       required_argument, nullptr, 'C' },
+		{ "minUtilization",         required_argument, nullptr, 'U' },
+		{ "maxQueueDelayMs",        required_argument, nullptr, 'Q' },
+		{ "json",                   required_argument, nullptr, 'j' },
+		{ nullptr, 0, nullptr, 0 }
+	};
+	// clang-format on
+	BenchOptions benchOptions;
+
+	optind = 1;
+	opterr = 0;
+
+	while ((c = getopt_long_only(argc, argv, "", options, &optionIdx)) != -1)
+	{
+		if (c == '?' || !optarg)
+			MS_THROW_TYPE_ERROR("invalid option (use --name=value)");
+
+		std::string value(optarg);
+
+		try
+		{
+			switch (c)
+			{
+				case 'S':
+				{
+					if (value == "fanout")
+						benchOptions.scenario = Scenario::FANOUT;
+					else if (value == "listener")
+						benchOptions.scenario = Scenario::LISTENER;
+					else if (value == "feedback")
+						benchOptions.scenario = Scenario::FEEDBACK;
+					else if (value == "network")
+						benchOptions.scenario = Scenario::NETWORK;
+					else
+						MS_THROW_TYPE_ERROR("invalid scenario '%s'", value.c_str());
+
+					break;
+				}
+
+				case 'c':
+				{
+					benchOptions.fanout.codec  = Bench::RtpGenerator::GetCodec(value);
+					benchOptions.network.codec = benchOptions.fanout.codec;
+
+					break;
+				}
+
+				case 't':
+				{
+					if (value == "plain")
+						benchOptions.fanout.transportType = Bench::FanoutScenario::TransportType::PLAIN;
+					else if (value == "direct")
+						benchOptions.fanout.transportType = Bench::FanoutScenario::TransportType::DIRECT;
+					else
+						MS_THROW_TYPE_ERROR("invalid transport '%s'", value.c_str());
+
+					break;
+				}
+
+				case 'n':
+				{
+					benchOptions.fanout.consumers = std::stoul(value);
+
+					break;
+				}
+
+				case 'f':
+				{
+					benchOptions.frames = std::stoul(value);
+
+					break;
+				}
+
+				case 'w':
+				{
+					benchOptions.warmupFrames = std::stoul(value);
+
+					break;
+				}
+
+				case 'k':
+				{
+					benchOptions.fanout.keyFrameInterval = std::stoul(value);
+
+					break;
+				}
+
+				case 's':
+				{
+					benchOptions.fanout.srtp = ParseBool(value);
+
+					break;
+				}
+
+				case 'h':
+				{
+					benchOptions.fanout.sharedRtpPacketHistory = ParseBool(value);
+
+					break;
+				}
+
+				case 'b':
+				{
+					Settings::configuration.udpSendBatchSize = static_cast<uint16_t>(std::stoul(value));
+
+					break;
+				}
+
+				case 'p':
+				{
+					benchOptions.listener.producers = std::stoul(value);
+
+					break;
+				}
+
+				case 'r':
+				{
+					benchOptions.rounds = std::stoul(value);
+
+					break;
+				}
+
+				case 'F':
+				{
+					benchOptions.feedbacks = std::stoul(value);
+
+					break;
+				}
+
+				case 'P':
+				{
+					benchOptions.feedback.packetsPerFeedback = std::stoul(value);
+
+					break;
+				}
+
+				case 'B':
+				{
+					benchOptions.feedback.feedbacksPerBatch = std::stoul(value);
+
+					break;
+				}
+
+				case 'o':
+				{
+					benchOptions.network.profile = Bench::NetworkScenario::GetProfile(value);
+
+					break;
+				}
+
+				case 'T':
+				{
+					benchOptions.network.traceFile = value;
+
+					break;
+				}
+
+				case 'e':
+				{
+					benchOptions.network.feedback = Bench::NetworkScenario::GetFeedback(value);
+
+					break;
+				}
+
+				case 'K':
+				{
+					benchOptions.network.packetsPerFrame = std::stoul(value);
+
+					break;
+				}
+
+				case 'a':
+				{
+					benchOptions.network.pacing = ParseBool(value);
+
+					break;
+				}
+
+				case 'E':
+				{
+					benchOptions.network.senderBwe = ParseBool(value);
+
+					break;
+				}
+
+				case 'q':
+				{
+					benchOptions.network.link.queueMs = std::stoul(value);
+
+					break;
+				}
+
+				case 'd':
+				{
+					benchOptions.network.link.delayMs = std::stoul(value);
+
+					break;
+				}
+
+				case 'J':
+				{
+					benchOptions.network.link.jitterMs = std::stoul(value);
+
+					break;
+				}
+
+				case 'l':
+				{
+					benchOptions.network.link.lossRatio = std::stod(value);
+
+					break;
+				}
+
+				case 'R':
+				{
+					benchOptions.network.link.reorderRatio = std::stod(value);
+
+					break;
+				}
+
+				case 'x':
+				{
+					benchOptions.network.link.seed = std::stoul(value);
+
+					break;
+				}
+
+				case 'C':
+				{
+					benchOptions.maxConvergenceMs = std::stoull(value);
+
+					break;
+				}
+
+				case 'U':
+				{
+					benchOptions.minUtilization = std::stod(value);
+
+					break;
+				}
+
+				case 'Q':
+				{
+					benchOptions.maxQueueDelayMs = std::stod(value);
+
+					break;
+				}
+
+				case 'j':
+				{
+					benchOptions.json = ParseBool(value);
+
+					break;
+				}
+			}
+		}
+		catch (const std::logic_error&)
+		{
+			MS_THROW_TYPE_ERROR("invalid value '%s' for option '%s'", optarg, options[optionIdx].name);
+		}
+	}
+
+	return benchOptions;
+}
+
+static bool ParseBool(const std::string& value)
+{
+	if (value == "true" || value == "1")
+		return true;
+	else if (value == "false" || value == "0")
+		return false;
+
+	MS_THROW_TYPE_ERROR("invalid boolean '%s'", value.c_str());
+}
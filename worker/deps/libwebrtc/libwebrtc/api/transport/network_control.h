@@ -81,8 +81,9 @@ class NetworkControllerInterface {
   // Called when a protocol specific calculation of packet loss has been made.
   virtual NetworkControlUpdate OnTransportLossReport(TransportLossReport) = 0;
   // Called with per packet feedback regarding receive time.
+  // MS_NOTE: Taken by reference to avoid copying the packet feedbacks.
   virtual NetworkControlUpdate OnTransportPacketsFeedback(
-      TransportPacketsFeedback) = 0;
+      const TransportPacketsFeedback&) = 0;
   // Called with network state estimate updates.
   virtual NetworkControlUpdate OnNetworkStateEstimate(NetworkStateEstimate) = 0;
 };
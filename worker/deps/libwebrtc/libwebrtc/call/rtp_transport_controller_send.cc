@@ -235,15 +235,36 @@ void RtpTransportControllerSend::OnTransportFeedback(
     const RTC::RTCP::FeedbackRtpTransportPacket& feedback) {
   MS_DEBUG_DEV("<<<<<");
 
-  absl::optional<TransportPacketsFeedback> feedback_msg =
-      transport_feedback_adapter_.ProcessTransportFeedback(
-          feedback, Timestamp::ms(DepLibUV::GetTimeMsInt64()));
-  if (feedback_msg)
-    PostUpdates(controller_->OnTransportPacketsFeedback(*feedback_msg));
+  if (transport_feedback_adapter_.ProcessTransportFeedback(
+          feedback, Timestamp::ms(DepLibUV::GetTimeMsInt64()),
+          &pending_feedback_msg_)) {
+    pending_feedback_ = true;
+  }
+  if (!feedback_batching_)
+    FlushTransportFeedback();
   pacer_.UpdateOutstandingData(
       transport_feedback_adapter_.GetOutstandingData().bytes());
 }
 
+void RtpTransportControllerSend::StartTransportFeedbackBatch() {
+  feedback_batching_ = true;
+}
+
+void RtpTransportControllerSend::EndTransportFeedbackBatch() {
+  feedback_batching_ = false;
+  FlushTransportFeedback();
+}
+
+void RtpTransportControllerSend::FlushTransportFeedback() {
+  if (!pending_feedback_)
+    return;
+
+  pending_feedback_ = false;
+  PostUpdates(controller_->OnTransportPacketsFeedback(pending_feedback_msg_));
+  pending_feedback_msg_.packet_feedbacks.clear();
+  pending_feedback_msg_.sendless_arrival_times.clear();
+}
+
 void RtpTransportControllerSend::OnRemoteNetworkEstimate(
     NetworkStateEstimate estimate) {
   estimate.update_time = Timestamp::ms(DepLibUV::GetTimeMsInt64());
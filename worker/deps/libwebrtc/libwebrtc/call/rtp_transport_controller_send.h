@@ -79,6 +79,11 @@ class RtpTransportControllerSend final
   void OnAddPacket(const RtpPacketSendInfo& packet_info) override;
   void OnTransportFeedback(const RTC::RTCP::FeedbackRtpTransportPacket& feedback) override;
 
+  // MS_NOTE: Transport feedbacks received between these calls are passed to
+  // the network controller as a single update when the batch ends.
+  void StartTransportFeedbackBatch();
+  void EndTransportFeedbackBatch();
+
   // Implements NetworkStateEstimateObserver interface
   void OnRemoteNetworkEstimate(NetworkStateEstimate estimate) override;
 
@@ -93,6 +98,7 @@ class RtpTransportControllerSend final
   void OnReceivedRtcpReceiverReportBlocks(const ReportBlockList& report_blocks,
                                           int64_t now_ms);
   void PostUpdates(NetworkControlUpdate update);
+  void FlushTransportFeedback();
   void UpdateControlState();
 
   const FieldTrialBasedConfig trial_based_config_;
@@ -128,6 +134,12 @@ class RtpTransportControllerSend final
 
   bool network_available_;
 
+  // MS_NOTE: Packet feedbacks not yet passed to the network controller. Its
+  // buffers are reused for every update.
+  TransportPacketsFeedback pending_feedback_msg_;
+  bool pending_feedback_ = false;
+  bool feedback_batching_ = false;
+
   // TODO(perkj): |task_queue_| is supposed to replace |process_thread_|.
   // |task_queue_| is defined last to ensure all pending tasks are cancelled
   // and deleted before any other members.
@@ -6,7 +6,6 @@
 #include "RTC/RTCP/FeedbackRtpTransport.hpp"
 
 #include <cstdint>
-#include <vector>
 
 namespace mediasoup_helpers
 {
@@ -15,18 +14,11 @@ namespace mediasoup_helpers
 	 */
 	namespace FeedbackRtpTransport
 	{
-		const std::vector<webrtc::rtcp::ReceivedPacket> GetReceivedPackets(
-			const RTC::RTCP::FeedbackRtpTransportPacket* packet)
+		// Get the receive delta of a received packet in microseconds.
+		int64_t GetDeltaUs(
+		  const RTC::RTCP::FeedbackRtpTransportPacket::PacketResult& packetResult)
 		{
-			std::vector<webrtc::rtcp::ReceivedPacket> receivedPackets;
-
-			for (auto& packetResult : packet->GetPacketResults())
-			{
-			  if (packetResult.received)
-			    receivedPackets.emplace_back(packetResult.sequenceNumber, packetResult.delta);
-			}
-
-			return receivedPackets;
+			return static_cast<int64_t>(packetResult.delta) * webrtc::rtcp::kDeltaScaleFactor;
 		}
 
 		// Get the reference time in microseconds, including any precision loss.
@@ -409,7 +409,7 @@ void GoogCcNetworkController::UpdateCongestionWindowSize(
 }
 
 NetworkControlUpdate GoogCcNetworkController::OnTransportPacketsFeedback(
-    TransportPacketsFeedback report) {
+    const TransportPacketsFeedback& report) {
   if (report.packet_feedbacks.empty()) {
     // TODO(bugs.webrtc.org/10125): Design a better mechanism to safe-guard
     // against building very large network queues.
@@ -491,10 +491,12 @@ NetworkControlUpdate GoogCcNetworkController::OnTransportPacketsFeedback(
     probe_controller_->SetAlrEndedTimeMs(now_ms);
   }
   previously_in_alr_ = alr_start_time.has_value();
+  // MS_NOTE: Sort the packet feedbacks just once.
+  std::vector<PacketResult> sorted_feedbacks = report.SortedByReceiveTime();
   acknowledged_bitrate_estimator_->IncomingPacketFeedbackVector(
-      report.SortedByReceiveTime());
+      sorted_feedbacks);
   auto acknowledged_bitrate = acknowledged_bitrate_estimator_->bitrate();
-  for (const auto& feedback : report.SortedByReceiveTime()) {
+  for (const auto& feedback : sorted_feedbacks) {
     if (feedback.sent_packet.pacing_info.probe_cluster_id !=
         PacedPacketInfo::kNotAProbe) {
       probe_bitrate_estimator_->HandleProbeAndEstimateBitrate(feedback);
@@ -60,7 +60,7 @@ class GoogCcNetworkController : public NetworkControllerInterface {
       TargetRateConstraints msg) override;
   NetworkControlUpdate OnTransportLossReport(TransportLossReport msg) override;
   NetworkControlUpdate OnTransportPacketsFeedback(
-      TransportPacketsFeedback msg) override;
+      const TransportPacketsFeedback& msg) override;
   NetworkControlUpdate OnNetworkStateEstimate(
       NetworkStateEstimate msg) override;
 
@@ -125,26 +125,26 @@ absl::optional<SentPacket> TransportFeedbackAdapter::ProcessSentPacket(
   return absl::nullopt;
 }
 
-absl::optional<TransportPacketsFeedback>
-TransportFeedbackAdapter::ProcessTransportFeedback(
+bool TransportFeedbackAdapter::ProcessTransportFeedback(
     const RTC::RTCP::FeedbackRtpTransportPacket& feedback,
-    Timestamp feedback_receive_time) {
-  DataSize prior_in_flight = GetOutstandingData();
+    Timestamp feedback_receive_time,
+    TransportPacketsFeedback* msg) {
+  // MS_NOTE: Just the first feedback of the update sets the prior in flight
+  // data.
+  if (msg->packet_feedbacks.empty() && msg->sendless_arrival_times.empty())
+    msg->prior_in_flight = GetOutstandingData();
 
-  last_packet_feedback_vector_ =
-      GetPacketFeedbackVector(feedback, feedback_receive_time);
+  GetPacketFeedbackVector(feedback, feedback_receive_time);
   {
     for (auto* observer : observers_) {
       observer->OnPacketFeedbackVector(last_packet_feedback_vector_);
     }
   }
 
-  std::vector<PacketFeedback> feedback_vector = last_packet_feedback_vector_;
-  if (feedback_vector.empty())
-    return absl::nullopt;
+  if (last_packet_feedback_vector_.empty())
+    return false;
 
-  TransportPacketsFeedback msg;
-  for (const PacketFeedback& rtp_feedback : feedback_vector) {
+  for (const PacketFeedback& rtp_feedback : last_packet_feedback_vector_) {
     if (rtp_feedback.send_time_ms != PacketFeedback::kNoSendTime) {
       auto feedback = NetworkPacketFeedbackFromRtpPacketFeedback(rtp_feedback);
       MS_DEBUG_DEV("feedback received for RTP packet: [seq_num: %" PRIi64 ", send_time:%" PRIi64 ", size: %lld, feedback.receive_time:%" PRIi64,
@@ -153,12 +153,12 @@ TransportFeedbackAdapter::ProcessTransportFeedback(
           feedback.sent_packet.size.bytes(),
           feedback.receive_time.ms());
 
-      msg.packet_feedbacks.push_back(feedback);
+      msg->packet_feedbacks.push_back(feedback);
     } else if (rtp_feedback.arrival_time_ms == PacketFeedback::kNotReceived) {
       MS_DEBUG_DEV("--- rtp_feedback.arrival_time_ms == PacketFeedback::kNotReceived ---");
-      msg.sendless_arrival_times.push_back(Timestamp::PlusInfinity());
+      msg->sendless_arrival_times.push_back(Timestamp::PlusInfinity());
     } else {
-      msg.sendless_arrival_times.push_back(
+      msg->sendless_arrival_times.push_back(
           Timestamp::ms(rtp_feedback.arrival_time_ms));
     }
   }
@@ -166,21 +166,22 @@ TransportFeedbackAdapter::ProcessTransportFeedback(
     absl::optional<int64_t> first_unacked_send_time_ms =
         send_time_history_.GetFirstUnackedSendTime();
     if (first_unacked_send_time_ms)
-      msg.first_unacked_send_time = Timestamp::ms(*first_unacked_send_time_ms);
+      msg->first_unacked_send_time = Timestamp::ms(*first_unacked_send_time_ms);
+    else
+      msg->first_unacked_send_time = Timestamp::PlusInfinity();
   }
-  msg.feedback_time = feedback_receive_time;
-  msg.prior_in_flight = prior_in_flight;
-  msg.data_in_flight = GetOutstandingData();
+  msg->feedback_time = feedback_receive_time;
+  msg->data_in_flight = GetOutstandingData();
 
-  MS_DEBUG_DEV("prior_in_flight:%lld, data_in_flight:%lld", msg.prior_in_flight.bytes(), msg.data_in_flight.bytes());
-  return msg;
+  MS_DEBUG_DEV("prior_in_flight:%lld, data_in_flight:%lld", msg->prior_in_flight.bytes(), msg->data_in_flight.bytes());
+  return true;
 }
 
 DataSize TransportFeedbackAdapter::GetOutstandingData() const {
   return send_time_history_.GetOutstandingData(local_net_id_, remote_net_id_);
 }
 
-std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
+void TransportFeedbackAdapter::GetPacketFeedbackVector(
     const RTC::RTCP::FeedbackRtpTransportPacket& feedback,
     Timestamp feedback_time) {
   // Add timestamp deltas to a local time base selected on first packet arrival.
@@ -195,43 +196,52 @@ std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
   last_timestamp_us_ =
     mediasoup_helpers::FeedbackRtpTransport::GetBaseTimeUs(&feedback);
 
-  std::vector<PacketFeedback> packet_feedback_vector;
+  last_packet_feedback_vector_.clear();
   if (feedback.GetPacketStatusCount() == 0) {
     MS_WARN_DEV("empty transport feedback packet received");
-    return packet_feedback_vector;
+    return;
   }
-  packet_feedback_vector.reserve(feedback.GetPacketStatusCount());
+  last_packet_feedback_vector_.reserve(feedback.GetPacketStatusCount());
   {
+    // MS_NOTE: Iterate the packet results of the feedback (read into a reused
+    // buffer) instead of building a vector with the received packets. Not
+    // received packets after the last received one are ignored, as libwebrtc
+    // does.
+    feedback.GetPacketResults(packet_results_);
+
+    size_t num_results = packet_results_.size();
+    while (num_results > 0 && !packet_results_[num_results - 1].received)
+      --num_results;
+
     size_t failed_lookups = 0;
     int64_t offset_us = 0;
     int64_t timestamp_ms = 0;
-    uint16_t seq_num = feedback.GetBaseSequenceNumber();
-    for (const auto& packet : mediasoup_helpers::FeedbackRtpTransport::GetReceivedPackets(&feedback)) {
-      // Insert into the vector those unreceived packets which precede this
-      // iteration's received packet.
-      for (; seq_num != packet.sequence_number(); ++seq_num) {
-        PacketFeedback packet_feedback(PacketFeedback::kNotReceived, seq_num);
+    for (size_t i = 0; i < num_results; ++i) {
+      const auto& packet = packet_results_[i];
+
+      if (!packet.received) {
+        PacketFeedback packet_feedback(PacketFeedback::kNotReceived,
+                                       packet.sequenceNumber);
         // Note: Element not removed from history because it might be reported
         // as received by another feedback.
         if (!send_time_history_.GetFeedback(&packet_feedback, false))
           ++failed_lookups;
         if (packet_feedback.local_net_id == local_net_id_ &&
             packet_feedback.remote_net_id == remote_net_id_) {
-          packet_feedback_vector.push_back(packet_feedback);
+          last_packet_feedback_vector_.push_back(packet_feedback);
         }
+        continue;
       }
 
-      // Handle this iteration's received packet.
-      offset_us += packet.delta_us();
+      offset_us += mediasoup_helpers::FeedbackRtpTransport::GetDeltaUs(packet);
       timestamp_ms = current_offset_ms_ + (offset_us / 1000);
-      PacketFeedback packet_feedback(timestamp_ms, packet.sequence_number());
+      PacketFeedback packet_feedback(timestamp_ms, packet.sequenceNumber);
       if (!send_time_history_.GetFeedback(&packet_feedback, true))
         ++failed_lookups;
       if (packet_feedback.local_net_id == local_net_id_ &&
           packet_feedback.remote_net_id == remote_net_id_) {
-        packet_feedback_vector.push_back(packet_feedback);
+        last_packet_feedback_vector_.push_back(packet_feedback);
       }
-      ++seq_num;
     }
 
     if (failed_lookups > 0) {
@@ -241,7 +251,6 @@ std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
                   (failed_lookups > 1 ? "s" : ""));
     }
   }
-  return packet_feedback_vector;
 }
 
 std::vector<PacketFeedback>
@@ -36,9 +36,14 @@ class TransportFeedbackAdapter {
   absl::optional<SentPacket> ProcessSentPacket(
       const rtc::SentPacket& sent_packet);
 
-  absl::optional<TransportPacketsFeedback> ProcessTransportFeedback(
+  // MS_NOTE: The packet feedbacks are appended to the given |msg| (whose
+  // buffers are reused) so feedbacks received together can be passed to the
+  // network controller as a single update. Returns false if the feedback has
+  // nothing to report.
+  bool ProcessTransportFeedback(
       const RTC::RTCP::FeedbackRtpTransportPacket& feedback,
-      Timestamp feedback_time);
+      Timestamp feedback_time,
+      TransportPacketsFeedback* msg);
 
   std::vector<PacketFeedback> GetTransportFeedbackVector() const;
 
@@ -47,7 +52,9 @@ class TransportFeedbackAdapter {
  private:
   void OnTransportFeedback(const RTC::RTCP::FeedbackRtpTransportPacket& feedback);
 
-  std::vector<PacketFeedback> GetPacketFeedbackVector(
+  // MS_NOTE: Fills |last_packet_feedback_vector_| instead of returning a new
+  // vector.
+  void GetPacketFeedbackVector(
       const RTC::RTCP::FeedbackRtpTransportPacket& feedback,
       Timestamp feedback_time);
 
@@ -57,6 +64,8 @@ class TransportFeedbackAdapter {
   int64_t current_offset_ms_;
   int64_t last_timestamp_us_;
   std::vector<PacketFeedback> last_packet_feedback_vector_;
+  // MS_NOTE: Reused buffer for the packet results of every feedback.
+  std::vector<RTC::RTCP::FeedbackRtpTransportPacket::PacketResult> packet_results_;
   // MS_NOTE: local_net_id_ and remote_net_id_ are not set.
   uint16_t local_net_id_;
   uint16_t remote_net_id_;
@@ -85,6 +85,8 @@ class PacedSender {
 
   void OnPacketSent(size_t size);
   PacedPacketInfo GetPacingInfo();
+  // MS_NOTE: Used to drive the RTP packet pacing queue of mediasoup.
+  uint32_t GetPacingBitrateBps() const { return pacing_bitrate_kbps_ * 1000; }
 
  private:
   int64_t UpdateTimeAndGetElapsedMs(int64_t now_us);
@@ -17,6 +17,7 @@ namespace Channel
 		static void Emit(uint64_t targetId, const char* event);
 		static void Emit(const std::string& targetId, const char* event);
 		static void Emit(const std::string& targetId, const char* event, json& data);
+		// `data` must be already encoded in the channel format (JSON or MessagePack).
 		static void Emit(const std::string& targetId, const char* event, const std::string& data);
 
 	public:
@@ -22,6 +22,7 @@ namespace Channel
 			WORKER_CLOSE = 1,
 			WORKER_DUMP,
 			WORKER_GET_RESOURCE_USAGE,
+			WORKER_GET_LATENCY_STATS,
 			WORKER_UPDATE_SETTINGS,
 			WORKER_CREATE_WEBRTC_SERVER,
 			WORKER_CREATE_ROUTER,
@@ -29,6 +30,7 @@ namespace Channel
 			WEBRTC_SERVER_DUMP,
 			WORKER_CLOSE_ROUTER,
 			ROUTER_DUMP,
+			ROUTER_GET_CONSUMERS_STATS,
 			ROUTER_CREATE_WEBRTC_TRANSPORT,
 			ROUTER_CREATE_WEBRTC_TRANSPORT_WITH_SERVER,
 			ROUTER_CREATE_PLAIN_TRANSPORT,
@@ -78,6 +80,9 @@ namespace Channel
 			RTP_OBSERVER_REMOVE_PRODUCER
 		};
 
+	public:
+		static bool IsMsgpackMap(const char* data, size_t len);
+
 	private:
 		static absl::flat_hash_map<std::string, MethodId> string2MethodId;
 
@@ -87,8 +92,17 @@ namespace Channel
 
 		void Accept();
 		void Accept(json& data);
+		// `data` must be an object or array already encoded in the channel format
+		// (JSON or MessagePack).
+		void Accept(const std::string& data);
 		void Error(const char* reason = nullptr);
 		void TypeError(const char* reason = nullptr);
+		// The handler keeps the request to reply it later and becomes
+		// responsible for deleting it.
+		void Defer()
+		{
+			this->deferred = true;
+		}
 
 	public:
 		// Passed by argument.
@@ -100,6 +114,7 @@ namespace Channel
 		json data;
 		// Others.
 		bool replied{ false };
+		bool deferred{ false };
 	};
 } // namespace Channel
 
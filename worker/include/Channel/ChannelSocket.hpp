@@ -6,6 +6,7 @@
 #include "handles/UnixStreamSocket.hpp"
 #include <nlohmann/json.hpp>
 #include <string>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -87,6 +88,11 @@ namespace Channel
 		void Close();
 		void SetListener(Listener* listener);
 		void Send(json& jsonMessage);
+		// Sends the given JSON object (with less than 15 entries) with a "data"
+		// entry whose value is already encoded in the channel format.
+		void Send(json& jsonMessage, const std::string& data);
+		// `message` must be serialized JSON, so it cannot be used with the
+		// MessagePack channel format.
 		void Send(const std::string& message);
 		void SendLog(const char* message, uint32_t messageLen);
 		bool CallbackRead();
@@ -112,6 +118,8 @@ namespace Channel
 		ChannelWriteCtx channelWriteCtx{ nullptr };
 		uv_async_t* uvReadHandle{ nullptr };
 		uint8_t* writeBuffer{ nullptr };
+		// Reused for MessagePack encoding.
+		std::vector<uint8_t> msgpackBuffer;
 	};
 } // namespace Channel
 
@@ -5,6 +5,7 @@
 #include "Channel/ChannelSocket.hpp"
 #include "PayloadChannel/PayloadChannelSocket.hpp"
 #include <absl/container/flat_hash_map.h>
+#include <absl/strings/string_view.h>
 #include <nlohmann/json.hpp>
 #include <string>
 
@@ -22,7 +23,7 @@ public:
 	static PayloadChannel::PayloadChannelSocket::RequestHandler* GetPayloadChannelRequestHandler(
 	  const std::string& id);
 	static PayloadChannel::PayloadChannelSocket::NotificationHandler* GetPayloadChannelNotificationHandler(
-	  const std::string& id);
+	  absl::string_view id);
 
 private:
 	thread_local static absl::flat_hash_map<std::string, Channel::ChannelSocket::RequestHandler*>
@@ -17,16 +17,31 @@ public:
 	}
 	static uint64_t GetTimeMs()
 	{
-		return static_cast<uint64_t>(uv_hrtime() / 1000000u);
+		return static_cast<uint64_t>(DepLibUV::GetTimeNs() / 1000000u);
 	}
 	static uint64_t GetTimeUs()
 	{
-		return static_cast<uint64_t>(uv_hrtime() / 1000u);
+		return static_cast<uint64_t>(DepLibUV::GetTimeNs() / 1000u);
 	}
 	static uint64_t GetTimeNs()
 	{
+#ifdef MS_VIRTUAL_CLOCK
+		if (DepLibUV::virtualClockEnabled)
+			return DepLibUV::virtualTimeNs;
+#endif
+
 		return uv_hrtime();
 	}
+	// Time of the loop in milliseconds, as used by libuv timers.
+	static uint64_t GetLoopTimeMs()
+	{
+#ifdef MS_VIRTUAL_CLOCK
+		if (DepLibUV::virtualClockEnabled)
+			return DepLibUV::virtualTimeNs / 1000000u;
+#endif
+
+		return uv_now(DepLibUV::loop);
+	}
 	// Used within libwebrtc dependency which uses int64_t values for time
 	// representation.
 	static int64_t GetTimeMsInt64()
@@ -40,8 +55,25 @@ public:
 		return static_cast<int64_t>(DepLibUV::GetTimeUs());
 	}
 
+#ifdef MS_VIRTUAL_CLOCK
+	// Replace the system clock and the loop time with a clock that just moves
+	// when told to, so time dependent code can be run in simulated time. It
+	// starts after the current time so already scheduled timers are not in the
+	// future.
+	static void EnableVirtualClock();
+	static void DisableVirtualClock();
+	static void AdvanceVirtualClock(uint64_t ns)
+	{
+		DepLibUV::virtualTimeNs += ns;
+	}
+#endif
+
 private:
 	thread_local static uv_loop_t* loop;
+#ifdef MS_VIRTUAL_CLOCK
+	thread_local static bool virtualClockEnabled;
+	thread_local static uint64_t virtualTimeNs;
+#endif
 };
 
 #endif
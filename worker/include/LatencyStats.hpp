@@ -0,0 +1,93 @@
+#ifndef MS_LATENCY_STATS_HPP
+#define MS_LATENCY_STATS_HPP
+
+#include "common.hpp"
+#include "DepLibUV.hpp"
+#include "Utils.hpp"
+#include <nlohmann/json.hpp>
+#include <uv.h>
+#include <vector>
+
+using json = nlohmann::json;
+
+// Latency histograms of the main stages of the media path and of the libuv
+// loop. Disabled by default. When disabled, instrumented code just checks a
+// flag.
+class LatencyStats
+{
+public:
+	enum class Stage : uint8_t
+	{
+		// Processing of a received UDP datagram (everything it triggers).
+		UDP_RECV = 0,
+		SRTP_DECRYPT,
+		// Producer::ReceiveRtpPacket() (includes the Router fanout).
+		PRODUCER_RECEIVE,
+		// Delivery of a RTP packet to all the Consumers of a Producer.
+		ROUTER_FANOUT,
+		// Consumer::SendRtpPacket() (includes encryption and socket send).
+		CONSUMER_SEND,
+		SRTP_ENCRYPT,
+		// Socket send of a datagram.
+		SOCKET_SEND,
+		// Time the loop is busy in each iteration (polling time excluded).
+		LOOP_ITERATION,
+		// Delay of timers firing after their scheduled time.
+		TIMER_LAG
+	};
+
+	static constexpr size_t StageCount{ 9u };
+
+public:
+	// Records the time elapsed during its lifetime into the given stage,
+	// divided among `count` items (packets) if given.
+	class Scope
+	{
+	public:
+		explicit Scope(Stage stage, size_t count = 1u)
+		  : stage(stage), count(count), startNs(LatencyStats::enabled ? DepLibUV::GetTimeNs() : 0u)
+		{
+		}
+		Scope& operator=(const Scope&) = delete;
+		Scope(const Scope&)            = delete;
+		~Scope()
+		{
+			if (this->startNs != 0u && this->count != 0u)
+			{
+				LatencyStats::Record(
+				  this->stage, (DepLibUV::GetTimeNs() - this->startNs) / this->count, this->count);
+			}
+		}
+
+	private:
+		Stage stage;
+		size_t count;
+		uint64_t startNs;
+	};
+
+public:
+	static bool IsEnabled()
+	{
+		return LatencyStats::enabled;
+	}
+	static void SetEnabled(bool enabled);
+	static void Record(Stage stage, uint64_t valueNs, uint64_t count = 1u)
+	{
+		LatencyStats::histograms[static_cast<size_t>(stage)].Record(valueNs, count);
+	}
+	static void Reset();
+	static void FillJson(json& jsonObject);
+
+	/* Callbacks fired by UV events. */
+public:
+	static void OnUvCheck();
+
+private:
+	thread_local static bool enabled;
+	thread_local static std::vector<Utils::LatencyHistogram> histograms;
+	thread_local static uv_check_t* uvCheckHandle;
+	thread_local static uint64_t lastCheckNs;
+	thread_local static uint64_t lastIdleNs;
+};
+
+#endif
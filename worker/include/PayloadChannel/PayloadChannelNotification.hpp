@@ -3,6 +3,7 @@
 
 #include "common.hpp"
 #include <absl/container/flat_hash_map.h>
+#include <absl/strings/string_view.h>
 #include <string>
 
 namespace PayloadChannel
@@ -22,22 +23,42 @@ namespace PayloadChannel
 
 	private:
 		static absl::flat_hash_map<std::string, EventId> string2EventId;
+		static absl::flat_hash_map<uint8_t, std::pair<EventId, std::string>> id2Event;
 
 	public:
+		PayloadChannelNotification() = default;
 		PayloadChannelNotification(const char* msg, size_t msgLen);
+		PayloadChannelNotification(const PayloadChannelNotification&) = delete;
+		PayloadChannelNotification& operator=(const PayloadChannelNotification&) = delete;
 		virtual ~PayloadChannelNotification();
 
 	public:
+		// Fills the notification from a binary frame of the PayloadChannelRing.
+		// The handler id and payload point into the frame, so they are only
+		// valid until it's popped.
+		void Fill(
+		  uint8_t eventId,
+		  const char* handlerId,
+		  size_t handlerIdLen,
+		  uint32_t ppid,
+		  const uint8_t* payload,
+		  size_t payloadLen);
 		void SetPayload(const uint8_t* payload, size_t payloadLen);
 
 	public:
 		// Passed by argument.
 		std::string event;
-		EventId eventId;
-		std::string handlerId;
+		EventId eventId{ EventId::TRANSPORT_SEND_RTCP };
+		absl::string_view handlerId;
 		std::string data;
+		// Only for DATA_PRODUCER_SEND.
+		uint32_t ppid{ 0u };
 		const uint8_t* payload{ nullptr };
 		size_t payloadLen{ 0u };
+
+	private:
+		// Memory of `handlerId` if not given by a ring frame.
+		std::string handlerIdStorage;
 	};
 } // namespace PayloadChannel
 
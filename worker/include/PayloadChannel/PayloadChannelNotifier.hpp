@@ -16,6 +16,14 @@ namespace PayloadChannel
 		static void ClassInit(PayloadChannel::PayloadChannelSocket* payloadChannel);
 		static void Emit(
 		  const std::string& targetId, const char* event, const uint8_t* payload, size_t payloadLen);
+		// The payload is given in two parts which are notified as a single one.
+		static void Emit(
+		  const std::string& targetId,
+		  const char* event,
+		  const uint8_t* payload1,
+		  size_t payload1Len,
+		  const uint8_t* payload2,
+		  size_t payload2Len);
 		static void Emit(
 		  const std::string& targetId,
 		  const char* event,
@@ -0,0 +1,93 @@
+#ifndef MS_PAYLOAD_CHANNEL_RING_HPP
+#define MS_PAYLOAD_CHANNEL_RING_HPP
+
+#include "common.hpp"
+#include <atomic>
+
+namespace PayloadChannel
+{
+	// Lock-free single producer single consumer ring of binary framed
+	// notifications (RTP, RTCP and data messages). When the worker runs as a
+	// library the host thread pushes them and the worker thread reads them, so
+	// the media path does not go through JSON and string framing.
+	//
+	// Each frame starts with a FrameHeader followed by the handler id and the
+	// payload, and is padded to FrameAlignment bytes. A frame never wraps: if it
+	// does not fit before the end of the buffer, the remaining bytes are skipped
+	// with a frame with `eventId` 0.
+	class PayloadChannelRing
+	{
+	public:
+		// Default size (bytes) of the ring.
+		static constexpr size_t DefaultCapacity{ 4194304u };
+		static constexpr size_t HandlerIdMaxLen{ 255u };
+
+	public:
+		struct Frame
+		{
+			uint8_t eventId;
+			const char* handlerId;
+			size_t handlerIdLen;
+			uint32_t ppid;
+			const uint8_t* payload;
+			size_t payloadLen;
+		};
+
+	private:
+		struct FrameHeader
+		{
+			// Total length of the frame (header and padding included).
+			uint32_t frameLen;
+			uint32_t payloadLen;
+			uint32_t ppid;
+			uint8_t eventId;
+			uint8_t handlerIdLen;
+			uint16_t reserved;
+		};
+
+		// Same as sizeof(FrameHeader), so a skip frame always fits at the end.
+		static constexpr size_t FrameAlignment{ 16u };
+
+	public:
+		explicit PayloadChannelRing(size_t capacity = DefaultCapacity);
+		~PayloadChannelRing();
+
+		/* Producer side. */
+	public:
+		// Returns false if the frame does not fit (ring full or frame too big).
+		bool Push(
+		  uint8_t eventId,
+		  const char* handlerId,
+		  size_t handlerIdLen,
+		  uint32_t ppid,
+		  const uint8_t* payload,
+		  size_t payloadLen);
+
+		/* Consumer side. */
+	public:
+		// Fills the first frame, valid until Pop() is called. Returns false if
+		// the ring is empty.
+		bool Front(Frame& frame);
+		void Pop();
+
+	private:
+		uint8_t* buffer{ nullptr };
+		size_t capacity{ 0u };
+		// Padding so positions written by different threads do not share a
+		// cache line (alignas() is not honored by new in C++11).
+		uint8_t padding1[64];
+		// Position of the next frame to read. Just written by the consumer.
+		std::atomic<uint64_t> readPos{ 0u };
+		// Length of the frame returned by Front().
+		uint32_t frontFrameLen{ 0u };
+		uint8_t padding2[64];
+		// Position of the next frame to write. Just written by the producer.
+		std::atomic<uint64_t> writePos{ 0u };
+		// Last read position seen by the producer, to not load `readPos` on
+		// every Push().
+		uint64_t cachedReadPos{ 0u };
+		uint8_t padding3[64];
+	};
+} // namespace PayloadChannel
+
+#endif
@@ -4,6 +4,7 @@
 #include "common.hpp"
 #include "PayloadChannel/PayloadChannelNotification.hpp"
 #include "PayloadChannel/PayloadChannelRequest.hpp"
+#include "PayloadChannel/PayloadChannelRing.hpp"
 #include "handles/UnixStreamSocket.hpp"
 #include <nlohmann/json.hpp>
 #include <string>
@@ -98,9 +99,26 @@ namespace PayloadChannel
 		void SetListener(Listener* listener);
 		void Send(json& jsonMessage, const uint8_t* payload, size_t payloadLen);
 		void Send(const std::string& message, const uint8_t* payload, size_t payloadLen);
+		void Send(
+		  const std::string& message,
+		  const uint8_t* payload1,
+		  size_t payload1Len,
+		  const uint8_t* payload2,
+		  size_t payload2Len);
 		void Send(json& jsonMessage);
 		void Send(const std::string& message);
 		bool CallbackRead();
+		// Called by the host thread when running as a library. Returns false if
+		// the frame does not fit in the ring so the host must send it through the
+		// regular channel.
+		bool PushToRing(
+		  uint8_t eventId,
+		  const char* handlerId,
+		  size_t handlerIdLen,
+		  uint32_t ppid,
+		  const uint8_t* payload,
+		  size_t payloadLen);
+		void ReadRing();
 
 	private:
 		void SendImpl(const uint8_t* message, uint32_t messageLen);
@@ -126,6 +144,8 @@ namespace PayloadChannel
 		PayloadChannel::PayloadChannelNotification* ongoingNotification{ nullptr };
 		PayloadChannel::PayloadChannelRequest* ongoingRequest{ nullptr };
 		uv_async_t* uvReadHandle{ nullptr };
+		PayloadChannel::PayloadChannelRing* ring{ nullptr };
+		PayloadChannel::PayloadChannelNotification* ringNotification{ nullptr };
 		uint8_t* writeBuffer{ nullptr };
 	};
 } // namespace PayloadChannel
@@ -0,0 +1,99 @@
+#ifndef MS_RTC_BITRATE_ALLOCATOR_HPP
+#define MS_RTC_BITRATE_ALLOCATOR_HPP
+
+#include "common.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <vector>
+
+namespace RTC
+{
+	// Distributes the available outgoing bitrate of a Transport among its
+	// participants (Consumers) by letting them increase their layers one by one,
+	// first one layer each and then as many layers per round as their bitrate
+	// priority, starting with the highest priority.
+	//
+	// Participants are kept in buckets by bitrate priority. Only participants
+	// whose priority changed move between buckets, so a regular distribution
+	// does not allocate memory. Participants with the same priority are given
+	// bitrate in the order in which they were added.
+	class BitrateAllocator
+	{
+	public:
+		class Participant
+		{
+		public:
+			virtual ~Participant() = default;
+
+		public:
+			// 0 means that the participant does not want bitrate.
+			virtual uint8_t GetBitratePriority() const = 0;
+			// Moves the provisional layers to the next layer that fits into the
+			// given bitrate (if any) and returns the bitrate it requires.
+			virtual uint32_t IncreaseLayer(uint32_t bitrate, bool considerLoss) = 0;
+			// Applies the provisional layers.
+			virtual void ApplyLayers() = 0;
+		};
+
+	private:
+		struct Entry
+		{
+			uint64_t order{ 0u };
+			uint8_t priority{ 0u };
+		};
+
+		struct Item
+		{
+			Item(Participant* participant, uint64_t order) : participant(participant), order(order)
+			{
+			}
+
+			Participant* participant{ nullptr };
+			uint64_t order{ 0u };
+			// Whether the participant didn't take bitrate in the current distribution,
+			// so it won't take it in later rounds either.
+			bool exhausted{ false };
+		};
+
+		struct Bucket
+		{
+			explicit Bucket(uint8_t priority) : priority(priority)
+			{
+			}
+
+			uint8_t priority{ 0u };
+			std::vector<Item> items;
+		};
+
+	public:
+		void AddParticipant(Participant* participant);
+		void RemoveParticipant(Participant* participant);
+		void Clear();
+		// Moves the participants whose bitrate priority changed into their new
+		// bucket. Must be called before Distribute().
+		void UpdatePriorities();
+		bool HasPrioritizedParticipants() const
+		{
+			return this->numPrioritizedParticipants != 0u;
+		}
+		size_t GetSize() const
+		{
+			return this->mapParticipantEntry.size();
+		}
+		// Returns the bitrate not used by any participant. Participants are told
+		// to apply their layers once done.
+		uint32_t Distribute(uint32_t availableBitrate, bool considerLoss);
+
+	private:
+		void AddToBucket(Participant* participant, uint8_t priority, uint64_t order);
+		void RemoveFromBucket(Participant* participant, uint8_t priority);
+
+	private:
+		absl::flat_hash_map<Participant*, Entry> mapParticipantEntry;
+		// Sorted by descending priority. Empty buckets are kept for later reuse.
+		std::vector<Bucket> buckets;
+		size_t numPrioritizedParticipants{ 0u };
+		uint64_t nextOrder{ 0u };
+	};
+} // namespace RTC
+
+#endif
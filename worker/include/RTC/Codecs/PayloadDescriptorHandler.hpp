@@ -98,6 +98,11 @@ namespace RTC
 
 		class PayloadDescriptorHandler
 		{
+		public:
+			// Max number of bytes at the start of the payload that Process() may
+			// rewrite.
+			static constexpr size_t MaxProcessedLength{ 8u };
+
 		public:
 			virtual ~PayloadDescriptorHandler() = default;
 
@@ -41,6 +41,10 @@ namespace RTC
 		/* Methods inherited from PayloadChannel::PayloadChannelSocket::NotificationHandler. */
 	public:
 		void HandleNotification(PayloadChannel::PayloadChannelNotification* notification) override;
+
+	private:
+		// Others.
+		bool enableRtcpReports{ false };
 	};
 } // namespace RTC
 
@@ -5,10 +5,6 @@
 #include "RTC/RtpPacket.hpp"
 #include "RTC/SeqManager.hpp"
 #include "handles/Timer.hpp"
-#include <absl/container/btree_map.h>
-#include <absl/container/btree_set.h>
-#include <map>
-#include <set>
 #include <vector>
 
 namespace RTC
@@ -29,17 +25,78 @@ namespace RTC
 	private:
 		struct NackInfo
 		{
-			NackInfo() = default;
-			explicit NackInfo(uint64_t createdAtMs, uint16_t seq, uint16_t sendAtSeq)
-			  : createdAtMs(createdAtMs), seq(seq), sendAtSeq(sendAtSeq)
+			// Times are truncated to 32 bits, just differences among them are used.
+			uint32_t createdAtMs{ 0u };
+			uint32_t sentAtMs{ 0u };
+			uint8_t retries{ 0u };
+		};
+
+		// Set of sequence numbers within a window of consecutive ones, stored as
+		// a bitmap in a ring indexed by sequence number. The ring grows (in
+		// powers of two) with the window, up to MaxCapacity sequence numbers.
+		class SeqBitmap
+		{
+		public:
+			static constexpr size_t MaxCapacity{ 16384u };
+
+		public:
+			size_t GetSize() const
 			{
+				return this->size;
 			}
+			bool IsEmpty() const
+			{
+				return this->size == 0u;
+			}
+			size_t GetCapacity() const
+			{
+				return this->words.size() * 64u;
+			}
+			bool Contains(uint16_t seq) const
+			{
+				if (this->size == 0u)
+					return false;
 
-			uint64_t createdAtMs{ 0u };
-			uint16_t seq{ 0u };
-			uint16_t sendAtSeq{ 0u };
-			uint64_t sentAtMs{ 0u };
-			uint8_t retries{ 0u };
+				auto offset = static_cast<uint16_t>(seq - this->start);
+
+				if (offset >= static_cast<uint16_t>(this->end - this->start))
+					return false;
+
+				size_t idx = seq & (GetCapacity() - 1);
+
+				return (this->words[idx >> 6] & (uint64_t{ 1u } << (idx & 63u))) != 0u;
+			}
+			// Returns false if already present.
+			bool Insert(uint16_t seq);
+			void Erase(uint16_t seq);
+			// Erases the sequence numbers lower than the given one.
+			void EraseLowerThan(uint16_t seq);
+			void Clear();
+			// Sets `seq` to the lowest sequence number. Returns false if empty.
+			bool GetFirst(uint16_t& seq) const
+			{
+				return Find(this->start, seq);
+			}
+			// Sets `seq` to the lowest sequence number higher than it. Returns false
+			// if there is none.
+			bool GetNext(uint16_t& seq) const
+			{
+				return Find(static_cast<uint16_t>(seq + 1u), seq);
+			}
+
+		private:
+			// Erases the first `count` sequence numbers of the window.
+			void EraseFirst(size_t count);
+			bool Find(uint16_t from, uint16_t& seq) const;
+			void ClearRange(uint16_t from, size_t count);
+			void Grow(size_t span);
+
+		private:
+			std::vector<uint64_t> words;
+			// The window is [start, end).
+			uint16_t start{ 0u };
+			uint16_t end{ 0u };
+			size_t size{ 0u };
 		};
 
 		enum class NackFilter
@@ -55,7 +112,7 @@ namespace RTC
 		bool ReceivePacket(RTC::RtpPacket* packet, bool isRecovered);
 		size_t GetNackListLength() const
 		{
-			return this->nackList.size();
+			return this->nackList.GetSize();
 		}
 		void UpdateRtt(uint32_t rtt)
 		{
@@ -65,6 +122,11 @@ namespace RTC
 
 	private:
 		void AddPacketsToNackList(uint16_t seqStart, uint16_t seqEnd);
+		NackInfo& AddNackItem(uint16_t seq);
+		NackInfo& GetNackItem(uint16_t seq)
+		{
+			return this->nackItems[seq & (this->nackList.GetCapacity() - 1)];
+		}
 		bool RemoveNackItemsUntilKeyFrame();
 		std::vector<uint16_t> GetNackBatch(NackFilter filter);
 		void MayRunTimer() const;
@@ -80,9 +142,11 @@ namespace RTC
 		// Allocated by this.
 		Timer* timer{ nullptr };
 		// Others.
-		absl::btree_map<uint16_t, NackInfo, RTC::SeqManager<uint16_t>::SeqLowerThan> nackList;
-		absl::btree_set<uint16_t, RTC::SeqManager<uint16_t>::SeqLowerThan> keyFrameList;
-		absl::btree_set<uint16_t, RTC::SeqManager<uint16_t>::SeqLowerThan> recoveredList;
+		SeqBitmap nackList;
+		// NACK items, indexed by sequence number as the nackList ring.
+		std::vector<NackInfo> nackItems;
+		SeqBitmap keyFrameList;
+		SeqBitmap recoveredList;
 		bool started{ false };
 		uint16_t lastSeq{ 0u }; // Seq number of last valid packet.
 		uint32_t rtt{ 0u };     // Round trip time (ms).
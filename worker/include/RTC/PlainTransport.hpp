@@ -65,8 +65,8 @@ namespace RTC
 
 		/* Pure virtual methods inherited from RTC::UdpSocket::Listener. */
 	public:
-		void OnUdpSocketPacketReceived(
-		  RTC::UdpSocket* socket, const uint8_t* data, size_t len, const struct sockaddr* remoteAddr) override;
+		void OnUdpSocketPacketsReceived(
+		  RTC::UdpSocket* socket, const RTC::UdpSocket::RecvDatagram* datagrams, size_t count) override;
 
 	private:
 		// Allocated by this.
@@ -29,6 +29,12 @@ namespace RTC
 		{
 			return reinterpret_cast<uv_udp_t*>(Bind(Transport::UDP, ip, port));
 		}
+		// Binds with SO_REUSEPORT and steers each remote tuple always to the same
+		// socket of the group of given number of sockets.
+		static uv_udp_t* BindUdp(std::string& ip, uint16_t port, uint16_t numReusePortShards)
+		{
+			return reinterpret_cast<uv_udp_t*>(Bind(Transport::UDP, ip, port, numReusePortShards));
+		}
 		static uv_tcp_t* BindTcp(std::string& ip)
 		{
 			return reinterpret_cast<uv_tcp_t*>(Bind(Transport::TCP, ip));
@@ -49,7 +55,9 @@ namespace RTC
 
 	private:
 		static uv_handle_t* Bind(Transport transport, std::string& ip);
-		static uv_handle_t* Bind(Transport transport, std::string& ip, uint16_t port);
+		static uv_handle_t* Bind(
+		  Transport transport, std::string& ip, uint16_t port, uint16_t numReusePortShards = 0u);
+		static void SetReusePortShardSteering(uv_udp_t* uvHandle, int family, uint16_t numShards);
 		static void Unbind(Transport transport, std::string& ip, uint16_t port);
 		static std::vector<bool>& GetPorts(Transport transport, const std::string& ip);
 
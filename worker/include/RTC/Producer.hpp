@@ -81,6 +81,23 @@ namespace RTC
 			RETRANSMISSION
 		};
 
+	private:
+		// Header extension element written into mangled RTP packets (in One-Byte
+		// format and in this order).
+		struct HeaderExtensionRewrite
+		{
+			HeaderExtensionRewrite(uint8_t id, uint8_t recvId, uint8_t len)
+			  : id(id), recvId(recvId), len(len){};
+
+			// mediasoup id.
+			uint8_t id{ 0u };
+			// Id of the extension in received packets (which value is proxied) or 0
+			// if the value is written by the Producer.
+			uint8_t recvId{ 0u };
+			// Length of the value written by the Producer.
+			uint8_t len{ 0u };
+		};
+
 	private:
 		struct TraceEventTypes
 		{
@@ -146,7 +163,9 @@ namespace RTC
 		  RTC::RtpPacket* packet, const RTC::RtpCodecParameters& mediaCodec, size_t encodingIdx);
 		void NotifyNewRtpStream(RTC::RtpStreamRecv* rtpStream);
 		void PreProcessRtpPacket(RTC::RtpPacket* packet);
+		void CompileHeaderExtensionsRewritePlan();
 		bool MangleRtpPacket(RTC::RtpPacket* packet, RTC::RtpStreamRecv* rtpStream) const;
+		bool MangleHeaderExtensionsInPlace(RTC::RtpPacket* packet) const;
 		void PostProcessRtpPacket(RTC::RtpPacket* packet);
 		void EmitScore() const;
 		void EmitTraceEventRtpAndKeyFrameTypes(RTC::RtpPacket* packet, bool isRtx = false) const;
@@ -187,6 +206,7 @@ namespace RTC
 		absl::flat_hash_map<RTC::RtpStreamRecv*, uint32_t> mapRtpStreamMappedSsrc;
 		absl::flat_hash_map<uint32_t, uint32_t> mapMappedSsrcSsrc;
 		struct RTC::RtpHeaderExtensionIds rtpHeaderExtensionIds;
+		std::vector<HeaderExtensionRewrite> headerExtensionsRewritePlan;
 		bool paused{ false };
 		RTC::RtpPacket* currentRtpPacket{ nullptr };
 		// Timestamp when last RTCP was sent.
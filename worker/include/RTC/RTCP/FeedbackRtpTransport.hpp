@@ -196,6 +196,14 @@ namespace RTC
 		public:
 			static FeedbackRtpTransportPacket* Parse(const uint8_t* data, size_t len);
 
+		private:
+			static bool AddStatusDeltas(
+			  const std::vector<Status>& statuses,
+			  const uint8_t* data,
+			  size_t len,
+			  std::vector<int16_t>& deltas,
+			  size_t& offset);
+
 		private:
 			static absl::flat_hash_map<Status, std::string> status2String;
 
@@ -257,7 +265,15 @@ namespace RTC
 			{
 				return this->latestTimestamp;
 			}
+			// Number of packets reported as received.
+			uint16_t GetReceivedPacketCount() const
+			{
+				return static_cast<uint16_t>(this->deltas.size());
+			}
 			std::vector<struct PacketResult> GetPacketResults() const;
+			// Same as above but filling the given vector, so its buffer can be reused
+			// for every received packet.
+			void GetPacketResults(std::vector<struct PacketResult>& packetResults) const;
 			uint8_t GetPacketFractionLost() const;
 
 			/* Pure virtual methods inherited from Packet. */
@@ -85,6 +85,70 @@ namespace RTC
 		uint64_t lastTime{ 0u };
 	};
 
+	// Rate calculator of N layers sharing the same time window, so a single item
+	// rollover updates all of them and old data is removed from all of them at
+	// once. Each window item holds the counts of all layers in a contiguous
+	// array, and rates of consecutive layers are computed in a single pass.
+	class LayersRateCalculator
+	{
+	public:
+		LayersRateCalculator(
+		  size_t layers,
+		  size_t windowSizeMs  = RateCalculator::DefaultWindowSize,
+		  float scale          = RateCalculator::DefaultBpsScale,
+		  uint16_t windowItems = RateCalculator::DefaultWindowItems)
+		  : layers(std::max(layers, static_cast<size_t>(1))), windowSizeMs(windowSizeMs), scale(scale),
+		    windowItems(windowItems)
+		{
+			this->itemSizeMs = std::max(windowSizeMs / windowItems, static_cast<size_t>(1));
+			this->itemTimes.resize(windowItems);
+			this->itemCounts.resize(windowItems * this->layers);
+			this->totalCounts.resize(this->layers);
+		}
+		void Update(size_t layer, size_t size, uint64_t nowMs);
+		// Rate of the given layer.
+		uint32_t GetRate(uint64_t nowMs, size_t layer)
+		{
+			return GetRate(nowMs, layer, layer + 1);
+		}
+		// Aggregated rate of layers in range [firstLayer, lastLayer).
+		uint32_t GetRate(uint64_t nowMs, size_t firstLayer, size_t lastLayer);
+		size_t GetLayers() const
+		{
+			return this->layers;
+		}
+
+	private:
+		void RemoveOldData(uint64_t nowMs);
+		void Reset();
+
+	private:
+		// Number of layers.
+		size_t layers{ 1u };
+		// Window Size (in milliseconds).
+		size_t windowSizeMs{ RateCalculator::DefaultWindowSize };
+		// Scale in which the rate is represented.
+		float scale{ RateCalculator::DefaultBpsScale };
+		// Window Size (number of items).
+		uint16_t windowItems{ RateCalculator::DefaultWindowItems };
+		// Item Size (in milliseconds), calculated as: windowSizeMs / windowItems.
+		size_t itemSizeMs{ 0u };
+		// Start time of each item in the time window.
+		std::vector<uint64_t> itemTimes;
+		// Count of each layer in each item (item * layers + layer).
+		std::vector<uint32_t> itemCounts;
+		// Total count of each layer in the time window.
+		std::vector<size_t> totalCounts;
+		// Time (in milliseconds) for last item in the time window.
+		uint64_t newestItemStartTime{ 0u };
+		// Index for the last item in the time window.
+		int32_t newestItemIndex{ -1 };
+		// Time (in milliseconds) for oldest item in the time window.
+		uint64_t oldestItemStartTime{ 0u };
+		// Index for the oldest item in the time window.
+		int32_t oldestItemIndex{ -1 };
+	};
+
 	class RtpDataCounter
 	{
 	public:
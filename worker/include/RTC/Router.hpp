@@ -11,13 +11,17 @@
 #include "RTC/Producer.hpp"
 #include "RTC/RtpObserver.hpp"
 #include "RTC/RtpPacket.hpp"
+#include "RTC/RtpPacketHistory.hpp"
 #include "RTC/RtpStream.hpp"
 #include "RTC/Transport.hpp"
 #include "RTC/WebRtcServer.hpp"
+#include "handles/Timer.hpp"
 #include <absl/container/flat_hash_map.h>
 #include <nlohmann/json.hpp>
+#include <deque>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -25,8 +29,23 @@ namespace RTC
 {
 	class Router : public RTC::Transport::Listener,
 	               public RTC::RtpObserver::Listener,
-	               public Channel::ChannelSocket::RequestHandler
+	               public Channel::ChannelSocket::RequestHandler,
+	               public Timer::Listener
 	{
+	private:
+		// Pending "router.getConsumersStats" request. Stats are collected in
+		// bounded time slices so the loop is not blocked with many Consumers.
+		struct ConsumersStatsJob
+		{
+			Channel::ChannelRequest* request{ nullptr };
+			// Consumers when the request was received. Closed ones are skipped.
+			std::vector<RTC::Consumer*> consumers;
+			size_t nextIdx{ 0u };
+			// Object with an entry per Consumer id, encoded in the channel format.
+			std::string data;
+			size_t numEntries{ 0u };
+		};
+
 	public:
 		class Listener
 		{
@@ -39,7 +58,7 @@ namespace RTC
 		};
 
 	public:
-		explicit Router(const std::string& id, Listener* listener);
+		explicit Router(const std::string& id, Listener* listener, json& data);
 		virtual ~Router();
 
 	public:
@@ -54,6 +73,7 @@ namespace RTC
 		RTC::Transport* GetTransportFromData(json& data) const;
 		void SetNewRtpObserverIdFromData(json& data, std::string& rtpObserverId) const;
 		RTC::RtpObserver* GetRtpObserverFromData(json& data) const;
+		void CollectConsumersStats();
 
 		/* Pure virtual methods inherited from RTC::Transport::Listener. */
 	public:
@@ -108,6 +128,10 @@ namespace RTC
 		void OnRtpObserverAddProducer(RTC::RtpObserver* rtpObserver, RTC::Producer* producer) override;
 		void OnRtpObserverRemoveProducer(RTC::RtpObserver* rtpObserver, RTC::Producer* producer) override;
 
+		/* Pure virtual methods inherited from Timer::Listener. */
+	public:
+		void OnTimer(Timer* timer) override;
+
 	public:
 		// Passed by argument.
 		const std::string id;
@@ -117,6 +141,8 @@ namespace RTC
 		// Allocated by this.
 		absl::flat_hash_map<std::string, RTC::Transport*> mapTransports;
 		absl::flat_hash_map<std::string, RTC::RtpObserver*> mapRtpObservers;
+		absl::flat_hash_map<RTC::Producer*, RTC::RtpPacketHistory*> mapProducerRtpPacketHistory;
+		Timer* consumersStatsTimer{ nullptr };
 		// Others.
 		absl::flat_hash_map<RTC::Producer*, absl::flat_hash_set<RTC::Consumer*>> mapProducerConsumers;
 		absl::flat_hash_map<RTC::Consumer*, RTC::Producer*> mapConsumerProducer;
@@ -126,6 +152,9 @@ namespace RTC
 		  mapDataProducerDataConsumers;
 		absl::flat_hash_map<RTC::DataConsumer*, RTC::DataProducer*> mapDataConsumerDataProducer;
 		absl::flat_hash_map<std::string, RTC::DataProducer*> mapDataProducers;
+		// Whether all Consumers of a Producer share a packet history.
+		bool sharedRtpPacketHistory{ false };
+		std::deque<ConsumersStatsJob> consumersStatsJobs;
 	};
 } // namespace RTC
 
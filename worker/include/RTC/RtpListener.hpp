@@ -4,9 +4,10 @@
 #include "common.hpp"
 #include "RTC/Producer.hpp"
 #include "RTC/RtpPacket.hpp"
+#include <absl/container/flat_hash_map.h>
 #include <nlohmann/json.hpp>
+#include <cstring> // std::memcpy()
 #include <string>
-#include <unordered_map>
 
 using json = nlohmann::json;
 
@@ -14,6 +15,42 @@ namespace RTC
 {
 	class RtpListener
 	{
+	public:
+		// MID or RID value stored in integers, so it's hashed and compared without
+		// building a std::string from the RTP header extension value.
+		struct Key
+		{
+			// Maximum length of a One-Byte header extension value.
+			static constexpr size_t MaxLength{ 16u };
+
+			// `len` must not be greater than MaxLength.
+			Key(const uint8_t* value, size_t len) : length(static_cast<uint8_t>(len))
+			{
+				std::memcpy(this->data, value, len);
+			}
+
+			bool operator==(const Key& other) const
+			{
+				return (
+				  this->data[0] == other.data[0] && this->data[1] == other.data[1] &&
+				  this->length == other.length);
+			}
+
+			std::string ToString() const
+			{
+				return std::string(reinterpret_cast<const char*>(this->data), this->length);
+			}
+
+			template<typename H>
+			friend H AbslHashValue(H h, const Key& key)
+			{
+				return H::combine(std::move(h), key.data[0], key.data[1], key.length);
+			}
+
+			uint64_t data[2]{ 0u, 0u };
+			uint8_t length{ 0u };
+		};
+
 	public:
 		void FillJson(json& jsonObject) const;
 		void AddProducer(RTC::Producer* producer);
@@ -23,11 +60,11 @@ namespace RTC
 
 	public:
 		// Table of SSRC / Producer pairs.
-		std::unordered_map<uint32_t, RTC::Producer*> ssrcTable;
+		absl::flat_hash_map<uint32_t, RTC::Producer*> ssrcTable;
 		//  Table of MID / Producer pairs.
-		std::unordered_map<std::string, RTC::Producer*> midTable;
+		absl::flat_hash_map<Key, RTC::Producer*> midTable;
 		//  Table of RID / Producer pairs.
-		std::unordered_map<std::string, RTC::Producer*> ridTable;
+		absl::flat_hash_map<Key, RTC::Producer*> ridTable;
 	};
 } // namespace RTC
 
@@ -0,0 +1,134 @@
+#ifndef MS_RTC_RTP_PACING_QUEUE_HPP
+#define MS_RTC_RTP_PACING_QUEUE_HPP
+
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <deque>
+
+namespace RTC
+{
+	class Consumer;
+
+	// Priority queue of RTP packets waiting to be sent by the pacer of a
+	// Transport. Packets are dequeued by priority (and in order within the same
+	// priority). Packets that have been queued for longer than the max queue
+	// time of their priority are dropped or sent right away (ignoring the
+	// pacing budget), depending on the drop policy of their priority.
+	class RtpPacingQueue
+	{
+	public:
+		enum class Priority : uint8_t
+		{
+			AUDIO = 0,
+			RETRANSMISSION,
+			VIDEO_BASE_LAYER,
+			VIDEO_UPPER_LAYER
+		};
+
+		static constexpr size_t NumPriorities{ 4u };
+
+		enum class DropPolicy : uint8_t
+		{
+			// Drop the packet (video receivers will ask for it via NACK).
+			DROP = 0,
+			// Send the packet ignoring the pacing budget.
+			SEND
+		};
+
+	public:
+		struct Item
+		{
+			Item(
+			  RTC::Consumer* consumer,
+			  RTC::SharedRtpPacket packet,
+			  Priority priority,
+			  bool retransmission,
+			  uint64_t enqueuedAtMs)
+			  : consumer(consumer), packet(std::move(packet)), priority(priority),
+			    retransmission(retransmission), enqueuedAtMs(enqueuedAtMs)
+			{
+			}
+
+			RTC::Consumer* consumer{ nullptr };
+			RTC::SharedRtpPacket packet{ nullptr };
+			Priority priority{ Priority::AUDIO };
+			bool retransmission{ false };
+			uint64_t enqueuedAtMs{ 0u };
+		};
+
+	public:
+		static uint32_t GetMaxQueueTime(Priority priority);
+		static DropPolicy GetDropPolicy(Priority priority);
+		static Priority GetPriority(
+		  const RTC::Consumer* consumer, const RTC::RtpPacket* packet, bool retransmission);
+
+	public:
+		explicit RtpPacingQueue(size_t maxSize = 8192u) : maxSize(maxSize)
+		{
+		}
+
+	public:
+		// Returns false if the packet has been dropped because the queue is full
+		// of packets with higher or same priority. Otherwise the packet is cloned
+		// and queued (the oldest packet with the lowest priority may be dropped to
+		// make room for it).
+		bool Enqueue(
+		  RTC::Consumer* consumer,
+		  const RTC::RtpPacket* packet,
+		  Priority priority,
+		  bool retransmission,
+		  uint64_t nowMs);
+		// Returns the next packet to send (which must be removed with Pop()) or
+		// nullptr if empty. Packets whose max queue time elapsed are dropped
+		// first or, depending on their drop policy, returned with `expired` set to
+		// true (so they should be sent regardless of the pacing budget).
+		Item* Front(uint64_t nowMs, bool& expired);
+		// Removes the packet returned by Front() and hands it over.
+		RTC::SharedRtpPacket Pop();
+		// Removes all the packets of the given Consumer.
+		void RemoveConsumer(RTC::Consumer* consumer);
+		void Clear();
+		bool IsEmpty() const
+		{
+			return this->size == 0u;
+		}
+		size_t GetSize() const
+		{
+			return this->size;
+		}
+		size_t GetBytes() const
+		{
+			return this->bytes;
+		}
+		size_t GetSize(Priority priority) const
+		{
+			return this->queues[static_cast<uint8_t>(priority)].size();
+		}
+		uint64_t GetDroppedPackets() const
+		{
+			return this->droppedPackets;
+		}
+		uint64_t GetDroppedPackets(Priority priority) const
+		{
+			return this->droppedPacketsPerPriority[static_cast<uint8_t>(priority)];
+		}
+
+	private:
+		void DropExpired(uint64_t nowMs);
+		void Drop(std::deque<Item>& queue);
+
+	private:
+		// Passed by argument.
+		size_t maxSize{ 0u };
+		// Others.
+		std::deque<Item> queues[NumPriorities];
+		// Index of the queue of the item returned by Front().
+		int8_t frontQueueIdx{ -1 };
+		size_t size{ 0u };
+		size_t bytes{ 0u };
+		uint64_t droppedPackets{ 0u };
+		uint64_t droppedPacketsPerPriority[NumPriorities]{ 0u, 0u, 0u, 0u };
+	};
+} // namespace RTC
+
+#endif
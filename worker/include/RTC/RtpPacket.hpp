@@ -2,13 +2,15 @@
 #define MS_RTC_RTP_PACKET_HPP
 
 #include "common.hpp"
-#include "ObjectPoolAllocator.hpp"
+#include "SlabAllocator.hpp"
 #include "Utils.hpp"
 #include "RTC/Codecs/PayloadDescriptorHandler.hpp"
-#include <absl/container/flat_hash_map.h>
 #include <array>
 #include <nlohmann/json.hpp>
 #include <string>
+#ifndef NDEBUG
+#include <thread>
+#endif
 #include <vector>
 
 using json = nlohmann::json;
@@ -21,15 +23,17 @@ namespace RTC
 	// extension).
 	constexpr uint8_t MidMaxLength{ 8u };
 
+	class SharedRtpPacket;
+
 	class RtpPacket
 	{
+		friend class SharedRtpPacket;
+
 	public:
-		using Allocator       = Utils::ObjectPoolAllocator<RtpPacket>;
+		using Allocator       = Utils::SlabAllocator<RtpPacket>;
 		using AllocatorTraits = std::allocator_traits<Allocator>;
 		// Memory to hold the cloned packet (with extra space for RTX encoding).
-		using RtpPacketBuffer       = std::array<uint8_t, MtuSize + 100>;
-		using BufferAllocator       = Utils::ObjectPoolAllocator<RtpPacket::RtpPacketBuffer>;
-		using BufferAllocatorTraits = std::allocator_traits<BufferAllocator>;
+		using RtpPacketBuffer = std::array<uint8_t, MtuSize + 100>;
 
 		static void Deallocate(RtpPacket* packet);
 
@@ -99,6 +103,38 @@ namespace RTC
 			uint8_t* value;
 		};
 
+	public:
+		/**
+		 * Struct with per-consumer header values that are set on top of a shared
+		 * packet instead of rewriting its buffer. While attached to a packet (see
+		 * SetHeaderOverlay()), header getters and setters operate on the overlay
+		 * and it's applied to the packet bytes when they are serialized. It also
+		 * holds the payload descriptor rewritten by ProcessPayload().
+		 */
+		struct HeaderOverlay
+		{
+			explicit HeaderOverlay(const RtpPacket* packet)
+			  : ssrc(packet->GetSsrc()), sequenceNumber(packet->GetSequenceNumber()),
+			    timestamp(packet->GetTimestamp()), marker(packet->HasMarker())
+			{
+			}
+
+			uint32_t ssrc;
+			uint16_t sequenceNumber;
+			uint32_t timestamp;
+			bool marker;
+			// It must outlive the overlay.
+			const std::string* mid{ nullptr };
+			bool hasAbsSendTime{ false };
+			uint32_t absSendTime{ 0u };
+			bool hasTransportWideCc01{ false };
+			uint16_t wideSeqNumber{ 0u };
+			// Rewritten first bytes of the payload (none if payloadDescriptorLength
+			// is 0).
+			uint8_t payloadDescriptor[Codecs::PayloadDescriptorHandler::MaxProcessedLength];
+			uint8_t payloadDescriptorLength{ 0u };
+		};
+
 	public:
 		/* Struct with frame-marking information. */
 		struct FrameMarking
@@ -163,6 +199,45 @@ namespace RTC
 			return (const uint8_t*)this->header;
 		}
 
+		// Copies the packet into the given buffer (which must have room for
+		// GetSize() bytes) applying the header overlay, if any.
+		size_t Serialize(uint8_t* buffer) const;
+
+		// Returns the packet header (its first GetSerializedHeaderLength() bytes)
+		// as it must be sent. The rest of the packet is sent from GetData() +
+		// GetSerializedHeaderLength() so a packet with a header overlay can be
+		// sent with scatter/gather I/O without copying its payload. If a header
+		// overlay is set the header is serialized into a thread local buffer which
+		// is valid until the next call.
+		const uint8_t* GetSerializedHeader() const;
+
+		size_t GetHeaderLength() const
+		{
+			return this->size - this->payloadLength - size_t{ this->payloadPadding };
+		}
+
+		// Header length plus the payload descriptor rewritten in the header
+		// overlay, if any.
+		size_t GetSerializedHeaderLength() const
+		{
+			if (this->headerOverlay)
+				return GetHeaderLength() + size_t{ this->headerOverlay->payloadDescriptorLength };
+
+			return GetHeaderLength();
+		}
+
+		HeaderOverlay* GetHeaderOverlay() const
+		{
+			return this->headerOverlay;
+		}
+
+		// The overlay is not owned by the packet and must be unset (by passing
+		// nullptr) before it's destroyed.
+		void SetHeaderOverlay(HeaderOverlay* headerOverlay)
+		{
+			this->headerOverlay = headerOverlay;
+		}
+
 		size_t GetSize() const
 		{
 			return this->size;
@@ -180,12 +255,18 @@ namespace RTC
 
 		bool HasMarker() const
 		{
+			if (this->headerOverlay)
+				return this->headerOverlay->marker;
+
 			return this->header->marker;
 		}
 
 		void SetMarker(bool marker)
 		{
-			this->header->marker = marker;
+			if (this->headerOverlay)
+				this->headerOverlay->marker = marker;
+			else
+				this->header->marker = marker;
 		}
 
 		void SetPayloadPaddingFlag(bool flag)
@@ -195,32 +276,66 @@ namespace RTC
 
 		uint16_t GetSequenceNumber() const
 		{
+			if (this->headerOverlay)
+				return this->headerOverlay->sequenceNumber;
+
 			return uint16_t{ ntohs(this->header->sequenceNumber) };
 		}
 
 		void SetSequenceNumber(uint16_t seq)
 		{
-			this->header->sequenceNumber = uint16_t{ htons(seq) };
+			if (this->headerOverlay)
+				this->headerOverlay->sequenceNumber = seq;
+			else
+				this->header->sequenceNumber = uint16_t{ htons(seq) };
 		}
 
 		uint32_t GetTimestamp() const
 		{
+			if (this->headerOverlay)
+				return this->headerOverlay->timestamp;
+
 			return uint32_t{ ntohl(this->header->timestamp) };
 		}
 
 		void SetTimestamp(uint32_t timestamp)
 		{
-			this->header->timestamp = uint32_t{ htonl(timestamp) };
+			if (this->headerOverlay)
+				this->headerOverlay->timestamp = timestamp;
+			else
+				this->header->timestamp = uint32_t{ htonl(timestamp) };
 		}
 
 		uint32_t GetSsrc() const
 		{
+			if (this->headerOverlay)
+				return this->headerOverlay->ssrc;
+
 			return uint32_t{ ntohl(this->header->ssrc) };
 		}
 
 		void SetSsrc(uint32_t ssrc)
 		{
-			this->header->ssrc = uint32_t{ htonl(ssrc) };
+			if (this->headerOverlay)
+				this->headerOverlay->ssrc = ssrc;
+			else
+				this->header->ssrc = uint32_t{ htonl(ssrc) };
+		}
+
+		// Header values of the packet bytes, regardless of the header overlay.
+		uint16_t GetOriginalSequenceNumber() const
+		{
+			return uint16_t{ ntohs(this->header->sequenceNumber) };
+		}
+
+		uint32_t GetOriginalTimestamp() const
+		{
+			return uint32_t{ ntohl(this->header->timestamp) };
+		}
+
+		uint32_t GetOriginalSsrc() const
+		{
+			return uint32_t{ ntohl(this->header->ssrc) };
 		}
 
 		bool HasHeaderExtension() const
@@ -231,6 +346,11 @@ namespace RTC
 		// After calling this method, all the extension ids are reset to 0.
 		void SetExtensions(uint8_t type, const std::vector<GenericExtension>& extensions);
 
+		// Same as SetExtensions() but given the already serialized extension
+		// elements, contiguous and followed by padding up to `len` (which must be
+		// a multiple of 4). They must not point into this packet.
+		void SetSerializedExtensions(uint8_t type, const uint8_t* data, size_t len);
+
 		uint16_t GetHeaderExtensionId() const
 		{
 			if (!this->headerExtension)
@@ -313,13 +433,34 @@ namespace RTC
 
 		bool ReadMid(std::string& mid) const
 		{
-			uint8_t extenLen;
-			uint8_t* extenValue = GetExtension(this->midExtensionId, extenLen);
+			const uint8_t* value;
+			uint8_t len;
+
+			if (!ReadMid(value, len))
+				return false;
+
+			mid.assign(reinterpret_cast<const char*>(value), static_cast<size_t>(len));
+
+			return true;
+		}
+
+		// Same as above but without copying the value.
+		bool ReadMid(const uint8_t*& mid, uint8_t& len) const
+		{
+			uint8_t* extenValue = GetExtension(this->midExtensionId, len);
 
-			if (!extenValue || extenLen == 0u)
+			if (!extenValue || len == 0u)
 				return false;
 
-			mid.assign(reinterpret_cast<const char*>(extenValue), static_cast<size_t>(extenLen));
+			if (this->headerOverlay && this->headerOverlay->mid)
+			{
+				mid = reinterpret_cast<const uint8_t*>(this->headerOverlay->mid->data());
+				len = static_cast<uint8_t>(this->headerOverlay->mid->size());
+
+				return true;
+			}
+
+			mid = extenValue;
 
 			return true;
 		}
@@ -327,23 +468,36 @@ namespace RTC
 		bool UpdateMid(const std::string& mid);
 
 		bool ReadRid(std::string& rid) const
+		{
+			const uint8_t* value;
+			uint8_t len;
+
+			if (!ReadRid(value, len))
+				return false;
+
+			rid.assign(reinterpret_cast<const char*>(value), static_cast<size_t>(len));
+
+			return true;
+		}
+
+		// Same as above but without copying the value.
+		bool ReadRid(const uint8_t*& rid, uint8_t& len) const
 		{
 			// First try with the RID id then with the Repaired RID id.
-			uint8_t extenLen;
-			uint8_t* extenValue = GetExtension(this->ridExtensionId, extenLen);
+			uint8_t* extenValue = GetExtension(this->ridExtensionId, len);
 
-			if (extenValue && extenLen > 0u)
+			if (extenValue && len > 0u)
 			{
-				rid.assign(reinterpret_cast<const char*>(extenValue), static_cast<size_t>(extenLen));
+				rid = extenValue;
 
 				return true;
 			}
 
-			extenValue = GetExtension(this->rridExtensionId, extenLen);
+			extenValue = GetExtension(this->rridExtensionId, len);
 
-			if (extenValue && extenLen > 0u)
+			if (extenValue && len > 0u)
 			{
-				rid.assign(reinterpret_cast<const char*>(extenValue), static_cast<size_t>(extenLen));
+				rid = extenValue;
 
 				return true;
 			}
@@ -359,7 +513,10 @@ namespace RTC
 			if (!extenValue || extenLen != 3u)
 				return false;
 
-			absSendtime = Utils::Byte::Get3Bytes(extenValue, 0);
+			if (this->headerOverlay && this->headerOverlay->hasAbsSendTime)
+				absSendtime = this->headerOverlay->absSendTime;
+			else
+				absSendtime = Utils::Byte::Get3Bytes(extenValue, 0);
 
 			return true;
 		}
@@ -374,7 +531,15 @@ namespace RTC
 
 			auto absSendTime = Utils::Time::TimeMsToAbsSendTime(ms);
 
-			Utils::Byte::Set3Bytes(extenValue, 0, absSendTime);
+			if (this->headerOverlay)
+			{
+				this->headerOverlay->hasAbsSendTime = true;
+				this->headerOverlay->absSendTime    = absSendTime;
+			}
+			else
+			{
+				Utils::Byte::Set3Bytes(extenValue, 0, absSendTime);
+			}
 
 			return true;
 		}
@@ -387,7 +552,10 @@ namespace RTC
 			if (!extenValue || extenLen != 2u)
 				return false;
 
-			wideSeqNumber = Utils::Byte::Get2Bytes(extenValue, 0);
+			if (this->headerOverlay && this->headerOverlay->hasTransportWideCc01)
+				wideSeqNumber = this->headerOverlay->wideSeqNumber;
+			else
+				wideSeqNumber = Utils::Byte::Get2Bytes(extenValue, 0);
 
 			return true;
 		}
@@ -400,7 +568,15 @@ namespace RTC
 			if (!extenValue || extenLen != 2u)
 				return false;
 
-			Utils::Byte::Set2Bytes(extenValue, 0, wideSeqNumber);
+			if (this->headerOverlay)
+			{
+				this->headerOverlay->hasTransportWideCc01 = true;
+				this->headerOverlay->wideSeqNumber        = wideSeqNumber;
+			}
+			else
+			{
+				Utils::Byte::Set2Bytes(extenValue, 0, wideSeqNumber);
+			}
 
 			return true;
 		}
@@ -481,21 +657,15 @@ namespace RTC
 			}
 			else if (HasOneByteExtensions())
 			{
-				if (id > 14)
-					return false;
-
-				// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
-				return this->oneByteExtensions[id - 1] != nullptr;
+				return GetExtensionElement(id) != nullptr;
 			}
 			else if (HasTwoBytesExtensions())
 			{
-				auto it = this->mapTwoBytesExtensions.find(id);
+				auto* extension = reinterpret_cast<TwoBytesExtension*>(GetExtensionElement(id));
 
-				if (it == this->mapTwoBytesExtensions.end())
+				if (!extension)
 					return false;
 
-				auto* extension = it->second;
-
 				// In Two-Byte extensions value length may be zero. If so, return false.
 				if (extension->len == 0u)
 					return false;
@@ -518,11 +688,7 @@ namespace RTC
 			}
 			else if (HasOneByteExtensions())
 			{
-				if (id > 14)
-					return nullptr;
-
-				// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
-				auto* extension = this->oneByteExtensions[id - 1];
+				auto* extension = reinterpret_cast<OneByteExtension*>(GetExtensionElement(id));
 
 				if (!extension)
 					return nullptr;
@@ -534,13 +700,11 @@ namespace RTC
 			}
 			else if (HasTwoBytesExtensions())
 			{
-				auto it = this->mapTwoBytesExtensions.find(id);
+				auto* extension = reinterpret_cast<TwoBytesExtension*>(GetExtensionElement(id));
 
-				if (it == this->mapTwoBytesExtensions.end())
+				if (!extension)
 					return nullptr;
 
-				auto* extension = it->second;
-
 				len = extension->len;
 
 				// In Two-Byte extensions value length may be zero. If so, return nullptr.
@@ -598,17 +762,25 @@ namespace RTC
 			return this->payloadDescriptorHandler->IsKeyFrame();
 		}
 
-		std::shared_ptr<RtpPacket> Clone() const;
+		SharedRtpPacket Clone() const;
 
 		void RtxEncode(uint8_t payloadType, uint32_t ssrc, uint16_t seq);
 
 		bool RtxDecode(uint8_t payloadType, uint32_t ssrc);
 
+		bool HasPayloadDescriptorHandler() const
+		{
+			return this->payloadDescriptorHandler != nullptr;
+		}
+
 		void SetPayloadDescriptorHandler(RTC::Codecs::PayloadDescriptorHandler* payloadDescriptorHandler)
 		{
 			this->payloadDescriptorHandler.reset(payloadDescriptorHandler);
 		}
 
+		// If a header overlay is set the payload descriptor is rewritten into it.
+		// Otherwise the payload is rewritten and RestorePayload() must be called
+		// once the packet is sent.
 		bool ProcessPayload(RTC::Codecs::EncodingContext* context, bool& marker);
 
 		void RestorePayload();
@@ -616,17 +788,53 @@ namespace RTC
 		void ShiftPayload(size_t payloadOffset, size_t shift, bool expand = true);
 
 	private:
+		// Max number of header extension elements whose offset is stored.
+		static constexpr uint8_t MaxExtensionElements{ 16u };
+
+	private:
+		uint8_t* ResetHeaderExtension(uint8_t type, size_t len);
 		void ParseExtensions();
+		void ClearExtensionElements()
+		{
+			this->numExtensionElements      = 0u;
+			this->extensionElementsOverflow = false;
+		}
+		void SetExtensionElement(uint8_t id, const uint8_t* ptr);
+		// Returns a pointer to the One-Byte or Two-Bytes extension element with
+		// the given id, or nullptr.
+		uint8_t* GetExtensionElement(uint8_t id) const
+		{
+			for (uint8_t i{ 0u }; i < this->numExtensionElements; ++i)
+			{
+				if (this->extensionElementIds[i] < id)
+					continue;
+				else if (this->extensionElementIds[i] > id)
+					break;
+
+				return reinterpret_cast<uint8_t*>(this->headerExtension) + this->extensionElementOffsets[i];
+			}
+
+			if (this->extensionElementsOverflow)
+				return FindTwoBytesExtensionElement(id);
+
+			return nullptr;
+		}
+		uint8_t* FindTwoBytesExtensionElement(uint8_t id) const;
+		void ApplyHeaderOverlay(uint8_t* data) const;
+		void ReleaseCloned();
 
 	private:
 		// Passed by argument.
 		Header* header{ nullptr };
 		uint8_t* csrcList{ nullptr };
 		HeaderExtension* headerExtension{ nullptr };
-		// There might be up to 14 one-byte header extensions
-		// (https://datatracker.ietf.org/doc/html/rfc5285#section-4.2), use std::array.
-		std::array<OneByteExtension*, 14> oneByteExtensions;
-		absl::flat_hash_map<uint8_t, TwoBytesExtension*> mapTwoBytesExtensions;
+		// Header extension elements sorted by id, with their offset from the start
+		// of the header extension. All One-Byte ids (1..14) fit. If a packet has
+		// more Two-Bytes ids, those that don't fit are looked up in the packet.
+		uint8_t extensionElementIds[MaxExtensionElements];
+		uint16_t extensionElementOffsets[MaxExtensionElements];
+		uint8_t numExtensionElements{ 0u };
+		bool extensionElementsOverflow{ false };
 		uint8_t midExtensionId{ 0u };
 		uint8_t ridExtensionId{ 0u };
 		uint8_t rridExtensionId{ 0u };
@@ -643,9 +851,153 @@ namespace RTC
 		// Codecs
 		std::shared_ptr<Codecs::PayloadDescriptorHandler> payloadDescriptorHandler;
 		// Buffer where this packet is allocated, can be `nullptr` if packet was
-		// parsed from externally provided buffer.
+		// parsed from externally provided buffer. Not owned, a cloned packet and
+		// its buffer are allocated together.
 		RtpPacketBuffer* buffer{ nullptr };
+		// Per-consumer header values (not owned).
+		HeaderOverlay* headerOverlay{ nullptr };
+		// Number of SharedRtpPacket handles of a cloned packet.
+		uint32_t refCount{ 0u };
+#ifndef NDEBUG
+		// Thread that cloned the packet.
+		std::thread::id ownerThreadId;
+#endif
+	};
+
+	/**
+	 * Ref-counted handle of a cloned RtpPacket. The counter lives in the packet
+	 * and is not atomic, so handles of a packet must only be used within the
+	 * thread that cloned it (asserted in debug builds).
+	 */
+	class SharedRtpPacket
+	{
+		friend class RtpPacket;
+
+	public:
+		SharedRtpPacket() = default;
+		SharedRtpPacket(std::nullptr_t)
+		{
+		}
+		SharedRtpPacket(const SharedRtpPacket& other) : packet(other.packet)
+		{
+			Retain();
+		}
+		SharedRtpPacket(SharedRtpPacket&& other) noexcept : packet(other.packet)
+		{
+			other.packet = nullptr;
+		}
+		~SharedRtpPacket()
+		{
+			Release();
+		}
+
+	public:
+		SharedRtpPacket& operator=(const SharedRtpPacket& other)
+		{
+			if (this->packet != other.packet)
+			{
+				Release();
+
+				this->packet = other.packet;
+
+				Retain();
+			}
+
+			return *this;
+		}
+		SharedRtpPacket& operator=(SharedRtpPacket&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Release();
+
+				this->packet = other.packet;
+				other.packet = nullptr;
+			}
+
+			return *this;
+		}
+		SharedRtpPacket& operator=(std::nullptr_t)
+		{
+			Release();
+
+			return *this;
+		}
+		RtpPacket* get() const
+		{
+			return this->packet;
+		}
+		RtpPacket* operator->() const
+		{
+			return this->packet;
+		}
+		RtpPacket& operator*() const
+		{
+			return *this->packet;
+		}
+		explicit operator bool() const
+		{
+			return this->packet != nullptr;
+		}
+		void reset()
+		{
+			Release();
+		}
+		uint32_t use_count() const
+		{
+			return this->packet ? this->packet->refCount : 0u;
+		}
+
+	private:
+		// Takes the first reference of a cloned packet.
+		explicit SharedRtpPacket(RtpPacket* packet) : packet(packet)
+		{
+			Retain();
+		}
+
+	private:
+		void Retain()
+		{
+			if (!this->packet)
+				return;
+
+#ifndef NDEBUG
+			AssertOwnerThread();
+#endif
+
+			++this->packet->refCount;
+		}
+		void Release()
+		{
+			if (!this->packet)
+				return;
+
+#ifndef NDEBUG
+			AssertOwnerThread();
+#endif
+
+			if (--this->packet->refCount == 0u)
+				this->packet->ReleaseCloned();
+
+			this->packet = nullptr;
+		}
+#ifndef NDEBUG
+		void AssertOwnerThread() const;
+#endif
+
+	private:
+		RtpPacket* packet{ nullptr };
 	};
+
+	inline bool operator==(const SharedRtpPacket& lhs, std::nullptr_t)
+	{
+		return !lhs;
+	}
+
+	inline bool operator!=(const SharedRtpPacket& lhs, std::nullptr_t)
+	{
+		return static_cast<bool>(lhs);
+	}
 } // namespace RTC
 
 #endif
@@ -0,0 +1,87 @@
+#ifndef MS_RTC_RTP_PACKET_HISTORY_HPP
+#define MS_RTC_RTP_PACKET_HISTORY_HPP
+
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <vector>
+
+namespace RTC
+{
+	// History of cloned RTP packets kept for retransmission. Packets are
+	// addressed by the index given when storing them and are removed once older
+	// than `maxAgeMs`, so RtpStreamSend instances just need to keep that index.
+	//
+	// If enabled in the Router, all Consumers of a Producer share a single one
+	// so each packet is stored once regardless of the number of Consumers.
+	// Otherwise each RtpStreamSend keeps its packets by itself.
+	class RtpPacketHistory
+	{
+	public:
+		// Max number of packets (older ones are removed to make room).
+		static constexpr size_t MaxCapacity{ 32768u };
+
+	private:
+		struct Item
+		{
+			RTC::SharedRtpPacket packet{ nullptr };
+			uint64_t storedAtMs{ 0u };
+			// Original header values (the clone may be modified when resent).
+			uint32_t ssrc{ 0u };
+			uint32_t timestamp{ 0u };
+			uint16_t sequenceNumber{ 0u };
+		};
+
+	public:
+		explicit RtpPacketHistory(uint32_t maxAgeMs);
+
+	public:
+		// Stores the packet (cloning it into `sharedPacket` unless already done)
+		// and returns its index. If a packet with same original SSRC, sequence
+		// number and timestamp is already stored its index is returned instead
+		// (and `sharedPacket` is set to it), so this can be called by every stream
+		// the packet is sent to and with duplicated packets.
+		uint32_t Store(RTC::RtpPacket* packet, RTC::SharedRtpPacket& sharedPacket, uint64_t nowMs);
+		// Returns nullptr if the packet is no longer in the history.
+		RTC::RtpPacket* Get(uint32_t index) const
+		{
+			if (index - this->firstIndex >= this->size)
+				return nullptr;
+
+			return this->items[index & this->mask].packet.get();
+		}
+		void SetMaxAge(uint32_t maxAgeMs)
+		{
+			this->maxAgeMs = maxAgeMs;
+		}
+		size_t GetSize() const
+		{
+			return this->size;
+		}
+		size_t GetCapacity() const
+		{
+			return this->items.size();
+		}
+		void Clear();
+
+	private:
+		void RemoveExpired(uint64_t nowMs);
+		void RemoveFirst();
+		void Grow();
+		static uint64_t GetKey(uint32_t ssrc, uint16_t seq)
+		{
+			return (uint64_t{ ssrc } << 16) | seq;
+		}
+
+	private:
+		uint32_t maxAgeMs;
+		std::vector<Item> items;
+		uint32_t mask{ 0u };
+		uint32_t firstIndex{ 0u };
+		size_t size{ 0u };
+		// Index of the stored packets by original SSRC and sequence number.
+		absl::flat_hash_map<uint64_t, uint32_t> mapKeyIndex;
+	};
+} // namespace RTC
+
+#endif
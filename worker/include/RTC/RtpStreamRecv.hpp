@@ -38,7 +38,19 @@ namespace RTC
 			size_t GetBytes() const;
 
 		private:
-			std::vector<std::vector<RTC::RtpDataCounter>> spatialLayerCounters;
+			size_t GetLayerIndex(uint8_t spatialLayer, uint8_t temporalLayer) const
+			{
+				return (static_cast<size_t>(spatialLayer) * this->temporalLayers) + temporalLayer;
+			}
+
+		private:
+			uint8_t spatialLayers{ 1u };
+			uint8_t temporalLayers{ 1u };
+			// Rate of every spatial and temporal layer (ordered by spatial layer and
+			// then by temporal layer) in a single time window.
+			RTC::LayersRateCalculator rate;
+			size_t packets{ 0u };
+			size_t bytes{ 0u };
 		};
 
 	public:
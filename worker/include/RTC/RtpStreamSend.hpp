@@ -1,10 +1,10 @@
 #ifndef MS_RTC_RTP_STREAM_SEND_HPP
 #define MS_RTC_RTP_STREAM_SEND_HPP
 
-#include "ObjectPoolAllocator.hpp"
 #include "RTC/RateCalculator.hpp"
+#include "RTC/RtpPacketHistory.hpp"
 #include "RTC/RtpStream.hpp"
-#include <deque>
+#include <vector>
 
 namespace RTC
 {
@@ -27,47 +27,95 @@ namespace RTC
 	public:
 		struct StorageItem
 		{
-			using Allocator       = Utils::ObjectPoolAllocator<RtpStreamSend::StorageItem>;
-			using AllocatorTraits = std::allocator_traits<Allocator>;
-
 			void Reset();
 
-			// Original packet.
-			std::shared_ptr<RTC::RtpPacket> packet{ nullptr };
-			// Correct SSRC since original packet may not have the same.
-			uint32_t ssrc{ 0 };
-			// Correct sequence number since original packet may not have the same.
-			uint16_t sequenceNumber{ 0 };
+			// Index of the original packet in the packet history (if any).
+			uint32_t historyIndex{ 0u };
 			// Correct timestamp since original packet may not have the same.
-			uint32_t timestamp{ 0 };
-			// Last time this packet was resent.
-			uint64_t resentAtMs{ 0u };
+			uint32_t timestamp{ 0u };
+			// Last time this packet was resent (lower 32 bits of the time in ms).
+			uint32_t resentAtMs{ 0u };
+			// Correct sequence number since original packet may not have the same.
+			uint16_t sequenceNumber{ 0u };
 			// Number of times this packet was resent.
 			uint8_t sentTimes{ 0u };
+			// Whether this item holds a packet.
+			bool stored{ false };
+		};
+
+		// First payload bytes of a stored packet as sent by this stream. The
+		// stored packet may be shared with streams that rewrite its payload
+		// descriptor differently.
+		struct StoredPayloadDescriptor
+		{
+			uint8_t data[RTC::Codecs::PayloadDescriptorHandler::MaxProcessedLength];
+			uint8_t length{ 0u };
 		};
 
 	private:
-		// Special container that stores `StorageItem*` elements addressable by
-		// their `uint16_t` sequence number, while only taking as little memory as
-		// necessary to store the range covering a maximum of
-		// `MaxRetransmissionDelay` milliseconds.
+		// Ring of `StorageItem` elements stored inline and addressable by their
+		// `uint16_t` sequence number (`seq & mask`). It covers a range of
+		// consecutive sequence numbers starting at `startSeq` which never exceeds
+		// the capacity, which doubles when needed to cover `MaxRetransmissionDelay`
+		// milliseconds of packets. Unless a packet history is used, it also holds
+		// the original packets in a parallel vector.
 		class StorageItemBuffer
 		{
 		public:
-			~StorageItemBuffer();
+			// Max number of items (half of the sequence number space).
+			static constexpr size_t MaxCapacity{ 32768u };
 
-			StorageItem* GetFirst() const;
-			StorageItem* Get(uint16_t seq) const;
-			size_t GetBufferSize() const;
-			void Insert(uint16_t seq, StorageItem* storageItem);
+		public:
+			explicit StorageItemBuffer(size_t initialCapacity);
+
+			StorageItem* GetFirst();
+			StorageItem* Get(uint16_t seq);
+			size_t GetBufferSize() const
+			{
+				return this->size;
+			}
+			size_t GetCapacity() const
+			{
+				return this->items.size();
+			}
+			RTC::SharedRtpPacket& GetPacket(const StorageItem* storageItem)
+			{
+				return this->packets[storageItem - this->items.data()];
+			}
+			void SetPayloadDescriptor(const StorageItem* storageItem, const uint8_t* data, size_t len);
+			// Returns nullptr if not set for the given item.
+			const StoredPayloadDescriptor* GetPayloadDescriptor(const StorageItem* storageItem) const;
+			StorageItem* Insert(uint16_t seq);
 			void RemoveFirst();
 			void Clear();
+			// Must be called before inserting any item.
+			void SetHoldPackets(bool holdPackets);
+
+		private:
+			StorageItem& GetItem(uint16_t seq)
+			{
+				return this->items[seq & this->mask];
+			}
+			void ResetItem(uint16_t seq);
+			void Grow();
 
 		private:
-			uint16_t startSeq{ 0 };
-			std::deque<StorageItem*> buffer;
+			size_t initialCapacity;
+			std::vector<StorageItem> items;
+			// Empty if packets are not held.
+			std::vector<RTC::SharedRtpPacket> packets;
+			// Empty until a packet with payload descriptor is inserted.
+			std::vector<StoredPayloadDescriptor> payloadDescriptors;
+			bool holdPackets{ true };
+			uint16_t mask{ 0u };
+			uint16_t startSeq{ 0u };
+			// Number of sequence numbers in the range (including holes).
+			size_t size{ 0u };
 		};
 
+	private:
+		static size_t GetStorageItemBufferCapacity(const RTC::RtpStream::Params& params);
+
 	public:
 		RtpStreamSend(
 		  RTC::RtpStreamSend::Listener* listener, RTC::RtpStream::Params& params, std::string& mid);
@@ -75,7 +123,10 @@ namespace RTC
 
 		void FillJsonStats(json& jsonObject) override;
 		void SetRtx(uint8_t payloadType, uint32_t ssrc) override;
-		bool ReceivePacket(RTC::RtpPacket* packet, std::shared_ptr<RTC::RtpPacket>& sharedPacket);
+		// Store packets into the given packet history (shared with other streams)
+		// instead of holding them. Must be called before any packet is sent.
+		void SetRtpPacketHistory(RTC::RtpPacketHistory* packetHistory);
+		bool ReceivePacket(RTC::RtpPacket* packet, RTC::SharedRtpPacket& sharedPacket);
 		void ReceiveNack(RTC::RTCP::FeedbackRtpNackPacket* nackPacket);
 		void ReceiveKeyFrameRequest(RTC::RTCP::FeedbackPs::MessageType messageType);
 		void ReceiveRtcpReceiverReport(RTC::RTCP::ReceiverReport* report);
@@ -94,9 +145,10 @@ namespace RTC
 		uint32_t GetLayerBitrate(uint64_t nowMs, uint8_t spatialLayer, uint8_t temporalLayer) override;
 
 	private:
-		void StorePacket(RTC::RtpPacket* packet, std::shared_ptr<RTC::RtpPacket>& sharedPacket);
-		void ClearOldPackets(const RtpPacket* packet);
+		void StorePacket(RTC::RtpPacket* packet, RTC::SharedRtpPacket& sharedPacket);
+		void ClearOldPackets(const RtpPacket* packet, uint32_t bufferSizeTs);
 		void ClearBuffer();
+		RTC::RtpPacket* GetStoredPacket(const StorageItem* storageItem);
 		void FillRetransmissionContainer(uint16_t seq, uint16_t bitmask);
 		void UpdateScore(RTC::RTCP::ReceiverReport* report);
 
@@ -104,6 +156,7 @@ namespace RTC
 		uint32_t lostPriorScore{ 0u }; // Packets lost at last interval for score calculation.
 		uint32_t sentPriorScore{ 0u }; // Packets sent at last interval for score calculation.
 		StorageItemBuffer storageItemBuffer;
+		RTC::RtpPacketHistory* packetHistory{ nullptr };
 		std::string mid;
 		uint32_t retransmissionBufferSize;
 		uint16_t rtxSeq{ 0u };
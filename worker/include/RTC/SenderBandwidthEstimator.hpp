@@ -3,14 +3,23 @@
 
 #include "common.hpp"
 #include "RTC/RTCP/FeedbackRtpTransport.hpp"
+#include "RTC/RTCP/ReceiverReport.hpp"
 #include "RTC/RateCalculator.hpp"
 #include "RTC/SeqManager.hpp"
-#include "RTC/TrendCalculator.hpp"
 #include <absl/container/btree_map.h>
-#include <map>
+#include <vector>
 
 namespace RTC
 {
+	// Loss, RTT and delay based estimation of the available outgoing bitrate.
+	//
+	// If the remote endpoint sends transport-cc feedback, the delivery rate and
+	// the one way delay variation of the acknowledged packets are used together
+	// with the reported losses. Otherwise the fraction lost and the RTT given by
+	// RTCP Receiver Reports are used. A received REMB bitrate caps the estimation.
+	//
+	// All methods are given the current time so the estimator can be driven by
+	// a simulated clock.
 	class SenderBandwidthEstimator
 	{
 	public:
@@ -30,13 +39,16 @@ namespace RTC
 		struct SentInfo
 		{
 			uint16_t wideSeq{ 0u };
+			// Whether the packet has a transport-wide sequence number, so it will be
+			// reported by transport-cc feedback.
+			bool hasWideSeq{ false };
 			size_t size{ 0u };
 			bool isProbation{ false };
 			uint64_t sendingAtMs{ 0u };
 			uint64_t sentAtMs{ 0u };
 		};
 
-	private:
+	public:
 		class CummulativeResult
 		{
 		public:
@@ -60,14 +72,21 @@ namespace RTC
 				auto sendIntervalMs =
 				  std::max<uint64_t>(this->lastPacketSentAtMs - this->firstPacketSentAtMs, 1u);
 
-				return static_cast<uint32_t>(this->totalSize / sendIntervalMs) * 8 * 1000;
+				return static_cast<uint32_t>(this->totalSize * 8u * 1000u / sendIntervalMs);
 			}
 			uint32_t GetReceiveBitrate() const
 			{
 				auto recvIntervalMs =
 				  std::max<uint64_t>(this->lastPacketReceivedAtMs - this->firstPacketReceivedAtMs, 1u);
 
-				return static_cast<uint32_t>(this->totalSize / recvIntervalMs) * 8 * 1000;
+				return static_cast<uint32_t>(this->totalSize * 8u * 1000u / recvIntervalMs);
+			}
+			// Time between the sending and the reception of the last packet. Local
+			// and remote clocks are not synchronized so it's only meaningful when
+			// compared to other values given by this method.
+			int64_t GetLastPacketDelayMs() const
+			{
+				return this->lastPacketReceivedAtMs - this->lastPacketSentAtMs;
 			}
 			void AddPacket(size_t size, int64_t sentAtMs, int64_t receivedAtMs);
 			void Reset();
@@ -81,20 +100,70 @@ namespace RTC
 			int64_t lastPacketReceivedAtMs{ 0u };
 		};
 
+	private:
+		// Minimum of the given values. Once the minimum is older than the window
+		// it's replaced by the next given value, so a change in the base delay of
+		// the path is eventually taken.
+		class MinValueTracker
+		{
+		public:
+			explicit MinValueTracker(uint64_t windowMs) : windowMs(windowMs)
+			{
+			}
+
+		public:
+			int64_t GetValue() const
+			{
+				return this->value;
+			}
+			void Update(int64_t value, uint64_t nowMs);
+			void Reset();
+
+		private:
+			uint64_t windowMs{ 0u };
+			bool hasValue{ false };
+			int64_t value{ 0 };
+			uint64_t updatedAtMs{ 0u };
+		};
+
 	public:
 		SenderBandwidthEstimator(
-		  RTC::SenderBandwidthEstimator::Listener* listener, uint32_t initialAvailableBitrate);
+		  RTC::SenderBandwidthEstimator::Listener* listener,
+		  uint32_t initialAvailableBitrate,
+		  uint32_t maxBitrate = 0u);
 		virtual ~SenderBandwidthEstimator();
 
 	public:
-		void TransportConnected();
+		void TransportConnected(uint64_t nowMs);
 		void TransportDisconnected();
-		void RtpPacketSent(SentInfo& sentInfo);
-		void ReceiveRtcpTransportFeedback(const RTC::RTCP::FeedbackRtpTransportPacket* feedback);
-		void EstimateAvailableBitrate(CummulativeResult& cummulativeResult);
-		void UpdateRtt(float rtt);
-		uint32_t GetAvailableBitrate() const;
-		void RescheduleNextAvailableBitrateEvent();
+		void RtpPacketSent(const SentInfo& sentInfo);
+		void ReceiveRtcpTransportFeedback(
+		  const RTC::RTCP::FeedbackRtpTransportPacket* feedback, uint64_t nowMs);
+		void ReceiveRtcpReceiverReport(
+		  RTC::RTCP::ReceiverReportPacket* packet, float rtt, uint64_t nowMs);
+		void ReceiveEstimatedBitrate(uint32_t bitrate, uint64_t nowMs);
+		void SetMaxBitrate(uint32_t maxBitrate);
+		void SetDesiredBitrate(uint32_t desiredBitrate);
+		uint32_t GetAvailableBitrate() const
+		{
+			return this->availableBitrate;
+		}
+		uint32_t GetSendBitrate(uint64_t nowMs)
+		{
+			return this->sendTransmission.GetRate(nowMs);
+		}
+		bool IsUsingTransportFeedback() const
+		{
+			return this->usingTransportFeedback;
+		}
+		void RescheduleNextAvailableBitrateEvent(uint64_t nowMs);
+
+	private:
+		void EstimateAvailableBitrate(
+		  float lossRatio, bool overusing, uint32_t deliveryBitrate, uint64_t nowMs);
+		void EstimateAvailableBitrateFromProbation(uint64_t nowMs);
+		void ApplyLimits();
+		void MayEmitAvailableBitrateEvent(uint64_t nowMs);
 
 	private:
 		// Passed by argument.
@@ -102,13 +171,28 @@ namespace RTC
 		// Others.
 		uint32_t initialAvailableBitrate{ 0u };
 		uint32_t availableBitrate{ 0u };
+		uint32_t maxBitrate{ 0u };
+		uint32_t desiredBitrate{ 0u };
+		uint32_t remoteEstimatedBitrate{ 0u };
+		bool usingTransportFeedback{ false };
+		uint64_t lastEstimationAtMs{ 0u };
+		uint64_t lastDecreaseAtMs{ 0u };
+		uint32_t lastNotifiedAvailableBitrate{ 0u };
 		uint64_t lastAvailableBitrateEventAtMs{ 0u };
 		absl::btree_map<uint16_t, SentInfo, RTC::SeqManager<uint16_t>::SeqLowerThan> sentInfos;
-		float rtt{ 0 }; // Round trip time in ms.
+		// Reused for every received feedback.
+		std::vector<struct RTC::RTCP::FeedbackRtpTransportPacket::PacketResult> packetResults;
+		float rtt{ 0 };         // Round trip time in ms.
+		float smoothedRtt{ 0 }; // Smoothed RTCP RTT in ms (0 if none yet).
+		MinValueTracker minRtt;
+		MinValueTracker minDelay;
+		// Current transport-cc feedback window.
+		uint64_t windowStartedAtMs{ 0u };
+		size_t numReportedPackets{ 0u };
+		size_t numLostPackets{ 0u };
 		CummulativeResult cummulativeResult;
 		CummulativeResult probationCummulativeResult;
 		RTC::RateCalculator sendTransmission;
-		RTC::TrendCalculator sendTransmissionTrend;
 	};
 } // namespace RTC
 
@@ -25,6 +25,10 @@ namespace RTC
 			OUTBOUND
 		};
 
+	public:
+		// Extra room a buffer given to EncryptRtp() must have for the SRTP trailer.
+		static constexpr size_t MaxTrailerLength{ SRTP_MAX_TRAILER_LEN };
+
 	public:
 		static void ClassInit();
 
@@ -37,6 +41,7 @@ namespace RTC
 
 	public:
 		bool EncryptRtp(const uint8_t** data, int* len);
+		bool EncryptRtp(uint8_t* data, int* len, size_t bufferSize);
 		bool DecryptSrtp(uint8_t* data, int* len);
 		bool EncryptRtcp(const uint8_t** data, int* len);
 		bool DecryptSrtcp(uint8_t* data, int* len);
@@ -29,6 +29,14 @@ namespace RTC
 		  size_t len,
 		  RTC::Transport::onSendCallback* cb,
 		  RTC::Transport::OnSendCallbackCtx* ctx);
+		// Sends a single frame with the given data split in two parts.
+		void Send(
+		  const uint8_t* data1,
+		  size_t len1,
+		  const uint8_t* data2,
+		  size_t len2,
+		  RTC::Transport::onSendCallback* cb,
+		  RTC::Transport::OnSendCallbackCtx* ctx);
 
 		/* Pure virtual methods inherited from ::TcpConnectionHandler. */
 	public:
@@ -1,14 +1,14 @@
 #ifndef MS_RTC_TRANSPORT_HPP
 #define MS_RTC_TRANSPORT_HPP
-// #define ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 
 #include "common.hpp"
 #include "DepLibUV.hpp"
-#include "ObjectPoolAllocator.hpp"
+#include "SlabAllocator.hpp"
 #include "Channel/ChannelRequest.hpp"
 #include "Channel/ChannelSocket.hpp"
 #include "PayloadChannel/PayloadChannelNotification.hpp"
 #include "PayloadChannel/PayloadChannelRequest.hpp"
+#include "RTC/BitrateAllocator.hpp"
 #include "RTC/Consumer.hpp"
 #include "RTC/DataConsumer.hpp"
 #include "RTC/DataProducer.hpp"
@@ -22,20 +22,25 @@
 #include "RTC/RtpPacket.hpp"
 #include "RTC/SctpAssociation.hpp"
 #include "RTC/SctpListener.hpp"
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 #include "RTC/SenderBandwidthEstimator.hpp"
-#endif
 #include "RTC/TransportCongestionControlClient.hpp"
 #include "RTC/TransportCongestionControlServer.hpp"
 #include "handles/Timer.hpp"
 #include <absl/container/flat_hash_map.h>
 #include <nlohmann/json.hpp>
+#include <array>
 #include <string>
+#include <vector>
 
 using json = nlohmann::json;
 
 namespace RTC
 {
+	// Define classes here such that we can use them even though we don't know
+	// what they look like yet (this is to avoid circular dependencies).
+	class SrtpSession;
+	class TransportTuple;
+
 	class Transport : public RTC::Producer::Listener,
 	                  public RTC::Consumer::Listener,
 	                  public RTC::DataProducer::Listener,
@@ -46,33 +51,24 @@ namespace RTC
 	                  public Channel::ChannelSocket::RequestHandler,
 	                  public PayloadChannel::PayloadChannelSocket::RequestHandler,
 	                  public PayloadChannel::PayloadChannelSocket::NotificationHandler,
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 	                  public RTC::SenderBandwidthEstimator::Listener,
-#endif
 	                  public Timer::Listener
 	{
 	protected:
 		using onQueuedCallback = const std::function<void(bool queued, bool sctpSendBufferFull)>;
 
 	public:
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
-		struct OnSendCallbackCtx
-		{
-			RTC::TransportCongestionControlClient* tccClient;
-			webrtc::RtpPacketSendInfo packetInfo;
-			RTC::SenderBandwidthEstimator* senderBwe;
-			RTC::SenderBandwidthEstimator::SentInfo sentInfo;
-		};
-#else
 		struct OnSendCallbackCtx
 		{
-			using Allocator       = Utils::ObjectPoolAllocator<Transport::OnSendCallbackCtx>;
+			using Allocator       = Utils::SlabAllocator<Transport::OnSendCallbackCtx>;
 			using AllocatorTraits = std::allocator_traits<Allocator>;
 
 			RTC::TransportCongestionControlClient* tccClient;
 			webrtc::RtpPacketSendInfo packetInfo;
+			// Null if the SenderBandwidthEstimator is not enabled.
+			RTC::SenderBandwidthEstimator* senderBwe;
+			RTC::SenderBandwidthEstimator::SentInfo sentInfo;
 		};
-#endif
 		// This function MUST NOT be de-allocated manually and MUST be called EXACTLY once.
 		static void OnSendCallback(bool sent, OnSendCallbackCtx* ctx);
 		using onSendCallback = void(bool sent, OnSendCallbackCtx* ctx);
@@ -151,6 +147,16 @@ namespace RTC
 		// Subclasses must also invoke the parent Close().
 		virtual void FillJson(json& jsonObject) const;
 		virtual void FillJsonStats(json& jsonArray);
+		/**
+		 * RTP packets received between these calls are processed together in
+		 * EndRecvBatch(), which also records the number of received datagrams.
+		 * Subclasses decrypt and parse each packet before passing it, so only the
+		 * Producer lookup and dispatch are done per batch.
+		 * Transport-wide CC feedbacks are also passed to the congestion controller
+		 * as a single update.
+		 */
+		void StartRecvBatch();
+		void EndRecvBatch(size_t numDatagrams);
 
 		/* Methods inherited from Channel::ChannelSocket::RequestHandler. */
 	public:
@@ -179,6 +185,12 @@ namespace RTC
 		void ReceiveRtpPacket(RTC::RtpPacket* packet);
 		void ReceiveRtcpPacket(RTC::RTCP::Packet* packet);
 		void ReceiveSctpData(const uint8_t* data, size_t len);
+		void SendRtpPacketToTuple(
+		  RTC::TransportTuple* tuple,
+		  RTC::RtpPacket* packet,
+		  RTC::SrtpSession* srtpSession,
+		  onSendCallback* cb,
+		  OnSendCallbackCtx* ctx);
 		void SetNewProducerIdFromData(json& data, std::string& producerId) const;
 		RTC::Producer* GetProducerFromData(json& data) const;
 		void SetNewConsumerIdFromData(json& data, std::string& consumerId) const;
@@ -197,6 +209,8 @@ namespace RTC
 		  RTC::RtpPacket* packet,
 		  onSendCallback* cb     = nullptr,
 		  OnSendCallbackCtx* ctx = nullptr) = 0;
+		void ReceiveRtpPackets(RTC::RtpPacket** packets, size_t count);
+		void FlushRecvBatchRtpPackets();
 		void HandleRtcpPacket(RTC::RTCP::Packet* packet);
 		void SendRtcp(uint64_t nowMs);
 		virtual void SendRtcpPacket(RTC::RTCP::Packet* packet)                 = 0;
@@ -210,6 +224,8 @@ namespace RTC
 		virtual void SendSctpData(const uint8_t* data, size_t len) = 0;
 		virtual void RecvStreamClosed(uint32_t ssrc)               = 0;
 		virtual void SendStreamClosed(uint32_t ssrc)               = 0;
+		void SendConsumerRtpPacket(RTC::Consumer* consumer, RTC::RtpPacket* packet, bool retransmission);
+		uint32_t GetAvailableOutgoingBitrate() const;
 		void DistributeAvailableOutgoingBitrate();
 		void ComputeOutgoingDesiredBitrate(bool forceBitrate = false);
 		void EmitTraceEventProbationType(RTC::RtpPacket* packet) const;
@@ -292,20 +308,23 @@ namespace RTC
 		  RTC::TransportCongestionControlClient* tccClient,
 		  RTC::RtpPacket* packet,
 		  const webrtc::PacedPacketInfo& pacingInfo) override;
+		void OnTransportCongestionControlClientSendQueuedRtpPacket(
+		  RTC::TransportCongestionControlClient* tccClient,
+		  RTC::Consumer* consumer,
+		  RTC::RtpPacket* packet,
+		  bool retransmission) override;
 
 		/* Pure virtual methods inherited from RTC::TransportCongestionControlServer::Listener. */
 	public:
 		void OnTransportCongestionControlServerSendRtcpPacket(
 		  RTC::TransportCongestionControlServer* tccServer, RTC::RTCP::Packet* packet) override;
 
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 		/* Pure virtual methods inherited from RTC::SenderBandwidthEstimator::Listener. */
 	public:
 		void OnSenderBandwidthEstimatorAvailableBitrate(
 		  RTC::SenderBandwidthEstimator* senderBwe,
 		  uint32_t availableBitrate,
 		  uint32_t previousAvailableBitrate) override;
-#endif
 
 		/* Pure virtual methods inherited from Timer::Listener. */
 	public:
@@ -333,15 +352,14 @@ namespace RTC
 		Timer* rtcpTimer{ nullptr };
 		RTC::TransportCongestionControlClient* tccClient{ nullptr };
 		RTC::TransportCongestionControlServer* tccServer{ nullptr };
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 		RTC::SenderBandwidthEstimator* senderBwe{ nullptr };
-#endif
 		// Others.
 		bool direct{ false }; // Whether this Transport allows PayloadChannel comm.
 		bool destroying{ false };
 		struct RTC::RtpHeaderExtensionIds recvRtpHeaderExtensionIds;
 		RTC::RtpListener rtpListener;
 		RTC::SctpListener sctpListener;
+		RTC::BitrateAllocator bitrateAllocator;
 		RTC::RateCalculator recvTransmission;
 		RTC::RateCalculator sendTransmission;
 		RTC::RtpDataCounter recvRtpTransmission;
@@ -353,7 +371,14 @@ namespace RTC
 		uint32_t initialAvailableOutgoingBitrate{ 600000u };
 		uint32_t maxIncomingBitrate{ 0u };
 		uint32_t maxOutgoingBitrate{ 0u };
+		bool enablePacing{ false };
+		bool enableSenderBwe{ false };
 		struct TraceEventTypes traceEventTypes;
+		bool recvBatching{ false };
+		std::vector<RTC::RtpPacket*> recvBatchRtpPackets;
+		// Number of received batches whose size is within [2^i, 2^(i+1)), the
+		// last bucket counts all the bigger ones.
+		std::array<size_t, 5> recvBatchSizes{};
 	};
 } // namespace RTC
 
@@ -5,6 +5,7 @@
 #include "RTC/BweType.hpp"
 #include "RTC/RTCP/FeedbackRtpTransport.hpp"
 #include "RTC/RTCP/ReceiverReport.hpp"
+#include "RTC/RtpPacingQueue.hpp"
 #include "RTC/RtpPacket.hpp"
 #include "RTC/RtpProbationGenerator.hpp"
 #include "RTC/TrendCalculator.hpp"
@@ -49,6 +50,11 @@ namespace RTC
 			  RTC::TransportCongestionControlClient* tccClient,
 			  RTC::RtpPacket* packet,
 			  const webrtc::PacedPacketInfo& pacingInfo) = 0;
+			virtual void OnTransportCongestionControlClientSendQueuedRtpPacket(
+			  RTC::TransportCongestionControlClient* tccClient,
+			  RTC::Consumer* consumer,
+			  RTC::RtpPacket* packet,
+			  bool retransmission) = 0;
 		};
 
 	public:
@@ -56,7 +62,8 @@ namespace RTC
 		  RTC::TransportCongestionControlClient::Listener* listener,
 		  RTC::BweType bweType,
 		  uint32_t initialAvailableBitrate,
-		  uint32_t maxOutgoingBitrate);
+		  uint32_t maxOutgoingBitrate,
+		  bool enablePacing = false);
 		virtual ~TransportCongestionControlClient();
 
 	public:
@@ -72,6 +79,11 @@ namespace RTC
 		void ReceiveEstimatedBitrate(uint32_t bitrate);
 		void ReceiveRtcpReceiverReport(RTC::RTCP::ReceiverReportPacket* packet, float rtt, int64_t nowMs);
 		void ReceiveRtcpTransportFeedback(const RTC::RTCP::FeedbackRtpTransportPacket* feedback);
+		// Transport-wide feedbacks received between these calls (i.e. within the
+		// same batch of received datagrams) are passed to the congestion
+		// controller as a single update.
+		void StartRtcpTransportFeedbackBatch();
+		void EndRtcpTransportFeedbackBatch();
 		void SetDesiredBitrate(uint32_t desiredBitrate, bool force);
 		void SetMaxOutgoingBitrate(uint32_t maxBitrate);
 		const Bitrates& GetBitrates() const
@@ -81,6 +93,38 @@ namespace RTC
 		uint32_t GetAvailableBitrate() const;
 		double GetPacketLoss() const;
 		void RescheduleNextAvailableBitrateEvent();
+		bool IsPacingEnabled() const
+		{
+			return this->enablePacing;
+		}
+		// Returns true if the packet must be sent right now. Otherwise it's been
+		// queued (or dropped) and it will be sent later via
+		// OnTransportCongestionControlClientSendQueuedRtpPacket().
+		bool MayQueueRtpPacket(
+		  RTC::Consumer* consumer,
+		  RTC::RtpPacket* packet,
+		  RTC::RtpPacingQueue::Priority priority,
+		  bool retransmission);
+		// Removes the queued packets of the given Consumer.
+		void RemoveQueuedRtpPackets(RTC::Consumer* consumer);
+		size_t GetPacingQueueSize() const
+		{
+			return this->pacingQueue.GetSize();
+		}
+		size_t GetPacingQueueBytes() const
+		{
+			return this->pacingQueue.GetBytes();
+		}
+		uint64_t GetPacingDroppedPackets() const
+		{
+			return this->pacingQueue.GetDroppedPackets();
+		}
+		// Smoothed time (in ms) that sent packets have been waiting in the pacing
+		// queue.
+		double GetPacingDelay() const
+		{
+			return this->pacingDelay;
+		}
 
 	private:
 		void MayEmitAvailableBitrateEvent(uint32_t previousAvailableBitrate);
@@ -89,6 +133,9 @@ namespace RTC
 
 		void InitializeController();
 		void DestroyController();
+		void UpdatePacingBudget(uint64_t nowUs);
+		void UpdatePacingDelay(uint64_t delayMs);
+		void SendQueuedRtpPackets();
 
 		// jmillan: missing.
 		// void OnRemoteNetworkEstimate(NetworkStateEstimate estimate) override;
@@ -114,6 +161,7 @@ namespace RTC
 		webrtc::RtpTransportControllerSend* rtpTransportControllerSend{ nullptr };
 		RTC::RtpProbationGenerator* probationGenerator{ nullptr };
 		Timer* processTimer{ nullptr };
+		Timer* pacingTimer{ nullptr };
 		// Others.
 		RTC::BweType bweType;
 		uint32_t initialAvailableBitrate{ 0u };
@@ -124,6 +172,12 @@ namespace RTC
 		RTC::TrendCalculator desiredBitrateTrend;
 		std::deque<double> packetLossHistory;
 		double packetLoss{ 0 };
+		bool enablePacing{ false };
+		RTC::RtpPacingQueue pacingQueue;
+		// Bytes that can be sent right now (negative if over the pacing rate).
+		int64_t pacingBudget{ 0 };
+		uint64_t pacingBudgetUpdatedAtUs{ 0u };
+		double pacingDelay{ 0 };
 	};
 } // namespace RTC
 
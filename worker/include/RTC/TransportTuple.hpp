@@ -63,6 +63,12 @@ namespace RTC
 
 		void FillJson(json& jsonObject) const;
 
+		void FillJsonSendBatchStats(json& jsonObject) const
+		{
+			if (this->protocol == Protocol::UDP)
+				this->udpSocket->FillJsonSendBatchStats(jsonObject);
+		}
+
 		void Dump() const;
 
 		void StoreUdpRemoteAddress()
@@ -95,6 +101,42 @@ namespace RTC
 				this->tcpConnection->Send(data, len, cb, ctx);
 		}
 
+		// Sends the given data split in two parts as a single datagram or frame.
+		void Send(
+		  const uint8_t* data1,
+		  size_t len1,
+		  const uint8_t* data2,
+		  size_t len2,
+		  Transport::onSendCallback* cb     = nullptr,
+		  Transport::OnSendCallbackCtx* ctx = nullptr)
+		{
+			if (this->protocol == Protocol::UDP)
+				this->udpSocket->Send(data1, len1, data2, len2, this->udpRemoteAddr, cb, ctx);
+			else
+				this->tcpConnection->Send(data1, len1, data2, len2, cb, ctx);
+		}
+
+		/**
+		 * Returns a buffer of at least len bytes to write a datagram into, or
+		 * nullptr if not available (so Send() must be used instead). The caller
+		 * must immediately call SendBuffer() after writing into it.
+		 */
+		uint8_t* GetSendBuffer(size_t len)
+		{
+			if (this->protocol == Protocol::UDP)
+				return this->udpSocket->GetSendBuffer(len);
+			else
+				return nullptr;
+		}
+
+		void SendBuffer(
+		  size_t len,
+		  Transport::onSendCallback* cb     = nullptr,
+		  Transport::OnSendCallbackCtx* ctx = nullptr)
+		{
+			this->udpSocket->SendBuffer(len, this->udpRemoteAddr, cb, ctx);
+		}
+
 		Protocol GetProtocol() const
 		{
 			return this->protocol;
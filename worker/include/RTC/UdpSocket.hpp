@@ -3,8 +3,11 @@
 
 #include "common.hpp"
 #include "handles/UdpSocketHandler.hpp"
+#include <nlohmann/json.hpp>
 #include <string>
 
+using json = nlohmann::json;
+
 namespace RTC
 {
 	class UdpSocket : public ::UdpSocketHandler
@@ -16,18 +19,22 @@ namespace RTC
 			virtual ~Listener() = default;
 
 		public:
-			virtual void OnUdpSocketPacketReceived(
-			  RTC::UdpSocket* socket, const uint8_t* data, size_t len, const struct sockaddr* remoteAddr) = 0;
+			virtual void OnUdpSocketPacketsReceived(
+			  RTC::UdpSocket* socket, const RecvDatagram* datagrams, size_t count) = 0;
 		};
 
 	public:
 		UdpSocket(Listener* listener, std::string& ip);
 		UdpSocket(Listener* listener, std::string& ip, uint16_t port);
+		UdpSocket(Listener* listener, std::string& ip, uint16_t port, uint16_t numReusePortShards);
 		~UdpSocket() override;
 
+	public:
+		void FillJsonSendBatchStats(json& jsonObject) const;
+
 		/* Pure virtual methods inherited from ::UdpSocketHandler. */
 	public:
-		void UserOnUdpDatagramReceived(const uint8_t* data, size_t len, const struct sockaddr* addr) override;
+		void UserOnUdpDatagramsReceived(const RecvDatagram* datagrams, size_t count) override;
 
 	private:
 		// Passed by argument.
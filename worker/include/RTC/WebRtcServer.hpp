@@ -8,10 +8,12 @@
 #include "RTC/TcpServer.hpp"
 #include "RTC/TransportTuple.hpp"
 #include "RTC/UdpSocket.hpp"
+#include "RTC/WebRtcServerShardGroup.hpp"
 #include "RTC/WebRtcTransport.hpp"
 #include <absl/container/flat_hash_map.h>
 #include <absl/container/flat_hash_set.h>
 #include <nlohmann/json.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -21,6 +23,7 @@ namespace RTC
 	                     public RTC::TcpServer::Listener,
 	                     public RTC::TcpConnection::Listener,
 	                     public RTC::WebRtcTransport::WebRtcTransportListener,
+	                     public RTC::WebRtcServerShardGroup::Listener,
 	                     public Channel::ChannelSocket::RequestHandler
 	{
 	private:
@@ -64,6 +67,11 @@ namespace RTC
 		void OnPacketReceived(RTC::TransportTuple* tuple, const uint8_t* data, size_t len);
 		void OnStunDataReceived(RTC::TransportTuple* tuple, const uint8_t* data, size_t len);
 		void OnNonStunDataReceived(RTC::TransportTuple* tuple, const uint8_t* data, size_t len);
+		bool ForwardToShard(
+		  const std::shared_ptr<RTC::WebRtcServerShardGroup::Shard>& shard,
+		  RTC::TransportTuple* tuple,
+		  const uint8_t* data,
+		  size_t len);
 
 		/* Pure virtual methods inherited from RTC::WebRtcTransport::WebRtcTransportListener. */
 	public:
@@ -78,10 +86,15 @@ namespace RTC
 		void OnWebRtcTransportTransportTupleRemoved(
 		  RTC::WebRtcTransport* webRtcTransport, RTC::TransportTuple* tuple) override;
 
+		/* Pure virtual methods inherited from RTC::WebRtcServerShardGroup::Listener. */
+	public:
+		void OnWebRtcServerShardGroupPacketForwarded(
+		  size_t socketIdx, const uint8_t* data, size_t len, const struct sockaddr* remoteAddr) override;
+
 		/* Pure virtual methods inherited from RTC::UdpSocket::Listener. */
 	public:
-		void OnUdpSocketPacketReceived(
-		  RTC::UdpSocket* socket, const uint8_t* data, size_t len, const struct sockaddr* remoteAddr) override;
+		void OnUdpSocketPacketsReceived(
+		  RTC::UdpSocket* socket, const RTC::UdpSocket::RecvDatagram* datagrams, size_t count) override;
 
 		/* Pure virtual methods inherited from RTC::TcpServer::Listener. */
 	public:
@@ -105,6 +118,11 @@ namespace RTC
 		absl::flat_hash_map<std::string, RTC::WebRtcTransport*> mapLocalIceUsernameFragmentWebRtcTransport;
 		// Map of WebRtcTransports indexed by TransportTuple.hash.
 		absl::flat_hash_map<uint64_t, RTC::WebRtcTransport*> mapTupleWebRtcTransport;
+		// Number of SO_REUSEPORT shards listening in the same UDP sockets.
+		uint16_t numShards{ 1u };
+		// Group of shards (just if numShards > 1).
+		RTC::WebRtcServerShardGroup* shardGroup{ nullptr };
+		std::shared_ptr<RTC::WebRtcServerShardGroup::Shard> shard;
 	};
 } // namespace RTC
 
@@ -0,0 +1,145 @@
+#ifndef MS_RTC_WEBRTC_SERVER_SHARD_GROUP_HPP
+#define MS_RTC_WEBRTC_SERVER_SHARD_GROUP_HPP
+
+#include "common.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <uv.h>
+#include <vector>
+
+namespace RTC
+{
+	/**
+	 * Group of WebRtcServers running in different worker threads of the same
+	 * process and listening on the same SO_REUSEPORT UDP sockets. The kernel
+	 * steers each remote tuple always to the same shard (WebRtcServer), which
+	 * forwards the packets of the tuples and ICE username fragments owned by
+	 * WebRtcTransports of other shards to them.
+	 */
+	class WebRtcServerShardGroup
+	{
+	public:
+		class Listener
+		{
+		public:
+			virtual ~Listener() = default;
+
+		public:
+			virtual void OnWebRtcServerShardGroupPacketForwarded(
+			  size_t socketIdx, const uint8_t* data, size_t len, const struct sockaddr* remoteAddr) = 0;
+		};
+
+	public:
+		// Max number of packets waiting in the inbox of a shard (about 1 MB).
+		static constexpr size_t MaxInboxPackets{ 512u };
+
+	private:
+		struct ForwardedPacket
+		{
+			// Max size of a forwarded packet.
+			static constexpr size_t StoreSize{ 2048u };
+
+			size_t socketIdx;
+			struct sockaddr_storage remoteAddr;
+			size_t len;
+			uint8_t store[StoreSize];
+		};
+
+	public:
+		class Shard
+		{
+			friend class WebRtcServerShardGroup;
+
+		public:
+			explicit Shard(Listener* listener);
+			~Shard();
+
+		public:
+			size_t GetDroppedPackets();
+			void OnUvAsync();
+
+		private:
+			void AddStaleUsernameFragment(const std::string& usernameFragment);
+			void AddStaleTuple(uint64_t tupleHash);
+			void AddStaleAll();
+			void DropStaleEntries();
+
+		private:
+			// Passed by argument.
+			Listener* listener{ nullptr };
+			// Allocated by this.
+			uv_async_t* uvHandle{ nullptr };
+			// Others (guarded by mutex).
+			std::mutex mutex;
+			bool closed{ false };
+			std::vector<ForwardedPacket> inbox;
+			size_t droppedPackets{ 0u };
+			// Username fragments and tuples added to or removed from the group since
+			// the last lookup of this shard.
+			std::vector<std::string> staleUsernameFragments;
+			std::vector<uint64_t> staleTuples;
+			bool staleAll{ false };
+			std::atomic<bool> hasStaleEntries{ false };
+			// Others (just accessed from the thread of this shard).
+			std::vector<ForwardedPacket> draining;
+			// Owner shard of the username fragments and tuples looked up by this
+			// shard, nullptr if none (negative cache).
+			absl::flat_hash_map<std::string, std::shared_ptr<Shard>> mapUsernameFragmentShard;
+			absl::flat_hash_map<uint64_t, std::shared_ptr<Shard>> mapTupleShard;
+		};
+
+	public:
+		// Runs the given bind function and adds a shard for the given listener
+		// into the group with the given key. Binding is done with the group locked
+		// so shards are added in the same order their sockets are added into the
+		// SO_REUSEPORT groups.
+		static WebRtcServerShardGroup* Join(
+		  const std::string& key,
+		  Listener* listener,
+		  const std::function<void()>& bindSockets,
+		  std::shared_ptr<Shard>& shard);
+		static void Leave(WebRtcServerShardGroup* group, std::shared_ptr<Shard>& shard);
+		// Forwards the packet to the given shard. May be called from any thread.
+		static bool Forward(
+		  const std::shared_ptr<Shard>& shard,
+		  size_t socketIdx,
+		  const uint8_t* data,
+		  size_t len,
+		  const struct sockaddr* remoteAddr);
+
+	private:
+		explicit WebRtcServerShardGroup(const std::string& key);
+
+	public:
+		void AddUsernameFragment(const std::string& usernameFragment, const std::shared_ptr<Shard>& shard);
+		void RemoveUsernameFragment(const std::string& usernameFragment);
+		void AddTuple(uint64_t tupleHash, const std::shared_ptr<Shard>& shard);
+		void RemoveTuple(uint64_t tupleHash);
+		// Return the shard owning the given username fragment or tuple, or nullptr
+		// if none or if it's the given shard. They must be called from the thread
+		// of the given shard, which caches the result (even if nullptr) until the
+		// username fragment or tuple is added to or removed from the group.
+		std::shared_ptr<Shard> GetUsernameFragmentShard(
+		  const std::shared_ptr<Shard>& shard, const std::string& usernameFragment);
+		std::shared_ptr<Shard> GetTupleShard(const std::shared_ptr<Shard>& shard, uint64_t tupleHash);
+
+	private:
+		static std::mutex globalMutex;
+		static absl::flat_hash_map<std::string, WebRtcServerShardGroup*> mapKeyGroup;
+
+	private:
+		// Passed by argument.
+		std::string key;
+		// Others.
+		std::mutex mutex;
+		std::vector<std::shared_ptr<Shard>> shards;
+		absl::flat_hash_map<std::string, std::shared_ptr<Shard>> mapUsernameFragmentShard;
+		absl::flat_hash_map<uint64_t, std::shared_ptr<Shard>> mapTupleShard;
+	};
+} // namespace RTC
+
+#endif
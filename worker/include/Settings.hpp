@@ -28,6 +28,13 @@ public:
 		bool message{ false };
 	};
 
+	// Format of the messages sent through the Channel.
+	enum class ChannelFormat
+	{
+		JSON,
+		MSGPACK
+	};
+
 public:
 	// Struct holding the configuration.
 	struct Configuration
@@ -38,6 +45,13 @@ public:
 		uint16_t rtcMaxPort{ 59999u };
 		std::string dtlsCertificateFile;
 		std::string dtlsPrivateKeyFile;
+		// Max number of UDP datagrams sent together in a loop iteration. 1 means
+		// no batching.
+		uint16_t udpSendBatchSize{ 32u };
+		// Granularity (in milliseconds) of the timer wheel ticks. Timers expiring
+		// within the same tick fire together.
+		uint16_t timerGranularity{ 1u };
+		ChannelFormat channelFormat{ ChannelFormat::JSON };
 	};
 
 public:
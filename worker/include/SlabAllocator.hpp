@@ -0,0 +1,299 @@
+#ifndef MS_SLAB_ALLOCATOR_HPP
+#define MS_SLAB_ALLOCATOR_HPP
+
+// #define MS_ALLOCATOR_FREE_ON_RETURN 1
+
+#include "common.hpp"
+#include <cstdlib> // std::free(), std::malloc(), posix_memalign()
+#include <new>     // std::bad_alloc
+#ifdef _WIN32
+#include <malloc.h> // _aligned_malloc(), _aligned_free()
+#endif
+
+namespace Utils
+{
+	// Pool of fixed size slots carved out of slabs. Each slab is a
+	// SlabSize aligned block of memory starting with a header, so the slab of a
+	// slot is found by masking its address. Slabs with free slots are kept in a
+	// list and the first one is always used for allocations, so memory of the
+	// other ones can be returned to the system once they become empty.
+	template<size_t SlotSize, size_t SlotAlignment>
+	class SlabPool
+	{
+	public:
+		// Size (and alignment) of each slab. Multiple of the page size.
+		static constexpr size_t SlabSize{ 65536u };
+		// Number of empty slabs to keep for later use. Other slabs becoming empty
+		// are returned to the system right away, so RSS goes down after a traffic
+		// spike.
+		static constexpr size_t MaxEmptySlabs{ 1u };
+
+	private:
+		// A free slot holds a pointer to the next free slot of its slab.
+		struct FreeSlot
+		{
+			FreeSlot* next;
+		};
+
+		struct Slab
+		{
+			FreeSlot* freeSlots{ nullptr };
+			// Number of slots never allocated since the slab was created. They are
+			// at the end of the slab and are not in the freeSlots list.
+			size_t untouchedSlots{ 0u };
+			size_t usedSlots{ 0u };
+			// Previous and next slabs with free slots.
+			Slab* prev{ nullptr };
+			Slab* next{ nullptr };
+		};
+
+		static constexpr size_t Alignment{ SlotAlignment > alignof(FreeSlot) ? SlotAlignment
+			                                                                     : alignof(FreeSlot) };
+		static constexpr size_t Stride{ ((SlotSize > sizeof(FreeSlot) ? SlotSize : sizeof(FreeSlot)) +
+			                               Alignment - 1) /
+			                              Alignment * Alignment };
+		static constexpr size_t FirstSlotOffset{ (sizeof(Slab) + Alignment - 1) / Alignment * Alignment };
+		static constexpr size_t SlotsPerSlab{ (SlabSize - FirstSlotOffset) / Stride };
+
+		static_assert(SlotsPerSlab >= 8u, "slot too big for a slab");
+
+	public:
+		thread_local static SlabPool<SlotSize, SlotAlignment> Instance;
+
+	public:
+		SlabPool() = default;
+		~SlabPool()
+		{
+			// Just empty slabs are freed. Those still in use (if any) are leaked on
+			// purpose since objects living in them may still be referenced.
+			while (this->availableSlabs)
+			{
+				auto* slab = this->availableSlabs;
+
+				RemoveAvailableSlab(slab);
+
+				if (slab->usedSlots == 0u)
+				{
+					--this->numEmptySlabs;
+
+					FreeSlab(slab);
+				}
+			}
+		}
+
+	public:
+		void* Allocate()
+		{
+			if (!this->availableSlabs)
+				AddAvailableSlab(CreateSlab());
+
+			auto* slab = this->availableSlabs;
+			void* ptr;
+
+			if (slab->freeSlots)
+			{
+				ptr             = slab->freeSlots;
+				slab->freeSlots = slab->freeSlots->next;
+			}
+			else
+			{
+				ptr = reinterpret_cast<uint8_t*>(slab) + FirstSlotOffset +
+				      ((SlotsPerSlab - slab->untouchedSlots) * Stride);
+
+				--slab->untouchedSlots;
+			}
+
+			if (slab->usedSlots++ == 0u)
+				--this->numEmptySlabs;
+
+			// Slab is full now.
+			if (!slab->freeSlots && slab->untouchedSlots == 0u)
+				RemoveAvailableSlab(slab);
+
+			return ptr;
+		}
+
+		void Deallocate(void* ptr)
+		{
+			auto* slab = reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) & ~(SlabSize - 1));
+			auto* freeSlot = static_cast<FreeSlot*>(ptr);
+
+			// Slab was full so it was not in the list.
+			if (!slab->freeSlots && slab->untouchedSlots == 0u)
+				AddAvailableSlab(slab);
+
+			freeSlot->next  = slab->freeSlots;
+			slab->freeSlots = freeSlot;
+
+			if (--slab->usedSlots != 0u)
+				return;
+
+			if (this->numEmptySlabs < MaxEmptySlabs)
+			{
+				++this->numEmptySlabs;
+
+				return;
+			}
+
+			RemoveAvailableSlab(slab);
+			FreeSlab(slab);
+		}
+
+		size_t GetNumSlabs() const
+		{
+			return this->numSlabs;
+		}
+
+	private:
+		Slab* CreateSlab()
+		{
+			void* memory{ nullptr };
+
+#ifdef _WIN32
+			memory = _aligned_malloc(SlabSize, SlabSize);
+#else
+			if (posix_memalign(&memory, SlabSize, SlabSize) != 0)
+				memory = nullptr;
+#endif
+
+			if (!memory)
+				throw std::bad_alloc();
+
+			auto* slab = new (memory) Slab();
+
+			slab->untouchedSlots = SlotsPerSlab;
+
+			++this->numSlabs;
+			++this->numEmptySlabs;
+
+			return slab;
+		}
+
+		void FreeSlab(Slab* slab)
+		{
+			--this->numSlabs;
+
+			slab->~Slab();
+
+#ifdef _WIN32
+			_aligned_free(slab);
+#else
+			std::free(slab);
+#endif
+		}
+
+		void AddAvailableSlab(Slab* slab)
+		{
+			slab->prev = nullptr;
+			slab->next = this->availableSlabs;
+
+			if (this->availableSlabs)
+				this->availableSlabs->prev = slab;
+
+			this->availableSlabs = slab;
+		}
+
+		void RemoveAvailableSlab(Slab* slab)
+		{
+			if (slab->prev)
+				slab->prev->next = slab->next;
+			else
+				this->availableSlabs = slab->next;
+
+			if (slab->next)
+				slab->next->prev = slab->prev;
+
+			slab->prev = nullptr;
+			slab->next = nullptr;
+		}
+
+	private:
+		Slab* availableSlabs{ nullptr };
+		size_t numSlabs{ 0u };
+		size_t numEmptySlabs{ 0u };
+	};
+
+	template<size_t SlotSize, size_t SlotAlignment>
+	thread_local SlabPool<SlotSize, SlotAlignment> SlabPool<SlotSize, SlotAlignment>::Instance;
+
+	// Allocator of single objects backed by a thread local SlabPool shared by
+	// all the types with same size and alignment. Arrays are allocated as usual.
+	template<typename T>
+	class SlabAllocator
+	{
+	public:
+		typedef T value_type;
+		thread_local static Utils::SlabAllocator<T> Pool;
+
+		SlabAllocator() = default;
+
+		template<typename U>
+		SlabAllocator(const SlabAllocator<U>& /*other*/)
+		{
+		}
+
+		T* allocate(size_t n)
+		{
+			if (n > 1)
+			{
+				return static_cast<T*>(std::malloc(sizeof(T) * n));
+			}
+
+#ifdef MS_ALLOCATOR_FREE_ON_RETURN
+			return static_cast<T*>(std::malloc(sizeof(T)));
+#else
+			return static_cast<T*>(GetSlabPool().Allocate());
+#endif
+		}
+
+		void deallocate(T* ptr, size_t n)
+		{
+			if (!ptr)
+			{
+				return;
+			}
+
+			if (n > 1)
+			{
+				std::free(ptr);
+				return;
+			}
+
+#ifdef MS_ALLOCATOR_FREE_ON_RETURN
+			std::free(ptr);
+#else
+			GetSlabPool().Deallocate(ptr);
+#endif
+		}
+
+		size_t GetNumSlabs() const
+		{
+			return GetSlabPool().GetNumSlabs();
+		}
+
+	private:
+		// NOTE: Template so T can be incomplete where the allocator type is named.
+		template<typename U = T>
+		static SlabPool<sizeof(U), alignof(U)>& GetSlabPool()
+		{
+			return SlabPool<sizeof(U), alignof(U)>::Instance;
+		}
+	};
+
+	template<typename T, typename U>
+	bool operator==(const SlabAllocator<T>& /*lhs*/, const SlabAllocator<U>& /*rhs*/)
+	{
+		return true;
+	}
+
+	template<typename T, typename U>
+	bool operator!=(const SlabAllocator<T>& /*lhs*/, const SlabAllocator<U>& /*rhs*/)
+	{
+		return false;
+	}
+
+	template<typename T>
+	thread_local Utils::SlabAllocator<T> Utils::SlabAllocator<T>::Pool;
+} // namespace Utils
+
+#endif
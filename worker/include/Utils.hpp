@@ -13,6 +13,7 @@
 // https://stackoverflow.com/a/24550632/2085408
 #include <intrin.h>
 #define __builtin_popcount __popcnt
+#define __builtin_popcountll __popcnt64
 #endif
 
 using json = nlohmann::json;
@@ -194,6 +195,39 @@ namespace Utils
 		{
 			return static_cast<size_t>(__builtin_popcount(mask));
 		}
+
+		static size_t CountSetBits(const uint64_t mask)
+		{
+			return static_cast<size_t>(__builtin_popcountll(mask));
+		}
+
+		// Position of the highest set bit. `value` must not be 0.
+		static uint8_t GetHighestSetBit(const uint64_t value)
+		{
+#ifdef _WIN32
+			unsigned long index; // NOLINT(google-runtime-int)
+
+			_BitScanReverse64(&index, value);
+
+			return static_cast<uint8_t>(index);
+#else
+			return static_cast<uint8_t>(63 - __builtin_clzll(value));
+#endif
+		}
+
+		// Position of the lowest set bit. `value` must not be 0.
+		static uint8_t GetLowestSetBit(const uint64_t value)
+		{
+#ifdef _WIN32
+			unsigned long index; // NOLINT(google-runtime-int)
+
+			_BitScanForward64(&index, value);
+
+			return static_cast<uint8_t>(index);
+#else
+			return static_cast<uint8_t>(__builtin_ctzll(value));
+#endif
+		}
 	};
 
 	class Crypto
@@ -202,6 +236,12 @@ namespace Utils
 		static void ClassInit();
 		static void ClassDestroy();
 
+		// Makes the generated random numbers reproducible (for benchmarks).
+		static void SetSeed(uint32_t seed)
+		{
+			Crypto::seed = seed;
+		}
+
 		static uint32_t GetRandomUInt(uint32_t min, uint32_t max)
 		{
 			// NOTE: This is the original, but produces very small values.
@@ -340,6 +380,78 @@ namespace Utils
 		}
 	};
 
+	// Histogram of latencies (nanoseconds) with logarithmic buckets, each
+	// power of two range split into SubBucketCount linear sub-buckets (as in
+	// HdrHistogram), so values are stored with a relative error lower than
+	// 1 / SubBucketCount and recording is just a few bit operations.
+	class LatencyHistogram
+	{
+	public:
+		static constexpr uint8_t SubBucketBits{ 4u };
+		static constexpr size_t SubBucketCount{ 1u << SubBucketBits };
+		// Higher values (about 68 seconds) are stored as this one.
+		static constexpr uint64_t MaxValue{ (static_cast<uint64_t>(1u) << 36) - 1 };
+		static constexpr size_t BucketCount{ (36u - SubBucketBits + 1u) * SubBucketCount };
+
+	public:
+		LatencyHistogram();
+
+	public:
+		void Record(uint64_t value, uint64_t count = 1u)
+		{
+			if (value > MaxValue)
+				value = MaxValue;
+
+			this->buckets[GetBucketIndex(value)] += count;
+			this->count += count;
+			this->sum += value * count;
+
+			if (value < this->min)
+				this->min = value;
+			if (value > this->max)
+				this->max = value;
+		}
+		void Reset();
+		uint64_t GetCount() const
+		{
+			return this->count;
+		}
+		uint64_t GetMin() const
+		{
+			return this->count != 0u ? this->min : 0u;
+		}
+		uint64_t GetMax() const
+		{
+			return this->max;
+		}
+		uint64_t GetMean() const
+		{
+			return this->count != 0u ? this->sum / this->count : 0u;
+		}
+		// Highest value equivalent to the one at the given percentile (0-100).
+		uint64_t GetValueAtPercentile(double percentile) const;
+		void FillJson(json& jsonObject) const;
+
+	private:
+		static size_t GetBucketIndex(uint64_t value)
+		{
+			if (value < SubBucketCount)
+				return static_cast<size_t>(value);
+
+			auto shift = static_cast<uint8_t>(Bits::GetHighestSetBit(value) - SubBucketBits);
+
+			return ((shift + 1u) * SubBucketCount) + ((value >> shift) & (SubBucketCount - 1));
+		}
+		static uint64_t GetBucketHighestValue(size_t index);
+
+	private:
+		std::vector<uint64_t> buckets;
+		uint64_t count{ 0u };
+		uint64_t sum{ 0u };
+		uint64_t min{ MaxValue };
+		uint64_t max{ 0u };
+	};
+
 	class Json
 	{
 	public:
@@ -72,6 +72,8 @@ public:
 	  size_t len1,
 	  const uint8_t* data2,
 	  size_t len2,
+	  const uint8_t* data3,
+	  size_t len3,
 	  RTC::Transport::onSendCallback* cb,
 	  RTC::Transport::OnSendCallbackCtx* ctx);
 	void ErrorReceiving();
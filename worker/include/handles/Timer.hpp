@@ -2,10 +2,13 @@
 #define MS_TIMER_HPP
 
 #include "common.hpp"
-#include <uv.h>
+
+class TimerWheel;
 
 class Timer
 {
+	friend class TimerWheel;
+
 public:
 	class Listener
 	{
@@ -38,22 +41,32 @@ public:
 	}
 	bool IsActive() const
 	{
-		return uv_is_active(reinterpret_cast<uv_handle_t*>(this->uvHandle)) != 0;
+		return this->active;
 	}
 
-	/* Callbacks fired by UV events. */
-public:
-	void OnUvTimer();
+private:
+	void Schedule(uint64_t timeout);
+	void SetExpectedFireTime(uint64_t timeout);
+
+	/* Callbacks fired by the TimerWheel. */
+private:
+	void OnTimerWheelExpired();
 
 private:
 	// Passed by argument.
 	Listener* listener{ nullptr };
-	// Allocated by this.
-	uv_timer_t* uvHandle{ nullptr };
 	// Others.
 	bool closed{ false };
+	bool active{ false };
 	uint64_t timeout{ 0u };
 	uint64_t repeat{ 0u };
+	// When the timer should fire (just set if LatencyStats are enabled).
+	uint64_t expectedFireTimeNs{ 0u };
+	// Intrusive list of the TimerWheel slot the timer is scheduled in.
+	Timer* wheelPrev{ nullptr };
+	Timer* wheelNext{ nullptr };
+	uint64_t wheelExpireTick{ 0u };
+	uint16_t wheelSlot{ 0u };
 };
 
 #endif
@@ -0,0 +1,83 @@
+#ifndef MS_TIMER_WHEEL_HPP
+#define MS_TIMER_WHEEL_HPP
+
+#include "common.hpp"
+#include "handles/Timer.hpp"
+#include <uv.h>
+
+// Hierarchical timer wheel running all the Timer instances of a worker on top
+// of a single uv_timer_t, so starting and stopping a Timer is O(1) regardless
+// of the number of them. Expiration times are rounded up to ticks of
+// `timerGranularity` milliseconds and timers expiring in the same tick fire
+// together.
+//
+// The first level has a slot per tick for the next 256 ticks. Each upper
+// level has 64 slots, each one spanning a full turn of the level below, and
+// its timers are moved (cascaded) to lower levels once their slot is reached.
+// Four levels cover 2^26 ticks (more than 18 hours with 1 ms ticks). Farther
+// timers wait in the last slot of the top level and are cascaded again.
+//
+// Timers started with no timeout don't wait for the next tick. They fire at
+// the end of the current expiration pass if started from a Timer listener, or
+// in the next loop iteration otherwise, as libuv timers do.
+class TimerWheel
+{
+public:
+	static void AddTimer(Timer* timer);
+	static void RemoveTimer(Timer* timer);
+	static void Schedule(Timer* timer, uint64_t timeout);
+	static void Cancel(Timer* timer);
+	static uint64_t GetGranularity()
+	{
+		return TimerWheel::granularity;
+	}
+	static size_t GetScheduledCount()
+	{
+		return TimerWheel::numScheduled;
+	}
+
+private:
+	static void Insert(Timer* timer);
+	static void InsertIntoSlot(Timer* timer, size_t slot);
+	static void Unlink(Timer* timer);
+	static void Cascade(size_t slot);
+	static void Expire(size_t slot);
+	static void ExpireDue();
+	static bool GetNextTick(uint64_t& tick);
+	static void UpdateUvTimer();
+
+	/* Callbacks fired by UV events. */
+public:
+	static void OnUvTimer();
+
+private:
+	static constexpr size_t Levels{ 4u };
+	static constexpr size_t Level0Bits{ 8u };
+	static constexpr size_t LevelBits{ 6u };
+	static constexpr size_t Level0Slots{ 1u << Level0Bits };
+	static constexpr size_t LevelSlots{ 1u << LevelBits };
+	static constexpr size_t NumSlots{ Level0Slots + ((Levels - 1) * LevelSlots) };
+	// Extra slots (out of the levels) for timers started with no timeout and
+	// for those being expired by ExpireDue().
+	static constexpr size_t DueSlot{ NumSlots };
+	static constexpr size_t ExpiringDueSlot{ NumSlots + 1u };
+
+private:
+	thread_local static uv_timer_t* uvHandle;
+	thread_local static uint64_t granularity;
+	// Number of Timer instances.
+	thread_local static size_t numTimers;
+	// Number of active Timer instances.
+	thread_local static size_t numScheduled;
+	// Last processed tick.
+	thread_local static uint64_t currentTick;
+	// Tick the uv_timer_t is started for.
+	thread_local static uint64_t uvTimerTick;
+	thread_local static bool expiring;
+	// Head of the circular list of timers of each slot.
+	thread_local static Timer* slots[NumSlots + 2u];
+	// A bit per slot, set if the slot is not empty.
+	thread_local static uint64_t slotsBitmap[(NumSlots / 64u) + 1u];
+};
+
+#endif
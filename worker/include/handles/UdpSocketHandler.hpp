@@ -5,6 +5,7 @@
 #include "RTC/Transport.hpp"
 #include <uv.h>
 #include <string>
+#include <vector>
 
 class UdpSocketHandler
 {
@@ -31,6 +32,49 @@ public:
 		RTC::Transport::OnSendCallbackCtx* ctx{ nullptr };
 	};
 
+	/* Struct for a datagram waiting in the send batch. */
+	struct SendBatchItem
+	{
+		// Enough for a full MTU RTP packet plus SRTP trailer.
+		static constexpr size_t StoreSize{ 2048u };
+
+		UdpSocketHandler* socket{ nullptr };
+		struct sockaddr_storage addr;
+		size_t len{ 0u };
+		RTC::Transport::onSendCallback* cb{ nullptr };
+		RTC::Transport::OnSendCallbackCtx* ctx{ nullptr };
+		uint8_t store[StoreSize];
+	};
+
+	/* Struct for a datagram received in a batch. */
+	struct RecvDatagram
+	{
+		const uint8_t* data;
+		size_t len;
+		const struct sockaddr* addr;
+	};
+
+	/* Struct with send batch counters of a socket. */
+	struct SendBatchStats
+	{
+		size_t batches{ 0u };
+		size_t batchedDatagrams{ 0u };
+		size_t gsoDatagrams{ 0u };
+	};
+
+public:
+	// Max number of datagrams received at once by libuv with recvmmsg().
+	static constexpr size_t RecvBatchMaxDatagrams{ 20u };
+
+public:
+	static void CreateSendBatch(size_t size);
+	static void CloseSendBatch();
+	static void FlushSendBatch();
+	static size_t GetSendBatchSize()
+	{
+		return UdpSocketHandler::sendBatchSize;
+	}
+
 public:
 	/**
 	 * uvHandle must be an already initialized and binded uv_udp_t pointer.
@@ -49,6 +93,29 @@ public:
 	virtual void Dump() const;
 	void Send(
 	  const uint8_t* data,
+	  size_t len,
+	  const struct sockaddr* addr,
+	  RTC::Transport::onSendCallback* cb,
+	  RTC::Transport::OnSendCallbackCtx* ctx)
+	{
+		Send(data, len, nullptr, 0u, addr, cb, ctx);
+	}
+	// Sends a single datagram with the given data split in two parts.
+	void Send(
+	  const uint8_t* data1,
+	  size_t len1,
+	  const uint8_t* data2,
+	  size_t len2,
+	  const struct sockaddr* addr,
+	  RTC::Transport::onSendCallback* cb,
+	  RTC::Transport::OnSendCallbackCtx* ctx);
+	/**
+	 * Returns a buffer of at least len bytes in the send batch, or nullptr if
+	 * not available. The caller must write the datagram into it and immediately
+	 * call SendBuffer().
+	 */
+	uint8_t* GetSendBuffer(size_t len);
+	void SendBuffer(
 	  size_t len,
 	  const struct sockaddr* addr,
 	  RTC::Transport::onSendCallback* cb,
@@ -77,9 +144,24 @@ public:
 	{
 		return this->sentBytes;
 	}
+	const SendBatchStats& GetSendBatchStats() const
+	{
+		return this->sendBatchStats;
+	}
 
 private:
 	bool SetLocalAddress();
+	void SendDatagram(
+	  const uint8_t* data1,
+	  size_t len1,
+	  const uint8_t* data2,
+	  size_t len2,
+	  const struct sockaddr* addr,
+	  RTC::Transport::onSendCallback* cb,
+	  RTC::Transport::OnSendCallbackCtx* ctx);
+	void SendBatchItems(SendBatchItem** items, size_t count);
+	void DropBatchItems();
+	void DeliverRecvBatch();
 
 	/* Callbacks fired by UV events. */
 public:
@@ -89,8 +171,15 @@ public:
 
 	/* Pure virtual methods that must be implemented by the subclass. */
 protected:
-	virtual void UserOnUdpDatagramReceived(
-	  const uint8_t* data, size_t len, const struct sockaddr* addr) = 0;
+	virtual void UserOnUdpDatagramsReceived(const RecvDatagram* datagrams, size_t count) = 0;
+
+private:
+	thread_local static size_t sendBatchSize;
+	thread_local static std::vector<SendBatchItem>* sendBatch;
+	thread_local static size_t sendBatchLength;
+	thread_local static bool sendBatchFlushing;
+	thread_local static uv_prepare_t* sendBatchPrepareHandle;
+	thread_local static uv_check_t* sendBatchCheckHandle;
 
 protected:
 	struct sockaddr_storage localAddr;
@@ -104,6 +193,8 @@ private:
 	bool closed{ false };
 	size_t recvBytes{ 0u };
 	size_t sentBytes{ 0u };
+	bool gsoDisabled{ false };
+	SendBatchStats sendBatchStats;
 };
 
 #endif
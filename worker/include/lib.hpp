@@ -16,3 +16,18 @@ extern "C" int mediasoup_worker_run(
   PayloadChannelReadCtx payloadChannelReadCtx,
   PayloadChannelWriteFn payloadChannelWriteFn,
   PayloadChannelWriteCtx payloadChannelWriteCtx);
+
+// Pushes a binary PayloadChannel notification (`eventId` as in
+// PayloadChannelNotification::EventId) into the ring read by the worker
+// thread. `handle` is the one given to the PayloadChannel read function. Only
+// a single thread may call it at a time. Returns 0 on success or -1 if the
+// notification does not fit, in which case it must be sent through the
+// regular PayloadChannel.
+extern "C" int mediasoup_worker_payload_channel_push(
+  const void* handle,
+  uint8_t eventId,
+  const char* handlerId,
+  uint32_t handlerIdLen,
+  uint32_t ppid,
+  const uint8_t* payload,
+  uint32_t payloadLen);
@@ -68,15 +68,11 @@ namespace Channel
 
 		MS_ASSERT(ChannelNotifier::channel, "channel unset");
 
-		std::string notification("{\"targetId\":\"");
+		json jsonNotification = json::object();
 
-		notification.append(targetId);
-		notification.append("\",\"event\":\"");
-		notification.append(event);
-		notification.append("\",\"data\":");
-		notification.append(data);
-		notification.append("}");
+		jsonNotification["targetId"] = targetId;
+		jsonNotification["event"]    = event;
 
-		ChannelNotifier::channel->Send(notification);
+		ChannelNotifier::channel->Send(jsonNotification, data);
 	}
 } // namespace Channel
@@ -4,6 +4,7 @@
 #include "Channel/ChannelRequest.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
+#include "Settings.hpp"
 #include "Utils.hpp"
 
 namespace Channel
@@ -16,6 +17,7 @@ namespace Channel
 		{ "worker.close",                                ChannelRequest::MethodId::WORKER_CLOSE                                     },
 		{ "worker.dump",                                 ChannelRequest::MethodId::WORKER_DUMP                                      },
 		{ "worker.getResourceUsage",                     ChannelRequest::MethodId::WORKER_GET_RESOURCE_USAGE                        },
+		{ "worker.getLatencyStats",                      ChannelRequest::MethodId::WORKER_GET_LATENCY_STATS                         },
 		{ "worker.updateSettings",                       ChannelRequest::MethodId::WORKER_UPDATE_SETTINGS                           },
 		{ "worker.createWebRtcServer",                   ChannelRequest::MethodId::WORKER_CREATE_WEBRTC_SERVER                      },
 		{ "worker.createRouter",                         ChannelRequest::MethodId::WORKER_CREATE_ROUTER                             },
@@ -23,6 +25,7 @@ namespace Channel
 		{ "webRtcServer.dump",                           ChannelRequest::MethodId::WEBRTC_SERVER_DUMP                               },
 		{ "worker.closeRouter",                          ChannelRequest::MethodId::WORKER_CLOSE_ROUTER                              },
 		{ "router.dump",                                 ChannelRequest::MethodId::ROUTER_DUMP                                      },
+		{ "router.getConsumersStats",                    ChannelRequest::MethodId::ROUTER_GET_CONSUMERS_STATS                       },
 		{ "router.createWebRtcTransport",                ChannelRequest::MethodId::ROUTER_CREATE_WEBRTC_TRANSPORT                   },
 		{ "router.createWebRtcTransportWithServer",      ChannelRequest::MethodId::ROUTER_CREATE_WEBRTC_TRANSPORT_WITH_SERVER       },
 		{ "router.createPlainTransport",                 ChannelRequest::MethodId::ROUTER_CREATE_PLAIN_TRANSPORT                    },
@@ -73,13 +76,27 @@ namespace Channel
 	};
 	// clang-format on
 
+	/* Class methods. */
+
+	bool ChannelRequest::IsMsgpackMap(const char* data, size_t len)
+	{
+		MS_TRACE();
+
+		if (len == 0)
+			return false;
+
+		auto byte = static_cast<uint8_t>(data[0]);
+
+		return (byte & 0xF0) == 0x80 || byte == 0xDE || byte == 0xDF;
+	}
+
 	/* Instance methods. */
 
 	/**
 	 * msg contains "id:method:handlerId:data" where:
 	 * - id: The ID of the request.
 	 * - handlerId: The ID of the target entity
-	 * - data: JSON object.
+	 * - data: JSON object, as JSON text or MessagePack.
 	 */
 	ChannelRequest::ChannelRequest(Channel::ChannelSocket* channel, const char* msg, size_t msgLen)
 	  : channel(channel)
@@ -121,14 +138,18 @@ namespace Channel
 			{
 				try
 				{
-					this->data = json::parse(data);
+					// A MessagePack map (fixmap, map 16 or map 32) instead of JSON text.
+					if (ChannelRequest::IsMsgpackMap(data.data(), data.size()))
+						this->data = json::from_msgpack(data);
+					else
+						this->data = json::parse(data);
 
 					if (!this->data.is_object())
 						this->data = json::object();
 				}
-				catch (const json::parse_error& error)
+				catch (const json::exception& error)
 				{
-					MS_THROW_TYPE_ERROR("JSON parsing error: %s", error.what());
+					MS_THROW_TYPE_ERROR("data parsing error: %s", error.what());
 				}
 			}
 		}
@@ -147,6 +168,18 @@ namespace Channel
 
 		this->replied = true;
 
+		if (Settings::configuration.channelFormat == Settings::ChannelFormat::MSGPACK)
+		{
+			json jsonResponse = json::object();
+
+			jsonResponse["id"]       = this->id;
+			jsonResponse["accepted"] = true;
+
+			this->channel->Send(jsonResponse);
+
+			return;
+		}
+
 		std::string response("{\"id\":");
 
 		response.append(std::to_string(this->id));
@@ -174,6 +207,22 @@ namespace Channel
 		this->channel->Send(jsonResponse);
 	}
 
+	void ChannelRequest::Accept(const std::string& data)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(!this->replied, "request already replied");
+
+		this->replied = true;
+
+		json jsonResponse = json::object();
+
+		jsonResponse["id"]       = this->id;
+		jsonResponse["accepted"] = true;
+
+		this->channel->Send(jsonResponse, data);
+	}
+
 	void ChannelRequest::Error(const char* reason)
 	{
 		MS_TRACE();
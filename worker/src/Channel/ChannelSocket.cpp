@@ -5,6 +5,7 @@
 #include "DepLibUV.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
+#include "Settings.hpp"
 #include <cmath>   // std::ceil()
 #include <cstdio>  // sprintf()
 #include <cstring> // std::memcpy(), std::memmove()
@@ -129,8 +130,78 @@ namespace Channel
 		if (this->closed)
 			return;
 
+		if (Settings::configuration.channelFormat == Settings::ChannelFormat::MSGPACK)
+		{
+			this->msgpackBuffer.clear();
+
+			json::to_msgpack(jsonMessage, this->msgpackBuffer);
+
+			if (this->msgpackBuffer.size() > PayloadMaxLen)
+			{
+				MS_ERROR_STD("message too big");
+
+				return;
+			}
+
+			SendImpl(this->msgpackBuffer.data(), static_cast<uint32_t>(this->msgpackBuffer.size()));
+
+			return;
+		}
+
+		std::string message = jsonMessage.dump();
+
+		if (message.length() > PayloadMaxLen)
+		{
+			MS_ERROR_STD("message too big");
+
+			return;
+		}
+
+		SendImpl(
+		  reinterpret_cast<const uint8_t*>(message.c_str()), static_cast<uint32_t>(message.length()));
+	}
+
+	void ChannelSocket::Send(json& jsonMessage, const std::string& data)
+	{
+		MS_TRACE_STD();
+
+		if (this->closed)
+			return;
+
+		if (Settings::configuration.channelFormat == Settings::ChannelFormat::MSGPACK)
+		{
+			static const uint8_t DataKey[]{ 0xA4, 'd', 'a', 't', 'a' };
+
+			this->msgpackBuffer.clear();
+
+			json::to_msgpack(jsonMessage, this->msgpackBuffer);
+
+			// The object is encoded as a fixmap, whose first byte has its number of
+			// entries, so just add one and append the "data" entry.
+			this->msgpackBuffer[0] += 1;
+			this->msgpackBuffer.insert(this->msgpackBuffer.end(), DataKey, DataKey + sizeof(DataKey));
+			this->msgpackBuffer.insert(this->msgpackBuffer.end(), data.begin(), data.end());
+
+			if (this->msgpackBuffer.size() > PayloadMaxLen)
+			{
+				MS_ERROR_STD("message too big");
+
+				return;
+			}
+
+			SendImpl(this->msgpackBuffer.data(), static_cast<uint32_t>(this->msgpackBuffer.size()));
+
+			return;
+		}
+
 		std::string message = jsonMessage.dump();
 
+		// Replace the closing brace with the "data" entry.
+		message.pop_back();
+		message.append(message.size() > 1 ? ",\"data\":" : "\"data\":");
+		message.append(data);
+		message.push_back('}');
+
 		if (message.length() > PayloadMaxLen)
 		{
 			MS_ERROR_STD("message too big");
@@ -217,8 +288,9 @@ namespace Channel
 					request->Error(error.what());
 				}
 
-				// Delete the Request.
-				delete request;
+				// Delete the Request unless its handler keeps it.
+				if (!request->deferred)
+					delete request;
 			}
 			catch (const json::parse_error& error)
 			{
@@ -283,8 +355,9 @@ namespace Channel
 				request->Error(error.what());
 			}
 
-			// Delete the Request.
-			delete request;
+			// Delete the Request unless its handler keeps it.
+			if (!request->deferred)
+				delete request;
 		}
 		catch (const json::parse_error& error)
 		{
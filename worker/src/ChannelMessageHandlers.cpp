@@ -155,7 +155,7 @@ PayloadChannel::PayloadChannelSocket::RequestHandler* ChannelMessageHandlers::Ge
 }
 
 PayloadChannel::PayloadChannelSocket::NotificationHandler* ChannelMessageHandlers::
-  GetPayloadChannelNotificationHandler(const std::string& id)
+  GetPayloadChannelNotificationHandler(absl::string_view id)
 {
 	MS_TRACE();
 
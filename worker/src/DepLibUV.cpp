@@ -3,11 +3,20 @@
 
 #include "DepLibUV.hpp"
 #include "Logger.hpp"
-#include <cstdlib> // std::abort()
+#include <algorithm> // std::max()
+#include <cstdlib>   // std::abort()
 
 /* Static variables. */
 
 thread_local uv_loop_t* DepLibUV::loop{ nullptr };
+#ifdef MS_VIRTUAL_CLOCK
+thread_local bool DepLibUV::virtualClockEnabled{ false };
+thread_local uint64_t DepLibUV::virtualTimeNs{ 0u };
+
+// The virtual clock starts at a multiple of this (so of the 64 seconds wrap of
+// abs-send-time and of the 64 ms units of transport-cc reference times).
+static constexpr uint64_t VirtualClockStartAlignmentNs{ 1024000000000u };
+#endif
 
 /* Static methods for UV callbacks. */
 
@@ -81,6 +90,33 @@ void DepLibUV::PrintVersion()
 	MS_DEBUG_TAG(info, "libuv version: \"%s\"", uv_version_string());
 }
 
+#ifdef MS_VIRTUAL_CLOCK
+void DepLibUV::EnableVirtualClock()
+{
+	MS_TRACE();
+
+	if (DepLibUV::virtualClockEnabled)
+		return;
+
+	uv_update_time(DepLibUV::loop);
+
+	auto nowNs = std::max(uv_hrtime(), uv_now(DepLibUV::loop) * 1000000u);
+
+	// Round it up so time arithmetics (timestamp wraps and so on) are the same
+	// in every run.
+	DepLibUV::virtualTimeNs =
+	  (nowNs / VirtualClockStartAlignmentNs + 1u) * VirtualClockStartAlignmentNs;
+	DepLibUV::virtualClockEnabled = true;
+}
+
+void DepLibUV::DisableVirtualClock()
+{
+	MS_TRACE();
+
+	DepLibUV::virtualClockEnabled = false;
+}
+#endif
+
 void DepLibUV::RunLoop()
 {
 	MS_TRACE();
@@ -0,0 +1,134 @@
+#define MS_CLASS "LatencyStats"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "LatencyStats.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+
+/* Static variables. */
+
+thread_local bool LatencyStats::enabled{ false };
+thread_local std::vector<Utils::LatencyHistogram> LatencyStats::histograms(LatencyStats::StageCount);
+thread_local uv_check_t* LatencyStats::uvCheckHandle{ nullptr };
+thread_local uint64_t LatencyStats::lastCheckNs{ 0u };
+thread_local uint64_t LatencyStats::lastIdleNs{ 0u };
+
+// clang-format off
+static const char* StageNames[] =
+{
+	"udpRecv",
+	"srtpDecrypt",
+	"producerReceive",
+	"routerFanout",
+	"consumerSend",
+	"srtpEncrypt",
+	"socketSend",
+	"loopIteration",
+	"timerLag"
+};
+// clang-format on
+
+static_assert(
+  sizeof(StageNames) / sizeof(StageNames[0]) == LatencyStats::StageCount,
+  "wrong number of stage names");
+
+/* Static methods for UV callbacks. */
+
+inline static void onCheck(uv_check_t* /*handle*/)
+{
+	LatencyStats::OnUvCheck();
+}
+
+inline static void onClose(uv_handle_t* handle)
+{
+	delete reinterpret_cast<uv_check_t*>(handle);
+}
+
+/* Class methods. */
+
+void LatencyStats::SetEnabled(bool enabled)
+{
+	MS_TRACE();
+
+	if (enabled == LatencyStats::enabled)
+		return;
+
+	if (enabled)
+	{
+		// Needed for uv_metrics_idle_time(). It cannot be unset later.
+		int err = uv_loop_configure(DepLibUV::GetLoop(), UV_METRICS_IDLE_TIME);
+
+		if (err != 0)
+			MS_THROW_ERROR("uv_loop_configure() failed: %s", uv_strerror(err));
+
+		LatencyStats::uvCheckHandle = new uv_check_t;
+
+		uv_check_init(DepLibUV::GetLoop(), LatencyStats::uvCheckHandle);
+		uv_check_start(LatencyStats::uvCheckHandle, static_cast<uv_check_cb>(onCheck));
+		// Do not keep the loop alive.
+		uv_unref(reinterpret_cast<uv_handle_t*>(LatencyStats::uvCheckHandle));
+
+		LatencyStats::lastCheckNs = 0u;
+
+		LatencyStats::Reset();
+	}
+	else
+	{
+		uv_close(
+		  reinterpret_cast<uv_handle_t*>(LatencyStats::uvCheckHandle), static_cast<uv_close_cb>(onClose));
+
+		LatencyStats::uvCheckHandle = nullptr;
+	}
+
+	LatencyStats::enabled = enabled;
+}
+
+void LatencyStats::Reset()
+{
+	MS_TRACE();
+
+	for (auto& histogram : LatencyStats::histograms)
+	{
+		histogram.Reset();
+	}
+}
+
+void LatencyStats::FillJson(json& jsonObject)
+{
+	MS_TRACE();
+
+	jsonObject["enabled"] = LatencyStats::enabled;
+
+	// Add stages.
+	jsonObject["stages"] = json::object();
+	auto jsonStagesIt    = jsonObject.find("stages");
+
+	for (size_t idx{ 0u }; idx < LatencyStats::StageCount; ++idx)
+	{
+		json jsonStage = json::object();
+
+		LatencyStats::histograms[idx].FillJson(jsonStage);
+
+		(*jsonStagesIt)[StageNames[idx]] = jsonStage;
+	}
+}
+
+inline void LatencyStats::OnUvCheck()
+{
+	// Called once per loop iteration, right after polling for I/O (and running
+	// its callbacks). Time since the previous call minus the time blocked in
+	// the poll is the time the loop was busy.
+	auto nowNs  = DepLibUV::GetTimeNs();
+	auto idleNs = uv_metrics_idle_time(DepLibUV::GetLoop());
+
+	if (LatencyStats::lastCheckNs != 0u)
+	{
+		auto elapsedNs = nowNs - LatencyStats::lastCheckNs;
+		auto idleDelta = idleNs - LatencyStats::lastIdleNs;
+
+		LatencyStats::Record(Stage::LOOP_ITERATION, elapsedNs > idleDelta ? elapsedNs - idleDelta : 0u);
+	}
+
+	LatencyStats::lastCheckNs = nowNs;
+	LatencyStats::lastIdleNs  = idleNs;
+}
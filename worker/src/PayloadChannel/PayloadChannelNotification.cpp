@@ -17,6 +17,12 @@ namespace PayloadChannel
 		{ "producer.send",      PayloadChannelNotification::EventId::PRODUCER_SEND       },
 		{ "dataProducer.send",  PayloadChannelNotification::EventId::DATA_PRODUCER_SEND  }
 	};
+	absl::flat_hash_map<uint8_t, std::pair<PayloadChannelNotification::EventId, std::string>> PayloadChannelNotification::id2Event =
+	{
+		{ 1u, { PayloadChannelNotification::EventId::TRANSPORT_SEND_RTCP, "transport.sendRtcp" } },
+		{ 2u, { PayloadChannelNotification::EventId::PRODUCER_SEND,       "producer.send"      } },
+		{ 3u, { PayloadChannelNotification::EventId::DATA_PRODUCER_SEND,  "dataProducer.send"  } }
+	};
 	// clang-format on
 
 	/* Class methods. */
@@ -53,7 +59,10 @@ namespace PayloadChannel
 			auto& handlerId = info[1];
 
 			if (handlerId != "undefined")
-				this->handlerId = handlerId;
+			{
+				this->handlerIdStorage = handlerId;
+				this->handlerId        = this->handlerIdStorage;
+			}
 		}
 
 		if (info.size() > 2)
@@ -63,6 +72,21 @@ namespace PayloadChannel
 			if (data != "undefined")
 				this->data = data;
 		}
+
+		if (this->eventId == EventId::DATA_PRODUCER_SEND)
+		{
+			// This may throw.
+			// NOTE: If this throws we have to catch the error and throw a MediaSoupError
+			// intead, otherwise the process would crash.
+			try
+			{
+				this->ppid = static_cast<uint32_t>(std::stoul(this->data));
+			}
+			catch (const std::exception& error)
+			{
+				MS_THROW_TYPE_ERROR("invalid PPID value: %s", error.what());
+			}
+		}
 	}
 
 	PayloadChannelNotification::~PayloadChannelNotification()
@@ -70,6 +94,30 @@ namespace PayloadChannel
 		MS_TRACE();
 	}
 
+	void PayloadChannelNotification::Fill(
+	  uint8_t eventId,
+	  const char* handlerId,
+	  size_t handlerIdLen,
+	  uint32_t ppid,
+	  const uint8_t* payload,
+	  size_t payloadLen)
+	{
+		MS_TRACE();
+
+		auto eventIt = PayloadChannelNotification::id2Event.find(eventId);
+
+		if (eventIt == PayloadChannelNotification::id2Event.end())
+			MS_THROW_ERROR("unknown event id %" PRIu8, eventId);
+
+		this->eventId   = eventIt->second.first;
+		this->event     = eventIt->second.second;
+		this->handlerId = absl::string_view(handlerId, handlerIdLen);
+		this->ppid      = ppid;
+
+		this->payload    = payload;
+		this->payloadLen = payloadLen;
+	}
+
 	void PayloadChannelNotification::SetPayload(const uint8_t* payload, size_t payloadLen)
 	{
 		MS_TRACE();
@@ -36,6 +36,29 @@ namespace PayloadChannel
 		PayloadChannelNotifier::payloadChannel->Send(notification, payload, payloadLen);
 	}
 
+	void PayloadChannelNotifier::Emit(
+	  const std::string& targetId,
+	  const char* event,
+	  const uint8_t* payload1,
+	  size_t payload1Len,
+	  const uint8_t* payload2,
+	  size_t payload2Len)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(PayloadChannelNotifier::payloadChannel, "payloadChannel unset");
+
+		std::string notification("{\"targetId\":\"");
+
+		notification.append(targetId);
+		notification.append("\",\"event\":\"");
+		notification.append(event);
+		notification.append("}");
+
+		PayloadChannelNotifier::payloadChannel->Send(
+		  notification, payload1, payload1Len, payload2, payload2Len);
+	}
+
 	void PayloadChannelNotifier::Emit(
 	  const std::string& targetId, const char* event, json& data, const uint8_t* payload, size_t payloadLen)
 	{
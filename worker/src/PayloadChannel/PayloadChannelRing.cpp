@@ -0,0 +1,158 @@
+#define MS_CLASS "PayloadChannel::PayloadChannelRing"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "PayloadChannel/PayloadChannelRing.hpp"
+#include "Logger.hpp"
+#include <cstdlib> // std::malloc(), std::free()
+#include <cstring> // std::memcpy()
+
+namespace PayloadChannel
+{
+	/* Instance methods. */
+
+	PayloadChannelRing::PayloadChannelRing(size_t capacity) : capacity(capacity)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(
+		  capacity >= 4096u && (capacity & (capacity - 1)) == 0u,
+		  "capacity must be a power of two not lower than 4096");
+
+		this->buffer = static_cast<uint8_t*>(std::malloc(capacity));
+	}
+
+	PayloadChannelRing::~PayloadChannelRing()
+	{
+		MS_TRACE();
+
+		std::free(this->buffer);
+	}
+
+	bool PayloadChannelRing::Push(
+	  uint8_t eventId,
+	  const char* handlerId,
+	  size_t handlerIdLen,
+	  uint32_t ppid,
+	  const uint8_t* payload,
+	  size_t payloadLen)
+	{
+		// NOTE: Called from the host thread, so no logging here.
+
+		if (eventId == 0u || handlerIdLen > HandlerIdMaxLen)
+			return false;
+
+		size_t frameLen = sizeof(FrameHeader) + handlerIdLen + payloadLen;
+
+		frameLen = (frameLen + FrameAlignment - 1) / FrameAlignment * FrameAlignment;
+
+		// Let a frame use at most half of the ring so skipping the end of the
+		// buffer always leaves room for it once the ring is drained.
+		if (frameLen > this->capacity / 2)
+			return false;
+
+		uint64_t writePos = this->writePos.load(std::memory_order_relaxed);
+		size_t offset     = static_cast<size_t>(writePos & (this->capacity - 1));
+		size_t untilEnd   = this->capacity - offset;
+		// Bytes to skip at the end of the buffer.
+		size_t skipLen = frameLen > untilEnd ? untilEnd : 0u;
+
+		if (writePos + skipLen + frameLen - this->cachedReadPos > this->capacity)
+		{
+			this->cachedReadPos = this->readPos.load(std::memory_order_acquire);
+
+			if (writePos + skipLen + frameLen - this->cachedReadPos > this->capacity)
+				return false;
+		}
+
+		if (skipLen != 0u)
+		{
+			FrameHeader skipHeader{};
+
+			skipHeader.frameLen = static_cast<uint32_t>(skipLen);
+
+			std::memcpy(this->buffer + offset, &skipHeader, sizeof(FrameHeader));
+
+			writePos += skipLen;
+			offset = 0u;
+		}
+
+		FrameHeader header{};
+
+		header.frameLen     = static_cast<uint32_t>(frameLen);
+		header.payloadLen   = static_cast<uint32_t>(payloadLen);
+		header.ppid         = ppid;
+		header.eventId      = eventId;
+		header.handlerIdLen = static_cast<uint8_t>(handlerIdLen);
+
+		auto* ptr = this->buffer + offset;
+
+		std::memcpy(ptr, &header, sizeof(FrameHeader));
+		ptr += sizeof(FrameHeader);
+
+		if (handlerIdLen != 0u)
+		{
+			std::memcpy(ptr, handlerId, handlerIdLen);
+			ptr += handlerIdLen;
+		}
+
+		if (payloadLen != 0u)
+			std::memcpy(ptr, payload, payloadLen);
+
+		// Publish the frame.
+		this->writePos.store(writePos + frameLen, std::memory_order_release);
+
+		return true;
+	}
+
+	bool PayloadChannelRing::Front(Frame& frame)
+	{
+		MS_TRACE();
+
+		uint64_t readPos  = this->readPos.load(std::memory_order_relaxed);
+		uint64_t writePos = this->writePos.load(std::memory_order_acquire);
+
+		while (readPos != writePos)
+		{
+			const auto* ptr = this->buffer + static_cast<size_t>(readPos & (this->capacity - 1));
+			FrameHeader header;
+
+			std::memcpy(&header, ptr, sizeof(FrameHeader));
+
+			// Skip the end of the buffer.
+			if (header.eventId == 0u)
+			{
+				readPos += header.frameLen;
+
+				this->readPos.store(readPos, std::memory_order_release);
+
+				continue;
+			}
+
+			frame.eventId      = header.eventId;
+			frame.handlerId    = reinterpret_cast<const char*>(ptr + sizeof(FrameHeader));
+			frame.handlerIdLen = header.handlerIdLen;
+			frame.ppid         = header.ppid;
+			frame.payload      = ptr + sizeof(FrameHeader) + header.handlerIdLen;
+			frame.payloadLen   = header.payloadLen;
+
+			this->frontFrameLen = header.frameLen;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void PayloadChannelRing::Pop()
+	{
+		MS_TRACE();
+
+		MS_ASSERT(this->frontFrameLen != 0u, "no frame to pop");
+
+		// Let the producer reuse the frame memory.
+		this->readPos.store(
+		  this->readPos.load(std::memory_order_relaxed) + this->frontFrameLen, std::memory_order_release);
+
+		this->frontFrameLen = 0u;
+	}
+} // namespace PayloadChannel
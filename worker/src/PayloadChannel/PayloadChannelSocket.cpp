@@ -20,10 +20,13 @@ namespace PayloadChannel
 
 	inline static void onAsync(uv_handle_t* handle)
 	{
-		while (static_cast<PayloadChannelSocket*>(handle->data)->CallbackRead())
+		auto* payloadChannel = static_cast<PayloadChannelSocket*>(handle->data);
+
+		// Read while there are new messages, binary frames first.
+		do
 		{
-			// Read while there are new messages.
-		}
+			payloadChannel->ReadRing();
+		} while (payloadChannel->CallbackRead());
 	}
 
 	inline static void onClose(uv_handle_t* handle)
@@ -47,7 +50,9 @@ namespace PayloadChannel
 	  PayloadChannelWriteFn payloadChannelWriteFn,
 	  PayloadChannelWriteCtx payloadChannelWriteCtx)
 	  : payloadChannelReadFn(payloadChannelReadFn), payloadChannelReadCtx(payloadChannelReadCtx),
-	    payloadChannelWriteFn(payloadChannelWriteFn), payloadChannelWriteCtx(payloadChannelWriteCtx)
+	    payloadChannelWriteFn(payloadChannelWriteFn), payloadChannelWriteCtx(payloadChannelWriteCtx),
+	    ring(new PayloadChannel::PayloadChannelRing()),
+	    ringNotification(new PayloadChannel::PayloadChannelNotification())
 	{
 		MS_TRACE();
 
@@ -84,6 +89,8 @@ namespace PayloadChannel
 
 		std::free(this->writeBuffer);
 		delete this->ongoingNotification;
+		delete this->ringNotification;
+		delete this->ring;
 
 		if (!this->closed)
 			Close();
@@ -163,6 +170,65 @@ namespace PayloadChannel
 		  static_cast<uint32_t>(payloadLen));
 	}
 
+	void PayloadChannelSocket::Send(
+	  const std::string& message,
+	  const uint8_t* payload1,
+	  size_t payload1Len,
+	  const uint8_t* payload2,
+	  size_t payload2Len)
+	{
+		MS_TRACE();
+
+		if (this->closed)
+			return;
+
+		const size_t payloadLen = payload1Len + payload2Len;
+
+		if (message.length() > PayloadMaxLen)
+		{
+			MS_ERROR("message too big");
+
+			return;
+		}
+		else if (payloadLen > PayloadMaxLen)
+		{
+			MS_ERROR("payload too big");
+
+			return;
+		}
+
+		// The write function takes the payload in a single buffer, so join it.
+		if (this->payloadChannelWriteFn)
+		{
+			if (!this->writeBuffer)
+				this->writeBuffer = static_cast<uint8_t*>(std::malloc(MessageMaxLen));
+
+			std::memcpy(this->writeBuffer, payload1, payload1Len);
+			std::memcpy(this->writeBuffer + payload1Len, payload2, payload2Len);
+
+			this->payloadChannelWriteFn(
+			  reinterpret_cast<const uint8_t*>(message.c_str()),
+			  static_cast<uint32_t>(message.length()),
+			  this->writeBuffer,
+			  static_cast<uint32_t>(payloadLen),
+			  this->payloadChannelWriteCtx);
+		}
+		// Otherwise write both parts into the frame of the payload.
+		else
+		{
+			SendImpl(
+			  reinterpret_cast<const uint8_t*>(message.c_str()), static_cast<uint32_t>(message.length()));
+
+			auto len = static_cast<uint32_t>(payloadLen);
+
+			std::memcpy(this->writeBuffer, &len, sizeof(uint32_t));
+			std::memcpy(this->writeBuffer + sizeof(uint32_t), payload1, payload1Len);
+			std::memcpy(this->writeBuffer + sizeof(uint32_t) + payload1Len, payload2, payload2Len);
+
+			this->producerSocket->Write(this->writeBuffer, sizeof(uint32_t) + payloadLen);
+		}
+	}
+
 	void PayloadChannelSocket::Send(json& jsonMessage)
 	{
 		MS_TRACE_STD();
@@ -325,6 +391,61 @@ namespace PayloadChannel
 		return free != nullptr;
 	}
 
+	bool PayloadChannelSocket::PushToRing(
+	  uint8_t eventId,
+	  const char* handlerId,
+	  size_t handlerIdLen,
+	  uint32_t ppid,
+	  const uint8_t* payload,
+	  size_t payloadLen)
+	{
+		// NOTE: Called from the host thread, so no logging here.
+
+		if (!this->ring)
+			return false;
+
+		if (!this->ring->Push(eventId, handlerId, handlerIdLen, ppid, payload, payloadLen))
+			return false;
+
+		// Wake up the worker thread. Calls are coalesced by libuv.
+		uv_async_send(this->uvReadHandle);
+
+		return true;
+	}
+
+	void PayloadChannelSocket::ReadRing()
+	{
+		MS_TRACE();
+
+		if (!this->ring)
+			return;
+
+		PayloadChannelRing::Frame frame;
+
+		while (!this->closed && this->ring->Front(frame))
+		{
+			try
+			{
+				this->ringNotification->Fill(
+				  frame.eventId,
+				  frame.handlerId,
+				  frame.handlerIdLen,
+				  frame.ppid,
+				  frame.payload,
+				  frame.payloadLen);
+
+				// Notify the listener.
+				this->listener->HandleNotification(this->ringNotification);
+			}
+			catch (const MediaSoupError& error)
+			{
+				MS_ERROR("notification failed: %s", error.what());
+			}
+
+			this->ring->Pop();
+		}
+	}
+
 	inline void PayloadChannelSocket::SendImpl(const uint8_t* message, uint32_t messageLen)
 	{
 		MS_TRACE();
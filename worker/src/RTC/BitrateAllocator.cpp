@@ -0,0 +1,206 @@
+#define MS_CLASS "RTC::BitrateAllocator"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "RTC/BitrateAllocator.hpp"
+#include "Logger.hpp"
+#include <algorithm> // std::lower_bound(), std::upper_bound(), std::find_if()
+
+namespace RTC
+{
+	/* Instance methods. */
+
+	void BitrateAllocator::AddParticipant(Participant* participant)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(
+		  this->mapParticipantEntry.find(participant) == this->mapParticipantEntry.end(),
+		  "participant already added");
+
+		// Its priority will be taken in the next UpdatePriorities().
+		auto& entry = this->mapParticipantEntry[participant];
+
+		entry.order = this->nextOrder++;
+	}
+
+	void BitrateAllocator::RemoveParticipant(Participant* participant)
+	{
+		MS_TRACE();
+
+		auto it = this->mapParticipantEntry.find(participant);
+
+		if (it == this->mapParticipantEntry.end())
+			return;
+
+		auto& entry = it->second;
+
+		if (entry.priority > 0u)
+			RemoveFromBucket(participant, entry.priority);
+
+		this->mapParticipantEntry.erase(it);
+	}
+
+	void BitrateAllocator::Clear()
+	{
+		MS_TRACE();
+
+		this->mapParticipantEntry.clear();
+		this->buckets.clear();
+		this->numPrioritizedParticipants = 0u;
+	}
+
+	void BitrateAllocator::UpdatePriorities()
+	{
+		MS_TRACE();
+
+		for (auto& kv : this->mapParticipantEntry)
+		{
+			auto* participant = kv.first;
+			auto& entry       = kv.second;
+			auto priority     = participant->GetBitratePriority();
+
+			if (priority == entry.priority)
+				continue;
+
+			MS_DEBUG_DEV(
+			  "participant priority changed [before:%" PRIu8 ", now:%" PRIu8 "]",
+			  entry.priority,
+			  priority);
+
+			if (entry.priority > 0u)
+				RemoveFromBucket(participant, entry.priority);
+
+			if (priority > 0u)
+				AddToBucket(participant, priority, entry.order);
+
+			entry.priority = priority;
+		}
+	}
+
+	uint32_t BitrateAllocator::Distribute(uint32_t availableBitrate, bool considerLoss)
+	{
+		MS_TRACE();
+
+		bool baseAllocation{ true };
+
+		// Redistribute the available bitrate by allowing participants to increase
+		// layer by layer. Initially try to spread the bitrate across all
+		// participants. Then allocate the excess bitrate to participants starting
+		// with the highest priorty.
+		while (availableBitrate > 0u)
+		{
+			auto previousAvailableBitrate = availableBitrate;
+
+			for (auto& bucket : this->buckets)
+			{
+				for (auto& item : bucket.items)
+				{
+					// The bitrate given to a participant only decreases in later rounds
+					// so a participant that didn't take it won't take it anymore.
+					if (item.exhausted)
+						continue;
+
+					for (uint8_t i{ 1u }; i <= (baseAllocation ? 1u : bucket.priority); ++i)
+					{
+						auto usedBitrate = item.participant->IncreaseLayer(availableBitrate, considerLoss);
+
+						MS_ASSERT(usedBitrate <= availableBitrate, "participant used more bitrate than given");
+
+						availableBitrate -= usedBitrate;
+
+						// Exit the loop fast if used bitrate is 0.
+						if (usedBitrate == 0u)
+						{
+							item.exhausted = true;
+
+							break;
+						}
+					}
+				}
+			}
+
+			// If no participant used bitrate, exit the loop.
+			if (availableBitrate == previousAvailableBitrate)
+				break;
+
+			baseAllocation = false;
+		}
+
+		// Finally instruct participants to apply their computed layers.
+		for (auto& bucket : this->buckets)
+		{
+			for (auto& item : bucket.items)
+			{
+				item.exhausted = false;
+
+				item.participant->ApplyLayers();
+			}
+		}
+
+		return availableBitrate;
+	}
+
+	void BitrateAllocator::AddToBucket(Participant* participant, uint8_t priority, uint64_t order)
+	{
+		MS_TRACE();
+
+		auto bucketIt = std::lower_bound(
+		  this->buckets.begin(),
+		  this->buckets.end(),
+		  priority,
+		  [](const Bucket& bucket, uint8_t priority)
+		  {
+			  return bucket.priority > priority;
+		  });
+
+		if (bucketIt == this->buckets.end() || bucketIt->priority != priority)
+			bucketIt = this->buckets.emplace(bucketIt, priority);
+
+		auto& items = bucketIt->items;
+		auto itemIt = std::upper_bound(
+		  items.begin(),
+		  items.end(),
+		  order,
+		  [](uint64_t order, const Item& item)
+		  {
+			  return order < item.order;
+		  });
+
+		items.emplace(itemIt, participant, order);
+
+		this->numPrioritizedParticipants++;
+	}
+
+	void BitrateAllocator::RemoveFromBucket(Participant* participant, uint8_t priority)
+	{
+		MS_TRACE();
+
+		auto bucketIt = std::lower_bound(
+		  this->buckets.begin(),
+		  this->buckets.end(),
+		  priority,
+		  [](const Bucket& bucket, uint8_t priority)
+		  {
+			  return bucket.priority > priority;
+		  });
+
+		MS_ASSERT(
+		  bucketIt != this->buckets.end() && bucketIt->priority == priority,
+		  "priority bucket not found");
+
+		auto& items = bucketIt->items;
+		auto itemIt = std::find_if(
+		  items.begin(),
+		  items.end(),
+		  [participant](const Item& item)
+		  {
+			  return item.participant == participant;
+		  });
+
+		MS_ASSERT(itemIt != items.end(), "participant not found in its priority bucket");
+
+		items.erase(itemIt);
+
+		this->numPrioritizedParticipants--;
+	}
+} // namespace RTC
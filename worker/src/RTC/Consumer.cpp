@@ -441,6 +441,17 @@ namespace RTC
 		this->producerRtpStreamScores = scores;
 	}
 
+	// The given packet history (owned by the Router) must outlive this Consumer.
+	void Consumer::ProducerRtpPacketHistory(RTC::RtpPacketHistory* packetHistory)
+	{
+		MS_TRACE();
+
+		for (auto* rtpStream : GetRtpStreams())
+		{
+			rtpStream->SetRtpPacketHistory(packetHistory);
+		}
+	}
+
 	// The caller (Router) is supposed to proceed with the deletion of this Consumer
 	// right after calling this method. Otherwise ugly things may happen.
 	void Consumer::ProducerClosed()
@@ -165,20 +165,7 @@ namespace RTC
 		{
 			case PayloadChannel::PayloadChannelNotification::EventId::DATA_PRODUCER_SEND:
 			{
-				int ppid;
-
-				// This may throw.
-				// NOTE: If this throws we have to catch the error and throw a MediaSoupError
-				// intead, otherwise the process would crash.
-				try
-				{
-					ppid = std::stoi(notification->data);
-				}
-				catch (const std::exception& error)
-				{
-					MS_THROW_TYPE_ERROR("invalid PPID value: %s", error.what());
-				}
-
+				auto ppid       = notification->ppid;
 				const auto* msg = notification->payload;
 				auto len        = notification->payloadLen;
 
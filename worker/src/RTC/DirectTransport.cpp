@@ -17,12 +17,27 @@ namespace RTC
 	{
 		MS_TRACE();
 
+		auto jsonEnableRtcpReportsIt = data.find("enableRtcpReports");
+
+		if (jsonEnableRtcpReportsIt != data.end())
+		{
+			if (!jsonEnableRtcpReportsIt->is_boolean())
+				MS_THROW_TYPE_ERROR("wrong enableRtcpReports (not a boolean)");
+
+			this->enableRtcpReports = jsonEnableRtcpReportsIt->get<bool>();
+		}
+
 		// NOTE: This may throw.
 		ChannelMessageHandlers::RegisterHandler(
 		  this->id,
 		  /*channelRequestHandler*/ this,
 		  /*payloadChannelRequestHandler*/ this,
 		  /*payloadChannelNotificationHandler*/ this);
+
+		// Periodic RTCP (Sender and Receiver Reports) is otherwise left to the
+		// application, so just start it if requested.
+		if (this->enableRtcpReports)
+			RTC::Transport::Connected();
 	}
 
 	DirectTransport::~DirectTransport()
@@ -118,7 +133,9 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		if (!consumer)
+		// Probation RTP packets are only sent if RTCP reports are enabled, since
+		// otherwise the outgoing bitrate can not be estimated.
+		if (!consumer && !this->enableRtcpReports)
 		{
 			MS_WARN_TAG(rtp, "cannot send RTP packet not associated to a Consumer");
 
@@ -130,11 +147,20 @@ namespace RTC
 			return;
 		}
 
-		const uint8_t* data = packet->GetData();
-		size_t len          = packet->GetSize();
-
-		// Notify the Node DirectTransport.
-		PayloadChannel::PayloadChannelNotifier::Emit(consumer->id, "rtp", data, len);
+		const size_t headerLength = packet->GetSerializedHeaderLength();
+		size_t len                = packet->GetSize();
+
+		// Notify the Node DirectTransport. RTP packets not associated to a
+		// Consumer (probation) are notified with the id of the transport. The
+		// header is given apart so the payload is not copied to apply the header
+		// overlay.
+		PayloadChannel::PayloadChannelNotifier::Emit(
+		  consumer ? consumer->id : this->id,
+		  "rtp",
+		  packet->GetSerializedHeader(),
+		  headerLength,
+		  packet->GetData() + headerLength,
+		  len - headerLength);
 
 		if (cb)
 		{
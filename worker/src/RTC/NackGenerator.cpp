@@ -4,9 +4,10 @@
 #include "RTC/NackGenerator.hpp"
 #include "DepLibUV.hpp"
 #include "Logger.hpp"
+#include "Utils.hpp"
 #include <iterator> // std::ostream_iterator
 #include <sstream>  // std::ostringstream
-#include <utility>  // std::make_pair()
+#include <utility>  // std::move()
 
 namespace RTC
 {
@@ -51,7 +52,7 @@ namespace RTC
 			this->lastSeq = seq;
 
 			if (isKeyFrame)
-				this->keyFrameList.insert(seq);
+				this->keyFrameList.Insert(seq);
 
 			return false;
 		}
@@ -64,10 +65,8 @@ namespace RTC
 		// or a retransmitted packet.
 		if (SeqManager<uint16_t>::IsSeqLowerThan(seq, this->lastSeq))
 		{
-			auto it = this->nackList.find(seq);
-
 			// It was a nacked packet.
-			if (it != this->nackList.end())
+			if (this->nackList.Contains(seq))
 			{
 				MS_DEBUG_DEV(
 				  "NACKed packet received [ssrc:%" PRIu32 ", seq:%" PRIu16 ", recovered:%s]",
@@ -75,9 +74,9 @@ namespace RTC
 				  packet->GetSequenceNumber(),
 				  isRecovered ? "true" : "false");
 
-				auto retries = it->second.retries;
+				auto retries = GetNackItem(seq).retries;
 
-				this->nackList.erase(it);
+				this->nackList.Erase(seq);
 
 				if (retries != 0)
 					return true;
@@ -101,25 +100,17 @@ namespace RTC
 		// newer than the latest seq seen.
 
 		if (isKeyFrame)
-			this->keyFrameList.insert(seq);
+			this->keyFrameList.Insert(seq);
 
 		// Remove old keyframes.
-		{
-			auto it = this->keyFrameList.lower_bound(seq - MaxPacketAge);
-
-			if (it != this->keyFrameList.begin())
-				this->keyFrameList.erase(this->keyFrameList.begin(), it);
-		}
+		this->keyFrameList.EraseLowerThan(static_cast<uint16_t>(seq - MaxPacketAge));
 
 		if (isRecovered)
 		{
-			this->recoveredList.insert(seq);
+			this->recoveredList.Insert(seq);
 
 			// Remove old ones so we don't accumulate recovered packets.
-			auto it = this->recoveredList.lower_bound(seq - MaxPacketAge);
-
-			if (it != this->recoveredList.begin())
-				this->recoveredList.erase(this->recoveredList.begin(), it);
+			this->recoveredList.EraseLowerThan(static_cast<uint16_t>(seq - MaxPacketAge));
 
 			// Do not let a packet pass if it's newer than last seen seq and came via
 			// RTX.
@@ -149,76 +140,107 @@ namespace RTC
 		MS_TRACE();
 
 		// Remove old packets.
-		auto it = this->nackList.lower_bound(seqEnd - MaxPacketAge);
-
-		this->nackList.erase(this->nackList.begin(), it);
+		this->nackList.EraseLowerThan(static_cast<uint16_t>(seqEnd - MaxPacketAge));
 
 		// If the nack list is too large, remove packets from the nack list until
 		// the latest first packet of a keyframe. If the list is still too large,
 		// clear it and request a keyframe.
 		uint16_t numNewNacks = seqEnd - seqStart;
 
-		if (static_cast<uint16_t>(this->nackList.size()) + numNewNacks > MaxNackPackets)
+		if (static_cast<uint16_t>(this->nackList.GetSize()) + numNewNacks > MaxNackPackets)
 		{
 			// clang-format off
 			while (
 				RemoveNackItemsUntilKeyFrame() &&
-				static_cast<uint16_t>(this->nackList.size()) + numNewNacks > MaxNackPackets
+				static_cast<uint16_t>(this->nackList.GetSize()) + numNewNacks > MaxNackPackets
 			)
 			// clang-format on
 			{
 			}
 
-			if (static_cast<uint16_t>(this->nackList.size()) + numNewNacks > MaxNackPackets)
+			if (static_cast<uint16_t>(this->nackList.GetSize()) + numNewNacks > MaxNackPackets)
 			{
 				MS_WARN_TAG(
 				  rtx, "NACK list full, clearing it and requesting a key frame [seqEnd:%" PRIu16 "]", seqEnd);
 
-				this->nackList.clear();
+				this->nackList.Clear();
 				this->listener->OnNackGeneratorKeyFrameRequired();
 
 				return;
 			}
 		}
 
+		auto nowMs = static_cast<uint32_t>(DepLibUV::GetTimeMs());
+
 		for (uint16_t seq = seqStart; seq != seqEnd; ++seq)
 		{
-			MS_ASSERT(this->nackList.find(seq) == this->nackList.end(), "packet already in the NACK list");
+			MS_ASSERT(!this->nackList.Contains(seq), "packet already in the NACK list");
 
 			// Do not send NACK for packets that are already recovered by RTX.
-			if (this->recoveredList.find(seq) != this->recoveredList.end())
+			if (this->recoveredList.Contains(seq))
 				continue;
 
-			this->nackList.emplace(std::make_pair(
-			  seq,
-			  NackInfo{
-			    DepLibUV::GetTimeMs(),
-			    seq,
-			    seq,
-			  }));
+			auto& nackInfo = AddNackItem(seq);
+
+			nackInfo.createdAtMs = nowMs;
+			nackInfo.sentAtMs    = 0u;
+			nackInfo.retries     = 0u;
 		}
 	}
 
-	bool NackGenerator::RemoveNackItemsUntilKeyFrame()
+	NackGenerator::NackInfo& NackGenerator::AddNackItem(uint16_t seq)
 	{
 		MS_TRACE();
 
-		while (!this->keyFrameList.empty())
+		auto capacity = this->nackList.GetCapacity();
+
+		this->nackList.Insert(seq);
+
+		// The ring has grown, so move items to their new positions.
+		if (this->nackList.GetCapacity() != capacity)
 		{
-			auto it = this->nackList.lower_bound(*this->keyFrameList.begin());
+			std::vector<NackInfo> nackItems(this->nackList.GetCapacity());
+			uint16_t itemSeq;
+
+			if (capacity != 0u)
+			{
+				for (bool found = this->nackList.GetFirst(itemSeq); found;
+				     found      = this->nackList.GetNext(itemSeq))
+				{
+					nackItems[itemSeq & (nackItems.size() - 1)] =
+					  this->nackItems[itemSeq & (capacity - 1)];
+				}
+			}
+
+			this->nackItems = std::move(nackItems);
+		}
+
+		return GetNackItem(seq);
+	}
+
+	bool NackGenerator::RemoveNackItemsUntilKeyFrame()
+	{
+		MS_TRACE();
 
-			if (it != this->nackList.begin())
+		uint16_t keyFrameSeq;
+		uint16_t firstNackSeq;
+
+		while (this->keyFrameList.GetFirst(keyFrameSeq))
+		{
+			if (
+			  this->nackList.GetFirst(firstNackSeq) &&
+			  SeqManager<uint16_t>::IsSeqLowerThan(firstNackSeq, keyFrameSeq))
 			{
 				// We have found a keyframe that actually is newer than at least one
 				// packet in the nack list.
-				this->nackList.erase(this->nackList.begin(), it);
+				this->nackList.EraseLowerThan(keyFrameSeq);
 
 				return true;
 			}
 
 			// If this keyframe is so old it does not remove any packets from the list,
 			// remove it from the list of keyframes and try the next keyframe.
-			this->keyFrameList.erase(this->keyFrameList.begin());
+			this->keyFrameList.Erase(keyFrameSeq);
 		}
 
 		return false;
@@ -228,29 +250,25 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		uint64_t nowMs = DepLibUV::GetTimeMs();
+		auto nowMs = static_cast<uint32_t>(DepLibUV::GetTimeMs());
 		std::vector<uint16_t> nackBatch;
+		uint16_t seq;
 
-		auto it = this->nackList.begin();
-
-		while (it != this->nackList.end())
+		// Removing the current item while iterating is fine.
+		for (bool found = this->nackList.GetFirst(seq); found; found = this->nackList.GetNext(seq))
 		{
-			NackInfo& nackInfo = it->second;
-			uint16_t seq       = nackInfo.seq;
+			NackInfo& nackInfo = GetNackItem(seq);
 
 			if (this->sendNackDelayMs > 0 && nowMs - nackInfo.createdAtMs < this->sendNackDelayMs)
-			{
-				++it;
 				continue;
-			}
 
 			// clang-format off
 			if (
 				filter == NackFilter::SEQ &&
-				nackInfo.sentAtMs == 0 &&
+				nackInfo.retries == 0u &&
 				(
-					nackInfo.sendAtSeq == this->lastSeq ||
-					SeqManager<uint16_t>::IsSeqHigherThan(this->lastSeq, nackInfo.sendAtSeq)
+					seq == this->lastSeq ||
+					SeqManager<uint16_t>::IsSeqHigherThan(this->lastSeq, seq)
 				)
 			)
 			// clang-format on
@@ -267,17 +285,13 @@ namespace RTC
 					  "]",
 					  seq);
 
-					it = this->nackList.erase(it);
-				}
-				else
-				{
-					++it;
+					this->nackList.Erase(seq);
 				}
 
 				continue;
 			}
 
-			if (filter == NackFilter::TIME && (nackInfo.sentAtMs == 0 || nowMs - nackInfo.sentAtMs >= this->rtt))
+			if (filter == NackFilter::TIME && (nackInfo.retries == 0u || nowMs - nackInfo.sentAtMs >= this->rtt))
 			{
 				nackBatch.emplace_back(seq);
 				nackInfo.retries++;
@@ -291,17 +305,9 @@ namespace RTC
 					  "]",
 					  seq);
 
-					it = this->nackList.erase(it);
+					this->nackList.Erase(seq);
 				}
-				else
-				{
-					++it;
-				}
-
-				continue;
 			}
-
-			++it;
 		}
 
 #if MS_LOG_DEV_LEVEL == 3
@@ -326,9 +332,9 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		this->nackList.clear();
-		this->keyFrameList.clear();
-		this->recoveredList.clear();
+		this->nackList.Clear();
+		this->keyFrameList.Clear();
+		this->recoveredList.Clear();
 
 		this->started = false;
 		this->lastSeq = 0u;
@@ -336,7 +342,7 @@ namespace RTC
 
 	inline void NackGenerator::MayRunTimer() const
 	{
-		if (!this->nackList.empty())
+		if (!this->nackList.IsEmpty())
 			this->timer->Start(TimerInterval);
 	}
 
@@ -351,4 +357,225 @@ namespace RTC
 
 		MayRunTimer();
 	}
+
+	/* SeqBitmap instance methods. */
+
+	bool NackGenerator::SeqBitmap::Insert(uint16_t seq)
+	{
+		MS_TRACE();
+
+		if (this->size == 0u)
+		{
+			if (this->words.empty())
+				this->words.resize(1u, 0u);
+
+			this->start = seq;
+			this->end   = static_cast<uint16_t>(seq + 1u);
+		}
+		else if (
+		  static_cast<uint16_t>(seq - this->start) >= static_cast<uint16_t>(this->end - this->start))
+		{
+			size_t span;
+
+			// Extend the window forward.
+			if (SeqManager<uint16_t>::IsSeqHigherThan(seq, static_cast<uint16_t>(this->end - 1u)))
+			{
+				span = static_cast<uint16_t>(seq - this->start) + 1u;
+
+				// Drop the oldest ones to make room.
+				if (span > MaxCapacity)
+				{
+					EraseFirst(span - MaxCapacity);
+
+					if (this->size == 0u)
+						return Insert(seq);
+
+					span = static_cast<uint16_t>(seq - this->start) + 1u;
+				}
+
+				if (span > GetCapacity())
+					Grow(span);
+
+				this->end = static_cast<uint16_t>(seq + 1u);
+			}
+			// Extend the window backward.
+			else
+			{
+				span = static_cast<uint16_t>(this->end - seq);
+
+				// Too old, ignore it.
+				if (span > MaxCapacity)
+					return false;
+
+				if (span > GetCapacity())
+					Grow(span);
+
+				this->start = seq;
+			}
+		}
+
+		size_t idx     = seq & (GetCapacity() - 1);
+		uint64_t& word = this->words[idx >> 6];
+		uint64_t bit   = uint64_t{ 1u } << (idx & 63u);
+
+		if ((word & bit) != 0u)
+			return false;
+
+		word |= bit;
+		++this->size;
+
+		return true;
+	}
+
+	void NackGenerator::SeqBitmap::Erase(uint16_t seq)
+	{
+		MS_TRACE();
+
+		if (!Contains(seq))
+			return;
+
+		size_t idx = seq & (GetCapacity() - 1);
+
+		this->words[idx >> 6] &= ~(uint64_t{ 1u } << (idx & 63u));
+		--this->size;
+
+		// Keep the window starting at the lowest sequence number.
+		if (this->size != 0u && seq == this->start)
+			Find(this->start, this->start);
+	}
+
+	void NackGenerator::SeqBitmap::EraseLowerThan(uint16_t seq)
+	{
+		MS_TRACE();
+
+		if (this->size == 0u || !SeqManager<uint16_t>::IsSeqHigherThan(seq, this->start))
+			return;
+
+		EraseFirst(static_cast<uint16_t>(seq - this->start));
+	}
+
+	void NackGenerator::SeqBitmap::Clear()
+	{
+		MS_TRACE();
+
+		if (this->size != 0u)
+			ClearRange(this->start, static_cast<uint16_t>(this->end - this->start));
+
+		this->size = 0u;
+	}
+
+	void NackGenerator::SeqBitmap::EraseFirst(size_t count)
+	{
+		MS_TRACE();
+
+		auto span = static_cast<uint16_t>(this->end - this->start);
+
+		if (count >= span)
+		{
+			Clear();
+
+			return;
+		}
+
+		auto from = this->start;
+
+		ClearRange(from, count);
+
+		if (this->size != 0u)
+			Find(static_cast<uint16_t>(from + count), this->start);
+	}
+
+	bool NackGenerator::SeqBitmap::Find(uint16_t from, uint16_t& seq) const
+	{
+		MS_TRACE();
+
+		if (this->size == 0u)
+			return false;
+
+		// The lowest one may have been erased.
+		if (SeqManager<uint16_t>::IsSeqLowerThan(from, this->start))
+			from = this->start;
+
+		auto offset = static_cast<uint16_t>(from - this->start);
+		auto span   = static_cast<uint16_t>(this->end - this->start);
+
+		if (offset >= span)
+			return false;
+
+		size_t remaining = span - offset;
+		size_t mask      = GetCapacity() - 1;
+		uint16_t pos     = from;
+
+		// Scan a word at a time.
+		while (remaining != 0u)
+		{
+			size_t idx    = pos & mask;
+			size_t bit    = idx & 63u;
+			size_t chunk  = 64u - bit < remaining ? 64u - bit : remaining;
+			uint64_t word = this->words[idx >> 6] >> bit;
+
+			if (chunk < 64u)
+				word &= (uint64_t{ 1u } << chunk) - 1;
+
+			if (word != 0u)
+			{
+				seq = static_cast<uint16_t>(pos + Utils::Bits::GetLowestSetBit(word));
+
+				return true;
+			}
+
+			pos = static_cast<uint16_t>(pos + chunk);
+			remaining -= chunk;
+		}
+
+		return false;
+	}
+
+	void NackGenerator::SeqBitmap::ClearRange(uint16_t from, size_t count)
+	{
+		MS_TRACE();
+
+		size_t mask  = GetCapacity() - 1;
+		uint16_t pos = from;
+
+		while (count != 0u)
+		{
+			size_t idx     = pos & mask;
+			size_t bit     = idx & 63u;
+			size_t chunk   = 64u - bit < count ? 64u - bit : count;
+			uint64_t bits  = (chunk < 64u ? (uint64_t{ 1u } << chunk) - 1 : ~uint64_t{ 0u }) << bit;
+			uint64_t& word = this->words[idx >> 6];
+
+			this->size -= Utils::Bits::CountSetBits(word & bits);
+			word &= ~bits;
+
+			pos = static_cast<uint16_t>(pos + chunk);
+			count -= chunk;
+		}
+	}
+
+	void NackGenerator::SeqBitmap::Grow(size_t span)
+	{
+		MS_TRACE();
+
+		size_t capacity = GetCapacity();
+
+		while (capacity < span)
+		{
+			capacity *= 2;
+		}
+
+		std::vector<uint64_t> words(capacity / 64u, 0u);
+		uint16_t seq;
+
+		// Move the current ones to their position in the new ring.
+		for (bool found = GetFirst(seq); found; found = GetNext(seq))
+		{
+			size_t idx = seq & (capacity - 1);
+
+			words[idx >> 6] |= (uint64_t{ 1u } << (idx & 63u));
+		}
+
+		this->words = std::move(words);
+	}
 } // namespace RTC
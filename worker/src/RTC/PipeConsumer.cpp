@@ -194,7 +194,7 @@ namespace RTC
 		return 0u;
 	}
 
-	void PipeConsumer::SendRtpPacket(RTC::RtpPacket* packet, std::shared_ptr<RTC::RtpPacket>& sharedPacket)
+	void PipeConsumer::SendRtpPacket(RTC::RtpPacket* packet, RTC::SharedRtpPacket& sharedPacket)
 	{
 		MS_TRACE();
 
@@ -245,10 +245,18 @@ namespace RTC
 		auto origSsrc = packet->GetSsrc();
 		auto origSeq  = packet->GetSequenceNumber();
 
-		// Rewrite packet.
+		// Rewrite packet. The packet is shared with other consumers so its header
+		// is rewritten into an overlay which is applied when sending it.
+		RTC::RtpPacket::HeaderOverlay headerOverlay(packet);
+
+		packet->SetHeaderOverlay(&headerOverlay);
 		packet->SetSsrc(ssrc);
 		packet->SetSequenceNumber(seq);
 
+		// Update MID RTP extension value.
+		if (!this->rtpParameters.mid.empty())
+			packet->UpdateMid(this->rtpParameters.mid);
+
 		if (isSyncPacket)
 		{
 			MS_DEBUG_TAG(
@@ -284,9 +292,8 @@ namespace RTC
 			  origSeq);
 		}
 
-		// Restore packet fields.
-		packet->SetSsrc(origSsrc);
-		packet->SetSequenceNumber(origSeq);
+		// Remove the header overlay.
+		packet->SetHeaderOverlay(nullptr);
 	}
 
 	void PipeConsumer::GetRtcp(
@@ -7,6 +7,7 @@
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
 #include "Channel/ChannelNotifier.hpp"
+#include <cstring> // std::memcpy()
 
 namespace RTC
 {
@@ -336,6 +337,9 @@ namespace RTC
 		// Add rtcpTuple.
 		if (!this->rtcpMux && this->rtcpTuple)
 			this->rtcpTuple->FillJson(jsonObject["rtcpTuple"]);
+
+		// Add UDP send batch stats.
+		this->udpSocket->FillJsonSendBatchStats(jsonObject);
 	}
 
 	void PlainTransport::HandleRequest(Channel::ChannelRequest* request)
@@ -729,25 +733,7 @@ namespace RTC
 			return;
 		}
 
-		const uint8_t* data = packet->GetData();
-		auto intLen         = static_cast<int>(packet->GetSize());
-
-		if (HasSrtp() && !this->srtpSendSession->EncryptRtp(&data, &intLen))
-		{
-			if (cb)
-			{
-				(*cb)(false, ctx);
-			}
-
-			return;
-		}
-
-		auto len = static_cast<size_t>(intLen);
-
-		this->tuple->Send(data, len, cb, ctx);
-
-		// Increase send transmission.
-		RTC::Transport::DataSent(len);
+		SendRtpPacketToTuple(this->tuple, packet, HasSrtp() ? this->srtpSendSession : nullptr, cb, ctx);
 	}
 
 	void PlainTransport::SendRtcpPacket(RTC::RTCP::Packet* packet)
@@ -1117,13 +1103,21 @@ namespace RTC
 		RTC::Transport::ReceiveSctpData(data, len);
 	}
 
-	inline void PlainTransport::OnUdpSocketPacketReceived(
-	  RTC::UdpSocket* socket, const uint8_t* data, size_t len, const struct sockaddr* remoteAddr)
+	inline void PlainTransport::OnUdpSocketPacketsReceived(
+	  RTC::UdpSocket* socket, const RTC::UdpSocket::RecvDatagram* datagrams, size_t count)
 	{
 		MS_TRACE();
 
-		RTC::TransportTuple tuple(socket, remoteAddr);
+		RTC::Transport::StartRecvBatch();
+
+		for (size_t i{ 0u }; i < count; ++i)
+		{
+			auto& datagram = datagrams[i];
+			RTC::TransportTuple tuple(socket, datagram.addr);
+
+			OnPacketReceived(&tuple, datagram.data, datagram.len);
+		}
 
-		OnPacketReceived(&tuple, data, len);
+		RTC::Transport::EndRecvBatch(count);
 	}
 } // namespace RTC
@@ -7,8 +7,24 @@
 #include "MediaSoupErrors.hpp"
 #include "Settings.hpp"
 #include "Utils.hpp"
+#include <cerrno>
+#include <cstring> // std::strerror()
 #include <tuple>   // std:make_tuple()
 #include <utility> // std::piecewise_construct
+#ifdef __linux__
+#include <linux/filter.h>
+#include <sys/socket.h>
+#endif
+
+/* Static. */
+
+#ifdef __linux__
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+// Multiplier (golden ratio) to spread the tuple bits before the modulo.
+static constexpr uint32_t ReusePortHashMultiplier{ 0x9E3779B1 };
+#endif
 
 /* Static methods for UV callbacks. */
 
@@ -314,7 +330,8 @@ namespace RTC
 		return static_cast<uv_handle_t*>(uvHandle);
 	}
 
-	uv_handle_t* PortManager::Bind(Transport transport, std::string& ip, uint16_t port)
+	uv_handle_t* PortManager::Bind(
+	  Transport transport, std::string& ip, uint16_t port, uint16_t numReusePortShards)
 	{
 		MS_TRACE();
 
@@ -387,10 +404,20 @@ namespace RTC
 		switch (transport)
 		{
 			case Transport::UDP:
+			{
+				// If SO_REUSEPORT is needed, the socket must be created now (by passing
+				// its family) so the option can be set before binding.
+				unsigned int udpFlags = UV_UDP_RECVMMSG;
+
+				if (numReusePortShards > 0u)
+					udpFlags |= static_cast<unsigned int>(family);
+
 				uvHandle = reinterpret_cast<uv_handle_t*>(new uv_udp_t());
-				err      = uv_udp_init_ex(
-          DepLibUV::GetLoop(), reinterpret_cast<uv_udp_t*>(uvHandle), UV_UDP_RECVMMSG);
+				err =
+				  uv_udp_init_ex(DepLibUV::GetLoop(), reinterpret_cast<uv_udp_t*>(uvHandle), udpFlags);
+
 				break;
+			}
 
 			case Transport::TCP:
 				uvHandle = reinterpret_cast<uv_handle_t*>(new uv_tcp_t());
@@ -418,6 +445,34 @@ namespace RTC
 		{
 			case Transport::UDP:
 			{
+				if (numReusePortShards > 0u)
+				{
+#ifdef SO_REUSEPORT
+					uv_os_fd_t fd;
+					int on{ 1 };
+
+					uv_fileno(uvHandle, &fd);
+
+					err = setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+
+					if (err != 0)
+					{
+						uv_close(reinterpret_cast<uv_handle_t*>(uvHandle), static_cast<uv_close_cb>(onClose));
+
+						MS_THROW_ERROR(
+						  "setsockopt(SO_REUSEPORT) failed [transport:%s, ip:'%s', port:%" PRIu16 "]: %s",
+						  transportStr.c_str(),
+						  ip.c_str(),
+						  port,
+						  std::strerror(errno));
+					}
+#else
+					uv_close(reinterpret_cast<uv_handle_t*>(uvHandle), static_cast<uv_close_cb>(onClose));
+
+					MS_THROW_ERROR("SO_REUSEPORT not supported on this platform");
+#endif
+				}
+
 				err = uv_udp_bind(
 				  reinterpret_cast<uv_udp_t*>(uvHandle),
 				  reinterpret_cast<const struct sockaddr*>(&bindAddr),
@@ -436,6 +491,11 @@ namespace RTC
 					  uv_strerror(err));
 				}
 
+				if (numReusePortShards > 1u)
+				{
+					SetReusePortShardSteering(reinterpret_cast<uv_udp_t*>(uvHandle), family, numReusePortShards);
+				}
+
 				break;
 			}
 
@@ -492,6 +552,93 @@ namespace RTC
 		return static_cast<uv_handle_t*>(uvHandle);
 	}
 
+	/**
+	 * Attaches a classic BPF program to the SO_REUSEPORT group of the socket which
+	 * selects the socket index by hashing the remote IP and port, so all the
+	 * packets of a remote tuple are always delivered to the same socket. If it
+	 * fails the kernel default selection is used, which also hashes the tuple.
+	 */
+	void PortManager::SetReusePortShardSteering(uv_udp_t* uvHandle, int family, uint16_t numShards)
+	{
+		MS_TRACE();
+
+#ifdef __linux__
+		// NOTE: Offsets are relative to the IP header (SKF_NET_OFF) since the
+		// program is run with the packet data pointing to the UDP payload.
+		// clang-format off
+		struct sock_filter ipv4Code[] =
+		{
+			// X = IP header length.
+			BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, static_cast<uint32_t>(SKF_NET_OFF)),
+			// A = source port.
+			BPF_STMT(BPF_LD | BPF_H | BPF_IND, static_cast<uint32_t>(SKF_NET_OFF)),
+			BPF_STMT(BPF_MISC | BPF_TAX, 0),
+			// A = source address ^ source port.
+			BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 12)),
+			BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+			// Return hash % numShards.
+			BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, ReusePortHashMultiplier),
+			BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),
+			BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, numShards),
+			BPF_STMT(BPF_RET | BPF_A, 0)
+		};
+
+		// NOTE: IPv6 extension headers are not expected so UDP header follows the
+		// fixed IPv6 header.
+		struct sock_filter ipv6Code[] =
+		{
+			// A = source port.
+			BPF_STMT(BPF_LD | BPF_H | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 40)),
+			BPF_STMT(BPF_MISC | BPF_TAX, 0),
+			// A = XOR of the source address words and source port.
+			BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 8)),
+			BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+			BPF_STMT(BPF_MISC | BPF_TAX, 0),
+			BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 12)),
+			BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+			BPF_STMT(BPF_MISC | BPF_TAX, 0),
+			BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 16)),
+			BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+			BPF_STMT(BPF_MISC | BPF_TAX, 0),
+			BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 20)),
+			BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+			// Return hash % numShards.
+			BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, ReusePortHashMultiplier),
+			BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),
+			BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, numShards),
+			BPF_STMT(BPF_RET | BPF_A, 0)
+		};
+		// clang-format on
+
+		struct sock_fprog prog; // NOLINT(cppcoreguidelines-pro-type-member-init)
+
+		if (family == AF_INET)
+		{
+			prog.len    = sizeof(ipv4Code) / sizeof(ipv4Code[0]);
+			prog.filter = ipv4Code;
+		}
+		else
+		{
+			prog.len    = sizeof(ipv6Code) / sizeof(ipv6Code[0]);
+			prog.filter = ipv6Code;
+		}
+
+		uv_os_fd_t fd;
+
+		uv_fileno(reinterpret_cast<uv_handle_t*>(uvHandle), &fd);
+
+		if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) != 0)
+		{
+			MS_WARN_TAG(
+			  info,
+			  "setsockopt(SO_ATTACH_REUSEPORT_CBPF) failed, using kernel default steering: %s",
+			  std::strerror(errno));
+		}
+#else
+		MS_WARN_TAG(info, "SO_ATTACH_REUSEPORT_CBPF not supported, using kernel default steering");
+#endif
+	}
+
 	void PortManager::Unbind(Transport transport, std::string& ip, uint16_t port)
 	{
 		MS_TRACE();
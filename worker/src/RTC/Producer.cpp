@@ -4,6 +4,7 @@
 #include "RTC/Producer.hpp"
 #include "ChannelMessageHandlers.hpp"
 #include "DepLibUV.hpp"
+#include "LatencyStats.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
@@ -290,6 +291,8 @@ namespace RTC
 			}
 		}
 
+		CompileHeaderExtensionsRewritePlan();
+
 		// Set the RTCP report generation interval.
 		if (this->kind == RTC::Media::Kind::AUDIO)
 			this->maxRtcpInterval = RTC::RTCP::MaxAudioIntervalMs;
@@ -673,6 +676,8 @@ namespace RTC
 	{
 		MS_TRACE();
 
+		LatencyStats::Scope latencyScope(LatencyStats::Stage::PRODUCER_RECEIVE);
+
 		// Reset current packet.
 		this->currentRtpPacket = nullptr;
 
@@ -1228,6 +1233,91 @@ namespace RTC
 		return rtpStream;
 	}
 
+	/**
+	 * Header extensions written by MangleRtpPacket() just depend on the RTP
+	 * parameters so their ids and lengths are computed once.
+	 */
+	void Producer::CompileHeaderExtensionsRewritePlan()
+	{
+		MS_TRACE();
+
+		auto& plan = this->headerExtensionsRewritePlan;
+
+		plan.clear();
+
+		// Add urn:ietf:params:rtp-hdrext:sdes:mid.
+		plan.emplace_back(
+		  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::MID), 0u, RTC::MidMaxLength);
+
+		if (this->kind == RTC::Media::Kind::AUDIO)
+		{
+			// Proxy urn:ietf:params:rtp-hdrext:ssrc-audio-level.
+			if (this->rtpHeaderExtensionIds.ssrcAudioLevel != 0u)
+			{
+				plan.emplace_back(
+				  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::SSRC_AUDIO_LEVEL),
+				  this->rtpHeaderExtensionIds.ssrcAudioLevel,
+				  0u);
+			}
+		}
+		else if (this->kind == RTC::Media::Kind::VIDEO)
+		{
+			// Add http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time.
+			plan.emplace_back(
+			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::ABS_SEND_TIME), 0u, 3u);
+
+			// Add http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01.
+			plan.emplace_back(
+			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01), 0u, 2u);
+
+			// NOTE: Remove this once framemarking draft becomes RFC.
+			// Proxy http://tools.ietf.org/html/draft-ietf-avtext-framemarking-07.
+			if (this->rtpHeaderExtensionIds.frameMarking07 != 0u)
+			{
+				plan.emplace_back(
+				  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::FRAME_MARKING_07),
+				  this->rtpHeaderExtensionIds.frameMarking07,
+				  0u);
+			}
+
+			// Proxy urn:ietf:params:rtp-hdrext:framemarking.
+			if (this->rtpHeaderExtensionIds.frameMarking != 0u)
+			{
+				plan.emplace_back(
+				  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::FRAME_MARKING),
+				  this->rtpHeaderExtensionIds.frameMarking,
+				  0u);
+			}
+
+			// Proxy urn:3gpp:video-orientation.
+			if (this->rtpHeaderExtensionIds.videoOrientation != 0u)
+			{
+				plan.emplace_back(
+				  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::VIDEO_ORIENTATION),
+				  this->rtpHeaderExtensionIds.videoOrientation,
+				  0u);
+			}
+
+			// Proxy urn:ietf:params:rtp-hdrext:toffset.
+			if (this->rtpHeaderExtensionIds.toffset != 0u)
+			{
+				plan.emplace_back(
+				  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::TOFFSET),
+				  this->rtpHeaderExtensionIds.toffset,
+				  0u);
+			}
+
+			// Proxy http://www.webrtc.org/experiments/rtp-hdrext/abs-capture-time.
+			if (this->rtpHeaderExtensionIds.absCaptureTime != 0u)
+			{
+				plan.emplace_back(
+				  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::ABS_CAPTURE_TIME),
+				  this->rtpHeaderExtensionIds.absCaptureTime,
+				  0u);
+			}
+		}
+	}
+
 	void Producer::NotifyNewRtpStream(RTC::RtpStreamRecv* rtpStream)
 	{
 		MS_TRACE();
@@ -1280,174 +1370,155 @@ namespace RTC
 
 		// Mangle RTP header extensions.
 		{
-			thread_local static uint8_t buffer[4096];
-			thread_local static std::vector<RTC::RtpPacket::GenericExtension> extensions;
-
-			// This happens just once.
-			if (extensions.capacity() != 24)
-				extensions.reserve(24);
-
-			extensions.clear();
-
-			uint8_t* extenValue;
-			uint8_t extenLen;
-			uint8_t* bufferPtr{ buffer };
-
-			// Add urn:ietf:params:rtp-hdrext:sdes:mid.
+			if (!MangleHeaderExtensionsInPlace(packet))
 			{
-				extenLen = RTC::MidMaxLength;
+				thread_local static uint8_t buffer[256];
 
-				extensions.emplace_back(
-				  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::MID), extenLen, bufferPtr);
+				uint8_t* bufferPtr{ buffer };
 
-				bufferPtr += extenLen;
-			}
-
-			if (this->kind == RTC::Media::Kind::AUDIO)
-			{
-				// Proxy urn:ietf:params:rtp-hdrext:ssrc-audio-level.
-				extenValue = packet->GetExtension(this->rtpHeaderExtensionIds.ssrcAudioLevel, extenLen);
-
-				if (extenValue)
+				for (const auto& rewrite : this->headerExtensionsRewritePlan)
 				{
-					std::memcpy(bufferPtr, extenValue, extenLen);
+					uint8_t* extenValue{ nullptr };
+					uint8_t extenLen{ rewrite.len };
 
-					extensions.emplace_back(
-					  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::SSRC_AUDIO_LEVEL),
-					  extenLen,
-					  bufferPtr);
-
-					// Not needed since this is the latest added extension.
-					// bufferPtr += extenLen;
-				}
-			}
-			else if (this->kind == RTC::Media::Kind::VIDEO)
-			{
-				// Add http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time.
-				{
-					extenLen = 3u;
+					if (rewrite.recvId != 0u)
+					{
+						extenValue = packet->GetExtension(rewrite.recvId, extenLen);
 
-					// NOTE: Add value 0. The sending Transport will update it.
-					uint32_t absSendTime{ 0u };
+						// One-Byte extensions cannot be longer than 16 bytes.
+						if (!extenValue || extenLen > 16u)
+							continue;
+					}
 
-					Utils::Byte::Set3Bytes(bufferPtr, 0, absSendTime);
+					*bufferPtr = (rewrite.id << 4) | (extenLen - 1);
+					++bufferPtr;
 
-					extensions.emplace_back(
-					  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::ABS_SEND_TIME), extenLen, bufferPtr);
+					// NOTE: Values written by the Producer are set to 0. The sending
+					// Transport and Consumers will update them.
+					if (extenValue)
+						std::memcpy(bufferPtr, extenValue, extenLen);
+					else
+						std::memset(bufferPtr, 0, extenLen);
 
 					bufferPtr += extenLen;
 				}
 
-				// Add http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01.
-				{
-					extenLen = 2u;
+				auto len       = static_cast<uint16_t>(bufferPtr - buffer);
+				auto paddedLen = Utils::Byte::PadTo4Bytes(len);
 
-					// NOTE: Add value 0. The sending Transport will update it.
-					uint16_t wideSeqNumber{ 0u };
+				std::memset(bufferPtr, 0, paddedLen - len);
 
-					Utils::Byte::Set2Bytes(bufferPtr, 0, wideSeqNumber);
+				// Set the new extensions into the packet using One-Byte format.
+				packet->SetSerializedExtensions(1, buffer, paddedLen);
+			}
 
-					extensions.emplace_back(
-					  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01),
-					  extenLen,
-					  bufferPtr);
+			// Assign mediasoup RTP header extension ids (just those that mediasoup may
+			// be interested in after passing it to the Router).
+			packet->SetMidExtensionId(static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::MID));
+			packet->SetAbsSendTimeExtensionId(
+			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::ABS_SEND_TIME));
+			packet->SetTransportWideCc01ExtensionId(
+			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01));
+			// NOTE: Remove this once framemarking draft becomes RFC.
+			packet->SetFrameMarking07ExtensionId(
+			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::FRAME_MARKING_07));
+			packet->SetFrameMarkingExtensionId(
+			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::FRAME_MARKING));
+			packet->SetSsrcAudioLevelExtensionId(
+			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::SSRC_AUDIO_LEVEL));
+			packet->SetVideoOrientationExtensionId(
+			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::VIDEO_ORIENTATION));
+		}
 
-					bufferPtr += extenLen;
-				}
+		return true;
+	}
 
-				// NOTE: Remove this once framemarking draft becomes RFC.
-				// Proxy http://tools.ietf.org/html/draft-ietf-avtext-framemarking-07.
-				extenValue = packet->GetExtension(this->rtpHeaderExtensionIds.frameMarking07, extenLen);
+	/**
+	 * Returns true if the header extension of the packet already has the layout
+	 * that MangleRtpPacket() would write (i.e. the packet comes from a Consumer
+	 * of another mediasoup Router through a PipeTransport). If so, the values
+	 * written by the Producer are reset in place.
+	 */
+	inline bool Producer::MangleHeaderExtensionsInPlace(RTC::RtpPacket* packet) const
+	{
+		MS_TRACE();
 
-				if (extenValue)
-				{
-					std::memcpy(bufferPtr, extenValue, extenLen);
+		if (!packet->HasOneByteExtensions())
+			return false;
 
-					extensions.emplace_back(
-					  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::FRAME_MARKING_07),
-					  extenLen,
-					  bufferPtr);
+		uint8_t* start = packet->GetHeaderExtensionValue();
+		uint8_t* end   = start + packet->GetHeaderExtensionLength();
+		uint8_t* ptr   = start;
 
-					bufferPtr += extenLen;
-				}
+		for (const auto& rewrite : this->headerExtensionsRewritePlan)
+		{
+			uint8_t extenLen;
 
-				// Proxy urn:ietf:params:rtp-hdrext:framemarking.
-				extenValue = packet->GetExtension(this->rtpHeaderExtensionIds.frameMarking, extenLen);
+			if (rewrite.recvId != 0u)
+			{
+				uint8_t* extenValue = packet->GetExtension(rewrite.recvId, extenLen);
 
-				if (extenValue)
-				{
-					std::memcpy(bufferPtr, extenValue, extenLen);
+				if (!extenValue)
+					continue;
 
-					extensions.emplace_back(
-					  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::FRAME_MARKING), extenLen, bufferPtr);
+				// It must be the next element and have the mediasoup id.
+				if (extenValue != ptr + 1 || rewrite.recvId != rewrite.id)
+					return false;
+			}
+			else
+			{
+				if (ptr >= end || (*ptr >> 4) != rewrite.id)
+					return false;
 
-					bufferPtr += extenLen;
-				}
+				extenLen = (*ptr & 0x0F) + 1;
 
-				// Proxy urn:3gpp:video-orientation.
-				extenValue = packet->GetExtension(this->rtpHeaderExtensionIds.videoOrientation, extenLen);
+				// It may be shorter (i.e. MID updated by a Consumer) if followed by
+				// zeros up to the expected length.
+				if (extenLen > rewrite.len || ptr + 1 + rewrite.len > end)
+					return false;
 
-				if (extenValue)
+				for (; extenLen < rewrite.len; ++extenLen)
 				{
-					std::memcpy(bufferPtr, extenValue, extenLen);
-
-					extensions.emplace_back(
-					  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::VIDEO_ORIENTATION),
-					  extenLen,
-					  bufferPtr);
-
-					bufferPtr += extenLen;
+					if (ptr[1 + extenLen] != 0u)
+						return false;
 				}
+			}
 
-				// Proxy urn:ietf:params:rtp-hdrext:toffset.
-				extenValue = packet->GetExtension(this->rtpHeaderExtensionIds.toffset, extenLen);
+			ptr += 1 + extenLen;
+		}
 
-				if (extenValue)
-				{
-					std::memcpy(bufferPtr, extenValue, extenLen);
+		// Just padding may follow.
+		if (Utils::Byte::PadTo4Bytes(static_cast<uint16_t>(ptr - start)) != end - start)
+			return false;
 
-					extensions.emplace_back(
-					  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::TOFFSET), extenLen, bufferPtr);
+		for (; ptr < end; ++ptr)
+		{
+			if (*ptr != 0u)
+				return false;
+		}
 
-					bufferPtr += extenLen;
-				}
+		// Reset the elements written by the Producer.
+		ptr = start;
 
-				// Proxy http://www.webrtc.org/experiments/rtp-hdrext/abs-capture-time.
-				extenValue = packet->GetExtension(this->rtpHeaderExtensionIds.absCaptureTime, extenLen);
+		for (const auto& rewrite : this->headerExtensionsRewritePlan)
+		{
+			uint8_t extenLen;
 
-				if (extenValue)
-				{
-					std::memcpy(bufferPtr, extenValue, extenLen);
+			if (rewrite.recvId != 0u)
+			{
+				if (!packet->GetExtension(rewrite.recvId, extenLen))
+					continue;
+			}
+			else
+			{
+				extenLen = rewrite.len;
 
-					extensions.emplace_back(
-					  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::ABS_CAPTURE_TIME),
-					  extenLen,
-					  bufferPtr);
+				*ptr = (rewrite.id << 4) | (extenLen - 1);
 
-					// Not needed since this is the latest added extension.
-					// bufferPtr += extenLen;
-				}
+				std::memset(ptr + 1, 0, extenLen);
 			}
 
-			// Set the new extensions into the packet using One-Byte format.
-			packet->SetExtensions(1, extensions);
-
-			// Assign mediasoup RTP header extension ids (just those that mediasoup may
-			// be interested in after passing it to the Router).
-			packet->SetMidExtensionId(static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::MID));
-			packet->SetAbsSendTimeExtensionId(
-			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::ABS_SEND_TIME));
-			packet->SetTransportWideCc01ExtensionId(
-			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01));
-			// NOTE: Remove this once framemarking draft becomes RFC.
-			packet->SetFrameMarking07ExtensionId(
-			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::FRAME_MARKING_07));
-			packet->SetFrameMarkingExtensionId(
-			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::FRAME_MARKING));
-			packet->SetSsrcAudioLevelExtensionId(
-			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::SSRC_AUDIO_LEVEL));
-			packet->SetVideoOrientationExtensionId(
-			  static_cast<uint8_t>(RTC::RtpHeaderExtensionUri::Type::VIDEO_ORIENTATION));
+			ptr += 1 + extenLen;
 		}
 
 		return true;
@@ -59,6 +59,19 @@ namespace RTC
 		uint16_t FeedbackRtpTransportPacket::maxPacketStatusCount{ (1 << 16) - 1 };
 		int16_t FeedbackRtpTransportPacket::maxPacketDelta{ 0x7FFF };
 
+		// Size (in bytes) of the receive delta of a packet, indexed by its status.
+		// A packet has been received if the size of its delta is not zero.
+		// clang-format off
+		static constexpr uint8_t StatusDeltaSizes[] =
+		{
+			0u, // NotReceived.
+			1u, // SmallDelta.
+			2u, // LargeDelta.
+			0u, // Reserved.
+			0u  // None.
+		};
+		// clang-format on
+
 		// clang-format off
 		absl::flat_hash_map<FeedbackRtpTransportPacket::Status, std::string> FeedbackRtpTransportPacket::status2String =
 		{
@@ -93,6 +106,41 @@ namespace RTC
 			return packet.release();
 		}
 
+		bool FeedbackRtpTransportPacket::AddStatusDeltas(
+		  const std::vector<Status>& statuses,
+		  const uint8_t* data,
+		  size_t len,
+		  std::vector<int16_t>& deltas,
+		  size_t& offset)
+		{
+			MS_TRACE();
+
+			for (auto status : statuses)
+			{
+				auto deltaSize = StatusDeltaSizes[status];
+
+				if (deltaSize == 0u)
+					continue;
+
+				if (len < deltaSize)
+				{
+					MS_WARN_TAG(rtcp, "not enough space for delta");
+
+					return false;
+				}
+
+				if (deltaSize == 1u)
+					deltas.push_back(static_cast<int16_t>(Utils::Byte::Get1Byte(data, offset)));
+				else
+					deltas.push_back(static_cast<int16_t>(Utils::Byte::Get2Bytes(data, offset)));
+
+				offset += deltaSize;
+				len -= deltaSize;
+			}
+
+			return true;
+		}
+
 		/* Instance methods. */
 
 		FeedbackRtpTransportPacket::FeedbackRtpTransportPacket(CommonHeader* commonHeader, size_t availableLen)
@@ -170,6 +218,8 @@ namespace RTC
 				return;
 			}
 
+			this->deltas.reserve(receivedPacketStatusCount);
+
 			auto chunksIt = this->chunks.begin();
 
 			while (chunksIt != this->chunks.end() && contentLen > offset)
@@ -424,6 +474,19 @@ namespace RTC
 
 			std::vector<struct PacketResult> packetResults;
 
+			GetPacketResults(packetResults);
+
+			return packetResults;
+		}
+
+		void FeedbackRtpTransportPacket::GetPacketResults(
+		  std::vector<struct PacketResult>& packetResults) const
+		{
+			MS_TRACE();
+
+			packetResults.clear();
+			packetResults.reserve(this->packetStatusCount);
+
 			uint16_t currentSequenceNumber = this->baseSequenceNumber - 1;
 
 			for (auto* chunk : this->chunks)
@@ -446,8 +509,6 @@ namespace RTC
 				packetResult.receivedAtMs = currentReceivedAtMs;
 				deltaIdx++;
 			}
-
-			return packetResults;
 		}
 
 		uint8_t FeedbackRtpTransportPacket::GetPacketFractionLost() const
@@ -809,38 +870,7 @@ namespace RTC
 		{
 			MS_TRACE();
 
-			for (auto status : this->statuses)
-			{
-				if (status == Status::NotReceived)
-				{
-					continue;
-				}
-				else if (status == Status::SmallDelta)
-				{
-					if (len < 1u)
-					{
-						MS_WARN_TAG(rtcp, "not enough space for small delta");
-
-						return false;
-					}
-
-					auto delta = static_cast<int16_t>(Utils::Byte::Get1Byte(data, offset));
-
-					deltas.push_back(delta);
-					offset += 1u;
-					len -= 1u;
-
-					continue;
-				}
-				else
-				{
-					MS_WARN_TAG(rtcp, "invalid status for one bit vector chunk");
-
-					return false;
-				}
-			}
-
-			return true;
+			return FeedbackRtpTransportPacket::AddStatusDeltas(this->statuses, data, len, deltas, offset);
 		}
 
 		void FeedbackRtpTransportPacket::OneBitVectorChunk::Dump() const
@@ -876,7 +906,7 @@ namespace RTC
 
 			for (auto status : this->statuses)
 			{
-				if (status == Status::SmallDelta || status == Status::LargeDelta)
+				if (StatusDeltaSizes[status] != 0u)
 					count++;
 			}
 
@@ -891,7 +921,7 @@ namespace RTC
 
 			for (auto status : this->statuses)
 			{
-				bool received = (status == Status::SmallDelta || status == Status::LargeDelta);
+				bool received = StatusDeltaSizes[status] != 0u;
 
 				packetResults.emplace_back(++currentSequenceNumber, received);
 			}
@@ -936,49 +966,7 @@ namespace RTC
 		{
 			MS_TRACE();
 
-			for (auto status : this->statuses)
-			{
-				if (status == Status::NotReceived)
-				{
-					continue;
-				}
-				else if (status == Status::SmallDelta)
-				{
-					if (len < 1u)
-					{
-						MS_WARN_TAG(rtcp, "not enough space for small delta");
-
-						return false;
-					}
-
-					auto delta = static_cast<int16_t>(Utils::Byte::Get1Byte(data, offset));
-
-					deltas.push_back(delta);
-					offset += 1u;
-					len -= 1u;
-
-					continue;
-				}
-				else if (status == Status::LargeDelta)
-				{
-					if (len < 2u)
-					{
-						MS_WARN_TAG(rtcp, "not enough space for large delta");
-
-						return false;
-					}
-
-					auto delta = static_cast<int16_t>(Utils::Byte::Get2Bytes(data, offset));
-
-					deltas.push_back(delta);
-					offset += 2u;
-					len -= 2u;
-
-					continue;
-				}
-			}
-
-			return true;
+			return FeedbackRtpTransportPacket::AddStatusDeltas(this->statuses, data, len, deltas, offset);
 		}
 
 		void FeedbackRtpTransportPacket::TwoBitVectorChunk::Dump() const
@@ -1014,7 +1002,7 @@ namespace RTC
 
 			for (auto status : this->statuses)
 			{
-				if (status == Status::SmallDelta || status == Status::LargeDelta)
+				if (StatusDeltaSizes[status] != 0u)
 					count++;
 			}
 
@@ -1029,7 +1017,7 @@ namespace RTC
 
 			for (auto status : this->statuses)
 			{
-				bool received = (status == Status::SmallDelta || status == Status::LargeDelta);
+				bool received = StatusDeltaSizes[status] != 0u;
 
 				packetResults.emplace_back(++currentSequenceNumber, received);
 			}
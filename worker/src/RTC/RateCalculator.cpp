@@ -3,7 +3,8 @@
 
 #include "RTC/RateCalculator.hpp"
 #include "Logger.hpp"
-#include <cmath> // std::trunc()
+#include <algorithm> // std::fill()
+#include <cmath>     // std::trunc()
 
 namespace RTC
 {
@@ -114,6 +115,125 @@ namespace RTC
 		}
 	}
 
+	void LayersRateCalculator::Update(size_t layer, size_t size, uint64_t nowMs)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(layer < this->layers, "layer too high");
+
+		// Ignore too old data. Should never happen.
+		if (nowMs < this->oldestItemStartTime)
+			return;
+
+		RemoveOldData(nowMs);
+
+		// If the elapsed time from the newest item start time is greater than the
+		// item size (in milliseconds), increase the item index.
+		if (this->newestItemIndex < 0 || nowMs - this->newestItemStartTime >= this->itemSizeMs)
+		{
+			this->newestItemIndex++;
+			this->newestItemStartTime = nowMs;
+			if (this->newestItemIndex >= this->windowItems)
+				this->newestItemIndex = 0;
+
+			MS_ASSERT(
+			  this->newestItemIndex != this->oldestItemIndex || this->oldestItemIndex == -1,
+			  "newest index overlaps with the oldest one");
+
+			// Set the newest item (counts of removed items are already zero).
+			this->itemTimes[this->newestItemIndex] = nowMs;
+		}
+
+		// Update the newest item.
+		this->itemCounts[(this->newestItemIndex * this->layers) + layer] += size;
+
+		// Set the oldest item index and time, if not set.
+		if (this->oldestItemIndex < 0)
+		{
+			this->oldestItemIndex     = this->newestItemIndex;
+			this->oldestItemStartTime = nowMs;
+		}
+
+		this->totalCounts[layer] += size;
+	}
+
+	uint32_t LayersRateCalculator::GetRate(uint64_t nowMs, size_t firstLayer, size_t lastLayer)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(firstLayer <= lastLayer, "firstLayer higher than lastLayer");
+		MS_ASSERT(lastLayer <= this->layers, "lastLayer too high");
+
+		RemoveOldData(nowMs);
+
+		size_t totalCount{ 0u };
+
+		for (size_t layer{ firstLayer }; layer < lastLayer; ++layer)
+		{
+			totalCount += this->totalCounts[layer];
+		}
+
+		float scale = this->scale / this->windowSizeMs;
+
+		return static_cast<uint32_t>(std::trunc(totalCount * scale + 0.5f));
+	}
+
+	inline void LayersRateCalculator::RemoveOldData(uint64_t nowMs)
+	{
+		MS_TRACE();
+
+		// No item set.
+		if (this->newestItemIndex < 0 || this->oldestItemIndex < 0)
+			return;
+
+		uint64_t newOldestTime = nowMs - this->windowSizeMs;
+
+		// Oldest item already removed.
+		if (newOldestTime < this->oldestItemStartTime)
+			return;
+
+		// A whole window size time has elapsed since last entry. Reset the buffer.
+		if (newOldestTime >= this->newestItemStartTime)
+		{
+			Reset();
+
+			return;
+		}
+
+		while (newOldestTime >= this->oldestItemStartTime)
+		{
+			auto* oldestItemCounts = this->itemCounts.data() + (this->oldestItemIndex * this->layers);
+
+			// Remove the counts of all layers in the oldest item at once.
+			for (size_t layer{ 0u }; layer < this->layers; ++layer)
+			{
+				this->totalCounts[layer] -= oldestItemCounts[layer];
+				oldestItemCounts[layer] = 0u;
+			}
+
+			this->itemTimes[this->oldestItemIndex] = 0u;
+
+			if (++this->oldestItemIndex >= this->windowItems)
+				this->oldestItemIndex = 0;
+
+			this->oldestItemStartTime = this->itemTimes[this->oldestItemIndex];
+		}
+	}
+
+	void LayersRateCalculator::Reset()
+	{
+		MS_TRACE();
+
+		std::fill(this->itemTimes.begin(), this->itemTimes.end(), 0u);
+		std::fill(this->itemCounts.begin(), this->itemCounts.end(), 0u);
+		std::fill(this->totalCounts.begin(), this->totalCounts.end(), 0u);
+
+		this->newestItemStartTime = 0u;
+		this->newestItemIndex     = -1;
+		this->oldestItemStartTime = 0u;
+		this->oldestItemIndex     = -1;
+	}
+
 	void RtpDataCounter::Update(RTC::RtpPacket* packet)
 	{
 		uint64_t nowMs = DepLibUV::GetTimeMs();
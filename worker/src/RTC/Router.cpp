@@ -3,8 +3,11 @@
 
 #include "RTC/Router.hpp"
 #include "ChannelMessageHandlers.hpp"
+#include "DepLibUV.hpp"
+#include "LatencyStats.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
+#include "Settings.hpp"
 #include "Utils.hpp"
 #include "RTC/ActiveSpeakerObserver.hpp"
 #include "RTC/AudioLevelObserver.hpp"
@@ -15,12 +18,28 @@
 
 namespace RTC
 {
+	/* Static. */
+
+	// Max time (in nanoseconds) spent collecting Consumer stats in a loop
+	// iteration.
+	static constexpr uint64_t ConsumersStatsSliceNs{ 1000000u };
+	static constexpr size_t MsgpackMap32HeaderLen{ 5u };
+
 	/* Instance methods. */
 
-	Router::Router(const std::string& id, Listener* listener) : id(id), listener(listener)
+	Router::Router(const std::string& id, Listener* listener, json& data)
+	  : id(id), listener(listener)
 	{
 		MS_TRACE();
 
+		auto jsonSharedRtpPacketHistoryIt = data.find("sharedRtpPacketHistory");
+
+		if (
+		  jsonSharedRtpPacketHistoryIt != data.end() && jsonSharedRtpPacketHistoryIt->is_boolean())
+		{
+			this->sharedRtpPacketHistory = jsonSharedRtpPacketHistoryIt->get<bool>();
+		}
+
 		// NOTE: This may throw.
 		ChannelMessageHandlers::RegisterHandler(
 		  this->id,
@@ -35,6 +54,17 @@ namespace RTC
 
 		ChannelMessageHandlers::UnregisterHandler(this->id);
 
+		// Reject pending stats requests.
+		for (auto& job : this->consumersStatsJobs)
+		{
+			job.request->Error("Router closed");
+
+			delete job.request;
+		}
+		this->consumersStatsJobs.clear();
+
+		delete this->consumersStatsTimer;
+
 		// Close all Transports.
 		for (auto& kv : this->mapTransports)
 		{
@@ -53,6 +83,15 @@ namespace RTC
 		}
 		this->mapRtpObservers.clear();
 
+		// Delete all packet histories (once their Consumers are deleted).
+		for (auto& kv : this->mapProducerRtpPacketHistory)
+		{
+			auto* packetHistory = kv.second;
+
+			delete packetHistory;
+		}
+		this->mapProducerRtpPacketHistory.clear();
+
 		// Clear other maps.
 		this->mapProducerConsumers.clear();
 		this->mapConsumerProducer.clear();
@@ -188,6 +227,34 @@ namespace RTC
 				break;
 			}
 
+			case Channel::ChannelRequest::MethodId::ROUTER_GET_CONSUMERS_STATS:
+			{
+				ConsumersStatsJob job;
+
+				job.request = request;
+
+				job.consumers.reserve(this->mapConsumerProducer.size());
+
+				for (const auto& kv : this->mapConsumerProducer)
+				{
+					job.consumers.push_back(kv.first);
+				}
+
+				this->consumersStatsJobs.push_back(std::move(job));
+
+				// It's replied and deleted once all stats are collected.
+				request->Defer();
+
+				if (!this->consumersStatsTimer)
+					this->consumersStatsTimer = new Timer(this);
+
+				// Collect them in the next loop iteration.
+				if (!this->consumersStatsTimer->IsActive())
+					this->consumersStatsTimer->Start(0u);
+
+				break;
+			}
+
 			case Channel::ChannelRequest::MethodId::ROUTER_CREATE_WEBRTC_TRANSPORT:
 			{
 				std::string transportId;
@@ -542,6 +609,80 @@ namespace RTC
 		return rtpObserver;
 	}
 
+	void Router::CollectConsumersStats()
+	{
+		MS_TRACE();
+
+		auto startNs = DepLibUV::GetTimeNs();
+		auto msgpack = Settings::configuration.channelFormat == Settings::ChannelFormat::MSGPACK;
+
+		while (!this->consumersStatsJobs.empty())
+		{
+			auto& job = this->consumersStatsJobs.front();
+
+			while (job.nextIdx < job.consumers.size())
+			{
+				auto* consumer = job.consumers[job.nextIdx++];
+
+				// Skip Consumers closed meanwhile.
+				if (this->mapConsumerProducer.find(consumer) == this->mapConsumerProducer.end())
+					continue;
+
+				json jsonArray = json::array();
+
+				consumer->FillJsonStats(jsonArray);
+
+				if (msgpack)
+				{
+					// Leave room for the map32 header.
+					if (job.data.empty())
+						job.data.assign(MsgpackMap32HeaderLen, '\0');
+
+					json::to_msgpack(consumer->id, job.data);
+					json::to_msgpack(jsonArray, job.data);
+				}
+				else
+				{
+					job.data.append(job.numEntries == 0u ? "{\"" : ",\"");
+					job.data.append(consumer->id);
+					job.data.append("\":");
+					job.data.append(jsonArray.dump());
+				}
+
+				++job.numEntries;
+
+				// Continue in the next loop iteration.
+				if (DepLibUV::GetTimeNs() - startNs >= ConsumersStatsSliceNs)
+				{
+					this->consumersStatsTimer->Start(0u);
+
+					return;
+				}
+			}
+
+			if (msgpack)
+			{
+				if (job.data.empty())
+					job.data.assign(MsgpackMap32HeaderLen, '\0');
+
+				auto* header = reinterpret_cast<uint8_t*>(std::addressof(job.data[0]));
+
+				header[0] = 0xDF;
+				Utils::Byte::Set4Bytes(header, 1, static_cast<uint32_t>(job.numEntries));
+			}
+			else
+			{
+				job.data.append(job.numEntries == 0u ? "{}" : "}");
+			}
+
+			job.request->Accept(job.data);
+
+			delete job.request;
+
+			this->consumersStatsJobs.pop_front();
+		}
+	}
+
 	inline void Router::OnTransportNewProducer(RTC::Transport* /*transport*/, RTC::Producer* producer)
 	{
 		MS_TRACE();
@@ -559,6 +700,12 @@ namespace RTC
 		this->mapProducers[producer->id] = producer;
 		this->mapProducerConsumers[producer];
 		this->mapProducerRtpObservers[producer];
+
+		if (this->sharedRtpPacketHistory)
+		{
+			this->mapProducerRtpPacketHistory[producer] =
+			  new RTC::RtpPacketHistory(RTC::RtpStreamSend::MaxRetransmissionDelay);
+		}
 	}
 
 	inline void Router::OnTransportProducerClosed(RTC::Transport* /*transport*/, RTC::Producer* producer)
@@ -600,6 +747,16 @@ namespace RTC
 			rtpObserver->RemoveProducer(producer);
 		}
 
+		// Delete the packet history once its Consumers are deleted.
+		auto mapProducerRtpPacketHistoryIt = this->mapProducerRtpPacketHistory.find(producer);
+
+		if (mapProducerRtpPacketHistoryIt != this->mapProducerRtpPacketHistory.end())
+		{
+			delete mapProducerRtpPacketHistoryIt->second;
+
+			this->mapProducerRtpPacketHistory.erase(mapProducerRtpPacketHistoryIt);
+		}
+
 		// Remove the Producer from the maps.
 		this->mapProducers.erase(mapProducersIt);
 		this->mapProducerConsumers.erase(mapProducerConsumersIt);
@@ -706,18 +863,18 @@ namespace RTC
 
 		if (!consumers.empty())
 		{
+			LatencyStats::Scope latencyScope(LatencyStats::Stage::ROUTER_FANOUT);
+
 			// Cloned ref-counted packet that RtpStreamSend will store for as long as
 			// needed avoiding multiple allocations unless absolutely necessary.
 			// Clone only happens if needed.
-			std::shared_ptr<RTC::RtpPacket> sharedPacket;
+			RTC::SharedRtpPacket sharedPacket;
 
+			// NOTE: Each consumer rewrites the packet header (including MID) into its
+			// own header overlay so the packet is not modified here.
 			for (auto* consumer : consumers)
 			{
-				// Update MID RTP extension value.
-				const auto& mid = consumer->GetRtpParameters().mid;
-
-				if (!mid.empty())
-					packet->UpdateMid(mid);
+				LatencyStats::Scope consumerLatencyScope(LatencyStats::Stage::CONSUMER_SEND);
 
 				consumer->SendRtpPacket(packet, sharedPacket);
 			}
@@ -782,6 +939,13 @@ namespace RTC
 		consumers.insert(consumer);
 		this->mapConsumerProducer[consumer] = producer;
 
+		// Make the Consumer store sent packets into the packet history of the
+		// Producer.
+		auto mapProducerRtpPacketHistoryIt = this->mapProducerRtpPacketHistory.find(producer);
+
+		if (mapProducerRtpPacketHistoryIt != this->mapProducerRtpPacketHistory.end())
+			consumer->ProducerRtpPacketHistory(mapProducerRtpPacketHistoryIt->second);
+
 		// Get all streams in the Producer and provide the Consumer with them.
 		for (const auto& kv : producer->GetRtpStreams())
 		{
@@ -1054,4 +1218,12 @@ namespace RTC
 
 		return producer;
 	}
+
+	inline void Router::OnTimer(Timer* timer)
+	{
+		MS_TRACE();
+
+		if (timer == this->consumersStatsTimer)
+			CollectConsumersStats();
+	}
 } // namespace RTC
@@ -37,7 +37,7 @@ namespace RTC
 			auto& mid      = kv.first;
 			auto* producer = kv.second;
 
-			(*jsonMidTableIt)[mid] = producer->id;
+			(*jsonMidTableIt)[mid.ToString()] = producer->id;
 		}
 
 		// Add ridTable.
@@ -46,7 +46,7 @@ namespace RTC
 			auto& rid      = kv.first;
 			auto* producer = kv.second;
 
-			(*jsonRidTableIt)[rid] = producer->id;
+			(*jsonRidTableIt)[rid.ToString()] = producer->id;
 		}
 	}
 
@@ -56,6 +56,20 @@ namespace RTC
 
 		const auto& rtpParameters = producer->GetRtpParameters();
 
+		// MID and RID values must fit into a Key.
+		if (rtpParameters.mid.size() > Key::MaxLength)
+		{
+			MS_THROW_ERROR("MID too long for RTP listener [mid:%s]", rtpParameters.mid.c_str());
+		}
+
+		for (auto& encoding : rtpParameters.encodings)
+		{
+			if (encoding.rid.size() > Key::MaxLength)
+			{
+				MS_THROW_ERROR("RID too long for RTP listener [rid:%s]", encoding.rid.c_str());
+			}
+		}
+
 		// Add entries into the ssrcTable.
 		for (auto& encoding : rtpParameters.encodings)
 		{
@@ -100,10 +114,11 @@ namespace RTC
 		if (!rtpParameters.mid.empty())
 		{
 			auto& mid = rtpParameters.mid;
+			Key key(reinterpret_cast<const uint8_t*>(mid.data()), mid.size());
 
-			if (this->midTable.find(mid) == this->midTable.end())
+			if (this->midTable.find(key) == this->midTable.end())
 			{
-				this->midTable[mid] = producer;
+				this->midTable[key] = producer;
 			}
 			else
 			{
@@ -121,9 +136,11 @@ namespace RTC
 			if (rid.empty())
 				continue;
 
-			if (this->ridTable.find(rid) == this->ridTable.end())
+			Key key(reinterpret_cast<const uint8_t*>(rid.data()), rid.size());
+
+			if (this->ridTable.find(key) == this->ridTable.end())
 			{
-				this->ridTable[rid] = producer;
+				this->ridTable[key] = producer;
 			}
 			// Just fail if no MID is given.
 			else if (rtpParameters.mid.empty())
@@ -141,28 +158,38 @@ namespace RTC
 
 		// Remove from the listener tables all entries pointing to the Producer.
 
+		// NOTE: The ssrcTable may have entries filled by GetProducer() so all of
+		// them must be checked.
 		for (auto it = this->ssrcTable.begin(); it != this->ssrcTable.end();)
 		{
 			if (it->second == producer)
-				it = this->ssrcTable.erase(it);
+				this->ssrcTable.erase(it++);
 			else
 				++it;
 		}
 
-		for (auto it = this->midTable.begin(); it != this->midTable.end();)
+		const auto& rtpParameters = producer->GetRtpParameters();
+		auto& mid                 = rtpParameters.mid;
+
+		if (!mid.empty() && mid.size() <= Key::MaxLength)
 		{
-			if (it->second == producer)
-				it = this->midTable.erase(it);
-			else
-				++it;
+			auto it = this->midTable.find(Key(reinterpret_cast<const uint8_t*>(mid.data()), mid.size()));
+
+			if (it != this->midTable.end() && it->second == producer)
+				this->midTable.erase(it);
 		}
 
-		for (auto it = this->ridTable.begin(); it != this->ridTable.end();)
+		for (auto& encoding : rtpParameters.encodings)
 		{
-			if (it->second == producer)
-				it = this->ridTable.erase(it);
-			else
-				++it;
+			auto& rid = encoding.rid;
+
+			if (rid.empty() || rid.size() > Key::MaxLength)
+				continue;
+
+			auto it = this->ridTable.find(Key(reinterpret_cast<const uint8_t*>(rid.data()), rid.size()));
+
+			if (it != this->ridTable.end() && it->second == producer)
+				this->ridTable.erase(it);
 		}
 	}
 
@@ -184,11 +211,12 @@ namespace RTC
 
 		// Otherwise lookup into the MID table.
 		{
-			std::string mid;
+			const uint8_t* mid;
+			uint8_t midLen;
 
-			if (packet->ReadMid(mid))
+			if (packet->ReadMid(mid, midLen) && midLen <= Key::MaxLength)
 			{
-				auto it = this->midTable.find(mid);
+				auto it = this->midTable.find(Key(mid, midLen));
 
 				if (it != this->midTable.end())
 				{
@@ -205,11 +233,12 @@ namespace RTC
 
 		// Otherwise lookup into the RID table.
 		{
-			std::string rid;
+			const uint8_t* rid;
+			uint8_t ridLen;
 
-			if (packet->ReadRid(rid))
+			if (packet->ReadRid(rid, ridLen) && ridLen <= Key::MaxLength)
 			{
-				auto it = this->ridTable.find(rid);
+				auto it = this->ridTable.find(Key(rid, ridLen));
 
 				if (it != this->ridTable.end())
 				{
@@ -0,0 +1,257 @@
+#define MS_CLASS "RTC::RtpPacingQueue"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "RTC/RtpPacingQueue.hpp"
+#include "Logger.hpp"
+#include "RTC/SimulcastConsumer.hpp"
+#include <algorithm> // std::remove_if()
+
+namespace RTC
+{
+	/* Static. */
+
+	// Max time (in ms) a packet can stay in the queue, per priority.
+	static constexpr uint32_t MaxQueueTimes[RtpPacingQueue::NumPriorities]{
+		100u, // AUDIO.
+		250u, // RETRANSMISSION.
+		250u, // VIDEO_BASE_LAYER.
+		250u  // VIDEO_UPPER_LAYER.
+	};
+	// What to do with packets that exceed their max queue time, per priority.
+	// Late audio and retransmissions are useless and dropped upper layer video
+	// packets are retransmitted on demand, but losing base layer packets would
+	// make receivers request a key frame, so they are sent anyway.
+	static constexpr RtpPacingQueue::DropPolicy DropPolicies[RtpPacingQueue::NumPriorities]{
+		RtpPacingQueue::DropPolicy::DROP, // AUDIO.
+		RtpPacingQueue::DropPolicy::DROP, // RETRANSMISSION.
+		RtpPacingQueue::DropPolicy::SEND, // VIDEO_BASE_LAYER.
+		RtpPacingQueue::DropPolicy::DROP  // VIDEO_UPPER_LAYER.
+	};
+
+	/* Class methods. */
+
+	uint32_t RtpPacingQueue::GetMaxQueueTime(Priority priority)
+	{
+		return MaxQueueTimes[static_cast<uint8_t>(priority)];
+	}
+
+	RtpPacingQueue::DropPolicy RtpPacingQueue::GetDropPolicy(Priority priority)
+	{
+		return DropPolicies[static_cast<uint8_t>(priority)];
+	}
+
+	RtpPacingQueue::Priority RtpPacingQueue::GetPriority(
+	  const RTC::Consumer* consumer, const RTC::RtpPacket* packet, bool retransmission)
+	{
+		if (consumer->GetKind() == RTC::Media::Kind::AUDIO)
+			return Priority::AUDIO;
+		else if (retransmission)
+			return Priority::RETRANSMISSION;
+
+		int16_t spatialLayer;
+
+		// The payload descriptor of a simulcast stream does not tell its spatial
+		// layer, which is the stream currently sent by the Consumer.
+		if (consumer->GetType() == RTC::RtpParameters::Type::SIMULCAST)
+		{
+			spatialLayer = static_cast<const RTC::SimulcastConsumer*>(consumer)->GetCurrentSpatialLayer();
+		}
+		else
+		{
+			spatialLayer = packet->GetSpatialLayer();
+		}
+
+		if (spatialLayer == 0 && packet->GetTemporalLayer() == 0u)
+			return Priority::VIDEO_BASE_LAYER;
+		else
+			return Priority::VIDEO_UPPER_LAYER;
+	}
+
+	/* Instance methods. */
+
+	bool RtpPacingQueue::Enqueue(
+	  RTC::Consumer* consumer,
+	  const RTC::RtpPacket* packet,
+	  Priority priority,
+	  bool retransmission,
+	  uint64_t nowMs)
+	{
+		MS_TRACE();
+
+		if (this->size >= this->maxSize)
+		{
+			// Make room by dropping the oldest packet with the lowest priority, if
+			// lower than the priority of the given packet.
+			for (int8_t idx{ NumPriorities - 1 }; idx > static_cast<int8_t>(priority); --idx)
+			{
+				auto& queue = this->queues[idx];
+
+				if (!queue.empty())
+				{
+					Drop(queue);
+
+					break;
+				}
+			}
+
+			if (this->size >= this->maxSize)
+			{
+				MS_DEBUG_DEV("queue full, packet dropped [ssrc:%" PRIu32 "]", packet->GetSsrc());
+
+				this->droppedPackets++;
+				this->droppedPacketsPerPriority[static_cast<uint8_t>(priority)]++;
+
+				return false;
+			}
+		}
+
+		this->queues[static_cast<uint8_t>(priority)].emplace_back(
+		  consumer, packet->Clone(), priority, retransmission, nowMs);
+
+		this->size++;
+		this->bytes += packet->GetSize();
+
+		return true;
+	}
+
+	RtpPacingQueue::Item* RtpPacingQueue::Front(uint64_t nowMs, bool& expired)
+	{
+		MS_TRACE();
+
+		this->frontQueueIdx = -1;
+		expired             = false;
+
+		if (this->size == 0u)
+			return nullptr;
+
+		DropExpired(nowMs);
+
+		// Expired packets to be sent regardless of the pacing budget go first.
+		for (uint8_t idx{ 0u }; idx < NumPriorities; ++idx)
+		{
+			auto& queue = this->queues[idx];
+
+			if (DropPolicies[idx] != DropPolicy::SEND || queue.empty())
+				continue;
+
+			if (nowMs - queue.front().enqueuedAtMs > MaxQueueTimes[idx])
+			{
+				this->frontQueueIdx = static_cast<int8_t>(idx);
+				expired             = true;
+
+				return std::addressof(queue.front());
+			}
+		}
+
+		for (uint8_t idx{ 0u }; idx < NumPriorities; ++idx)
+		{
+			auto& queue = this->queues[idx];
+
+			if (!queue.empty())
+			{
+				this->frontQueueIdx = static_cast<int8_t>(idx);
+
+				return std::addressof(queue.front());
+			}
+		}
+
+		return nullptr;
+	}
+
+	RTC::SharedRtpPacket RtpPacingQueue::Pop()
+	{
+		MS_TRACE();
+
+		MS_ASSERT(this->frontQueueIdx != -1, "no packet returned by Front()");
+
+		auto& queue = this->queues[this->frontQueueIdx];
+		auto packet = std::move(queue.front().packet);
+
+		this->size--;
+		this->bytes -= packet->GetSize();
+
+		queue.pop_front();
+
+		this->frontQueueIdx = -1;
+
+		return packet;
+	}
+
+	void RtpPacingQueue::RemoveConsumer(RTC::Consumer* consumer)
+	{
+		MS_TRACE();
+
+		for (auto& queue : this->queues)
+		{
+			auto it = std::remove_if(
+			  queue.begin(),
+			  queue.end(),
+			  [this, consumer](const Item& item)
+			  {
+				  if (item.consumer != consumer)
+					  return false;
+
+				  this->size--;
+				  this->bytes -= item.packet->GetSize();
+
+				  return true;
+			  });
+
+			queue.erase(it, queue.end());
+		}
+
+		this->frontQueueIdx = -1;
+	}
+
+	void RtpPacingQueue::Clear()
+	{
+		MS_TRACE();
+
+		for (auto& queue : this->queues)
+		{
+			queue.clear();
+		}
+
+		this->frontQueueIdx = -1;
+		this->size          = 0u;
+		this->bytes         = 0u;
+	}
+
+	void RtpPacingQueue::DropExpired(uint64_t nowMs)
+	{
+		MS_TRACE();
+
+		for (uint8_t idx{ 0u }; idx < NumPriorities; ++idx)
+		{
+			auto& queue = this->queues[idx];
+
+			if (DropPolicies[idx] != DropPolicy::DROP)
+				continue;
+
+			while (!queue.empty() && nowMs - queue.front().enqueuedAtMs > MaxQueueTimes[idx])
+			{
+				Drop(queue);
+			}
+		}
+	}
+
+	inline void RtpPacingQueue::Drop(std::deque<Item>& queue)
+	{
+		MS_TRACE();
+
+		auto& item = queue.front();
+
+		MS_DEBUG_DEV(
+		  "packet dropped [priority:%" PRIu8 ", ssrc:%" PRIu32 ", seq:%" PRIu16 "]",
+		  static_cast<uint8_t>(item.priority),
+		  item.packet->GetSsrc(),
+		  item.packet->GetSequenceNumber());
+
+		this->size--;
+		this->bytes -= item.packet->GetSize();
+		this->droppedPackets++;
+		this->droppedPacketsPerPriority[static_cast<uint8_t>(item.priority)]++;
+
+		queue.pop_front();
+	}
+} // namespace RTC
@@ -3,12 +3,94 @@
 
 #include "RTC/RtpPacket.hpp"
 #include "Logger.hpp"
-#include <cstring>  // std::memcpy(), std::memmove(), std::memset()
+#include <cstddef>  // offsetof()
+#include <cstring>  // std::memcmp(), std::memcpy(), std::memmove(), std::memset()
 #include <iterator> // std::ostream_iterator
 #include <sstream>  // std::ostringstream
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace RTC
 {
+	/* Static. */
+
+	// Returns a pointer to the first non zero byte in [ptr, end), or `end`.
+	// Padding is usually short so the first byte is checked before scanning 16
+	// bytes at a time.
+	inline static uint8_t* skipZeroBytes(uint8_t* ptr, const uint8_t* end)
+	{
+		if (ptr >= end || *ptr != 0u)
+			return ptr;
+
+#if defined(__SSE2__)
+		const __m128i zero = _mm_setzero_si128();
+
+		while (end - ptr >= 16)
+		{
+			auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+			auto mask  = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero)));
+
+			if (mask != 0xFFFFu)
+				return ptr + Utils::Bits::GetLowestSetBit(~mask & 0xFFFFu);
+
+			ptr += 16;
+		}
+#elif defined(__ARM_NEON)
+		while (end - ptr >= 16)
+		{
+			auto words = vreinterpretq_u64_u8(vld1q_u8(ptr));
+
+			if ((vgetq_lane_u64(words, 0) | vgetq_lane_u64(words, 1)) != 0u)
+				break;
+
+			ptr += 16;
+		}
+#endif
+
+		while (ptr < end && *ptr == 0u)
+		{
+			++ptr;
+		}
+
+		return ptr;
+	}
+
+	static constexpr size_t SerializationBufferSize{ 65536u };
+	thread_local static uint8_t SerializationBuffer[SerializationBufferSize];
+
+	// Memory of a cloned RtpPacket. The RtpPacket (which holds its reference
+	// counter) and its buffer are contiguous in the same slab slot.
+	struct ClonedRtpPacket
+	{
+		using Allocator       = Utils::SlabAllocator<ClonedRtpPacket>;
+		using AllocatorTraits = std::allocator_traits<Allocator>;
+
+		// NOTE: User provided so the buffer is not zeroed.
+		ClonedRtpPacket()
+		{
+		}
+
+		~ClonedRtpPacket()
+		{
+			GetPacket()->~RtpPacket();
+		}
+
+		RtpPacket* GetPacket()
+		{
+			return reinterpret_cast<RtpPacket*>(this->packet);
+		}
+
+		RtpPacket::RtpPacketBuffer buffer;
+		// Constructed in place once the buffer is filled.
+		alignas(RtpPacket) uint8_t packet[sizeof(RtpPacket)];
+	};
+
+	// RtpPacket::ReleaseCloned() gets the ClonedRtpPacket from the packet buffer.
+	static_assert(offsetof(ClonedRtpPacket, buffer) == 0, "buffer must be the first member");
+
 	/* Static Class methods. */
 
 	void RtpPacket::Deallocate(RtpPacket* packet)
@@ -165,13 +247,8 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		// This is a cloned RtpPacket.
-		if (this->buffer)
-		{
-			this->buffer->~array();
-			RtpPacket::BufferAllocator::Pool.deallocate(this->buffer, 1);
-			this->buffer = nullptr;
-		}
+		// NOTE: The buffer of a cloned RtpPacket is freed along with it (see
+		// ClonedRtpPacket).
 	}
 
 	void RtpPacket::Dump() const
@@ -200,21 +277,9 @@ namespace RTC
 			std::vector<std::string> extIds;
 			std::ostringstream extIdsStream;
 
-			if (HasOneByteExtensions())
+			for (uint8_t i{ 0u }; i < this->numExtensionElements; ++i)
 			{
-				for (const auto& extension : this->oneByteExtensions)
-				{
-					extIds.push_back(std::to_string(extension->id));
-				}
-			}
-			else
-			{
-				extIds.reserve(this->mapTwoBytesExtensions.size());
-
-				for (const auto& kv : this->mapTwoBytesExtensions)
-				{
-					extIds.push_back(std::to_string(kv.first));
-				}
+				extIds.push_back(std::to_string(this->extensionElementIds[i]));
 			}
 
 			if (!extIds.empty())
@@ -391,42 +456,6 @@ namespace RTC
 	{
 		MS_ASSERT(type == 1u || type == 2u, "type must be 1 or 2");
 
-		// Reset extension ids.
-		this->midExtensionId               = 0u;
-		this->ridExtensionId               = 0u;
-		this->rridExtensionId              = 0u;
-		this->absSendTimeExtensionId       = 0u;
-		this->transportWideCc01ExtensionId = 0u;
-		this->frameMarking07ExtensionId    = 0u;
-		this->frameMarkingExtensionId      = 0u;
-		this->ssrcAudioLevelExtensionId    = 0u;
-		this->videoOrientationExtensionId  = 0u;
-
-		// Clear the One-Byte and Two-Bytes extension elements maps.
-		std::fill(std::begin(this->oneByteExtensions), std::end(this->oneByteExtensions), nullptr);
-		this->mapTwoBytesExtensions.clear();
-
-		// If One-Byte is requested and the packet already has One-Byte extensions,
-		// keep the header extension id.
-		if (type == 1u && HasOneByteExtensions())
-		{
-			// Nothing to do.
-		}
-		// If Two-Bytes is requested and the packet already has Two-Bytes extensions,
-		// keep the header extension id.
-		else if (type == 2u && HasTwoBytesExtensions())
-		{
-			// Nothing to do.
-		}
-		// Otherwise, if there is header extension of non matching type, modify its id.
-		else if (this->headerExtension)
-		{
-			if (type == 1u)
-				this->headerExtension->id = uint16_t{ htons(0xBEDE) };
-			else if (type == 2u)
-				this->headerExtension->id = uint16_t{ htons(0b0001000000000000) };
-		}
-
 		// Calculate total size required for all extensions (with padding if needed).
 		size_t extensionsTotalSize{ 0 };
 
@@ -452,60 +481,8 @@ namespace RTC
 		  static_cast<size_t>(Utils::Byte::PadTo4Bytes(static_cast<uint16_t>(extensionsTotalSize)));
 		size_t padding = paddedExtensionsTotalSize - extensionsTotalSize;
 
-		extensionsTotalSize = paddedExtensionsTotalSize;
-
-		// Calculate the number of bytes to shift (may be negative if the packet did
-		// already have header extension).
-		int16_t shift{ 0 };
-
-		if (this->headerExtension)
-		{
-			shift = static_cast<int16_t>(extensionsTotalSize - GetHeaderExtensionLength());
-		}
-		else
-		{
-			shift = 4 + static_cast<int16_t>(extensionsTotalSize);
-		}
-
-		if (this->headerExtension && shift != 0)
-		{
-			// Shift the payload.
-			std::memmove(this->payload + shift, this->payload, this->payloadLength + this->payloadPadding);
-			this->payload += shift;
-
-			// Update packet total size.
-			this->size += shift;
-
-			// Update the header extension length.
-			this->headerExtension->length = htons(extensionsTotalSize / 4);
-		}
-		else if (!this->headerExtension)
-		{
-			// Set the header extension bit.
-			this->header->extension = 1u;
-
-			// Set the header extension pointing to the current payload.
-			this->headerExtension = reinterpret_cast<HeaderExtension*>(this->payload);
-
-			// Shift the payload.
-			std::memmove(this->payload + shift, this->payload, this->payloadLength + this->payloadPadding);
-			this->payload += shift;
-
-			// Update packet total size.
-			this->size += shift;
-
-			// Set the header extension id.
-			if (type == 1u)
-				this->headerExtension->id = uint16_t{ htons(0xBEDE) };
-			else if (type == 2u)
-				this->headerExtension->id = uint16_t{ htons(0b0001000000000000) };
-
-			// Set the header extension length.
-			this->headerExtension->length = htons(extensionsTotalSize / 4);
-		}
-
 		// Write the new extensions into the header extension value.
-		uint8_t* ptr = this->headerExtension->value;
+		uint8_t* ptr = ResetHeaderExtension(type, paddedExtensionsTotalSize);
 
 		for (const auto& extension : extensions)
 		{
@@ -514,9 +491,7 @@ namespace RTC
 				if (extension.id == 0 || extension.id > 14 || extension.len == 0 || extension.len > 16)
 					continue;
 
-				// Store the One-Byte extension element in an array.
-				// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
-				this->oneByteExtensions[extension.id - 1] = reinterpret_cast<OneByteExtension*>(ptr);
+				SetExtensionElement(extension.id, ptr);
 
 				*ptr = (extension.id << 4) | ((extension.len - 1) & 0x0F);
 				++ptr;
@@ -528,8 +503,7 @@ namespace RTC
 				if (extension.id == 0)
 					continue;
 
-				// Store the Two-Bytes extension element in the map.
-				this->mapTwoBytesExtensions[extension.id] = reinterpret_cast<TwoBytesExtension*>(ptr);
+				SetExtensionElement(extension.id, ptr);
 
 				*ptr = extension.id;
 				++ptr;
@@ -549,6 +523,37 @@ namespace RTC
 		MS_ASSERT(ptr == this->payload, "wrong ptr calculation");
 	}
 
+	void RtpPacket::SetSerializedExtensions(uint8_t type, const uint8_t* data, size_t len)
+	{
+		MS_ASSERT(type == 1u || type == 2u, "type must be 1 or 2");
+		MS_ASSERT(len % 4 == 0, "len must be multiple of 4");
+
+		uint8_t* ptr = ResetHeaderExtension(type, len);
+		uint8_t* end = ptr + len;
+
+		std::memcpy(ptr, data, len);
+
+		// Elements are contiguous so the first zero byte starts the padding.
+		if (type == 1u)
+		{
+			while (ptr < end && *ptr != 0u)
+			{
+				SetExtensionElement(*ptr >> 4, ptr);
+
+				ptr += 2 + (*ptr & 0x0F);
+			}
+		}
+		else
+		{
+			while (ptr + 1 < end && *ptr != 0u)
+			{
+				SetExtensionElement(*ptr, ptr);
+
+				ptr += 2 + ptr[1];
+			}
+		}
+	}
+
 	bool RtpPacket::UpdateMid(const std::string& mid)
 	{
 		MS_TRACE();
@@ -571,6 +576,15 @@ namespace RTC
 			return false;
 		}
 
+		// If there is a header overlay just keep a reference to the MID, it will be
+		// written into the serialized packet.
+		if (this->headerOverlay)
+		{
+			this->headerOverlay->mid = &mid;
+
+			return true;
+		}
+
 		std::memcpy(extenValue, mid.c_str(), mid.size());
 
 		SetExtensionLength(this->midExtensionId, mid.size());
@@ -599,8 +613,7 @@ namespace RTC
 		}
 		else if (HasOneByteExtensions())
 		{
-			// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
-			auto* extension = this->oneByteExtensions[id - 1];
+			auto* extension = reinterpret_cast<OneByteExtension*>(GetExtensionElement(id));
 
 			if (!extension)
 				return false;
@@ -618,12 +631,11 @@ namespace RTC
 		}
 		else if (HasTwoBytesExtensions())
 		{
-			auto it = this->mapTwoBytesExtensions.find(id);
+			auto* extension = reinterpret_cast<TwoBytesExtension*>(GetExtensionElement(id));
 
-			if (it == this->mapTwoBytesExtensions.end())
+			if (!extension)
 				return false;
 
-			auto* extension = it->second;
 			auto currentLen = extension->len;
 
 			// Fill with 0's if new length is minor.
@@ -656,12 +668,42 @@ namespace RTC
 		SetPayloadPaddingFlag(false);
 	}
 
-	std::shared_ptr<RtpPacket> RtpPacket::Clone() const
+	const uint8_t* RtpPacket::GetSerializedHeader() const
+	{
+		MS_TRACE();
+
+		if (!this->headerOverlay)
+			return GetData();
+
+		const size_t headerLength = GetSerializedHeaderLength();
+
+		MS_ASSERT(headerLength <= SerializationBufferSize, "header too big");
+
+		std::memcpy(SerializationBuffer, GetData(), headerLength);
+		ApplyHeaderOverlay(SerializationBuffer);
+
+		return SerializationBuffer;
+	}
+
+	size_t RtpPacket::Serialize(uint8_t* buffer) const
 	{
 		MS_TRACE();
 
-		auto* buffer = RtpPacket::BufferAllocator::Pool.allocate(1);
-		RtpPacket::BufferAllocatorTraits::construct(RtpPacket::BufferAllocator::Pool, buffer);
+		std::memcpy(buffer, GetData(), this->size);
+
+		if (this->headerOverlay)
+			ApplyHeaderOverlay(buffer);
+
+		return this->size;
+	}
+
+	SharedRtpPacket RtpPacket::Clone() const
+	{
+		MS_TRACE();
+
+		auto* cloned = ClonedRtpPacket::Allocator::Pool.allocate(1);
+		ClonedRtpPacket::AllocatorTraits::construct(ClonedRtpPacket::Allocator::Pool, cloned);
+		auto* buffer = std::addressof(cloned->buffer);
 
 		auto* ptr = const_cast<uint8_t*>(buffer->data());
 
@@ -720,15 +762,13 @@ namespace RTC
 		MS_ASSERT(
 		  static_cast<size_t>(ptr - buffer->data()) == this->size, "ptr - buffer->data() == this->size");
 
-		// Create the new RtpPacket instance and return it.
-		std::shared_ptr<RtpPacket> shared = std::allocate_shared<RtpPacket, RtpPacket::Allocator>(
-		  RtpPacket::Allocator::Pool,
-		  newHeader,
-		  newHeaderExtension,
-		  newPayload,
-		  this->payloadLength,
-		  this->payloadPadding,
-		  this->size);
+		// The cloned packet gets the header values of the overlay (if any).
+		if (this->headerOverlay)
+			ApplyHeaderOverlay(buffer->data());
+
+		// Create the new RtpPacket instance in the cloned memory and return it.
+		auto* shared = new (cloned->packet) RtpPacket(
+		  newHeader, newHeaderExtension, newPayload, this->payloadLength, this->payloadPadding, this->size);
 
 		shared->midExtensionId               = this->midExtensionId;
 		shared->ridExtensionId               = this->ridExtensionId;
@@ -743,8 +783,11 @@ namespace RTC
 		shared->payloadDescriptorHandler = this->payloadDescriptorHandler;
 		// Store allocated buffer.
 		shared->buffer = buffer;
+#ifndef NDEBUG
+		shared->ownerThreadId = std::this_thread::get_id();
+#endif
 
-		return shared;
+		return SharedRtpPacket(shared);
 	}
 
 	// NOTE: The caller must ensure that the buffer/memmory of the packet has
@@ -828,6 +871,30 @@ namespace RTC
 		if (!this->payloadDescriptorHandler)
 			return true;
 
+		// The payload may be shared with other consumers, so rewrite a copy of
+		// its first bytes in the header overlay.
+		if (this->headerOverlay)
+		{
+			auto* overlay = this->headerOverlay;
+			size_t length = this->payloadLength;
+
+			if (length > Codecs::PayloadDescriptorHandler::MaxProcessedLength)
+				length = Codecs::PayloadDescriptorHandler::MaxProcessedLength;
+
+			std::memcpy(overlay->payloadDescriptor, this->payload, length);
+
+			overlay->payloadDescriptorLength = 0u;
+
+			if (!this->payloadDescriptorHandler->Process(context, overlay->payloadDescriptor, marker))
+				return false;
+
+			// Only apply it if it was rewritten.
+			if (std::memcmp(overlay->payloadDescriptor, this->payload, length) != 0)
+				overlay->payloadDescriptorLength = static_cast<uint8_t>(length);
+
+			return true;
+		}
+
 		if (this->payloadDescriptorHandler->Process(context, this->payload, marker))
 		{
 			return true;
@@ -883,16 +950,112 @@ namespace RTC
 		}
 	}
 
+	/**
+	 * Sets a header extension of the given type with room for `len` bytes of
+	 * extension elements, shifting the payload. Returns a pointer to the room.
+	 */
+	uint8_t* RtpPacket::ResetHeaderExtension(uint8_t type, size_t len)
+	{
+		MS_TRACE();
+
+		// Reset extension ids.
+		this->midExtensionId               = 0u;
+		this->ridExtensionId               = 0u;
+		this->rridExtensionId              = 0u;
+		this->absSendTimeExtensionId       = 0u;
+		this->transportWideCc01ExtensionId = 0u;
+		this->frameMarking07ExtensionId    = 0u;
+		this->frameMarkingExtensionId      = 0u;
+		this->ssrcAudioLevelExtensionId    = 0u;
+		this->videoOrientationExtensionId  = 0u;
+
+		// Clear the One-Byte and Two-Bytes extension elements.
+		ClearExtensionElements();
+
+		// If One-Byte is requested and the packet already has One-Byte extensions,
+		// keep the header extension id.
+		if (type == 1u && HasOneByteExtensions())
+		{
+			// Nothing to do.
+		}
+		// If Two-Bytes is requested and the packet already has Two-Bytes extensions,
+		// keep the header extension id.
+		else if (type == 2u && HasTwoBytesExtensions())
+		{
+			// Nothing to do.
+		}
+		// Otherwise, if there is header extension of non matching type, modify its id.
+		else if (this->headerExtension)
+		{
+			if (type == 1u)
+				this->headerExtension->id = uint16_t{ htons(0xBEDE) };
+			else if (type == 2u)
+				this->headerExtension->id = uint16_t{ htons(0b0001000000000000) };
+		}
+
+		// Calculate the number of bytes to shift (may be negative if the packet did
+		// already have header extension).
+		int16_t shift{ 0 };
+
+		if (this->headerExtension)
+		{
+			shift = static_cast<int16_t>(len - GetHeaderExtensionLength());
+		}
+		else
+		{
+			shift = 4 + static_cast<int16_t>(len);
+		}
+
+		if (this->headerExtension && shift != 0)
+		{
+			// Shift the payload.
+			std::memmove(this->payload + shift, this->payload, this->payloadLength + this->payloadPadding);
+			this->payload += shift;
+
+			// Update packet total size.
+			this->size += shift;
+
+			// Update the header extension length.
+			this->headerExtension->length = htons(len / 4);
+		}
+		else if (!this->headerExtension)
+		{
+			// Set the header extension bit.
+			this->header->extension = 1u;
+
+			// Set the header extension pointing to the current payload.
+			this->headerExtension = reinterpret_cast<HeaderExtension*>(this->payload);
+
+			// Shift the payload.
+			std::memmove(this->payload + shift, this->payload, this->payloadLength + this->payloadPadding);
+			this->payload += shift;
+
+			// Update packet total size.
+			this->size += shift;
+
+			// Set the header extension id.
+			if (type == 1u)
+				this->headerExtension->id = uint16_t{ htons(0xBEDE) };
+			else if (type == 2u)
+				this->headerExtension->id = uint16_t{ htons(0b0001000000000000) };
+
+			// Set the header extension length.
+			this->headerExtension->length = htons(len / 4);
+		}
+
+		return this->headerExtension->value;
+	}
+
 	void RtpPacket::ParseExtensions()
 	{
 		MS_TRACE();
 
+		// Clear the One-Byte and Two-Bytes extension elements.
+		ClearExtensionElements();
+
 		// Parse One-Byte header extension.
 		if (HasOneByteExtensions())
 		{
-			// Clear the One-Byte extension elements map.
-			std::fill(std::begin(this->oneByteExtensions), std::end(this->oneByteExtensions), nullptr);
-
 			uint8_t* extensionStart = reinterpret_cast<uint8_t*>(this->headerExtension) + 4;
 			uint8_t* extensionEnd   = extensionStart + GetHeaderExtensionLength();
 			uint8_t* ptr            = extensionStart;
@@ -918,9 +1081,7 @@ namespace RTC
 						break;
 					}
 
-					// Store the One-Byte extension element in an array.
-					// `-1` because we have 14 elements total 0..13 and `id` is in the range 1..14.
-					this->oneByteExtensions[id - 1] = reinterpret_cast<OneByteExtension*>(ptr);
+					SetExtensionElement(id, ptr);
 
 					ptr += (1 + len);
 				}
@@ -930,19 +1091,13 @@ namespace RTC
 					++ptr;
 				}
 
-				// Counting padding bytes.
-				while ((ptr < extensionEnd) && (*ptr == 0))
-				{
-					++ptr;
-				}
+				// Skip padding bytes.
+				ptr = skipZeroBytes(ptr, extensionEnd);
 			}
 		}
 		// Parse Two-Bytes header extension.
 		else if (HasTwoBytesExtensions())
 		{
-			// Clear the Two-Bytes extension elements map.
-			this->mapTwoBytesExtensions.clear();
-
 			uint8_t* extensionStart = reinterpret_cast<uint8_t*>(this->headerExtension) + 4;
 			uint8_t* extensionEnd   = extensionStart + GetHeaderExtensionLength();
 			uint8_t* ptr            = extensionStart;
@@ -967,8 +1122,7 @@ namespace RTC
 						break;
 					}
 
-					// Store the Two-Bytes extension element in the map.
-					this->mapTwoBytesExtensions[id] = reinterpret_cast<TwoBytesExtension*>(ptr);
+					SetExtensionElement(id, ptr);
 
 					ptr += (2 + len);
 				}
@@ -978,12 +1132,172 @@ namespace RTC
 					++ptr;
 				}
 
-				// Counting padding bytes.
-				while ((ptr < extensionEnd) && (*ptr == 0))
-				{
-					++ptr;
-				}
+				// Skip padding bytes.
+				ptr = skipZeroBytes(ptr, extensionEnd);
+			}
+		}
+	}
+
+	void RtpPacket::SetExtensionElement(uint8_t id, const uint8_t* ptr)
+	{
+		auto offset = static_cast<uint16_t>(ptr - reinterpret_cast<uint8_t*>(this->headerExtension));
+		uint8_t idx{ 0u };
+
+		while (idx < this->numExtensionElements && this->extensionElementIds[idx] < id)
+		{
+			++idx;
+		}
+
+		// The last element with a given id wins.
+		if (idx < this->numExtensionElements && this->extensionElementIds[idx] == id)
+		{
+			this->extensionElementOffsets[idx] = offset;
+
+			return;
+		}
+
+		// Only possible with Two-Bytes extensions, remaining ids will be looked up
+		// in the packet.
+		if (this->numExtensionElements == MaxExtensionElements)
+		{
+			this->extensionElementsOverflow = true;
+
+			return;
+		}
+
+		for (uint8_t i{ this->numExtensionElements }; i > idx; --i)
+		{
+			this->extensionElementIds[i]     = this->extensionElementIds[i - 1];
+			this->extensionElementOffsets[i] = this->extensionElementOffsets[i - 1];
+		}
+
+		this->extensionElementIds[idx]     = id;
+		this->extensionElementOffsets[idx] = offset;
+		++this->numExtensionElements;
+	}
+
+	uint8_t* RtpPacket::FindTwoBytesExtensionElement(uint8_t id) const
+	{
+		MS_TRACE();
+
+		uint8_t* extensionStart = reinterpret_cast<uint8_t*>(this->headerExtension) + 4;
+		uint8_t* extensionEnd   = extensionStart + GetHeaderExtensionLength();
+		uint8_t* ptr            = extensionStart;
+		uint8_t* element{ nullptr };
+
+		// Same as in ParseExtensions(), the last element with the given id wins.
+		while (ptr + 1 < extensionEnd)
+		{
+			uint8_t len = *(ptr + 1);
+
+			if (*ptr != 0u)
+			{
+				if (ptr + 2 + len > extensionEnd)
+					break;
+
+				if (*ptr == id)
+					element = ptr;
+
+				ptr += (2 + len);
+			}
+			else
+			{
+				++ptr;
+			}
+
+			ptr = skipZeroBytes(ptr, extensionEnd);
+		}
+
+		return element;
+	}
+
+	/**
+	 * Writes the header overlay into the given data, which must be a copy of
+	 * this packet.
+	 */
+	void RtpPacket::ApplyHeaderOverlay(uint8_t* data) const
+	{
+		MS_TRACE();
+
+		const auto* overlay = this->headerOverlay;
+		auto* header        = reinterpret_cast<Header*>(data);
+		uint8_t extenLen;
+		uint8_t* extenValue;
+
+		header->marker         = overlay->marker;
+		header->sequenceNumber = uint16_t{ htons(overlay->sequenceNumber) };
+		header->timestamp      = uint32_t{ htonl(overlay->timestamp) };
+		header->ssrc           = uint32_t{ htonl(overlay->ssrc) };
+
+		if (overlay->mid && !overlay->mid->empty())
+		{
+			extenValue = GetExtension(this->midExtensionId, extenLen);
+
+			// NOTE: UpdateMid() already checked that the MID fits.
+			if (extenValue)
+			{
+				const auto midLen = static_cast<uint8_t>(overlay->mid->size());
+				auto* value       = data + (extenValue - GetData());
+
+				std::memcpy(value, overlay->mid->c_str(), midLen);
+
+				// Fill with 0's if new length is minor.
+				if (midLen < extenLen)
+					std::memset(value + midLen, 0, extenLen - midLen);
+
+				// Rewrite the extension length, which is the byte before the value.
+				// In One-Byte extensions value length 0 means 1.
+				if (HasOneByteExtensions())
+					*(value - 1) = (this->midExtensionId << 4) | (midLen - 1);
+				else
+					*(value - 1) = midLen;
 			}
 		}
+
+		if (overlay->hasAbsSendTime)
+		{
+			extenValue = GetExtension(this->absSendTimeExtensionId, extenLen);
+
+			if (extenValue)
+				Utils::Byte::Set3Bytes(data + (extenValue - GetData()), 0, overlay->absSendTime);
+		}
+
+		if (overlay->hasTransportWideCc01)
+		{
+			extenValue = GetExtension(this->transportWideCc01ExtensionId, extenLen);
+
+			if (extenValue)
+				Utils::Byte::Set2Bytes(data + (extenValue - GetData()), 0, overlay->wideSeqNumber);
+		}
+
+		if (overlay->payloadDescriptorLength != 0u)
+		{
+			std::memcpy(
+			  data + (this->payload - GetData()),
+			  overlay->payloadDescriptor,
+			  overlay->payloadDescriptorLength);
+		}
+	}
+
+	void RtpPacket::ReleaseCloned()
+	{
+		MS_TRACE();
+
+		MS_ASSERT(this->buffer, "not a cloned packet");
+
+		// Destroy this RtpPacket along with its memory.
+		auto* cloned = reinterpret_cast<ClonedRtpPacket*>(this->buffer);
+
+		cloned->~ClonedRtpPacket();
+		ClonedRtpPacket::Allocator::Pool.deallocate(cloned, 1);
+	}
+
+#ifndef NDEBUG
+	void SharedRtpPacket::AssertOwnerThread() const
+	{
+		MS_ASSERT(
+		  this->packet->ownerThreadId == std::this_thread::get_id(),
+		  "cloned RtpPacket used from a thread other than the one that cloned it");
 	}
+#endif
 } // namespace RTC
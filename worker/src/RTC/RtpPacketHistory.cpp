@@ -0,0 +1,142 @@
+#define MS_CLASS "RTC::RtpPacketHistory"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "RTC/RtpPacketHistory.hpp"
+#include "Logger.hpp"
+
+namespace RTC
+{
+	/* Static. */
+
+	static constexpr size_t InitialCapacity{ 64u };
+
+	/* Instance methods. */
+
+	RtpPacketHistory::RtpPacketHistory(uint32_t maxAgeMs) : maxAgeMs(maxAgeMs)
+	{
+		MS_TRACE();
+	}
+
+	uint32_t RtpPacketHistory::Store(
+	  RTC::RtpPacket* packet, RTC::SharedRtpPacket& sharedPacket, uint64_t nowMs)
+	{
+		MS_TRACE();
+
+		// Already stored by another stream (fast path for the fanout of the last
+		// received packet).
+		if (this->size != 0u && sharedPacket)
+		{
+			auto lastIndex = static_cast<uint32_t>(this->firstIndex + this->size - 1);
+
+			if (this->items[lastIndex & this->mask].packet.get() == sharedPacket.get())
+				return lastIndex;
+		}
+
+		auto ssrc      = packet->GetOriginalSsrc();
+		auto seq       = packet->GetOriginalSequenceNumber();
+		auto timestamp = packet->GetOriginalTimestamp();
+		auto key       = GetKey(ssrc, seq);
+
+		RemoveExpired(nowMs);
+
+		// Already stored (duplicated or out of order packet).
+		auto it = this->mapKeyIndex.find(key);
+
+		if (it != this->mapKeyIndex.end())
+		{
+			auto index = it->second;
+			auto& item = this->items[index & this->mask];
+
+			if (item.timestamp == timestamp)
+			{
+				if (!sharedPacket)
+					sharedPacket = item.packet;
+
+				return index;
+			}
+		}
+
+		if (this->size == this->items.size())
+		{
+			if (this->items.size() < MaxCapacity)
+				Grow();
+			else
+				RemoveFirst();
+		}
+
+		// Only clone once and only if necessary.
+		if (!sharedPacket)
+			sharedPacket = packet->Clone();
+
+		auto index = static_cast<uint32_t>(this->firstIndex + this->size);
+		auto& item = this->items[index & this->mask];
+
+		item.packet         = sharedPacket;
+		item.storedAtMs     = nowMs;
+		item.ssrc           = ssrc;
+		item.timestamp      = timestamp;
+		item.sequenceNumber = seq;
+
+		// It replaces an older packet with same sequence number, if any.
+		this->mapKeyIndex[key] = index;
+
+		++this->size;
+
+		return index;
+	}
+
+	void RtpPacketHistory::Clear()
+	{
+		MS_TRACE();
+
+		while (this->size != 0u)
+		{
+			RemoveFirst();
+		}
+	}
+
+	void RtpPacketHistory::RemoveExpired(uint64_t nowMs)
+	{
+		while (this->size != 0u)
+		{
+			auto& item = this->items[this->firstIndex & this->mask];
+
+			if (nowMs - item.storedAtMs <= this->maxAgeMs)
+				break;
+
+			RemoveFirst();
+		}
+	}
+
+	void RtpPacketHistory::RemoveFirst()
+	{
+		auto& item = this->items[this->firstIndex & this->mask];
+		auto it    = this->mapKeyIndex.find(GetKey(item.ssrc, item.sequenceNumber));
+
+		if (it != this->mapKeyIndex.end() && it->second == this->firstIndex)
+			this->mapKeyIndex.erase(it);
+
+		item.packet.reset();
+
+		++this->firstIndex;
+		--this->size;
+	}
+
+	void RtpPacketHistory::Grow()
+	{
+		MS_TRACE();
+
+		std::vector<Item> items(this->items.empty() ? InitialCapacity : this->items.size() * 2);
+		auto mask = static_cast<uint32_t>(items.size() - 1);
+
+		for (size_t i{ 0u }; i < this->size; ++i)
+		{
+			auto index = static_cast<uint32_t>(this->firstIndex + i);
+
+			items[index & mask] = std::move(this->items[index & this->mask]);
+		}
+
+		this->items = std::move(items);
+		this->mask  = mask;
+	}
+} // namespace RTC
@@ -129,8 +129,8 @@ namespace RTC
 		// Delete the probation packet buffer.
 		delete[] this->probationPacketBuffer;
 
-		// Delete the probation RTP packet.
-		delete this->probationPacket;
+		// Free the probation RTP packet.
+		RTC::RtpPacket::Deallocate(this->probationPacket);
 	}
 
 	RTC::RtpPacket* RtpProbationGenerator::GetNextPacket(size_t size)
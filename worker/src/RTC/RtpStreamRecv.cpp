@@ -17,19 +17,11 @@ namespace RTC
 
 	RtpStreamRecv::TransmissionCounter::TransmissionCounter(
 	  uint8_t spatialLayers, uint8_t temporalLayers, size_t windowSize)
+	  : spatialLayers(std::max(spatialLayers, static_cast<uint8_t>(1))),
+	    temporalLayers(std::max(temporalLayers, static_cast<uint8_t>(1))),
+	    rate(static_cast<size_t>(this->spatialLayers) * this->temporalLayers, windowSize)
 	{
 		MS_TRACE();
-
-		// Reserve vectors capacity.
-		this->spatialLayerCounters = std::vector<std::vector<RTC::RtpDataCounter>>(spatialLayers);
-
-		for (auto& spatialLayerCounter : this->spatialLayerCounters)
-		{
-			for (uint8_t tIdx{ 0u }; tIdx < temporalLayers; ++tIdx)
-			{
-				spatialLayerCounter.emplace_back(RTC::RtpDataCounter(windowSize));
-			}
-		}
 	}
 
 	void RtpStreamRecv::TransmissionCounter::Update(RTC::RtpPacket* packet)
@@ -40,33 +32,25 @@ namespace RTC
 		auto temporalLayer = packet->GetTemporalLayer();
 
 		// Sanity check. Do not allow spatial layers higher than defined.
-		if (spatialLayer > this->spatialLayerCounters.size() - 1)
-			spatialLayer = this->spatialLayerCounters.size() - 1;
+		if (spatialLayer > this->spatialLayers - 1)
+			spatialLayer = this->spatialLayers - 1;
 
 		// Sanity check. Do not allow temporal layers higher than defined.
-		if (temporalLayer > this->spatialLayerCounters[0].size() - 1)
-			temporalLayer = this->spatialLayerCounters[0].size() - 1;
+		if (temporalLayer > this->temporalLayers - 1)
+			temporalLayer = this->temporalLayers - 1;
 
-		auto& counter = this->spatialLayerCounters[spatialLayer][temporalLayer];
+		uint64_t nowMs = DepLibUV::GetTimeMs();
 
-		counter.Update(packet);
+		this->packets++;
+		this->bytes += packet->GetSize();
+		this->rate.Update(GetLayerIndex(spatialLayer, temporalLayer), packet->GetSize(), nowMs);
 	}
 
 	uint32_t RtpStreamRecv::TransmissionCounter::GetBitrate(uint64_t nowMs)
 	{
 		MS_TRACE();
 
-		uint32_t rate{ 0u };
-
-		for (auto& spatialLayerCounter : this->spatialLayerCounters)
-		{
-			for (auto& temporalLayerCounter : spatialLayerCounter)
-			{
-				rate += temporalLayerCounter.GetBitrate(nowMs);
-			}
-		}
-
-		return rate;
+		return this->rate.GetRate(nowMs, 0u, this->rate.GetLayers());
 	}
 
 	uint32_t RtpStreamRecv::TransmissionCounter::GetBitrate(
@@ -74,62 +58,27 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		MS_ASSERT(spatialLayer < this->spatialLayerCounters.size(), "spatialLayer too high");
-		MS_ASSERT(
-		  temporalLayer < this->spatialLayerCounters[spatialLayer].size(), "temporalLayer too high");
+		MS_ASSERT(spatialLayer < this->spatialLayers, "spatialLayer too high");
+		MS_ASSERT(temporalLayer < this->temporalLayers, "temporalLayer too high");
 
 		// Return 0 if specified layers are not being received.
-		auto& counter = this->spatialLayerCounters[spatialLayer][temporalLayer];
-
-		if (counter.GetBitrate(nowMs) == 0)
+		if (this->rate.GetRate(nowMs, GetLayerIndex(spatialLayer, temporalLayer)) == 0)
 			return 0u;
 
-		uint32_t rate{ 0u };
-
-		// Iterate all temporal layers of spatial layers previous to the given one.
-		for (uint8_t sIdx{ 0u }; sIdx < spatialLayer; ++sIdx)
-		{
-			for (uint8_t tIdx{ 0u }; tIdx < this->spatialLayerCounters[sIdx].size(); ++tIdx)
-			{
-				auto& temporalLayerCounter = this->spatialLayerCounters[sIdx][tIdx];
-
-				rate += temporalLayerCounter.GetBitrate(nowMs);
-			}
-		}
-
-		// Add the given spatial layer with up to the given temporal layer.
-		for (uint8_t tIdx{ 0u }; tIdx <= temporalLayer; ++tIdx)
-		{
-			auto& temporalLayerCounter = this->spatialLayerCounters[spatialLayer][tIdx];
-
-			rate += temporalLayerCounter.GetBitrate(nowMs);
-		}
-
-		return rate;
+		// All temporal layers of spatial layers previous to the given one plus the
+		// given spatial layer with up to the given temporal layer, which are the
+		// layers up to the given one.
+		return this->rate.GetRate(nowMs, 0u, GetLayerIndex(spatialLayer, temporalLayer) + 1);
 	}
 
 	uint32_t RtpStreamRecv::TransmissionCounter::GetSpatialLayerBitrate(uint64_t nowMs, uint8_t spatialLayer)
 	{
 		MS_TRACE();
 
-		MS_ASSERT(spatialLayer < this->spatialLayerCounters.size(), "spatialLayer too high");
-
-		uint32_t rate{ 0u };
-
-		// clang-format off
-		for (
-			uint8_t tIdx{ 0u };
-			tIdx < this->spatialLayerCounters[spatialLayer].size();
-			++tIdx
-		)
-		// clang-format on
-		{
-			auto& temporalLayerCounter = this->spatialLayerCounters[spatialLayer][tIdx];
+		MS_ASSERT(spatialLayer < this->spatialLayers, "spatialLayer too high");
 
-			rate += temporalLayerCounter.GetBitrate(nowMs);
-		}
-
-		return rate;
+		return this->rate.GetRate(
+		  nowMs, GetLayerIndex(spatialLayer, 0u), GetLayerIndex(spatialLayer + 1, 0u));
 	}
 
 	uint32_t RtpStreamRecv::TransmissionCounter::GetLayerBitrate(
@@ -137,47 +86,24 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		MS_ASSERT(spatialLayer < this->spatialLayerCounters.size(), "spatialLayer too high");
-		MS_ASSERT(
-		  temporalLayer < this->spatialLayerCounters[spatialLayer].size(), "temporalLayer too high");
-
-		auto& counter = this->spatialLayerCounters[spatialLayer][temporalLayer];
+		MS_ASSERT(spatialLayer < this->spatialLayers, "spatialLayer too high");
+		MS_ASSERT(temporalLayer < this->temporalLayers, "temporalLayer too high");
 
-		return counter.GetBitrate(nowMs);
+		return this->rate.GetRate(nowMs, GetLayerIndex(spatialLayer, temporalLayer));
 	}
 
 	size_t RtpStreamRecv::TransmissionCounter::GetPacketCount() const
 	{
 		MS_TRACE();
 
-		size_t packetCount{ 0u };
-
-		for (auto& spatialLayerCounter : this->spatialLayerCounters)
-		{
-			for (auto& temporalLayerCounter : spatialLayerCounter)
-			{
-				packetCount += temporalLayerCounter.GetPacketCount();
-			}
-		}
-
-		return packetCount;
+		return this->packets;
 	}
 
 	size_t RtpStreamRecv::TransmissionCounter::GetBytes() const
 	{
 		MS_TRACE();
 
-		size_t bytes{ 0u };
-
-		for (const auto& spatialLayerCounter : this->spatialLayerCounters)
-		{
-			for (const auto& temporalLayerCounter : spatialLayerCounter)
-			{
-				bytes += temporalLayerCounter.GetBytes();
-			}
-		}
-
-		return bytes;
+		return this->bytes;
 	}
 
 	/* Instance methods. */
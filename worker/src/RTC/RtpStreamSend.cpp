@@ -5,6 +5,7 @@
 #include "Logger.hpp"
 #include "Utils.hpp"
 #include "RTC/SeqManager.hpp"
+#include <cstring> // std::memcpy()
 
 namespace RTC
 {
@@ -15,7 +16,10 @@ namespace RTC
 	thread_local static std::vector<RTC::RtpStreamSend::StorageItem*> RetransmissionContainer(
 	  MaxRequestedPackets + 1);
 	static constexpr uint32_t DefaultRtt{ 100u };
-	static constexpr uint16_t MaxSeq = std::numeric_limits<uint16_t>::max();
+	// Expected packet rates used to size the retransmission buffer, which grows
+	// if the stream needs more.
+	static constexpr uint32_t AudioPacketsPerSecond{ 50u };
+	static constexpr uint32_t VideoPacketsPerSecond{ 500u };
 
 	/* Class Static. */
 
@@ -24,148 +28,256 @@ namespace RTC
 	// Maximum retransmission buffer size (ms).
 	const uint32_t RtpStreamSend::MaxRetransmissionDelay{ 2000u };
 
+	/* Class methods. */
+
+	size_t RtpStreamSend::GetStorageItemBufferCapacity(const RTC::RtpStream::Params& params)
+	{
+		auto packetsPerSecond = params.mimeType.type == RTC::RtpCodecMimeType::Type::AUDIO
+		                          ? AudioPacketsPerSecond
+		                          : VideoPacketsPerSecond;
+		size_t numPackets = RtpStreamSend::MaxRetransmissionDelay * packetsPerSecond / 1000;
+		size_t capacity{ 1u };
+
+		while (capacity < numPackets && capacity < RtpStreamSend::StorageItemBuffer::MaxCapacity)
+		{
+			capacity <<= 1;
+		}
+
+		return capacity;
+	}
+
 	void RtpStreamSend::StorageItem::Reset()
 	{
 		MS_TRACE();
 
-		this->packet.reset();
-		this->ssrc           = 0;
-		this->sequenceNumber = 0;
-		this->timestamp      = 0;
-		this->resentAtMs     = 0;
-		this->sentTimes      = 0;
+		this->historyIndex   = 0u;
+		this->timestamp      = 0u;
+		this->resentAtMs     = 0u;
+		this->sequenceNumber = 0u;
+		this->sentTimes      = 0u;
+		this->stored         = false;
 	}
 
-	RtpStreamSend::StorageItem* RtpStreamSend::StorageItemBuffer::GetFirst() const
+	RtpStreamSend::StorageItemBuffer::StorageItemBuffer(size_t initialCapacity)
+	  : initialCapacity(initialCapacity)
+	{
+		MS_ASSERT(
+		  initialCapacity != 0u && (initialCapacity & (initialCapacity - 1)) == 0u &&
+		    initialCapacity <= MaxCapacity,
+		  "capacity must be a power of two not greater than MaxCapacity");
+	}
+
+	RtpStreamSend::StorageItem* RtpStreamSend::StorageItemBuffer::GetFirst()
 	{
 		auto* storageItem = this->Get(this->startSeq);
 
 		MS_ASSERT(storageItem, "first storage item is missing");
-		MS_ASSERT(storageItem->packet, "storage item does not contain original packet");
+		MS_ASSERT(storageItem->stored, "storage item does not contain original packet");
 
 		return storageItem;
 	}
 
-	RtpStreamSend::StorageItem* RtpStreamSend::StorageItemBuffer::Get(uint16_t seq) const
+	RtpStreamSend::StorageItem* RtpStreamSend::StorageItemBuffer::Get(uint16_t seq)
 	{
-		if (RTC::SeqManager<uint16_t>::IsSeqLowerThan(seq, this->startSeq))
+		auto idx{ static_cast<uint16_t>(seq - this->startSeq) };
+
+		if (idx >= this->size)
 			return nullptr;
 
-		auto idx{ static_cast<uint16_t>(seq - this->startSeq) };
+		auto& storageItem = GetItem(seq);
 
-		if (this->buffer.empty() || idx > static_cast<uint16_t>(this->buffer.size() - 1))
+		// A hole in the range.
+		if (!storageItem.stored)
 			return nullptr;
 
-		return this->buffer.at(idx);
+		return std::addressof(storageItem);
 	}
 
-	size_t RtpStreamSend::StorageItemBuffer::GetBufferSize() const
+	RtpStreamSend::StorageItem* RtpStreamSend::StorageItemBuffer::Insert(uint16_t seq)
 	{
-		return this->buffer.size();
-	}
+		// Allocate the ring on first use.
+		if (this->items.empty())
+		{
+			this->items.resize(this->initialCapacity);
+			this->mask = static_cast<uint16_t>(this->initialCapacity - 1);
 
-	void RtpStreamSend::StorageItemBuffer::Insert(uint16_t seq, StorageItem* storageItem)
-	{
-		if (this->buffer.empty())
+			if (this->holdPackets)
+				this->packets.resize(this->initialCapacity);
+		}
+
+		if (this->size == 0u)
 		{
 			this->startSeq = seq;
-			this->buffer.push_back(storageItem);
+			this->size     = 1u;
 		}
 		// Packet sequence number is higher than startSeq.
 		else if (RTC::SeqManager<uint16_t>::IsSeqHigherThan(seq, this->startSeq))
 		{
-			auto idx{ static_cast<uint16_t>(seq - this->startSeq) };
+			size_t newSize = static_cast<uint16_t>(seq - this->startSeq) + size_t{ 1u };
 
-			// Packet arrived out of order, so we already have a slot allocated for it.
-			if (idx <= static_cast<uint16_t>(this->buffer.size() - 1))
+			if (newSize > this->size)
 			{
-				MS_ASSERT(this->buffer[idx] == nullptr, "Must insert into empty slot");
+				while (newSize > GetCapacity() && GetCapacity() < MaxCapacity)
+				{
+					Grow();
+				}
 
-				this->buffer[idx] = storageItem;
-			}
-			else
-			{
-				// Calculate how many elements would it be necessary to add when pushing new item
-				// to the back of the deque.
-				auto addToBack = static_cast<uint16_t>(seq - (this->startSeq + this->buffer.size() - 1));
+				// Still not enough room, drop items from the beginning.
+				while (newSize > GetCapacity() && this->size != 0u)
+				{
+					RemoveFirst();
 
-				// Packets can arrive out of order, add blank slots.
-				for (uint16_t i{ 1 }; i < addToBack; ++i)
-					this->buffer.push_back(nullptr);
+					newSize = static_cast<uint16_t>(seq - this->startSeq) + size_t{ 1u };
+				}
 
-				this->buffer.push_back(storageItem);
+				if (this->size == 0u)
+				{
+					this->startSeq = seq;
+					newSize        = 1u;
+				}
+
+				// NOTE: Items out of the range are always empty, so the new holes too.
+				this->size = newSize;
 			}
 		}
 		// Packet sequence number is the same or lower than startSeq.
 		else
 		{
-			// Calculate how many elements would it be necessary to add when pushing new item
-			// to the front of the deque.
 			auto addToFront = static_cast<uint16_t>(this->startSeq - seq);
+			size_t newSize  = this->size + addToFront;
 
-			// Packets can arrive out of order, add blank slots.
-			for (uint16_t i{ 1 }; i < addToFront; ++i)
-				this->buffer.push_front(nullptr);
+			while (newSize > GetCapacity() && GetCapacity() < MaxCapacity)
+			{
+				Grow();
+			}
+
+			// Too old for the buffer.
+			if (newSize > GetCapacity())
+				return nullptr;
 
-			this->buffer.push_front(storageItem);
 			this->startSeq = seq;
+			this->size     = newSize;
 		}
 
-		MS_ASSERT(
-		  this->buffer.size() <= MaxSeq,
-		  "StorageItemBuffer contains more than %" PRIu16 " entries",
-		  MaxSeq);
+		auto& storageItem = GetItem(seq);
+
+		MS_ASSERT(!storageItem.stored, "Must insert into empty slot");
+
+		return std::addressof(storageItem);
 	}
 
 	void RtpStreamSend::StorageItemBuffer::RemoveFirst()
 	{
-		MS_ASSERT(!this->buffer.empty(), "buffer is empty");
-
-		auto* storageItem = this->buffer[0];
+		MS_ASSERT(this->size != 0u, "buffer is empty");
 
-		// Reset (free RTP packet) the old storage item.
-		storageItem->Reset();
-		// Return into the pool.
-		StorageItem::Allocator::Pool.deallocate(storageItem, 1);
+		// Reset the old storage item.
+		ResetItem(this->startSeq);
 
-		this->buffer[0] = nullptr;
+		++this->startSeq;
+		--this->size;
 
-		// Remove all `nullptr` elements from the beginning of the buffer.
-		// NOTE: Calling front on an empty container is undefined.
-		while (!this->buffer.empty() && this->buffer.front() == nullptr)
+		// Remove all the holes from the beginning of the buffer.
+		while (this->size != 0u && !GetItem(this->startSeq).stored)
 		{
-			this->buffer.pop_front();
-			this->startSeq++;
+			++this->startSeq;
+			--this->size;
 		}
 	}
 
 	void RtpStreamSend::StorageItemBuffer::Clear()
 	{
-		for (auto* storageItem : this->buffer)
+		// NOTE: Items out of the range are always empty.
+		for (size_t i{ 0u }; i < this->size; ++i)
 		{
-			if (!storageItem)
-				continue;
-
-			// Reset the storage item (decrease RTP packet shared pointer counter).
-			storageItem->Reset();
-			// Return into the pool.
-			StorageItem::Allocator::Pool.deallocate(storageItem, 1);
+			ResetItem(static_cast<uint16_t>(this->startSeq + i));
 		}
 
-		this->buffer.clear();
-		this->startSeq = 0;
+		this->startSeq = 0u;
+		this->size     = 0u;
+	}
+
+	void RtpStreamSend::StorageItemBuffer::SetPayloadDescriptor(
+	  const StorageItem* storageItem, const uint8_t* data, size_t len)
+	{
+		MS_ASSERT(
+		  len <= RTC::Codecs::PayloadDescriptorHandler::MaxProcessedLength,
+		  "payload descriptor too big");
+
+		// Allocate them on first use.
+		if (this->payloadDescriptors.empty())
+			this->payloadDescriptors.resize(GetCapacity());
+
+		auto& payloadDescriptor = this->payloadDescriptors[storageItem - this->items.data()];
+
+		std::memcpy(payloadDescriptor.data, data, len);
+		payloadDescriptor.length = static_cast<uint8_t>(len);
+	}
+
+	const RtpStreamSend::StoredPayloadDescriptor* RtpStreamSend::StorageItemBuffer::
+	  GetPayloadDescriptor(const StorageItem* storageItem) const
+	{
+		if (this->payloadDescriptors.empty())
+			return nullptr;
+
+		const auto& payloadDescriptor = this->payloadDescriptors[storageItem - this->items.data()];
+
+		if (payloadDescriptor.length == 0u)
+			return nullptr;
+
+		return std::addressof(payloadDescriptor);
 	}
 
-	RtpStreamSend::StorageItemBuffer::~StorageItemBuffer()
+	void RtpStreamSend::StorageItemBuffer::SetHoldPackets(bool holdPackets)
 	{
-		Clear();
+		MS_ASSERT(this->items.empty(), "items have already been inserted");
+
+		this->holdPackets = holdPackets;
+	}
+
+	void RtpStreamSend::StorageItemBuffer::ResetItem(uint16_t seq)
+	{
+		GetItem(seq).Reset();
+
+		if (this->holdPackets)
+			this->packets[seq & this->mask].reset();
+
+		if (!this->payloadDescriptors.empty())
+			this->payloadDescriptors[seq & this->mask].length = 0u;
+	}
+
+	void RtpStreamSend::StorageItemBuffer::Grow()
+	{
+		std::vector<StorageItem> items(GetCapacity() * 2);
+		std::vector<RTC::SharedRtpPacket> packets(this->holdPackets ? items.size() : 0u);
+		std::vector<StoredPayloadDescriptor> payloadDescriptors(
+		  this->payloadDescriptors.empty() ? 0u : items.size());
+		auto mask = static_cast<uint16_t>(items.size() - 1);
+
+		for (size_t i{ 0u }; i < this->size; ++i)
+		{
+			auto seq = static_cast<uint16_t>(this->startSeq + i);
+
+			items[seq & mask] = std::move(GetItem(seq));
+
+			if (this->holdPackets)
+				packets[seq & mask] = std::move(this->packets[seq & this->mask]);
+
+			if (!payloadDescriptors.empty())
+				payloadDescriptors[seq & mask] = this->payloadDescriptors[seq & this->mask];
+		}
+
+		this->items              = std::move(items);
+		this->packets            = std::move(packets);
+		this->payloadDescriptors = std::move(payloadDescriptors);
+		this->mask               = mask;
 	}
 
 	/* Instance methods. */
 
 	RtpStreamSend::RtpStreamSend(
 	  RTC::RtpStreamSend::Listener* listener, RTC::RtpStream::Params& params, std::string& mid)
-	  : RTC::RtpStream::RtpStream(listener, params, 10), mid(mid),
+	  : RTC::RtpStream::RtpStream(listener, params, 10),
+	    storageItemBuffer(GetStorageItemBufferCapacity(params)), mid(mid),
 	    retransmissionBufferSize(RtpStreamSend::MaxRetransmissionDelay)
 	{
 		MS_TRACE();
@@ -202,7 +314,20 @@ namespace RTC
 		this->rtxSeq = Utils::Crypto::GetRandomUInt(0u, 0xFFFF);
 	}
 
-	bool RtpStreamSend::ReceivePacket(RTC::RtpPacket* packet, std::shared_ptr<RTC::RtpPacket>& sharedPacket)
+	void RtpStreamSend::SetRtpPacketHistory(RTC::RtpPacketHistory* packetHistory)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(packetHistory, "packetHistory must be given");
+		MS_ASSERT(
+		  this->transmissionCounter.GetPacketCount() == 0u, "packets have already been stored");
+
+		this->packetHistory = packetHistory;
+
+		this->storageItemBuffer.SetHoldPackets(false);
+	}
+
+	bool RtpStreamSend::ReceivePacket(RTC::RtpPacket* packet, RTC::SharedRtpPacket& sharedPacket)
 	{
 		MS_TRACE();
 
@@ -241,23 +366,23 @@ namespace RTC
 
 				// Note that this is an already RTX encoded packet if RTX is used
 				// (FillRetransmissionContainer() did it).
-				auto packet = storageItem->packet;
+				auto* packet = GetStoredPacket(storageItem);
 
 				// Retransmit the packet.
 				static_cast<RTC::RtpStreamSend::Listener*>(this->listener)
-				  ->OnRtpStreamRetransmitRtpPacket(this, packet.get());
+				  ->OnRtpStreamRetransmitRtpPacket(this, packet);
 
 				// Mark the packet as retransmitted.
-				RTC::RtpStream::PacketRetransmitted(packet.get());
+				RTC::RtpStream::PacketRetransmitted(packet);
 
 				// Mark the packet as repaired (only if this is the first retransmission).
 				if (storageItem->sentTimes == 1)
-					RTC::RtpStream::PacketRepaired(packet.get());
+					RTC::RtpStream::PacketRepaired(packet);
 
 				if (HasRtx())
 				{
 					// Restore the packet.
-					packet->RtxDecode(RtpStream::GetPayloadType(), storageItem->ssrc);
+					packet->RtxDecode(RtpStream::GetPayloadType(), this->params.ssrc);
 				}
 			}
 		}
@@ -441,7 +566,7 @@ namespace RTC
 		MS_ABORT("invalid method call");
 	}
 
-	void RtpStreamSend::StorePacket(RTC::RtpPacket* packet, std::shared_ptr<RTC::RtpPacket>& sharedPacket)
+	void RtpStreamSend::StorePacket(RTC::RtpPacket* packet, RTC::SharedRtpPacket& sharedPacket)
 	{
 		MS_TRACE();
 
@@ -460,6 +585,11 @@ namespace RTC
 			return;
 		}
 
+		// Retransmission buffer size in RTP timestamp units, rounded up so it
+		// expires the same packets as comparing ages in ms.
+		auto bufferSizeTs = static_cast<uint32_t>(
+		  (uint64_t{ this->retransmissionBufferSize } * this->params.clockRate + 999) / 1000);
+
 		// Check if RTP packet is too old to be stored.
 		if (this->storageItemBuffer.GetBufferSize() > 0)
 		{
@@ -471,12 +601,12 @@ namespace RTC
 				uint32_t diffTs{ storageItem->timestamp - packet->GetTimestamp() };
 
 				// RTP packet is older than the retransmission buffer size.
-				if (static_cast<uint32_t>(diffTs * 1000 / this->params.clockRate) >= this->retransmissionBufferSize)
+				if (diffTs >= bufferSizeTs)
 					return;
 			}
 		}
 
-		this->ClearOldPackets(packet);
+		this->ClearOldPackets(packet, bufferSizeTs);
 
 		auto seq          = packet->GetSequenceNumber();
 		auto* storageItem = this->storageItemBuffer.Get(seq);
@@ -491,52 +621,73 @@ namespace RTC
 			// Reset the storage item.
 			storageItem->Reset();
 		}
-		// Allocate new buffer item.
+		// Take a new buffer item.
 		else
 		{
-			// Allocate a new storage item.
-			storageItem = StorageItem::Allocator::Pool.allocate(1);
-			// Memory is not initialized in any way, reset it.
-			// Create a new StorageItem instance in this memory.
-			StorageItem::AllocatorTraits::construct(StorageItem::Allocator::Pool, storageItem);
+			storageItem = this->storageItemBuffer.Insert(seq);
 
-			this->storageItemBuffer.Insert(seq, storageItem);
+			// Too old to fit into the buffer.
+			if (!storageItem)
+				return;
 		}
 
-		// Only clone once and only if necessary.
-		if (!sharedPacket.get())
+		// Store original packet (cloned only once and only if necessary) and some
+		// extra info into the storage item.
+		if (this->packetHistory)
 		{
-			sharedPacket = packet->Clone();
+			storageItem->historyIndex =
+			  this->packetHistory->Store(packet, sharedPacket, DepLibUV::GetTimeMs());
+		}
+		else
+		{
+			if (!sharedPacket)
+				sharedPacket = packet->Clone();
+
+			this->storageItemBuffer.GetPacket(storageItem) = sharedPacket;
+		}
+
+		// Keep the payload descriptor sent by this stream since other streams may
+		// rewrite it differently in the stored packet.
+		if (packet->HasPayloadDescriptorHandler())
+		{
+			const auto* headerOverlay = packet->GetHeaderOverlay();
+			size_t len                = packet->GetPayloadLength();
+
+			if (len > RTC::Codecs::PayloadDescriptorHandler::MaxProcessedLength)
+				len = RTC::Codecs::PayloadDescriptorHandler::MaxProcessedLength;
+
+			const uint8_t* data = packet->GetPayload();
+
+			if (headerOverlay && headerOverlay->payloadDescriptorLength != 0u)
+				data = headerOverlay->payloadDescriptor;
+
+			this->storageItemBuffer.SetPayloadDescriptor(storageItem, data, len);
 		}
 
-		// Store original packet and some extra info into the storage item.
-		storageItem->packet         = sharedPacket;
-		storageItem->ssrc           = packet->GetSsrc();
 		storageItem->sequenceNumber = packet->GetSequenceNumber();
 		storageItem->timestamp      = packet->GetTimestamp();
+		storageItem->stored         = true;
 	}
 
-	void RtpStreamSend::ClearOldPackets(const RtpPacket* packet)
+	void RtpStreamSend::ClearOldPackets(const RtpPacket* packet, uint32_t bufferSizeTs)
 	{
 		MS_TRACE();
 
-		auto clockRate{ this->params.clockRate };
-
-		const auto bufferSize = this->storageItemBuffer.GetBufferSize();
+		// Packets with a timestamp lower than this watermark are expired.
+		uint32_t watermarkTs{ packet->GetTimestamp() - bufferSizeTs };
 
 		// Go through all buffer items starting with the first and free all storage
-		// items that contain packets older than `MaxRetransmissionDelay`.
-		for (size_t i{ 0 }; i < bufferSize && this->storageItemBuffer.GetBufferSize() != 0; ++i)
+		// items that contain packets older than `retransmissionBufferSize`.
+		while (this->storageItemBuffer.GetBufferSize() != 0)
 		{
 			auto* storageItem = this->storageItemBuffer.GetFirst();
-			uint32_t diffTs{ packet->GetTimestamp() - storageItem->timestamp };
 
 			// Processing RTP packet is older than first one.
 			if (RTC::SeqManager<uint32_t>::IsSeqLowerThan(packet->GetTimestamp(), storageItem->timestamp))
 				break;
 
 			// First RTP packet is recent enough.
-			if (static_cast<uint32_t>(diffTs * 1000 / clockRate) < this->retransmissionBufferSize)
+			if (RTC::SeqManager<uint32_t>::IsSeqHigherThan(storageItem->timestamp, watermarkTs))
 				break;
 
 			// Unfill the buffer start item.
@@ -552,6 +703,17 @@ namespace RTC
 		this->storageItemBuffer.Clear();
 	}
 
+	RTC::RtpPacket* RtpStreamSend::GetStoredPacket(const StorageItem* storageItem)
+	{
+		MS_TRACE();
+
+		// The packet may have been removed from a shared packet history.
+		if (this->packetHistory)
+			return this->packetHistory->Get(storageItem->historyIndex);
+
+		return this->storageItemBuffer.GetPacket(storageItem).get();
+	}
+
 	// This method looks for the requested RTP packets and inserts them into the
 	// RetransmissionContainer vector (and sets to null the next position).
 	//
@@ -594,16 +756,18 @@ namespace RTC
 			if (requested)
 			{
 				auto* storageItem = this->storageItemBuffer.Get(currentSeq);
-				std::shared_ptr<RTC::RtpPacket> packet{ nullptr };
+				RTC::RtpPacket* packet{ nullptr };
 				uint32_t diffMs;
 
+				if (storageItem)
+					packet = GetStoredPacket(storageItem);
+
 				// Calculate the elapsed time between the max timestamp seen and the
 				// requested packet's timestamp (in ms).
-				if (storageItem)
+				if (packet)
 				{
-					packet = storageItem->packet;
 					// Put correct info into the packet.
-					packet->SetSsrc(storageItem->ssrc);
+					packet->SetSsrc(this->params.ssrc);
 					packet->SetSequenceNumber(storageItem->sequenceNumber);
 					packet->SetTimestamp(storageItem->timestamp);
 
@@ -611,13 +775,19 @@ namespace RTC
 					if (!this->mid.empty())
 						packet->UpdateMid(mid);
 
+					auto* payloadDescriptor = this->storageItemBuffer.GetPayloadDescriptor(storageItem);
+
+					// Put the payload descriptor sent by this stream.
+					if (payloadDescriptor)
+						std::memcpy(packet->GetPayload(), payloadDescriptor->data, payloadDescriptor->length);
+
 					uint32_t diffTs = this->maxPacketTs - packet->GetTimestamp();
 
 					diffMs = diffTs * 1000 / this->params.clockRate;
 				}
 
 				// Packet not found.
-				if (!storageItem)
+				if (!packet)
 				{
 					// Do nothing.
 				}
@@ -640,8 +810,8 @@ namespace RTC
 				// Don't resent the packet if it was resent in the last RTT ms.
 				// clang-format off
 				else if (
-					storageItem->resentAtMs != 0u &&
-					nowMs - storageItem->resentAtMs <= static_cast<uint64_t>(rtt)
+					storageItem->sentTimes != 0u &&
+					static_cast<uint32_t>(nowMs) - storageItem->resentAtMs <= static_cast<uint32_t>(rtt)
 				)
 				// clang-format on
 				{
@@ -665,7 +835,7 @@ namespace RTC
 					}
 
 					// Save when this packet was resent.
-					storageItem->resentAtMs = nowMs;
+					storageItem->resentAtMs = static_cast<uint32_t>(nowMs);
 
 					// Increase the number of times this packet was sent.
 					storageItem->sentTimes++;
@@ -2,24 +2,48 @@
 // #define MS_LOG_DEV_LEVEL 3
 
 #include "RTC/SenderBandwidthEstimator.hpp"
-#include "DepLibUV.hpp"
 #include "Logger.hpp"
-#include <limits>
+#include <algorithm> // std::min(), std::max()
 
 namespace RTC
 {
 	/* Static. */
 
-	// static constexpr uint64_t AvailableBitrateEventInterval{ 2000u }; // In ms.
-	static constexpr uint16_t MaxSentInfoAge{ 2000u }; // TODO: Let's see.
+	static constexpr uint64_t AvailableBitrateEventInterval{ 1000u }; // In ms.
+	static constexpr uint16_t MaxSentInfoAge{ 2000u };
 	static constexpr float DefaultRtt{ 100 };
+	static constexpr uint32_t MinBitrate{ 30000u };
+	// Minimum duration (in ms) and number of packets of the transport-cc
+	// feedback window used for every estimation.
+	static constexpr uint64_t FeedbackWindowDuration{ 100u };
+	static constexpr size_t FeedbackWindowMinPackets{ 20u };
+	// A feedback window not completed within this time (in ms) is dropped.
+	static constexpr uint64_t FeedbackWindowMaxDuration{ 1000u };
+	// Window (in ms) of the base RTT and base one way delay.
+	static constexpr uint64_t MinValueWindow{ 10000u };
+	static constexpr float RttSmoothingFactor{ 0.5f };
+	// Delay (in ms) on top of the base one (or RTT) considered as overuse.
+	static constexpr int64_t QueuingDelayThreshold{ 50 };
+	// Above this loss ratio the bitrate is decreased, below the low one it may
+	// be increased.
+	static constexpr float HighLossRatio{ 0.10f };
+	static constexpr float LowLossRatio{ 0.02f };
+	static constexpr float OveruseDecreaseFactor{ 0.85f };
+	static constexpr float IncreaseFactorPerSecond{ 0.08f };
+	// The bitrate is not increased above this factor of the send bitrate
+	// (unless more is desired), so it doesn't grow while not being used.
+	static constexpr float MaxSendBitrateFactor{ 1.5f };
+	// Minimum time (in ms) between decreases, on top of the RTT.
+	static constexpr uint64_t MinDecreaseInterval{ 300u };
 
 	/* Instance methods. */
 
 	SenderBandwidthEstimator::SenderBandwidthEstimator(
-	  RTC::SenderBandwidthEstimator::Listener* listener, uint32_t initialAvailableBitrate)
-	  : listener(listener), initialAvailableBitrate(initialAvailableBitrate), rtt(DefaultRtt),
-	    sendTransmission(1000u), sendTransmissionTrend(0.15f)
+	  RTC::SenderBandwidthEstimator::Listener* listener,
+	  uint32_t initialAvailableBitrate,
+	  uint32_t maxBitrate)
+	  : listener(listener), initialAvailableBitrate(initialAvailableBitrate), maxBitrate(maxBitrate),
+	    rtt(DefaultRtt), minRtt(MinValueWindow), minDelay(MinValueWindow), sendTransmission(1000u)
 	{
 		MS_TRACE();
 	}
@@ -29,29 +53,45 @@ namespace RTC
 		MS_TRACE();
 	}
 
-	void SenderBandwidthEstimator::TransportConnected()
+	void SenderBandwidthEstimator::TransportConnected(uint64_t nowMs)
 	{
 		MS_TRACE();
 
-		this->availableBitrate              = this->initialAvailableBitrate;
-		this->lastAvailableBitrateEventAtMs = DepLibUV::GetTimeMs();
+		this->availableBitrate = this->initialAvailableBitrate;
+
+		ApplyLimits();
+
+		this->lastEstimationAtMs            = nowMs;
+		this->lastDecreaseAtMs              = 0u;
+		this->lastNotifiedAvailableBitrate  = this->availableBitrate;
+		this->lastAvailableBitrateEventAtMs = nowMs;
 	}
 
 	void SenderBandwidthEstimator::TransportDisconnected()
 	{
 		MS_TRACE();
 
-		this->availableBitrate = 0u;
+		this->availableBitrate   = 0u;
+		this->smoothedRtt        = 0;
+		this->numReportedPackets = 0u;
+		this->numLostPackets     = 0u;
 
 		this->sentInfos.clear();
+		this->minRtt.Reset();
+		this->minDelay.Reset();
 		this->cummulativeResult.Reset();
+		this->probationCummulativeResult.Reset();
 	}
 
-	void SenderBandwidthEstimator::RtpPacketSent(SentInfo& sentInfo)
+	void SenderBandwidthEstimator::RtpPacketSent(const SentInfo& sentInfo)
 	{
 		MS_TRACE();
 
-		auto nowMs = sentInfo.sentAtMs;
+		// Fill the send transmission counter.
+		this->sendTransmission.Update(sentInfo.size, sentInfo.sentAtMs);
+
+		if (!sentInfo.hasWideSeq)
+			return;
 
 		// Remove old sent infos.
 		auto it = this->sentInfos.lower_bound(sentInfo.wideSeq - MaxSentInfoAge + 1);
@@ -60,54 +100,51 @@ namespace RTC
 
 		// Insert the sent info into the map.
 		this->sentInfos[sentInfo.wideSeq] = sentInfo;
-
-		// Fill the send transmission counter.
-		this->sendTransmission.Update(sentInfo.size, nowMs);
-
-		// Update the send transmission trend.
-		auto sendBitrate = this->sendTransmission.GetRate(nowMs);
-
-		this->sendTransmissionTrend.Update(sendBitrate, nowMs);
-
-		// TODO: Remove.
-		// MS_DEBUG_DEV(
-		// 	"[wideSeq:%" PRIu16 ", size:%zu, isProbation:%s, bitrate:%" PRIu32 "]",
-		// 	sentInfo.wideSeq,
-		// 	sentInfo.size,
-		// 	sentInfo.isProbation ? "true" : "false",
-		// 	sendBitrate);
 	}
 
 	void SenderBandwidthEstimator::ReceiveRtcpTransportFeedback(
-	  const RTC::RTCP::FeedbackRtpTransportPacket* feedback)
+	  const RTC::RTCP::FeedbackRtpTransportPacket* feedback, uint64_t nowMs)
 	{
 		MS_TRACE();
 
-		auto nowMs         = DepLibUV::GetTimeMs();
-		uint64_t elapsedMs = nowMs - this->cummulativeResult.GetStartedAtMs();
+		this->usingTransportFeedback = true;
+
+		// Drop the ongoing feedback window if too old.
+		// clang-format off
+		if (
+			this->numReportedPackets != 0u &&
+			nowMs - this->windowStartedAtMs > FeedbackWindowMaxDuration
+		)
+		// clang-format on
+		{
+			this->numReportedPackets = 0u;
+			this->numLostPackets     = 0u;
 
-		// Drop ongoing cummulative result if too old.
-		if (elapsedMs > 1000u)
 			this->cummulativeResult.Reset();
+		}
 
-		for (auto& result : feedback->GetPacketResults())
-		{
-			if (!result.received)
-				continue;
+		if (this->numReportedPackets == 0u)
+			this->windowStartedAtMs = nowMs;
 
-			uint16_t wideSeq = result.sequenceNumber;
-			auto it          = this->sentInfos.find(wideSeq);
+		feedback->GetPacketResults(this->packetResults);
 
-			if (it == this->sentInfos.end())
-			{
-				MS_WARN_DEV("received packet not present in sent infos [wideSeq:%" PRIu16 "]", wideSeq);
+		for (auto& result : this->packetResults)
+		{
+			auto it = this->sentInfos.find(result.sequenceNumber);
 
+			// Already reported by a previous feedback, or too old.
+			if (it == this->sentInfos.end())
 				continue;
-			}
 
 			auto& sentInfo = it->second;
 
-			if (!sentInfo.isProbation)
+			this->numReportedPackets++;
+
+			if (!result.received)
+			{
+				this->numLostPackets++;
+			}
+			else if (!sentInfo.isProbation)
 			{
 				this->cummulativeResult.AddPacket(
 				  sentInfo.size, static_cast<int64_t>(sentInfo.sentAtMs), result.receivedAtMs);
@@ -117,110 +154,297 @@ namespace RTC
 				this->probationCummulativeResult.AddPacket(
 				  sentInfo.size, static_cast<int64_t>(sentInfo.sentAtMs), result.receivedAtMs);
 			}
+
+			this->sentInfos.erase(it);
 		}
 
 		// Handle probation packets separately.
 		if (this->probationCummulativeResult.GetNumPackets() >= 2u)
+			EstimateAvailableBitrateFromProbation(nowMs);
+
+		this->probationCummulativeResult.Reset();
+
+		// clang-format off
+		if (
+			nowMs - this->windowStartedAtMs < FeedbackWindowDuration ||
+			this->numReportedPackets < FeedbackWindowMinPackets
+		)
+		// clang-format on
 		{
-			// MS_DEBUG_DEV(
-			//   "probation [packets:%zu, size:%zu] "
-			//   "[send bps:%" PRIu32 ", recv bps:%" PRIu32 "] ",
-			//   this->probationCummulativeResult.GetNumPackets(),
-			//   this->probationCummulativeResult.GetTotalSize(),
-			//   this->probationCummulativeResult.GetSendBitrate(),
-			//   this->probationCummulativeResult.GetReceiveBitrate());
-
-			EstimateAvailableBitrate(this->probationCummulativeResult);
-
-			// Reset probation cummulative result.
-			this->probationCummulativeResult.Reset();
+			return;
 		}
-		else
+
+		auto lossRatio = static_cast<float>(this->numLostPackets) / this->numReportedPackets;
+		bool overusing{ false };
+		uint32_t deliveryBitrate{ 0u };
+
+		if (this->cummulativeResult.GetNumPackets() >= 2u)
 		{
-			// Reset probation cummulative result.
-			this->probationCummulativeResult.Reset();
+			auto delayMs = this->cummulativeResult.GetLastPacketDelayMs();
+
+			this->minDelay.Update(delayMs, nowMs);
+
+			overusing       = delayMs - this->minDelay.GetValue() > QueuingDelayThreshold;
+			deliveryBitrate = this->cummulativeResult.GetReceiveBitrate();
+
+			MS_DEBUG_DEV(
+			  "feedback window [packets:%zu, lost:%zu, send bps:%" PRIu32 ", recv bps:%" PRIu32
+			  ", queuing delay:%" PRIi64 "]",
+			  this->numReportedPackets,
+			  this->numLostPackets,
+			  this->cummulativeResult.GetSendBitrate(),
+			  deliveryBitrate,
+			  delayMs - this->minDelay.GetValue());
 		}
 
-		// Handle real and probation packets all together.
-		if (elapsedMs >= 100u && this->cummulativeResult.GetNumPackets() >= 20u)
+		EstimateAvailableBitrate(lossRatio, overusing, deliveryBitrate, nowMs);
+
+		this->numReportedPackets = 0u;
+		this->numLostPackets     = 0u;
+
+		this->cummulativeResult.Reset();
+	}
+
+	void SenderBandwidthEstimator::ReceiveRtcpReceiverReport(
+	  RTC::RTCP::ReceiverReportPacket* packet, float rtt, uint64_t nowMs)
+	{
+		MS_TRACE();
+
+		size_t numReports{ 0u };
+		uint32_t totalFractionLost{ 0u };
+
+		for (auto it = packet->Begin(); it != packet->End(); ++it)
 		{
-			// auto sendBitrate      = this->sendTransmission.GetRate(nowMs);
-			// auto sendBitrateTrend = this->sendTransmissionTrend.GetValue();
-
-			// MS_DEBUG_DEV(
-			//   "real+prob [packets:%zu, size:%zu] "
-			//   "[send bps:%" PRIu32 ", recv bps:%" PRIu32
-			//   "] "
-			//   "[real bps:%" PRIu32 ", trend bps:%" PRIu32 "]",
-			//   this->cummulativeResult.GetNumPackets(),
-			//   this->cummulativeResult.GetTotalSize(),
-			//   this->cummulativeResult.GetSendBitrate(),
-			//   this->cummulativeResult.GetReceiveBitrate(),
-			//   sendBitrate,
-			//   sendBitrateTrend);
-
-			EstimateAvailableBitrate(this->cummulativeResult);
-
-			// Reset cummulative result.
-			this->cummulativeResult.Reset();
+			auto* report = *it;
+
+			totalFractionLost += report->GetFractionLost();
+			numReports++;
+		}
+
+		if (numReports == 0u)
+			return;
+
+		if (rtt > 0)
+		{
+			this->rtt = rtt;
+
+			if (this->smoothedRtt == 0)
+				this->smoothedRtt = rtt;
+			else
+				this->smoothedRtt += (rtt - this->smoothedRtt) * RttSmoothingFactor;
+
+			this->minRtt.Update(static_cast<int64_t>(rtt), nowMs);
 		}
+
+		// With transport-cc feedback RTCP is just used for the RTT.
+		if (this->usingTransportFeedback)
+			return;
+
+		auto lossRatio = static_cast<float>(totalFractionLost) / numReports / 256;
+		// The RTT grows with the queue in the path of our packets.
+		bool overusing =
+		  this->smoothedRtt > 0 &&
+		  static_cast<int64_t>(this->smoothedRtt) - this->minRtt.GetValue() > QueuingDelayThreshold;
+
+		MS_DEBUG_DEV(
+		  "receiver report [loss ratio:%f, rtt:%f, smoothed rtt:%f, min rtt:%" PRIi64 "]",
+		  lossRatio,
+		  rtt,
+		  this->smoothedRtt,
+		  this->minRtt.GetValue());
+
+		EstimateAvailableBitrate(lossRatio, overusing, 0u, nowMs);
 	}
 
-	void SenderBandwidthEstimator::EstimateAvailableBitrate(CummulativeResult& cummulativeResult)
+	void SenderBandwidthEstimator::ReceiveEstimatedBitrate(uint32_t bitrate, uint64_t nowMs)
 	{
 		MS_TRACE();
 
-		auto previousAvailableBitrate = this->availableBitrate;
+		this->remoteEstimatedBitrate = bitrate;
+
+		if (this->availableBitrate == 0u || this->availableBitrate <= bitrate)
+			return;
+
+		ApplyLimits();
+		MayEmitAvailableBitrateEvent(nowMs);
+	}
+
+	void SenderBandwidthEstimator::SetMaxBitrate(uint32_t maxBitrate)
+	{
+		MS_TRACE();
 
-		double ratio = static_cast<double>(cummulativeResult.GetReceiveBitrate()) /
-		               static_cast<double>(cummulativeResult.GetSendBitrate());
-		auto bitrate =
-		  std::min<uint32_t>(cummulativeResult.GetReceiveBitrate(), cummulativeResult.GetSendBitrate());
+		this->maxBitrate = maxBitrate;
 
-		if (0.75f <= ratio && ratio <= 1.25f)
+		if (this->availableBitrate != 0u)
+			ApplyLimits();
+	}
+
+	void SenderBandwidthEstimator::SetDesiredBitrate(uint32_t desiredBitrate)
+	{
+		MS_TRACE();
+
+		this->desiredBitrate = desiredBitrate;
+	}
+
+	void SenderBandwidthEstimator::RescheduleNextAvailableBitrateEvent(uint64_t nowMs)
+	{
+		MS_TRACE();
+
+		this->lastNotifiedAvailableBitrate  = this->availableBitrate;
+		this->lastAvailableBitrateEventAtMs = nowMs;
+	}
+
+	void SenderBandwidthEstimator::EstimateAvailableBitrate(
+	  float lossRatio, bool overusing, uint32_t deliveryBitrate, uint64_t nowMs)
+	{
+		MS_TRACE();
+
+		// Not connected.
+		if (this->availableBitrate == 0u)
+			return;
+
+		auto elapsedMs = std::min<uint64_t>(nowMs - this->lastEstimationAtMs, 1000u);
+		// Let a decrease take effect before deciding on another one.
+		bool mayDecrease =
+		  nowMs - this->lastDecreaseAtMs >= MinDecreaseInterval + static_cast<uint64_t>(this->rtt);
+		auto bitrate = this->availableBitrate;
+
+		this->lastEstimationAtMs = nowMs;
+
+		if (lossRatio > HighLossRatio)
 		{
-			if (bitrate > this->availableBitrate)
+			if (mayDecrease)
 			{
-				this->availableBitrate = bitrate;
+				bitrate                = static_cast<uint32_t>(bitrate * (1 - (0.5f * lossRatio)));
+				this->lastDecreaseAtMs = nowMs;
 
-				MS_DEBUG_DEV("BWE UP [ratio:%f, availableBitrate:%" PRIu32 "]", ratio, this->availableBitrate);
+				MS_DEBUG_DEV("BWE DOWN by loss [loss ratio:%f, bitrate:%" PRIu32 "]", lossRatio, bitrate);
 			}
 		}
-		else
+		else if (overusing)
 		{
-			if (bitrate < this->availableBitrate)
+			if (mayDecrease)
 			{
-				this->availableBitrate = bitrate;
+				if (deliveryBitrate != 0u)
+					bitrate = std::min(bitrate, deliveryBitrate);
+
+				bitrate                = static_cast<uint32_t>(bitrate * OveruseDecreaseFactor);
+				this->lastDecreaseAtMs = nowMs;
 
 				MS_DEBUG_DEV(
-				  "BWE DOWN [ratio:%f, availableBitrate:%" PRIu32 "]", ratio, this->availableBitrate);
+				  "BWE DOWN by delay [deliveryBitrate:%" PRIu32 ", bitrate:%" PRIu32 "]",
+				  deliveryBitrate,
+				  bitrate);
 			}
 		}
+		else if (lossRatio < LowLossRatio)
+		{
+			auto maxIncreasedBitrate = std::max(
+			  static_cast<uint32_t>(this->sendTransmission.GetRate(nowMs) * MaxSendBitrateFactor),
+			  this->desiredBitrate);
+			auto increasedBitrate = static_cast<uint32_t>(
+			  bitrate * (1 + (IncreaseFactorPerSecond * static_cast<float>(elapsedMs) / 1000)));
 
-		// TODO: No, should wait for AvailableBitrateEventInterval and so on.
-		this->listener->OnSenderBandwidthEstimatorAvailableBitrate(
-		  this, this->availableBitrate, previousAvailableBitrate);
+			if (increasedBitrate > maxIncreasedBitrate)
+				increasedBitrate = std::max(bitrate, maxIncreasedBitrate);
+
+			bitrate = increasedBitrate;
+		}
+
+		this->availableBitrate = bitrate;
+
+		ApplyLimits();
+		MayEmitAvailableBitrateEvent(nowMs);
 	}
 
-	void SenderBandwidthEstimator::UpdateRtt(float rtt)
+	void SenderBandwidthEstimator::EstimateAvailableBitrateFromProbation(uint64_t nowMs)
 	{
 		MS_TRACE();
 
-		this->rtt = rtt;
+		// Not connected.
+		if (this->availableBitrate == 0u)
+			return;
+
+		auto sendBitrate = this->probationCummulativeResult.GetSendBitrate();
+		auto recvBitrate = this->probationCummulativeResult.GetReceiveBitrate();
+		double ratio     = static_cast<double>(recvBitrate) / static_cast<double>(sendBitrate);
+		auto bitrate     = std::min(recvBitrate, sendBitrate);
+
+		// The probation cluster went through at the sent bitrate.
+		if (0.75f <= ratio && ratio <= 1.25f && bitrate > this->availableBitrate)
+		{
+			this->availableBitrate = bitrate;
+
+			MS_DEBUG_DEV(
+			  "BWE UP by probation [ratio:%f, availableBitrate:%" PRIu32 "]",
+			  ratio,
+			  this->availableBitrate);
+
+			ApplyLimits();
+			MayEmitAvailableBitrateEvent(nowMs);
+		}
 	}
 
-	uint32_t SenderBandwidthEstimator::GetAvailableBitrate() const
+	void SenderBandwidthEstimator::ApplyLimits()
 	{
 		MS_TRACE();
 
-		return this->availableBitrate;
+		if (this->maxBitrate != 0u && this->availableBitrate > this->maxBitrate)
+			this->availableBitrate = this->maxBitrate;
+
+		if (this->remoteEstimatedBitrate != 0u && this->availableBitrate > this->remoteEstimatedBitrate)
+			this->availableBitrate = this->remoteEstimatedBitrate;
+
+		if (this->availableBitrate < MinBitrate)
+			this->availableBitrate = MinBitrate;
 	}
 
-	void SenderBandwidthEstimator::RescheduleNextAvailableBitrateEvent()
+	void SenderBandwidthEstimator::MayEmitAvailableBitrateEvent(uint64_t nowMs)
 	{
 		MS_TRACE();
 
-		this->lastAvailableBitrateEventAtMs = DepLibUV::GetTimeMs();
+		bool notify{ false };
+
+		// Emit event if AvailableBitrateEventInterval elapsed.
+		if (nowMs - this->lastAvailableBitrateEventAtMs >= AvailableBitrateEventInterval)
+		{
+			notify = true;
+		}
+		// Also emit the event fast if we detect a high BWE value decrease.
+		else if (this->availableBitrate < this->lastNotifiedAvailableBitrate * 0.75)
+		{
+			MS_WARN_TAG(
+			  bwe,
+			  "high BWE value decrease detected, notifying the listener [now:%" PRIu32 ", before:%" PRIu32
+			  "]",
+			  this->availableBitrate,
+			  this->lastNotifiedAvailableBitrate);
+
+			notify = true;
+		}
+		// Also emit the event fast if we detect a high BWE value increase.
+		else if (this->availableBitrate > this->lastNotifiedAvailableBitrate * 1.50)
+		{
+			MS_DEBUG_TAG(
+			  bwe,
+			  "high BWE value increase detected, notifying the listener [now:%" PRIu32 ", before:%" PRIu32
+			  "]",
+			  this->availableBitrate,
+			  this->lastNotifiedAvailableBitrate);
+
+			notify = true;
+		}
+
+		if (!notify)
+			return;
+
+		auto previousAvailableBitrate = this->lastNotifiedAvailableBitrate;
+
+		this->lastNotifiedAvailableBitrate  = this->availableBitrate;
+		this->lastAvailableBitrateEventAtMs = nowMs;
+
+		this->listener->OnSenderBandwidthEstimatorAvailableBitrate(
+		  this, this->availableBitrate, previousAvailableBitrate);
 	}
 
 	void SenderBandwidthEstimator::CummulativeResult::AddPacket(
@@ -265,4 +489,25 @@ namespace RTC
 		this->firstPacketReceivedAtMs = 0u;
 		this->lastPacketReceivedAtMs  = 0u;
 	}
+
+	void SenderBandwidthEstimator::MinValueTracker::Update(int64_t value, uint64_t nowMs)
+	{
+		MS_TRACE();
+
+		if (!this->hasValue || value <= this->value || nowMs - this->updatedAtMs > this->windowMs)
+		{
+			this->hasValue    = true;
+			this->value       = value;
+			this->updatedAtMs = nowMs;
+		}
+	}
+
+	void SenderBandwidthEstimator::MinValueTracker::Reset()
+	{
+		MS_TRACE();
+
+		this->hasValue    = false;
+		this->value       = 0;
+		this->updatedAtMs = 0u;
+	}
 } // namespace RTC
@@ -259,7 +259,7 @@ namespace RTC
 		return desiredBitrate;
 	}
 
-	void SimpleConsumer::SendRtpPacket(RTC::RtpPacket* packet, std::shared_ptr<RTC::RtpPacket>& sharedPacket)
+	void SimpleConsumer::SendRtpPacket(RTC::RtpPacket* packet, RTC::SharedRtpPacket& sharedPacket)
 	{
 		MS_TRACE();
 
@@ -279,9 +279,17 @@ namespace RTC
 
 		bool marker;
 
+		// The packet is shared with other consumers so its header and payload
+		// descriptor are rewritten into an overlay which is applied when sending it.
+		RTC::RtpPacket::HeaderOverlay headerOverlay(packet);
+
+		packet->SetHeaderOverlay(&headerOverlay);
+
 		// Process the payload if needed. Drop packet if necessary.
 		if (this->encodingContext && !packet->ProcessPayload(this->encodingContext.get(), marker))
 		{
+			packet->SetHeaderOverlay(nullptr);
+
 			MS_DEBUG_DEV(
 			  "discarding packet [ssrc:%" PRIu32 ", seq:%" PRIu16 ", ts:%" PRIu32 "]",
 			  packet->GetSsrc(),
@@ -296,7 +304,11 @@ namespace RTC
 		// If we need to sync, support key frames and this is not a key frame, ignore
 		// the packet.
 		if (this->syncRequired && this->keyFrameSupported && !packet->IsKeyFrame())
+		{
+			packet->SetHeaderOverlay(nullptr);
+
 			return;
+		}
 
 		// Whether this is the first packet after re-sync.
 		bool isSyncPacket = this->syncRequired;
@@ -318,13 +330,16 @@ namespace RTC
 		this->rtpSeqManager.Input(packet->GetSequenceNumber(), seq);
 
 		// Save original packet fields.
-		auto origSsrc = packet->GetSsrc();
-		auto origSeq  = packet->GetSequenceNumber();
+		auto origSeq = packet->GetSequenceNumber();
 
 		// Rewrite packet.
 		packet->SetSsrc(this->rtpParameters.encodings[0].ssrc);
 		packet->SetSequenceNumber(seq);
 
+		// Update MID RTP extension value.
+		if (!this->rtpParameters.mid.empty())
+			packet->UpdateMid(this->rtpParameters.mid);
+
 		if (isSyncPacket)
 		{
 			MS_DEBUG_TAG(
@@ -358,9 +373,8 @@ namespace RTC
 			  origSeq);
 		}
 
-		// Restore packet fields.
-		packet->SetSsrc(origSsrc);
-		packet->SetSequenceNumber(origSeq);
+		// Remove the header overlay.
+		packet->SetHeaderOverlay(nullptr);
 	}
 
 	void SimpleConsumer::GetRtcp(
@@ -651,7 +651,7 @@ namespace RTC
 	}
 
 	void SimulcastConsumer::SendRtpPacket(
-	  RTC::RtpPacket* packet, std::shared_ptr<RTC::RtpPacket>& sharedPacket)
+	  RTC::RtpPacket* packet, RTC::SharedRtpPacket& sharedPacket)
 	{
 		MS_TRACE();
 
@@ -852,6 +852,12 @@ namespace RTC
 
 		bool marker{ false };
 
+		// The packet is shared with other consumers so its header and payload
+		// descriptor are rewritten into an overlay which is applied when sending it.
+		RTC::RtpPacket::HeaderOverlay headerOverlay(packet);
+
+		packet->SetHeaderOverlay(&headerOverlay);
+
 		if (shouldSwitchCurrentSpatialLayer)
 		{
 			// Update current spatial layer.
@@ -883,6 +889,8 @@ namespace RTC
 			// Rewrite payload if needed. Drop packet if necessary.
 			if (!packet->ProcessPayload(this->encodingContext.get(), marker))
 			{
+				packet->SetHeaderOverlay(nullptr);
+
 				this->rtpSeqManager.Drop(packet->GetSequenceNumber());
 
 				return;
@@ -908,6 +916,10 @@ namespace RTC
 		packet->SetSequenceNumber(seq);
 		packet->SetTimestamp(timestamp);
 
+		// Update MID RTP extension value.
+		if (!this->rtpParameters.mid.empty())
+			packet->UpdateMid(this->rtpParameters.mid);
+
 		if (isSyncPacket)
 		{
 			MS_DEBUG_TAG(
@@ -948,13 +960,8 @@ namespace RTC
 			  origTimestamp);
 		}
 
-		// Restore packet fields.
-		packet->SetSsrc(origSsrc);
-		packet->SetSequenceNumber(origSeq);
-		packet->SetTimestamp(origTimestamp);
-
-		// Restore the original payload if needed.
-		packet->RestorePayload();
+		// Remove the header overlay.
+		packet->SetHeaderOverlay(nullptr);
 	}
 
 	void SimulcastConsumer::GetRtcp(
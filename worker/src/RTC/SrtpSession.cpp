@@ -3,6 +3,7 @@
 
 #include "RTC/SrtpSession.hpp"
 #include "DepLibSRTP.hpp"
+#include "LatencyStats.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include <cstring> // std::memset(), std::memcpy()
@@ -150,6 +151,8 @@ namespace RTC
 	{
 		MS_TRACE();
 
+		LatencyStats::Scope latencyScope(LatencyStats::Stage::SRTP_ENCRYPT);
+
 		// Ensure that the resulting SRTP packet fits into the encrypt buffer.
 		if (static_cast<size_t>(*len) + SRTP_MAX_TRAILER_LEN > EncryptBufferSize)
 		{
@@ -175,10 +178,42 @@ namespace RTC
 		return true;
 	}
 
+	/**
+	 * Encrypts in place the RTP packet in the given buffer, which must have room
+	 * for the SRTP trailer.
+	 */
+	bool SrtpSession::EncryptRtp(uint8_t* data, int* len, size_t bufferSize)
+	{
+		MS_TRACE();
+
+		LatencyStats::Scope latencyScope(LatencyStats::Stage::SRTP_ENCRYPT);
+
+		// Ensure that the resulting SRTP packet fits into the given buffer.
+		if (static_cast<size_t>(*len) + SRTP_MAX_TRAILER_LEN > bufferSize)
+		{
+			MS_WARN_TAG(srtp, "cannot encrypt RTP packet, size too big (%i bytes)", *len);
+
+			return false;
+		}
+
+		srtp_err_status_t err = srtp_protect(this->session, static_cast<void*>(data), len);
+
+		if (DepLibSRTP::IsError(err))
+		{
+			MS_WARN_TAG(srtp, "srtp_protect() failed: %s", DepLibSRTP::GetErrorString(err));
+
+			return false;
+		}
+
+		return true;
+	}
+
 	bool SrtpSession::DecryptSrtp(uint8_t* data, int* len)
 	{
 		MS_TRACE();
 
+		LatencyStats::Scope latencyScope(LatencyStats::Stage::SRTP_DECRYPT);
+
 		srtp_err_status_t err = srtp_unprotect(this->session, static_cast<void*>(data), len);
 
 		if (DepLibSRTP::IsError(err))
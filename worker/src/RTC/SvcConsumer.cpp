@@ -542,7 +542,7 @@ namespace RTC
 		return desiredBitrate;
 	}
 
-	void SvcConsumer::SendRtpPacket(RTC::RtpPacket* packet, std::shared_ptr<RTC::RtpPacket>& sharedPacket)
+	void SvcConsumer::SendRtpPacket(RTC::RtpPacket* packet, RTC::SharedRtpPacket& sharedPacket)
 	{
 		MS_TRACE();
 
@@ -592,10 +592,17 @@ namespace RTC
 		auto previousTemporalLayer = this->encodingContext->GetCurrentTemporalLayer();
 
 		bool marker{ false };
-		bool origMarker = packet->HasMarker();
+
+		// The packet is shared with other consumers so its header and payload
+		// descriptor are rewritten into an overlay which is applied when sending it.
+		RTC::RtpPacket::HeaderOverlay headerOverlay(packet);
+
+		packet->SetHeaderOverlay(&headerOverlay);
 
 		if (!packet->ProcessPayload(this->encodingContext.get(), marker))
 		{
+			packet->SetHeaderOverlay(nullptr);
+
 			this->rtpSeqManager.Drop(packet->GetSequenceNumber());
 
 			return;
@@ -625,6 +632,10 @@ namespace RTC
 		packet->SetSsrc(this->rtpParameters.encodings[0].ssrc);
 		packet->SetSequenceNumber(seq);
 
+		// Update MID RTP extension value.
+		if (!this->rtpParameters.mid.empty())
+			packet->UpdateMid(this->rtpParameters.mid);
+
 		if (marker)
 		{
 			packet->SetMarker(true);
@@ -664,13 +675,8 @@ namespace RTC
 			  origSeq);
 		}
 
-		// Restore packet fields.
-		packet->SetSsrc(origSsrc);
-		packet->SetSequenceNumber(origSeq);
-		packet->SetMarker(origMarker);
-
-		// Restore the original payload if needed.
-		packet->RestorePayload();
+		// Remove the header overlay.
+		packet->SetHeaderOverlay(nullptr);
 	}
 
 	void SvcConsumer::GetRtcp(
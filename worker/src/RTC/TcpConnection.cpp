@@ -167,6 +167,24 @@ namespace RTC
 		uint8_t frameLen[2];
 
 		Utils::Byte::Set2Bytes(frameLen, 0, len);
-		::TcpConnectionHandler::Write(frameLen, 2, data, len, cb, ctx);
+		::TcpConnectionHandler::Write(frameLen, 2, data, len, nullptr, 0, cb, ctx);
+	}
+
+	void TcpConnection::Send(
+	  const uint8_t* data1,
+	  size_t len1,
+	  const uint8_t* data2,
+	  size_t len2,
+	  RTC::Transport::onSendCallback* cb,
+	  RTC::Transport::OnSendCallbackCtx* ctx)
+	{
+		MS_TRACE();
+
+		// Write according to Framing RFC 4571.
+
+		uint8_t frameLen[2];
+
+		Utils::Byte::Set2Bytes(frameLen, 0, len1 + len2);
+		::TcpConnectionHandler::Write(frameLen, 2, data1, len1, data2, len2, cb, ctx);
 	}
 } // namespace RTC
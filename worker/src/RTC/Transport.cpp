@@ -19,40 +19,40 @@
 #include "RTC/RtpDictionaries.hpp"
 #include "RTC/SimpleConsumer.hpp"
 #include "RTC/SimulcastConsumer.hpp"
+#include "RTC/SrtpSession.hpp"
 #include "RTC/SvcConsumer.hpp"
+#include "RTC/TransportTuple.hpp"
+#include "handles/UdpSocketHandler.hpp"
 #include <libwebrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h> // webrtc::RtpPacketSendInfo
+#include <algorithm>                                             // std::any_of()
 #include <iterator>                                              // std::ostream_iterator
-#include <map>                                                   // std::multimap
 #include <sstream>                                               // std::ostringstream
 
 namespace RTC
 {
 	static size_t DefaultSctpSendBufferSize{ 262144 }; // 2^18.
 	static size_t MaxSctpSendBufferSize{ 268435456 };  // 2^28.
+	static constexpr size_t RtpSendBufferSize{ 65536 };
+	// Used to encrypt RTP packets that cannot be encrypted into the send buffer
+	// of the tuple.
+	thread_local static uint8_t RtpSendBuffer[RtpSendBufferSize];
 
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 	void Transport::OnSendCallback(bool sent, OnSendCallbackCtx* ctx)
 	{
 		if (sent)
 		{
 			ctx->tccClient->PacketSent(ctx->packetInfo, DepLibUV::GetTimeMsInt64());
 
-			ctx->sentInfo.sentAtMs = DepLibUV::GetTimeMs();
+			if (ctx->senderBwe)
+			{
+				ctx->sentInfo.sentAtMs = DepLibUV::GetTimeMs();
 
-			ctx->senderBwe->RtpPacketSent(ctx->sentInfo);
+				ctx->senderBwe->RtpPacketSent(ctx->sentInfo);
+			}
 		}
 
 		OnSendCallbackCtx::Allocator::Pool.deallocate(ctx, 1);
 	}
-#else
-	void Transport::OnSendCallback(bool sent, OnSendCallbackCtx* ctx)
-	{
-		if (sent)
-			ctx->tccClient->PacketSent(ctx->packetInfo, DepLibUV::GetTimeMsInt64());
-
-		OnSendCallbackCtx::Allocator::Pool.deallocate(ctx, 1);
-	}
-#endif
 
 	/* Instance methods. */
 
@@ -100,6 +100,26 @@ namespace RTC
 			this->initialAvailableOutgoingBitrate = jsonInitialAvailableOutgoingBitrateIt->get<uint32_t>();
 		}
 
+		auto jsonEnablePacingIt = data.find("enablePacing");
+
+		if (jsonEnablePacingIt != data.end())
+		{
+			if (!jsonEnablePacingIt->is_boolean())
+				MS_THROW_TYPE_ERROR("wrong enablePacing (not a boolean)");
+
+			this->enablePacing = jsonEnablePacingIt->get<bool>();
+		}
+
+		auto jsonEnableSenderBweIt = data.find("enableSenderBwe");
+
+		if (jsonEnableSenderBweIt != data.end())
+		{
+			if (!jsonEnableSenderBweIt->is_boolean())
+				MS_THROW_TYPE_ERROR("wrong enableSenderBwe (not a boolean)");
+
+			this->enableSenderBwe = jsonEnableSenderBweIt->get<bool>();
+		}
+
 		auto jsonEnableSctpIt = data.find("enableSctp");
 
 		// clang-format off
@@ -228,6 +248,7 @@ namespace RTC
 		this->mapConsumers.clear();
 		this->mapSsrcConsumer.clear();
 		this->mapRtxSsrcConsumer.clear();
+		this->bitrateAllocator.Clear();
 
 		// Delete all DataProducers.
 		for (auto& kv : this->mapDataProducers)
@@ -255,6 +276,10 @@ namespace RTC
 		delete this->rtcpTimer;
 		this->rtcpTimer = nullptr;
 
+		// Flush the UDP send batch since its datagrams may have send callbacks
+		// referencing our Transport-CC client.
+		UdpSocketHandler::FlushSendBatch();
+
 		// Delete Transport-CC client.
 		delete this->tccClient;
 		this->tccClient = nullptr;
@@ -263,11 +288,9 @@ namespace RTC
 		delete this->tccServer;
 		this->tccServer = nullptr;
 
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 		// Delete Sender BWE.
 		delete this->senderBwe;
 		this->senderBwe = nullptr;
-#endif
 	}
 
 	void Transport::CloseProducersAndConsumers()
@@ -305,6 +328,7 @@ namespace RTC
 		this->mapConsumers.clear();
 		this->mapSsrcConsumer.clear();
 		this->mapRtxSsrcConsumer.clear();
+		this->bitrateAllocator.Clear();
 
 		// Delete all DataProducers.
 		for (auto& kv : this->mapDataProducers)
@@ -575,7 +599,7 @@ namespace RTC
 
 		// Add availableOutgoingBitrate.
 		if (this->tccClient)
-			jsonObject["availableOutgoingBitrate"] = this->tccClient->GetAvailableBitrate();
+			jsonObject["availableOutgoingBitrate"] = GetAvailableOutgoingBitrate();
 
 		// Add availableIncomingBitrate.
 		if (this->tccServer && this->tccServer->GetAvailableBitrate() != 0u)
@@ -592,6 +616,64 @@ namespace RTC
 		// Add packetLossSent.
 		if (this->tccClient)
 			jsonObject["rtpPacketLossSent"] = this->tccClient->GetPacketLoss();
+
+		// Add pacing stats.
+		if (this->tccClient && this->tccClient->IsPacingEnabled())
+		{
+			jsonObject["pacingQueueSize"]      = this->tccClient->GetPacingQueueSize();
+			jsonObject["pacingQueueBytes"]     = this->tccClient->GetPacingQueueBytes();
+			jsonObject["pacingDelay"]          = this->tccClient->GetPacingDelay();
+			jsonObject["pacingDroppedPackets"] = this->tccClient->GetPacingDroppedPackets();
+		}
+
+		// Add recvBatchSizes.
+		if (std::any_of(
+		      this->recvBatchSizes.begin(),
+		      this->recvBatchSizes.end(),
+		      [](size_t batches) { return batches != 0u; }))
+		{
+			jsonObject["recvBatchSizes"] = this->recvBatchSizes;
+		}
+	}
+
+	void Transport::StartRecvBatch()
+	{
+		MS_TRACE();
+
+		MS_ASSERT(!this->recvBatching, "already in a receive batch");
+
+		this->recvBatching = true;
+
+		if (this->tccClient)
+			this->tccClient->StartRtcpTransportFeedbackBatch();
+	}
+
+	void Transport::EndRecvBatch(size_t numDatagrams)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(this->recvBatching, "not in a receive batch");
+
+		this->recvBatching = false;
+
+		// Update the congestion controller with all the received transport-wide
+		// feedbacks before forwarding the received RTP packets.
+		if (this->tccClient)
+			this->tccClient->EndRtcpTransportFeedbackBatch();
+
+		FlushRecvBatchRtpPackets();
+
+		if (numDatagrams == 0u)
+			return;
+
+		size_t idx{ 0u };
+
+		while (idx < this->recvBatchSizes.size() - 1 && (numDatagrams >> (idx + 1)) != 0u)
+		{
+			++idx;
+		}
+
+		this->recvBatchSizes[idx]++;
 	}
 
 	void Transport::HandleRequest(Channel::ChannelRequest* request)
@@ -677,6 +759,9 @@ namespace RTC
 					this->tccClient->SetMaxOutgoingBitrate(bitrate);
 					this->maxOutgoingBitrate = bitrate;
 
+					if (this->senderBwe)
+						this->senderBwe->SetMaxBitrate(bitrate);
+
 					MS_DEBUG_TAG(bwe, "maximum outgoing bitrate set to %" PRIu32, this->maxOutgoingBitrate);
 
 					ComputeOutgoingDesiredBitrate();
@@ -932,6 +1017,8 @@ namespace RTC
 				// Insert into the maps.
 				this->mapConsumers[consumerId] = consumer;
 
+				this->bitrateAllocator.AddParticipant(consumer);
+
 				for (auto ssrc : consumer->GetMediaSsrcs())
 				{
 					this->mapSsrcConsumer[ssrc] = consumer;
@@ -1025,6 +1112,21 @@ namespace RTC
 						createTccClient = true;
 						bweType         = RTC::BweType::REMB;
 					}
+					// Otherwise, if the SenderBandwidthEstimator is enabled, rely on it
+					// (using RTCP Receiver Reports) for video Consumers. The client is
+					// still needed for pacing and for the desired bitrate.
+					// clang-format off
+					else if (
+						this->enableSenderBwe &&
+						consumer->GetKind() == RTC::Media::Kind::VIDEO
+					)
+					// clang-format on
+					{
+						MS_DEBUG_TAG(bwe, "enabling TransportCongestionControlClient without remote feedback");
+
+						createTccClient = true;
+						bweType         = RTC::BweType::REMB;
+					}
 
 					if (createTccClient)
 					{
@@ -1037,7 +1139,11 @@ namespace RTC
 						};
 
 						this->tccClient = new RTC::TransportCongestionControlClient(
-						  this, bweType, this->initialAvailableOutgoingBitrate, this->maxOutgoingBitrate);
+						  this,
+						  bweType,
+						  this->initialAvailableOutgoingBitrate,
+						  this->maxOutgoingBitrate,
+						  this->enablePacing);
 
 						if (IsConnected())
 							this->tccClient->TransportConnected();
@@ -1049,53 +1155,20 @@ namespace RTC
 				if (this->tccClient)
 					consumer->SetExternallyManagedBitrate();
 
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
-				// Create SenderBandwidthEstimator if:
-				// - not already created,
-				// - it's a video Consumer, and
-				// - there is transport-wide-cc-01 RTP header extension, and
-				// - there is "transport-cc" in codecs RTCP feedback.
-				//
-				// clang-format off
-				if (
-					!this->senderBwe &&
-					consumer->GetKind() == RTC::Media::Kind::VIDEO &&
-					rtpHeaderExtensionIds.transportWideCc01 != 0u &&
-					std::any_of(
-						codecs.begin(), codecs.end(), [](const RTC::RtpCodecParameters& codec)
-						{
-							return std::any_of(
-								codec.rtcpFeedback.begin(), codec.rtcpFeedback.end(), [](const RTC::RtcpFeedback& fb)
-								{
-									return fb.type == "transport-cc";
-								});
-						})
-				)
-				// clang-format on
+				// Create SenderBandwidthEstimator if enabled and not already created.
+				// It needs the TransportCongestionControlClient (created above for
+				// video Consumers).
+				if (this->enableSenderBwe && this->tccClient && !this->senderBwe)
 				{
 					MS_DEBUG_TAG(bwe, "enabling SenderBandwidthEstimator");
 
-					// Tell all the Consumers that we are gonna manage their bitrate.
-					for (auto& kv : this->mapConsumers)
-					{
-						auto* consumer = kv.second;
-
-						consumer->SetExternallyManagedBitrate();
-					};
-
-					this->senderBwe =
-					  new RTC::SenderBandwidthEstimator(this, this->initialAvailableOutgoingBitrate);
+					this->senderBwe = new RTC::SenderBandwidthEstimator(
+					  this, this->initialAvailableOutgoingBitrate, this->maxOutgoingBitrate);
 
 					if (IsConnected())
-						this->senderBwe->TransportConnected();
+						this->senderBwe->TransportConnected(DepLibUV::GetTimeMs());
 				}
 
-				// If applicable, tell the new Consumer that we are gonna manage its
-				// bitrate.
-				if (this->senderBwe)
-					consumer->SetExternallyManagedBitrate();
-#endif
-
 				if (IsConnected())
 					consumer->TransportConnected();
 
@@ -1390,6 +1463,12 @@ namespace RTC
 					SendStreamClosed(ssrc);
 				}
 
+				// Drop its packets waiting in the pacing queue.
+				if (this->tccClient)
+					this->tccClient->RemoveQueuedRtpPackets(consumer);
+
+				this->bitrateAllocator.RemoveParticipant(consumer);
+
 				// Notify the listener.
 				this->listener->OnTransportConsumerClosed(this, consumer);
 
@@ -1535,11 +1614,9 @@ namespace RTC
 		if (this->tccServer)
 			this->tccServer->TransportConnected();
 
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 		// Tell the SenderBandwidthEstimator.
 		if (this->senderBwe)
-			this->senderBwe->TransportConnected();
-#endif
+			this->senderBwe->TransportConnected(DepLibUV::GetTimeMs());
 	}
 
 	void Transport::Disconnected()
@@ -1573,80 +1650,33 @@ namespace RTC
 		if (this->tccServer)
 			this->tccServer->TransportDisconnected();
 
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 		// Tell the SenderBandwidthEstimator.
 		if (this->senderBwe)
 			this->senderBwe->TransportDisconnected();
-#endif
 	}
 
 	void Transport::ReceiveRtpPacket(RTC::RtpPacket* packet)
 	{
 		MS_TRACE();
 
-		// Apply the Transport RTP header extension ids so the RTP listener can use them.
-		packet->SetMidExtensionId(this->recvRtpHeaderExtensionIds.mid);
-		packet->SetRidExtensionId(this->recvRtpHeaderExtensionIds.rid);
-		packet->SetRepairedRidExtensionId(this->recvRtpHeaderExtensionIds.rrid);
-		packet->SetAbsSendTimeExtensionId(this->recvRtpHeaderExtensionIds.absSendTime);
-		packet->SetTransportWideCc01ExtensionId(this->recvRtpHeaderExtensionIds.transportWideCc01);
-
-		auto nowMs = DepLibUV::GetTimeMs();
-
-		// Feed the TransportCongestionControlServer.
-		if (this->tccServer)
-			this->tccServer->IncomingPacket(nowMs, packet);
-
-		// Get the associated Producer.
-		RTC::Producer* producer = this->rtpListener.GetProducer(packet);
-
-		if (!producer)
+		// Within a receive batch, keep the packet until the batch ends.
+		if (this->recvBatching)
 		{
-			MS_WARN_TAG(
-			  rtp,
-			  "no suitable Producer for received RTP packet [ssrc:%" PRIu32 ", payloadType:%" PRIu8 "]",
-			  packet->GetSsrc(),
-			  packet->GetPayloadType());
-
-			// Tell the child class to remove this SSRC.
-			RecvStreamClosed(packet->GetSsrc());
-
-			RtpPacket::Deallocate(packet);
+			this->recvBatchRtpPackets.push_back(packet);
 
 			return;
 		}
 
-		// MS_DEBUG_DEV(
-		//   "RTP packet received [ssrc:%" PRIu32 ", payloadType:%" PRIu8 ", producerId:%s]",
-		//   packet->GetSsrc(),
-		//   packet->GetPayloadType(),
-		//   producer->id.c_str());
-
-		// Pass the RTP packet to the corresponding Producer.
-		auto result = producer->ReceiveRtpPacket(packet);
-
-		switch (result)
-		{
-			case RTC::Producer::ReceiveRtpPacketResult::MEDIA:
-				this->recvRtpTransmission.Update(packet);
-				break;
-			case RTC::Producer::ReceiveRtpPacketResult::RETRANSMISSION:
-				this->recvRtxTransmission.Update(packet);
-				break;
-			case RTC::Producer::ReceiveRtpPacketResult::DISCARDED:
-				// Tell the child class to remove this SSRC.
-				RecvStreamClosed(packet->GetSsrc());
-				break;
-			default:;
-		}
-
-		RtpPacket::Deallocate(packet);
+		ReceiveRtpPackets(&packet, 1u);
 	}
 
 	void Transport::ReceiveRtcpPacket(RTC::RTCP::Packet* packet)
 	{
 		MS_TRACE();
 
+		// Process RTP packets received before this RTCP packet first.
+		FlushRecvBatchRtpPackets();
+
 		// Handle each RTCP packet.
 		while (packet)
 		{
@@ -1675,6 +1705,92 @@ namespace RTC
 		this->sctpAssociation->ProcessSctpData(data, len);
 	}
 
+	/**
+	 * Sends the RTP packet to the given tuple, encrypting it with the given SRTP
+	 * session (if any). The packet is serialized (applying its header overlay)
+	 * and encrypted directly into the send buffer of the tuple if available, so
+	 * it's copied just once. Otherwise, if not encrypted, it's sent with its
+	 * header and payload as separate parts so the payload is not copied.
+	 */
+	void Transport::SendRtpPacketToTuple(
+	  RTC::TransportTuple* tuple,
+	  RTC::RtpPacket* packet,
+	  RTC::SrtpSession* srtpSession,
+	  onSendCallback* cb,
+	  OnSendCallbackCtx* ctx)
+	{
+		MS_TRACE();
+
+		size_t bufferSize = packet->GetSize();
+
+		if (srtpSession)
+			bufferSize += RTC::SrtpSession::MaxTrailerLength;
+
+		uint8_t* buffer = tuple->GetSendBuffer(bufferSize);
+
+		// Not encrypted and no send buffer available.
+		if (!buffer && !srtpSession)
+		{
+			const size_t headerLength = packet->GetSerializedHeaderLength();
+			const size_t len          = packet->GetSize();
+
+			tuple->Send(
+			  packet->GetSerializedHeader(),
+			  headerLength,
+			  packet->GetData() + headerLength,
+			  len - headerLength,
+			  cb,
+			  ctx);
+
+			// Increase send transmission.
+			DataSent(len);
+
+			return;
+		}
+
+		// Encrypted and no send buffer available.
+		if (!buffer)
+		{
+			if (bufferSize > RtpSendBufferSize)
+			{
+				MS_WARN_TAG(srtp, "cannot encrypt RTP packet, size too big (%zu bytes)", packet->GetSize());
+
+				if (cb)
+				{
+					(*cb)(false, ctx);
+				}
+
+				return;
+			}
+
+			buffer = RtpSendBuffer;
+		}
+
+		auto intLen = static_cast<int>(packet->GetSize());
+
+		packet->Serialize(buffer);
+
+		if (srtpSession && !srtpSession->EncryptRtp(buffer, &intLen, bufferSize))
+		{
+			if (cb)
+			{
+				(*cb)(false, ctx);
+			}
+
+			return;
+		}
+
+		auto len = static_cast<size_t>(intLen);
+
+		if (buffer == RtpSendBuffer)
+			tuple->Send(buffer, len, cb, ctx);
+		else
+			tuple->SendBuffer(len, cb, ctx);
+
+		// Increase send transmission.
+		DataSent(len);
+	}
+
 	void Transport::SetNewProducerIdFromData(json& data, std::string& producerId) const
 	{
 		MS_TRACE();
@@ -1863,6 +1979,93 @@ namespace RTC
 		return dataConsumer;
 	}
 
+	void Transport::ReceiveRtpPackets(RTC::RtpPacket** packets, size_t count)
+	{
+		MS_TRACE();
+
+		auto nowMs = DepLibUV::GetTimeMs();
+		RTC::Producer* producer{ nullptr };
+		uint32_t producerSsrc{ 0u };
+
+		for (size_t i{ 0u }; i < count; ++i)
+		{
+			auto* packet = packets[i];
+
+			// Apply the Transport RTP header extension ids so the RTP listener can use them.
+			packet->SetMidExtensionId(this->recvRtpHeaderExtensionIds.mid);
+			packet->SetRidExtensionId(this->recvRtpHeaderExtensionIds.rid);
+			packet->SetRepairedRidExtensionId(this->recvRtpHeaderExtensionIds.rrid);
+			packet->SetAbsSendTimeExtensionId(this->recvRtpHeaderExtensionIds.absSendTime);
+			packet->SetTransportWideCc01ExtensionId(this->recvRtpHeaderExtensionIds.transportWideCc01);
+
+			// Feed the TransportCongestionControlServer.
+			if (this->tccServer)
+				this->tccServer->IncomingPacket(nowMs, packet);
+
+			// Get the associated Producer. Consecutive packets of the same stream
+			// reuse the previous lookup.
+			if (!producer || packet->GetSsrc() != producerSsrc)
+			{
+				producer     = this->rtpListener.GetProducer(packet);
+				producerSsrc = packet->GetSsrc();
+			}
+
+			if (!producer)
+			{
+				MS_WARN_TAG(
+				  rtp,
+				  "no suitable Producer for received RTP packet [ssrc:%" PRIu32 ", payloadType:%" PRIu8 "]",
+				  packet->GetSsrc(),
+				  packet->GetPayloadType());
+
+				// Tell the child class to remove this SSRC.
+				RecvStreamClosed(packet->GetSsrc());
+
+				RtpPacket::Deallocate(packet);
+
+				continue;
+			}
+
+			// MS_DEBUG_DEV(
+			//   "RTP packet received [ssrc:%" PRIu32 ", payloadType:%" PRIu8 ", producerId:%s]",
+			//   packet->GetSsrc(),
+			//   packet->GetPayloadType(),
+			//   producer->id.c_str());
+
+			// Pass the RTP packet to the corresponding Producer.
+			auto result = producer->ReceiveRtpPacket(packet);
+
+			switch (result)
+			{
+				case RTC::Producer::ReceiveRtpPacketResult::MEDIA:
+					this->recvRtpTransmission.Update(packet);
+					break;
+				case RTC::Producer::ReceiveRtpPacketResult::RETRANSMISSION:
+					this->recvRtxTransmission.Update(packet);
+					break;
+				case RTC::Producer::ReceiveRtpPacketResult::DISCARDED:
+					// Tell the child class to remove this SSRC.
+					RecvStreamClosed(packet->GetSsrc());
+					break;
+				default:;
+			}
+
+			RtpPacket::Deallocate(packet);
+		}
+	}
+
+	void Transport::FlushRecvBatchRtpPackets()
+	{
+		MS_TRACE();
+
+		if (this->recvBatchRtpPackets.empty())
+			return;
+
+		ReceiveRtpPackets(this->recvBatchRtpPackets.data(), this->recvBatchRtpPackets.size());
+
+		this->recvBatchRtpPackets.clear();
+	}
+
 	void Transport::HandleRtcpPacket(RTC::RTCP::Packet* packet)
 	{
 		MS_TRACE();
@@ -1921,6 +2124,10 @@ namespace RTC
 					}
 
 					this->tccClient->ReceiveRtcpReceiverReport(rr, rtt, DepLibUV::GetTimeMsInt64());
+
+					// Pass it to the SenderBandwidthEstimator.
+					if (this->senderBwe)
+						this->senderBwe->ReceiveRtcpReceiverReport(rr, rtt, DepLibUV::GetTimeMs());
 				}
 
 				break;
@@ -2026,6 +2233,10 @@ namespace RTC
 								this->tccClient->ReceiveEstimatedBitrate(remb->GetBitrate());
 							}
 
+							// Pass it to the SenderBandwidthEstimator, which takes it as a limit.
+							if (this->senderBwe)
+								this->senderBwe->ReceiveEstimatedBitrate(remb->GetBitrate(), DepLibUV::GetTimeMs());
+
 							break;
 						}
 						else
@@ -2116,11 +2327,9 @@ namespace RTC
 						if (this->tccClient)
 							this->tccClient->ReceiveRtcpTransportFeedback(feedback);
 
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
-						// Pass it to the SenderBandwidthEstimator client.
+						// Pass it to the SenderBandwidthEstimator.
 						if (this->senderBwe)
-							this->senderBwe->ReceiveRtcpTransportFeedback(feedback);
-#endif
+							this->senderBwe->ReceiveRtcpTransportFeedback(feedback, DepLibUV::GetTimeMs());
 
 						break;
 					}
@@ -2309,89 +2518,119 @@ namespace RTC
 		}
 	}
 
-	void Transport::DistributeAvailableOutgoingBitrate()
+	void Transport::SendConsumerRtpPacket(
+	  RTC::Consumer* consumer, RTC::RtpPacket* packet, bool retransmission)
 	{
 		MS_TRACE();
 
-		MS_ASSERT(this->tccClient, "no TransportCongestionClient");
-
-		std::multimap<uint8_t, RTC::Consumer*> multimapPriorityConsumer;
+		// Update abs-send-time if present.
+		packet->UpdateAbsSendTime(DepLibUV::GetTimeMs());
 
-		// Fill the map with Consumers and their priority (if > 0).
-		for (auto& kv : this->mapConsumers)
+		// Update transport wide sequence number if present.
+		// clang-format off
+		if (
+			this->tccClient &&
+			this->tccClient->GetBweType() == RTC::BweType::TRANSPORT_CC &&
+			packet->UpdateTransportWideCc01(this->transportWideCcSeq + 1)
+		)
+		// clang-format on
 		{
-			auto* consumer = kv.second;
-			auto priority  = consumer->GetBitratePriority();
+			this->transportWideCcSeq++;
 
-			if (priority > 0u)
-				multimapPriorityConsumer.emplace(priority, consumer);
-		}
+			webrtc::RtpPacketSendInfo packetInfo;
 
-		// Nobody wants bitrate. Exit.
-		if (multimapPriorityConsumer.empty())
-			return;
+			packetInfo.ssrc                      = packet->GetSsrc();
+			packetInfo.transport_sequence_number = this->transportWideCcSeq;
+			packetInfo.has_rtp_sequence_number   = true;
+			packetInfo.rtp_sequence_number       = packet->GetSequenceNumber();
+			packetInfo.length                    = packet->GetSize();
+			packetInfo.pacing_info               = this->tccClient->GetPacingInfo();
 
-		bool baseAllocation       = true;
-		uint32_t availableBitrate = this->tccClient->GetAvailableBitrate();
+			// Indicate the pacer (and prober) that a packet is to be sent.
+			this->tccClient->InsertPacket(packetInfo);
 
-		this->tccClient->RescheduleNextAvailableBitrateEvent();
+			auto* ctx = OnSendCallbackCtx::Allocator::Pool.allocate(1);
+			OnSendCallbackCtx::AllocatorTraits::construct(OnSendCallbackCtx::Allocator::Pool, ctx);
+			RTC::SenderBandwidthEstimator::SentInfo sentInfo;
 
-		MS_DEBUG_DEV("before layer-by-layer iterations [availableBitrate:%" PRIu32 "]", availableBitrate);
+			sentInfo.wideSeq     = this->transportWideCcSeq;
+			sentInfo.hasWideSeq  = true;
+			sentInfo.size        = packet->GetSize();
+			sentInfo.sendingAtMs = DepLibUV::GetTimeMs();
 
-		// Redistribute the available bitrate by allowing Consumers to increase
-		// layer by layer. Initially try to spread the bitrate across all
-		// consumers. Then allocate the excess bitrate to Consumers starting
-		// with the highest priorty.
-		while (availableBitrate > 0u)
+			ctx->tccClient  = this->tccClient;
+			ctx->packetInfo = packetInfo;
+			ctx->senderBwe  = this->senderBwe;
+			ctx->sentInfo   = sentInfo;
+
+			SendRtpPacket(consumer, packet, OnSendCallback, ctx);
+		}
+		else
 		{
-			auto previousAvailableBitrate = availableBitrate;
+			SendRtpPacket(consumer, packet);
 
-			for (auto it = multimapPriorityConsumer.rbegin(); it != multimapPriorityConsumer.rend(); ++it)
+			// No feedback will be received for it, but it counts for the send bitrate.
+			if (this->senderBwe)
 			{
-				auto priority  = it->first;
-				auto* consumer = it->second;
-				auto bweType   = this->tccClient->GetBweType();
+				RTC::SenderBandwidthEstimator::SentInfo sentInfo;
 
-				for (uint8_t i{ 1u }; i <= (baseAllocation ? 1u : priority); ++i)
-				{
-					uint32_t usedBitrate{ 0u };
+				sentInfo.size        = packet->GetSize();
+				sentInfo.sendingAtMs = DepLibUV::GetTimeMs();
+				sentInfo.sentAtMs    = sentInfo.sendingAtMs;
 
-					switch (bweType)
-					{
-						case RTC::BweType::TRANSPORT_CC:
-							usedBitrate = consumer->IncreaseLayer(availableBitrate, /*considerLoss*/ false);
-							break;
-						case RTC::BweType::REMB:
-							usedBitrate = consumer->IncreaseLayer(availableBitrate, /*considerLoss*/ true);
-							break;
-					}
+				this->senderBwe->RtpPacketSent(sentInfo);
+			}
+		}
 
-					MS_ASSERT(usedBitrate <= availableBitrate, "Consumer used more layer bitrate than given");
+		if (!retransmission)
+			this->sendRtpTransmission.Update(packet);
+		else
+			this->sendRtxTransmission.Update(packet);
+	}
 
-					availableBitrate -= usedBitrate;
+	uint32_t Transport::GetAvailableOutgoingBitrate() const
+	{
+		MS_TRACE();
 
-					// Exit the loop fast if used bitrate is 0.
-					if (usedBitrate == 0u)
-						break;
-				}
-			}
+		MS_ASSERT(this->tccClient, "no TransportCongestionClient");
 
-			// If no Consumer used bitrate, exit the loop.
-			if (availableBitrate == previousAvailableBitrate)
-				break;
+		// The SenderBandwidthEstimator, if enabled, replaces the estimation of the
+		// TransportCongestionControlClient.
+		if (this->senderBwe)
+			return this->senderBwe->GetAvailableBitrate();
 
-			baseAllocation = false;
-		}
+		return this->tccClient->GetAvailableBitrate();
+	}
 
-		MS_DEBUG_DEV("after layer-by-layer iterations [availableBitrate:%" PRIu32 "]", availableBitrate);
+	void Transport::DistributeAvailableOutgoingBitrate()
+	{
+		MS_TRACE();
 
-		// Finally instruct Consumers to apply their computed layers.
-		for (auto it = multimapPriorityConsumer.rbegin(); it != multimapPriorityConsumer.rend(); ++it)
-		{
-			auto* consumer = it->second;
+		MS_ASSERT(this->tccClient, "no TransportCongestionClient");
 
-			consumer->ApplyLayers();
-		}
+		// Take changes in the priority of Consumers (or in whether they want
+		// bitrate at all) since the previous distribution.
+		this->bitrateAllocator.UpdatePriorities();
+
+		// Nobody wants bitrate. Exit.
+		if (!this->bitrateAllocator.HasPrioritizedParticipants())
+			return;
+
+		uint32_t availableBitrate = GetAvailableOutgoingBitrate();
+		// With transport-cc the available bitrate already takes packet loss into
+		// account, and so does the SenderBandwidthEstimator.
+		bool considerLoss = !this->senderBwe && this->tccClient->GetBweType() == RTC::BweType::REMB;
+
+		this->tccClient->RescheduleNextAvailableBitrateEvent();
+
+		if (this->senderBwe)
+			this->senderBwe->RescheduleNextAvailableBitrateEvent(DepLibUV::GetTimeMs());
+
+		MS_DEBUG_DEV("before layer-by-layer iterations [availableBitrate:%" PRIu32 "]", availableBitrate);
+
+		availableBitrate = this->bitrateAllocator.Distribute(availableBitrate, considerLoss);
+
+		MS_DEBUG_DEV("after layer-by-layer iterations [availableBitrate:%" PRIu32 "]", availableBitrate);
 	}
 
 	void Transport::ComputeOutgoingDesiredBitrate(bool forceBitrate)
@@ -2413,6 +2652,9 @@ namespace RTC
 		MS_DEBUG_DEV("total desired bitrate: %" PRIu32, totalDesiredBitrate);
 
 		this->tccClient->SetDesiredBitrate(totalDesiredBitrate, forceBitrate);
+
+		if (this->senderBwe)
+			this->senderBwe->SetDesiredBitrate(totalDesiredBitrate);
 	}
 
 	inline void Transport::EmitTraceEventProbationType(RTC::RtpPacket* packet) const
@@ -2532,116 +2774,38 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		// Update abs-send-time if present.
-		packet->UpdateAbsSendTime(DepLibUV::GetTimeMs());
-
-		// Update transport wide sequence number if present.
 		// clang-format off
 		if (
 			this->tccClient &&
-			this->tccClient->GetBweType() == RTC::BweType::TRANSPORT_CC &&
-			packet->UpdateTransportWideCc01(this->transportWideCcSeq + 1)
+			this->tccClient->IsPacingEnabled() &&
+			!this->tccClient->MayQueueRtpPacket(
+				consumer, packet, RTC::RtpPacingQueue::GetPriority(consumer, packet, false), false)
 		)
 		// clang-format on
 		{
-			this->transportWideCcSeq++;
-
-			webrtc::RtpPacketSendInfo packetInfo;
-
-			packetInfo.ssrc                      = packet->GetSsrc();
-			packetInfo.transport_sequence_number = this->transportWideCcSeq;
-			packetInfo.has_rtp_sequence_number   = true;
-			packetInfo.rtp_sequence_number       = packet->GetSequenceNumber();
-			packetInfo.length                    = packet->GetSize();
-			packetInfo.pacing_info               = this->tccClient->GetPacingInfo();
-
-			// Indicate the pacer (and prober) that a packet is to be sent.
-			this->tccClient->InsertPacket(packetInfo);
-
-			auto* ctx = OnSendCallbackCtx::Allocator::Pool.allocate(1);
-			OnSendCallbackCtx::AllocatorTraits::construct(OnSendCallbackCtx::Allocator::Pool, ctx);
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
-			auto* senderBwe = this->senderBwe;
-			RTC::SenderBandwidthEstimator::SentInfo sentInfo;
-
-			sentInfo.wideSeq     = this->transportWideCcSeq;
-			sentInfo.size        = packet->GetSize();
-			sentInfo.sendingAtMs = DepLibUV::GetTimeMs();
-
-			ctx->tccClient  = this->tccClient;
-			ctx->packetInfo = packetInfo;
-			ctx->senderBwe  = senderBwe;
-			ctx->sentInfo   = sentInfo;
-#else
-			ctx->tccClient  = this->tccClient;
-			ctx->packetInfo = packetInfo;
-#endif
-			SendRtpPacket(consumer, packet, OnSendCallback, ctx);
-		}
-		else
-		{
-			SendRtpPacket(consumer, packet);
+			return;
 		}
 
-		this->sendRtpTransmission.Update(packet);
+		SendConsumerRtpPacket(consumer, packet, /*retransmission*/ false);
 	}
 
 	inline void Transport::OnConsumerRetransmitRtpPacket(RTC::Consumer* consumer, RTC::RtpPacket* packet)
 	{
 		MS_TRACE();
 
-		// Update abs-send-time if present.
-		packet->UpdateAbsSendTime(DepLibUV::GetTimeMs());
-
-		// Update transport wide sequence number if present.
 		// clang-format off
 		if (
 			this->tccClient &&
-			this->tccClient->GetBweType() == RTC::BweType::TRANSPORT_CC &&
-			packet->UpdateTransportWideCc01(this->transportWideCcSeq + 1)
+			this->tccClient->IsPacingEnabled() &&
+			!this->tccClient->MayQueueRtpPacket(
+				consumer, packet, RTC::RtpPacingQueue::GetPriority(consumer, packet, true), true)
 		)
 		// clang-format on
 		{
-			this->transportWideCcSeq++;
-
-			webrtc::RtpPacketSendInfo packetInfo;
-
-			packetInfo.ssrc                      = packet->GetSsrc();
-			packetInfo.transport_sequence_number = this->transportWideCcSeq;
-			packetInfo.has_rtp_sequence_number   = true;
-			packetInfo.rtp_sequence_number       = packet->GetSequenceNumber();
-			packetInfo.length                    = packet->GetSize();
-			packetInfo.pacing_info               = this->tccClient->GetPacingInfo();
-
-			// Indicate the pacer (and prober) that a packet is to be sent.
-			this->tccClient->InsertPacket(packetInfo);
-
-			auto* ctx = OnSendCallbackCtx::Allocator::Pool.allocate(1);
-			OnSendCallbackCtx::AllocatorTraits::construct(OnSendCallbackCtx::Allocator::Pool, ctx);
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
-			auto* senderBwe = this->senderBwe;
-			RTC::SenderBandwidthEstimator::SentInfo sentInfo;
-
-			sentInfo.wideSeq     = this->transportWideCcSeq;
-			sentInfo.size        = packet->GetSize();
-			sentInfo.sendingAtMs = DepLibUV::GetTimeMs();
-
-			ctx->tccClient  = this->tccClient;
-			ctx->packetInfo = packetInfo;
-			ctx->senderBwe  = senderBwe;
-			ctx->sentInfo   = sentInfo;
-#else
-			ctx->tccClient  = this->tccClient;
-			ctx->packetInfo = packetInfo;
-#endif
-			SendRtpPacket(consumer, packet, OnSendCallback, ctx);
-		}
-		else
-		{
-			SendRtpPacket(consumer, packet);
+			return;
 		}
 
-		this->sendRtxTransmission.Update(packet);
+		SendConsumerRtpPacket(consumer, packet, /*retransmission*/ true);
 	}
 
 	inline void Transport::OnConsumerKeyFrameRequested(RTC::Consumer* consumer, uint32_t mappedSsrc)
@@ -2703,6 +2867,12 @@ namespace RTC
 			SendStreamClosed(ssrc);
 		}
 
+		// Drop its packets waiting in the pacing queue.
+		if (this->tccClient)
+			this->tccClient->RemoveQueuedRtpPackets(consumer);
+
+		this->bitrateAllocator.RemoveParticipant(consumer);
+
 		// Notify the listener.
 		this->listener->OnTransportConsumerProducerClosed(this, consumer);
 
@@ -2943,23 +3113,19 @@ namespace RTC
 
 			auto* ctx = OnSendCallbackCtx::Allocator::Pool.allocate(1);
 			OnSendCallbackCtx::AllocatorTraits::construct(OnSendCallbackCtx::Allocator::Pool, ctx);
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
-			auto* senderBwe = this->senderBwe;
 			RTC::SenderBandwidthEstimator::SentInfo sentInfo;
 
 			sentInfo.wideSeq     = this->transportWideCcSeq;
+			sentInfo.hasWideSeq  = true;
 			sentInfo.size        = packet->GetSize();
 			sentInfo.isProbation = true;
 			sentInfo.sendingAtMs = DepLibUV::GetTimeMs();
 
 			ctx->tccClient  = this->tccClient;
 			ctx->packetInfo = packetInfo;
-			ctx->senderBwe  = senderBwe;
+			ctx->senderBwe  = this->senderBwe;
 			ctx->sentInfo   = sentInfo;
-#else
-			ctx->tccClient  = this->tccClient;
-			ctx->packetInfo = packetInfo;
-#endif
+
 			SendRtpPacket(nullptr, packet, OnSendCallback, ctx);
 		}
 		else
@@ -2980,6 +3146,17 @@ namespace RTC
 		  this->sendProbationTransmission.GetBitrate(DepLibUV::GetTimeMs()));
 	}
 
+	inline void Transport::OnTransportCongestionControlClientSendQueuedRtpPacket(
+	  RTC::TransportCongestionControlClient* /*tccClient*/,
+	  RTC::Consumer* consumer,
+	  RTC::RtpPacket* packet,
+	  bool retransmission)
+	{
+		MS_TRACE();
+
+		SendConsumerRtpPacket(consumer, packet, retransmission);
+	}
+
 	inline void Transport::OnTransportCongestionControlServerSendRtcpPacket(
 	  RTC::TransportCongestionControlServer* /*tccServer*/, RTC::RTCP::Packet* packet)
 	{
@@ -2990,7 +3167,6 @@ namespace RTC
 		SendRtcpPacket(packet);
 	}
 
-#ifdef ENABLE_RTC_SENDER_BANDWIDTH_ESTIMATOR
 	inline void Transport::OnSenderBandwidthEstimatorAvailableBitrate(
 	  RTC::SenderBandwidthEstimator* /*senderBwe*/,
 	  uint32_t availableBitrate,
@@ -2998,16 +3174,15 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		MS_DEBUG_DEV(
+		MS_DEBUG_TAG(
+		  bwe,
 		  "outgoing available bitrate [now:%" PRIu32 ", before:%" PRIu32 "]",
 		  availableBitrate,
 		  previousAvailableBitrate);
 
-		// TODO: Uncomment once just SenderBandwidthEstimator is used.
-		// DistributeAvailableOutgoingBitrate();
-		// ComputeOutgoingDesiredBitrate();
+		DistributeAvailableOutgoingBitrate();
+		ComputeOutgoingDesiredBitrate();
 	}
-#endif
 
 	inline void Transport::OnTimer(Timer* timer)
 	{
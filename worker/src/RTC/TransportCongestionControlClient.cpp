@@ -19,6 +19,11 @@ namespace RTC
 	static constexpr float MaxPaddingBitrateFactor{ 0.85f };
 	static constexpr uint64_t AvailableBitrateEventInterval{ 1000u }; // In ms.
 	static constexpr size_t PacketLossHistogramLength{ 24 };
+	// Max time (in ms) the pacing budget can accumulate while idle, so a burst
+	// after an idle period is sent at most this much ahead of the pacing rate.
+	static constexpr uint64_t MaxPacingBurstTime{ 5u };
+	// Weight of a new sample in the smoothed pacing delay.
+	static constexpr double PacingDelaySmoothingFactor{ 1.0 / 16 };
 
 	/* Instance methods. */
 
@@ -26,11 +31,12 @@ namespace RTC
 	  RTC::TransportCongestionControlClient::Listener* listener,
 	  RTC::BweType bweType,
 	  uint32_t initialAvailableBitrate,
-	  uint32_t maxOutgoingBitrate)
+	  uint32_t maxOutgoingBitrate,
+	  bool enablePacing)
 	  : listener(listener), bweType(bweType),
 	    initialAvailableBitrate(std::max<uint32_t>(
 	      initialAvailableBitrate, RTC::TransportCongestionControlMinOutgoingBitrate)),
-	    maxOutgoingBitrate(maxOutgoingBitrate)
+	    maxOutgoingBitrate(maxOutgoingBitrate), enablePacing(enablePacing)
 	{
 		MS_TRACE();
 
@@ -81,6 +87,9 @@ namespace RTC
 			this->controllerFactory->GetProcessInterval().ms()
 		));
 		// clang-format on
+
+		if (this->enablePacing)
+			this->pacingTimer = new Timer(this);
 	}
 
 	void TransportCongestionControlClient::DestroyController()
@@ -93,6 +102,11 @@ namespace RTC
 
 		delete this->processTimer;
 		this->processTimer = nullptr;
+
+		delete this->pacingTimer;
+		this->pacingTimer = nullptr;
+
+		this->pacingQueue.Clear();
 	}
 
 	void TransportCongestionControlClient::TransportConnected()
@@ -118,6 +132,12 @@ namespace RTC
 
 		this->desiredBitrateTrend.ForceUpdate(0u, nowMs);
 		this->rtpTransportControllerSend->OnNetworkAvailability(false);
+
+		// Queued packets cannot be sent.
+		this->pacingQueue.Clear();
+
+		if (this->pacingTimer)
+			this->pacingTimer->Stop();
 	}
 
 	void TransportCongestionControlClient::InsertPacket(webrtc::RtpPacketSendInfo& packetInfo)
@@ -209,12 +229,7 @@ namespace RTC
 
 		// Update packet loss history.
 		size_t expected_packets = feedback->GetPacketStatusCount();
-		size_t lost_packets     = 0;
-		for (const auto& result : feedback->GetPacketResults())
-		{
-			if (!result.received)
-				lost_packets += 1;
-		}
+		size_t lost_packets     = expected_packets - feedback->GetReceivedPacketCount();
 		this->UpdatePacketLoss(static_cast<double>(lost_packets) / expected_packets);
 
 		if (this->rtpTransportControllerSend == nullptr)
@@ -225,6 +240,30 @@ namespace RTC
 		this->rtpTransportControllerSend->OnTransportFeedback(*feedback);
 	}
 
+	void TransportCongestionControlClient::StartRtcpTransportFeedbackBatch()
+	{
+		MS_TRACE();
+
+		if (this->rtpTransportControllerSend == nullptr)
+		{
+			return;
+		}
+
+		this->rtpTransportControllerSend->StartTransportFeedbackBatch();
+	}
+
+	void TransportCongestionControlClient::EndRtcpTransportFeedbackBatch()
+	{
+		MS_TRACE();
+
+		if (this->rtpTransportControllerSend == nullptr)
+		{
+			return;
+		}
+
+		this->rtpTransportControllerSend->EndTransportFeedbackBatch();
+	}
+
 	void TransportCongestionControlClient::UpdatePacketLoss(double packetLoss)
 	{
 		// Add the score into the histogram.
@@ -383,6 +422,126 @@ namespace RTC
 		this->lastAvailableBitrateEventAtMs = DepLibUV::GetTimeMs();
 	}
 
+	bool TransportCongestionControlClient::MayQueueRtpPacket(
+	  RTC::Consumer* consumer,
+	  RTC::RtpPacket* packet,
+	  RTC::RtpPacingQueue::Priority priority,
+	  bool retransmission)
+	{
+		MS_TRACE();
+
+		if (!this->enablePacing || this->rtpTransportControllerSend == nullptr)
+			return true;
+
+		auto nowUs = DepLibUV::GetTimeUs();
+
+		UpdatePacingBudget(nowUs);
+
+		// Send it right now if nothing is waiting and the budget allows it.
+		if (this->pacingQueue.IsEmpty() && this->pacingBudget > 0)
+		{
+			this->pacingBudget -= static_cast<int64_t>(packet->GetSize());
+
+			UpdatePacingDelay(0u);
+
+			return true;
+		}
+
+		this->pacingQueue.Enqueue(consumer, packet, priority, retransmission, nowUs / 1000);
+
+		if (!this->pacingTimer->IsActive())
+			SendQueuedRtpPackets();
+
+		return false;
+	}
+
+	void TransportCongestionControlClient::RemoveQueuedRtpPackets(RTC::Consumer* consumer)
+	{
+		MS_TRACE();
+
+		this->pacingQueue.RemoveConsumer(consumer);
+	}
+
+	void TransportCongestionControlClient::UpdatePacingBudget(uint64_t nowUs)
+	{
+		MS_TRACE();
+
+		auto pacingBitrate =
+		  this->rtpTransportControllerSend->packet_sender()->GetPacingBitrateBps();
+		auto elapsedUs = nowUs - this->pacingBudgetUpdatedAtUs;
+
+		this->pacingBudgetUpdatedAtUs = nowUs;
+
+		// Do not let the budget grow beyond the burst size (but allow at least a
+		// full packet).
+		int64_t maxBudget = std::max<int64_t>(
+		  static_cast<int64_t>(pacingBitrate) * MaxPacingBurstTime / 8000, RTC::MtuSize);
+
+		if (this->pacingBudget >= maxBudget)
+			return;
+
+		// Avoid overflows after a long idle period.
+		elapsedUs = std::min<uint64_t>(elapsedUs, MaxPacingBurstTime * 1000);
+
+		this->pacingBudget = std::min<int64_t>(
+		  this->pacingBudget + static_cast<int64_t>(pacingBitrate * elapsedUs / 8000000), maxBudget);
+	}
+
+	inline void TransportCongestionControlClient::UpdatePacingDelay(uint64_t delayMs)
+	{
+		this->pacingDelay += (delayMs - this->pacingDelay) * PacingDelaySmoothingFactor;
+	}
+
+	void TransportCongestionControlClient::SendQueuedRtpPackets()
+	{
+		MS_TRACE();
+
+		auto nowUs = DepLibUV::GetTimeUs();
+		auto nowMs = nowUs / 1000;
+		bool expired{ false };
+
+		UpdatePacingBudget(nowUs);
+
+		while (auto* item = this->pacingQueue.Front(nowMs, expired))
+		{
+			// Packets whose max queue time elapsed are sent regardless the budget.
+			if (this->pacingBudget <= 0 && !expired)
+				break;
+
+			auto* consumer      = item->consumer;
+			auto retransmission = item->retransmission;
+
+			UpdatePacingDelay(nowMs - item->enqueuedAtMs);
+
+			auto packet = this->pacingQueue.Pop();
+
+			this->pacingBudget -= static_cast<int64_t>(packet->GetSize());
+
+			this->listener->OnTransportCongestionControlClientSendQueuedRtpPacket(
+			  this, consumer, packet.get(), retransmission);
+		}
+
+		if (this->pacingQueue.IsEmpty())
+		{
+			this->pacingTimer->Stop();
+
+			return;
+		}
+
+		// Wake up once the budget allows sending the next packet.
+		auto pacingBitrate =
+		  this->rtpTransportControllerSend->packet_sender()->GetPacingBitrateBps();
+		uint64_t timeout{ 1u };
+
+		if (pacingBitrate > 0u)
+		{
+			timeout = std::max<uint64_t>(
+			  static_cast<uint64_t>(-this->pacingBudget) * 8000 / pacingBitrate + 1u, 1u);
+		}
+
+		this->pacingTimer->Start(timeout);
+	}
+
 	void TransportCongestionControlClient::MayEmitAvailableBitrateEvent(uint32_t previousAvailableBitrate)
 	{
 		MS_TRACE();
@@ -521,5 +680,9 @@ namespace RTC
 
 			MayEmitAvailableBitrateEvent(this->bitrates.availableBitrate);
 		}
+		else if (timer == this->pacingTimer)
+		{
+			SendQueuedRtpPackets();
+		}
 	}
 } // namespace RTC
@@ -26,6 +26,14 @@ namespace RTC
 		MS_TRACE();
 	}
 
+	UdpSocket::UdpSocket(Listener* listener, std::string& ip, uint16_t port, uint16_t numReusePortShards)
+	  : // This may throw.
+	    ::UdpSocketHandler::UdpSocketHandler(PortManager::BindUdp(ip, port, numReusePortShards)),
+	    listener(listener), fixedPort(true)
+	{
+		MS_TRACE();
+	}
+
 	UdpSocket::~UdpSocket()
 	{
 		MS_TRACE();
@@ -36,7 +44,26 @@ namespace RTC
 		}
 	}
 
-	void UdpSocket::UserOnUdpDatagramReceived(const uint8_t* data, size_t len, const struct sockaddr* addr)
+	void UdpSocket::FillJsonSendBatchStats(json& jsonObject) const
+	{
+		MS_TRACE();
+
+		auto& sendBatchStats = GetSendBatchStats();
+
+		// Add udpSendBatchSize.
+		jsonObject["udpSendBatchSize"] = UdpSocketHandler::GetSendBatchSize();
+
+		// Add udpSendBatches.
+		jsonObject["udpSendBatches"] = sendBatchStats.batches;
+
+		// Add udpSendBatchedPackets.
+		jsonObject["udpSendBatchedPackets"] = sendBatchStats.batchedDatagrams;
+
+		// Add udpSendGsoPackets.
+		jsonObject["udpSendGsoPackets"] = sendBatchStats.gsoDatagrams;
+	}
+
+	void UdpSocket::UserOnUdpDatagramsReceived(const RecvDatagram* datagrams, size_t count)
 	{
 		MS_TRACE();
 
@@ -48,6 +75,6 @@ namespace RTC
 		}
 
 		// Notify the reader.
-		this->listener->OnUdpSocketPacketReceived(this, data, len, addr);
+		this->listener->OnUdpSocketPacketsReceived(this, datagrams, count);
 	}
 } // namespace RTC
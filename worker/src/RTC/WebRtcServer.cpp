@@ -104,14 +104,42 @@ namespace RTC
 			listenInfo.port = jsonPortIt->get<uint16_t>();
 		}
 
-		try
+		auto jsonNumShardsIt = data.find("numShards");
+
+		if (jsonNumShardsIt != data.end())
+		{
+			if (!(jsonNumShardsIt->is_number() && Utils::Json::IsPositiveInteger(*jsonNumShardsIt)))
+				MS_THROW_TYPE_ERROR("wrong numShards (not a positive number)");
+
+			this->numShards = jsonNumShardsIt->get<uint16_t>();
+
+			if (this->numShards == 0u)
+				MS_THROW_TYPE_ERROR("wrong numShards (must be greater than 0)");
+		}
+
+		// Connections accepted by a TcpServer cannot be moved to other shards.
+		if (this->numShards > 1u)
+		{
+			for (auto& listenInfo : listenInfos)
+			{
+				if (listenInfo.protocol == RTC::TransportTuple::Protocol::TCP)
+					MS_THROW_TYPE_ERROR("wrong listenInfo.protocol (TCP not supported with numShards > 1)");
+			}
+		}
+
+		auto bindSockets = [this, &listenInfos]()
 		{
 			for (auto& listenInfo : listenInfos)
 			{
 				if (listenInfo.protocol == RTC::TransportTuple::Protocol::UDP)
 				{
+					RTC::UdpSocket* udpSocket;
+
 					// This may throw.
-					auto* udpSocket = new RTC::UdpSocket(this, listenInfo.ip, listenInfo.port);
+					if (this->numShards > 1u)
+						udpSocket = new RTC::UdpSocket(this, listenInfo.ip, listenInfo.port, this->numShards);
+					else
+						udpSocket = new RTC::UdpSocket(this, listenInfo.ip, listenInfo.port);
 
 					this->udpSocketOrTcpServers.emplace_back(udpSocket, nullptr, listenInfo.announcedIp);
 				}
@@ -123,6 +151,28 @@ namespace RTC
 					this->udpSocketOrTcpServers.emplace_back(nullptr, tcpServer, listenInfo.announcedIp);
 				}
 			}
+		};
+
+		try
+		{
+			if (this->numShards > 1u)
+			{
+				// Shards listening in the same IPs and ports belong to the same group.
+				std::string key;
+
+				for (auto& listenInfo : listenInfos)
+				{
+					key.append(listenInfo.ip).append(":").append(std::to_string(listenInfo.port)).append(" ");
+				}
+
+				// This may throw.
+				this->shardGroup = RTC::WebRtcServerShardGroup::Join(key, this, bindSockets, this->shard);
+			}
+			else
+			{
+				// This may throw.
+				bindSockets();
+			}
 
 			// NOTE: This may throw.
 			ChannelMessageHandlers::RegisterHandler(
@@ -135,6 +185,12 @@ namespace RTC
 		{
 			// Must delete everything since the destructor won't be called.
 
+			if (this->shardGroup)
+			{
+				RTC::WebRtcServerShardGroup::Leave(this->shardGroup, this->shard);
+				this->shardGroup = nullptr;
+			}
+
 			for (auto& item : this->udpSocketOrTcpServers)
 			{
 				delete item.udpSocket;
@@ -155,6 +211,13 @@ namespace RTC
 
 		ChannelMessageHandlers::UnregisterHandler(this->id);
 
+		// Stop receiving packets forwarded by other shards.
+		if (this->shardGroup)
+		{
+			RTC::WebRtcServerShardGroup::Leave(this->shardGroup, this->shard);
+			this->shardGroup = nullptr;
+		}
+
 		for (auto& item : this->udpSocketOrTcpServers)
 		{
 			delete item.udpSocket;
@@ -264,6 +327,10 @@ namespace RTC
 
 			++idx;
 		}
+
+		// Add droppedForwardedPackets.
+		if (this->shardGroup)
+			jsonObject["droppedForwardedPackets"] = this->shard->GetDroppedPackets();
 	}
 
 	void WebRtcServer::HandleRequest(Channel::ChannelRequest* request)
@@ -403,6 +470,19 @@ namespace RTC
 
 		if (it2 == this->mapLocalIceUsernameFragmentWebRtcTransport.end())
 		{
+			// The WebRtcTransport may belong to another shard.
+			if (this->shardGroup)
+			{
+				auto shard = this->shardGroup->GetUsernameFragmentShard(this->shard, key);
+
+				if (shard && ForwardToShard(shard, tuple, data, len))
+				{
+					delete packet;
+
+					return;
+				}
+			}
+
 			MS_WARN_TAG(ice, "ignoring received STUN packet with unknown remote ICE usernameFragment");
 
 			delete packet;
@@ -426,6 +506,15 @@ namespace RTC
 
 		if (it == this->mapTupleWebRtcTransport.end())
 		{
+			// The tuple may belong to another shard.
+			if (this->shardGroup)
+			{
+				auto shard = this->shardGroup->GetTupleShard(this->shard, tuple->hash);
+
+				if (shard && ForwardToShard(shard, tuple, data, len))
+					return;
+			}
+
 			MS_WARN_TAG(ice, "ignoring received non STUN data from unknown tuple");
 
 			return;
@@ -436,6 +525,29 @@ namespace RTC
 		webRtcTransport->ProcessNonStunPacketFromWebRtcServer(tuple, data, len);
 	}
 
+	inline bool WebRtcServer::ForwardToShard(
+	  const std::shared_ptr<RTC::WebRtcServerShardGroup::Shard>& shard,
+	  RTC::TransportTuple* tuple,
+	  const uint8_t* data,
+	  size_t len)
+	{
+		MS_TRACE();
+
+		// All the shards of the group have the same UDP sockets in the same order.
+		for (size_t socketIdx{ 0u }; socketIdx < this->udpSocketOrTcpServers.size(); ++socketIdx)
+		{
+			auto* udpSocket = this->udpSocketOrTcpServers[socketIdx].udpSocket;
+
+			if (udpSocket && udpSocket->GetLocalAddress() == tuple->GetLocalAddress())
+			{
+				return RTC::WebRtcServerShardGroup::Forward(
+				  shard, socketIdx, data, len, tuple->GetRemoteAddress());
+			}
+		}
+
+		return false;
+	}
+
 	inline void WebRtcServer::OnWebRtcTransportCreated(RTC::WebRtcTransport* webRtcTransport)
 	{
 		MS_TRACE();
@@ -469,6 +581,9 @@ namespace RTC
 		  "local ICE username fragment already exists in the table");
 
 		this->mapLocalIceUsernameFragmentWebRtcTransport[usernameFragment] = webRtcTransport;
+
+		if (this->shardGroup)
+			this->shardGroup->AddUsernameFragment(usernameFragment, this->shard);
 	}
 
 	inline void WebRtcServer::OnWebRtcTransportLocalIceUsernameFragmentRemoved(
@@ -482,6 +597,9 @@ namespace RTC
 		  "local ICE username fragment not found in the table");
 
 		this->mapLocalIceUsernameFragmentWebRtcTransport.erase(usernameFragment);
+
+		if (this->shardGroup)
+			this->shardGroup->RemoveUsernameFragment(usernameFragment);
 	}
 
 	inline void WebRtcServer::OnWebRtcTransportTransportTupleAdded(
@@ -497,6 +615,9 @@ namespace RTC
 		}
 
 		this->mapTupleWebRtcTransport[tuple->hash] = webRtcTransport;
+
+		if (this->shardGroup)
+			this->shardGroup->AddTuple(tuple->hash, this->shard);
 	}
 
 	inline void WebRtcServer::OnWebRtcTransportTransportTupleRemoved(
@@ -512,18 +633,98 @@ namespace RTC
 		}
 
 		this->mapTupleWebRtcTransport.erase(tuple->hash);
+
+		if (this->shardGroup)
+			this->shardGroup->RemoveTuple(tuple->hash);
 	}
 
-	inline void WebRtcServer::OnUdpSocketPacketReceived(
-	  RTC::UdpSocket* socket, const uint8_t* data, size_t len, const struct sockaddr* remoteAddr)
+	inline void WebRtcServer::OnWebRtcServerShardGroupPacketForwarded(
+	  size_t socketIdx, const uint8_t* data, size_t len, const struct sockaddr* remoteAddr)
 	{
 		MS_TRACE();
 
-		RTC::TransportTuple tuple(socket, remoteAddr);
+		auto* udpSocket = this->udpSocketOrTcpServers[socketIdx].udpSocket;
+
+		RTC::TransportTuple tuple(udpSocket, remoteAddr);
 
 		OnPacketReceived(&tuple, data, len);
 	}
 
+	inline void WebRtcServer::OnUdpSocketPacketsReceived(
+	  RTC::UdpSocket* socket, const RTC::UdpSocket::RecvDatagram* datagrams, size_t count)
+	{
+		MS_TRACE();
+
+		// WebRtcTransports receiving non STUN datagrams of this batch and their
+		// number of datagrams.
+		RTC::WebRtcTransport* batchWebRtcTransports[RTC::UdpSocket::RecvBatchMaxDatagrams];
+		size_t batchWebRtcTransportCounts[RTC::UdpSocket::RecvBatchMaxDatagrams];
+		size_t numBatchWebRtcTransports{ 0u };
+		// Last tuple found in the tuples table. Bursts usually come from the same
+		// remote tuple so this saves most of the lookups.
+		uint64_t lastTupleHash{ 0u };
+		RTC::WebRtcTransport* lastWebRtcTransport{ nullptr };
+
+		for (size_t i{ 0u }; i < count; ++i)
+		{
+			auto& datagram = datagrams[i];
+			RTC::TransportTuple tuple(socket, datagram.addr);
+
+			// STUN packets may add or remove tuples, so forget the last one.
+			if (RTC::StunPacket::IsStun(datagram.data, datagram.len))
+			{
+				lastWebRtcTransport = nullptr;
+
+				OnStunDataReceived(&tuple, datagram.data, datagram.len);
+
+				continue;
+			}
+
+			if (!lastWebRtcTransport || tuple.hash != lastTupleHash)
+			{
+				auto it = this->mapTupleWebRtcTransport.find(tuple.hash);
+
+				if (it == this->mapTupleWebRtcTransport.end())
+				{
+					lastWebRtcTransport = nullptr;
+
+					OnNonStunDataReceived(&tuple, datagram.data, datagram.len);
+
+					continue;
+				}
+
+				lastTupleHash       = tuple.hash;
+				lastWebRtcTransport = it->second;
+			}
+
+			auto* webRtcTransport = lastWebRtcTransport;
+			size_t idx{ 0u };
+
+			while (idx < numBatchWebRtcTransports && batchWebRtcTransports[idx] != webRtcTransport)
+			{
+				++idx;
+			}
+
+			if (idx == numBatchWebRtcTransports)
+			{
+				webRtcTransport->StartRecvBatch();
+
+				batchWebRtcTransports[idx]      = webRtcTransport;
+				batchWebRtcTransportCounts[idx] = 0u;
+				++numBatchWebRtcTransports;
+			}
+
+			batchWebRtcTransportCounts[idx]++;
+
+			webRtcTransport->ProcessNonStunPacketFromWebRtcServer(&tuple, datagram.data, datagram.len);
+		}
+
+		for (size_t idx{ 0u }; idx < numBatchWebRtcTransports; ++idx)
+		{
+			batchWebRtcTransports[idx]->EndRecvBatch(batchWebRtcTransportCounts[idx]);
+		}
+	}
+
 	inline void WebRtcServer::OnRtcTcpConnectionClosed(
 	  RTC::TcpServer* /*tcpServer*/, RTC::TcpConnection* connection)
 	{
@@ -0,0 +1,468 @@
+#define MS_CLASS "RTC::WebRtcServerShardGroup"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "RTC/WebRtcServerShardGroup.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include "Utils.hpp"
+#include <algorithm> // std::find()
+#include <cstring>   // std::memcpy()
+
+namespace RTC
+{
+	/* Static. */
+
+	// Max number of stale username fragments or tuples pending to be dropped from
+	// the cache of a shard. Beyond it the whole cache is dropped.
+	static constexpr size_t MaxStaleEntries{ 1024u };
+	// Max number of username fragments or tuples in the cache of a shard. Beyond
+	// it the cache is emptied so unknown traffic does not make it grow forever.
+	static constexpr size_t MaxCachedEntries{ 4096u };
+
+	/* Static methods for UV callbacks. */
+
+	inline static void onAsync(uv_async_t* handle)
+	{
+		static_cast<WebRtcServerShardGroup::Shard*>(handle->data)->OnUvAsync();
+	}
+
+	inline static void onClose(uv_handle_t* handle)
+	{
+		delete reinterpret_cast<uv_async_t*>(handle);
+	}
+
+	/* Class variables. */
+
+	std::mutex WebRtcServerShardGroup::globalMutex;
+	absl::flat_hash_map<std::string, WebRtcServerShardGroup*> WebRtcServerShardGroup::mapKeyGroup;
+
+	/* Class methods. */
+
+	WebRtcServerShardGroup* WebRtcServerShardGroup::Join(
+	  const std::string& key,
+	  Listener* listener,
+	  const std::function<void()>& bindSockets,
+	  std::shared_ptr<Shard>& shard)
+	{
+		MS_TRACE();
+
+		std::lock_guard<std::mutex> globalLock(WebRtcServerShardGroup::globalMutex);
+
+		// This may throw.
+		bindSockets();
+
+		// This may throw.
+		shard = std::make_shared<Shard>(listener);
+
+		WebRtcServerShardGroup* group;
+		auto it = WebRtcServerShardGroup::mapKeyGroup.find(key);
+
+		if (it != WebRtcServerShardGroup::mapKeyGroup.end())
+		{
+			group = it->second;
+		}
+		else
+		{
+			group = new WebRtcServerShardGroup(key);
+
+			WebRtcServerShardGroup::mapKeyGroup[key] = group;
+		}
+
+		std::lock_guard<std::mutex> lock(group->mutex);
+
+		group->shards.push_back(shard);
+
+		MS_DEBUG_TAG(
+		  info, "shard joined WebRtcServer group [key:'%s', shards:%zu]", key.c_str(), group->shards.size());
+
+		return group;
+	}
+
+	void WebRtcServerShardGroup::Leave(WebRtcServerShardGroup* group, std::shared_ptr<Shard>& shard)
+	{
+		MS_TRACE();
+
+		{
+			std::lock_guard<std::mutex> globalLock(WebRtcServerShardGroup::globalMutex);
+			std::unique_lock<std::mutex> lock(group->mutex);
+
+			auto it = std::find(group->shards.begin(), group->shards.end(), shard);
+
+			MS_ASSERT(it != group->shards.end(), "shard not found in the group");
+
+			group->shards.erase(it);
+
+			for (auto it2 = group->mapUsernameFragmentShard.begin();
+			     it2 != group->mapUsernameFragmentShard.end();)
+			{
+				if (it2->second == shard)
+					group->mapUsernameFragmentShard.erase(it2++);
+				else
+					++it2;
+			}
+
+			for (auto it2 = group->mapTupleShard.begin(); it2 != group->mapTupleShard.end();)
+			{
+				if (it2->second == shard)
+					group->mapTupleShard.erase(it2++);
+				else
+					++it2;
+			}
+
+			// Other shards may have cached username fragments and tuples of this one.
+			for (auto& otherShard : group->shards)
+			{
+				otherShard->AddStaleAll();
+			}
+
+			if (group->shards.empty())
+			{
+				lock.unlock();
+
+				WebRtcServerShardGroup::mapKeyGroup.erase(group->key);
+
+				delete group;
+			}
+		}
+
+		// Don't accept more forwarded packets. Other threads may still hold a
+		// reference to the shard.
+		{
+			std::lock_guard<std::mutex> lock(shard->mutex);
+
+			shard->closed = true;
+			shard->inbox.clear();
+		}
+
+		shard->mapUsernameFragmentShard.clear();
+		shard->mapTupleShard.clear();
+
+		uv_close(reinterpret_cast<uv_handle_t*>(shard->uvHandle), static_cast<uv_close_cb>(onClose));
+		shard->uvHandle = nullptr;
+
+		shard.reset();
+	}
+
+	bool WebRtcServerShardGroup::Forward(
+	  const std::shared_ptr<Shard>& shard,
+	  size_t socketIdx,
+	  const uint8_t* data,
+	  size_t len,
+	  const struct sockaddr* remoteAddr)
+	{
+		MS_TRACE();
+
+		if (len > ForwardedPacket::StoreSize)
+		{
+			MS_WARN_DEV("packet too big to be forwarded [len:%zu]", len);
+
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(shard->mutex);
+
+		if (shard->closed)
+			return false;
+
+		// Don't let a stalled shard make the inbox grow forever.
+		if (shard->inbox.size() >= WebRtcServerShardGroup::MaxInboxPackets)
+		{
+			shard->droppedPackets++;
+
+			return false;
+		}
+
+		shard->inbox.emplace_back();
+
+		auto& forwardedPacket = shard->inbox.back();
+
+		forwardedPacket.socketIdx  = socketIdx;
+		forwardedPacket.remoteAddr = Utils::IP::CopyAddress(remoteAddr);
+		forwardedPacket.len        = len;
+		std::memcpy(forwardedPacket.store, data, len);
+
+		// Wake up the shard loop if this is the first pending packet.
+		if (shard->inbox.size() == 1u)
+			uv_async_send(shard->uvHandle);
+
+		return true;
+	}
+
+	/* Instance methods. */
+
+	WebRtcServerShardGroup::WebRtcServerShardGroup(const std::string& key) : key(key)
+	{
+		MS_TRACE();
+	}
+
+	void WebRtcServerShardGroup::AddUsernameFragment(
+	  const std::string& usernameFragment, const std::shared_ptr<Shard>& shard)
+	{
+		MS_TRACE();
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		this->mapUsernameFragmentShard[usernameFragment] = shard;
+
+		for (auto& otherShard : this->shards)
+		{
+			otherShard->AddStaleUsernameFragment(usernameFragment);
+		}
+	}
+
+	void WebRtcServerShardGroup::RemoveUsernameFragment(const std::string& usernameFragment)
+	{
+		MS_TRACE();
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		this->mapUsernameFragmentShard.erase(usernameFragment);
+
+		for (auto& otherShard : this->shards)
+		{
+			otherShard->AddStaleUsernameFragment(usernameFragment);
+		}
+	}
+
+	void WebRtcServerShardGroup::AddTuple(uint64_t tupleHash, const std::shared_ptr<Shard>& shard)
+	{
+		MS_TRACE();
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		this->mapTupleShard[tupleHash] = shard;
+
+		for (auto& otherShard : this->shards)
+		{
+			otherShard->AddStaleTuple(tupleHash);
+		}
+	}
+
+	void WebRtcServerShardGroup::RemoveTuple(uint64_t tupleHash)
+	{
+		MS_TRACE();
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		this->mapTupleShard.erase(tupleHash);
+
+		for (auto& otherShard : this->shards)
+		{
+			otherShard->AddStaleTuple(tupleHash);
+		}
+	}
+
+	std::shared_ptr<WebRtcServerShardGroup::Shard> WebRtcServerShardGroup::GetUsernameFragmentShard(
+	  const std::shared_ptr<Shard>& shard, const std::string& usernameFragment)
+	{
+		MS_TRACE();
+
+		shard->DropStaleEntries();
+
+		auto it = shard->mapUsernameFragmentShard.find(usernameFragment);
+
+		if (it != shard->mapUsernameFragmentShard.end())
+			return it->second;
+
+		std::shared_ptr<Shard> ownerShard;
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+
+			auto it2 = this->mapUsernameFragmentShard.find(usernameFragment);
+
+			if (it2 != this->mapUsernameFragmentShard.end() && it2->second != shard)
+				ownerShard = it2->second;
+		}
+
+		if (shard->mapUsernameFragmentShard.size() >= MaxCachedEntries)
+			shard->mapUsernameFragmentShard.clear();
+
+		shard->mapUsernameFragmentShard[usernameFragment] = ownerShard;
+
+		return ownerShard;
+	}
+
+	std::shared_ptr<WebRtcServerShardGroup::Shard> WebRtcServerShardGroup::GetTupleShard(
+	  const std::shared_ptr<Shard>& shard, uint64_t tupleHash)
+	{
+		MS_TRACE();
+
+		shard->DropStaleEntries();
+
+		auto it = shard->mapTupleShard.find(tupleHash);
+
+		if (it != shard->mapTupleShard.end())
+			return it->second;
+
+		std::shared_ptr<Shard> ownerShard;
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+
+			auto it2 = this->mapTupleShard.find(tupleHash);
+
+			if (it2 != this->mapTupleShard.end() && it2->second != shard)
+				ownerShard = it2->second;
+		}
+
+		if (shard->mapTupleShard.size() >= MaxCachedEntries)
+			shard->mapTupleShard.clear();
+
+		shard->mapTupleShard[tupleHash] = ownerShard;
+
+		return ownerShard;
+	}
+
+	/* Shard instance methods. */
+
+	WebRtcServerShardGroup::Shard::Shard(Listener* listener) : listener(listener)
+	{
+		MS_TRACE();
+
+		this->uvHandle       = new uv_async_t;
+		this->uvHandle->data = static_cast<void*>(this);
+
+		int err = uv_async_init(DepLibUV::GetLoop(), this->uvHandle, static_cast<uv_async_cb>(onAsync));
+
+		if (err != 0)
+		{
+			delete this->uvHandle;
+			this->uvHandle = nullptr;
+
+			MS_THROW_ERROR("uv_async_init() failed: %s", uv_strerror(err));
+		}
+	}
+
+	WebRtcServerShardGroup::Shard::~Shard()
+	{
+		MS_TRACE();
+
+		// NOTE: The uv_async_t handle is closed in Leave() within the loop of the
+		// shard, this may be called from any thread.
+	}
+
+	size_t WebRtcServerShardGroup::Shard::GetDroppedPackets()
+	{
+		MS_TRACE();
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		return this->droppedPackets;
+	}
+
+	void WebRtcServerShardGroup::Shard::OnUvAsync()
+	{
+		MS_TRACE();
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+
+			std::swap(this->inbox, this->draining);
+		}
+
+		for (auto& forwardedPacket : this->draining)
+		{
+			this->listener->OnWebRtcServerShardGroupPacketForwarded(
+			  forwardedPacket.socketIdx,
+			  forwardedPacket.store,
+			  forwardedPacket.len,
+			  reinterpret_cast<const struct sockaddr*>(&forwardedPacket.remoteAddr));
+		}
+
+		this->draining.clear();
+	}
+
+	void WebRtcServerShardGroup::Shard::AddStaleUsernameFragment(const std::string& usernameFragment)
+	{
+		MS_TRACE();
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		if (this->staleAll)
+			return;
+
+		if (this->staleUsernameFragments.size() < MaxStaleEntries)
+		{
+			this->staleUsernameFragments.push_back(usernameFragment);
+		}
+		else
+		{
+			this->staleAll = true;
+			this->staleUsernameFragments.clear();
+			this->staleTuples.clear();
+		}
+
+		this->hasStaleEntries.store(true, std::memory_order_release);
+	}
+
+	void WebRtcServerShardGroup::Shard::AddStaleTuple(uint64_t tupleHash)
+	{
+		MS_TRACE();
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		if (this->staleAll)
+			return;
+
+		if (this->staleTuples.size() < MaxStaleEntries)
+		{
+			this->staleTuples.push_back(tupleHash);
+		}
+		else
+		{
+			this->staleAll = true;
+			this->staleUsernameFragments.clear();
+			this->staleTuples.clear();
+		}
+
+		this->hasStaleEntries.store(true, std::memory_order_release);
+	}
+
+	void WebRtcServerShardGroup::Shard::AddStaleAll()
+	{
+		MS_TRACE();
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		this->staleAll = true;
+		this->staleUsernameFragments.clear();
+		this->staleTuples.clear();
+		this->hasStaleEntries.store(true, std::memory_order_release);
+	}
+
+	inline void WebRtcServerShardGroup::Shard::DropStaleEntries()
+	{
+		MS_TRACE();
+
+		// Most lookups don't need to lock.
+		if (!this->hasStaleEntries.load(std::memory_order_acquire))
+			return;
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		if (this->staleAll)
+		{
+			this->mapUsernameFragmentShard.clear();
+			this->mapTupleShard.clear();
+		}
+		else
+		{
+			for (auto& usernameFragment : this->staleUsernameFragments)
+			{
+				this->mapUsernameFragmentShard.erase(usernameFragment);
+			}
+
+			for (auto tupleHash : this->staleTuples)
+			{
+				this->mapTupleShard.erase(tupleHash);
+			}
+		}
+
+		this->staleAll = false;
+		this->staleUsernameFragments.clear();
+		this->staleTuples.clear();
+		this->hasStaleEntries.store(false, std::memory_order_relaxed);
+	}
+} // namespace RTC
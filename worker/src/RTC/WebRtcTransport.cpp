@@ -487,6 +487,9 @@ namespace RTC
 		{
 			// Add iceSelectedTuple.
 			this->iceServer->GetSelectedTuple()->FillJson(jsonObject["iceSelectedTuple"]);
+
+			// Add UDP send batch stats.
+			this->iceServer->GetSelectedTuple()->FillJsonSendBatchStats(jsonObject);
 		}
 
 		// Add dtlsState.
@@ -861,25 +864,8 @@ namespace RTC
 			return;
 		}
 
-		const uint8_t* data = packet->GetData();
-		auto intLen         = static_cast<int>(packet->GetSize());
-
-		if (!this->srtpSendSession->EncryptRtp(&data, &intLen))
-		{
-			if (cb)
-			{
-				(*cb)(false, ctx);
-			}
-
-			return;
-		}
-
-		auto len = static_cast<size_t>(intLen);
-
-		this->iceServer->GetSelectedTuple()->Send(data, len, cb, ctx);
-
-		// Increase send transmission.
-		RTC::Transport::DataSent(len);
+		SendRtpPacketToTuple(
+		  this->iceServer->GetSelectedTuple(), packet, this->srtpSendSession, cb, ctx);
 	}
 
 	void WebRtcTransport::SendRtcpPacket(RTC::RTCP::Packet* packet)
@@ -1100,6 +1086,8 @@ namespace RTC
 		}
 
 		// Decrypt the SRTP packet.
+		// NOTE: This is done per packet even within a receive batch since libsrtp
+		// has no API to unprotect several packets at once.
 		auto intLen = static_cast<int>(len);
 
 		if (!this->srtpRecvSession->DecryptSrtp(const_cast<uint8_t*>(data), &intLen))
@@ -1189,14 +1177,22 @@ namespace RTC
 		RTC::Transport::ReceiveRtcpPacket(packet);
 	}
 
-	inline void WebRtcTransport::OnUdpSocketPacketReceived(
-	  RTC::UdpSocket* socket, const uint8_t* data, size_t len, const struct sockaddr* remoteAddr)
+	inline void WebRtcTransport::OnUdpSocketPacketsReceived(
+	  RTC::UdpSocket* socket, const RTC::UdpSocket::RecvDatagram* datagrams, size_t count)
 	{
 		MS_TRACE();
 
-		RTC::TransportTuple tuple(socket, remoteAddr);
+		RTC::Transport::StartRecvBatch();
 
-		OnPacketReceived(&tuple, data, len);
+		for (size_t i{ 0u }; i < count; ++i)
+		{
+			auto& datagram = datagrams[i];
+			RTC::TransportTuple tuple(socket, datagram.addr);
+
+			OnPacketReceived(&tuple, datagram.data, datagram.len);
+		}
+
+		RTC::Transport::EndRecvBatch(count);
 	}
 
 	inline void WebRtcTransport::OnRtcTcpConnectionClosed(
@@ -2,6 +2,7 @@
 // #define MS_LOG_DEV_LEVEL 3
 
 #include "Settings.hpp"
+#include "LatencyStats.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
@@ -19,6 +20,8 @@ extern "C"
 /* Static. */
 
 static std::mutex globalSyncMutex;
+static constexpr uint16_t MaxUdpSendBatchSize{ 256u };
+static constexpr uint16_t MaxTimerGranularity{ 100u };
 
 /* Class variables. */
 
@@ -59,6 +62,9 @@ void Settings::SetConfiguration(int argc, char* argv[])
 		{ "rtcMaxPort",          optional_argument, nullptr, 'M' },
 		{ "dtlsCertificateFile", optional_argument, nullptr, 'c' },
 		{ "dtlsPrivateKeyFile",  optional_argument, nullptr, 'p' },
+		{ "udpSendBatchSize",    optional_argument, nullptr, 'b' },
+		{ "timerGranularity",    optional_argument, nullptr, 'g' },
+		{ "channelFormat",       optional_argument, nullptr, 'f' },
 		{ nullptr, 0, nullptr, 0 }
 	};
 	// clang-format on
@@ -139,6 +145,70 @@ void Settings::SetConfiguration(int argc, char* argv[])
 				break;
 			}
 
+			case 'b':
+			{
+				int value{ 0 };
+
+				try
+				{
+					value = std::stoi(optarg);
+				}
+				catch (const std::exception& error)
+				{
+					MS_THROW_TYPE_ERROR("%s", error.what());
+				}
+
+				// Validate before narrowing so out of range values do not wrap.
+				if (value < 1 || value > static_cast<int>(MaxUdpSendBatchSize))
+				{
+					MS_THROW_TYPE_ERROR(
+					  "udpSendBatchSize must be between 1 and %" PRIu16, MaxUdpSendBatchSize);
+				}
+
+				Settings::configuration.udpSendBatchSize = static_cast<uint16_t>(value);
+
+				break;
+			}
+
+			case 'g':
+			{
+				int value{ 0 };
+
+				try
+				{
+					value = std::stoi(optarg);
+				}
+				catch (const std::exception& error)
+				{
+					MS_THROW_TYPE_ERROR("%s", error.what());
+				}
+
+				// Validate before narrowing so out of range values do not wrap.
+				if (value < 1 || value > static_cast<int>(MaxTimerGranularity))
+				{
+					MS_THROW_TYPE_ERROR(
+					  "timerGranularity must be between 1 and %" PRIu16, MaxTimerGranularity);
+				}
+
+				Settings::configuration.timerGranularity = static_cast<uint16_t>(value);
+
+				break;
+			}
+
+			case 'f':
+			{
+				stringValue = std::string(optarg);
+
+				if (stringValue == "json")
+					Settings::configuration.channelFormat = ChannelFormat::JSON;
+				else if (stringValue == "msgpack")
+					Settings::configuration.channelFormat = ChannelFormat::MSGPACK;
+				else
+					MS_THROW_TYPE_ERROR("invalid channelFormat '%s'", stringValue.c_str());
+
+				break;
+			}
+
 			// Invalid option.
 			case '?':
 			{
@@ -226,6 +296,14 @@ void Settings::PrintConfiguration()
 	MS_DEBUG_TAG(info, "  logTags             : %s", logTagsStream.str().c_str());
 	MS_DEBUG_TAG(info, "  rtcMinPort          : %" PRIu16, Settings::configuration.rtcMinPort);
 	MS_DEBUG_TAG(info, "  rtcMaxPort          : %" PRIu16, Settings::configuration.rtcMaxPort);
+	MS_DEBUG_TAG(
+	  info, "  udpSendBatchSize    : %" PRIu16, Settings::configuration.udpSendBatchSize);
+	MS_DEBUG_TAG(
+	  info, "  timerGranularity    : %" PRIu16, Settings::configuration.timerGranularity);
+	MS_DEBUG_TAG(
+	  info,
+	  "  channelFormat       : %s",
+	  Settings::configuration.channelFormat == ChannelFormat::MSGPACK ? "msgpack" : "json");
 	if (!Settings::configuration.dtlsCertificateFile.empty())
 	{
 		MS_DEBUG_TAG(
@@ -245,8 +323,9 @@ void Settings::HandleRequest(Channel::ChannelRequest* request)
 	{
 		case Channel::ChannelRequest::MethodId::WORKER_UPDATE_SETTINGS:
 		{
-			auto jsonLogLevelIt = request->data.find("logLevel");
-			auto jsonLogTagsIt  = request->data.find("logTags");
+			auto jsonLogLevelIt     = request->data.find("logLevel");
+			auto jsonLogTagsIt      = request->data.find("logTags");
+			auto jsonLatencyStatsIt = request->data.find("latencyStats");
 
 			// Update logLevel if requested.
 			if (jsonLogLevelIt != request->data.end() && jsonLogLevelIt->is_string())
@@ -271,6 +350,10 @@ void Settings::HandleRequest(Channel::ChannelRequest* request)
 				Settings::SetLogTags(logTags);
 			}
 
+			// Enable or disable latencyStats if requested.
+			if (jsonLatencyStatsIt != request->data.end() && jsonLatencyStatsIt->is_boolean())
+				LatencyStats::SetEnabled(jsonLatencyStatsIt->get<bool>());
+
 			// Print the new effective configuration.
 			Settings::PrintConfiguration();
 
@@ -0,0 +1,84 @@
+#define MS_CLASS "Utils::LatencyHistogram"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "Logger.hpp"
+#include "Utils.hpp"
+#include <algorithm> // std::fill()
+
+namespace Utils
+{
+	/* Instance methods. */
+
+	LatencyHistogram::LatencyHistogram() : buckets(BucketCount, 0u)
+	{
+		MS_TRACE();
+	}
+
+	void LatencyHistogram::Reset()
+	{
+		MS_TRACE();
+
+		std::fill(this->buckets.begin(), this->buckets.end(), 0u);
+
+		this->count = 0u;
+		this->sum   = 0u;
+		this->min   = MaxValue;
+		this->max   = 0u;
+	}
+
+	uint64_t LatencyHistogram::GetValueAtPercentile(double percentile) const
+	{
+		MS_TRACE();
+
+		if (this->count == 0u)
+			return 0u;
+
+		if (percentile > 100)
+			percentile = 100;
+
+		// Number of values lower or equal than the one to return (at least 1).
+		auto countAtPercentile =
+		  static_cast<uint64_t>(std::ceil((percentile / 100) * static_cast<double>(this->count)));
+
+		if (countAtPercentile == 0u)
+			countAtPercentile = 1u;
+
+		uint64_t total{ 0u };
+
+		for (size_t index{ 0u }; index < this->buckets.size(); ++index)
+		{
+			total += this->buckets[index];
+
+			if (total >= countAtPercentile)
+				return std::min(GetBucketHighestValue(index), this->max);
+		}
+
+		return this->max;
+	}
+
+	void LatencyHistogram::FillJson(json& jsonObject) const
+	{
+		MS_TRACE();
+
+		jsonObject["count"] = this->count;
+		jsonObject["min"]   = GetMin();
+		jsonObject["max"]   = GetMax();
+		jsonObject["mean"]  = GetMean();
+		jsonObject["p50"]   = GetValueAtPercentile(50);
+		jsonObject["p90"]   = GetValueAtPercentile(90);
+		jsonObject["p99"]   = GetValueAtPercentile(99);
+		jsonObject["p999"]  = GetValueAtPercentile(99.9);
+	}
+
+	uint64_t LatencyHistogram::GetBucketHighestValue(size_t index)
+	{
+		if (index < SubBucketCount)
+			return static_cast<uint64_t>(index);
+
+		auto shift      = static_cast<uint8_t>((index / SubBucketCount) - 1u);
+		auto subBucket  = static_cast<uint64_t>(index % SubBucketCount);
+		uint64_t lowest = (SubBucketCount + subBucket) << shift;
+
+		return lowest + (static_cast<uint64_t>(1u) << shift) - 1u;
+	}
+} // namespace Utils
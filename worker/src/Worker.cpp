@@ -5,10 +5,12 @@
 #include "ChannelMessageHandlers.hpp"
 #include "DepLibUV.hpp"
 #include "DepUsrSCTP.hpp"
+#include "LatencyStats.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Settings.hpp"
 #include "Channel/ChannelNotifier.hpp"
+#include "handles/UdpSocketHandler.hpp"
 
 /* Instance methods. */
 
@@ -37,6 +39,9 @@ Worker::Worker(::Channel::ChannelSocket* channel, PayloadChannel::PayloadChannel
 	// Create the Checker instance in DepUsrSCTP.
 	DepUsrSCTP::CreateChecker();
 
+	// Create the UDP send batch.
+	UdpSocketHandler::CreateSendBatch(Settings::configuration.udpSendBatchSize);
+
 	// Tell the Node process that we are running.
 	Channel::ChannelNotifier::Emit(Logger::pid, "running");
 
@@ -86,6 +91,12 @@ void Worker::Close()
 	// Close the Checker instance in DepUsrSCTP.
 	DepUsrSCTP::CloseChecker();
 
+	// Close the UDP send batch.
+	UdpSocketHandler::CloseSendBatch();
+
+	// Disable LatencyStats (closes its UV handle).
+	LatencyStats::SetEnabled(false);
+
 	// Close the Channel.
 	this->channel->Close();
 
@@ -303,6 +314,27 @@ inline void Worker::HandleRequest(Channel::ChannelRequest* request)
 			break;
 		}
 
+		case Channel::ChannelRequest::MethodId::WORKER_GET_LATENCY_STATS:
+		{
+			json data = json::object();
+
+			LatencyStats::FillJson(data);
+
+			auto jsonResetIt = request->data.find("reset");
+
+			// Reset the histograms if requested.
+			if (
+			  jsonResetIt != request->data.end() && jsonResetIt->is_boolean() &&
+			  jsonResetIt->get<bool>())
+			{
+				LatencyStats::Reset();
+			}
+
+			request->Accept(data);
+
+			break;
+		}
+
 		case Channel::ChannelRequest::MethodId::WORKER_UPDATE_SETTINGS:
 		{
 			Settings::HandleRequest(request);
@@ -376,7 +408,7 @@ inline void Worker::HandleRequest(Channel::ChannelRequest* request)
 				MS_THROW_ERROR("%s [method:%s]", error.what(), request->method.c_str());
 			}
 
-			auto* router = new RTC::Router(routerId, this);
+			auto* router = new RTC::Router(routerId, this, request->data);
 
 			this->mapRouters[routerId] = router;
 
@@ -499,7 +531,8 @@ inline void Worker::HandleNotification(PayloadChannel::PayloadChannelNotificatio
 		if (handler == nullptr)
 		{
 			MS_THROW_ERROR(
-			  "PayloadChannel notification handler with ID %s not found", notification->handlerId.c_str());
+			  "PayloadChannel notification handler with ID %s not found",
+			  std::string(notification->handlerId).c_str());
 		}
 
 		handler->HandleNotification(notification);
@@ -182,6 +182,8 @@ void TcpConnectionHandler::Write(
   size_t len1,
   const uint8_t* data2,
   size_t len2,
+  const uint8_t* data3,
+  size_t len3,
   RTC::Transport::onSendCallback* cb,
   RTC::Transport::OnSendCallbackCtx* ctx)
 {
@@ -197,7 +199,7 @@ void TcpConnectionHandler::Write(
 		return;
 	}
 
-	if (len1 == 0 && len2 == 0)
+	if (len1 == 0 && len2 == 0 && len3 == 0)
 	{
 		if (cb)
 		{
@@ -207,8 +209,8 @@ void TcpConnectionHandler::Write(
 		return;
 	}
 
-	size_t totalLen = len1 + len2;
-	uv_buf_t buffers[2];
+	size_t totalLen = len1 + len2 + len3;
+	uv_buf_t buffers[3];
 	int written{ 0 };
 	int err;
 
@@ -217,7 +219,8 @@ void TcpConnectionHandler::Write(
 
 	buffers[0] = uv_buf_init(reinterpret_cast<char*>(const_cast<uint8_t*>(data1)), len1);
 	buffers[1] = uv_buf_init(reinterpret_cast<char*>(const_cast<uint8_t*>(data2)), len2);
-	written    = uv_try_write(reinterpret_cast<uv_stream_t*>(this->uvHandle), buffers, 2);
+	buffers[2] = uv_buf_init(reinterpret_cast<char*>(const_cast<uint8_t*>(data3)), len3);
+	written    = uv_try_write(reinterpret_cast<uv_stream_t*>(this->uvHandle), buffers, 3);
 
 	// All the data was written. Done.
 	if (written == static_cast<int>(totalLen))
@@ -252,20 +255,23 @@ void TcpConnectionHandler::Write(
 
 	writeData->req.data = static_cast<void*>(writeData);
 
-	// If the first buffer was not entirely written then splice it.
-	if (static_cast<size_t>(written) < len1)
-	{
-		std::memcpy(
-		  writeData->store, data1 + static_cast<size_t>(written), len1 - static_cast<size_t>(written));
-		std::memcpy(writeData->store + (len1 - static_cast<size_t>(written)), data2, len2);
-	}
-	// Otherwise just take the pending data in the second buffer.
-	else
+	// Copy the pending data, skipping what was already written.
+	auto skipLen = static_cast<size_t>(written);
+	size_t storeLen{ 0u };
+
+	for (const auto& buf : buffers)
 	{
-		std::memcpy(
-		  writeData->store,
-		  data2 + (static_cast<size_t>(written) - len1),
-		  len2 - (static_cast<size_t>(written) - len1));
+		if (skipLen >= buf.len)
+		{
+			skipLen -= buf.len;
+
+			continue;
+		}
+
+		std::memcpy(writeData->store + storeLen, buf.base + skipLen, buf.len - skipLen);
+
+		storeLen += buf.len - skipLen;
+		skipLen = 0u;
 	}
 
 	writeData->cb  = cb;
@@ -3,20 +3,10 @@
 
 #include "handles/Timer.hpp"
 #include "DepLibUV.hpp"
+#include "LatencyStats.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
-
-/* Static methods for UV callbacks. */
-
-inline static void onTimer(uv_timer_t* handle)
-{
-	static_cast<Timer*>(handle->data)->OnUvTimer();
-}
-
-inline static void onClose(uv_handle_t* handle)
-{
-	delete handle;
-}
+#include "handles/TimerWheel.hpp"
 
 /* Instance methods. */
 
@@ -24,18 +14,7 @@ Timer::Timer(Listener* listener) : listener(listener)
 {
 	MS_TRACE();
 
-	this->uvHandle       = new uv_timer_t;
-	this->uvHandle->data = static_cast<void*>(this);
-
-	int err = uv_timer_init(DepLibUV::GetLoop(), this->uvHandle);
-
-	if (err != 0)
-	{
-		delete this->uvHandle;
-		this->uvHandle = nullptr;
-
-		MS_THROW_ERROR("uv_timer_init() failed: %s", uv_strerror(err));
-	}
+	TimerWheel::AddTimer(this);
 }
 
 Timer::~Timer()
@@ -55,7 +34,10 @@ void Timer::Close()
 
 	this->closed = true;
 
-	uv_close(reinterpret_cast<uv_handle_t*>(this->uvHandle), static_cast<uv_close_cb>(onClose));
+	if (this->active)
+		TimerWheel::Cancel(this);
+
+	TimerWheel::RemoveTimer(this);
 }
 
 void Timer::Start(uint64_t timeout, uint64_t repeat)
@@ -68,13 +50,10 @@ void Timer::Start(uint64_t timeout, uint64_t repeat)
 	this->timeout = timeout;
 	this->repeat  = repeat;
 
-	if (uv_is_active(reinterpret_cast<uv_handle_t*>(this->uvHandle)) != 0)
+	if (this->active)
 		Stop();
 
-	int err = uv_timer_start(this->uvHandle, static_cast<uv_timer_cb>(onTimer), timeout, repeat);
-
-	if (err != 0)
-		MS_THROW_ERROR("uv_timer_start() failed: %s", uv_strerror(err));
+	Schedule(timeout);
 }
 
 void Timer::Stop()
@@ -84,10 +63,8 @@ void Timer::Stop()
 	if (this->closed)
 		MS_THROW_ERROR("closed");
 
-	int err = uv_timer_stop(this->uvHandle);
-
-	if (err != 0)
-		MS_THROW_ERROR("uv_timer_stop() failed: %s", uv_strerror(err));
+	if (this->active)
+		TimerWheel::Cancel(this);
 }
 
 void Timer::Reset()
@@ -97,17 +74,15 @@ void Timer::Reset()
 	if (this->closed)
 		MS_THROW_ERROR("closed");
 
-	if (uv_is_active(reinterpret_cast<uv_handle_t*>(this->uvHandle)) == 0)
+	if (!this->active)
 		return;
 
 	if (this->repeat == 0u)
 		return;
 
-	int err =
-	  uv_timer_start(this->uvHandle, static_cast<uv_timer_cb>(onTimer), this->repeat, this->repeat);
+	TimerWheel::Cancel(this);
 
-	if (err != 0)
-		MS_THROW_ERROR("uv_timer_start() failed: %s", uv_strerror(err));
+	Schedule(this->repeat);
 }
 
 void Timer::Restart()
@@ -117,20 +92,52 @@ void Timer::Restart()
 	if (this->closed)
 		MS_THROW_ERROR("closed");
 
-	if (uv_is_active(reinterpret_cast<uv_handle_t*>(this->uvHandle)) != 0)
+	if (this->active)
 		Stop();
 
-	int err =
-	  uv_timer_start(this->uvHandle, static_cast<uv_timer_cb>(onTimer), this->timeout, this->repeat);
+	Schedule(this->timeout);
+}
+
+void Timer::Schedule(uint64_t timeout)
+{
+	TimerWheel::Schedule(this, timeout);
 
-	if (err != 0)
-		MS_THROW_ERROR("uv_timer_start() failed: %s", uv_strerror(err));
+	SetExpectedFireTime(timeout);
 }
 
-inline void Timer::OnUvTimer()
+void Timer::SetExpectedFireTime(uint64_t timeout)
+{
+	this->expectedFireTimeNs =
+	  LatencyStats::IsEnabled() ? DepLibUV::GetTimeNs() + (timeout * 1000000u) : 0u;
+}
+
+void Timer::OnTimerWheelExpired()
 {
 	MS_TRACE();
 
+	// As libuv does, schedule the next run of a repeating timer from now and
+	// before notifying the listener, so it can stop or restart it.
+	if (this->repeat != 0u)
+		TimerWheel::Schedule(this, this->repeat);
+
+	if (LatencyStats::IsEnabled())
+	{
+		auto nowNs = DepLibUV::GetTimeNs();
+
+		if (this->expectedFireTimeNs != 0u)
+		{
+			LatencyStats::Record(
+			  LatencyStats::Stage::TIMER_LAG,
+			  nowNs > this->expectedFireTimeNs ? nowNs - this->expectedFireTimeNs : 0u);
+		}
+
+		this->expectedFireTimeNs = this->repeat != 0u ? nowNs + (this->repeat * 1000000u) : 0u;
+	}
+	else
+	{
+		this->expectedFireTimeNs = 0u;
+	}
+
 	// Notify the listener.
 	this->listener->OnTimer(this);
 }
@@ -0,0 +1,475 @@
+#define MS_CLASS "TimerWheel"
+// #define MS_LOG_DEV_LEVEL 3
+
+#include "handles/TimerWheel.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+#include "MediaSoupErrors.hpp"
+#include "Settings.hpp"
+#include "Utils.hpp"
+#include <limits> // std::numeric_limits()
+
+/* Static methods for UV callbacks. */
+
+inline static void onTimer(uv_timer_t* /*handle*/)
+{
+	TimerWheel::OnUvTimer();
+}
+
+inline static void onClose(uv_handle_t* handle)
+{
+	delete handle;
+}
+
+/* Static. */
+
+// Returns the distance from the `start` slot to the first non empty slot of a
+// level of `size` slots (scanning circularly), or `size` if all them are empty.
+inline static size_t findNextSlot(const uint64_t* bitmap, size_t size, size_t start)
+{
+	size_t scanned{ 0u };
+
+	while (scanned < size)
+	{
+		size_t idx    = (start + scanned) & (size - 1);
+		size_t bit    = idx & 63u;
+		uint64_t word = bitmap[idx >> 6] >> bit;
+
+		if (word != 0u)
+			return scanned + Utils::Bits::GetLowestSetBit(word);
+
+		scanned += 64u - bit;
+	}
+
+	return size;
+}
+
+/* Class variables. */
+
+thread_local uv_timer_t* TimerWheel::uvHandle{ nullptr };
+thread_local uint64_t TimerWheel::granularity{ 1u };
+thread_local size_t TimerWheel::numTimers{ 0u };
+thread_local size_t TimerWheel::numScheduled{ 0u };
+thread_local uint64_t TimerWheel::currentTick{ 0u };
+thread_local uint64_t TimerWheel::uvTimerTick{ 0u };
+thread_local bool TimerWheel::expiring{ false };
+thread_local Timer* TimerWheel::slots[TimerWheel::NumSlots + 2u];
+thread_local uint64_t TimerWheel::slotsBitmap[(TimerWheel::NumSlots / 64u) + 1u];
+
+/* Class methods. */
+
+void TimerWheel::AddTimer(Timer* /*timer*/)
+{
+	MS_TRACE();
+
+	// The uv_timer_t exists while there are Timer instances, so it doesn't
+	// outlive the libuv loop.
+	if (TimerWheel::numTimers == 0u)
+	{
+		TimerWheel::uvHandle = new uv_timer_t;
+
+		int err = uv_timer_init(DepLibUV::GetLoop(), TimerWheel::uvHandle);
+
+		if (err != 0)
+		{
+			delete TimerWheel::uvHandle;
+			TimerWheel::uvHandle = nullptr;
+
+			MS_THROW_ERROR("uv_timer_init() failed: %s", uv_strerror(err));
+		}
+
+		TimerWheel::granularity = Settings::configuration.timerGranularity;
+		TimerWheel::currentTick = DepLibUV::GetLoopTimeMs() / TimerWheel::granularity;
+	}
+
+	++TimerWheel::numTimers;
+}
+
+void TimerWheel::RemoveTimer(Timer* timer)
+{
+	MS_TRACE();
+
+	MS_ASSERT(!timer->active, "timer is scheduled");
+	MS_ASSERT(TimerWheel::numTimers != 0u, "no timers");
+
+	--TimerWheel::numTimers;
+
+	if (TimerWheel::numTimers == 0u)
+	{
+		uv_close(
+		  reinterpret_cast<uv_handle_t*>(TimerWheel::uvHandle), static_cast<uv_close_cb>(onClose));
+
+		TimerWheel::uvHandle = nullptr;
+	}
+}
+
+void TimerWheel::Schedule(Timer* timer, uint64_t timeout)
+{
+	MS_TRACE();
+
+	MS_ASSERT(!timer->active, "timer already scheduled");
+
+	// As libuv does, use the loop time.
+	auto nowMs    = DepLibUV::GetLoopTimeMs();
+	auto expireMs = nowMs + timeout;
+
+	if (expireMs < nowMs)
+		expireMs = std::numeric_limits<uint64_t>::max();
+
+	// Nothing was scheduled so there is nothing to process until now.
+	if (TimerWheel::numScheduled == 0u && TimerWheel::currentTick < nowMs / TimerWheel::granularity)
+		TimerWheel::currentTick = nowMs / TimerWheel::granularity;
+
+	// Round up so the timer never fires before its timeout.
+	uint64_t expireTick = (expireMs / TimerWheel::granularity) +
+	                      (expireMs % TimerWheel::granularity != 0u ? 1u : 0u);
+
+	timer->active = true;
+
+	++TimerWheel::numScheduled;
+
+	// Don't wait for the next tick if there is no timeout.
+	if (timeout == 0u)
+	{
+		bool wasDue = TimerWheel::slots[DueSlot] != nullptr;
+
+		timer->wheelExpireTick = TimerWheel::currentTick;
+
+		InsertIntoSlot(timer, DueSlot);
+
+		// Fired at the end of the current expiration pass, or the uv_timer_t is
+		// already started for the next loop iteration.
+		if (TimerWheel::expiring || wasDue)
+			return;
+
+		UpdateUvTimer();
+
+		return;
+	}
+
+	// Never schedule into an already processed tick.
+	if (expireTick <= TimerWheel::currentTick)
+		expireTick = TimerWheel::currentTick + 1u;
+
+	timer->wheelExpireTick = expireTick;
+
+	Insert(timer);
+
+	// The uv_timer_t is updated once all expired timers are processed.
+	if (TimerWheel::expiring)
+		return;
+
+	if (
+	  uv_is_active(reinterpret_cast<uv_handle_t*>(TimerWheel::uvHandle)) == 0 ||
+	  expireTick < TimerWheel::uvTimerTick)
+	{
+		UpdateUvTimer();
+	}
+}
+
+void TimerWheel::Cancel(Timer* timer)
+{
+	MS_TRACE();
+
+	MS_ASSERT(timer->active, "timer not scheduled");
+
+	Unlink(timer);
+
+	timer->active = false;
+
+	--TimerWheel::numScheduled;
+
+	// Don't keep the loop alive. Otherwise, let the uv_timer_t fire, it's
+	// cheaper than looking for the next tick on every cancelation.
+	if (TimerWheel::numScheduled == 0u && !TimerWheel::expiring)
+		uv_timer_stop(TimerWheel::uvHandle);
+}
+
+void TimerWheel::Insert(Timer* timer)
+{
+	MS_TRACE();
+
+	auto expireTick = timer->wheelExpireTick;
+	auto current    = TimerWheel::currentTick;
+	size_t slot;
+
+	if (expireTick - current < Level0Slots)
+	{
+		slot = expireTick & (Level0Slots - 1);
+	}
+	else
+	{
+		size_t level{ 1u };
+		size_t shift{ Level0Bits };
+		size_t base{ Level0Slots };
+
+		for (; level < Levels; ++level, shift += LevelBits, base += LevelSlots)
+		{
+			if ((expireTick >> shift) - (current >> shift) < LevelSlots)
+				break;
+		}
+
+		// Beyond the wheel, wait in the last slot of the top level.
+		if (level == Levels)
+		{
+			shift -= LevelBits;
+			base -= LevelSlots;
+
+			slot = base + (((current >> shift) + LevelSlots - 1) & (LevelSlots - 1));
+		}
+		else
+		{
+			slot = base + ((expireTick >> shift) & (LevelSlots - 1));
+		}
+	}
+
+	InsertIntoSlot(timer, slot);
+}
+
+void TimerWheel::InsertIntoSlot(Timer* timer, size_t slot)
+{
+	MS_TRACE();
+
+	auto* head = TimerWheel::slots[slot];
+
+	timer->wheelSlot = static_cast<uint16_t>(slot);
+
+	// Append it to the circular list of the slot.
+	if (!head)
+	{
+		timer->wheelPrev = timer;
+		timer->wheelNext = timer;
+
+		TimerWheel::slots[slot] = timer;
+		TimerWheel::slotsBitmap[slot >> 6] |= (uint64_t{ 1u } << (slot & 63u));
+	}
+	else
+	{
+		auto* tail = head->wheelPrev;
+
+		tail->wheelNext  = timer;
+		timer->wheelPrev = tail;
+		timer->wheelNext = head;
+		head->wheelPrev  = timer;
+	}
+}
+
+void TimerWheel::Unlink(Timer* timer)
+{
+	MS_TRACE();
+
+	size_t slot = timer->wheelSlot;
+
+	if (timer->wheelNext == timer)
+	{
+		TimerWheel::slots[slot] = nullptr;
+		TimerWheel::slotsBitmap[slot >> 6] &= ~(uint64_t{ 1u } << (slot & 63u));
+	}
+	else
+	{
+		timer->wheelPrev->wheelNext = timer->wheelNext;
+		timer->wheelNext->wheelPrev = timer->wheelPrev;
+
+		if (TimerWheel::slots[slot] == timer)
+			TimerWheel::slots[slot] = timer->wheelNext;
+	}
+
+	timer->wheelPrev = nullptr;
+	timer->wheelNext = nullptr;
+}
+
+void TimerWheel::Cascade(size_t slot)
+{
+	MS_TRACE();
+
+	auto* timer = TimerWheel::slots[slot];
+
+	if (!timer)
+		return;
+
+	TimerWheel::slots[slot] = nullptr;
+	TimerWheel::slotsBitmap[slot >> 6] &= ~(uint64_t{ 1u } << (slot & 63u));
+
+	// Break the circular list at its tail.
+	timer->wheelPrev->wheelNext = nullptr;
+
+	while (timer)
+	{
+		auto* next = timer->wheelNext;
+
+		Insert(timer);
+
+		timer = next;
+	}
+}
+
+void TimerWheel::Expire(size_t slot)
+{
+	MS_TRACE();
+
+	// Timers are unlinked one by one since the listener may stop, restart or
+	// delete any Timer. Those restarted can not end in this same slot.
+	while (TimerWheel::slots[slot])
+	{
+		auto* timer = TimerWheel::slots[slot];
+
+		Unlink(timer);
+
+		timer->active = false;
+
+		--TimerWheel::numScheduled;
+
+		timer->OnTimerWheelExpired();
+	}
+}
+
+void TimerWheel::ExpireDue()
+{
+	MS_TRACE();
+
+	auto* timer = TimerWheel::slots[DueSlot];
+
+	if (!timer)
+		return;
+
+	TimerWheel::slots[DueSlot] = nullptr;
+	TimerWheel::slotsBitmap[DueSlot >> 6] &= ~(uint64_t{ 1u } << (DueSlot & 63u));
+
+	// Move them to another slot so those started again by their listener wait
+	// for the next pass instead of being fired in a loop.
+	timer->wheelPrev->wheelNext = nullptr;
+
+	while (timer)
+	{
+		auto* next = timer->wheelNext;
+
+		InsertIntoSlot(timer, ExpiringDueSlot);
+
+		timer = next;
+	}
+
+	Expire(ExpiringDueSlot);
+}
+
+bool TimerWheel::GetNextTick(uint64_t& tick)
+{
+	MS_TRACE();
+
+	if (TimerWheel::numScheduled == 0u)
+		return false;
+
+	bool found{ false };
+	auto current = TimerWheel::currentTick;
+	auto distance =
+	  findNextSlot(TimerWheel::slotsBitmap, Level0Slots, (current + 1u) & (Level0Slots - 1));
+
+	if (distance < Level0Slots)
+	{
+		tick  = current + 1u + distance;
+		found = true;
+	}
+
+	// Timers in upper levels must be cascaded when their slot is reached.
+	size_t shift{ Level0Bits };
+	size_t base{ Level0Slots };
+
+	for (size_t level{ 1u }; level < Levels; ++level, shift += LevelBits, base += LevelSlots)
+	{
+		auto block = current >> shift;
+
+		distance = findNextSlot(
+		  TimerWheel::slotsBitmap + (base >> 6), LevelSlots, (block + 1u) & (LevelSlots - 1));
+
+		if (distance == LevelSlots)
+			continue;
+
+		auto cascadeTick = (block + 1u + distance) << shift;
+
+		if (!found || cascadeTick < tick)
+		{
+			tick  = cascadeTick;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+void TimerWheel::UpdateUvTimer()
+{
+	MS_TRACE();
+
+	// The last Timer was deleted by a listener.
+	if (!TimerWheel::uvHandle)
+		return;
+
+	auto nowMs = DepLibUV::GetLoopTimeMs();
+	uint64_t tick;
+	uint64_t expireMs;
+
+	// Due timers fire in the next loop iteration.
+	if (TimerWheel::slots[DueSlot])
+	{
+		tick     = TimerWheel::currentTick;
+		expireMs = nowMs;
+	}
+	else if (GetNextTick(tick))
+	{
+		expireMs = tick * TimerWheel::granularity;
+	}
+	else
+	{
+		uv_timer_stop(TimerWheel::uvHandle);
+
+		return;
+	}
+
+	TimerWheel::uvTimerTick = tick;
+
+	int err = uv_timer_start(
+	  TimerWheel::uvHandle,
+	  static_cast<uv_timer_cb>(onTimer),
+	  expireMs > nowMs ? expireMs - nowMs : 0u,
+	  0u);
+
+	if (err != 0)
+		MS_THROW_ERROR("uv_timer_start() failed: %s", uv_strerror(err));
+}
+
+void TimerWheel::OnUvTimer()
+{
+	MS_TRACE();
+
+	auto nowTick = DepLibUV::GetLoopTimeMs() / TimerWheel::granularity;
+	uint64_t tick;
+
+	TimerWheel::expiring = true;
+
+	// Just visit ticks with something to cascade or expire.
+	while (GetNextTick(tick) && tick <= nowTick)
+	{
+		TimerWheel::currentTick = tick;
+
+		// Cascade the upper levels whose slot is reached.
+		for (size_t level{ Levels - 1 }; level > 0u; --level)
+		{
+			size_t shift = Level0Bits + ((level - 1) * LevelBits);
+
+			if ((tick & ((uint64_t{ 1u } << shift) - 1)) != 0u)
+				continue;
+
+			Cascade(Level0Slots + ((level - 1) * LevelSlots) + ((tick >> shift) & (LevelSlots - 1)));
+		}
+
+		Expire(tick & (Level0Slots - 1));
+	}
+
+	if (TimerWheel::currentTick < nowTick)
+		TimerWheel::currentTick = nowTick;
+
+	ExpireDue();
+
+	TimerWheel::expiring = false;
+
+	UpdateUvTimer();
+}
@@ -2,15 +2,69 @@
 // #define MS_LOG_DEV_LEVEL 3
 
 #include "handles/UdpSocketHandler.hpp"
+#include "DepLibUV.hpp"
+#include "LatencyStats.hpp"
 #include "Logger.hpp"
 #include "MediaSoupErrors.hpp"
 #include "Utils.hpp"
 #include <cstring> // std::memcpy()
+#include <memory> // std::unique_ptr
+#ifdef __linux__
+#include <cerrno>
+#include <netinet/udp.h>
+#endif
 
 /* Static. */
 
-static constexpr size_t ReadBufferSize{ 65536 };
-thread_local static uint8_t ReadBuffer[ReadBufferSize];
+// Size of each datagram slot of the read buffer. libuv splits the buffer into
+// slots of this size when using recvmmsg() so a slot can hold the largest UDP
+// datagram (or a GRO coalesced one).
+static constexpr size_t ReadBufferSlotSize{ 65536 };
+static constexpr size_t ReadBufferSize{ ReadBufferSlotSize * UdpSocketHandler::RecvBatchMaxDatagrams };
+// Allocated on first use so threads not running a worker don't pay for it.
+// NOTE: It's left uninitialized on purpose. Only the pages the kernel writes
+// datagrams into become resident, which is about one MTU per slot rather than
+// the whole buffer.
+thread_local static std::unique_ptr<uint8_t[]> ReadBuffer;
+// Datagrams received in the current recvmmsg() batch.
+thread_local static UdpSocketHandler::RecvDatagram RecvBatch[UdpSocketHandler::RecvBatchMaxDatagrams];
+thread_local static size_t RecvBatchLength{ 0u };
+#ifdef __linux__
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+// Max number of segments the kernel accepts in a single UDP GSO send.
+static constexpr size_t MaxGsoSegments{ 64u };
+// Max payload of a single UDP GSO send.
+static constexpr size_t MaxGsoBytes{ 65000u };
+
+/* Struct holding a UDP_SEGMENT control message. */
+union GsoControl
+{
+	char buf[CMSG_SPACE(sizeof(uint16_t))];
+	struct cmsghdr align;
+};
+
+// Scratch space for sendmmsg(), sized when creating the send batch.
+thread_local static std::vector<struct mmsghdr> SendBatchMsgs;
+thread_local static std::vector<struct iovec> SendBatchIovs;
+thread_local static std::vector<size_t> SendBatchMsgItems;
+thread_local static std::vector<GsoControl> SendBatchControls;
+#endif
+// Items of the send batch sorted by socket, sized when creating the send batch.
+thread_local static std::vector<UdpSocketHandler::SendBatchItem*> SendBatchSortedItems;
+
+/* Class variables. */
+
+thread_local size_t UdpSocketHandler::sendBatchSize{ 1u };
+thread_local std::vector<UdpSocketHandler::SendBatchItem>* UdpSocketHandler::sendBatch{ nullptr };
+thread_local size_t UdpSocketHandler::sendBatchLength{ 0u };
+thread_local bool UdpSocketHandler::sendBatchFlushing{ false };
+thread_local uv_prepare_t* UdpSocketHandler::sendBatchPrepareHandle{ nullptr };
+thread_local uv_check_t* UdpSocketHandler::sendBatchCheckHandle{ nullptr };
 
 /* Static methods for UV callbacks. */
 
@@ -53,6 +107,183 @@ inline static void onClose(uv_handle_t* handle)
 	delete handle;
 }
 
+inline static void onSendBatchPrepare(uv_prepare_t* /*handle*/)
+{
+	UdpSocketHandler::FlushSendBatch();
+}
+
+inline static void onSendBatchCheck(uv_check_t* /*handle*/)
+{
+	UdpSocketHandler::FlushSendBatch();
+}
+
+/* Class methods. */
+
+/**
+ * Datagrams sent during a loop iteration are queued into a worker wide batch
+ * which is flushed right before libuv polls for I/O (so datagrams generated by
+ * timers are not delayed) and right after it (so datagrams generated by I/O
+ * callbacks are not delayed either). Datagrams of the same socket are written
+ * with a single sendmmsg() and, if they have the same destination and size,
+ * coalesced into a single UDP GSO message.
+ */
+void UdpSocketHandler::CreateSendBatch(size_t size)
+{
+	MS_TRACE();
+
+	MS_ASSERT(UdpSocketHandler::sendBatch == nullptr, "send batch already created");
+
+	UdpSocketHandler::sendBatchSize = size;
+
+	// Batching disabled.
+	if (size <= 1u)
+		return;
+
+	int err;
+
+	UdpSocketHandler::sendBatch = new std::vector<SendBatchItem>(size);
+	SendBatchSortedItems.resize(size);
+#ifdef __linux__
+	SendBatchMsgs.resize(size);
+	SendBatchIovs.resize(size);
+	SendBatchMsgItems.resize(size);
+	SendBatchControls.resize(size);
+#endif
+
+	UdpSocketHandler::sendBatchPrepareHandle = new uv_prepare_t;
+
+	err = uv_prepare_init(DepLibUV::GetLoop(), UdpSocketHandler::sendBatchPrepareHandle);
+
+	if (err != 0)
+		MS_THROW_ERROR("uv_prepare_init() failed: %s", uv_strerror(err));
+
+	uv_prepare_start(
+	  UdpSocketHandler::sendBatchPrepareHandle, static_cast<uv_prepare_cb>(onSendBatchPrepare));
+	// Don't let it keep the loop alive.
+	uv_unref(reinterpret_cast<uv_handle_t*>(UdpSocketHandler::sendBatchPrepareHandle));
+
+	UdpSocketHandler::sendBatchCheckHandle = new uv_check_t;
+
+	err = uv_check_init(DepLibUV::GetLoop(), UdpSocketHandler::sendBatchCheckHandle);
+
+	if (err != 0)
+		MS_THROW_ERROR("uv_check_init() failed: %s", uv_strerror(err));
+
+	uv_check_start(UdpSocketHandler::sendBatchCheckHandle, static_cast<uv_check_cb>(onSendBatchCheck));
+	// Don't let it keep the loop alive.
+	uv_unref(reinterpret_cast<uv_handle_t*>(UdpSocketHandler::sendBatchCheckHandle));
+}
+
+void UdpSocketHandler::CloseSendBatch()
+{
+	MS_TRACE();
+
+	UdpSocketHandler::FlushSendBatch();
+
+	if (UdpSocketHandler::sendBatchPrepareHandle)
+	{
+		uv_close(
+		  reinterpret_cast<uv_handle_t*>(UdpSocketHandler::sendBatchPrepareHandle),
+		  static_cast<uv_close_cb>(onClose));
+
+		UdpSocketHandler::sendBatchPrepareHandle = nullptr;
+	}
+
+	if (UdpSocketHandler::sendBatchCheckHandle)
+	{
+		uv_close(
+		  reinterpret_cast<uv_handle_t*>(UdpSocketHandler::sendBatchCheckHandle),
+		  static_cast<uv_close_cb>(onClose));
+
+		UdpSocketHandler::sendBatchCheckHandle = nullptr;
+	}
+
+	delete UdpSocketHandler::sendBatch;
+	UdpSocketHandler::sendBatch = nullptr;
+	SendBatchSortedItems.clear();
+#ifdef __linux__
+	SendBatchMsgs.clear();
+	SendBatchIovs.clear();
+	SendBatchMsgItems.clear();
+	SendBatchControls.clear();
+#endif
+	UdpSocketHandler::sendBatchLength = 0u;
+	UdpSocketHandler::sendBatchSize   = 1u;
+}
+
+void UdpSocketHandler::FlushSendBatch()
+{
+	MS_TRACE();
+
+	if (UdpSocketHandler::sendBatchLength == 0u || UdpSocketHandler::sendBatchFlushing)
+		return;
+
+	// NOTE: Send callbacks may send new datagrams. Those are sent immediately
+	// while flushing.
+	UdpSocketHandler::sendBatchFlushing = true;
+
+	auto& batch = *UdpSocketHandler::sendBatch;
+	const size_t length{ UdpSocketHandler::sendBatchLength };
+	auto* items = SendBatchSortedItems.data();
+
+	for (size_t idx{ 0u }; idx < length; ++idx)
+	{
+		items[idx] = std::addressof(batch[idx]);
+	}
+
+	// Group items by socket, keeping their order within each socket. Insertion
+	// sort in place since std::stable_sort() may allocate a temporary buffer.
+	for (size_t idx{ 1u }; idx < length; ++idx)
+	{
+		auto* item = items[idx];
+		size_t pos{ idx };
+
+		while (pos > 0u && std::less<UdpSocketHandler*>()(item->socket, items[pos - 1]->socket))
+		{
+			items[pos] = items[pos - 1];
+			--pos;
+		}
+
+		items[pos] = item;
+	}
+
+	size_t first{ 0u };
+
+	while (first < length)
+	{
+		auto* socket = items[first]->socket;
+
+		// Dropped by a socket closed by a send callback of a previous group.
+		if (!socket)
+		{
+			++first;
+
+			continue;
+		}
+
+		size_t last{ first + 1 };
+
+		while (last < length && items[last]->socket == socket)
+		{
+			++last;
+		}
+
+		// Detach the items from the socket so DropBatchItems() does not fail
+		// them once they are being sent.
+		for (size_t idx{ first }; idx < last; ++idx)
+		{
+			items[idx]->socket = nullptr;
+		}
+
+		socket->SendBatchItems(items + first, last - first);
+
+		first = last;
+	}
+
+	UdpSocketHandler::sendBatchLength   = 0u;
+	UdpSocketHandler::sendBatchFlushing = false;
+}
+
 /* Instance methods. */
 
 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
@@ -100,6 +331,9 @@ void UdpSocketHandler::Close()
 
 	this->closed = true;
 
+	// Fail datagrams of this socket waiting in the send batch.
+	DropBatchItems();
+
 	// Tell the UV handle that the UdpSocketHandler has been closed.
 	this->uvHandle->data = nullptr;
 
@@ -122,8 +356,10 @@ void UdpSocketHandler::Dump() const
 }
 
 void UdpSocketHandler::Send(
-  const uint8_t* data,
-  size_t len,
+  const uint8_t* data1,
+  size_t len1,
+  const uint8_t* data2,
+  size_t len2,
   const struct sockaddr* addr,
   RTC::Transport::onSendCallback* cb,
   RTC::Transport::OnSendCallbackCtx* ctx)
@@ -140,6 +376,8 @@ void UdpSocketHandler::Send(
 		return;
 	}
 
+	size_t len = len1 + len2;
+
 	if (len == 0)
 	{
 		if (cb)
@@ -150,11 +388,89 @@ void UdpSocketHandler::Send(
 		return;
 	}
 
+	auto* buffer = GetSendBuffer(len);
+
+	// Send batch disabled, being flushed or datagram too big for it.
+	if (!buffer)
+	{
+		SendDatagram(data1, len1, data2, len2, addr, cb, ctx);
+
+		return;
+	}
+
+	std::memcpy(buffer, data1, len1);
+
+	if (len2 != 0)
+		std::memcpy(buffer + len1, data2, len2);
+
+	SendBuffer(len, addr, cb, ctx);
+}
+
+uint8_t* UdpSocketHandler::GetSendBuffer(size_t len)
+{
+	MS_TRACE();
+
+	if (this->closed || !UdpSocketHandler::sendBatch || UdpSocketHandler::sendBatchFlushing)
+		return nullptr;
+
+	// Datagram too big for the send batch. Flush it so the order of datagrams
+	// is kept when the caller sends it by other means.
+	if (len > SendBatchItem::StoreSize)
+	{
+		UdpSocketHandler::FlushSendBatch();
+
+		return nullptr;
+	}
+
+	return (*UdpSocketHandler::sendBatch)[UdpSocketHandler::sendBatchLength].store;
+}
+
+void UdpSocketHandler::SendBuffer(
+  size_t len,
+  const struct sockaddr* addr,
+  RTC::Transport::onSendCallback* cb,
+  RTC::Transport::OnSendCallbackCtx* ctx)
+{
+	MS_TRACE();
+
+	MS_ASSERT(UdpSocketHandler::sendBatch != nullptr, "send batch not created");
+	MS_ASSERT(len <= SendBatchItem::StoreSize, "datagram too big");
+
+	auto& item = (*UdpSocketHandler::sendBatch)[UdpSocketHandler::sendBatchLength];
+
+	item.socket = this;
+	item.addr   = Utils::IP::CopyAddress(addr);
+	item.len    = len;
+	item.cb     = cb;
+	item.ctx    = ctx;
+
+	if (++UdpSocketHandler::sendBatchLength == UdpSocketHandler::sendBatchSize)
+		UdpSocketHandler::FlushSendBatch();
+}
+
+void UdpSocketHandler::SendDatagram(
+  const uint8_t* data1,
+  size_t len1,
+  const uint8_t* data2,
+  size_t len2,
+  const struct sockaddr* addr,
+  RTC::Transport::onSendCallback* cb,
+  RTC::Transport::OnSendCallbackCtx* ctx)
+{
+	MS_TRACE();
+
+	LatencyStats::Scope latencyScope(LatencyStats::Stage::SOCKET_SEND);
+
 	// First try uv_udp_try_send(). In case it can not directly send the datagram
 	// then build a uv_req_t and use uv_udp_send().
 
-	uv_buf_t buffer = uv_buf_init(reinterpret_cast<char*>(const_cast<uint8_t*>(data)), len);
-	int sent        = uv_udp_try_send(this->uvHandle, &buffer, 1, addr);
+	size_t len = len1 + len2;
+	uv_buf_t buffers[2];
+
+	buffers[0] = uv_buf_init(reinterpret_cast<char*>(const_cast<uint8_t*>(data1)), len1);
+	buffers[1] = uv_buf_init(reinterpret_cast<char*>(const_cast<uint8_t*>(data2)), len2);
+
+	int sent = uv_udp_try_send(this->uvHandle, buffers, len2 != 0 ? 2 : 1, addr);
 
 	// Entire datagram was sent. Done.
 	if (sent == static_cast<int>(len))
@@ -192,11 +508,15 @@ void UdpSocketHandler::Send(
 	auto* sendData = new UvSendData(len);
 
 	sendData->req.data = static_cast<void*>(sendData);
-	std::memcpy(sendData->store, data, len);
+	std::memcpy(sendData->store, data1, len1);
+
+	if (len2 != 0)
+		std::memcpy(sendData->store + len1, data2, len2);
+
 	sendData->cb  = cb;
 	sendData->ctx = ctx;
 
-	buffer = uv_buf_init(reinterpret_cast<char*>(sendData->store), len);
+	uv_buf_t buffer = uv_buf_init(reinterpret_cast<char*>(sendData->store), len);
 
 	int err = uv_udp_send(
 	  &sendData->req, this->uvHandle, &buffer, 1, addr, static_cast<uv_udp_send_cb>(onSend));
@@ -220,6 +540,251 @@ void UdpSocketHandler::Send(
 	}
 }
 
+void UdpSocketHandler::SendBatchItems(SendBatchItem** items, size_t count)
+{
+	MS_TRACE();
+
+	if (this->closed)
+	{
+		for (size_t idx{ 0u }; idx < count; ++idx)
+		{
+			auto* item = items[idx];
+
+			if (item->cb)
+				(*item->cb)(false, item->ctx);
+		}
+
+		return;
+	}
+
+#ifdef __linux__
+	uv_os_fd_t fd;
+
+	// If there are datagrams already queued in libuv (due to EAGAIN) writing
+	// into the fd would reorder them.
+	if (
+	  count > 1 && this->uvHandle->send_queue_count == 0 &&
+	  uv_fileno(reinterpret_cast<uv_handle_t*>(this->uvHandle), &fd) == 0)
+	{
+		auto* msgs = SendBatchMsgs.data();
+		auto* iovs = SendBatchIovs.data();
+		// Number of items in each message.
+		auto* msgItems = SendBatchMsgItems.data();
+		// Space for a UDP_SEGMENT control message in each message.
+		auto* controls = SendBatchControls.data();
+		size_t numMsgs{ 0u };
+		size_t idx{ 0u };
+
+		std::memset(msgs, 0, sizeof(struct mmsghdr) * count);
+
+		while (idx < count)
+		{
+			auto* item   = items[idx];
+			auto& msg    = msgs[numMsgs].msg_hdr;
+			size_t first = idx;
+			size_t bytes = item->len;
+
+			iovs[idx].iov_base = item->store;
+			iovs[idx].iov_len  = item->len;
+			++idx;
+
+			// Coalesce following items with same destination and size into a GSO
+			// message. The last segment may be smaller.
+			if (!this->gsoDisabled)
+			{
+				while (idx < count && idx - first < MaxGsoSegments &&
+				       bytes + items[idx]->len <= MaxGsoBytes && items[idx]->len <= item->len &&
+				       items[idx - 1]->len == item->len &&
+				       Utils::IP::CompareAddresses(
+				         reinterpret_cast<const struct sockaddr*>(std::addressof(items[idx]->addr)),
+				         reinterpret_cast<const struct sockaddr*>(std::addressof(item->addr))))
+				{
+					iovs[idx].iov_base = items[idx]->store;
+					iovs[idx].iov_len  = items[idx]->len;
+					bytes += items[idx]->len;
+					++idx;
+				}
+			}
+
+			msg.msg_name    = std::addressof(item->addr);
+			msg.msg_namelen = item->addr.ss_family == AF_INET6 ? sizeof(struct sockaddr_in6)
+			                                                   : sizeof(struct sockaddr_in);
+			msg.msg_iov    = std::addressof(iovs[first]);
+			msg.msg_iovlen = idx - first;
+
+			if (idx - first > 1)
+			{
+				msg.msg_control    = controls[numMsgs].buf;
+				msg.msg_controllen = sizeof(controls[numMsgs].buf);
+
+				auto* cmsg       = CMSG_FIRSTHDR(&msg);
+				cmsg->cmsg_level = SOL_UDP;
+				cmsg->cmsg_type  = UDP_SEGMENT;
+				cmsg->cmsg_len   = CMSG_LEN(sizeof(uint16_t));
+
+				auto segmentSize = static_cast<uint16_t>(item->len);
+
+				std::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(uint16_t));
+			}
+
+			msgItems[numMsgs] = idx - first;
+			++numMsgs;
+		}
+
+		size_t msgIdx{ 0u };
+
+		idx = 0u;
+
+		while (msgIdx < numMsgs)
+		{
+			int sent;
+
+			{
+				// Split among all the datagrams given to sendmmsg().
+				LatencyStats::Scope latencyScope(LatencyStats::Stage::SOCKET_SEND, count - idx);
+
+				sent = sendmmsg(fd, msgs + msgIdx, numMsgs - msgIdx, 0);
+			}
+
+			if (sent < 0 && errno == EINTR)
+				continue;
+
+			if (sent > 0)
+			{
+				this->sendBatchStats.batches++;
+
+				for (int i{ 0 }; i < sent; ++i, ++msgIdx)
+				{
+					if (msgItems[msgIdx] > 1)
+						this->sendBatchStats.gsoDatagrams += msgItems[msgIdx];
+
+					for (size_t j{ 0u }; j < msgItems[msgIdx]; ++j, ++idx)
+					{
+						auto* item = items[idx];
+
+						// Update sent bytes.
+						this->sentBytes += item->len;
+						this->sendBatchStats.batchedDatagrams++;
+
+						if (item->cb)
+							(*item->cb)(true, item->ctx);
+					}
+				}
+
+				continue;
+			}
+
+			// The kernel or the NIC does not support UDP GSO, so disable it in this
+			// socket and send the datagrams of this message one by one.
+			if (msgItems[msgIdx] > 1 && (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT))
+			{
+				MS_WARN_DEV("UDP GSO send failed, disabling it: %s", std::strerror(errno));
+
+				this->gsoDisabled = true;
+			}
+			// Any error but legit EAGAIN.
+			else if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				MS_WARN_DEV("sendmmsg() failed, trying uv_udp_send(): %s", std::strerror(errno));
+			}
+
+			// Send the remaining datagrams one by one. Those will be queued in libuv
+			// if needed.
+			break;
+		}
+
+		if (idx == count)
+			return;
+
+		items += idx;
+		count -= idx;
+	}
+#endif
+
+	for (size_t idx{ 0u }; idx < count; ++idx)
+	{
+		auto* item = items[idx];
+
+		SendDatagram(
+		  item->store,
+		  item->len,
+		  nullptr,
+		  0u,
+		  reinterpret_cast<const struct sockaddr*>(std::addressof(item->addr)),
+		  item->cb,
+		  item->ctx);
+	}
+}
+
+void UdpSocketHandler::DropBatchItems()
+{
+	MS_TRACE();
+
+	if (UdpSocketHandler::sendBatchLength == 0u)
+		return;
+
+	auto& batch = *UdpSocketHandler::sendBatch;
+
+	// The batch is being flushed so items cannot be removed. Detach them
+	// instead so FlushSendBatch() skips them once this socket is deleted.
+	if (UdpSocketHandler::sendBatchFlushing)
+	{
+		for (size_t idx{ 0u }; idx < UdpSocketHandler::sendBatchLength; ++idx)
+		{
+			auto& item = batch[idx];
+
+			if (item.socket != this)
+				continue;
+
+			item.socket = nullptr;
+
+			if (item.cb)
+				(*item.cb)(false, item.ctx);
+		}
+
+		return;
+	}
+
+	size_t length{ 0u };
+
+	for (size_t idx{ 0u }; idx < UdpSocketHandler::sendBatchLength; ++idx)
+	{
+		auto& item = batch[idx];
+
+		if (item.socket == this)
+		{
+			if (item.cb)
+				(*item.cb)(false, item.ctx);
+
+			continue;
+		}
+
+		if (length != idx)
+			batch[length] = item;
+
+		++length;
+	}
+
+	UdpSocketHandler::sendBatchLength = length;
+}
+
+inline void UdpSocketHandler::DeliverRecvBatch()
+{
+	MS_TRACE();
+
+	auto count = RecvBatchLength;
+
+	if (count == 0u)
+		return;
+
+	RecvBatchLength = 0u;
+
+	LatencyStats::Scope latencyScope(LatencyStats::Stage::UDP_RECV, count);
+
+	// Notify the subclass.
+	UserOnUdpDatagramsReceived(RecvBatch, count);
+}
+
 bool UdpSocketHandler::SetLocalAddress()
 {
 	MS_TRACE();
@@ -249,9 +814,13 @@ inline void UdpSocketHandler::OnUvRecvAlloc(size_t /*suggestedSize*/, uv_buf_t*
 {
 	MS_TRACE();
 
-	// Tell UV to write into the static buffer.
-	buf->base = reinterpret_cast<char*>(ReadBuffer);
-	// Give UV all the buffer space.
+	if (!ReadBuffer)
+		ReadBuffer.reset(new uint8_t[ReadBufferSize]);
+
+	// Tell UV to write into the read buffer.
+	buf->base = reinterpret_cast<char*>(ReadBuffer.get());
+	// Give UV all the buffer space so it can read up to RecvBatchMaxDatagrams
+	// datagrams with a single recvmmsg().
 	buf->len = ReadBufferSize;
 }
 
@@ -260,6 +829,16 @@ inline void UdpSocketHandler::OnUvRecv(
 {
 	MS_TRACE();
 
+	// End of a recvmmsg() batch, deliver its datagrams. Those point into the
+	// read buffer and to addresses in the libuv stack, which remain valid until
+	// this callback returns.
+	if ((flags & UV_UDP_MMSG_FREE) != 0u)
+	{
+		DeliverRecvBatch();
+
+		return;
+	}
+
 	// NOTE: Ignore if there is nothing to read or if it was an empty datagram.
 	if (nread == 0)
 		return;
@@ -278,8 +857,20 @@ inline void UdpSocketHandler::OnUvRecv(
 		// Update received bytes.
 		this->recvBytes += nread;
 
-		// Notify the subclass.
-		UserOnUdpDatagramReceived(reinterpret_cast<uint8_t*>(buf->base), nread, addr);
+		// Just in case.
+		if (RecvBatchLength == UdpSocketHandler::RecvBatchMaxDatagrams)
+			DeliverRecvBatch();
+
+		auto& datagram = RecvBatch[RecvBatchLength++];
+
+		datagram.data = reinterpret_cast<uint8_t*>(buf->base);
+		datagram.len  = static_cast<size_t>(nread);
+		datagram.addr = addr;
+
+		// Datagram read with recvmsg() rather than as part of a recvmmsg() batch,
+		// deliver it now.
+		if ((flags & UV_UDP_MMSG_CHUNK) == 0u)
+			DeliverRecvBatch();
 	}
 	// Some error.
 	else
@@ -201,6 +201,25 @@ extern "C" int mediasoup_worker_run(
 	}
 }
 
+extern "C" int mediasoup_worker_payload_channel_push(
+  const void* handle,
+  uint8_t eventId,
+  const char* handlerId,
+  uint32_t handlerIdLen,
+  uint32_t ppid,
+  const uint8_t* payload,
+  uint32_t payloadLen)
+{
+	// The PayloadChannelSocket is stored in the data of its read handle.
+	auto* payloadChannel = static_cast<PayloadChannel::PayloadChannelSocket*>(
+	  static_cast<const uv_async_t*>(handle)->data);
+
+	if (!payloadChannel->PushToRing(eventId, handlerId, handlerIdLen, ppid, payload, payloadLen))
+		return -1;
+
+	return 0;
+}
+
 void IgnoreSignals()
 {
 #ifndef _WIN32
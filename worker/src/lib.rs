@@ -80,6 +80,21 @@ extern "C" {
     /// Returns `0` on success, or an error code `< 0` on failure
     pub fn uv_async_send(handle: UvAsyncT) -> c_int;
 
+    /// Pushes a binary payload channel notification into the ring read by the worker thread.
+    /// Only one thread may call it at a time.
+    ///
+    /// Returns `0` on success, or `-1` if it doesn't fit and must be sent through the regular
+    /// payload channel
+    pub fn mediasoup_worker_payload_channel_push(
+        handle: UvAsyncT,
+        event_id: u8,
+        handler_id: *const c_char,
+        handler_id_len: u32,
+        ppid: u32,
+        payload: *const u8,
+        payload_len: u32,
+    ) -> c_int;
+
     pub fn mediasoup_worker_run(
         argc: c_int,
         argv: *const *const c_char,
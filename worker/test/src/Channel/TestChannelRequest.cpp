@@ -0,0 +1,276 @@
+#include "common.hpp"
+#include "DepLibUV.hpp"
+#include "Settings.hpp"
+#include "Channel/ChannelRequest.hpp"
+#include "Channel/ChannelSocket.hpp"
+#include <catch2/catch.hpp>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+// #define PERFORMANCE_TEST 1
+
+#ifdef PERFORMANCE_TEST
+#include <chrono>
+#include <iostream>
+#endif
+
+using json = nlohmann::json;
+
+#ifdef PERFORMANCE_TEST
+// Like the data of the WORKER_DUMP response of a worker with some routers.
+static json createWorkerDump()
+{
+	json jsonObject = json::object();
+
+	jsonObject["pid"]             = 12345;
+	jsonObject["webRtcServerIds"] = json::array();
+	jsonObject["routerIds"]       = json::array();
+
+	auto& jsonHandlers = jsonObject["channelMessageHandlers"];
+
+	jsonHandlers["channelRequestHandlers"]             = json::array();
+	jsonHandlers["payloadChannelRequestHandlers"]      = json::array();
+	jsonHandlers["payloadChannelNotificationHandlers"] = json::array();
+
+	for (int i{ 0 }; i < 200; ++i)
+	{
+		std::string id = "b3c9a4b7-4f4e-4d2a-9c1e-" + std::to_string(100000000000 + i);
+
+		if (i < 10)
+			jsonObject["routerIds"].push_back(id);
+
+		jsonHandlers["channelRequestHandlers"].push_back(id);
+		jsonHandlers["payloadChannelRequestHandlers"].push_back(id);
+		jsonHandlers["payloadChannelNotificationHandlers"].push_back(id);
+	}
+
+	return jsonObject;
+}
+
+// Like the data of the TRANSPORT_GET_STATS response of a WebRtcTransport.
+static json createTransportStats()
+{
+	json jsonArray = json::array();
+
+	jsonArray.emplace_back(json::value_t::object);
+
+	auto& jsonObject = jsonArray[0];
+
+	jsonObject["type"]                     = "webrtc-transport";
+	jsonObject["transportId"]              = "b3c9a4b7-4f4e-4d2a-9c1e-3f3c2a1b0d9e";
+	jsonObject["timestamp"]                = 1234567890123;
+	jsonObject["sctpState"]                = "connected";
+	jsonObject["bytesReceived"]            = 123456789;
+	jsonObject["recvBitrate"]              = 2345678;
+	jsonObject["bytesSent"]                = 987654321;
+	jsonObject["sendBitrate"]              = 3456789;
+	jsonObject["rtpBytesReceived"]         = 123000000;
+	jsonObject["rtpRecvBitrate"]           = 2300000;
+	jsonObject["rtpBytesSent"]             = 987000000;
+	jsonObject["rtpSendBitrate"]           = 3400000;
+	jsonObject["rtxBytesReceived"]         = 12345;
+	jsonObject["rtxRecvBitrate"]           = 1234;
+	jsonObject["rtxBytesSent"]             = 54321;
+	jsonObject["rtxSendBitrate"]           = 4321;
+	jsonObject["probationBytesSent"]       = 3456;
+	jsonObject["probationSendBitrate"]     = 0;
+	jsonObject["availableOutgoingBitrate"] = 4500000;
+	jsonObject["availableIncomingBitrate"] = 3500000;
+	jsonObject["maxIncomingBitrate"]       = 0;
+	jsonObject["maxOutgoingBitrate"]       = 0;
+	jsonObject["minOutgoingBitrate"]       = 0;
+	jsonObject["rtpPacketLossReceived"]    = 0.0123;
+	jsonObject["rtpPacketLossSent"]        = 0.0456;
+	jsonObject["iceRole"]                  = "controlled";
+	jsonObject["iceState"]                 = "completed";
+	jsonObject["dtlsState"]                = "connected";
+
+	auto& jsonTuple = jsonObject["iceSelectedTuple"];
+
+	jsonTuple["localIp"]    = "10.0.0.1";
+	jsonTuple["localPort"]  = 40000;
+	jsonTuple["remoteIp"]   = "192.168.1.33";
+	jsonTuple["remotePort"] = 54321;
+	jsonTuple["protocol"]   = "udp";
+
+	return jsonArray;
+}
+#endif
+
+static ChannelReadFreeFn channelRead(
+  uint8_t** /*message*/,
+  uint32_t* /*messageLen*/,
+  size_t* /*messageCtx*/,
+  const void* /*handle*/,
+  ChannelReadCtx /*ctx*/)
+{
+	return nullptr;
+}
+
+static void channelWrite(const uint8_t* message, uint32_t messageLen, ChannelWriteCtx ctx)
+{
+	auto* messages = static_cast<std::vector<std::string>*>(ctx);
+
+	messages->emplace_back(reinterpret_cast<const char*>(message), messageLen);
+}
+
+SCENARIO("ChannelRequest", "[channel][request]")
+{
+	SECTION("IsMsgpackMap()")
+	{
+		auto msgpack = json::to_msgpack(json{ { "foo", 1 } });
+
+		REQUIRE(
+		  Channel::ChannelRequest::IsMsgpackMap(
+		    reinterpret_cast<const char*>(msgpack.data()), msgpack.size()) == true);
+		REQUIRE(Channel::ChannelRequest::IsMsgpackMap("{\"foo\":1}", 9) == false);
+		REQUIRE(Channel::ChannelRequest::IsMsgpackMap("", 0) == false);
+	}
+
+	SECTION("request with JSON data")
+	{
+		std::string msg{ "1:transport.setMaxIncomingBitrate:abcd:{\"bitrate\":1000}" };
+
+		Channel::ChannelRequest request(nullptr, msg.c_str(), msg.size());
+
+		REQUIRE(request.id == 1);
+		REQUIRE(
+		  request.methodId == Channel::ChannelRequest::MethodId::TRANSPORT_SET_MAX_INCOMING_BITRATE);
+		REQUIRE(request.handlerId == "abcd");
+		REQUIRE(request.data["bitrate"].get<uint32_t>() == 1000);
+	}
+
+	SECTION("request with MessagePack data")
+	{
+		json data = { { "bitrate", 1000 }, { "label", "a:b:c" } };
+		auto msgpack = json::to_msgpack(data);
+		std::string msg{ "2:transport.setMaxIncomingBitrate:abcd:" };
+
+		msg.append(msgpack.begin(), msgpack.end());
+
+		Channel::ChannelRequest request(nullptr, msg.c_str(), msg.size());
+
+		REQUIRE(request.id == 2);
+		REQUIRE(request.handlerId == "abcd");
+		REQUIRE(request.data["bitrate"].is_number_unsigned());
+		REQUIRE(request.data["bitrate"].get<uint32_t>() == 1000);
+		REQUIRE(request.data["label"].get<std::string>() == "a:b:c");
+	}
+
+	SECTION("request without data")
+	{
+		std::string msg{ "3:worker.dump:undefined:undefined" };
+
+		Channel::ChannelRequest request(nullptr, msg.c_str(), msg.size());
+
+		REQUIRE(request.methodId == Channel::ChannelRequest::MethodId::WORKER_DUMP);
+		REQUIRE(request.handlerId.empty());
+		REQUIRE(request.data.is_null());
+	}
+
+	SECTION("responses are encoded in the channel format")
+	{
+		std::vector<std::string> messages;
+		Channel::ChannelSocket channel(channelRead, nullptr, channelWrite, &messages);
+		std::string msg{ "4:router.getConsumersStats:abcd:undefined" };
+		json data = { { "foo", 1 } };
+
+		Channel::ChannelRequest request1(&channel, msg.c_str(), msg.size());
+		Channel::ChannelRequest request2(&channel, msg.c_str(), msg.size());
+
+		request1.Accept();
+		request2.Accept(data.dump());
+
+		REQUIRE(messages.size() == 2);
+		REQUIRE(json::parse(messages[0]) == json({ { "id", 4 }, { "accepted", true } }));
+		REQUIRE(
+		  json::parse(messages[1]) == json({ { "id", 4 }, { "accepted", true }, { "data", data } }));
+
+		Settings::configuration.channelFormat = Settings::ChannelFormat::MSGPACK;
+
+		auto msgpack = json::to_msgpack(data);
+		Channel::ChannelRequest request3(&channel, msg.c_str(), msg.size());
+		Channel::ChannelRequest request4(&channel, msg.c_str(), msg.size());
+
+		request3.Accept();
+		request4.Accept(std::string(msgpack.begin(), msgpack.end()));
+
+		Settings::configuration.channelFormat = Settings::ChannelFormat::JSON;
+
+		REQUIRE(messages.size() == 4);
+		REQUIRE(json::from_msgpack(messages[2]) == json({ { "id", 4 }, { "accepted", true } }));
+		REQUIRE(
+		  json::from_msgpack(messages[3]) ==
+		  json({ { "id", 4 }, { "accepted", true }, { "data", data } }));
+
+		channel.Close();
+
+		// Run the close callback of the channel.
+		uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+	}
+
+#ifdef PERFORMANCE_TEST
+	SECTION("Performance")
+	{
+		std::vector<std::pair<std::string, json>> payloads = {
+			{ "WORKER_DUMP", createWorkerDump() }, { "TRANSPORT_GET_STATS", createTransportStats() }
+		};
+		size_t iterations = 10000;
+
+		for (auto& kv : payloads)
+		{
+			auto& name        = kv.first;
+			auto& jsonMessage = kv.second;
+			std::string text;
+			std::vector<uint8_t> msgpack;
+
+			auto start = std::chrono::system_clock::now();
+
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				text = jsonMessage.dump();
+			}
+
+			std::chrono::duration<double> dumpDur = std::chrono::system_clock::now() - start;
+
+			start = std::chrono::system_clock::now();
+
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				msgpack.clear();
+				json::to_msgpack(jsonMessage, msgpack);
+			}
+
+			std::chrono::duration<double> msgpackDur = std::chrono::system_clock::now() - start;
+
+			start = std::chrono::system_clock::now();
+
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				auto parsed = json::parse(text);
+			}
+
+			std::chrono::duration<double> parseDur = std::chrono::system_clock::now() - start;
+
+			start = std::chrono::system_clock::now();
+
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				auto parsed = json::from_msgpack(msgpack);
+			}
+
+			std::chrono::duration<double> fromMsgpackDur = std::chrono::system_clock::now() - start;
+
+			REQUIRE(json::from_msgpack(msgpack) == json::parse(text));
+
+			std::cout << name << " (" << iterations << " iterations):" << std::endl
+			          << "  JSON: " << text.size() << " bytes, encoded in " << dumpDur.count()
+			          << " seconds, decoded in " << parseDur.count() << " seconds" << std::endl
+			          << "  MessagePack: " << msgpack.size() << " bytes, encoded in "
+			          << msgpackDur.count() << " seconds, decoded in " << fromMsgpackDur.count()
+			          << " seconds" << std::endl;
+		}
+	}
+#endif
+}
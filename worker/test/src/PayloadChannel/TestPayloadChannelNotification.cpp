@@ -1,4 +1,5 @@
 #include "common.hpp"
+#include "MediaSoupErrors.hpp"
 #include "PayloadChannel/PayloadChannelNotification.hpp"
 #include <catch2/catch.hpp>
 
@@ -31,4 +32,47 @@ SCENARIO("PayloadChannelNotification", "[channel][notification]")
 
 		REQUIRE(PayloadChannel::PayloadChannelNotification::IsNotification(foo, sizeof(foo)) == false);
 	}
+
+	SECTION("Fill() from a binary frame")
+	{
+		PayloadChannel::PayloadChannelNotification notification;
+		uint8_t payload[]{ 1, 2, 3 };
+
+		notification.Fill(3u, "abcd", 4u, 51u, payload, sizeof(payload));
+
+		REQUIRE(notification.event == "dataProducer.send");
+		REQUIRE(
+		  notification.eventId ==
+		  PayloadChannel::PayloadChannelNotification::EventId::DATA_PRODUCER_SEND);
+		REQUIRE(notification.handlerId == "abcd");
+		REQUIRE(notification.ppid == 51u);
+		REQUIRE(notification.data.empty());
+		REQUIRE(notification.payload == payload);
+		REQUIRE(notification.payloadLen == sizeof(payload));
+
+		notification.Fill(2u, "efgh", 4u, 0u, payload, 1u);
+
+		REQUIRE(notification.event == "producer.send");
+		REQUIRE(notification.handlerId == "efgh");
+		REQUIRE(notification.data.empty());
+		REQUIRE(notification.payloadLen == 1u);
+
+		REQUIRE_THROWS(notification.Fill(0u, "abcd", 4u, 0u, payload, 1u));
+	}
+
+	SECTION("PPID is parsed from a text notification")
+	{
+		char msg[]{ "dataProducer.send:abcd:51" };
+
+		PayloadChannel::PayloadChannelNotification notification(msg, sizeof(msg) - 1);
+
+		REQUIRE(notification.handlerId == "abcd");
+		REQUIRE(notification.ppid == 51u);
+
+		char wrongMsg[]{ "dataProducer.send:abcd:foo" };
+
+		REQUIRE_THROWS_AS(
+		  PayloadChannel::PayloadChannelNotification(wrongMsg, sizeof(wrongMsg) - 1),
+		  MediaSoupTypeError);
+	}
 }
@@ -0,0 +1,145 @@
+#include "common.hpp"
+#include "PayloadChannel/PayloadChannelRing.hpp"
+#include <catch2/catch.hpp>
+#include <cstring> // std::memcmp(), std::memcpy()
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace PayloadChannel;
+
+SCENARIO("PayloadChannelRing", "[channel][ring]")
+{
+	std::string handlerId{ "9bfc4f38-6b28-4b4b-9d3c-e9a2b41e9b4e" };
+	std::vector<uint8_t> payload(1000u);
+
+	for (size_t i{ 0u }; i < payload.size(); ++i)
+	{
+		payload[i] = static_cast<uint8_t>(i);
+	}
+
+	SECTION("pushed frames are read in order")
+	{
+		PayloadChannelRing ring(4096u);
+		PayloadChannelRing::Frame frame;
+
+		REQUIRE(ring.Front(frame) == false);
+
+		REQUIRE(ring.Push(2u, handlerId.c_str(), handlerId.size(), 0u, payload.data(), 100u));
+		REQUIRE(ring.Push(3u, handlerId.c_str(), handlerId.size(), 51u, payload.data(), 200u));
+
+		REQUIRE(ring.Front(frame));
+		REQUIRE(frame.eventId == 2u);
+		REQUIRE(std::string(frame.handlerId, frame.handlerIdLen) == handlerId);
+		REQUIRE(frame.ppid == 0u);
+		REQUIRE(frame.payloadLen == 100u);
+		REQUIRE(std::memcmp(frame.payload, payload.data(), 100u) == 0);
+
+		ring.Pop();
+
+		REQUIRE(ring.Front(frame));
+		REQUIRE(frame.eventId == 3u);
+		REQUIRE(frame.ppid == 51u);
+		REQUIRE(frame.payloadLen == 200u);
+		REQUIRE(std::memcmp(frame.payload, payload.data(), 200u) == 0);
+
+		ring.Pop();
+
+		REQUIRE(ring.Front(frame) == false);
+	}
+
+	SECTION("Push() fails if the ring is full or the frame is too big")
+	{
+		PayloadChannelRing ring(4096u);
+		size_t pushed{ 0u };
+
+		REQUIRE(ring.Push(2u, handlerId.c_str(), handlerId.size(), 0u, payload.data(), 4000u) == false);
+		REQUIRE(ring.Push(0u, handlerId.c_str(), handlerId.size(), 0u, payload.data(), 10u) == false);
+
+		while (ring.Push(2u, handlerId.c_str(), handlerId.size(), 0u, payload.data(), 1000u))
+		{
+			++pushed;
+		}
+
+		REQUIRE(pushed == 3u);
+
+		PayloadChannelRing::Frame frame;
+
+		REQUIRE(ring.Front(frame));
+
+		ring.Pop();
+
+		REQUIRE(ring.Push(2u, handlerId.c_str(), handlerId.size(), 0u, payload.data(), 1000u));
+	}
+
+	SECTION("frames not fitting at the end of the buffer are written at the start")
+	{
+		PayloadChannelRing ring(4096u);
+		PayloadChannelRing::Frame frame;
+
+		for (size_t i{ 0u }; i < 100u; ++i)
+		{
+			auto payloadLen = static_cast<size_t>(300u + i * 7u);
+
+			REQUIRE(ring.Push(
+			  2u, handlerId.c_str(), handlerId.size(), static_cast<uint32_t>(i), payload.data(), payloadLen));
+			REQUIRE(ring.Front(frame));
+			REQUIRE(frame.ppid == i);
+			REQUIRE(frame.payloadLen == payloadLen);
+			REQUIRE(std::memcmp(frame.payload, payload.data(), payloadLen) == 0);
+
+			ring.Pop();
+		}
+
+		REQUIRE(ring.Front(frame) == false);
+	}
+
+	SECTION("frames are passed from a producer thread to a consumer thread")
+	{
+		PayloadChannelRing ring(8192u);
+		uint32_t count{ 100000u };
+		uint32_t errors{ 0u };
+
+		std::thread producer(
+		  [&]()
+		  {
+			  uint8_t data[64];
+
+			  for (uint32_t i{ 0u }; i < count; ++i)
+			  {
+				  auto len = static_cast<size_t>(4u + i % 60u);
+
+				  std::memcpy(data, &i, sizeof(i));
+
+				  while (!ring.Push(2u, handlerId.c_str(), handlerId.size(), i, data, len))
+				  {
+					  std::this_thread::yield();
+				  }
+			  }
+		  });
+
+		PayloadChannelRing::Frame frame;
+
+		for (uint32_t i{ 0u }; i < count; ++i)
+		{
+			while (!ring.Front(frame))
+			{
+				std::this_thread::yield();
+			}
+
+			uint32_t value;
+
+			std::memcpy(&value, frame.payload, sizeof(value));
+
+			if (frame.ppid != i || value != i || frame.payloadLen != 4u + i % 60u)
+				++errors;
+
+			ring.Pop();
+		}
+
+		producer.join();
+
+		REQUIRE(errors == 0u);
+		REQUIRE(ring.Front(frame) == false);
+	}
+}
@@ -261,6 +261,17 @@ SCENARIO("RTCP Feeback RTP transport", "[parser][rtcp][feedback-rtp][transport]"
 				REQUIRE(packet2->GetPacketStatusCount() == 18);
 				REQUIRE(packet2->GetFeedbackPacketCount() == 1);
 				REQUIRE(packet2->GetPacketFractionLost() > 0);
+				REQUIRE(packet2->GetReceivedPacketCount() == 6);
+
+				// Previous content of the given vector is replaced.
+				std::vector<struct FeedbackRtpTransportPacket::PacketResult> packetResults(
+				  20, FeedbackRtpTransportPacket::PacketResult(0, false));
+
+				packet2->GetPacketResults(packetResults);
+
+				REQUIRE(packetResults.size() == 18);
+
+				validate(inputs, packetResults);
 
 				uint8_t buffer2[1024];
 				auto len2 = packet2->Serialize(buffer2);
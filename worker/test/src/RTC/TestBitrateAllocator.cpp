@@ -0,0 +1,327 @@
+#include "common.hpp"
+#include "RTC/BitrateAllocator.hpp"
+#include <catch2/catch.hpp>
+#include <map>
+#include <memory> // std::unique_ptr
+#include <random>
+#include <vector>
+
+using namespace RTC;
+
+// Participant with a fixed ladder of layers, each one requiring the given
+// bitrate on top of the previous one.
+class FakeParticipant : public BitrateAllocator::Participant
+{
+public:
+	FakeParticipant(uint8_t priority, std::vector<uint32_t> ladder)
+	  : priority(priority), ladder(std::move(ladder))
+	{
+	}
+
+public:
+	uint8_t GetBitratePriority() const override
+	{
+		return this->priority;
+	}
+	uint32_t IncreaseLayer(uint32_t bitrate, bool considerLoss) override
+	{
+		auto nextLayer = this->provisionalLayer + 1;
+
+		if (nextLayer >= static_cast<int16_t>(this->ladder.size()))
+			return 0u;
+
+		auto requiredBitrate = this->ladder[nextLayer];
+		auto virtualBitrate  = considerLoss ? bitrate / 10u * 9u : bitrate;
+
+		if (requiredBitrate > virtualBitrate)
+			return 0u;
+
+		this->provisionalLayer = nextLayer;
+
+		return requiredBitrate;
+	}
+	void ApplyLayers() override
+	{
+		this->layer            = this->provisionalLayer;
+		this->provisionalLayer = -1;
+	}
+
+public:
+	uint8_t priority{ 0u };
+	std::vector<uint32_t> ladder;
+	int16_t provisionalLayer{ -1 };
+	int16_t layer{ -1 };
+};
+
+// Distribution as done by Transport::DistributeAvailableOutgoingBitrate()
+// before BitrateAllocator existed. Participants with the same priority are
+// given bitrate in the order of the given vector.
+static uint32_t distributeWithMultimap(
+  const std::vector<FakeParticipant*>& participants, uint32_t availableBitrate, bool considerLoss)
+{
+	std::multimap<uint8_t, FakeParticipant*> multimapPriorityParticipant;
+
+	// Equal keys are iterated backwards below, so insert them backwards too.
+	for (auto it = participants.rbegin(); it != participants.rend(); ++it)
+	{
+		auto* participant = *it;
+		auto priority     = participant->GetBitratePriority();
+
+		if (priority > 0u)
+			multimapPriorityParticipant.emplace(priority, participant);
+	}
+
+	if (multimapPriorityParticipant.empty())
+		return availableBitrate;
+
+	bool baseAllocation{ true };
+
+	while (availableBitrate > 0u)
+	{
+		auto previousAvailableBitrate = availableBitrate;
+
+		for (auto it = multimapPriorityParticipant.rbegin(); it != multimapPriorityParticipant.rend();
+		     ++it)
+		{
+			auto priority     = it->first;
+			auto* participant = it->second;
+
+			for (uint8_t i{ 1u }; i <= (baseAllocation ? 1u : priority); ++i)
+			{
+				auto usedBitrate = participant->IncreaseLayer(availableBitrate, considerLoss);
+
+				availableBitrate -= usedBitrate;
+
+				if (usedBitrate == 0u)
+					break;
+			}
+		}
+
+		if (availableBitrate == previousAvailableBitrate)
+			break;
+
+		baseAllocation = false;
+	}
+
+	for (auto it = multimapPriorityParticipant.rbegin(); it != multimapPriorityParticipant.rend();
+	     ++it)
+	{
+		it->second->ApplyLayers();
+	}
+
+	return availableBitrate;
+}
+
+static uint32_t distribute(BitrateAllocator& allocator, uint32_t availableBitrate, bool considerLoss)
+{
+	allocator.UpdatePriorities();
+
+	if (!allocator.HasPrioritizedParticipants())
+		return availableBitrate;
+
+	return allocator.Distribute(availableBitrate, considerLoss);
+}
+
+SCENARIO("BitrateAllocator", "[bitrate-allocator]")
+{
+	// clang-format off
+	std::vector<uint32_t> ladder = { 100000u, 50000u, 50000u, 300000u, 100000u };
+	// clang-format on
+
+	SECTION("participants without priority are ignored")
+	{
+		BitrateAllocator allocator;
+		FakeParticipant participant1(0u, ladder);
+		FakeParticipant participant2(0u, ladder);
+
+		allocator.AddParticipant(std::addressof(participant1));
+		allocator.AddParticipant(std::addressof(participant2));
+		allocator.UpdatePriorities();
+
+		REQUIRE(allocator.GetSize() == 2);
+		REQUIRE(!allocator.HasPrioritizedParticipants());
+
+		participant2.priority = 1u;
+
+		REQUIRE(distribute(allocator, 1000000u, false) == 400000u);
+		REQUIRE(participant1.layer == -1);
+		REQUIRE(participant2.layer == 4);
+	}
+
+	SECTION("higher priority participants get more layers")
+	{
+		BitrateAllocator allocator;
+		FakeParticipant participant1(1u, ladder);
+		FakeParticipant participant2(2u, ladder);
+
+		allocator.AddParticipant(std::addressof(participant1));
+		allocator.AddParticipant(std::addressof(participant2));
+
+		// Base allocation: 100000 each. Then participant2 takes 50000 twice and
+		// participant1 50000 once.
+		REQUIRE(distribute(allocator, 370000u, false) == 20000u);
+		REQUIRE(participant1.layer == 1);
+		REQUIRE(participant2.layer == 2);
+
+		// Same result in the next distribution.
+		REQUIRE(distribute(allocator, 370000u, false) == 20000u);
+		REQUIRE(participant1.layer == 1);
+		REQUIRE(participant2.layer == 2);
+
+		participant1.priority = 3u;
+
+		REQUIRE(distribute(allocator, 370000u, false) == 20000u);
+		REQUIRE(participant1.layer == 2);
+		REQUIRE(participant2.layer == 1);
+	}
+
+	SECTION("participants with same priority get bitrate in the order they were added")
+	{
+		BitrateAllocator allocator;
+		FakeParticipant participant1(1u, ladder);
+		FakeParticipant participant2(1u, ladder);
+		FakeParticipant participant3(1u, ladder);
+
+		allocator.AddParticipant(std::addressof(participant1));
+		allocator.AddParticipant(std::addressof(participant2));
+		allocator.AddParticipant(std::addressof(participant3));
+
+		REQUIRE(distribute(allocator, 210000u, false) == 10000u);
+		REQUIRE(participant1.layer == 0);
+		REQUIRE(participant2.layer == 0);
+		REQUIRE(participant3.layer == -1);
+
+		// Moving to another bucket and back keeps the order.
+		participant1.priority = 2u;
+		distribute(allocator, 210000u, false);
+		participant1.priority = 1u;
+
+		REQUIRE(distribute(allocator, 210000u, false) == 10000u);
+		REQUIRE(participant1.layer == 0);
+		REQUIRE(participant2.layer == 0);
+		REQUIRE(participant3.layer == -1);
+
+		allocator.RemoveParticipant(std::addressof(participant1));
+
+		REQUIRE(allocator.GetSize() == 2);
+		REQUIRE(distribute(allocator, 210000u, false) == 10000u);
+		REQUIRE(participant2.layer == 0);
+		REQUIRE(participant3.layer == 0);
+
+		allocator.Clear();
+
+		REQUIRE(allocator.GetSize() == 0);
+		REQUIRE(!allocator.HasPrioritizedParticipants());
+	}
+
+	SECTION("replayed distributions match the multimap based distribution")
+	{
+		std::mt19937 random(1234u);
+		auto randomInt = [&random](uint32_t min, uint32_t max)
+		{
+			return std::uniform_int_distribution<uint32_t>(min, max)(random);
+		};
+		auto randomLadder = [&randomInt]()
+		{
+			std::vector<uint32_t> ladder(randomInt(1u, 6u));
+
+			for (auto& bitrate : ladder)
+			{
+				bitrate = randomInt(1u, 400u) * 1000u;
+			}
+
+			return ladder;
+		};
+
+		BitrateAllocator allocator;
+		// Each participant given to the allocator has a twin given to the
+		// multimap based distribution.
+		std::vector<std::unique_ptr<FakeParticipant>> participants;
+		std::vector<std::unique_ptr<FakeParticipant>> twins;
+
+		auto addParticipant = [&]()
+		{
+			auto priority = static_cast<uint8_t>(randomInt(0u, 4u));
+			auto ladder   = randomLadder();
+
+			participants.emplace_back(new FakeParticipant(priority, ladder));
+			twins.emplace_back(new FakeParticipant(priority, ladder));
+			allocator.AddParticipant(participants.back().get());
+		};
+
+		for (size_t i{ 0u }; i < 50u; ++i)
+		{
+			addParticipant();
+		}
+
+		for (size_t round{ 0u }; round < 2000u; ++round)
+		{
+			// Change some participants before distributing.
+			for (auto numChanges = randomInt(0u, 3u); numChanges > 0u; --numChanges)
+			{
+				auto idx = randomInt(0u, static_cast<uint32_t>(participants.size()) - 1u);
+
+				switch (randomInt(0u, 3u))
+				{
+					case 0:
+					{
+						auto priority = static_cast<uint8_t>(randomInt(0u, 4u));
+
+						participants[idx]->priority = priority;
+						twins[idx]->priority        = priority;
+
+						break;
+					}
+
+					case 1:
+					{
+						auto ladder = randomLadder();
+
+						participants[idx]->ladder = ladder;
+						twins[idx]->ladder        = ladder;
+
+						break;
+					}
+
+					case 2:
+					{
+						allocator.RemoveParticipant(participants[idx].get());
+						participants.erase(participants.begin() + idx);
+						twins.erase(twins.begin() + idx);
+
+						if (participants.empty())
+							addParticipant();
+
+						break;
+					}
+
+					case 3:
+					{
+						addParticipant();
+
+						break;
+					}
+				}
+			}
+
+			std::vector<FakeParticipant*> orderedTwins;
+
+			for (auto& twin : twins)
+			{
+				orderedTwins.push_back(twin.get());
+			}
+
+			auto availableBitrate = randomInt(0u, 5000u) * 1000u;
+			auto considerLoss     = randomInt(0u, 1u) == 1u;
+
+			REQUIRE(
+			  distribute(allocator, availableBitrate, considerLoss) ==
+			  distributeWithMultimap(orderedTwins, availableBitrate, considerLoss));
+
+			for (size_t idx{ 0u }; idx < participants.size(); ++idx)
+			{
+				REQUIRE(participants[idx]->layer == twins[idx]->layer);
+			}
+		}
+	}
+}
@@ -282,6 +282,21 @@ SCENARIO("NACK generator", "[rtp][rtcp]")
 		validate(inputs);
 	}
 
+	SECTION("Key Frame removes older packets from a too large Nack list after sequence wrap")
+	{
+		// clang-format off
+		std::vector<TestNackGeneratorInput> inputs =
+		{
+			{ 65300, false,     0,   0, false,   0 },
+			{   363, false, 65301, 598, false, 598 },
+			{   364,  true,     0,   0, false, 598 },
+			{   963, false,   365, 598, false, 598 }
+		};
+		// clang-format on
+
+		validate(inputs);
+	}
+
 	// Must run the loop to wait for UV timers and close them.
 	DepLibUV::RunLoop();
 }
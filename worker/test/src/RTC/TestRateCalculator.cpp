@@ -141,3 +141,57 @@ SCENARIO("Bitrate calculator", "[rtp][bitrate]")
 		validate(rate, nowMs, input);
 	}
 }
+
+SCENARIO("Layers bitrate calculator", "[rtp][bitrate]")
+{
+	uint64_t nowMs = DepLibUV::GetTimeMs();
+
+	SECTION("single layer behaves as RateCalculator")
+	{
+		// window: 1000ms, items: 5 (granularity: 200ms)
+		RateCalculator rate(1000, 8000, 5);
+		LayersRateCalculator layersRate(1, 1000, 8000, 5);
+
+		for (uint64_t offset{ 1000u }; offset <= 4000u; offset += 100u)
+		{
+			rate.Update(offset % 7, nowMs + offset);
+			layersRate.Update(0, offset % 7, nowMs + offset);
+
+			REQUIRE(layersRate.GetRate(nowMs + offset, 0) == rate.GetRate(nowMs + offset));
+		}
+
+		REQUIRE(layersRate.GetRate(nowMs + 5001, 0) == 0);
+	}
+
+	SECTION("multiple layers")
+	{
+		LayersRateCalculator rate(3, 1000, 8000, 100);
+
+		rate.Update(0, 5, nowMs);
+		rate.Update(1, 2, nowMs);
+		rate.Update(2, 1, nowMs + 500);
+		rate.Update(0, 3, nowMs + 500);
+
+		REQUIRE(rate.GetRate(nowMs + 500, 0) == 64);
+		REQUIRE(rate.GetRate(nowMs + 500, 1) == 16);
+		REQUIRE(rate.GetRate(nowMs + 500, 2) == 8);
+		REQUIRE(rate.GetRate(nowMs + 500, 0, 2) == 80);
+		REQUIRE(rate.GetRate(nowMs + 500, 1, 3) == 24);
+		REQUIRE(rate.GetRate(nowMs + 500, 0, 3) == 88);
+		REQUIRE(rate.GetRate(nowMs + 500, 1, 1) == 0);
+
+		// Data received at nowMs slides out of the window in all layers at once.
+		REQUIRE(rate.GetRate(nowMs + 1000, 0) == 24);
+		REQUIRE(rate.GetRate(nowMs + 1000, 1) == 0);
+		REQUIRE(rate.GetRate(nowMs + 1000, 2) == 8);
+		REQUIRE(rate.GetRate(nowMs + 1000, 0, 3) == 32);
+
+		REQUIRE(rate.GetRate(nowMs + 1500, 0, 3) == 0);
+
+		rate.Update(1, 4, nowMs + 1600);
+
+		REQUIRE(rate.GetRate(nowMs + 1600, 0) == 0);
+		REQUIRE(rate.GetRate(nowMs + 1600, 1) == 32);
+		REQUIRE(rate.GetRate(nowMs + 1600, 0, 3) == 32);
+	}
+}
@@ -0,0 +1,197 @@
+#include "common.hpp"
+#include "ChannelMessageHandlers.hpp"
+#include "DepLibUV.hpp"
+#include "Settings.hpp"
+#include "Channel/ChannelNotifier.hpp"
+#include "Channel/ChannelRequest.hpp"
+#include "Channel/ChannelSocket.hpp"
+#include "RTC/Router.hpp"
+#include <catch2/catch.hpp>
+#include <string>
+#include <vector>
+
+using namespace RTC;
+
+static ChannelReadFreeFn channelRead(
+  uint8_t** /*message*/,
+  uint32_t* /*messageLen*/,
+  size_t* /*messageCtx*/,
+  const void* /*handle*/,
+  ChannelReadCtx /*ctx*/)
+{
+	return nullptr;
+}
+
+static void channelWrite(const uint8_t* message, uint32_t messageLen, ChannelWriteCtx ctx)
+{
+	auto* messages = static_cast<std::vector<std::string>*>(ctx);
+
+	messages->emplace_back(reinterpret_cast<const char*>(message), messageLen);
+}
+
+SCENARIO("Router", "[router]")
+{
+	class TestRouterListener : public Router::Listener
+	{
+	public:
+		WebRtcServer* OnRouterNeedWebRtcServer(Router* /*router*/, std::string& /*webRtcServerId*/) override
+		{
+			return nullptr;
+		}
+	};
+
+	std::vector<std::string> messages;
+	Channel::ChannelSocket channel(channelRead, nullptr, channelWrite, &messages);
+	TestRouterListener listener;
+	json routerData = json::object();
+
+	Channel::ChannelNotifier::ClassInit(&channel);
+
+	auto* router = new Router("router1", &listener, routerData);
+
+	// Handles the request as the ChannelSocket does.
+	auto handleRequest = [&channel](const std::string& method, const std::string& handlerId, json data)
+	{
+		std::string message = "1:" + method + ":" + handlerId + ":" + data.dump();
+		auto* request       = new Channel::ChannelRequest(&channel, message.data(), message.size());
+		auto* handler       = ChannelMessageHandlers::GetChannelRequestHandler(handlerId);
+
+		REQUIRE(handler);
+
+		handler->HandleRequest(request);
+
+		if (!request->deferred)
+			delete request;
+	};
+
+	handleRequest("router.createDirectTransport", "router1", { { "transportId", "transport1" } });
+
+	// clang-format off
+	handleRequest("transport.produce", "transport1", {
+		{ "producerId", "producer1" },
+		{ "kind", "audio" },
+		{ "paused", false },
+		{
+			"rtpParameters",
+			{
+				{ "codecs", { { { "mimeType", "audio/opus" }, { "payloadType", 100 }, { "clockRate", 48000 }, { "channels", 2 } } } },
+				{ "headerExtensions", json::array() },
+				{ "encodings", { { { "ssrc", 1111 } } } },
+				{ "rtcp", { { "cname", "foo" } } }
+			}
+		},
+		{
+			"rtpMapping",
+			{
+				{ "codecs", { { { "payloadType", 100 }, { "mappedPayloadType", 100 } } } },
+				{ "encodings", { { { "ssrc", 1111 }, { "mappedSsrc", 2222 } } } }
+			}
+		}
+	});
+	// clang-format on
+
+	std::vector<std::string> consumerIds{ "consumer1", "consumer2", "consumer3" };
+
+	for (size_t i{ 0u }; i < consumerIds.size(); ++i)
+	{
+		// clang-format off
+		handleRequest("transport.consume", "transport1", {
+			{ "consumerId", consumerIds[i] },
+			{ "producerId", "producer1" },
+			{ "kind", "audio" },
+			{ "type", "simple" },
+			{ "paused", false },
+			{
+				"rtpParameters",
+				{
+					{ "codecs", { { { "mimeType", "audio/opus" }, { "payloadType", 100 }, { "clockRate", 48000 }, { "channels", 2 } } } },
+					{ "headerExtensions", json::array() },
+					{ "encodings", { { { "ssrc", 3000 + i } } } },
+					{ "rtcp", { { "cname", "foo" } } }
+				}
+			},
+			{ "consumableRtpEncodings", { { { "ssrc", 2222 } } } }
+		});
+		// clang-format on
+	}
+
+	// Responses of the requests above.
+	REQUIRE(messages.size() == 5);
+
+	for (auto& message : messages)
+	{
+		REQUIRE(json::parse(message)["accepted"] == true);
+	}
+
+	messages.clear();
+
+	SECTION("router.getConsumersStats is replied in the next loop iteration")
+	{
+		handleRequest("router.getConsumersStats", "router1", json::object());
+
+		REQUIRE(messages.empty());
+
+		// Closed meanwhile, so it's skipped.
+		handleRequest("transport.closeConsumer", "transport1", { { "consumerId", "consumer2" } });
+
+		REQUIRE(messages.size() == 1);
+
+		messages.clear();
+
+		uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+
+		REQUIRE(messages.size() == 1);
+
+		auto response = json::parse(messages[0]);
+
+		REQUIRE(response["id"] == 1);
+		REQUIRE(response["accepted"] == true);
+		REQUIRE(response["data"].size() == 2);
+		REQUIRE(response["data"]["consumer1"].is_array());
+		REQUIRE(response["data"]["consumer1"][0]["type"] == "outbound-rtp");
+		REQUIRE(response["data"]["consumer3"].is_array());
+		REQUIRE(response["data"].find("consumer2") == response["data"].end());
+	}
+
+	SECTION("router.getConsumersStats is encoded in the channel format")
+	{
+		Settings::configuration.channelFormat = Settings::ChannelFormat::MSGPACK;
+
+		handleRequest("router.getConsumersStats", "router1", json::object());
+
+		uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+
+		Settings::configuration.channelFormat = Settings::ChannelFormat::JSON;
+
+		REQUIRE(messages.size() == 1);
+
+		auto response = json::from_msgpack(messages[0]);
+
+		REQUIRE(response["accepted"] == true);
+		REQUIRE(response["data"].size() == 3);
+
+		for (auto& consumerId : consumerIds)
+		{
+			REQUIRE(response["data"][consumerId][0]["type"] == "outbound-rtp");
+		}
+	}
+
+	SECTION("pending router.getConsumersStats requests are rejected when the Router is closed")
+	{
+		handleRequest("router.getConsumersStats", "router1", json::object());
+
+		delete router;
+		router = nullptr;
+
+		REQUIRE(messages.size() == 1);
+		REQUIRE(json::parse(messages[0])["error"] == "Error");
+	}
+
+	delete router;
+
+	Channel::ChannelNotifier::ClassInit(nullptr);
+	channel.Close();
+
+	// Run the close callbacks of the channel and the timers.
+	uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+}
@@ -0,0 +1,384 @@
+#include "common.hpp"
+#include "DepLibUV.hpp"
+#include "Channel/ChannelNotifier.hpp"
+#include "Channel/ChannelSocket.hpp"
+#include "RTC/Codecs/VP8.hpp"
+#include "RTC/RtpPacingQueue.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "RTC/RtpStreamRecv.hpp"
+#include "RTC/SimulcastConsumer.hpp"
+#include <catch2/catch.hpp>
+#include <cstring> // std::memcpy()
+#include <string>
+#include <vector>
+
+using namespace RTC;
+
+using Priority   = RtpPacingQueue::Priority;
+using DropPolicy = RtpPacingQueue::DropPolicy;
+
+SCENARIO("RtpPacingQueue", "[rtp][pacing]")
+{
+	// clang-format off
+	uint8_t buffer[] =
+	{
+		0b10000000, 0b01111011, 0b01010010, 0b00001110,
+		0b01011011, 0b01101011, 0b11001010, 0b10110101,
+		0, 0, 0, 2
+	};
+	// clang-format on
+
+	uint8_t packetBuffer[1500];
+
+	std::memcpy(packetBuffer, buffer, sizeof(buffer));
+
+	auto* packet = RtpPacket::Parse(packetBuffer, sizeof(buffer));
+
+	REQUIRE(packet);
+
+	// Consumers are just used as tags by the queue.
+	auto* consumer1 = reinterpret_cast<Consumer*>(0x1);
+	auto* consumer2 = reinterpret_cast<Consumer*>(0x2);
+	bool expired{ false };
+
+	SECTION("packets are dequeued by priority and in order")
+	{
+		RtpPacingQueue queue;
+
+		packet->SetSequenceNumber(1);
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::VIDEO_UPPER_LAYER, false, 10000u));
+		packet->SetSequenceNumber(2);
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::VIDEO_BASE_LAYER, false, 10000u));
+		packet->SetSequenceNumber(3);
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::RETRANSMISSION, true, 10000u));
+		packet->SetSequenceNumber(4);
+		REQUIRE(queue.Enqueue(consumer2, packet, Priority::AUDIO, false, 10000u));
+		packet->SetSequenceNumber(5);
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::VIDEO_BASE_LAYER, false, 10000u));
+
+		REQUIRE(queue.GetSize() == 5);
+		REQUIRE(queue.GetBytes() == 5 * packet->GetSize());
+		REQUIRE(queue.GetSize(Priority::VIDEO_BASE_LAYER) == 2);
+
+		for (uint16_t seq : { 4, 3, 2, 5, 1 })
+		{
+			auto* item = queue.Front(10010u, expired);
+
+			REQUIRE(item);
+			REQUIRE(!expired);
+			REQUIRE(item->packet->GetSequenceNumber() == seq);
+			REQUIRE(item->consumer == (seq == 4 ? consumer2 : consumer1));
+			REQUIRE(item->retransmission == (seq == 3));
+
+			auto* queuedPacket = item->packet.get();
+
+			REQUIRE(queue.Pop().get() == queuedPacket);
+		}
+
+		REQUIRE(queue.IsEmpty());
+		REQUIRE(queue.GetBytes() == 0);
+		REQUIRE(queue.Front(10010u, expired) == nullptr);
+		REQUIRE(queue.GetDroppedPackets() == 0);
+	}
+
+	SECTION("queued packets are not affected by changes in the original packet")
+	{
+		RtpPacingQueue queue;
+
+		packet->SetSequenceNumber(1);
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::AUDIO, false, 10000u));
+		packet->SetSequenceNumber(2);
+
+		auto* item = queue.Front(10000u, expired);
+
+		REQUIRE(item);
+		REQUIRE(item->packet.get() != packet);
+		REQUIRE(item->packet->GetSequenceNumber() == 1);
+	}
+
+	SECTION("expired packets are dropped or sent depending on their drop policy")
+	{
+		RtpPacingQueue queue;
+		auto maxQueueTime = RtpPacingQueue::GetMaxQueueTime(Priority::VIDEO_BASE_LAYER);
+
+		REQUIRE(RtpPacingQueue::GetDropPolicy(Priority::VIDEO_BASE_LAYER) == DropPolicy::SEND);
+		REQUIRE(RtpPacingQueue::GetDropPolicy(Priority::VIDEO_UPPER_LAYER) == DropPolicy::DROP);
+		REQUIRE(RtpPacingQueue::GetMaxQueueTime(Priority::VIDEO_UPPER_LAYER) == maxQueueTime);
+
+		packet->SetSequenceNumber(1);
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::VIDEO_UPPER_LAYER, false, 10000u));
+		packet->SetSequenceNumber(2);
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::VIDEO_BASE_LAYER, false, 10000u));
+		packet->SetSequenceNumber(3);
+		REQUIRE(
+		  queue.Enqueue(consumer1, packet, Priority::RETRANSMISSION, true, 10000u + maxQueueTime));
+
+		// Nothing expired yet.
+		auto* item = queue.Front(10000u + maxQueueTime, expired);
+
+		REQUIRE(item);
+		REQUIRE(!expired);
+		REQUIRE(item->packet->GetSequenceNumber() == 3);
+
+		// The upper layer packet is dropped and the base layer one is returned
+		// before the retransmission with the expired flag.
+		item = queue.Front(10000u + maxQueueTime + 1, expired);
+
+		REQUIRE(item);
+		REQUIRE(expired);
+		REQUIRE(item->packet->GetSequenceNumber() == 2);
+		REQUIRE(queue.GetSize() == 2);
+		REQUIRE(queue.GetDroppedPackets() == 1);
+		REQUIRE(queue.GetDroppedPackets(Priority::VIDEO_UPPER_LAYER) == 1);
+
+		queue.Pop();
+
+		item = queue.Front(10000u + maxQueueTime + 1, expired);
+
+		REQUIRE(item);
+		REQUIRE(!expired);
+		REQUIRE(item->packet->GetSequenceNumber() == 3);
+	}
+
+	SECTION("a full queue makes room by dropping packets with lower priority")
+	{
+		RtpPacingQueue queue(2u);
+
+		packet->SetSequenceNumber(1);
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::VIDEO_UPPER_LAYER, false, 10000u));
+		packet->SetSequenceNumber(2);
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::VIDEO_BASE_LAYER, false, 10000u));
+		packet->SetSequenceNumber(3);
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::VIDEO_BASE_LAYER, false, 10000u));
+
+		REQUIRE(queue.GetSize() == 2);
+		REQUIRE(queue.GetSize(Priority::VIDEO_UPPER_LAYER) == 0);
+		REQUIRE(queue.GetDroppedPackets(Priority::VIDEO_UPPER_LAYER) == 1);
+
+		// No packet with lower priority, so the new one is dropped.
+		packet->SetSequenceNumber(4);
+		REQUIRE(!queue.Enqueue(consumer1, packet, Priority::VIDEO_BASE_LAYER, false, 10000u));
+		REQUIRE(!queue.Enqueue(consumer1, packet, Priority::VIDEO_UPPER_LAYER, false, 10000u));
+
+		REQUIRE(queue.GetSize() == 2);
+		REQUIRE(queue.GetDroppedPackets() == 3);
+
+		packet->SetSequenceNumber(5);
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::AUDIO, false, 10000u));
+
+		REQUIRE(queue.GetSize() == 2);
+		REQUIRE(queue.Front(10000u, expired)->packet->GetSequenceNumber() == 5);
+	}
+
+	SECTION("RemoveConsumer() removes all the packets of the given consumer")
+	{
+		RtpPacingQueue queue;
+
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::VIDEO_BASE_LAYER, false, 10000u));
+		REQUIRE(queue.Enqueue(consumer2, packet, Priority::VIDEO_BASE_LAYER, false, 10000u));
+		REQUIRE(queue.Enqueue(consumer1, packet, Priority::RETRANSMISSION, true, 10000u));
+		REQUIRE(queue.Enqueue(consumer2, packet, Priority::AUDIO, false, 10000u));
+
+		queue.RemoveConsumer(consumer1);
+
+		REQUIRE(queue.GetSize() == 2);
+		REQUIRE(queue.GetBytes() == 2 * packet->GetSize());
+		REQUIRE(queue.GetDroppedPackets() == 0);
+
+		auto* item = queue.Front(10000u, expired);
+
+		REQUIRE(item->consumer == consumer2);
+
+		queue.Pop();
+
+		item = queue.Front(10000u, expired);
+
+		REQUIRE(item->consumer == consumer2);
+
+		queue.Clear();
+
+		REQUIRE(queue.IsEmpty());
+		REQUIRE(queue.GetBytes() == 0);
+	}
+
+	RtpPacket::Deallocate(packet);
+}
+
+static ChannelReadFreeFn channelRead(
+  uint8_t** /*message*/,
+  uint32_t* /*messageLen*/,
+  size_t* /*messageCtx*/,
+  const void* /*handle*/,
+  ChannelReadCtx /*ctx*/)
+{
+	return nullptr;
+}
+
+static void channelWrite(const uint8_t* /*message*/, uint32_t /*messageLen*/, ChannelWriteCtx /*ctx*/)
+{
+}
+
+SCENARIO("RtpPacingQueue priority of simulcast packets", "[rtp][pacing]")
+{
+	class TestConsumerListener : public Consumer::Listener
+	{
+	public:
+		void OnConsumerSendRtpPacket(Consumer* consumer, RtpPacket* packet) override
+		{
+			this->priorities.push_back(RtpPacingQueue::GetPriority(consumer, packet, false));
+		}
+		void OnConsumerRetransmitRtpPacket(Consumer* /*consumer*/, RtpPacket* /*packet*/) override
+		{
+		}
+		void OnConsumerKeyFrameRequested(Consumer* /*consumer*/, uint32_t /*mappedSsrc*/) override
+		{
+		}
+		void OnConsumerNeedBitrateChange(Consumer* /*consumer*/) override
+		{
+		}
+		void OnConsumerNeedZeroBitrate(Consumer* /*consumer*/) override
+		{
+		}
+		void OnConsumerProducerClosed(Consumer* /*consumer*/) override
+		{
+		}
+
+	public:
+		std::vector<Priority> priorities;
+	};
+
+	class TestRtpStreamRecvListener : public RtpStreamRecv::Listener
+	{
+	public:
+		void OnRtpStreamScore(RtpStream* /*rtpStream*/, uint8_t /*score*/, uint8_t /*previousScore*/) override
+		{
+		}
+		void OnRtpStreamSendRtcpPacket(RtpStreamRecv* /*rtpStream*/, RTCP::Packet* /*packet*/) override
+		{
+		}
+		void OnRtpStreamNeedWorstRemoteFractionLost(
+		  RtpStreamRecv* /*rtpStream*/, uint8_t& /*worstRemoteFractionLost*/) override
+		{
+		}
+	};
+
+	Channel::ChannelSocket channel(channelRead, nullptr, channelWrite, nullptr);
+
+	Channel::ChannelNotifier::ClassInit(&channel);
+
+	TestConsumerListener consumerListener;
+	TestRtpStreamRecvListener rtpStreamListener;
+	RtpStream::Params params;
+
+	params.clockRate        = 90000;
+	params.mimeType.type    = RtpCodecMimeType::Type::VIDEO;
+	params.mimeType.subtype = RtpCodecMimeType::Subtype::VP8;
+
+	params.ssrc = 1111;
+	RtpStreamRecv producerRtpStream0(&rtpStreamListener, params, 0u);
+	params.ssrc = 2222;
+	RtpStreamRecv producerRtpStream1(&rtpStreamListener, params, 0u);
+
+	std::vector<uint8_t> producerRtpStreamScores{ 10, 10 };
+
+	auto createConsumer = [&](int16_t preferredSpatialLayer)
+	{
+		// clang-format off
+		json data = {
+			{ "kind", "video" },
+			{
+				"rtpParameters",
+				{
+					{ "codecs", { { { "mimeType", "video/VP8" }, { "payloadType", 101 }, { "clockRate", 90000 } } } },
+					{ "headerExtensions", json::array() },
+					{ "encodings", { { { "ssrc", 3333 }, { "scalabilityMode", "S2T3" } } } },
+					{ "rtcp", { { "cname", "foo" } } }
+				}
+			},
+			{ "consumableRtpEncodings", { { { "ssrc", 1111 } }, { { "ssrc", 2222 } } } },
+			{ "preferredLayers", { { "spatialLayer", preferredSpatialLayer } } }
+		};
+		// clang-format on
+
+		auto* consumer = new SimulcastConsumer("consumer1", "producer1", &consumerListener, data);
+
+		consumer->ProducerRtpStreamScores(&producerRtpStreamScores);
+		consumer->ProducerRtpStream(&producerRtpStream0, 1111);
+		consumer->ProducerRtpStream(&producerRtpStream1, 2222);
+		consumer->TransportConnected();
+
+		return consumer;
+	};
+
+	// A VP8 packet with the given temporal layer (a key frame if 0).
+	auto sendPacket = [](SimulcastConsumer* consumer, uint32_t ssrc, uint16_t seq, uint8_t temporalLayer)
+	{
+		// clang-format off
+		uint8_t buffer[] =
+		{
+			0b10000000, 0b11100101, 0, 0, // Marker, PT:101
+			0, 0, 0, 0,
+			0, 0, 0, 0,                   // SSRC
+			0x90, 0xA0, 0x80, 0x01,       // VP8 payload descriptor, PictureID:1
+			0x00, 0x00                    // TID, VP8 payload header
+		};
+		// clang-format on
+
+		Utils::Byte::Set2Bytes(buffer, 2, seq);
+		Utils::Byte::Set4Bytes(buffer, 4, seq * 3000u);
+		Utils::Byte::Set4Bytes(buffer, 8, ssrc);
+		buffer[16] = temporalLayer << 6;
+		buffer[17] = temporalLayer == 0u ? 0x00 : 0x01;
+
+		auto* packet = RtpPacket::Parse(buffer, sizeof(buffer));
+
+		REQUIRE(packet);
+
+		Codecs::VP8::ProcessRtpPacket(packet);
+
+		SharedRtpPacket sharedPacket;
+
+		consumer->SendRtpPacket(packet, sharedPacket);
+
+		RtpPacket::Deallocate(packet);
+	};
+
+	SECTION("packets of the first simulcast stream are classified by their temporal layer")
+	{
+		auto* consumer = createConsumer(0);
+
+		sendPacket(consumer, 1111, 1, 0);
+		sendPacket(consumer, 1111, 2, 1);
+		// Not the stream being sent.
+		sendPacket(consumer, 2222, 1, 0);
+
+		REQUIRE(consumer->GetCurrentSpatialLayer() == 0);
+		REQUIRE(
+		  consumerListener.priorities ==
+		  std::vector<Priority>{ Priority::VIDEO_BASE_LAYER, Priority::VIDEO_UPPER_LAYER });
+
+		delete consumer;
+	}
+
+	SECTION("packets of upper simulcast streams are upper layer packets")
+	{
+		auto* consumer = createConsumer(1);
+
+		// The payload descriptor of VP8 tells spatial layer 0 for every stream.
+		sendPacket(consumer, 2222, 1, 0);
+		sendPacket(consumer, 2222, 2, 1);
+
+		REQUIRE(consumer->GetCurrentSpatialLayer() == 1);
+		REQUIRE(
+		  consumerListener.priorities ==
+		  std::vector<Priority>{ Priority::VIDEO_UPPER_LAYER, Priority::VIDEO_UPPER_LAYER });
+
+		delete consumer;
+	}
+
+	Channel::ChannelNotifier::ClassInit(nullptr);
+	channel.Close();
+
+	// Run the close callbacks of the channel and the timers.
+	uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+}
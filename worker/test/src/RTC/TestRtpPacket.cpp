@@ -1,8 +1,9 @@
 #include "common.hpp"
 #include "helpers.hpp"
+#include "RTC/Codecs/VP8.hpp"
 #include "RTC/RtpPacket.hpp"
 #include <catch2/catch.hpp>
-#include <cstring> // std::memset()
+#include <cstring> // std::memset(), std::memcmp()
 #include <string>
 #include <vector>
 
@@ -303,6 +304,124 @@ SCENARIO("parse RTP packets", "[parser][rtp]")
 		RTC::RtpPacket::Deallocate(packet);
 	}
 
+	SECTION("parse Two-Bytes header extension with high ids, repeated ids and long padding")
+	{
+		// clang-format off
+		uint8_t buffer[] =
+		{
+			0b10010000, 0b00000001, 0, 8,
+			0, 0, 0, 4,
+			0, 0, 0, 5,
+			0b00010000, 0, 0, 10, // Header Extension
+			200, 1, 0x42, 0,
+			0, 0, 0, 0,
+			0, 0, 0, 0,
+			0, 0, 0, 0,
+			0, 0, 0, 0,
+			0, 0, 255, 2,
+			0x11, 0x22, 200, 1,
+			0x43, 64, 1, 0x44,
+			0, 0, 0, 0,
+			0, 0, 0, 0
+		};
+		// clang-format on
+
+		uint8_t extenLen;
+		uint8_t* extenValue;
+
+		RtpPacket* packet = RtpPacket::Parse(buffer, sizeof(buffer));
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		REQUIRE(packet->GetHeaderExtensionLength() == 40);
+		REQUIRE(packet->HasTwoBytesExtensions());
+
+		// The last element with a given id wins.
+		extenValue = packet->GetExtension(200, extenLen);
+		REQUIRE(packet->HasExtension(200) == true);
+		REQUIRE(extenValue != nullptr);
+		REQUIRE(extenLen == 1);
+		REQUIRE(extenValue[0] == 0x43);
+
+		extenValue = packet->GetExtension(255, extenLen);
+		REQUIRE(packet->HasExtension(255) == true);
+		REQUIRE(extenValue != nullptr);
+		REQUIRE(extenLen == 2);
+		REQUIRE(extenValue[0] == 0x11);
+		REQUIRE(extenValue[1] == 0x22);
+
+		extenValue = packet->GetExtension(64, extenLen);
+		REQUIRE(packet->HasExtension(64) == true);
+		REQUIRE(extenValue != nullptr);
+		REQUIRE(extenLen == 1);
+		REQUIRE(extenValue[0] == 0x44);
+
+		REQUIRE(packet->HasExtension(63) == false);
+		REQUIRE(packet->HasExtension(128) == false);
+
+		REQUIRE(packet->SetExtensionLength(255, 1) == true);
+
+		extenValue = packet->GetExtension(255, extenLen);
+		REQUIRE(extenLen == 1);
+		REQUIRE(extenValue[0] == 0x11);
+
+		RTC::RtpPacket::Deallocate(packet);
+	}
+
+	SECTION("parse Two-Bytes header extension with more ids than stored offsets")
+	{
+		// 12 bytes of fixed header, 4 bytes of header extension header and 20
+		// elements of 3 bytes (ids 1..20 with value id) plus a repeated id 20
+		// element and a padding byte.
+		// clang-format off
+		std::vector<uint8_t> buffer
+		{
+			0b10010000, 0b00000001, 0, 8,
+			0, 0, 0, 4,
+			0, 0, 0, 5,
+			0b00010000, 0, 0, 16 // Header Extension
+		};
+		// clang-format on
+
+		for (uint8_t id{ 1u }; id <= 20u; ++id)
+		{
+			buffer.insert(buffer.end(), { id, 1, id });
+		}
+
+		buffer.insert(buffer.end(), { 20, 1, 0x42, 0 });
+
+		uint8_t extenLen;
+		uint8_t* extenValue;
+
+		RtpPacket* packet = RtpPacket::Parse(buffer.data(), buffer.size());
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		REQUIRE(packet->GetHeaderExtensionLength() == 64);
+		REQUIRE(packet->HasTwoBytesExtensions());
+
+		for (uint8_t id{ 1u }; id < 20u; ++id)
+		{
+			extenValue = packet->GetExtension(id, extenLen);
+			REQUIRE(extenValue != nullptr);
+			REQUIRE(extenLen == 1);
+			REQUIRE(extenValue[0] == id);
+		}
+
+		// The last element with a given id wins.
+		extenValue = packet->GetExtension(20, extenLen);
+		REQUIRE(extenValue != nullptr);
+		REQUIRE(extenLen == 1);
+		REQUIRE(extenValue[0] == 0x42);
+
+		REQUIRE(packet->HasExtension(21) == false);
+		REQUIRE(packet->HasExtension(255) == false);
+
+		RTC::RtpPacket::Deallocate(packet);
+	}
+
 	SECTION("rtx encryption-decryption")
 	{
 		// clang-format off
@@ -792,6 +911,85 @@ SCENARIO("parse RTP packets", "[parser][rtp]")
 		RTC::RtpPacket::Deallocate(packet);
 	}
 
+	SECTION("set serialized header extensions")
+	{
+		// clang-format off
+		uint8_t buffer[] =
+		{
+			0b10100000, 0b00000001, 0, 8,
+			0, 0, 0, 4,
+			0, 0, 0, 5,
+			0x11, 0x22, 0x33, 0x44, // Payload
+			0x55, 0x66, 0x77, 0x88,
+			0x99, 0xAA, 0xBB, 0xCC,
+			0x00, 0x00, 0x00, 0x04, // 4 padding bytes
+			// Extra buffer
+			0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00
+		};
+
+		uint8_t oneByteExtensions[] =
+		{
+			0x12, 0x61, 0x62, 0x63, // id: 1, len: 3
+			0x31, 0x09, 0x08,       // id: 3, len: 2
+			0x00                    // 1 padding byte
+		};
+
+		uint8_t twoBytesExtensions[] =
+		{
+			0x18, 0x01, 0xAA,       // id: 24, len: 1
+			0x00                    // 1 padding byte
+		};
+		// clang-format on
+
+		RtpPacket* packet = RtpPacket::Parse(buffer, 28);
+		uint8_t extenLen;
+		uint8_t* extenValue;
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		packet->SetSerializedExtensions(1, oneByteExtensions, sizeof(oneByteExtensions));
+
+		REQUIRE(packet->GetSize() == 40);
+		REQUIRE(packet->GetHeaderExtensionId() == 0xBEDE);
+		REQUIRE(packet->GetHeaderExtensionLength() == 8);
+		REQUIRE(packet->HasOneByteExtensions() == true);
+		REQUIRE(packet->GetPayloadLength() == 12);
+		REQUIRE(packet->GetPayloadPadding() == 4);
+		REQUIRE(packet->GetPayload()[0] == 0x11);
+		REQUIRE(packet->GetPayload()[packet->GetPayloadLength() - 1] == 0xCC);
+		REQUIRE((extenValue = packet->GetExtension(1, extenLen)));
+		REQUIRE(extenLen == 3);
+		REQUIRE(extenValue[0] == 0x61);
+		REQUIRE(extenValue[2] == 0x63);
+		REQUIRE((extenValue = packet->GetExtension(3, extenLen)));
+		REQUIRE(extenLen == 2);
+		REQUIRE(extenValue[0] == 0x09);
+		REQUIRE(extenValue[1] == 0x08);
+		REQUIRE(packet->HasExtension(2) == false);
+
+		packet->SetSerializedExtensions(2, twoBytesExtensions, sizeof(twoBytesExtensions));
+
+		REQUIRE(packet->GetSize() == 36);
+		REQUIRE(packet->GetHeaderExtensionId() == 0b0001000000000000);
+		REQUIRE(packet->GetHeaderExtensionLength() == 4);
+		REQUIRE(packet->HasTwoBytesExtensions() == true);
+		REQUIRE(packet->GetPayloadLength() == 12);
+		REQUIRE(packet->GetPayloadPadding() == 4);
+		REQUIRE(packet->GetPayload()[0] == 0x11);
+		REQUIRE(packet->GetPayload()[packet->GetPayloadLength() - 1] == 0xCC);
+		REQUIRE(packet->HasExtension(1) == false);
+		REQUIRE(packet->HasExtension(3) == false);
+		REQUIRE((extenValue = packet->GetExtension(24, extenLen)));
+		REQUIRE(extenLen == 1);
+		REQUIRE(extenValue[0] == 0xAA);
+
+		RTC::RtpPacket::Deallocate(packet);
+	}
+
 	SECTION("read frame-marking extension")
 	{
 		// clang-format off
@@ -842,6 +1040,263 @@ SCENARIO("parse RTP packets", "[parser][rtp]")
 		RTC::RtpPacket::Deallocate(packet);
 	}
 
+	SECTION("header overlay")
+	{
+		// clang-format off
+		uint8_t buffer[] =
+		{
+			0b10010000, 0b00000001, 0, 8,
+			0, 0, 0, 4,
+			0, 0, 0, 5,
+			0xBE, 0xDE, 0, 4, // Header Extension
+			0b00010000, 'a', 0x00, 0x00, // id: 1, len: 1 (MID) + padding
+			0x00, 0x00, 0x00, 0x00,
+			0x00, 0b00100010, 0x01, 0x02, // id: 2, len: 3 (abs-send-time)
+			0x03, 0b00110001, 0x04, 0x05, // id: 3, len: 2 (transport-wide-cc)
+			1, 2, 3, 4
+		};
+		// clang-format on
+
+		RtpPacket* packet = RtpPacket::Parse(buffer, sizeof(buffer));
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		packet->SetMidExtensionId(1);
+		packet->SetAbsSendTimeExtensionId(2);
+		packet->SetTransportWideCc01ExtensionId(3);
+
+		std::string mid;
+		uint16_t wideSeqNumber;
+		uint32_t absSendTime;
+
+		REQUIRE(packet->GetSerializedHeader() == packet->GetData());
+
+		const std::string newMid{ "abc" };
+		RtpPacket::HeaderOverlay headerOverlay(packet);
+
+		packet->SetHeaderOverlay(&headerOverlay);
+		packet->SetSsrc(1234);
+		packet->SetSequenceNumber(1000);
+		packet->SetTimestamp(2000);
+		packet->SetMarker(true);
+
+		REQUIRE(packet->UpdateMid(newMid));
+		REQUIRE(packet->UpdateTransportWideCc01(4321));
+
+		REQUIRE(packet->GetSsrc() == 1234);
+		REQUIRE(packet->GetSequenceNumber() == 1000);
+		REQUIRE(packet->GetTimestamp() == 2000);
+		REQUIRE(packet->HasMarker() == true);
+		REQUIRE(packet->ReadMid(mid));
+		REQUIRE(mid == "abc");
+		REQUIRE(packet->ReadTransportWideCc01(wideSeqNumber));
+		REQUIRE(wideSeqNumber == 4321);
+
+		// The packet buffer must not be modified.
+		REQUIRE(buffer[1] == 0b00000001);
+		REQUIRE(buffer[3] == 8);
+		REQUIRE(buffer[7] == 4);
+		REQUIRE(buffer[11] == 5);
+		REQUIRE(buffer[16] == 0b00010000);
+		REQUIRE(buffer[17] == 'a');
+		REQUIRE(buffer[18] == 0x00);
+		REQUIRE(buffer[30] == 0x04);
+		REQUIRE(buffer[31] == 0x05);
+
+		uint8_t serialized[sizeof(buffer)];
+
+		REQUIRE(packet->Serialize(serialized) == sizeof(buffer));
+		// Header is serialized apart from the payload (the last 4 bytes).
+		REQUIRE(packet->GetHeaderLength() == sizeof(buffer) - 4);
+		REQUIRE(packet->GetPayload() == buffer + sizeof(buffer) - 4);
+		REQUIRE(std::memcmp(packet->GetSerializedHeader(), serialized, packet->GetHeaderLength()) == 0);
+
+		RtpPacket* serializedPacket = RtpPacket::Parse(serialized, sizeof(serialized));
+
+		if (!serializedPacket)
+			FAIL("not a RTP packet");
+
+		serializedPacket->SetMidExtensionId(1);
+		serializedPacket->SetAbsSendTimeExtensionId(2);
+		serializedPacket->SetTransportWideCc01ExtensionId(3);
+
+		REQUIRE(serializedPacket->GetSsrc() == 1234);
+		REQUIRE(serializedPacket->GetSequenceNumber() == 1000);
+		REQUIRE(serializedPacket->GetTimestamp() == 2000);
+		REQUIRE(serializedPacket->HasMarker() == true);
+		REQUIRE(serializedPacket->ReadMid(mid));
+		REQUIRE(mid == "abc");
+		REQUIRE(serializedPacket->ReadTransportWideCc01(wideSeqNumber));
+		REQUIRE(wideSeqNumber == 4321);
+		REQUIRE(serializedPacket->ReadAbsSendTime(absSendTime));
+		REQUIRE(absSendTime == 0x010203);
+		REQUIRE(serializedPacket->GetPayloadLength() == 4);
+		REQUIRE(serializedPacket->GetPayload()[3] == 4);
+
+		auto clone = packet->Clone();
+
+		REQUIRE(clone->GetHeaderOverlay() == nullptr);
+		REQUIRE(clone->GetSsrc() == 1234);
+		REQUIRE(clone->GetSequenceNumber() == 1000);
+		REQUIRE(clone->GetTimestamp() == 2000);
+		REQUIRE(clone->HasMarker() == true);
+		REQUIRE(clone->ReadMid(mid));
+		REQUIRE(mid == "abc");
+
+		packet->SetHeaderOverlay(nullptr);
+
+		REQUIRE(packet->GetSsrc() == 5);
+		REQUIRE(packet->GetSequenceNumber() == 8);
+		REQUIRE(packet->GetTimestamp() == 4);
+		REQUIRE(packet->HasMarker() == false);
+		REQUIRE(packet->ReadMid(mid));
+		REQUIRE(mid == "a");
+		REQUIRE(packet->ReadTransportWideCc01(wideSeqNumber));
+		REQUIRE(wideSeqNumber == 0x0405);
+
+		RTC::RtpPacket::Deallocate(serializedPacket);
+		RTC::RtpPacket::Deallocate(packet);
+	}
+
+	SECTION("payload descriptor rewritten into the header overlay")
+	{
+		// clang-format off
+		uint8_t buffer[] =
+		{
+			0b10000000, 0b00000001, 0, 8,
+			0, 0, 0, 4,
+			0, 0, 0, 5,
+			// VP8 payload descriptor with two bytes pictureId 17, TL0PICIDX 5
+			// and TID 0.
+			0x90, 0xe0, 0x80, 0x11, 0x05, 0x20,
+			// VP8 payload.
+			0xaa, 0xbb, 0xcc, 0xdd
+		};
+		// clang-format on
+
+		RtpPacket* packet = RtpPacket::Parse(buffer, sizeof(buffer));
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		Codecs::VP8::ProcessRtpPacket(packet);
+
+		RTC::Codecs::EncodingContext::Params params;
+		Codecs::VP8::EncodingContext context(params);
+		bool marker{ false };
+
+		// Sync so pictureId and TL0PICIDX are rewritten to 1.
+		context.SyncRequired();
+		context.SetTargetTemporalLayer(0);
+		context.SetCurrentTemporalLayer(0);
+
+		RtpPacket::HeaderOverlay headerOverlay(packet);
+
+		packet->SetHeaderOverlay(&headerOverlay);
+
+		REQUIRE(packet->ProcessPayload(&context, marker));
+
+		// The packet buffer must not be modified.
+		REQUIRE(buffer[15] == 0x11);
+		REQUIRE(buffer[16] == 0x05);
+
+		// The rewritten bytes are serialized along with the header.
+		REQUIRE(headerOverlay.payloadDescriptorLength == 8);
+		REQUIRE(packet->GetSerializedHeaderLength() == packet->GetHeaderLength() + 8);
+
+		const uint8_t* header = packet->GetSerializedHeader();
+
+		REQUIRE(header[14] == 0x80);
+		REQUIRE(header[15] == 0x01);
+		REQUIRE(header[16] == 0x01);
+		REQUIRE(header[19] == 0xbb);
+
+		uint8_t serialized[sizeof(buffer)];
+
+		REQUIRE(packet->Serialize(serialized) == sizeof(buffer));
+		REQUIRE(serialized[15] == 0x01);
+		REQUIRE(serialized[16] == 0x01);
+		REQUIRE(std::memcmp(serialized, header, packet->GetSerializedHeaderLength()) == 0);
+		REQUIRE(
+		  std::memcmp(
+		    serialized + packet->GetSerializedHeaderLength(),
+		    buffer + packet->GetSerializedHeaderLength(),
+		    sizeof(buffer) - packet->GetSerializedHeaderLength()) == 0);
+
+		auto clone = packet->Clone();
+
+		REQUIRE(clone->GetPayload()[3] == 0x01);
+		REQUIRE(clone->GetPayload()[4] == 0x01);
+
+		packet->SetHeaderOverlay(nullptr);
+
+		REQUIRE(packet->GetSerializedHeaderLength() == packet->GetHeaderLength());
+		REQUIRE(packet->GetPayload()[3] == 0x11);
+
+		RTC::RtpPacket::Deallocate(packet);
+	}
+
+	SECTION("SharedRtpPacket counts references of a cloned packet")
+	{
+		// clang-format off
+		uint8_t buffer[] =
+		{
+			0b10000000, 0b00000001, 0, 8,
+			0, 0, 0, 4,
+			0, 0, 0, 5,
+			1, 2, 3, 4
+		};
+		// clang-format on
+
+		RtpPacket* packet = RtpPacket::Parse(buffer, sizeof(buffer));
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		SharedRtpPacket sharedPacket;
+
+		REQUIRE(!sharedPacket);
+		REQUIRE(sharedPacket.use_count() == 0);
+
+		sharedPacket = packet->Clone();
+
+		RTC::RtpPacket::Deallocate(packet);
+
+		REQUIRE(sharedPacket);
+		REQUIRE(sharedPacket.use_count() == 1);
+
+		{
+			SharedRtpPacket copy1 = sharedPacket;
+			SharedRtpPacket copy2;
+
+			copy2 = copy1;
+
+			REQUIRE(copy1.get() == sharedPacket.get());
+			REQUIRE(copy2.get() == sharedPacket.get());
+			REQUIRE(sharedPacket.use_count() == 3);
+
+			SharedRtpPacket moved = std::move(copy2);
+
+			REQUIRE(!copy2);
+			REQUIRE(moved.get() == sharedPacket.get());
+			REQUIRE(sharedPacket.use_count() == 3);
+
+			copy1.reset();
+
+			REQUIRE(!copy1);
+			REQUIRE(sharedPacket.use_count() == 2);
+		}
+
+		REQUIRE(sharedPacket.use_count() == 1);
+		REQUIRE(sharedPacket->GetSequenceNumber() == 8);
+		REQUIRE(sharedPacket->GetPayloadLength() == 4);
+
+		sharedPacket = nullptr;
+
+		REQUIRE(!sharedPacket);
+	}
+
 #ifdef PERFORMANCE_TEST
 	SECTION("Parse()")
 	{
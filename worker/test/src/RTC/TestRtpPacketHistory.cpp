@@ -0,0 +1,180 @@
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "RTC/RtpPacketHistory.hpp"
+#include <catch2/catch.hpp>
+#include <cstring> // std::memcpy()
+
+using namespace RTC;
+
+SCENARIO("RtpPacketHistory", "[rtp][nack]")
+{
+	// clang-format off
+	uint8_t buffer[] =
+	{
+		0b10000000, 0b01111011, 0b01010010, 0b00001110,
+		0b01011011, 0b01101011, 0b11001010, 0b10110101,
+		0, 0, 0, 2
+	};
+	// clang-format on
+
+	uint8_t packetBuffer[1500];
+
+	std::memcpy(packetBuffer, buffer, sizeof(buffer));
+
+	auto* packet = RtpPacket::Parse(packetBuffer, sizeof(buffer));
+
+	REQUIRE(packet);
+
+	SECTION("stored packets are got by their index")
+	{
+		RtpPacketHistory packetHistory(1000u);
+
+		SharedRtpPacket sharedPacket1;
+		auto index1 = packetHistory.Store(packet, sharedPacket1, 10000u);
+
+		packet->SetSequenceNumber(packet->GetSequenceNumber() + 1);
+
+		SharedRtpPacket sharedPacket2;
+		auto index2 = packetHistory.Store(packet, sharedPacket2, 10000u);
+
+		REQUIRE(sharedPacket1);
+		REQUIRE(sharedPacket2);
+		REQUIRE(index2 == index1 + 1);
+		REQUIRE(packetHistory.GetSize() == 2);
+		REQUIRE(packetHistory.Get(index1) == sharedPacket1.get());
+		REQUIRE(packetHistory.Get(index2) == sharedPacket2.get());
+		REQUIRE(packetHistory.Get(index2 + 1) == nullptr);
+	}
+
+	SECTION("a packet is stored once for all the streams it is sent to")
+	{
+		RtpPacketHistory packetHistory(1000u);
+
+		SharedRtpPacket sharedPacket;
+		auto index1 = packetHistory.Store(packet, sharedPacket, 10000u);
+		auto* clonedPacket = sharedPacket.get();
+		auto index2        = packetHistory.Store(packet, sharedPacket, 10000u);
+
+		REQUIRE(index2 == index1);
+		REQUIRE(sharedPacket.get() == clonedPacket);
+		REQUIRE(sharedPacket.use_count() == 2);
+		REQUIRE(packetHistory.GetSize() == 1);
+	}
+
+	SECTION("a duplicated packet is stored once")
+	{
+		RtpPacketHistory packetHistory(1000u);
+		auto seq = packet->GetSequenceNumber();
+
+		SharedRtpPacket sharedPacket1;
+		auto index1 = packetHistory.Store(packet, sharedPacket1, 10000u);
+
+		packet->SetSequenceNumber(seq + 1);
+
+		SharedRtpPacket sharedPacket2;
+		auto index2 = packetHistory.Store(packet, sharedPacket2, 10000u);
+
+		// Same packet received again after another one.
+		packet->SetSequenceNumber(seq);
+
+		SharedRtpPacket sharedPacket3;
+		auto index3 = packetHistory.Store(packet, sharedPacket3, 10000u);
+
+		REQUIRE(index3 == index1);
+		REQUIRE(index2 == index1 + 1);
+		REQUIRE(sharedPacket3.get() == sharedPacket1.get());
+		REQUIRE(packetHistory.GetSize() == 2);
+
+		// Same sequence number but different timestamp is a different packet.
+		packet->SetTimestamp(packet->GetTimestamp() + 1);
+
+		SharedRtpPacket sharedPacket4;
+		auto index4 = packetHistory.Store(packet, sharedPacket4, 10000u);
+
+		REQUIRE(index4 == index2 + 1);
+		REQUIRE(sharedPacket4.get() != sharedPacket1.get());
+		REQUIRE(packetHistory.GetSize() == 3);
+
+		// Duplicates are looked up by the packet bytes, not by the header overlay.
+		RtpPacket::HeaderOverlay headerOverlay(packet);
+
+		packet->SetHeaderOverlay(&headerOverlay);
+		packet->SetSequenceNumber(seq + 100);
+
+		SharedRtpPacket sharedPacket5;
+		auto index5 = packetHistory.Store(packet, sharedPacket5, 10000u);
+
+		packet->SetHeaderOverlay(nullptr);
+
+		REQUIRE(index5 == index4);
+		REQUIRE(sharedPacket5.get() == sharedPacket4.get());
+	}
+
+	SECTION("packets older than max age are removed")
+	{
+		RtpPacketHistory packetHistory(1000u);
+
+		SharedRtpPacket sharedPacket1;
+		auto index1 = packetHistory.Store(packet, sharedPacket1, 10000u);
+
+		packet->SetSequenceNumber(packet->GetSequenceNumber() + 1);
+
+		SharedRtpPacket sharedPacket2;
+		auto index2 = packetHistory.Store(packet, sharedPacket2, 11000u);
+
+		REQUIRE(packetHistory.Get(index1) == sharedPacket1.get());
+
+		packet->SetSequenceNumber(packet->GetSequenceNumber() + 1);
+
+		SharedRtpPacket sharedPacket3;
+		auto index3 = packetHistory.Store(packet, sharedPacket3, 11001u);
+
+		REQUIRE(packetHistory.Get(index1) == nullptr);
+		REQUIRE(sharedPacket1.use_count() == 1);
+		REQUIRE(packetHistory.Get(index2) == sharedPacket2.get());
+		REQUIRE(packetHistory.Get(index3) == sharedPacket3.get());
+		REQUIRE(packetHistory.GetSize() == 2);
+	}
+
+	SECTION("oldest packets are removed when full")
+	{
+		RtpPacketHistory packetHistory(1000u);
+		uint32_t firstIndex{ 0u };
+		uint32_t lastIndex{ 0u };
+		size_t maxCapacity = RtpPacketHistory::MaxCapacity;
+
+		for (size_t i{ 0u }; i < maxCapacity + 10u; ++i)
+		{
+			SharedRtpPacket sharedPacket;
+
+			packet->SetSequenceNumber(static_cast<uint16_t>(i));
+
+			lastIndex = packetHistory.Store(packet, sharedPacket, 10000u);
+
+			if (i == 0u)
+				firstIndex = lastIndex;
+		}
+
+		REQUIRE(packetHistory.GetCapacity() == maxCapacity);
+		REQUIRE(packetHistory.GetSize() == maxCapacity);
+		REQUIRE(packetHistory.Get(firstIndex + 9u) == nullptr);
+		REQUIRE(packetHistory.Get(firstIndex + 10u) != nullptr);
+		REQUIRE(packetHistory.Get(lastIndex) != nullptr);
+	}
+
+	SECTION("Clear() removes all the packets")
+	{
+		RtpPacketHistory packetHistory(1000u);
+
+		SharedRtpPacket sharedPacket;
+		auto index = packetHistory.Store(packet, sharedPacket, 10000u);
+
+		packetHistory.Clear();
+
+		REQUIRE(packetHistory.GetSize() == 0);
+		REQUIRE(packetHistory.Get(index) == nullptr);
+		REQUIRE(sharedPacket.use_count() == 1);
+	}
+
+	RtpPacket::Deallocate(packet);
+}
@@ -206,5 +206,5 @@ SCENARIO("receive RTP packets and trigger NACK", "[rtp][rtpstream]")
 	// Must run the loop to wait for UV timers and close them.
 	DepLibUV::RunLoop();
 
-	delete packet;
+	RtpPacket::Deallocate(packet);
 }
@@ -1,12 +1,21 @@
 #include "common.hpp"
+#include "RTC/Codecs/VP8.hpp"
 #include "RTC/RTCP/FeedbackRtpNack.hpp"
 #include "RTC/RtpPacket.hpp"
+#include "RTC/RtpPacketHistory.hpp"
 #include "RTC/RtpStream.hpp"
 #include "RTC/RtpStreamSend.hpp"
 #include <catch2/catch.hpp>
 #include <vector>
 
 #define PERFORMANCE_TEST 1
+// Clone/store churn, NACK bursts and memory of many consumers. Too slow to run
+// with the rest of the tests.
+// #define RETRANSMISSION_BENCHMARK 1
+
+#if defined(RETRANSMISSION_BENCHMARK) && defined(__GLIBC__)
+#include <malloc.h> // mallinfo2()
+#endif
 
 using namespace RTC;
 
@@ -22,7 +31,7 @@ static RtpPacket* CreateRtpPacket(uint8_t* buffer, uint16_t seq, uint32_t timest
 
 static void SendRtpPacket(std::vector<std::pair<RtpStreamSend*, uint32_t>> streams, RtpPacket* packet)
 {
-	std::shared_ptr<RtpPacket> sharedPacket;
+	SharedRtpPacket sharedPacket;
 
 	for (auto& stream : streams)
 	{
@@ -319,6 +328,198 @@ SCENARIO("NACK and RTP packets retransmission", "[rtp][rtcp][nack]")
 		delete stream2;
 	}
 
+	SECTION("receive NACK in RtpStreamSend instances sending different payload descriptors")
+	{
+		// clang-format off
+		uint8_t vp8Buffer[1500] =
+		{
+			0b10000000, 0b01111011, 0b01010010, 0b00001110,
+			0b01011011, 0b01101011, 0b11001010, 0b10110101,
+			0, 0, 0, 2,
+			// VP8 payload descriptor with two bytes pictureId 17, TL0PICIDX 5
+			// and TID 0.
+			0x90, 0xe0, 0x80, 0x11, 0x05, 0x20,
+			// VP8 payload.
+			0xaa, 0xbb
+		};
+		// clang-format on
+
+		auto* packet = RtpPacket::Parse(vp8Buffer, 20);
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		packet->SetSequenceNumber(21006);
+		packet->SetTimestamp(1533790901);
+
+		Codecs::VP8::ProcessRtpPacket(packet);
+
+		REQUIRE(packet->HasPayloadDescriptorHandler());
+
+		// Create two RtpStreamSend instances.
+		TestRtpStreamListener testRtpStreamListener1;
+		TestRtpStreamListener testRtpStreamListener2;
+
+		RtpStream::Params params1;
+
+		params1.ssrc          = 1111;
+		params1.clockRate     = 90000;
+		params1.useNack       = true;
+		params1.mimeType.type = RTC::RtpCodecMimeType::Type::VIDEO;
+
+		std::string mid;
+		RtpStreamSend* stream1 = new RtpStreamSend(&testRtpStreamListener1, params1, mid);
+
+		RtpStream::Params params2;
+
+		params2.ssrc          = 2222;
+		params2.clockRate     = 90000;
+		params2.useNack       = true;
+		params2.mimeType.type = RTC::RtpCodecMimeType::Type::VIDEO;
+
+		RtpStreamSend* stream2 = new RtpStreamSend(&testRtpStreamListener2, params2, mid);
+
+		// stream1 rewrites the pictureId to 1 and clones the packet shared with
+		// stream2, which sends the original payload descriptor.
+		SharedRtpPacket sharedPacket;
+		RtpPacket::HeaderOverlay headerOverlay1(packet);
+
+		std::memcpy(headerOverlay1.payloadDescriptor, packet->GetPayload(), 8);
+		headerOverlay1.payloadDescriptor[3]    = 0x01;
+		headerOverlay1.payloadDescriptorLength = 8;
+
+		packet->SetHeaderOverlay(&headerOverlay1);
+		packet->SetSsrc(params1.ssrc);
+		stream1->ReceivePacket(packet, sharedPacket);
+		packet->SetHeaderOverlay(nullptr);
+
+		RtpPacket::HeaderOverlay headerOverlay2(packet);
+
+		packet->SetHeaderOverlay(&headerOverlay2);
+		packet->SetSsrc(params2.ssrc);
+		stream2->ReceivePacket(packet, sharedPacket);
+		packet->SetHeaderOverlay(nullptr);
+
+		REQUIRE(sharedPacket->GetPayload()[3] == 0x01);
+
+		RTCP::FeedbackRtpNackPacket nackPacket(0, params1.ssrc);
+		auto* nackItem = new RTCP::FeedbackRtpNackItem(21006, 0b0000000000000000);
+
+		nackPacket.AddItem(nackItem);
+
+		stream2->ReceiveNack(&nackPacket);
+
+		REQUIRE(testRtpStreamListener2.retransmittedPackets.size() == 1);
+
+		auto* rtxPacket = testRtpStreamListener2.retransmittedPackets[0];
+
+		REQUIRE(rtxPacket->GetSsrc() == params2.ssrc);
+		REQUIRE(std::memcmp(rtxPacket->GetPayload(), vp8Buffer + 12, 8) == 0);
+
+		stream1->ReceiveNack(&nackPacket);
+
+		REQUIRE(testRtpStreamListener1.retransmittedPackets.size() == 1);
+
+		rtxPacket = testRtpStreamListener1.retransmittedPackets[0];
+
+		REQUIRE(rtxPacket->GetSsrc() == params1.ssrc);
+		REQUIRE(std::memcmp(rtxPacket->GetPayload(), headerOverlay1.payloadDescriptor, 8) == 0);
+
+		delete stream1;
+		delete stream2;
+		RtpPacket::Deallocate(packet);
+	}
+
+	SECTION("receive NACK in RtpStreamSend instances sharing a packet history")
+	{
+		// packet1 [pt:123, seq:21006, timestamp:1533790901]
+		auto packet1 = CreateRtpPacket(rtpBuffer1, 21006, 1533790901);
+		// packet2 [pt:123, seq:21007, timestamp:1533790901]
+		auto packet2 = CreateRtpPacket(rtpBuffer2, 21007, 1533790901);
+
+		RtpPacketHistory packetHistory(RtpStreamSend::MaxRetransmissionDelay);
+
+		// Create two RtpStreamSend instances using the same packet history.
+		TestRtpStreamListener testRtpStreamListener1;
+		TestRtpStreamListener testRtpStreamListener2;
+
+		RtpStream::Params params1;
+
+		params1.ssrc          = 1111;
+		params1.clockRate     = 90000;
+		params1.useNack       = true;
+		params1.mimeType.type = RTC::RtpCodecMimeType::Type::VIDEO;
+
+		std::string mid;
+		RtpStreamSend* stream1 = new RtpStreamSend(&testRtpStreamListener1, params1, mid);
+
+		stream1->SetRtpPacketHistory(&packetHistory);
+
+		RtpStream::Params params2;
+
+		params2.ssrc          = 2222;
+		params2.clockRate     = 90000;
+		params2.useNack       = true;
+		params2.mimeType.type = RTC::RtpCodecMimeType::Type::VIDEO;
+
+		RtpStreamSend* stream2 = new RtpStreamSend(&testRtpStreamListener2, params2, mid);
+
+		stream2->SetRtpPacketHistory(&packetHistory);
+
+		// Receive all the packets in both streams.
+		SendRtpPacket({ { stream1, params1.ssrc }, { stream2, params2.ssrc } }, packet1);
+		SendRtpPacket({ { stream1, params1.ssrc }, { stream2, params2.ssrc } }, packet2);
+
+		// Each packet is stored once.
+		REQUIRE(packetHistory.GetSize() == 2);
+
+		// Create a NACK item that request for all the packets.
+		RTCP::FeedbackRtpNackPacket nackPacket(0, params1.ssrc);
+		auto* nackItem = new RTCP::FeedbackRtpNackItem(21006, 0b0000000000000001);
+
+		nackPacket.AddItem(nackItem);
+
+		// Process the NACK packet on stream1.
+		stream1->ReceiveNack(&nackPacket);
+
+		REQUIRE(testRtpStreamListener1.retransmittedPackets.size() == 2);
+
+		auto rtxPacket1 = testRtpStreamListener1.retransmittedPackets[0];
+		auto rtxPacket2 = testRtpStreamListener1.retransmittedPackets[1];
+
+		testRtpStreamListener1.retransmittedPackets.clear();
+
+		CheckRtxPacket(rtxPacket1, packet1->GetSequenceNumber(), packet1->GetTimestamp());
+		REQUIRE(rtxPacket1->GetSsrc() == params1.ssrc);
+		CheckRtxPacket(rtxPacket2, packet2->GetSequenceNumber(), packet2->GetTimestamp());
+		REQUIRE(rtxPacket2->GetSsrc() == params1.ssrc);
+
+		// Process the NACK packet on stream2.
+		stream2->ReceiveNack(&nackPacket);
+
+		REQUIRE(testRtpStreamListener2.retransmittedPackets.size() == 2);
+
+		rtxPacket1 = testRtpStreamListener2.retransmittedPackets[0];
+		rtxPacket2 = testRtpStreamListener2.retransmittedPackets[1];
+
+		testRtpStreamListener2.retransmittedPackets.clear();
+
+		CheckRtxPacket(rtxPacket1, packet1->GetSequenceNumber(), packet1->GetTimestamp());
+		REQUIRE(rtxPacket1->GetSsrc() == params2.ssrc);
+		CheckRtxPacket(rtxPacket2, packet2->GetSequenceNumber(), packet2->GetTimestamp());
+		REQUIRE(rtxPacket2->GetSsrc() == params2.ssrc);
+
+		// Packets removed from the history are no longer retransmitted.
+		packetHistory.Clear();
+
+		stream1->ReceiveNack(&nackPacket);
+
+		REQUIRE(testRtpStreamListener1.retransmittedPackets.empty());
+
+		delete stream1;
+		delete stream2;
+	}
+
 	SECTION("packets get retransmitted as long as they don't exceed MaxRetransmissionDelay")
 	{
 		uint32_t clockRate = 90000;
@@ -421,6 +622,59 @@ SCENARIO("NACK and RTP packets retransmission", "[rtp][rtcp][nack]")
 		delete stream;
 	}
 
+	SECTION("retransmission buffer grows to cover MaxRetransmissionDelay at high packet rates")
+	{
+		// One packet per ms during 3 seconds, starting close to the seq wrap.
+		uint32_t clockRate    = 90000;
+		uint16_t firstSeq     = 65000;
+		uint32_t firstTs      = 1533790901;
+		size_t numPackets     = 3000;
+		uint16_t requestedSeq = firstSeq + 1500;
+
+		auto packet = CreateRtpPacket(rtpBuffer1, firstSeq, firstTs);
+
+		// Create a RtpStreamSend instance.
+		TestRtpStreamListener testRtpStreamListener1;
+
+		RtpStream::Params params1;
+
+		params1.ssrc          = 1111;
+		params1.clockRate     = clockRate;
+		params1.useNack       = true;
+		params1.mimeType.type = RTC::RtpCodecMimeType::Type::VIDEO;
+
+		std::string mid;
+		RtpStreamSend* stream = new RtpStreamSend(&testRtpStreamListener1, params1, mid);
+
+		for (size_t i{ 0u }; i < numPackets; ++i)
+		{
+			packet->SetSequenceNumber(static_cast<uint16_t>(firstSeq + i));
+			packet->SetTimestamp(static_cast<uint32_t>(firstTs + i * clockRate / 1000));
+
+			SendRtpPacket({ { stream, params1.ssrc } }, packet);
+		}
+
+		// Request a packet sent 1.5 seconds ago and the one sent 2.5 seconds ago.
+		RTCP::FeedbackRtpNackPacket nackPacket(0, params1.ssrc);
+
+		nackPacket.AddItem(new RTCP::FeedbackRtpNackItem(requestedSeq, 0b0000000000000000));
+		nackPacket.AddItem(new RTCP::FeedbackRtpNackItem(firstSeq + 500, 0b0000000000000000));
+
+		stream->ReceiveNack(&nackPacket);
+
+		REQUIRE(testRtpStreamListener1.retransmittedPackets.size() == 1);
+
+		auto rtxPacket = testRtpStreamListener1.retransmittedPackets[0];
+
+		testRtpStreamListener1.retransmittedPackets.clear();
+
+		CheckRtxPacket(rtxPacket, requestedSeq, firstTs + 1500 * clockRate / 1000);
+
+		delete stream;
+
+		RTC::RtpPacket::Deallocate(packet);
+	}
+
 #ifdef PERFORMANCE_TEST
 	SECTION("Performance")
 	{
@@ -447,7 +701,7 @@ SCENARIO("NACK and RTP packets retransmission", "[rtp][rtcp][nack]")
 
 		for (size_t i = 0; i < iterations; i++)
 		{
-			std::shared_ptr<RtpPacket> sharedPacket;
+			SharedRtpPacket sharedPacket;
 
 			stream->ReceivePacket(packet, sharedPacket);
 			stream->Pause();
@@ -468,7 +722,7 @@ SCENARIO("NACK and RTP packets retransmission", "[rtp][rtcp][nack]")
 
 		for (size_t i = 0; i < iterations; i++)
 		{
-			std::shared_ptr<RtpPacket> sharedPacket;
+			SharedRtpPacket sharedPacket;
 
 			stream->ReceivePacket(packet, sharedPacket);
 			stream->Pause();
@@ -483,4 +737,140 @@ SCENARIO("NACK and RTP packets retransmission", "[rtp][rtcp][nack]")
 		RTC::RtpPacket::Deallocate(packet);
 	}
 #endif
+
+#ifdef RETRANSMISSION_BENCHMARK
+	SECTION("Retransmission benchmark")
+	{
+		TestRtpStreamListener testRtpStreamListener;
+
+		RtpStream::Params params;
+
+		params.clockRate     = 90000;
+		params.useNack       = true;
+		params.mimeType.type = RTC::RtpCodecMimeType::Type::VIDEO;
+
+		std::string mid;
+
+		// Clone/store/free churn: a packet cloned once is stored by several NACK
+		// enabled streams, and old packets are freed once out of their storage.
+		std::vector<std::pair<RtpStreamSend*, uint32_t>> streams;
+
+		auto* packet = RtpPacket::Parse(rtpBuffer1, 1500);
+
+		for (uint32_t ssrc{ 2222 }; ssrc < 2226; ++ssrc)
+		{
+			params.ssrc = ssrc;
+			streams.emplace_back(new RtpStreamSend(&testRtpStreamListener, params, mid), ssrc);
+		}
+
+		size_t iterations = 1000000;
+
+		auto start = std::chrono::system_clock::now();
+
+		for (size_t i = 0; i < iterations; i++)
+		{
+			packet->SetSequenceNumber(static_cast<uint16_t>(i));
+			// One packet per ms, as a high bitrate video stream.
+			packet->SetTimestamp(static_cast<uint32_t>(i * 90));
+
+			SendRtpPacket(streams, packet);
+		}
+
+		std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+		std::cout << iterations << " video RtpPackets cloned, stored and freed in \t" << dur.count()
+		          << " seconds for " << streams.size() << " NACK enabled streams" << std::endl;
+
+		// NACK bursts on a high packet rate stream: lookups spread over the whole
+		// retransmission buffer.
+		uint16_t nackSeq{ 0u };
+		size_t bursts{ 100000 };
+		std::vector<RTCP::FeedbackRtpNackPacket*> nackPackets;
+
+		for (size_t i = 0; i < 64; i++)
+		{
+			auto* nackPacket = new RTCP::FeedbackRtpNackPacket(0, 2222);
+
+			for (size_t j = 0; j < 8; j++)
+			{
+				nackSeq = static_cast<uint16_t>(iterations - 2000 + ((i * 8 + j) * 37) % 1900);
+
+				nackPacket->AddItem(new RTCP::FeedbackRtpNackItem(nackSeq, 0b1010101010101010));
+			}
+
+			nackPackets.push_back(nackPacket);
+		}
+
+		start = std::chrono::system_clock::now();
+
+		for (size_t i = 0; i < bursts; i++)
+		{
+			streams[0].first->ReceiveNack(nackPackets[i % nackPackets.size()]);
+			testRtpStreamListener.retransmittedPackets.clear();
+		}
+
+		dur = std::chrono::system_clock::now() - start;
+		std::cout << bursts << " NACK bursts of 72 packets served in \t" << dur.count()
+		          << " seconds for a NACK enabled stream" << std::endl;
+
+		for (auto* nackPacket : nackPackets)
+		{
+			delete nackPacket;
+		}
+
+		for (auto& stream : streams)
+		{
+			delete stream.first;
+		}
+
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+		// Memory of 1 producer to N consumers: 2 seconds of packets (one per ms)
+		// stored by each consumer, first with the packets held by each consumer
+		// and then with a packet history shared by all of them.
+		auto getHeapBytes = []() -> size_t
+		{
+			auto info = mallinfo2();
+
+			return info.uordblks + info.hblkhd;
+		};
+
+		size_t numConsumers{ 500u };
+
+		for (auto shared : { false, true })
+		{
+			RtpPacketHistory packetHistory(RtpStreamSend::MaxRetransmissionDelay);
+			size_t heapBytes = getHeapBytes();
+
+			streams.clear();
+
+			for (size_t i{ 0u }; i < numConsumers; ++i)
+			{
+				params.ssrc = static_cast<uint32_t>(3000 + i);
+				streams.emplace_back(new RtpStreamSend(&testRtpStreamListener, params, mid), params.ssrc);
+
+				if (shared)
+					streams.back().first->SetRtpPacketHistory(&packetHistory);
+			}
+
+			for (size_t i = 0; i < 2000; i++)
+			{
+				packet->SetSequenceNumber(static_cast<uint16_t>(i));
+				packet->SetTimestamp(static_cast<uint32_t>(i * 90));
+
+				SendRtpPacket(streams, packet);
+			}
+
+			std::cout << "2000 video RtpPackets stored by " << numConsumers << " consumers using "
+			          << (getHeapBytes() - heapBytes) / numConsumers << " bytes per consumer with "
+			          << (shared ? "a shared packet history" : "own packets") << std::endl;
+
+			for (auto& stream : streams)
+			{
+				delete stream.first;
+			}
+		}
+#endif
+
+		RTC::RtpPacket::Deallocate(packet);
+	}
+#endif
 }
@@ -0,0 +1,435 @@
+#include "common.hpp"
+#include "NetworkLink.hpp"
+#include "Utils.hpp"
+#include "RTC/RTCP/FeedbackRtpTransport.hpp"
+#include "RTC/RTCP/ReceiverReport.hpp"
+#include "RTC/SenderBandwidthEstimator.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm> // std::min(), std::max()
+#include <deque>
+#include <memory> // std::unique_ptr
+#include <vector>
+
+using namespace RTC;
+
+static constexpr uint32_t SenderSsrc{ 1111u };
+static constexpr uint32_t MediaSsrc{ 2222u };
+static constexpr size_t MaxRtcpPacketLen{ 1200u };
+
+class TestSenderBweListener : public SenderBandwidthEstimator::Listener
+{
+public:
+	void OnSenderBandwidthEstimatorAvailableBitrate(
+	  SenderBandwidthEstimator* /*senderBwe*/,
+	  uint32_t availableBitrate,
+	  uint32_t /*previousAvailableBitrate*/) override
+	{
+		this->numEvents++;
+		this->availableBitrate = availableBitrate;
+	}
+
+public:
+	size_t numEvents{ 0u };
+	uint32_t availableBitrate{ 0u };
+};
+
+// Replays a packet trace through a Bench::NetworkLink (the link emulator of
+// the network scenario of mediasoup-worker-bench). Packets of the trace are only
+// sent if the current estimation allows it (as an encoder would do), and the
+// receiver sends transport-cc feedback (every 100 ms) or RTCP Receiver Reports
+// (every second) back to the estimator. Everything happens in simulated time.
+class TestSimulation
+{
+public:
+	struct TracePacket
+	{
+		uint64_t atMs;
+		size_t size;
+	};
+
+	struct Feedback
+	{
+		uint64_t arrivalAtMs;
+		std::unique_ptr<RTCP::FeedbackRtpTransportPacket> packet;
+	};
+
+	struct Report
+	{
+		uint64_t arrivalAtMs;
+		uint8_t fractionLost;
+		float rtt;
+	};
+
+public:
+	// Constant bitrate trace with packets of the given size.
+	static std::vector<TracePacket> CreateTrace(
+	  uint32_t bitrate, size_t packetSize, uint64_t durationMs)
+	{
+		std::vector<TracePacket> trace;
+		auto intervalMs = static_cast<double>(packetSize) * 8000 / bitrate;
+
+		for (double atMs{ 0 }; atMs < durationMs; atMs += intervalMs)
+		{
+			trace.push_back({ static_cast<uint64_t>(atMs), packetSize });
+		}
+
+		return trace;
+	}
+
+public:
+	TestSimulation(const Bench::NetworkLink::Options& linkOptions, bool useTransportFeedback)
+	  : link(linkOptions), senderBwe(std::addressof(listener), 600000u),
+	    useTransportFeedback(useTransportFeedback), delayMs(linkOptions.delayMs)
+	{
+		this->senderBwe.TransportConnected(this->nowMs);
+	}
+
+public:
+	// Runs the trace until the given time and returns the bytes received in
+	// that period.
+	size_t Run(const std::vector<TracePacket>& trace, uint64_t untilMs)
+	{
+		size_t receivedBytes{ 0u };
+
+		for (; this->nowMs < untilMs; ++this->nowMs)
+		{
+			// Refill the budget given by the estimation, allowing short bursts.
+			auto bitrate = this->senderBwe.GetAvailableBitrate();
+
+			this->budget =
+			  std::min(this->budget + (bitrate / 8000.0), std::max(bitrate / 8000.0 * 20, 1500.0));
+
+			for (; this->traceIdx < trace.size(); ++this->traceIdx)
+			{
+				if (trace[this->traceIdx].atMs > this->nowMs)
+					break;
+
+				auto size = trace[this->traceIdx].size;
+
+				if (this->budget < size)
+					continue;
+
+				this->budget -= size;
+
+				SendPacket(size);
+			}
+
+			this->link.Process(this->nowMs * 1000u);
+			this->link.Receive(
+			  this->nowMs * 1000u,
+			  [this, &receivedBytes](const uint8_t* data, size_t len)
+			  {
+				  receivedBytes += len;
+
+				  ReceivePacket(data);
+			  });
+
+			if (this->useTransportFeedback && this->nowMs % 100u == 0u)
+				SendFeedback();
+			else if (!this->useTransportFeedback && this->nowMs % 1000u == 0u)
+				SendReport();
+
+			while (!this->feedbacks.empty() && this->feedbacks.front().arrivalAtMs <= this->nowMs)
+			{
+				this->senderBwe.ReceiveRtcpTransportFeedback(
+				  this->feedbacks.front().packet.get(), this->nowMs);
+
+				this->feedbacks.pop_front();
+			}
+
+			while (!this->reports.empty() && this->reports.front().arrivalAtMs <= this->nowMs)
+			{
+				RTCP::ReceiverReportPacket packet;
+				auto* report = new RTCP::ReceiverReport();
+
+				report->SetSsrc(MediaSsrc);
+				report->SetFractionLost(this->reports.front().fractionLost);
+				packet.AddReport(report);
+
+				this->senderBwe.ReceiveRtcpReceiverReport(
+				  std::addressof(packet), this->reports.front().rtt, this->nowMs);
+
+				this->reports.pop_front();
+			}
+		}
+
+		return receivedBytes;
+	}
+
+private:
+	void SendPacket(size_t size)
+	{
+		SenderBandwidthEstimator::SentInfo sentInfo;
+
+		sentInfo.wideSeq     = ++this->sentWideSeq;
+		sentInfo.hasWideSeq  = this->useTransportFeedback;
+		sentInfo.size        = size;
+		sentInfo.sendingAtMs = this->nowMs;
+		sentInfo.sentAtMs    = this->nowMs;
+
+		this->senderBwe.RtpPacketSent(sentInfo);
+
+		// The packet carries its wide sequence number and sending time.
+		uint8_t data[RTC::MtuSize] = { 0 };
+
+		Utils::Byte::Set2Bytes(data, 0, sentInfo.wideSeq);
+		Utils::Byte::Set8Bytes(data, 2, this->nowMs);
+
+		this->link.Send(data, size, this->nowMs * 1000u);
+	}
+
+	void ReceivePacket(const uint8_t* data)
+	{
+		auto wideSeq      = Utils::Byte::Get2Bytes(data, 0);
+		auto sentAtMs     = Utils::Byte::Get8Bytes(data, 2);
+		auto receivedAtMs = this->nowMs;
+
+		this->numReceivedPackets++;
+		this->highestReceivedWideSeq = wideSeq;
+		this->lastPacketDelayMs      = receivedAtMs - sentAtMs;
+
+		if (!this->useTransportFeedback)
+			return;
+
+		if (!this->feedback)
+			CreateFeedback();
+
+		auto result = this->feedback->AddPacket(wideSeq, receivedAtMs, MaxRtcpPacketLen);
+
+		if (result == RTCP::FeedbackRtpTransportPacket::AddPacketResult::MAX_SIZE_EXCEEDED)
+		{
+			SendFeedback();
+
+			this->feedback->AddPacket(wideSeq, receivedAtMs, MaxRtcpPacketLen);
+		}
+
+		REQUIRE(result != RTCP::FeedbackRtpTransportPacket::AddPacketResult::FATAL);
+
+		this->latestWideSeq      = wideSeq;
+		this->latestReceivedAtMs = receivedAtMs;
+
+		if (this->feedback->IsFull())
+			SendFeedback();
+	}
+
+	void CreateFeedback()
+	{
+		this->feedback.reset(new RTCP::FeedbackRtpTransportPacket(SenderSsrc, MediaSsrc));
+		this->feedback->SetFeedbackPacketCount(this->feedbackPacketCount++);
+
+		// As TransportCongestionControlServer does, the latest received packet of
+		// the previous feedback is the base of the new one.
+		if (this->latestReceivedAtMs != 0u)
+			this->feedback->AddPacket(this->latestWideSeq, this->latestReceivedAtMs, MaxRtcpPacketLen);
+	}
+
+	void SendFeedback()
+	{
+		if (!this->feedback || this->feedback->GetLatestSequenceNumber() == this->latestSentFeedbackSeq)
+			return;
+
+		this->latestSentFeedbackSeq = this->feedback->GetLatestSequenceNumber();
+
+		this->feedback->Finish();
+
+		uint8_t buffer[MaxRtcpPacketLen];
+		auto len = this->feedback->Serialize(buffer);
+
+		// Parse it so packet results are given as for a received feedback.
+		std::unique_ptr<RTCP::FeedbackRtpTransportPacket> packet(
+		  RTCP::FeedbackRtpTransportPacket::Parse(buffer, len));
+
+		REQUIRE(packet != nullptr);
+
+		this->feedbacks.push_back(
+		  { this->nowMs + this->delayMs, std::move(packet) });
+
+		CreateFeedback();
+	}
+
+	void SendReport()
+	{
+		uint16_t expected = this->highestReceivedWideSeq - this->reportedWideSeq;
+		auto received     = this->numReceivedPackets - this->numReportedPackets;
+		uint8_t fractionLost{ 0u };
+
+		if (expected != 0u && received < expected)
+		{
+			fractionLost =
+			  static_cast<uint8_t>(std::min<size_t>((expected - received) * 256 / expected, 255u));
+		}
+
+		this->reportedWideSeq    = this->highestReceivedWideSeq;
+		this->numReportedPackets = this->numReceivedPackets;
+
+		// The Sender Report used for the RTT is queued as media is.
+		auto rtt = static_cast<float>(this->lastPacketDelayMs + this->delayMs);
+
+		this->reports.push_back(
+		  { this->nowMs + this->delayMs, fractionLost, rtt });
+	}
+
+public:
+	Bench::NetworkLink link;
+	TestSenderBweListener listener;
+	SenderBandwidthEstimator senderBwe;
+
+private:
+	bool useTransportFeedback{ false };
+	uint64_t delayMs{ 0u };
+	uint64_t nowMs{ 1u };
+	double budget{ 0 };
+	size_t traceIdx{ 0u };
+	uint16_t sentWideSeq{ 0u };
+	std::deque<Feedback> feedbacks;
+	std::deque<Report> reports;
+	// Receiver side.
+	size_t numReceivedPackets{ 0u };
+	uint16_t highestReceivedWideSeq{ 0u };
+	double lastPacketDelayMs{ 0 };
+	std::unique_ptr<RTCP::FeedbackRtpTransportPacket> feedback;
+	uint8_t feedbackPacketCount{ 0u };
+	uint16_t latestWideSeq{ 0u };
+	uint64_t latestReceivedAtMs{ 0u };
+	uint16_t latestSentFeedbackSeq{ 0u };
+	uint16_t reportedWideSeq{ 0u };
+	size_t numReportedPackets{ 0u };
+};
+
+SCENARIO("SenderBandwidthEstimator", "[rtp][bwe]")
+{
+	auto trace = TestSimulation::CreateTrace(5000000u, 1200u, 120000u);
+
+	SECTION("converges to the link capacity with transport-cc feedback")
+	{
+		Bench::NetworkLink::Options linkOptions;
+
+		linkOptions.capacity = 1500000u;
+
+		TestSimulation simulation(linkOptions, true);
+
+		simulation.Run(trace, 40000u);
+
+		// Last 20 seconds.
+		auto receivedBytes = simulation.Run(trace, 60000u);
+		auto bitrate       = simulation.senderBwe.GetAvailableBitrate();
+
+		REQUIRE(bitrate >= 1000000u);
+		REQUIRE(bitrate <= 1800000u);
+		REQUIRE(receivedBytes * 8 / 20 >= 1500000u * 0.75);
+		REQUIRE(simulation.listener.numEvents > 0u);
+		REQUIRE(simulation.listener.availableBitrate > 0u);
+	}
+
+	SECTION("converges to the link capacity with Receiver Reports")
+	{
+		Bench::NetworkLink::Options linkOptions;
+
+		linkOptions.capacity = 1500000u;
+
+		TestSimulation simulation(linkOptions, false);
+
+		REQUIRE(!simulation.senderBwe.IsUsingTransportFeedback());
+
+		simulation.Run(trace, 40000u);
+
+		auto receivedBytes = simulation.Run(trace, 60000u);
+		auto bitrate       = simulation.senderBwe.GetAvailableBitrate();
+
+		REQUIRE(bitrate >= 1000000u);
+		REQUIRE(bitrate <= 1800000u);
+		REQUIRE(receivedBytes * 8 / 20 >= 1500000u * 0.7);
+	}
+
+	SECTION("backs off when the link capacity decreases")
+	{
+		for (auto useTransportFeedback : { true, false })
+		{
+			Bench::NetworkLink::Options linkOptions;
+
+			linkOptions.capacity = 2000000u;
+
+			TestSimulation simulation(linkOptions, useTransportFeedback);
+
+			simulation.Run(trace, 40000u);
+
+			REQUIRE(simulation.senderBwe.GetAvailableBitrate() >= 1300000u);
+
+			simulation.link.SetCapacity(500000u);
+			simulation.Run(trace, 50000u);
+
+			REQUIRE(simulation.senderBwe.GetAvailableBitrate() <= 650000u);
+
+			// And it keeps using the link.
+			auto receivedBytes = simulation.Run(trace, 60000u);
+
+			REQUIRE(receivedBytes * 8 / 10 >= 500000u * 0.7);
+		}
+	}
+
+	SECTION("decreases on high random loss and ignores low random loss")
+	{
+		for (auto useTransportFeedback : { true, false })
+		{
+			Bench::NetworkLink::Options linkOptions;
+
+			linkOptions.capacity  = 2000000u;
+			linkOptions.lossRatio = 0.2;
+
+			TestSimulation lossySimulation(linkOptions, useTransportFeedback);
+
+			lossySimulation.Run(trace, 30000u);
+
+			REQUIRE(lossySimulation.senderBwe.GetAvailableBitrate() < 300000u);
+
+			linkOptions.lossRatio = 0.01;
+
+			TestSimulation simulation(linkOptions, useTransportFeedback);
+
+			simulation.Run(trace, 30000u);
+
+			REQUIRE(simulation.senderBwe.GetAvailableBitrate() >= 1000000u);
+		}
+	}
+
+	SECTION("REMB and max bitrate cap the estimation")
+	{
+		Bench::NetworkLink::Options linkOptions;
+
+		linkOptions.capacity = 2000000u;
+
+		TestSimulation simulation(linkOptions, true);
+
+		simulation.senderBwe.ReceiveEstimatedBitrate(400000u, 1u);
+
+		REQUIRE(simulation.senderBwe.GetAvailableBitrate() == 400000u);
+
+		simulation.Run(trace, 20000u);
+
+		REQUIRE(simulation.senderBwe.GetAvailableBitrate() <= 400000u);
+
+		simulation.senderBwe.ReceiveEstimatedBitrate(0u, 20000u);
+		simulation.senderBwe.SetMaxBitrate(800000u);
+		simulation.Run(trace, 40000u);
+
+		REQUIRE(simulation.senderBwe.GetAvailableBitrate() == 800000u);
+	}
+
+	SECTION("simulations are deterministic")
+	{
+		Bench::NetworkLink::Options linkOptions;
+
+		linkOptions.capacity  = 1000000u;
+		linkOptions.lossRatio = 0.05;
+
+		TestSimulation simulation1(linkOptions, true);
+		TestSimulation simulation2(linkOptions, true);
+
+		for (uint64_t untilMs{ 1000u }; untilMs <= 20000u; untilMs += 1000u)
+		{
+			REQUIRE(simulation1.Run(trace, untilMs) == simulation2.Run(trace, untilMs));
+			REQUIRE(
+			  simulation1.senderBwe.GetAvailableBitrate() == simulation2.senderBwe.GetAvailableBitrate());
+		}
+	}
+}
@@ -0,0 +1,269 @@
+#include "common.hpp"
+#include "DepLibUV.hpp"
+#include "Channel/ChannelNotifier.hpp"
+#include "Channel/ChannelRequest.hpp"
+#include "Channel/ChannelSocket.hpp"
+#include "RTC/DirectTransport.hpp"
+#include "RTC/RTCP/Packet.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <catch2/catch.hpp>
+#include <string>
+#include <vector>
+
+using namespace RTC;
+
+static ChannelReadFreeFn channelRead(
+  uint8_t** /*message*/,
+  uint32_t* /*messageLen*/,
+  size_t* /*messageCtx*/,
+  const void* /*handle*/,
+  ChannelReadCtx /*ctx*/)
+{
+	return nullptr;
+}
+
+static void channelWrite(const uint8_t* message, uint32_t messageLen, ChannelWriteCtx ctx)
+{
+	auto* messages = static_cast<std::vector<std::string>*>(ctx);
+
+	messages->emplace_back(reinterpret_cast<const char*>(message), messageLen);
+}
+
+SCENARIO("Transport", "[transport]")
+{
+	class TestTransportListener : public Transport::Listener
+	{
+	public:
+		void OnTransportNewProducer(Transport* /*transport*/, Producer* /*producer*/) override
+		{
+		}
+		void OnTransportProducerClosed(Transport* /*transport*/, Producer* /*producer*/) override
+		{
+		}
+		void OnTransportProducerPaused(Transport* /*transport*/, Producer* /*producer*/) override
+		{
+		}
+		void OnTransportProducerResumed(Transport* /*transport*/, Producer* /*producer*/) override
+		{
+		}
+		void OnTransportProducerNewRtpStream(
+		  Transport* /*transport*/,
+		  Producer* /*producer*/,
+		  RtpStream* /*rtpStream*/,
+		  uint32_t /*mappedSsrc*/) override
+		{
+		}
+		void OnTransportProducerRtpStreamScore(
+		  Transport* /*transport*/,
+		  Producer* /*producer*/,
+		  RtpStream* /*rtpStream*/,
+		  uint8_t /*score*/,
+		  uint8_t /*previousScore*/) override
+		{
+		}
+		void OnTransportProducerRtcpSenderReport(
+		  Transport* /*transport*/, Producer* /*producer*/, RtpStream* /*rtpStream*/, bool /*first*/) override
+		{
+			this->events.emplace_back("sr");
+		}
+		void OnTransportProducerRtpPacketReceived(
+		  Transport* /*transport*/, Producer* /*producer*/, RtpPacket* packet) override
+		{
+			this->events.emplace_back("rtp:" + std::to_string(packet->GetSequenceNumber()));
+		}
+		void OnTransportNeedWorstRemoteFractionLost(
+		  Transport* /*transport*/,
+		  Producer* /*producer*/,
+		  uint32_t /*mappedSsrc*/,
+		  uint8_t& /*worstRemoteFractionLost*/) override
+		{
+		}
+		void OnTransportNewConsumer(
+		  Transport* /*transport*/, Consumer* /*consumer*/, std::string& /*producerId*/) override
+		{
+		}
+		void OnTransportConsumerClosed(Transport* /*transport*/, Consumer* /*consumer*/) override
+		{
+		}
+		void OnTransportConsumerProducerClosed(Transport* /*transport*/, Consumer* /*consumer*/) override
+		{
+		}
+		void OnTransportConsumerKeyFrameRequested(
+		  Transport* /*transport*/, Consumer* /*consumer*/, uint32_t /*mappedSsrc*/) override
+		{
+		}
+		void OnTransportNewDataProducer(Transport* /*transport*/, DataProducer* /*dataProducer*/) override
+		{
+		}
+		void OnTransportDataProducerClosed(Transport* /*transport*/, DataProducer* /*dataProducer*/) override
+		{
+		}
+		void OnTransportDataProducerMessageReceived(
+		  Transport* /*transport*/,
+		  DataProducer* /*dataProducer*/,
+		  uint32_t /*ppid*/,
+		  const uint8_t* /*msg*/,
+		  size_t /*len*/) override
+		{
+		}
+		void OnTransportNewDataConsumer(
+		  Transport* /*transport*/,
+		  DataConsumer* /*dataConsumer*/,
+		  std::string& /*dataProducerId*/) override
+		{
+		}
+		void OnTransportDataConsumerClosed(Transport* /*transport*/, DataConsumer* /*dataConsumer*/) override
+		{
+		}
+		void OnTransportDataConsumerDataProducerClosed(
+		  Transport* /*transport*/, DataConsumer* /*dataConsumer*/) override
+		{
+		}
+		void OnTransportListenServerClosed(Transport* /*transport*/) override
+		{
+		}
+
+	public:
+		std::vector<std::string> events;
+	};
+
+	// Gives access to the receiving methods of RTC::Transport.
+	class TestTransport : public DirectTransport
+	{
+	public:
+		TestTransport(const std::string& id, Transport::Listener* listener, json& data)
+		  : DirectTransport(id, listener, data)
+		{
+		}
+
+	public:
+		void ReceiveRtp(RtpPacket* packet)
+		{
+			ReceiveRtpPacket(packet);
+		}
+		void ReceiveRtcp(RTCP::Packet* packet)
+		{
+			ReceiveRtcpPacket(packet);
+		}
+	};
+
+	std::vector<std::string> messages;
+	Channel::ChannelSocket channel(channelRead, nullptr, channelWrite, &messages);
+	TestTransportListener listener;
+	json transportData = json::object();
+
+	Channel::ChannelNotifier::ClassInit(&channel);
+
+	TestTransport transport("transport1", &listener, transportData);
+
+	// clang-format off
+	std::string produceData = json{
+		{ "producerId", "producer1" },
+		{ "kind", "audio" },
+		{ "paused", false },
+		{
+			"rtpParameters",
+			{
+				{ "codecs", { { { "mimeType", "audio/opus" }, { "payloadType", 100 }, { "clockRate", 48000 }, { "channels", 2 } } } },
+				{ "headerExtensions", json::array() },
+				{ "encodings", { { { "ssrc", 1111 } } } },
+				{ "rtcp", { { "cname", "foo" } } }
+			}
+		},
+		{
+			"rtpMapping",
+			{
+				{ "codecs", { { { "payloadType", 100 }, { "mappedPayloadType", 100 } } } },
+				{ "encodings", { { { "ssrc", 1111 }, { "mappedSsrc", 2222 } } } }
+			}
+		}
+	}.dump();
+	// clang-format on
+
+	std::string produceMessage = "1:transport.produce:transport1:" + produceData;
+	Channel::ChannelRequest produceRequest(&channel, produceMessage.data(), produceMessage.size());
+
+	transport.HandleRequest(&produceRequest);
+
+	REQUIRE(messages.size() == 1);
+	REQUIRE(json::parse(messages[0])["accepted"] == true);
+
+	// clang-format off
+	uint8_t rtpBuffer1[] =
+	{
+		0x80, 0x64, 0x00, 0x01, // PT:100, Seq:1
+		0x00, 0x00, 0x00, 0x01, // Timestamp:1
+		0x00, 0x00, 0x04, 0x57, // SSRC:1111
+		0x01, 0x02, 0x03, 0x04  // Payload
+	};
+	uint8_t rtpBuffer2[] =
+	{
+		0x80, 0x64, 0x00, 0x02, // PT:100, Seq:2
+		0x00, 0x00, 0x03, 0xC1, // Timestamp:961
+		0x00, 0x00, 0x04, 0x57, // SSRC:1111
+		0x01, 0x02, 0x03, 0x04  // Payload
+	};
+	uint8_t rtpBuffer3[] =
+	{
+		0x80, 0x64, 0x00, 0x03, // PT:100, Seq:3
+		0x00, 0x00, 0x07, 0x81, // Timestamp:1921
+		0x00, 0x00, 0x04, 0x57, // SSRC:1111
+		0x01, 0x02, 0x03, 0x04  // Payload
+	};
+	uint8_t srBuffer[] =
+	{
+		0x80, 0xC8, 0x00, 0x06, // PT:200 (SR), Length:6
+		0x00, 0x00, 0x04, 0x57, // SSRC:1111
+		0xE5, 0xC1, 0x7E, 0xB4, // NTP sec
+		0x00, 0x00, 0x00, 0x00, // NTP frac
+		0x00, 0x00, 0x03, 0xC1, // RTP timestamp:961
+		0x00, 0x00, 0x00, 0x02, // Packet count:2
+		0x00, 0x00, 0x00, 0x08  // Octet count:8
+	};
+	// clang-format on
+
+	SECTION("RTP packets received before a RTCP packet in a batch are processed first")
+	{
+		transport.StartRecvBatch();
+
+		transport.ReceiveRtp(RtpPacket::Parse(rtpBuffer1, sizeof(rtpBuffer1)));
+		transport.ReceiveRtp(RtpPacket::Parse(rtpBuffer2, sizeof(rtpBuffer2)));
+
+		// RTP packets are kept until the batch ends.
+		REQUIRE(listener.events.empty());
+
+		// The Sender Report is only delivered if the RTP stream already exists, so
+		// the RTP packets must be processed before it.
+		transport.ReceiveRtcp(RTCP::Packet::Parse(srBuffer, sizeof(srBuffer)));
+
+		REQUIRE(listener.events == std::vector<std::string>{ "rtp:1", "rtp:2", "sr" });
+
+		transport.ReceiveRtp(RtpPacket::Parse(rtpBuffer3, sizeof(rtpBuffer3)));
+
+		REQUIRE(listener.events.size() == 3);
+
+		transport.EndRecvBatch(4u);
+
+		REQUIRE(listener.events == std::vector<std::string>{ "rtp:1", "rtp:2", "sr", "rtp:3" });
+	}
+
+	SECTION("RTP packets are processed immediately out of a batch")
+	{
+		transport.ReceiveRtp(RtpPacket::Parse(rtpBuffer1, sizeof(rtpBuffer1)));
+
+		REQUIRE(listener.events == std::vector<std::string>{ "rtp:1" });
+
+		transport.ReceiveRtcp(RTCP::Packet::Parse(srBuffer, sizeof(srBuffer)));
+		transport.ReceiveRtp(RtpPacket::Parse(rtpBuffer2, sizeof(rtpBuffer2)));
+
+		REQUIRE(listener.events == std::vector<std::string>{ "rtp:1", "sr", "rtp:2" });
+	}
+
+	transport.CloseProducersAndConsumers();
+
+	Channel::ChannelNotifier::ClassInit(nullptr);
+	channel.Close();
+
+	// Run the close callback of the channel.
+	uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+}
@@ -0,0 +1,192 @@
+#include "common.hpp"
+#include "DepLibUV.hpp"
+#include "Utils.hpp"
+#include "RTC/WebRtcServerShardGroup.hpp"
+#include <catch2/catch.hpp>
+#include <cstring> // std::memcmp()
+#include <memory>
+#include <vector>
+
+using namespace RTC;
+
+SCENARIO("WebRtcServerShardGroup", "[webrtcserver][shard]")
+{
+	class TestListener : public WebRtcServerShardGroup::Listener
+	{
+	public:
+		struct Packet
+		{
+			size_t socketIdx;
+			std::vector<uint8_t> data;
+			struct sockaddr_storage remoteAddr;
+		};
+
+	public:
+		void OnWebRtcServerShardGroupPacketForwarded(
+		  size_t socketIdx, const uint8_t* data, size_t len, const struct sockaddr* remoteAddr) override
+		{
+			this->packets.push_back(
+			  { socketIdx, std::vector<uint8_t>(data, data + len), Utils::IP::CopyAddress(remoteAddr) });
+		}
+
+	public:
+		std::vector<Packet> packets;
+	};
+
+	TestListener listener1;
+	TestListener listener2;
+	std::shared_ptr<WebRtcServerShardGroup::Shard> shard1;
+	std::shared_ptr<WebRtcServerShardGroup::Shard> shard2;
+
+	auto* group = WebRtcServerShardGroup::Join("test", &listener1, []() {}, shard1);
+
+	REQUIRE(WebRtcServerShardGroup::Join("test", &listener2, []() {}, shard2) == group);
+
+	SECTION("username fragments are looked up in the cache of each shard")
+	{
+		// Unknown username fragment.
+		REQUIRE(group->GetUsernameFragmentShard(shard1, "foo") == nullptr);
+		REQUIRE(group->GetUsernameFragmentShard(shard1, "foo") == nullptr);
+
+		// Adding it must drop the negative entry cached by shard1.
+		group->AddUsernameFragment("foo", shard2);
+
+		REQUIRE(group->GetUsernameFragmentShard(shard1, "foo") == shard2);
+		REQUIRE(group->GetUsernameFragmentShard(shard1, "foo") == shard2);
+		// A shard does not return itself.
+		REQUIRE(group->GetUsernameFragmentShard(shard2, "foo") == nullptr);
+
+		group->AddUsernameFragment("bar", shard2);
+		REQUIRE(group->GetUsernameFragmentShard(shard1, "bar") == shard2);
+
+		group->RemoveUsernameFragment("foo");
+
+		REQUIRE(group->GetUsernameFragmentShard(shard1, "foo") == nullptr);
+		REQUIRE(group->GetUsernameFragmentShard(shard1, "bar") == shard2);
+	}
+
+	SECTION("tuples are looked up in the cache of each shard")
+	{
+		REQUIRE(group->GetTupleShard(shard1, 1111u) == nullptr);
+
+		group->AddTuple(1111u, shard2);
+		group->AddTuple(2222u, shard1);
+
+		REQUIRE(group->GetTupleShard(shard1, 1111u) == shard2);
+		REQUIRE(group->GetTupleShard(shard2, 2222u) == shard1);
+		REQUIRE(group->GetTupleShard(shard1, 2222u) == nullptr);
+
+		group->RemoveTuple(2222u);
+
+		// Removing a tuple must not affect other tuples.
+		REQUIRE(group->GetTupleShard(shard1, 1111u) == shard2);
+		REQUIRE(group->GetTupleShard(shard2, 2222u) == nullptr);
+
+		group->RemoveTuple(1111u);
+
+		REQUIRE(group->GetTupleShard(shard1, 1111u) == nullptr);
+	}
+
+	SECTION("forwarded packets are delivered in the loop of the shard")
+	{
+		struct sockaddr_storage remoteAddr;
+		uint8_t data[] = { 1, 2, 3, 4, 5 };
+
+		auto* remoteAddrIn = reinterpret_cast<struct sockaddr_in*>(&remoteAddr);
+
+		std::memset(&remoteAddr, 0, sizeof(remoteAddr));
+		remoteAddrIn->sin_family = AF_INET;
+		remoteAddrIn->sin_port   = htons(1234);
+		uv_inet_pton(AF_INET, "1.2.3.4", &remoteAddrIn->sin_addr);
+
+		REQUIRE(WebRtcServerShardGroup::Forward(
+		  shard2, 1u, data, sizeof(data), reinterpret_cast<struct sockaddr*>(&remoteAddr)));
+		REQUIRE(WebRtcServerShardGroup::Forward(
+		  shard2, 0u, data, 2u, reinterpret_cast<struct sockaddr*>(&remoteAddr)));
+
+		REQUIRE(listener2.packets.empty());
+
+		uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+
+		REQUIRE(listener1.packets.empty());
+		REQUIRE(listener2.packets.size() == 2);
+		REQUIRE(listener2.packets[0].socketIdx == 1u);
+		REQUIRE(listener2.packets[0].data.size() == sizeof(data));
+		REQUIRE(std::memcmp(listener2.packets[0].data.data(), data, sizeof(data)) == 0);
+		REQUIRE(Utils::IP::CompareAddresses(
+		  reinterpret_cast<struct sockaddr*>(&listener2.packets[0].remoteAddr),
+		  reinterpret_cast<struct sockaddr*>(&remoteAddr)));
+		REQUIRE(listener2.packets[1].socketIdx == 0u);
+		REQUIRE(listener2.packets[1].data.size() == 2u);
+	}
+
+	SECTION("forwarded packets are dropped if the inbox of the shard is full")
+	{
+		struct sockaddr_storage remoteAddr;
+		uint8_t data[2049] = { 0 };
+
+		auto* remoteAddrIn = reinterpret_cast<struct sockaddr_in*>(&remoteAddr);
+
+		std::memset(&remoteAddr, 0, sizeof(remoteAddr));
+		remoteAddrIn->sin_family = AF_INET;
+		remoteAddrIn->sin_port   = htons(1234);
+
+		const size_t maxInboxPackets{ WebRtcServerShardGroup::MaxInboxPackets };
+
+		// Too big.
+		REQUIRE(!WebRtcServerShardGroup::Forward(
+		  shard2, 0u, data, sizeof(data), reinterpret_cast<struct sockaddr*>(&remoteAddr)));
+
+		for (size_t i{ 0u }; i < maxInboxPackets; ++i)
+		{
+			REQUIRE(WebRtcServerShardGroup::Forward(
+			  shard2, 0u, data, 100u, reinterpret_cast<struct sockaddr*>(&remoteAddr)));
+		}
+
+		REQUIRE(!WebRtcServerShardGroup::Forward(
+		  shard2, 0u, data, 100u, reinterpret_cast<struct sockaddr*>(&remoteAddr)));
+		REQUIRE(!WebRtcServerShardGroup::Forward(
+		  shard2, 0u, data, 100u, reinterpret_cast<struct sockaddr*>(&remoteAddr)));
+		REQUIRE(shard2->GetDroppedPackets() == 2u);
+
+		uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+
+		REQUIRE(listener2.packets.size() == maxInboxPackets);
+
+		// The inbox has room again.
+		REQUIRE(WebRtcServerShardGroup::Forward(
+		  shard2, 0u, data, 100u, reinterpret_cast<struct sockaddr*>(&remoteAddr)));
+		REQUIRE(shard2->GetDroppedPackets() == 2u);
+
+		uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+	}
+
+	SECTION("a shard that left the group does not accept packets")
+	{
+		auto leftShard = shard2;
+		uint8_t data[] = { 1, 2, 3 };
+		struct sockaddr_storage remoteAddr;
+
+		std::memset(&remoteAddr, 0, sizeof(remoteAddr));
+		remoteAddr.ss_family = AF_INET;
+
+		group->AddTuple(3333u, shard2);
+
+		REQUIRE(group->GetTupleShard(shard1, 3333u) == shard2);
+
+		WebRtcServerShardGroup::Leave(group, shard2);
+
+		REQUIRE(!shard2);
+		REQUIRE(group->GetTupleShard(shard1, 3333u) == nullptr);
+		REQUIRE(!WebRtcServerShardGroup::Forward(
+		  leftShard, 0u, data, sizeof(data), reinterpret_cast<struct sockaddr*>(&remoteAddr)));
+	}
+
+	if (shard2)
+		WebRtcServerShardGroup::Leave(group, shard2);
+
+	WebRtcServerShardGroup::Leave(group, shard1);
+
+	// Run the close callbacks of the shards.
+	uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+}
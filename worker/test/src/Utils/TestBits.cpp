@@ -20,3 +20,28 @@ SCENARIO("Utils::Bits::CountSetBits()")
 	mask = 0b1111111111111111;
 	REQUIRE(Utils::Bits::CountSetBits(mask) == 16);
 }
+
+SCENARIO("Utils::Bits::GetHighestSetBit()")
+{
+	REQUIRE(Utils::Bits::GetHighestSetBit(1u) == 0);
+	REQUIRE(Utils::Bits::GetHighestSetBit(2u) == 1);
+	REQUIRE(Utils::Bits::GetHighestSetBit(3u) == 1);
+	REQUIRE(Utils::Bits::GetHighestSetBit(0b1000000000000001) == 15);
+	REQUIRE(Utils::Bits::GetHighestSetBit(0xFFFFFFFFFFFFFFFF) == 63);
+}
+
+SCENARIO("Utils::Bits::GetLowestSetBit()")
+{
+	REQUIRE(Utils::Bits::GetLowestSetBit(1u) == 0);
+	REQUIRE(Utils::Bits::GetLowestSetBit(2u) == 1);
+	REQUIRE(Utils::Bits::GetLowestSetBit(3u) == 0);
+	REQUIRE(Utils::Bits::GetLowestSetBit(0b1000000000000000) == 15);
+	REQUIRE(Utils::Bits::GetLowestSetBit(0x8000000000000000) == 63);
+}
+
+SCENARIO("Utils::Bits::CountSetBits() with 64 bits")
+{
+	REQUIRE(Utils::Bits::CountSetBits(uint64_t{ 0u }) == 0);
+	REQUIRE(Utils::Bits::CountSetBits(uint64_t{ 0x8000000000000001 }) == 2);
+	REQUIRE(Utils::Bits::CountSetBits(uint64_t{ 0xFFFFFFFFFFFFFFFF }) == 64);
+}
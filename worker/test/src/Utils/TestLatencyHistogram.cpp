@@ -0,0 +1,109 @@
+#include "common.hpp"
+#include "Utils.hpp"
+#include <catch2/catch.hpp>
+
+using namespace Utils;
+
+SCENARIO("Utils::LatencyHistogram", "[utils][latency]")
+{
+	SECTION("empty histogram")
+	{
+		LatencyHistogram histogram;
+
+		REQUIRE(histogram.GetCount() == 0);
+		REQUIRE(histogram.GetMin() == 0);
+		REQUIRE(histogram.GetMax() == 0);
+		REQUIRE(histogram.GetMean() == 0);
+		REQUIRE(histogram.GetValueAtPercentile(50) == 0);
+	}
+
+	SECTION("small values are stored exactly")
+	{
+		LatencyHistogram histogram;
+
+		for (uint64_t value{ 1u }; value <= 10u; ++value)
+		{
+			histogram.Record(value);
+		}
+
+		REQUIRE(histogram.GetCount() == 10);
+		REQUIRE(histogram.GetMin() == 1);
+		REQUIRE(histogram.GetMax() == 10);
+		REQUIRE(histogram.GetMean() == 5);
+		REQUIRE(histogram.GetValueAtPercentile(50) == 5);
+		REQUIRE(histogram.GetValueAtPercentile(90) == 9);
+		REQUIRE(histogram.GetValueAtPercentile(100) == 10);
+	}
+
+	SECTION("big values are stored with bounded relative error")
+	{
+		LatencyHistogram histogram;
+
+		for (uint64_t value{ 1000u }; value <= 100000000u; value = value * 3 / 2)
+		{
+			histogram.Reset();
+			histogram.Record(value);
+
+			auto stored = histogram.GetValueAtPercentile(50);
+
+			REQUIRE(stored == value);
+
+			histogram.Record(value + 1);
+			histogram.Record(value + 2);
+
+			stored = histogram.GetValueAtPercentile(1);
+
+			REQUIRE(stored >= value);
+			REQUIRE(stored - value <= value / LatencyHistogram::SubBucketCount);
+		}
+	}
+
+	SECTION("percentiles")
+	{
+		LatencyHistogram histogram;
+
+		// 990 values of 1 us and 10 values of 1 ms.
+		histogram.Record(1000u, 990u);
+		histogram.Record(1000000u, 10u);
+
+		REQUIRE(histogram.GetCount() == 1000);
+		REQUIRE(histogram.GetMin() == 1000);
+		REQUIRE(histogram.GetMax() == 1000000);
+		REQUIRE(histogram.GetMean() == 10990);
+		REQUIRE(histogram.GetValueAtPercentile(50) >= 1000);
+		REQUIRE(histogram.GetValueAtPercentile(50) < 1100);
+		REQUIRE(histogram.GetValueAtPercentile(99) < 1100);
+		REQUIRE(histogram.GetValueAtPercentile(99.9) == 1000000);
+	}
+
+	SECTION("values above MaxValue are clamped")
+	{
+		LatencyHistogram histogram;
+		uint64_t maxValue = LatencyHistogram::MaxValue;
+
+		histogram.Record(static_cast<uint64_t>(-1));
+
+		REQUIRE(histogram.GetMax() == maxValue);
+		REQUIRE(histogram.GetValueAtPercentile(100) == maxValue);
+	}
+
+	SECTION("FillJson()")
+	{
+		LatencyHistogram histogram;
+		json data = json::object();
+
+		histogram.Record(100u);
+		histogram.FillJson(data);
+
+		REQUIRE(data["count"] == 1);
+		REQUIRE(data["min"] == 100);
+		REQUIRE(data["max"] == 100);
+		REQUIRE(data["p50"] == 100);
+		REQUIRE(data["p999"] == 100);
+
+		histogram.Reset();
+
+		REQUIRE(histogram.GetCount() == 0);
+		REQUIRE(histogram.GetMax() == 0);
+	}
+}
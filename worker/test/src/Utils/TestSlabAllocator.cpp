@@ -0,0 +1,86 @@
+#include "common.hpp"
+#include "SlabAllocator.hpp"
+#include <catch2/catch.hpp>
+#include <cstring> // std::memset()
+#include <memory>  // std::allocate_shared()
+#include <vector>
+
+using namespace Utils;
+
+// Type with a size no other test type has, so its SlabPool is only used here.
+struct TestSlabItem
+{
+	uint8_t data[1234];
+};
+
+SCENARIO("Utils::SlabAllocator")
+{
+	auto& allocator = SlabAllocator<TestSlabItem>::Pool;
+
+	SECTION("freed slots are reused")
+	{
+		auto* item1 = allocator.allocate(1);
+
+		allocator.deallocate(item1, 1);
+
+		auto* item2 = allocator.allocate(1);
+
+		REQUIRE(item2 == item1);
+
+		allocator.deallocate(item2, 1);
+	}
+
+	SECTION("empty slabs are returned to the system")
+	{
+		const size_t numSlabs = allocator.GetNumSlabs();
+		std::vector<TestSlabItem*> items;
+
+		for (size_t i{ 0u }; i < 1000u; ++i)
+		{
+			items.push_back(allocator.allocate(1));
+		}
+
+		REQUIRE(allocator.GetNumSlabs() > numSlabs + 1u);
+
+		for (auto* item : items)
+		{
+			allocator.deallocate(item, 1);
+		}
+
+		const size_t maxEmptySlabs = SlabPool<sizeof(TestSlabItem), alignof(TestSlabItem)>::MaxEmptySlabs;
+
+		REQUIRE(allocator.GetNumSlabs() <= maxEmptySlabs);
+	}
+
+	SECTION("slots are aligned and do not overlap")
+	{
+		std::vector<TestSlabItem*> items;
+
+		for (size_t i{ 0u }; i < 100u; ++i)
+		{
+			auto* item = allocator.allocate(1);
+
+			REQUIRE(reinterpret_cast<uintptr_t>(item) % alignof(TestSlabItem) == 0u);
+
+			std::memset(item->data, static_cast<int>(i), sizeof(item->data));
+			items.push_back(item);
+		}
+
+		for (size_t i{ 0u }; i < items.size(); ++i)
+		{
+			REQUIRE(items[i]->data[0] == static_cast<uint8_t>(i));
+			REQUIRE(items[i]->data[sizeof(TestSlabItem::data) - 1] == static_cast<uint8_t>(i));
+
+			allocator.deallocate(items[i], 1);
+		}
+	}
+
+	SECTION("std::allocate_shared() uses the pool of the rebound type")
+	{
+		auto shared = std::allocate_shared<TestSlabItem>(allocator);
+
+		REQUIRE(shared);
+
+		shared.reset();
+	}
+}
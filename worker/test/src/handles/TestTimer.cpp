@@ -0,0 +1,220 @@
+#include "common.hpp"
+#include "DepLibUV.hpp"
+#include "MediaSoupErrors.hpp"
+#include "Settings.hpp"
+#include "handles/Timer.hpp"
+#include "handles/TimerWheel.hpp"
+#include <catch2/catch.hpp>
+#include <vector>
+
+SCENARIO("Timer", "[timer]")
+{
+	class TestTimerListener : public Timer::Listener
+	{
+	public:
+		void OnTimer(Timer* timer) override
+		{
+			this->firedTimers.push_back(timer);
+			this->firedTimesMs.push_back(uv_now(DepLibUV::GetLoop()));
+
+			if (timer == this->timerToStop && this->firedTimers.size() == this->stopAfter)
+				timer->Stop();
+
+			if (this->timerToDelete)
+			{
+				delete this->timerToDelete;
+				this->timerToDelete = nullptr;
+			}
+
+			if (this->timerToStart)
+			{
+				this->timerToStart->Start(0);
+				this->timerToStart = nullptr;
+			}
+
+			if (timer == this->timerToRestart && this->firedTimers.size() < this->restartTimes)
+				timer->Start(0);
+		}
+
+	public:
+		std::vector<Timer*> firedTimers;
+		std::vector<uint64_t> firedTimesMs;
+		Timer* timerToStop{ nullptr };
+		size_t stopAfter{ 0u };
+		Timer* timerToDelete{ nullptr };
+		Timer* timerToStart{ nullptr };
+		Timer* timerToRestart{ nullptr };
+		size_t restartTimes{ 0u };
+	};
+
+	SECTION("timers fire in expiration order and never before their timeout")
+	{
+		TestTimerListener listener;
+		Timer timer1(&listener);
+		Timer timer2(&listener);
+		Timer timer3(&listener);
+		Timer timer4(&listener);
+
+		uv_update_time(DepLibUV::GetLoop());
+
+		auto startMs = uv_now(DepLibUV::GetLoop());
+
+		// 300 ms is beyond the first level of the wheel.
+		timer1.Start(30);
+		timer2.Start(1);
+		timer3.Start(300);
+		timer4.Start(10);
+
+		REQUIRE(timer1.IsActive());
+		REQUIRE(TimerWheel::GetScheduledCount() == 4);
+
+		DepLibUV::RunLoop();
+
+		REQUIRE(TimerWheel::GetScheduledCount() == 0);
+		REQUIRE(!timer1.IsActive());
+		REQUIRE(listener.firedTimers == std::vector<Timer*>{ &timer2, &timer4, &timer1, &timer3 });
+		REQUIRE(listener.firedTimesMs[0] - startMs >= 1);
+		REQUIRE(listener.firedTimesMs[1] - startMs >= 10);
+		REQUIRE(listener.firedTimesMs[2] - startMs >= 30);
+		REQUIRE(listener.firedTimesMs[3] - startMs >= 300);
+	}
+
+	SECTION("repeating timer stopped by its listener")
+	{
+		TestTimerListener listener;
+		Timer timer(&listener);
+
+		listener.timerToStop = &timer;
+		listener.stopAfter   = 3;
+
+		timer.Start(5, 5);
+
+		REQUIRE(timer.GetTimeout() == 5);
+		REQUIRE(timer.GetRepeat() == 5);
+
+		DepLibUV::RunLoop();
+
+		REQUIRE(listener.firedTimers.size() == 3);
+		REQUIRE(!timer.IsActive());
+	}
+
+	SECTION("timer deleted by the listener of a timer expiring in the same tick")
+	{
+		TestTimerListener listener;
+		Timer timer1(&listener);
+		auto* timer2 = new Timer(&listener);
+
+		listener.timerToDelete = timer2;
+
+		timer1.Start(5);
+		timer2->Start(5);
+
+		DepLibUV::RunLoop();
+
+		REQUIRE(listener.firedTimers == std::vector<Timer*>{ &timer1 });
+		REQUIRE(TimerWheel::GetScheduledCount() == 0);
+	}
+
+	SECTION("stopped and restarted timers")
+	{
+		TestTimerListener listener;
+		Timer timer1(&listener);
+		Timer timer2(&listener);
+
+		timer1.Start(5);
+		timer1.Stop();
+		timer2.Start(100);
+		timer2.Start(5);
+
+		REQUIRE(!timer1.IsActive());
+		REQUIRE(TimerWheel::GetScheduledCount() == 1);
+
+		DepLibUV::RunLoop();
+
+		REQUIRE(listener.firedTimers == std::vector<Timer*>{ &timer2 });
+
+		// Reset() does nothing if the timer is not repeating.
+		timer2.Reset();
+
+		REQUIRE(!timer2.IsActive());
+
+		timer2.Restart();
+
+		REQUIRE(timer2.IsActive());
+
+		DepLibUV::RunLoop();
+
+		REQUIRE(listener.firedTimers == std::vector<Timer*>{ &timer2, &timer2 });
+	}
+
+	SECTION("timers with no timeout don't wait for the next tick")
+	{
+		auto granularity = Settings::configuration.timerGranularity;
+
+		// Read by the TimerWheel when the first Timer is created.
+		Settings::configuration.timerGranularity = 50u;
+
+		TestTimerListener listener;
+		Timer timer1(&listener);
+		Timer timer2(&listener);
+
+		Settings::configuration.timerGranularity = granularity;
+
+		uv_update_time(DepLibUV::GetLoop());
+
+		auto startMs = uv_now(DepLibUV::GetLoop());
+
+		timer1.Start(0);
+
+		REQUIRE(timer1.IsActive());
+		REQUIRE(TimerWheel::GetScheduledCount() == 1);
+
+		DepLibUV::RunLoop();
+
+		REQUIRE(listener.firedTimers == std::vector<Timer*>{ &timer1 });
+		REQUIRE(listener.firedTimesMs[0] - startMs < 50);
+
+		// Started by the listener of another one, it fires in the same expiration
+		// pass.
+		listener.timerToStart = &timer2;
+
+		timer1.Start(1);
+
+		DepLibUV::RunLoop();
+
+		REQUIRE(listener.firedTimers == std::vector<Timer*>{ &timer1, &timer1, &timer2 });
+		REQUIRE(listener.firedTimesMs[2] == listener.firedTimesMs[1]);
+
+		// Restarted by its own listener, it fires in the next loop iteration so
+		// the loop is not blocked.
+		listener.firedTimers.clear();
+		listener.timerToRestart = &timer1;
+		listener.restartTimes   = 3;
+
+		timer1.Start(0);
+		timer2.Stop();
+
+		DepLibUV::RunLoop();
+
+		REQUIRE(listener.firedTimers == std::vector<Timer*>{ &timer1, &timer1, &timer1 });
+		REQUIRE(TimerWheel::GetScheduledCount() == 0);
+	}
+
+	SECTION("closed timer cannot be started")
+	{
+		TestTimerListener listener;
+		Timer timer(&listener);
+
+		timer.Start(1000);
+		timer.Close();
+
+		REQUIRE(!timer.IsActive());
+		REQUIRE(TimerWheel::GetScheduledCount() == 0);
+		REQUIRE_THROWS_AS(timer.Start(1000), MediaSoupError);
+
+		// Nothing keeps the loop alive.
+		DepLibUV::RunLoop();
+
+		REQUIRE(listener.firedTimers.empty());
+	}
+}
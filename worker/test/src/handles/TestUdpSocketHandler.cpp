@@ -0,0 +1,187 @@
+#include "common.hpp"
+#include "DepLibUV.hpp"
+#include "handles/UdpSocketHandler.hpp"
+#include <catch2/catch.hpp>
+#include <utility>
+#include <vector>
+
+static uv_udp_t* createUvHandle()
+{
+	auto* uvHandle = new uv_udp_t;
+	struct sockaddr_storage bindAddr;
+
+	uv_udp_init_ex(DepLibUV::GetLoop(), uvHandle, UV_UDP_RECVMMSG);
+	uv_ip4_addr("127.0.0.1", 0, reinterpret_cast<struct sockaddr_in*>(&bindAddr));
+	uv_udp_bind(uvHandle, reinterpret_cast<struct sockaddr*>(&bindAddr), 0);
+
+	return uvHandle;
+}
+
+SCENARIO("UdpSocketHandler", "[handles][udpsocket]")
+{
+	class TestUdpSocket : public UdpSocketHandler
+	{
+	public:
+		TestUdpSocket() : UdpSocketHandler(createUvHandle())
+		{
+		}
+
+	public:
+		void UserOnUdpDatagramsReceived(const RecvDatagram* datagrams, size_t count) override
+		{
+			this->batchSizes.push_back(count);
+
+			for (size_t i{ 0u }; i < count; ++i)
+			{
+				this->datagrams.emplace_back(datagrams[i].data, datagrams[i].data + datagrams[i].len);
+			}
+		}
+
+	public:
+		std::vector<size_t> batchSizes;
+		std::vector<std::vector<uint8_t>> datagrams;
+	};
+
+	auto runLoop = [](TestUdpSocket& socket, size_t numDatagrams)
+	{
+		// Loopback datagrams are already queued, but don't hang if they got lost.
+		for (size_t i{ 0u }; i < 100u && socket.datagrams.size() < numDatagrams; ++i)
+		{
+			uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+		}
+	};
+
+	SECTION("datagrams read with a single recvmmsg() are delivered as a batch")
+	{
+		TestUdpSocket sender;
+		TestUdpSocket receiver;
+
+		for (uint8_t i{ 0u }; i < 3u; ++i)
+		{
+			uint8_t data[] = { i, i, i };
+
+			sender.Send(data, sizeof(data), receiver.GetLocalAddress(), nullptr, nullptr);
+		}
+
+		runLoop(receiver, 3u);
+
+		REQUIRE(receiver.batchSizes == std::vector<size_t>{ 3u });
+		REQUIRE(receiver.datagrams.size() == 3u);
+
+		// In the same order they were sent.
+		for (uint8_t i{ 0u }; i < 3u; ++i)
+		{
+			REQUIRE(receiver.datagrams[i] == std::vector<uint8_t>{ i, i, i });
+		}
+
+		REQUIRE(receiver.GetRecvBytes() == 9u);
+		REQUIRE(sender.batchSizes.empty());
+	}
+
+	SECTION("a batch holds at most RecvBatchMaxDatagrams datagrams")
+	{
+		const size_t maxDatagrams{ UdpSocketHandler::RecvBatchMaxDatagrams };
+		const size_t numDatagrams{ maxDatagrams + 5u };
+		TestUdpSocket sender;
+		TestUdpSocket receiver;
+
+		for (size_t i{ 0u }; i < numDatagrams; ++i)
+		{
+			uint8_t data[] = { static_cast<uint8_t>(i) };
+
+			sender.Send(data, sizeof(data), receiver.GetLocalAddress(), nullptr, nullptr);
+		}
+
+		runLoop(receiver, numDatagrams);
+
+		REQUIRE(receiver.batchSizes == std::vector<size_t>{ maxDatagrams, 5u });
+		REQUIRE(receiver.datagrams.size() == numDatagrams);
+
+		for (size_t i{ 0u }; i < numDatagrams; ++i)
+		{
+			REQUIRE(receiver.datagrams[i] == std::vector<uint8_t>{ static_cast<uint8_t>(i) });
+		}
+	}
+
+	SECTION("datagrams larger than a MTU are received")
+	{
+		TestUdpSocket sender;
+		TestUdpSocket receiver;
+		std::vector<uint8_t> data(9000u, 0xAA);
+
+		sender.Send(data.data(), data.size(), receiver.GetLocalAddress(), nullptr, nullptr);
+
+		runLoop(receiver, 1u);
+
+		REQUIRE(receiver.batchSizes == std::vector<size_t>{ 1u });
+		REQUIRE(receiver.datagrams[0] == data);
+	}
+
+	SECTION("a socket deleted by a send callback while flushing fails its batched datagrams")
+	{
+		// Socket of each sender and send results (sender index, sent).
+		static TestUdpSocket* senders[2];
+		static std::vector<std::pair<size_t, bool>> results;
+		static size_t tags[2] = { 0u, 1u };
+
+		auto* onSend = +[](bool sent, RTC::Transport::OnSendCallbackCtx* ctx)
+		{
+			auto idx = *reinterpret_cast<size_t*>(ctx);
+
+			results.emplace_back(idx, sent);
+
+			// The first datagram sent deletes the other sender.
+			auto* other = senders[1u - idx];
+
+			if (sent && other)
+			{
+				senders[1u - idx] = nullptr;
+
+				delete other;
+			}
+		};
+
+		UdpSocketHandler::CreateSendBatch(16u);
+
+		TestUdpSocket receiver;
+
+		senders[0] = new TestUdpSocket();
+		senders[1] = new TestUdpSocket();
+		results.clear();
+
+		for (size_t i{ 0u }; i < 4u; ++i)
+		{
+			uint8_t data[] = { static_cast<uint8_t>(i) };
+			auto* ctx      = reinterpret_cast<RTC::Transport::OnSendCallbackCtx*>(&tags[i % 2u]);
+
+			senders[i % 2u]->Send(data, sizeof(data), receiver.GetLocalAddress(), onSend, ctx);
+		}
+
+		REQUIRE(results.empty());
+
+		UdpSocketHandler::FlushSendBatch();
+
+		// One sender got its datagrams sent, the deleted one got them failed.
+		REQUIRE(results.size() == 4u);
+
+		const size_t alive = senders[0] ? 0u : 1u;
+
+		REQUIRE(senders[alive] != nullptr);
+		REQUIRE(senders[1u - alive] == nullptr);
+		REQUIRE(
+		  results ==
+		  std::vector<std::pair<size_t, bool>>{
+		    { alive, true }, { 1u - alive, false }, { 1u - alive, false }, { alive, true } });
+
+		runLoop(receiver, 2u);
+
+		REQUIRE(receiver.datagrams.size() == 2u);
+
+		delete senders[alive];
+
+		UdpSocketHandler::CloseSendBatch();
+	}
+
+	// Run the close callbacks of the sockets.
+	uv_run(DepLibUV::GetLoop(), UV_RUN_NOWAIT);
+}